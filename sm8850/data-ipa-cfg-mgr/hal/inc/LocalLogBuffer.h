@@ -29,45 +29,94 @@
 #ifndef _LOCAL_LOG_BUFFER_H_
 #define _LOCAL_LOG_BUFFER_H_
 /* External Includes */
-#include <deque>
-#include <sstream>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
 #include <string>
 #include <sys/types.h>
 #include <vector>
 
 /* Namespace pollution avoidance */
-using ::std::deque;
+using ::std::mutex;
 using ::std::string;
-using ::std::stringstream;
+using ::std::unique_ptr;
 using ::std::vector;
 
 
+/* Every HAL call is recorded as a fixed size binary record: the function and
+ * argument names are kept as pointers to their string literals and the values
+ * are copied raw (strings truncated to fit).  Records live in a ring that is
+ * allocated once, so logging a call does no heap allocation and no formatting;
+ * the text is only produced when the ring is dumped.
+ */
 class LocalLogBuffer {
 public:
+    static const size_t kMaxArgs = 4;
+    static const size_t kMaxArgLen = 96;
+    static const size_t kMaxResultVals = 8;
+
     class FunctionLog {
     public:
-        FunctionLog(string /* funcName */);
-        FunctionLog(const FunctionLog& /* other */);
-        void addArg(string /* kw */, string /* arg */);
-        void addArg(string /* kw */, vector<string> /* args */);
-        void addArg(string /* kw */, uint64_t /* arg */);
-        void setResult(bool /* success */, string /* msg */);
-        void setResult(vector<unsigned int> /* ret */);
+        /* funcName must outlive the log, __func__ or a string literal */
+        FunctionLog(const char* /* funcName */);
+        void addArg(const char* /* kw */, const char* /* arg */);
+        void addArg(const char* /* kw */, const vector<string>& /* args */);
+        void addArg(const char* /* kw */, uint64_t /* arg */);
+        void setResult(bool /* success */, const string& /* msg */);
+        void setResult(const vector<unsigned int>& /* ret */);
         void setResult(uint64_t /* rx */, uint64_t /* tx */);
-        string toString();
+        string toString() const;
     private:
-        void maybeAddArgsComma();
-        const string mName;
-        bool mArgsProvided;
-        stringstream mSSArgs;
-        stringstream mSSReturn;
+        friend class LocalLogBuffer;
+        FunctionLog();
+        enum ArgType : uint8_t { ARG_U64, ARG_STR, ARG_STR_LIST };
+        enum ResultType : uint8_t { RES_NONE, RES_BOOL, RES_VALS, RES_RX_TX };
+        typedef struct {
+            const char* kw;
+            ArgType type;
+            /* ARG_STR_LIST: entries stored in str / entries passed */
+            uint8_t stored;
+            uint16_t total;
+            union {
+                uint64_t u64;
+                /* ARG_STR_LIST packs the entries back to back, NUL separated */
+                char str[kMaxArgLen];
+            };
+        } Arg;
+
+        void copyStr(char* /* dst */, const char* /* src */, size_t /* len */);
+
+        const char* mName;
+        uint64_t mStartNs;
+        uint64_t mEndNs;
+        uint8_t mNumArgs;
+        ResultType mResultType;
+        Arg mArgs[kMaxArgs];
+        union {
+            struct {
+                bool success;
+                char msg[kMaxArgLen];
+            } mBool;
+            struct {
+                uint8_t stored;
+                uint16_t total;
+                unsigned int vals[kMaxResultVals];
+            } mVals;
+            struct {
+                uint64_t rx;
+                uint64_t tx;
+            } mRxTx;
+        };
     }; /* FunctionLog */
     LocalLogBuffer(string /* name */, int /* maxLogs */);
-    void addLog(FunctionLog /* log */);
+    void addLog(const FunctionLog& /* log */);
     void toLogcat();
 private:
-    deque<FunctionLog> mLogs;
+    mutex mLock;
+    unique_ptr<FunctionLog[]> mLogs;
     const string mName;
     const size_t mMaxLogs;
+    /* calls recorded so far, the ring holds the last mMaxLogs of them */
+    uint64_t mNumLogged;
 }; /* LocalLogBuffer */
-#endif /* _LOCAL_LOG_BUFFER_H_ */
\ No newline at end of file
+#endif /* _LOCAL_LOG_BUFFER_H_ */
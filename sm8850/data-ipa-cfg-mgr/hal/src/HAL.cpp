@@ -111,6 +111,7 @@ void HAL::doLogcatDump() {
      * ALOGD("fd2->%d", mHandle2->data[0]);
      */
     ALOGD("========");
+    mLogs.toLogcat();
 } /* doLogcatDump */
 
 HAL::BoolResult HAL::makeInputCheckFailure(string customErr) {
@@ -446,7 +447,7 @@ Return<void> HAL::getForwardedStats
     getForwardedStats_cb hidl_cb
 ) {
     LocalLogBuffer::FunctionLog fl(__func__);
-    fl.addArg("upstream", upstream);
+    fl.addArg("upstream", upstream.c_str());
 
     OffloadStatistics ret;
     RET ipaReturn = mIPA->getStats(upstream.c_str(), true, ret);
@@ -477,7 +478,7 @@ Return<void> HAL::setDataLimit
     setDataLimit_cb hidl_cb
 ) {
     LocalLogBuffer::FunctionLog fl(__func__);
-    fl.addArg("upstream", upstream);
+    fl.addArg("upstream", upstream.c_str());
     fl.addArg("limit", limit);
 
     if (!isInitialized()) {
@@ -509,9 +510,9 @@ Return<void> HAL::setUpstreamParameters
     vector<string> v6GwStrs = convertHidlStrToStdStr(v6Gws);
 
     LocalLogBuffer::FunctionLog fl(__func__);
-    fl.addArg("iface", iface);
-    fl.addArg("v4Addr", v4Addr);
-    fl.addArg("v4Gw", v4Gw);
+    fl.addArg("iface", iface.c_str());
+    fl.addArg("v4Addr", v4Addr.c_str());
+    fl.addArg("v4Gw", v4Gw.c_str());
     fl.addArg("v6Gws", v6GwStrs);
 
     PrefixParser v4AddrParser;
@@ -568,8 +569,8 @@ Return<void> HAL::addDownstream
     addDownstream_cb hidl_cb
 ) {
     LocalLogBuffer::FunctionLog fl(__func__);
-    fl.addArg("iface", iface);
-    fl.addArg("prefix", prefix);
+    fl.addArg("iface", iface.c_str());
+    fl.addArg("prefix", prefix.c_str());
 
     PrefixParser prefixParser;
 
@@ -602,8 +603,8 @@ Return<void> HAL::removeDownstream
     removeDownstream_cb hidl_cb
 ) {
     LocalLogBuffer::FunctionLog fl(__func__);
-    fl.addArg("iface", iface);
-    fl.addArg("prefix", prefix);
+    fl.addArg("iface", iface.c_str());
+    fl.addArg("prefix", prefix.c_str());
 
     PrefixParser prefixParser;
 
@@ -637,7 +638,7 @@ Return<void> HAL::setDataWarningAndLimit
     setDataWarningAndLimit_cb hidl_cb
 ) {
     LocalLogBuffer::FunctionLog fl(__func__);
-    fl.addArg("upstream", upstream);
+    fl.addArg("upstream", upstream.c_str());
     fl.addArg("warningBytes", warningBytes);
     fl.addArg("limitBytes", limitBytes);
 
@@ -30,97 +30,188 @@
 
 /* External Includes */
 #include <cutils/log.h>
-#include <deque>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <sys/types.h>
+#include <time.h>
 #include <vector>
 
 /* Internal Includes */
 #include "LocalLogBuffer.h"
 
 /* Namespace pollution avoidance */
-using ::std::deque;
+using ::std::lock_guard;
+using ::std::setfill;
+using ::std::setw;
 using ::std::string;
+using ::std::stringstream;
 using ::std::vector;
 
 
-LocalLogBuffer::FunctionLog::FunctionLog(string funcName) : mName(funcName) {
-    mArgsProvided = false;
+static uint64_t nowNs() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+} /* nowNs */
+
+LocalLogBuffer::FunctionLog::FunctionLog() : mName(nullptr) {
+    mStartNs = 0;
+    mEndNs = 0;
+    mNumArgs = 0;
+    mResultType = RES_NONE;
 } /* FunctionLog */
 
-LocalLogBuffer::FunctionLog::FunctionLog(const FunctionLog& other) :
-        mName(other.mName) {
-    mArgsProvided = other.mArgsProvided;
-    /* Is this right? How do you copy stringstreams without wizardry? */
-    mSSArgs.str(other.mSSArgs.str());
-    mSSReturn.str(other.mSSReturn.str());
+LocalLogBuffer::FunctionLog::FunctionLog(const char* funcName) : mName(funcName) {
+    mStartNs = nowNs();
+    mEndNs = 0;
+    mNumArgs = 0;
+    mResultType = RES_NONE;
 } /* FunctionLog */
 
-void LocalLogBuffer::FunctionLog::addArg(string kw, string arg) {
-    maybeAddArgsComma();
-    mSSArgs << kw << "=" << arg;
-} /* addArg */
+void LocalLogBuffer::FunctionLog::copyStr(char* dst, const char* src, size_t len) {
+    size_t srcLen = strlen(src);
 
-void LocalLogBuffer::FunctionLog::addArg(string kw, vector<string> args) {
-    maybeAddArgsComma();
-    mSSArgs << kw << "=[";
-    for (size_t i = 0; i < args.size(); i++) {
-        mSSArgs << args[i];
-        if (i < (args.size() - 1))
-            mSSArgs << ", ";
+    if (srcLen < len) {
+        memcpy(dst, src, srcLen + 1);
+    } else {
+        /* Mark the truncation so that nobody mistakes it for the real value */
+        memcpy(dst, src, len - 4);
+        memcpy(dst + len - 4, "...", 4);
     }
-    mSSArgs << "]";
+} /* copyStr */
+
+void LocalLogBuffer::FunctionLog::addArg(const char* kw, const char* arg) {
+    if (mNumArgs >= kMaxArgs)
+        return;
+    Arg& a = mArgs[mNumArgs++];
+    a.kw = kw;
+    a.type = ARG_STR;
+    copyStr(a.str, arg, sizeof(a.str));
 } /* addArg */
 
-void LocalLogBuffer::FunctionLog::addArg(string kw, uint64_t arg) {
-    maybeAddArgsComma();
-    mSSArgs << kw << "=" << arg;
+void LocalLogBuffer::FunctionLog::addArg(const char* kw, const vector<string>& args) {
+    if (mNumArgs >= kMaxArgs)
+        return;
+    Arg& a = mArgs[mNumArgs++];
+    size_t used = 0;
+
+    a.kw = kw;
+    a.type = ARG_STR_LIST;
+    a.stored = 0;
+    a.total = (args.size() > UINT16_MAX) ? UINT16_MAX : args.size();
+    for (size_t i = 0; i < args.size() && a.stored < UINT8_MAX; i++) {
+        if (args[i].size() + 1 > sizeof(a.str) - used)
+            break;
+        memcpy(a.str + used, args[i].c_str(), args[i].size() + 1);
+        used += args[i].size() + 1;
+        a.stored++;
+    }
 } /* addArg */
 
-void LocalLogBuffer::FunctionLog::maybeAddArgsComma() {
-    if (!mArgsProvided) {
-        mArgsProvided = true;
-    } else {
-        mSSArgs << ", ";
-    }
-} /* maybeAddArgsComma */
+void LocalLogBuffer::FunctionLog::addArg(const char* kw, uint64_t arg) {
+    if (mNumArgs >= kMaxArgs)
+        return;
+    Arg& a = mArgs[mNumArgs++];
+    a.kw = kw;
+    a.type = ARG_U64;
+    a.u64 = arg;
+} /* addArg */
 
-void LocalLogBuffer::FunctionLog::setResult(bool success, string msg) {
-    mSSReturn << "[" << ((success) ? "success" : "failure") << ", " << msg
-              << "]";
+void LocalLogBuffer::FunctionLog::setResult(bool success, const string& msg) {
+    mResultType = RES_BOOL;
+    mBool.success = success;
+    copyStr(mBool.msg, msg.c_str(), sizeof(mBool.msg));
 } /* setResult */
 
-void LocalLogBuffer::FunctionLog::setResult(vector<unsigned int> ret) {
-    mSSReturn << "[";
-    for (size_t i = 0; i < ret.size(); i++) {
-        mSSReturn << ret[i];
-        if (i < (ret.size() - 1))
-            mSSReturn << ", ";
-    }
-    mSSReturn << "]";
+void LocalLogBuffer::FunctionLog::setResult(const vector<unsigned int>& ret) {
+    mResultType = RES_VALS;
+    mVals.stored = 0;
+    mVals.total = (ret.size() > UINT16_MAX) ? UINT16_MAX : ret.size();
+    for (size_t i = 0; i < ret.size() && i < kMaxResultVals; i++)
+        mVals.vals[mVals.stored++] = ret[i];
 } /* setResult */
 
 void LocalLogBuffer::FunctionLog::setResult(uint64_t rx, uint64_t tx) {
-    mSSReturn << "[rx=" << rx << ", tx=" << tx << "]";
+    mResultType = RES_RX_TX;
+    mRxTx.rx = rx;
+    mRxTx.tx = tx;
 } /* setResult */
 
-string LocalLogBuffer::FunctionLog::toString() {
+string LocalLogBuffer::FunctionLog::toString() const {
     stringstream ret;
-    ret << mName << "(" << mSSArgs.str() << ") returned " << mSSReturn.str();
+
+    ret << "[" << (mStartNs / 1000000000ULL) << "." << setfill('0') << setw(6)
+        << ((mStartNs / 1000) % 1000000) << setfill(' ') << "] " << mName << "(";
+    for (size_t i = 0; i < mNumArgs; i++) {
+        const Arg& a = mArgs[i];
+        if (i > 0)
+            ret << ", ";
+        ret << a.kw << "=";
+        if (a.type == ARG_U64) {
+            ret << a.u64;
+        } else if (a.type == ARG_STR) {
+            ret << a.str;
+        } else {
+            const char* entry = a.str;
+            ret << "[";
+            for (size_t j = 0; j < a.stored; j++) {
+                if (j > 0)
+                    ret << ", ";
+                ret << entry;
+                entry += strlen(entry) + 1;
+            }
+            if (a.total > a.stored)
+                ret << ((a.stored > 0) ? ", " : "") << "+" << (a.total - a.stored) << " more";
+            ret << "]";
+        }
+    }
+    ret << ") returned ";
+    if (mResultType == RES_BOOL) {
+        ret << "[" << ((mBool.success) ? "success" : "failure") << ", " << mBool.msg << "]";
+    } else if (mResultType == RES_VALS) {
+        ret << "[";
+        for (size_t i = 0; i < mVals.stored; i++) {
+            ret << mVals.vals[i];
+            if (i < (size_t)(mVals.stored - 1))
+                ret << ", ";
+        }
+        if (mVals.total > mVals.stored)
+            ret << ", +" << (mVals.total - mVals.stored) << " more";
+        ret << "]";
+    } else if (mResultType == RES_RX_TX) {
+        ret << "[rx=" << mRxTx.rx << ", tx=" << mRxTx.tx << "]";
+    }
+    if (mEndNs >= mStartNs)
+        ret << " in " << ((mEndNs - mStartNs) / 1000) << "us";
     return ret.str();
 } /* toString */
 
 LocalLogBuffer::LocalLogBuffer(string name, int maxLogs) : mName(name),
-        mMaxLogs(maxLogs) {
+        mMaxLogs((maxLogs > 0) ? maxLogs : 1) {
+    mLogs.reset(new FunctionLog[mMaxLogs]);
+    mNumLogged = 0;
 } /* LocalLogBuffer */
 
-void LocalLogBuffer::addLog(FunctionLog log) {
-    while (mLogs.size() > mMaxLogs)
-        mLogs.pop_front();
-    mLogs.push_back(log);
+void LocalLogBuffer::addLog(const FunctionLog& log) {
+    uint64_t end = nowNs();
+    lock_guard<mutex> guard(mLock);
+    FunctionLog& slot = mLogs[mNumLogged % mMaxLogs];
+
+    slot = log;
+    slot.mEndNs = end;
+    mNumLogged++;
 } /* addLog */
 
 void LocalLogBuffer::toLogcat() {
-    for (size_t i = 0; i < mLogs.size(); i++)
-        ALOGD("%s: %s", mName.c_str(), mLogs[i].toString().c_str());
+    lock_guard<mutex> guard(mLock);
+    uint64_t first = (mNumLogged > mMaxLogs) ? mNumLogged - mMaxLogs : 0;
+
+    ALOGD("%s: %llu calls, last %llu kept", mName.c_str(),
+            (unsigned long long)mNumLogged, (unsigned long long)(mNumLogged - first));
+    for (uint64_t i = first; i < mNumLogged; i++)
+        ALOGD("%s: %s", mName.c_str(), mLogs[i % mMaxLogs].toString().c_str());
 } /* toLogcat */
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/* Measures the per call cost of the HAL call log: the binary ring in
+ * LocalLogBuffer against the eager stringstream formatting it replaced, for a
+ * setUpstreamParameters like call.  Heap allocations done while logging are
+ * counted through operator new.
+ */
+/* External Includes */
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <sstream>
+#include <string>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+/* Internal Includes */
+#include "LocalLogBuffer.h"
+
+/* Namespace pollution avoidance */
+using ::std::deque;
+using ::std::string;
+using ::std::stringstream;
+using ::std::vector;
+
+
+static unsigned long long gAllocs = 0;
+
+void* operator new(size_t size) {
+    void* p = malloc(size ? size : 1);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    gAllocs++;
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+static uint64_t nowNs() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+} /* nowNs */
+
+/* The logging LocalLogBuffer did before the binary ring */
+class EagerLog {
+public:
+    EagerLog(string funcName) : mName(funcName), mArgsProvided(false) {}
+    EagerLog(const EagerLog& other) : mName(other.mName) {
+        mArgsProvided = other.mArgsProvided;
+        mSSArgs.str(other.mSSArgs.str());
+        mSSReturn.str(other.mSSReturn.str());
+    }
+    void addArg(string kw, string arg) {
+        maybeAddArgsComma();
+        mSSArgs << kw << "=" << arg;
+    }
+    void addArg(string kw, vector<string> args) {
+        maybeAddArgsComma();
+        mSSArgs << kw << "=[";
+        for (size_t i = 0; i < args.size(); i++) {
+            mSSArgs << args[i];
+            if (i < (args.size() - 1))
+                mSSArgs << ", ";
+        }
+        mSSArgs << "]";
+    }
+    void setResult(bool success, string msg) {
+        mSSReturn << "[" << ((success) ? "success" : "failure") << ", " << msg << "]";
+    }
+    string toString() {
+        stringstream ret;
+        ret << mName << "(" << mSSArgs.str() << ") returned " << mSSReturn.str();
+        return ret.str();
+    }
+private:
+    void maybeAddArgsComma() {
+        if (!mArgsProvided)
+            mArgsProvided = true;
+        else
+            mSSArgs << ", ";
+    }
+    const string mName;
+    bool mArgsProvided;
+    stringstream mSSArgs;
+    stringstream mSSReturn;
+}; /* EagerLog */
+
+static void usage(const char* name) {
+    printf("Usage: %s [-n calls] [-l max_logs]\n", name);
+} /* usage */
+
+int main(int argc, char** argv) {
+    int calls = 100000, maxLogs = 50;
+    int opt;
+    string iface("rmnet_data0"), v4Addr("100.64.12.34"), v4Gw("100.64.12.1");
+    string errMsg;
+    vector<string> v6Gws;
+    uint64_t start, binaryNs, eagerNs;
+    unsigned long long binaryAllocs, eagerAllocs;
+    string binaryStr, eagerStr;
+
+    while ((opt = getopt(argc, argv, "n:l:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                calls = atoi(optarg);
+                break;
+            case 'l':
+                maxLogs = atoi(optarg);
+                break;
+            default:
+                usage(argv[0]);
+                return -1;
+        }
+    }
+    if (calls <= 0 || maxLogs <= 0) {
+        usage(argv[0]);
+        return -1;
+    }
+
+    v6Gws.push_back("fe80::1");
+    v6Gws.push_back("fe80::2:aaff:fe00:1");
+
+    LocalLogBuffer logs("bench", maxLogs);
+    LocalLogBuffer::FunctionLog last("setUpstreamParameters");
+    gAllocs = 0;
+    start = nowNs();
+    for (int i = 0; i < calls; i++) {
+        LocalLogBuffer::FunctionLog fl("setUpstreamParameters");
+        fl.addArg("iface", iface.c_str());
+        fl.addArg("v4Addr", v4Addr.c_str());
+        fl.addArg("v4Gw", v4Gw.c_str());
+        fl.addArg("v6Gws", v6Gws);
+        fl.setResult(true, errMsg);
+        logs.addLog(fl);
+        if (i == calls - 1)
+            last = fl;
+    }
+    binaryNs = nowNs() - start;
+    binaryAllocs = gAllocs;
+    binaryStr = last.toString();
+
+    deque<EagerLog> eagerLogs;
+    gAllocs = 0;
+    start = nowNs();
+    for (int i = 0; i < calls; i++) {
+        EagerLog fl("setUpstreamParameters");
+        fl.addArg("iface", iface);
+        fl.addArg("v4Addr", v4Addr);
+        fl.addArg("v4Gw", v4Gw);
+        fl.addArg("v6Gws", v6Gws);
+        fl.setResult(true, errMsg);
+        while (eagerLogs.size() > (size_t)maxLogs)
+            eagerLogs.pop_front();
+        eagerLogs.push_back(fl);
+    }
+    eagerNs = nowNs() - start;
+    eagerAllocs = gAllocs;
+    eagerStr = eagerLogs.back().toString();
+
+    printf("calls %d ring %d\n", calls, maxLogs);
+    printf("binary %8.1fns/call %6.2f allocs/call\n", (double)binaryNs / calls,
+            (double)binaryAllocs / calls);
+    printf("eager  %8.1fns/call %6.2f allocs/call\n", (double)eagerNs / calls,
+            (double)eagerAllocs / calls);
+
+    /* The binary record adds a timestamp and duration around the same text */
+    if (binaryStr.find(eagerStr) == string::npos) {
+        printf("MISMATCH\n  binary: %s\n  eager:  %s\n", binaryStr.c_str(), eagerStr.c_str());
+        return -1;
+    }
+    printf("last call: %s\n", binaryStr.c_str());
+    return 0;
+} /* main */
@@ -40,6 +40,7 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define IPA_CONNTRACK_MESSAGE_H
 
 #include <pthread.h>
+#include <atomic>
 #include "IPACM_Defs.h"
 
 
@@ -60,38 +61,81 @@ typedef struct cmd_s
 	ipacm_cmd_q_data data;
 }cmd_t;
 
+/* messages preallocated for PostEvt, further messages fall back to the heap */
+#define IPACM_MSG_POOL_SIZE 512
+/* messages processed per wakeup before the queues are checked for new work again */
+#define IPACM_MSG_BATCH_SIZE 32
+
 class Message
 {
 private:
-	Message *m_next;
+	std::atomic<Message *> m_next;
 
 public:
 	cmd_t evt;
+	uint64_t enqueue_ns;
+	bool pooled;
 
 	Message()
 	{
-		m_next = NULL;
+		m_next.store(NULL, std::memory_order_relaxed);
 		evt.callback_ptr = NULL;
+		enqueue_ns = 0;
+		pooled = false;
 	}
 	~Message() { }
-	void setnext(Message *item) { m_next = item; }
-	Message* getnext()       { return m_next; }
+	void setnext(Message *item) { m_next.store(item, std::memory_order_release); }
+	Message* getnext()       { return m_next.load(std::memory_order_acquire); }
 };
 
+/* Intrusive multi-producer single-consumer queue, producers never block each other. Only the
+   command queue thread dequeues. */
 class MessageQueue
 {
 
 private:
-	Message *Head;
-	Message *Tail;
+	std::atomic<Message *> Head;	/* last enqueued, producer side */
+	Message *Tail;			/* next to dequeue, consumer side */
+	Message stub;
+	const char *name;
+
+	/* statistics, producer side */
+	std::atomic<uint32_t> depth;
+	std::atomic<uint32_t> depth_max;
+	std::atomic<uint64_t> enqueued;
+	/* statistics, consumer side */
+	uint64_t processed;
+	uint64_t wait_total_us;
+	uint32_t wait_max_us;
+
 	Message* dequeue(void);
+	void push(Message *item);
 	static MessageQueue *inst_internal;
 	static MessageQueue *inst_external;
 
-	MessageQueue()
+	/* preallocated messages */
+	static Message pool[IPACM_MSG_POOL_SIZE];
+	static Message *pool_free;
+	static pthread_mutex_t pool_lock;
+	static uint64_t pool_exhausted;
+
+	/* consumer sleeps only when both queues are empty */
+	static pthread_mutex_t wait_lock;
+	static pthread_cond_t wait_cond;
+	static std::atomic<bool> waiting;
+	static uint64_t wakeups;
+
+	MessageQueue(const char *queue_name)
 	{
-		Head = NULL;
-		Tail = NULL;
+		Head.store(&stub, std::memory_order_relaxed);
+		Tail = &stub;
+		name = queue_name;
+		depth.store(0, std::memory_order_relaxed);
+		depth_max.store(0, std::memory_order_relaxed);
+		enqueued.store(0, std::memory_order_relaxed);
+		processed = 0;
+		wait_total_us = 0;
+		wait_max_us = 0;
 	}
 
 public:
@@ -99,9 +143,13 @@ public:
 	~MessageQueue() { }
 	void enqueue(Message *item);
 
+	static Message* allocMessage(void);
+	static void freeMessage(Message *item);
+
 	static void* Process(void *);
 	static MessageQueue* getInstanceInternal();
 	static MessageQueue* getInstanceExternal();
+	static void dumpStats(void);
 
 };
 
@@ -41,9 +41,12 @@ typedef uint32_t in_addr_t;
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <errno.h>
+#include <pthread.h>
+#include <vector>
 
 #include "IPACM_CmdQueue.h"
 #include "IPACM_Conntrack_NATApp.h"
+#include "IPACM_ConntrackWorkers.h"
 #include "IPACM_Listener.h"
 #ifdef CT_OPT
 #include "IPACM_LanToLan.h"
@@ -69,6 +72,17 @@ typedef struct _ct_entry
 	enum nf_conntrack_msg_type type;
 }ct_entry;
 
+/* holds the listener configuration lock for writing until the end of the scope */
+class CtCfgWriteGuard
+{
+public:
+	CtCfgWriteGuard(pthread_rwlock_t *lock) : lock(lock) { pthread_rwlock_wrlock(lock); }
+	~CtCfgWriteGuard() { pthread_rwlock_unlock(lock); }
+
+private:
+	pthread_rwlock_t *lock;
+};
+
 class IPACM_ConntrackListener : public IPACM_Listener
 {
 
@@ -86,8 +100,19 @@ private:
 	uint32_t nonnat_iface_ipv4_addr[MAX_IFACE_ADDRESS];
 	uint32_t sta_clnt_ipv4_addr[MAX_STA_CLNT_IFACES];
 	IPACM_Config *pConfig;
-	ct_entry *ct_entries;
+	/* the conntrack workers classify events against the state above, changing it takes this for writing */
+	pthread_rwlock_t ct_cfg_lock;
+	pthread_mutex_t ct_cache_lock;
 	ct_entry ct_cache[MAX_CONNTRACK_ENTRIES];
+
+	/* dump entries received before WAN up and the nf_conntrack pool of readConntrack */
+	pthread_mutex_t ct_dump_lock;
+	std::vector<ct_entry> ct_pending;
+	std::vector<struct nf_conntrack *> ct_pool;
+	struct nf_conntrack *ct_blank;
+	uint64_t ct_sync_start_us;
+	int ct_sync_received;
+	int ct_sync_processed;
 #ifdef CT_OPT
 	IPACM_LanToLan *p_lan2lan;
 #endif
@@ -95,6 +120,10 @@ private:
 	void ProcessCTMessage(void *);
 	bool ProcessTCPorUDPMsg(struct nf_conntrack *,
 	enum nf_conntrack_msg_type, u_int8_t);
+	bool ClassifyTCPorUDPMsg(struct nf_conntrack *, enum nf_conntrack_msg_type, u_int8_t,
+		nat_table_entry *, nat_entry_bundle *, bool *);
+	void CacheORDeleteConntrackLocked(struct nf_conntrack *,
+		enum nf_conntrack_msg_type, u_int8_t);
 	void TriggerWANUp(void *);
 	void TriggerWANDown(uint32_t);
 	int  CreateNatThreads(void);
@@ -106,6 +135,12 @@ private:
 	void HandleNonNatIPAddr(void *, bool);
 	void HandleNatTableMove(void *in_param);
 
+	struct nf_conntrack *GetPooledCt(void);
+	void PutPooledCt(struct nf_conntrack *);
+	void ReleaseCtPool(void);
+	void ProcessDumpEntry(struct nf_conntrack *, enum nf_conntrack_msg_type);
+	void ProcessPendingConntrack(void);
+
 #ifdef CT_OPT
 	void ProcessCTV6Message(void *);
 	void HandleLan2Lan(struct nf_conntrack *,
@@ -130,6 +165,7 @@ public:
 	void HandleSTAClientDelEvt(uint32_t);
 	int  CreateConnTrackThreads(void);
 	void readConntrack(int fd);
+	void ProcessCTBatch(ct_work_item *, int);
 	void processConntrack(void);
 	void CacheORDeleteConntrack(struct nf_conntrack *ct,
 		enum nf_conntrack_msg_type type, u_int8_t protocol);
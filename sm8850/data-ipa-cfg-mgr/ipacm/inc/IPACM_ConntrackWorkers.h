@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*!
+	@file
+	IPACM_ConntrackWorkers.h
+
+	@brief
+	Worker pool processing IPv4 conntrack events, sharded by flow
+*/
+#ifndef IPACM_CONNTRACK_WORKERS_H
+#define IPACM_CONNTRACK_WORKERS_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <atomic>
+
+extern "C"
+{
+#include <libnetfilter_conntrack/libnetfilter_conntrack.h>
+}
+
+#define CT_MAX_WORKERS 4
+#define CT_WORKER_QUEUE_LEN 1024
+/* events handed to the listener, and NAT table writes done under one NatApp lock */
+#define CT_WORKER_BATCH 32
+
+typedef struct _ct_work_item
+{
+	struct nf_conntrack *ct;
+	enum nf_conntrack_msg_type type;
+} ct_work_item;
+
+/*
+ * Every event of a flow hashes to the same shard and each shard is drained in order by
+ * its own thread, so per flow ordering is kept while different flows are classified in
+ * parallel. A full shard blocks the netlink thread feeding it rather than dropping the
+ * event; events the kernel could not deliver (ENOBUFS) are counted as drops.
+ */
+class IPACM_ConntrackWorkers
+{
+public:
+	/* starts one worker per online CPU, up to CT_MAX_WORKERS */
+	static int Start(void);
+	static bool IsStarted(void) { return num_shards > 0; }
+
+	/* queues the event on the shard of its flow and takes ownership of ct */
+	static void Dispatch(struct nf_conntrack *ct, enum nf_conntrack_msg_type type);
+
+	static void CountKernelDrop(void) { kernel_drops++; }
+	static void DumpStats(void);
+
+private:
+	typedef struct
+	{
+		pthread_t thread;
+		pthread_mutex_t lock;
+		pthread_cond_t not_empty;
+		pthread_cond_t not_full;
+		ct_work_item ring[CT_WORKER_QUEUE_LEN];
+		/* written under lock, atomic for DumpStats which runs in the SIGHUP handler */
+		std::atomic<uint32_t> head;
+		std::atomic<uint32_t> tail;
+
+		std::atomic<uint64_t> enqueued;
+		std::atomic<uint64_t> processed;
+		std::atomic<uint64_t> batches;
+		std::atomic<uint64_t> full_waits;
+		std::atomic<uint32_t> depth_max;
+	} shard;
+
+	static shard *shards;
+	static int num_shards;
+	static uint64_t start_us;
+	static uint64_t last_dump_us;
+	static uint64_t last_dump_processed;
+	static std::atomic<uint64_t> kernel_drops;
+
+	static uint32_t FlowHash(struct nf_conntrack *ct);
+	static void *WorkerLoop(void *param);
+};
+
+#endif /* IPACM_CONNTRACK_WORKERS_H */
@@ -32,9 +32,11 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string.h>  /* for stderror */
 #include <stdlib.h>
 #include <cstdio>  /* for perror */
+#include <pthread.h>
 
 #include "IPACM_Config.h"
 #include "IPACM_Xml.h"
+#include "IPACM_NatCacheIndex.h"
 
 extern "C"
 {
@@ -47,29 +49,36 @@ extern "C"
 #define IPACM_TCP_FULL_FILE_NAME  "/proc/sys/net/ipv4/netfilter/ip_conntrack_tcp_timeout_established"
 #define IPACM_UDP_FULL_FILE_NAME   "/proc/sys/net/ipv4/netfilter/ip_conntrack_udp_timeout_stream"
 
-typedef struct _nat_table_entry
-{
-	uint32_t private_ip;
-	uint16_t private_port;
-
-	uint32_t target_ip;
-	uint16_t target_port;
-
-	uint32_t public_ip;
-	uint16_t public_port;
-
-	u_int8_t  protocol;
-	uint32_t timestamp;
+#define CHK_TBL_HDL()  if(nat_table_hdl == 0){ return -1; }
 
-	bool dst_nat;
-	bool enabled;
-	uint32_t rule_hdl;
+/* conntrack timeout refreshes sent per netlink datagram */
+#define NAT_TS_BATCH_SIZE 32
+#define NAT_TS_BATCH_MSG_LEN 512
 
-	/* used for pcie-modem */
-	uint32_t rule_id;
-}nat_table_entry;
+/* UDP keep-alive harvest cycles, see NatApp::UpdateUDPTimeStamp */
+typedef struct
+{
+	uint64_t cycles;
+	uint64_t queried;
+	uint64_t changed;
+	uint64_t updated;
+	uint64_t failed;
+	uint32_t last_duration_us;
+	uint32_t max_duration_us;
+} nat_ts_harvest_stat;
+
+/* holds a mutex for the lifetime of the scope */
+class NatAppGuard
+{
+public:
+	NatAppGuard(pthread_mutex_t *mutex) : m_mutex(mutex) { pthread_mutex_lock(m_mutex); }
+	~NatAppGuard() { pthread_mutex_unlock(m_mutex); }
+private:
+	pthread_mutex_t *m_mutex;
+};
 
-#define CHK_TBL_HDL()  if(nat_table_hdl == 0){ return -1; }
+/* public NatApp methods take the (recursive) instance lock themselves */
+#define NAT_APP_LOCK() NatAppGuard nat_app_guard(&lock)
 
 class NatApp
 {
@@ -77,7 +86,11 @@ private:
 
 	static NatApp *pInstance;
 
+	/* NatApp is shared by the command queue, the conntrack workers and the UDP timeout thread */
+	pthread_mutex_t lock;
+
 	nat_table_entry *cache;
+	NatCacheIndex cache_index;
 	nat_table_entry temp[MAX_TEMP_ENTRIES];
 	uint32_t pub_ip_addr;
 	uint32_t pub_ip_addr_pre;
@@ -100,6 +113,11 @@ private:
 	struct nf_conntrack *ct;
 	struct nfct_handle *ct_hdl;
 
+	/* per slot hardware timestamps of the last harvest and the slots that changed */
+	uint32_t *ts_snapshot;
+	int *ts_changed;
+	nat_ts_harvest_stat ts_stats;
+
 	int m_fd_ipa;
 
 	NatApp();
@@ -107,6 +125,12 @@ private:
 	int Init();
 
 	void UpdateCTUdpTs(nat_table_entry *, uint32_t);
+	int SnapshotTimestamps(int *);
+#ifndef FEATURE_IPACM_HAL
+	int OpenCTHandle(void);
+	void SetCTAttrs(const nat_table_entry *);
+	void UpdateCTUdpTsBatch(const int *, int, int *, int *);
+#endif
 	bool ChkForDup(const nat_table_entry *);
 	bool isAlgPort(uint8_t, uint16_t);
 	void Reset();
@@ -116,6 +140,10 @@ private:
 public:
 	static NatApp* GetInstance();
 
+	/* keeps the NAT table to one caller across several calls, e.g. a batch of rule updates */
+	void Lock(void) { pthread_mutex_lock(&lock); }
+	void Unlock(void) { pthread_mutex_unlock(&lock); }
+
 	int AddTable(uint32_t, uint8_t mux_id);
 	uint32_t GetTableHdl(uint32_t);
 	int DeleteTable(uint32_t);
@@ -128,6 +156,7 @@ public:
 	int DelConnection(const uint32_t);
 
 	void UpdateUDPTimeStamp();
+	static void DumpStats(void);
 
 	int UpdatePwrSaveIf(uint32_t);
 	int ResetPwrSaveIf(uint32_t);
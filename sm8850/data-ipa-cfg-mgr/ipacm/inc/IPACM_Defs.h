@@ -108,7 +108,11 @@ extern "C"
 #define NUM_IPV6_PREFIX_MTU_RULE 1
 
 #define MAX_CONNTRACK_ENTRIES 100
-#define CT_ENTRIES_BUFFER_SIZE 8096
+/* conntrack dump receive, datagrams per recvmmsg and size of each */
+#define CT_DUMP_RECV_MSGS 8
+#define CT_DUMP_RECV_BUF_SIZE 16384
+/* nf_conntrack objects kept for reuse between dump entries */
+#define CT_POOL_MAX 256
 #define LOOPBACK_MASK 0xFF000000
 #define LOOPBACK_ADDR 0x7F000000
 
@@ -218,6 +222,15 @@ typedef enum
 	IPACM_EVENT_MAX
 } ipa_cm_event_id;
 
+/* per event dispatch statistics */
+typedef struct
+{
+	uint32_t count;              /* listener callbacks invoked */
+	uint32_t dispatched;         /* events dispatched */
+	uint64_t total_latency_us;   /* time spent dispatching */
+	uint32_t max_latency_us;
+} ipacm_event_stat;
+
 typedef struct
 {
 	uint8_t num_rule;
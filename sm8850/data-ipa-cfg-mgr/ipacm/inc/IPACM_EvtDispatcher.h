@@ -41,20 +41,23 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define IPACM_EvtDispatcher_H
 
 #include <stdio.h>
+#include <pthread.h>
+#include <vector>
 #include <IPACM_CmdQueue.h>
 #include "IPACM_Defs.h"
 #include "IPACM_Listener.h"
 
-/* queue */
-typedef struct _cmd_evts
-{
-	ipa_cm_event_id event;
-	IPACM_Listener *obj;
-	//int ipa_interface_index;
-	_cmd_evts *next;
-}  cmd_evts;
-
+/* preallocated event payloads, further payloads fall back to the heap */
+#define IPACM_EVT_DATA_POOL_SIZE 256
 
+/* payloads posted by the netlink thread for every link, address and neighbor change */
+typedef union _ipacm_evt_data_block
+{
+	union _ipacm_evt_data_block *next;
+	ipacm_event_data_all data_all;
+	ipacm_event_data_addr data_addr;
+	ipacm_event_data_fid data_fid;
+} ipacm_evt_data_block;
 
 class IPACM_EvtDispatcher
 {
@@ -69,8 +72,25 @@ public:
 	static int PostEvt(ipacm_cmd_q_data *);
 	static void ProcessEvt(ipacm_cmd_q_data *);
 
+	/* event payload from the pool, released by ProcessEvt once the event is dispatched */
+	static void *AllocEvtData(size_t size);
+	static void FreeEvtData(void *data);
+	static void dumpStats(void);
+
 private:
-	static cmd_evts *head;
+	/* listeners indexed by event, in registration order */
+	static std::vector<IPACM_Listener *> listeners[IPACM_EVENT_MAX];
+
+	/* callbacks may (de)register listeners, only compact the lists once dispatch is done */
+	static int dispatch_depth;
+	static bool compact_pending;
+
+	static void compact(void);
+
+	static ipacm_evt_data_block data_pool[IPACM_EVT_DATA_POOL_SIZE];
+	static ipacm_evt_data_block *data_pool_free;
+	static pthread_mutex_t data_pool_lock;
+	static uint64_t data_pool_exhausted;
 };
 
 #endif /* IPACM_EvtDispatcher_H */
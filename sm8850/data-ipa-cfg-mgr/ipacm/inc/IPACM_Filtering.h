@@ -55,9 +55,9 @@ class IPACM_Filtering
 public:
 	IPACM_Filtering();
 	~IPACM_Filtering();
-	bool AddFilteringRule(struct ipa_ioc_add_flt_rule const *ruleTable);
-	bool AddFilteringRule_v2(struct ipa_ioc_add_flt_rule_v2 const *ruleTable);
-	bool AddFilteringRuleAfter(struct ipa_ioc_add_flt_rule_after const *ruleTable);
+	bool AddFilteringRule(struct ipa_ioc_add_flt_rule *ruleTable);
+	bool AddFilteringRule_v2(struct ipa_ioc_add_flt_rule_v2 *ruleTable);
+	bool AddFilteringRuleAfter(struct ipa_ioc_add_flt_rule_after *ruleTable);
 #ifdef IPA_IOCTL_SET_FNR_COUNTER_INFO
 	bool AddFilteringRule_hw_index(struct ipa_ioc_add_flt_rule *ruleTable, int hw_counter_index);
 	bool AddFilteringRuleAfter_hw_index(struct ipa_ioc_add_flt_rule_after *ruleTable, int hw_counter_index);
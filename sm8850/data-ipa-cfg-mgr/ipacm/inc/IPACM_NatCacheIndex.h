@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*!
+	@file
+	IPACM_NatCacheIndex.h
+
+	@brief
+	Hash indexes over the NatApp connection cache
+*/
+#ifndef IPACM_NAT_CACHE_INDEX_H
+#define IPACM_NAT_CACHE_INDEX_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+typedef struct _nat_table_entry
+{
+	uint32_t private_ip;
+	uint16_t private_port;
+
+	uint32_t target_ip;
+	uint16_t target_port;
+
+	uint32_t public_ip;
+	uint16_t public_port;
+
+	u_int8_t  protocol;
+	uint32_t timestamp;
+
+	bool dst_nat;
+	bool enabled;
+	uint32_t rule_hdl;
+
+	/* used for pcie-modem */
+	uint32_t rule_id;
+}nat_table_entry;
+
+/*
+ * Indexes the slots of a nat_table_entry array by 5-tuple, by private ip and by target ip, and
+ * keeps the empty slots on a free list. A slot is empty while its 5-tuple is all zero, the
+ * owner fills the 5-tuple and then calls Insert(), and calls Remove() before clearing it.
+ * All operations are O(1) except the ip walks, which are O(entries of that ip).
+ */
+class NatCacheIndex
+{
+public:
+	NatCacheIndex();
+	~NatCacheIndex();
+
+	/* indexes the current content of cache */
+	int Init(const nat_table_entry *cache, int max_entries);
+
+	/* slot holding the 5-tuple of rule, -1 if none */
+	int Find(const nat_table_entry *rule) const;
+
+	/* slot Insert() should use next, -1 if the cache is full */
+	int GetFreeSlot() const { return free_head; }
+
+	void Insert(int slot);
+	void Remove(int slot);
+
+	/* walk the slots of an ip, -1 terminates. Fetch the next slot before removing the current */
+	int FirstByPrivateIp(uint32_t ip) const;
+	int NextByPrivateIp(int slot) const;
+	int FirstByTargetIp(uint32_t ip) const;
+	int NextByTargetIp(int slot) const;
+
+private:
+	enum
+	{
+		IDX_TUPLE,
+		IDX_PRIVATE_IP,
+		IDX_TARGET_IP,
+		IDX_MAX
+	};
+
+	typedef struct
+	{
+		int next;
+		int prev;
+	} slot_link;
+
+	/* free_links prev of a slot that is not on the free list */
+	static const int NOT_FREE = -2;
+
+	const nat_table_entry *cache;
+	int max_entries;
+	uint32_t bucket_mask;
+	int *buckets[IDX_MAX];
+	slot_link *links[IDX_MAX];
+	slot_link *free_links;
+	int free_head;
+
+	static uint32_t HashIp(uint32_t ip);
+	static uint32_t HashTuple(const nat_table_entry *rule);
+	static bool SameTuple(const nat_table_entry *a, const nat_table_entry *b);
+	static bool IsEmpty(const nat_table_entry *entry);
+	uint32_t Bucket(int idx, const nat_table_entry *entry) const;
+
+	void Link(int *head, slot_link *link, int slot);
+	void Unlink(int *head, slot_link *link, int slot);
+	void Release();
+};
+
+#endif /* IPACM_NAT_CACHE_INDEX_H */
@@ -99,6 +99,8 @@ extern "C"
 
 #define MAX_NUM_OF_FD 10
 #define IPA_NL_MSG_MAX_LEN (2048)
+/* netlink messages picked up per read */
+#define IPA_NL_RECV_MSGS 16
 
 /*--------------------------------------------------------------------------- 
 	 Type representing enumeration of NetLink event indication messages
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*!
+	@file
+	IPACM_Replay.h
+
+	@brief
+	Trace format of the IPACM event record/replay shim
+*/
+#ifndef IPACM_REPLAY_H
+#define IPACM_REPLAY_H
+
+#include <stdint.h>
+
+/*
+ * libipacm_replay.so is preloaded into an unmodified ipacm binary.
+ *
+ * With IPACM_REPLAY_RECORD=<trace> (on a device) it passes everything through and
+ * appends to the trace the netlink route and conntrack events ipacm receives, the
+ * messages it reads from /dev/ipa, and the result of every ioctl it issues on the IPA
+ * devices along with the SIOCGIF* interface queries.
+ *
+ * With IPACM_REPLAY_PLAY=<trace> (on any Linux host) the IPA devices and the netlink
+ * sockets are replaced by socket pairs. Events are injected from the trace, ioctls are
+ * answered with the recorded results, and the ioctls ipacm emits are counted and, with
+ * IPACM_REPLAY_RULES=<file>, written out as REPLAY_REC_RULE records. Once the trace is
+ * consumed the latency per event type is printed to stderr (and to
+ * IPACM_REPLAY_REPORT=<file>) and the process exits unless IPACM_REPLAY_EXIT=0.
+ *
+ * Events are injected one at a time by default. The next one goes out once no ioctl has
+ * been seen for IPACM_REPLAY_IDLE_MS (20), and the time from injection to the last
+ * ioctl is that event's latency. With IPACM_REPLAY_FLOOD=1 they are injected back to
+ * back and only the overall throughput is reported.
+ *
+ * Netlink requests ipacm sends are acknowledged and dumps come back empty. Ioctls whose
+ * argument layout is not known here (wwan_ioctl) only get their recorded return value.
+ */
+
+#define IPACM_REPLAY_MAGIC 0x50525049 /* "IPRP" */
+#define IPACM_REPLAY_VERSION 1
+
+typedef enum
+{
+	REPLAY_REC_NL_ROUTE = 1, /* netlink route datagram, sock = event socket ordinal */
+	REPLAY_REC_NL_CT,        /* conntrack netlink datagram, sock = event socket ordinal */
+	REPLAY_REC_IPA_MSG,      /* message read from /dev/ipa */
+	REPLAY_REC_IOCTL,        /* in_len bytes of input then the output, ret is the result */
+	REPLAY_REC_RULE          /* ioctl emitted during replay, sock = index of the event */
+} ipacm_replay_rec_type;
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t version;
+} ipacm_replay_file_hdr;
+
+/* followed by len bytes of payload */
+typedef struct
+{
+	uint32_t type;
+	uint32_t len;
+	uint64_t ts_ns;
+	uint32_t request;
+	uint32_t in_len;
+	int32_t ret;
+	uint32_t sock;
+} ipacm_replay_rec;
+
+#endif /* IPACM_REPLAY_H */
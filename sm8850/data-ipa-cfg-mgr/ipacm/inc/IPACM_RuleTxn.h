@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*!
+	@file
+	IPACM_RuleTxn.h
+
+	@brief
+	Coalesces the header, routing and filtering commits of one event
+*/
+#ifndef IPACM_RULE_TXN_H
+#define IPACM_RULE_TXN_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include <atomic>
+#include <linux/msm_ipa.h>
+#include "IPACM_Defs.h"
+
+typedef enum
+{
+	IPACM_TXN_HDR,
+	IPACM_TXN_RT_V4,
+	IPACM_TXN_RT_V6,
+	IPACM_TXN_FLT_V4,
+	IPACM_TXN_FLT_V6,
+	IPACM_TXN_TABLE_MAX
+} ipacm_txn_table;
+
+/*
+ * The command thread opens a transaction around the dispatch of every event. While it is
+ * open, add and modify requests issued from that thread are sent with commit cleared and
+ * the touched tables are committed once, header first, when the event is done. Rule
+ * handles are still returned by the add ioctls, so handlers keep using them right away.
+ * Deletions flush the pending commits and commit themselves, so that HW never points at a
+ * removed header or routing table. Other threads (NAT, conntrack, HAL) commit immediately,
+ * but flush the pending commits first and hold off the command thread meanwhile, so their
+ * commit never pushes a filtering or routing rule of the transaction ahead of the routing
+ * table or header it points at.
+ */
+class IPACM_RuleTxn
+{
+public:
+	/* opens the device for the commits, before the command thread starts */
+	static void Init(void);
+	static void Begin(void);
+	static void End(ipa_cm_event_id event);
+
+	/* add/modify ioctl whose commit flag is cleared while the transaction defers it */
+	static int Ioctl(int dev_fd, unsigned long request, void *arg, uint8_t *commit, ipacm_txn_table table);
+	/* commits what is pending, before anything that relies on the rules being in HW */
+	static void Flush(void);
+	/*
+	 * Around ioctls which commit on their own (delete, commit, reset), from any thread:
+	 * Lock commits what is pending and holds off other rule changes until Unlock
+	 */
+	static void Lock(void);
+	static void Unlock(void);
+	static void DumpStats(void);
+
+	static ipacm_txn_table RtTable(enum ipa_ip_type ip) { return (ip == IPA_IP_v6) ? IPACM_TXN_RT_V6 : IPACM_TXN_RT_V4; }
+	static ipacm_txn_table FltTable(enum ipa_ip_type ip) { return (ip == IPA_IP_v6) ? IPACM_TXN_FLT_V6 : IPACM_TXN_FLT_V4; }
+
+private:
+	/* guards the transaction state and the rule ioctls issued through it */
+	static pthread_mutex_t lock;
+	static int depth;
+	static pthread_t owner;
+	static uint32_t dirty;
+	static uint64_t start_us;
+	static int fd;
+
+	/* statistics, written under lock, atomic for DumpStats which runs in the SIGHUP handler */
+	static std::atomic<uint64_t> deferred[IPACM_TXN_TABLE_MAX];
+	static std::atomic<uint64_t> committed[IPACM_TXN_TABLE_MAX];
+	static std::atomic<uint64_t> attach_count;
+	static std::atomic<uint64_t> attach_total_us;
+	static std::atomic<uint32_t> attach_max_us;
+
+	/* called with lock held */
+	static bool IsOwner(void);
+	static bool Defer(ipacm_txn_table table);
+	static void FlushLocked(void);
+};
+
+#endif /* IPACM_RULE_TXN_H */
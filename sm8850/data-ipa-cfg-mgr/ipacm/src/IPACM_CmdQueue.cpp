@@ -38,82 +38,174 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 */
 #include <string.h>
+#include <time.h>
+#include <sched.h>
 #include "IPACM_CmdQueue.h"
 #include "IPACM_Log.h"
 #include "IPACM_Iface.h"
 
-pthread_mutex_t mutex    = PTHREAD_MUTEX_INITIALIZER;
-pthread_cond_t  cond_var = PTHREAD_COND_INITIALIZER;
+extern ipacm_event_stat ipacm_event_stats[IPACM_EVENT_MAX];
 
-MessageQueue* MessageQueue::inst_internal = NULL;
-MessageQueue* MessageQueue::inst_external = NULL;
+/* created before any producer thread starts, getInstance*() never races on them */
+MessageQueue* MessageQueue::inst_internal = new MessageQueue("internal");
+MessageQueue* MessageQueue::inst_external = new MessageQueue("external");
+
+Message MessageQueue::pool[IPACM_MSG_POOL_SIZE];
+Message* MessageQueue::pool_free = NULL;
+pthread_mutex_t MessageQueue::pool_lock = PTHREAD_MUTEX_INITIALIZER;
+uint64_t MessageQueue::pool_exhausted = 0;
+static bool pool_initialized = false;
+
+pthread_mutex_t MessageQueue::wait_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t MessageQueue::wait_cond = PTHREAD_COND_INITIALIZER;
+std::atomic<bool> MessageQueue::waiting(false);
+uint64_t MessageQueue::wakeups = 0;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
 
 MessageQueue* MessageQueue::getInstanceInternal()
 {
-	if(inst_internal == NULL)
+	return inst_internal;
+}
+
+MessageQueue* MessageQueue::getInstanceExternal()
+{
+	return inst_external;
+}
+
+Message* MessageQueue::allocMessage(void)
+{
+	Message *item = NULL;
+	int i;
+
+	pthread_mutex_lock(&pool_lock);
+	if(!pool_initialized)
 	{
-		inst_internal = new MessageQueue();
-		if(inst_internal == NULL)
+		for(i = IPACM_MSG_POOL_SIZE - 1; i >= 0; i--)
 		{
-			IPACMERR("unable to create internal Message Queue instance\n");
-			return NULL;
+			pool[i].pooled = true;
+			pool[i].setnext(pool_free);
+			pool_free = &pool[i];
 		}
+		pool_initialized = true;
 	}
 
-	return inst_internal;
-}
+	item = pool_free;
+	if(item != NULL)
+	{
+		pool_free = item->getnext();
+	}
+	else
+	{
+		pool_exhausted++;
+	}
+	pthread_mutex_unlock(&pool_lock);
 
-MessageQueue* MessageQueue::getInstanceExternal()
-{
-	if(inst_external == NULL)
+	if(item == NULL)
 	{
-		inst_external = new MessageQueue();
-		if(inst_external == NULL)
+		item = new Message();
+		if(item == NULL)
 		{
-			IPACMERR("unable to create external Message Queue instance\n");
 			return NULL;
 		}
 	}
 
-	return inst_external;
+	item->setnext(NULL);
+	item->evt.callback_ptr = NULL;
+	return item;
+}
+
+void MessageQueue::freeMessage(Message *item)
+{
+	if(!item->pooled)
+	{
+		delete item;
+		return;
+	}
+
+	pthread_mutex_lock(&pool_lock);
+	item->setnext(pool_free);
+	pool_free = item;
+	pthread_mutex_unlock(&pool_lock);
+}
+
+void MessageQueue::push(Message *item)
+{
+	Message *prev;
+
+	item->setnext(NULL);
+	prev = Head.exchange(item, std::memory_order_acq_rel);
+	/* until the link below is stored the consumer sees the queue end at prev */
+	prev->setnext(item);
 }
 
 void MessageQueue::enqueue(Message *item)
 {
-	if(!Head)
+	uint32_t cur_depth, max_depth;
+
+	/* count before linking, so the decrement of dequeue never runs ahead of it */
+	item->enqueue_ns = now_ns();
+	enqueued.fetch_add(1, std::memory_order_relaxed);
+	cur_depth = depth.fetch_add(1) + 1;
+	max_depth = depth_max.load(std::memory_order_relaxed);
+	while(cur_depth > max_depth &&
+		!depth_max.compare_exchange_weak(max_depth, cur_depth, std::memory_order_relaxed))
 	{
-		Tail = item;
-		Head = item;
 	}
-	else
+
+	push(item);
+
+	/* pairs with the depth check of the consumer, only take the lock when it may sleep */
+	if(waiting.load())
 	{
-		if(Tail == NULL)
-		{
-			IPACMDBG("Tail is null\n");
-			Head->setnext(item);
-		}
-		else
-		{
-			Tail->setnext(item);
-		}
-		Tail = item;
+		pthread_mutex_lock(&wait_lock);
+		pthread_cond_signal(&wait_cond);
+		pthread_mutex_unlock(&wait_lock);
 	}
 }
 
 
 Message* MessageQueue::dequeue(void)
 {
-	if(Head == NULL)
+	Message *tail = Tail;
+	Message *next = tail->getnext();
+
+	if(tail == &stub)
 	{
-		return NULL;
+		if(next == NULL)
+		{
+			return NULL;
+		}
+		Tail = next;
+		tail = next;
+		next = next->getnext();
 	}
-	else
-	{
-		Message *tmp = Head;
-		Head = Head->getnext();
 
-		return tmp;
+	if(next == NULL)
+	{
+		if(tail != Head.load(std::memory_order_acquire))
+		{
+			/* a producer is in the middle of push, retry on the next round */
+			return NULL;
+		}
+		/* tail is the last message, put the stub behind it so it can be handed out */
+		push(&stub);
+		next = tail->getnext();
+		if(next == NULL)
+		{
+			return NULL;
+		}
 	}
+
+	Tail = next;
+	depth.fetch_sub(1, std::memory_order_relaxed);
+	return tail;
 }
 
 
@@ -121,9 +213,12 @@ void* MessageQueue::Process(void *param)
 {
 	MessageQueue *MsgQueueInternal = NULL;
 	MessageQueue *MsgQueueExternal = NULL;
+	MessageQueue *MsgQueue = NULL;
 	Message *item = NULL;
 	param = NULL;
 	const char *eventName = NULL;
+	uint64_t wait_us;
+	int batch;
 
 	IPACMDBG("MessageQueue::Process()\n");
 
@@ -143,74 +238,120 @@ void* MessageQueue::Process(void *param)
 
 	while(1)
 	{
-		if(pthread_mutex_lock(&mutex) != 0)
+		/* internal events always go first, also within a batch */
+		for(batch = 0; batch < IPACM_MSG_BATCH_SIZE; batch++)
 		{
-			IPACMERR("unable to lock the mutex\n");
-			return NULL;
-		}
-
-		item = MsgQueueInternal->dequeue();
-		if(item == NULL)
-		{
-			item = MsgQueueExternal->dequeue();
-			if(item)
+			MsgQueue = MsgQueueInternal;
+			item = MsgQueue->dequeue();
+			if(item == NULL)
 			{
-				eventName = IPACM_Iface::ipacmcfg->getEventName(item->evt.data.event);
-				if (eventName != NULL)
-				{
-					IPACMDBG("Get event %s from external queue.\n",
-							eventName);
-				}
+				MsgQueue = MsgQueueExternal;
+				item = MsgQueue->dequeue();
 			}
-		}
-		else
-		{
-			eventName = IPACM_Iface::ipacmcfg->getEventName(item->evt.data.event);
-			if (eventName != NULL)
+			if(item == NULL)
 			{
-				IPACMDBG("Get event %s from internal queue.\n",
-					eventName);
+				break;
 			}
-		}
-
-		if(item == NULL)
-		{
-			IPACMDBG("Waiting for Message\n");
 
-			if(pthread_cond_wait(&cond_var, &mutex) != 0)
+			eventName = IPACM_Iface::ipacmcfg->getEventName(item->evt.data.event);
+			if (eventName != NULL)
 			{
-				IPACMERR("unable to lock the mutex\n");
-
-				if(pthread_mutex_unlock(&mutex) != 0)
-				{
-					IPACMERR("unable to unlock the mutex\n");
-					return NULL;
-				}
-
-				return NULL;
+				IPACMDBG("Get event %s from %s queue.\n", eventName, MsgQueue->name);
 			}
 
-			if(pthread_mutex_unlock(&mutex) != 0)
+			wait_us = (now_ns() - item->enqueue_ns) / 1000;
+			MsgQueue->processed++;
+			MsgQueue->wait_total_us += wait_us;
+			if(wait_us > MsgQueue->wait_max_us)
 			{
-				IPACMERR("unable to unlock the mutex\n");
-				return NULL;
+				MsgQueue->wait_max_us = (uint32_t)wait_us;
 			}
 
+			IPACMDBG("Processing item %pK event ID: %d\n",item,item->evt.data.event);
+			item->evt.callback_ptr(&item->evt.data);
+			freeMessage(item);
+			item = NULL;
 		}
-		else
+
+		if(batch == IPACM_MSG_BATCH_SIZE)
 		{
-			if(pthread_mutex_unlock(&mutex) != 0)
+			continue;
+		}
+
+		if(pthread_mutex_lock(&wait_lock) != 0)
+		{
+			IPACMERR("unable to lock the mutex\n");
+			return NULL;
+		}
+
+		waiting.store(true);
+		if(MsgQueueInternal->depth.load() == 0 && MsgQueueExternal->depth.load() == 0)
+		{
+			IPACMDBG("Waiting for Message\n");
+			if(pthread_cond_wait(&wait_cond, &wait_lock) != 0)
 			{
-				IPACMERR("unable to unlock the mutex\n");
+				IPACMERR("unable to wait on the condition\n");
+				waiting.store(false);
+				pthread_mutex_unlock(&wait_lock);
 				return NULL;
 			}
+			wakeups++;
+		}
+		waiting.store(false);
 
-			IPACMDBG("Processing item %pK event ID: %d\n",item,item->evt.data.event);
-			item->evt.callback_ptr(&item->evt.data);
-			delete item;
-			item = NULL;
+		if(pthread_mutex_unlock(&wait_lock) != 0)
+		{
+			IPACMERR("unable to unlock the mutex\n");
+			return NULL;
+		}
+
+		if(batch == 0 && (MsgQueueInternal->depth.load() || MsgQueueExternal->depth.load()))
+		{
+			/* messages are counted but a producer has not linked them yet */
+			sched_yield();
 		}
 
 	} /* Go forever until a termination indication is received */
 
 }
+
+void MessageQueue::dumpStats(void)
+{
+	MessageQueue *queues[] = { inst_internal, inst_external };
+	MessageQueue *queue;
+	const char *eventName;
+	unsigned int i;
+	int event;
+
+	for(i = 0; i < sizeof(queues) / sizeof(queues[0]); i++)
+	{
+		queue = queues[i];
+		if(queue == NULL)
+		{
+			continue;
+		}
+		IPACMDBG_H("%s queue: enqueued %llu processed %llu depth %u max depth %u wait avg %lluus max %uus\n",
+			queue->name, (unsigned long long)queue->enqueued.load(),
+			(unsigned long long)queue->processed, queue->depth.load(), queue->depth_max.load(),
+			(unsigned long long)(queue->processed ? queue->wait_total_us / queue->processed : 0),
+			queue->wait_max_us);
+	}
+	IPACMDBG_H("message pool: %d messages, exhausted %llu times, consumer wakeups %llu\n",
+		IPACM_MSG_POOL_SIZE, (unsigned long long)pool_exhausted,
+		(unsigned long long)wakeups);
+
+	for(event = 0; event < IPACM_EVENT_MAX; event++)
+	{
+		if(ipacm_event_stats[event].dispatched == 0)
+		{
+			continue;
+		}
+		eventName = IPACM_Iface::ipacmcfg->getEventName((ipa_cm_event_id)event);
+		IPACMDBG_H("event %s: dispatched %u callbacks %u latency avg %lluus max %uus\n",
+			eventName != NULL ? eventName : "unknown", ipacm_event_stats[event].dispatched,
+			ipacm_event_stats[event].count,
+			(unsigned long long)(ipacm_event_stats[event].total_latency_us /
+				ipacm_event_stats[event].dispatched),
+			ipacm_event_stats[event].max_latency_us);
+	}
+}
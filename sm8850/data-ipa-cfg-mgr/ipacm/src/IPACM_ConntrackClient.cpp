@@ -129,6 +129,13 @@ int IPACM_ConntrackClient::IPAConntrackEventCB
 
 #endif
 
+	/* IPv4 events are classified by the worker of their flow, off the command queue */
+	if(AF_INET == ip_type && IPACM_ConntrackWorkers::IsStarted())
+	{
+		IPACM_ConntrackWorkers::Dispatch(ct, type);
+		return NFCT_CB_STOLEN;
+	}
+
 	ct_data = (ipacm_ct_evt_data *)malloc(sizeof(ipacm_ct_evt_data));
 	if(ct_data == NULL)
 	{
@@ -516,6 +523,11 @@ ctcatch:
 	else
 	{
 		IPACMDBG("ctcatch ret:%d, errno:%d\n", ret, errno);
+		if(ret == -1 && errno == ENOBUFS)
+		{
+			/* the socket overran, the kernel dropped events */
+			IPACM_ConntrackWorkers::CountKernelDrop();
+		}
 		goto ctcatch;
 	}
 
@@ -606,6 +618,11 @@ ctcatch:
 	else
 	{
 		IPACMDBG("ctcatch ret:%d, errno:%d\n", ret, errno);
+		if(ret == -1 && errno == ENOBUFS)
+		{
+			/* the socket overran, the kernel dropped events */
+			IPACM_ConntrackWorkers::CountKernelDrop();
+		}
 		goto ctcatch;
 	}
 
@@ -63,6 +63,7 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
 
 #include <sys/ioctl.h>
 #include <net/if.h>
+#include <time.h>
 
 #include "IPACM_ConntrackListener.h"
 #include "IPACM_ConntrackClient.h"
@@ -84,7 +85,13 @@ IPACM_ConntrackListener::IPACM_ConntrackListener()
 	 NatIfaceCnt = 0;
 	 StaClntCnt = 0;
 	 pNatIfaces = NULL;
-	 ct_entries = NULL;
+	 pthread_mutex_init(&ct_dump_lock, NULL);
+	 pthread_rwlock_init(&ct_cfg_lock, NULL);
+	 pthread_mutex_init(&ct_cache_lock, NULL);
+	 ct_blank = NULL;
+	 ct_sync_start_us = 0;
+	 ct_sync_received = 0;
+	 ct_sync_processed = 0;
 	 pConfig = IPACM_Config::GetInstance();;
 
 	 memset(nat_iface_ipv4_addr, 0, sizeof(nat_iface_ipv4_addr));
@@ -120,6 +127,16 @@ void IPACM_ConntrackListener::event_callback(ipa_cm_event_id evt,
 		 return;
 	 }
 
+	 /* everything but the conntrack messages may change what the workers classify against */
+	 if(evt == IPA_PROCESS_CT_MESSAGE || evt == IPA_PROCESS_CT_MESSAGE_V6)
+	 {
+		 pthread_rwlock_rdlock(&ct_cfg_lock);
+	 }
+	 else
+	 {
+		 pthread_rwlock_wrlock(&ct_cfg_lock);
+	 }
+
 	 switch(evt)
 	 {
 	 case IPA_PROCESS_CT_MESSAGE:
@@ -187,6 +204,8 @@ void IPACM_ConntrackListener::event_callback(ipa_cm_event_id evt,
 			IPACMDBG("Ignore cmd %d\n", evt);
 			break;
 	 }
+
+	 pthread_rwlock_unlock(&ct_cfg_lock);
 }
 
 int IPACM_ConntrackListener::CheckNatIface(
@@ -334,6 +353,7 @@ void IPACM_ConntrackListener::HandleNonNatIPAddr(
 void IPACM_ConntrackListener::HandleNeighIpAddrAddEvt(
    ipacm_event_data_all *data)
 {
+	CtCfgWriteGuard guard(&ct_cfg_lock);
 	bool NatIface = false;
 	int j, ret;
 
@@ -368,6 +388,7 @@ void IPACM_ConntrackListener::HandleNeighIpAddrAddEvt(
 void IPACM_ConntrackListener::HandleNeighIpAddrDelEvt(
    uint32_t ipv4_addr)
 {
+	CtCfgWriteGuard guard(&ct_cfg_lock);
 	int cnt;
 
 	if(ipv4_addr == 0)
@@ -444,6 +465,12 @@ int IPACM_ConntrackListener::CreateConnTrackThreads(void)
 
 	if(isCTReg == false)
 	{
+		/* without workers the events go through the command queue as before */
+		if(IPACM_ConntrackWorkers::Start() != 0)
+		{
+			IPACMERR("unable to start conntrack workers\n");
+		}
+
 		ret = pthread_create(&tcp_thread, NULL, IPACM_ConntrackClient::TCPRegisterWithConnTrack, NULL);
 		if(0 != ret)
 		{
@@ -751,6 +778,65 @@ void IPACM_ConntrackListener::ProcessCTMessage(void *param)
 	 return;
 }
 
+/*
+ * Runs on a conntrack worker. The events of the batch are classified in parallel with the
+ * other workers, then written to the NAT table under a single NatApp lock.
+ */
+void IPACM_ConntrackListener::ProcessCTBatch(ct_work_item *batch, int num)
+{
+	nat_table_entry rule[CT_WORKER_BATCH];
+	nat_entry_bundle nat_entry[CT_WORKER_BATCH];
+	bool add_entry[CT_WORKER_BATCH], cache_ct[CT_WORKER_BATCH];
+	u_int8_t l4proto[CT_WORKER_BATCH];
+	int cnt, num_add = 0;
+
+	pthread_rwlock_rdlock(&ct_cfg_lock);
+	for(cnt = 0; cnt < num; cnt++)
+	{
+		add_entry[cnt] = false;
+		cache_ct[cnt] = false;
+		l4proto[cnt] = nfct_get_attr_u8(batch[cnt].ct, ATTR_ORIG_L4PROTO);
+		if(IPPROTO_UDP != l4proto[cnt] && IPPROTO_TCP != l4proto[cnt])
+		{
+			IPACMDBG("Received unexpected protocl %d conntrack message\n", l4proto[cnt]);
+			continue;
+		}
+		add_entry[cnt] = ClassifyTCPorUDPMsg(batch[cnt].ct, batch[cnt].type, l4proto[cnt],
+			&rule[cnt], &nat_entry[cnt], &cache_ct[cnt]);
+		if(add_entry[cnt])
+		{
+			num_add++;
+		}
+	}
+
+	if(num_add > 0)
+	{
+		nat_inst->Lock();
+		for(cnt = 0; cnt < num; cnt++)
+		{
+			if(add_entry[cnt])
+			{
+				AddORDeleteNatEntry(&nat_entry[cnt]);
+			}
+		}
+		nat_inst->Unlock();
+	}
+
+	for(cnt = 0; cnt < num; cnt++)
+	{
+		if(cache_ct[cnt])
+		{
+			CacheORDeleteConntrack(batch[cnt].ct, batch[cnt].type, l4proto[cnt]);
+		}
+		else
+		{
+			nfct_destroy(batch[cnt].ct);
+		}
+	}
+	pthread_rwlock_unlock(&ct_cfg_lock);
+	return;
+}
+
 bool IPACM_ConntrackListener::AddIface(
    nat_table_entry *rule, bool *isTempEntry)
 {
@@ -1090,29 +1176,52 @@ void IPACM_ConntrackListener::CheckSTAClient(
 	*isTempEntry = true;
 }
 
-/* conntrack send in host order and ipa expects in host order */
 bool IPACM_ConntrackListener::ProcessTCPorUDPMsg(
 	 struct nf_conntrack *ct,
 	 enum nf_conntrack_msg_type type,
 	 u_int8_t l4proto)
 {
-	 nat_table_entry rule;
+	nat_table_entry rule;
+	nat_entry_bundle nat_entry;
+	bool cache_ct = false;
+
+	if(ClassifyTCPorUDPMsg(ct, type, l4proto, &rule, &nat_entry, &cache_ct))
+	{
+		AddORDeleteNatEntry(&nat_entry);
+	}
+	return cache_ct;
+}
+
+/*
+ * Builds the NAT rule of a conntrack event into rule and nat_entry, without touching the
+ * NAT table. Returns true when AddORDeleteNatEntry() should be called with nat_entry,
+ * *cache_ct tells whether the event must be kept until WAN is up.
+ * conntrack send in host order and ipa expects in host order
+ */
+bool IPACM_ConntrackListener::ClassifyTCPorUDPMsg(
+	 struct nf_conntrack *ct,
+	 enum nf_conntrack_msg_type type,
+	 u_int8_t l4proto,
+	 nat_table_entry *rule,
+	 nat_entry_bundle *nat_entry,
+	 bool *cache_ct)
+{
 	 uint32_t status = 0;
 	 uint32_t orig_src_ip, orig_dst_ip;
 	 bool isAdd = false;
-	 bool cache_ct = false;
 
-	 nat_entry_bundle nat_entry;
-	 nat_entry.isTempEntry = false;
-	 nat_entry.ct = ct;
-	 nat_entry.type = type;
+	 nat_entry->isTempEntry = false;
+	 nat_entry->ct = ct;
+	 nat_entry->type = type;
+	 nat_entry->rule = rule;
+	 *cache_ct = false;
 
-	memset(&rule, 0, sizeof(rule));
+	memset(rule, 0, sizeof(*rule));
 	IPACMDBG("Received type:%d with proto:%d\n", type, l4proto);
 	status = nfct_get_attr_u32(ct, ATTR_STATUS);
 
 	 /* Retrieve Protocol */
-	 rule.protocol = nfct_get_attr_u8(ct, ATTR_REPL_L4PROTO);
+	 rule->protocol = nfct_get_attr_u8(ct, ATTR_REPL_L4PROTO);
 
 	 if(IPS_DST_NAT & status)
 	 {
@@ -1130,7 +1239,7 @@ bool IPACM_ConntrackListener::ProcessTCPorUDPMsg(
 		 if(orig_src_ip == 0)
 		 {
 			 IPACMERR("unable to retrieve orig src ip address\n");
-			 return cache_ct;
+			 return false;
 		 }
 
 		 orig_dst_ip = nfct_get_attr_u32(ct, ATTR_ORIG_IPV4_DST);
@@ -1138,7 +1247,7 @@ bool IPACM_ConntrackListener::ProcessTCPorUDPMsg(
 		 if(orig_dst_ip == 0)
 		 {
 			 IPACMERR("unable to retrieve orig dst ip address\n");
-			 return cache_ct;
+			 return false;
 		 }
 
 		if(orig_src_ip == wan_ipaddr)
@@ -1157,22 +1266,22 @@ bool IPACM_ConntrackListener::ProcessTCPorUDPMsg(
 					   orig_src_ip, orig_dst_ip, wan_ipaddr);
 
 #ifdef CT_OPT
-			HandleLan2Lan(ct, type, &rule);
+			HandleLan2Lan(ct, type, rule);
 #endif
 		 	IPACMDBG("Neither source Nor destination nat.\n");
 			/* If WAN is not up, cache the event. */
 			if(!CtList->isWanUp())
-				cache_ct = true;
+				*cache_ct = true;
 			goto IGNORE;
 		}
 	}
 
-	PopulateTCPorUDPEntry(ct, status, &rule);
-	rule.public_ip = wan_ipaddr;
+	PopulateTCPorUDPEntry(ct, status, rule);
+	rule->public_ip = wan_ipaddr;
 
-	if (rule.private_ip != wan_ipaddr)
+	if (rule->private_ip != wan_ipaddr)
 	{
-		isAdd = AddIface(&rule, &nat_entry.isTempEntry);
+		isAdd = AddIface(rule, &nat_entry->isTempEntry);
 		if (!isAdd)
 		{
 			goto IGNORE;
@@ -1191,28 +1300,27 @@ bool IPACM_ConntrackListener::ProcessTCPorUDPMsg(
 
 		IPACMDBG("For embedded connections add dummy nat rule\n");
 		IPACMDBG("Change private port %d to %d\n",
-				rule.private_port, rule.public_port);
-		rule.private_port = rule.public_port;
+				rule->private_port, rule->public_port);
+		rule->private_port = rule->public_port;
 	}
 
-	CheckSTAClient(&rule, &nat_entry.isTempEntry);
-	nat_entry.rule = &rule;
-	AddORDeleteNatEntry(&nat_entry);
-	return cache_ct;
+	CheckSTAClient(rule, &nat_entry->isTempEntry);
+	return true;
 
 IGNORE:
 	IPACMDBG_H("ignoring below Nat Entry\n");
-	iptodot("ProcessTCPorUDPMsg(): target ip or dst ip", rule.target_ip);
-	IPACMDBG("target port or dst port: 0x%x Decimal:%d\n", rule.target_port, rule.target_port);
-	iptodot("ProcessTCPorUDPMsg(): private ip or src ip", rule.private_ip);
-	IPACMDBG("private port or src port: 0x%x, Decimal:%d\n", rule.private_port, rule.private_port);
-	IPACMDBG("public port or reply dst port: 0x%x, Decimal:%d\n", rule.public_port, rule.public_port);
-	IPACMDBG("Protocol: %d, destination nat flag: %d\n", rule.protocol, rule.dst_nat);
-	return cache_ct;
+	iptodot("ProcessTCPorUDPMsg(): target ip or dst ip", rule->target_ip);
+	IPACMDBG("target port or dst port: 0x%x Decimal:%d\n", rule->target_port, rule->target_port);
+	iptodot("ProcessTCPorUDPMsg(): private ip or src ip", rule->private_ip);
+	IPACMDBG("private port or src port: 0x%x, Decimal:%d\n", rule->private_port, rule->private_port);
+	IPACMDBG("public port or reply dst port: 0x%x, Decimal:%d\n", rule->public_port, rule->public_port);
+	IPACMDBG("Protocol: %d, destination nat flag: %d\n", rule->protocol, rule->dst_nat);
+	return false;
 }
 
 void IPACM_ConntrackListener::HandleSTAClientAddEvt(uint32_t clnt_ip_addr)
 {
+	 CtCfgWriteGuard guard(&ct_cfg_lock);
 	 int cnt;
 	 IPACMDBG_H("Received STA client 0x%x\n", clnt_ip_addr);
 
@@ -1249,6 +1357,7 @@ void IPACM_ConntrackListener::HandleSTAClientAddEvt(uint32_t clnt_ip_addr)
 
 void IPACM_ConntrackListener::HandleSTAClientDelEvt(uint32_t clnt_ip_addr)
 {
+	 CtCfgWriteGuard guard(&ct_cfg_lock);
 	 int cnt;
 	 IPACMDBG_H("Received STA client 0x%x\n", clnt_ip_addr);
 
@@ -1280,167 +1389,280 @@ bool isLocalHostAddr(uint32_t src_ip_addr, uint32_t dst_ip_addr) {
 	return false;
 }
 
-void IPACM_ConntrackListener::readConntrack(int fd) {
+static uint64_t now_us(void)
+{
+	struct timespec ts;
 
-	int recv_bytes = -1, index = 0, len =0;
-	char buffer[CT_ENTRIES_BUFFER_SIZE];
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+}
+
+struct nf_conntrack *IPACM_ConntrackListener::GetPooledCt(void)
+{
 	struct nf_conntrack *ct;
-	struct nlmsghdr *nl_header;
-   	struct iovec iov = {
-		.iov_base	= buffer,
-		.iov_len	= CT_ENTRIES_BUFFER_SIZE,
-	};
-	struct sockaddr_nl addr;
-	struct msghdr msg = {
-		.msg_name	= &addr,
-		.msg_namelen	= sizeof(struct sockaddr_nl),
-		.msg_iov	= &iov,
-		.msg_iovlen	= 1,
-		.msg_control	= NULL,
-		.msg_controllen	= 0,
-		.msg_flags	= 0,
-	};
-
-	len = MAX_CONNTRACK_ENTRIES * sizeof(ct_entry);
-
-	ct_entries = (ct_entry *) malloc(len);
-	if(ct_entries == NULL)
-	{
-		IPACMERR("unable to allocate ct_entries memory \n");
+
+	if(ct_pool.empty())
+	{
+		return nfct_new();
+	}
+	ct = ct_pool.back();
+	ct_pool.pop_back();
+	return ct;
+}
+
+void IPACM_ConntrackListener::PutPooledCt(struct nf_conntrack *ct)
+{
+	if(ct_blank == NULL || ct_pool.size() >= CT_POOL_MAX)
+	{
+		nfct_destroy(ct);
+		return;
+	}
+	/* drop the attributes of the previous entry before the object is parsed into again */
+	nfct_copy(ct, ct_blank, NFCT_CP_OVERRIDE);
+	ct_pool.push_back(ct);
+}
+
+/* the pool only serves the conntrack dump, it is given back once the dump is offloaded */
+void IPACM_ConntrackListener::ReleaseCtPool(void)
+{
+	size_t index;
+
+	for(index = 0; index < ct_pool.size(); index++)
+	{
+		nfct_destroy(ct_pool[index]);
+	}
+	std::vector<struct nf_conntrack *>().swap(ct_pool);
+	if(ct_blank != NULL)
+	{
+		nfct_destroy(ct_blank);
+		ct_blank = NULL;
+	}
+}
+
+/* offloads one conntrack dump entry, ct goes back to the pool unless it is consumed */
+void IPACM_ConntrackListener::ProcessDumpEntry(struct nf_conntrack *ct, enum nf_conntrack_msg_type type)
+{
+	struct nf_conntrack *cache_ct;
+	uint8_t ip_type, l4proto;
+#ifdef CT_OPT
+	ipacm_ct_evt_data ct_data;
+#endif
+
+	ct_sync_processed++;
+	ip_type = nfct_get_attr_u8(ct, ATTR_REPL_L3PROTO);
+	if((AF_INET == ip_type) && isLocalHostAddr(nfct_get_attr_u32(ct, ATTR_ORIG_IPV4_SRC),
+			nfct_get_attr_u32(ct, ATTR_ORIG_IPV4_DST)))
+	{
+		IPACMDBG(" loopback entry \n");
+		PutPooledCt(ct);
 		return;
 	}
-	memset(ct_entries, 0, len);
+
+	if(AF_INET6 == ip_type)
+	{
+#ifdef CT_OPT
+		/* ProcessCTV6Message destroys the entry */
+		ct_data.ct = ct;
+		ct_data.type = type;
+		ProcessCTV6Message(&ct_data);
+#else
+		IPACMDBG("Ignoring ipv6(%d) connections\n", ip_type);
+		PutPooledCt(ct);
+#endif
+		return;
+	}
+
+	l4proto = nfct_get_attr_u8(ct, ATTR_ORIG_L4PROTO);
+	if(IPPROTO_UDP != l4proto && IPPROTO_TCP != l4proto)
+	{
+		IPACMDBG("Received unexpected protocl %d conntrack message\n", l4proto);
+	}
+	else if(ProcessTCPorUDPMsg(ct, type, l4proto))
+	{
+		/* the CT cache keeps its entries, hand it a copy so that ct can be reused */
+		cache_ct = nfct_clone(ct);
+		if(cache_ct != NULL)
+		{
+			CacheORDeleteConntrack(cache_ct, type, l4proto);
+		}
+		else
+		{
+			IPACMERR("unable to clone ct entry\n");
+		}
+	}
+	PutPooledCt(ct);
+}
+
+/* called with ct_dump_lock held */
+void IPACM_ConntrackListener::ProcessPendingConntrack(void)
+{
+	size_t index;
+
+	for(index = 0; index < ct_pending.size(); index++)
+	{
+		ProcessDumpEntry(ct_pending[index].ct, ct_pending[index].type);
+	}
+	ct_pending.clear();
+}
+
+/*
+ * Reads the conntrack dump the framework left on fd. Several datagrams are received per
+ * recvmmsg() and parsed into pooled nf_conntrack objects. Once WAN is up each batch is
+ * offloaded as soon as it is parsed, before that the entries wait in ct_pending for
+ * processConntrack().
+ */
+void IPACM_ConntrackListener::readConntrack(int fd) {
+
+	struct mmsghdr msgs[CT_DUMP_RECV_MSGS];
+	struct iovec iov[CT_DUMP_RECV_MSGS];
+	struct nlmsghdr *nl_header;
+	struct nf_conntrack *ct;
+	ct_entry entry;
+	char *buffer;
+	int num_msgs, cnt, recv_bytes, parse_result;
+	bool done = false;
 
 	if( fd < 0)
 	{
 		IPACMDBG_H("Invalid fd %d \n",fd);
-		free(ct_entries);
 		return;
 	}
+
+	buffer = (char *)malloc(CT_DUMP_RECV_MSGS * CT_DUMP_RECV_BUF_SIZE);
+	if(buffer == NULL)
+	{
+		IPACMERR("unable to allocate conntrack receive buffer \n");
+		return;
+	}
+	memset(msgs, 0, sizeof(msgs));
+	for(cnt = 0; cnt < CT_DUMP_RECV_MSGS; cnt++)
+	{
+		iov[cnt].iov_base = buffer + cnt * CT_DUMP_RECV_BUF_SIZE;
+		iov[cnt].iov_len = CT_DUMP_RECV_BUF_SIZE;
+		msgs[cnt].msg_hdr.msg_iov = &iov[cnt];
+		msgs[cnt].msg_hdr.msg_iovlen = 1;
+	}
+
+	pthread_mutex_lock(&ct_dump_lock);
+	ct_sync_start_us = now_us();
+	ct_sync_received = 0;
+	ct_sync_processed = 0;
+	isReadCTDone = false;
+	if(ct_blank == NULL)
+	{
+		ct_pool.reserve(CT_POOL_MAX);
+		ct_blank = nfct_new();
+	}
+	pthread_mutex_unlock(&ct_dump_lock);
+
 	IPACMDBG_H("receiving conntrack entries started.\n");
-	len = CT_ENTRIES_BUFFER_SIZE;
-	while (len > 0)
+	while(!done)
 	{
-		memset(buffer, 0, CT_ENTRIES_BUFFER_SIZE);
-		recv_bytes = recvmsg(fd, &msg, 0);
-		if(recv_bytes < 0)
+		/* waits up to the socket receive timeout for the first datagram, not for the others */
+		num_msgs = recvmmsg(fd, msgs, CT_DUMP_RECV_MSGS, MSG_WAITFORONE, NULL);
+		if(num_msgs <= 0)
 		{
 			IPACMDBG_H("error in receiving conntrack entries %d%s\n",errno, strerror(errno));
 			break;
 		}
-		else
+
+		pthread_rwlock_rdlock(&ct_cfg_lock);
+		pthread_mutex_lock(&ct_dump_lock);
+		if(isWanUp() && !ct_pending.empty())
 		{
-			len -= recv_bytes;
-			nl_header = (struct nlmsghdr *)buffer;
-			IPACMDBG_H("Number of bytes:%d to parse\n", recv_bytes);
-			while(NLMSG_OK(nl_header, recv_bytes) && (index < MAX_CONNTRACK_ENTRIES))
+			ProcessPendingConntrack();
+		}
+		for(cnt = 0; cnt < num_msgs && !done; cnt++)
+		{
+			recv_bytes = msgs[cnt].msg_len;
+			for(nl_header = (struct nlmsghdr *)iov[cnt].iov_base; NLMSG_OK(nl_header, recv_bytes);
+				nl_header = NLMSG_NEXT(nl_header, recv_bytes))
 			{
-				if (nl_header->nlmsg_type == NLMSG_ERROR)
+				if(nl_header->nlmsg_type == NLMSG_DONE)
 				{
-					IPACMDBG_H("Error, recv_bytes is %d\n",recv_bytes);
+					IPACMDBG_H("Message is done.\n");
+					done = true;
 					break;
 				}
-				ct = nfct_new();
-				if (ct != NULL)
+				if(nl_header->nlmsg_type == NLMSG_ERROR)
 				{
-					int parseResult =  nfct_parse_conntrack((nf_conntrack_msg_type) NFCT_T_ALL,nl_header, ct);
-					if(parseResult != NFCT_T_ERROR && parseResult != 0)
-					{
-						ct_entries[index].ct = ct;
-						ct_entries[index++].type = (nf_conntrack_msg_type)parseResult;
-					}
-					else
-					{
-						IPACMDBG_H("error in parsing  %d%s \n", errno, strerror(errno));
-						nfct_destroy(ct);
-					}
+					IPACMDBG_H("Error, recv_bytes is %d\n",recv_bytes);
+					done = true;
+					break;
 				}
-				else
+
+				ct = GetPooledCt();
+				if(ct == NULL)
 				{
 					IPACMDBG_H("ct allocation failed\n");
+					continue;
 				}
-				if (nl_header->nlmsg_type == NLMSG_DONE)
+				parse_result = nfct_parse_conntrack(NFCT_T_ALL, nl_header, ct);
+				if(parse_result == NFCT_T_ERROR || parse_result == 0)
 				{
-					IPACMDBG_H("Message is done.\n");
-					break;
+					IPACMDBG_H("error in parsing  %d%s \n", errno, strerror(errno));
+					PutPooledCt(ct);
+					continue;
+				}
+
+				ct_sync_received++;
+				if(isWanUp())
+				{
+					ProcessDumpEntry(ct, (nf_conntrack_msg_type)parse_result);
+				}
+				else
+				{
+					entry.ct = ct;
+					entry.protocol = 0;
+					entry.type = (nf_conntrack_msg_type)parse_result;
+					ct_pending.push_back(entry);
+					isProcessCTDone = false;
 				}
-				nl_header = NLMSG_NEXT(nl_header, recv_bytes);
 			}
 		}
+		pthread_mutex_unlock(&ct_dump_lock);
+		pthread_rwlock_unlock(&ct_cfg_lock);
 	}
+	free(buffer);
 
+	pthread_mutex_lock(&ct_dump_lock);
 	isReadCTDone = true;
-	IPACMDBG_H("receiving conntrack entries ended. No of entries: %d\n", index);
-	if(isWanUp() && !isProcessCTDone)
+	pthread_mutex_unlock(&ct_dump_lock);
+	IPACMDBG_H("receiving conntrack entries ended. No of entries: %d\n", ct_sync_received);
+	pthread_rwlock_rdlock(&ct_cfg_lock);
+	if(isWanUp())
 	{
 		IPACMDBG_H("wan is up, process ct entries \n");
 		processConntrack();
 	}
+	pthread_rwlock_unlock(&ct_cfg_lock);
 
 	return ;
 }
 
 void IPACM_ConntrackListener::processConntrack() {
 
-	uint8_t ip_type;
-	int index = 0;
-	ipacm_ct_evt_data *ct_data;
-	IPACMDBG_H("process conntrack started \n");
-	if(ct_entries != NULL)
-	{
-		while(ct_entries[index].ct != NULL)
-		{
-			ip_type = nfct_get_attr_u8(ct_entries[index].ct, ATTR_REPL_L3PROTO);
-			if((AF_INET == ip_type) && isLocalHostAddr(nfct_get_attr_u32(ct_entries[index].ct, ATTR_ORIG_IPV4_SRC),
-					nfct_get_attr_u32(ct_entries[index].ct, ATTR_ORIG_IPV4_DST)))
-			{
-				IPACMDBG_H(" loopback entry \n");
-				goto IGNORE;
-			}
-
-#ifndef CT_OPT
-			if(AF_INET6 == ip_type)
-			{
-				IPACMDBG("Ignoring ipv6(%d) connections\n", ip_type);
-				goto IGNORE;
-			}
-#endif
-
-			ct_data = (ipacm_ct_evt_data *)malloc(sizeof(ipacm_ct_evt_data));
-			if(ct_data == NULL)
-			{
-				IPACMERR("unable to allocate memory \n");
-				goto IGNORE;
-			}
+	size_t pending;
+	uint64_t start_us, elapsed_us;
 
-			ct_data->ct = ct_entries[index].ct;
-			ct_data->type = ct_entries[index].type;
-
-#ifdef CT_OPT
-			if(AF_INET6 == ip_type)
-			{
-				ProcessCTV6Message(ct_data);
-			}
-#else
-				ProcessCTMessage(ct_data);
-#endif
-		index++;
-		free(ct_data);
-		continue;
-IGNORE:
-		nfct_destroy(ct_entries[index].ct);
-		index++;
-		}
-	}
-	else
+	IPACMDBG_H("process conntrack started \n");
+	pthread_mutex_lock(&ct_dump_lock);
+	start_us = now_us();
+	pending = ct_pending.size();
+	ProcessPendingConntrack();
+	isProcessCTDone = true;
+	IPACMDBG_H("process conntrack ended. Number of entries:%zu in %lluus\n", pending,
+		(unsigned long long)(now_us() - start_us));
+	/* time to offload: from the start of the dump to the last entry offloaded */
+	elapsed_us = now_us() - ct_sync_start_us;
+	IPACMDBG_H("conntrack dump: received %d processed %d, %lluus since dump start, %llu entries/s\n",
+		ct_sync_received, ct_sync_processed, (unsigned long long)elapsed_us,
+		(unsigned long long)(elapsed_us ? (uint64_t)ct_sync_received * 1000000ULL / elapsed_us : 0));
+	if(isReadCTDone)
 	{
-		IPACMDBG_H("ct entry is null\n");
-		return ;
+		ReleaseCtPool();
 	}
-	isProcessCTDone = true;
-	free(ct_entries);
-	ct_entries = NULL;
-	IPACMDBG_H("process conntrack ended. Number of entries:%d \n", index);
+	pthread_mutex_unlock(&ct_dump_lock);
 	return;
 }
 
@@ -1450,6 +1672,18 @@ void IPACM_ConntrackListener::CacheORDeleteConntrack
 	enum nf_conntrack_msg_type type,
 	u_int8_t protocol
 )
+{
+	pthread_mutex_lock(&ct_cache_lock);
+	CacheORDeleteConntrackLocked(ct, type, protocol);
+	pthread_mutex_unlock(&ct_cache_lock);
+}
+
+void IPACM_ConntrackListener::CacheORDeleteConntrackLocked
+(
+	struct nf_conntrack *ct,
+	enum nf_conntrack_msg_type type,
+	u_int8_t protocol
+)
 {
 	u_int8_t tcp_state;
 	int i = 0, free_idx = -1;
@@ -1540,6 +1774,7 @@ void IPACM_ConntrackListener::processCacheConntrack(void)
 	int i = 0;
 
 	IPACMDBG("Entry:\n");
+	pthread_mutex_lock(&ct_cache_lock);
 	for(; i < MAX_CONNTRACK_ENTRIES; i++)
 	{
 		if (ct_cache[i].ct != NULL)
@@ -1549,6 +1784,7 @@ void IPACM_ConntrackListener::processCacheConntrack(void)
 			memset(&ct_cache[i], 0, sizeof(ct_cache[i]));
 		}
 	}
+	pthread_mutex_unlock(&ct_cache_lock);
 	IPACMDBG("Exit:\n");
 }
 
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*!
+	@file
+	IPACM_ConntrackWorkers.cpp
+
+	@brief
+	Worker pool processing IPv4 conntrack events, sharded by flow
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include "IPACM_ConntrackWorkers.h"
+#include "IPACM_ConntrackListener.h"
+#include "IPACM_Log.h"
+
+IPACM_ConntrackWorkers::shard *IPACM_ConntrackWorkers::shards = NULL;
+int IPACM_ConntrackWorkers::num_shards = 0;
+uint64_t IPACM_ConntrackWorkers::start_us = 0;
+uint64_t IPACM_ConntrackWorkers::last_dump_us = 0;
+uint64_t IPACM_ConntrackWorkers::last_dump_processed = 0;
+std::atomic<uint64_t> IPACM_ConntrackWorkers::kernel_drops(0);
+
+static uint64_t now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static uint32_t mix32(uint32_t val)
+{
+	/* murmur3 finalizer */
+	val ^= val >> 16;
+	val *= 0x85ebca6b;
+	val ^= val >> 13;
+	val *= 0xc2b2ae35;
+	val ^= val >> 16;
+	return val;
+}
+
+int IPACM_ConntrackWorkers::Start(void)
+{
+	long cpus;
+	int cnt, count;
+	char name[16];
+
+	if(IsStarted())
+	{
+		return 0;
+	}
+
+	cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	count = (cpus < 1) ? 1 : (cpus > CT_MAX_WORKERS ? CT_MAX_WORKERS : (int)cpus);
+
+	shards = (shard *)calloc(count, sizeof(shard));
+	if(shards == NULL)
+	{
+		IPACMERR("unable to allocate %d conntrack worker shards\n", count);
+		return -1;
+	}
+
+	for(cnt = 0; cnt < count; cnt++)
+	{
+		pthread_mutex_init(&shards[cnt].lock, NULL);
+		pthread_cond_init(&shards[cnt].not_empty, NULL);
+		pthread_cond_init(&shards[cnt].not_full, NULL);
+		if(pthread_create(&shards[cnt].thread, NULL, WorkerLoop, &shards[cnt]) != 0)
+		{
+			IPACMERR("unable to create conntrack worker %d\n", cnt);
+			break;
+		}
+		snprintf(name, sizeof(name), "ct worker %d", cnt);
+		if(pthread_setname_np(shards[cnt].thread, name) != 0)
+		{
+			IPACMERR("unable to set thread name\n");
+		}
+	}
+
+	if(cnt == 0)
+	{
+		free(shards);
+		shards = NULL;
+		return -1;
+	}
+
+	start_us = now_us();
+	last_dump_us = start_us;
+	num_shards = cnt;
+	IPACMDBG_H("started %d conntrack workers\n", num_shards);
+	return 0;
+}
+
+/* hash of the original direction tuple, the same for every event of a flow */
+uint32_t IPACM_ConntrackWorkers::FlowHash(struct nf_conntrack *ct)
+{
+	uint32_t hash;
+
+	hash = mix32(nfct_get_attr_u32(ct, ATTR_ORIG_IPV4_SRC));
+	hash = mix32(hash ^ nfct_get_attr_u32(ct, ATTR_ORIG_IPV4_DST));
+	hash = mix32(hash ^ (((uint32_t)nfct_get_attr_u16(ct, ATTR_ORIG_PORT_SRC) << 16) |
+		nfct_get_attr_u16(ct, ATTR_ORIG_PORT_DST)));
+	return mix32(hash ^ nfct_get_attr_u8(ct, ATTR_ORIG_L4PROTO));
+}
+
+void IPACM_ConntrackWorkers::Dispatch(struct nf_conntrack *ct, enum nf_conntrack_msg_type type)
+{
+	shard *sh = &shards[FlowHash(ct) % num_shards];
+	uint32_t depth;
+
+	pthread_mutex_lock(&sh->lock);
+	if(sh->tail - sh->head == CT_WORKER_QUEUE_LEN)
+	{
+		/* back pressure, the kernel keeps the events until the worker catches up */
+		sh->full_waits++;
+		while(sh->tail - sh->head == CT_WORKER_QUEUE_LEN)
+		{
+			pthread_cond_wait(&sh->not_full, &sh->lock);
+		}
+	}
+	sh->ring[sh->tail % CT_WORKER_QUEUE_LEN].ct = ct;
+	sh->ring[sh->tail % CT_WORKER_QUEUE_LEN].type = type;
+	sh->tail++;
+	sh->enqueued++;
+	depth = sh->tail - sh->head;
+	if(depth > sh->depth_max)
+	{
+		sh->depth_max = depth;
+	}
+	if(depth == 1)
+	{
+		pthread_cond_signal(&sh->not_empty);
+	}
+	pthread_mutex_unlock(&sh->lock);
+}
+
+void *IPACM_ConntrackWorkers::WorkerLoop(void *param)
+{
+	shard *sh = (shard *)param;
+	ct_work_item batch[CT_WORKER_BATCH];
+	int num;
+
+	while(1)
+	{
+		pthread_mutex_lock(&sh->lock);
+		while(sh->head == sh->tail)
+		{
+			pthread_cond_wait(&sh->not_empty, &sh->lock);
+		}
+		for(num = 0; num < CT_WORKER_BATCH && sh->head != sh->tail; num++)
+		{
+			batch[num] = sh->ring[sh->head % CT_WORKER_QUEUE_LEN];
+			sh->head++;
+		}
+		pthread_cond_signal(&sh->not_full);
+		pthread_mutex_unlock(&sh->lock);
+
+		CtList->ProcessCTBatch(batch, num);
+
+		pthread_mutex_lock(&sh->lock);
+		sh->processed += num;
+		sh->batches++;
+		pthread_mutex_unlock(&sh->lock);
+	}
+
+	return NULL;
+}
+
+void IPACM_ConntrackWorkers::DumpStats(void)
+{
+	uint64_t now, processed = 0, enqueued = 0;
+	int cnt;
+
+	if(!IsStarted())
+	{
+		return;
+	}
+
+	for(cnt = 0; cnt < num_shards; cnt++)
+	{
+		IPACMDBG_H("ct worker %d: enqueued %llu processed %llu batches %llu depth %u max depth %u full waits %llu\n",
+			cnt, (unsigned long long)shards[cnt].enqueued.load(),
+			(unsigned long long)shards[cnt].processed.load(),
+			(unsigned long long)shards[cnt].batches.load(),
+			shards[cnt].tail.load() - shards[cnt].head.load(), shards[cnt].depth_max.load(),
+			(unsigned long long)shards[cnt].full_waits.load());
+		enqueued += shards[cnt].enqueued.load();
+		processed += shards[cnt].processed.load();
+	}
+
+	now = now_us();
+	IPACMDBG_H("ct workers: %llu events queued, %llu processed, %llu/s overall, %llu/s since last dump, kernel drops %llu\n",
+		(unsigned long long)enqueued, (unsigned long long)processed,
+		(unsigned long long)(now > start_us ? processed * 1000000ULL / (now - start_us) : 0),
+		(unsigned long long)(now > last_dump_us ?
+			(processed - last_dump_processed) * 1000000ULL / (now - last_dump_us) : 0),
+		(unsigned long long)kernel_drops.load());
+	last_dump_us = now;
+	last_dump_processed = processed;
+}
@@ -33,6 +33,10 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "IPACM_OffloadManager.h"
 #endif
 #include "IPACM_Iface.h"
+#include <errno.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
 
 #define INVALID_IP_ADDR 0x0
 
@@ -51,6 +55,13 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 NatApp *NatApp::pInstance = NULL;
 NatApp::NatApp()
 {
+	pthread_mutexattr_t attr;
+
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&lock, &attr);
+	pthread_mutexattr_destroy(&attr);
+
 	max_entries = 0;
 	mem_type = NULL;
 
@@ -68,6 +79,10 @@ NatApp::NatApp()
 	ct = NULL;
 	ct_hdl = NULL;
 
+	ts_snapshot = NULL;
+	ts_changed = NULL;
+	memset(&ts_stats, 0, sizeof(ts_stats));
+
 	memset(temp, 0, sizeof(temp));
 	m_fd_ipa = open(IPA_DEVICE_NAME, O_RDWR);
 	if(m_fd_ipa < 0)
@@ -109,6 +124,20 @@ int NatApp::Init(void)
 	IPACMDBG("Allocated %d bytes for config manager nat cache\n", size);
 	memset(cache, 0, size);
 
+	if(cache_index.Init(cache, max_entries))
+	{
+		IPACMERR("Unable to allocate memory for cache index\n");
+		goto fail;
+	}
+
+	ts_snapshot = (uint32_t *)malloc(sizeof(uint32_t) * (max_entries ? max_entries : 1));
+	ts_changed = (int *)malloc(sizeof(int) * (max_entries ? max_entries : 1));
+	if(ts_snapshot == NULL || ts_changed == NULL)
+	{
+		IPACMERR("Unable to allocate memory for timestamp snapshot\n");
+		goto fail;
+	}
+
 	nALGPort = pConfig->GetAlgPortCnt();
 	if(nALGPort > 0)
 	{
@@ -141,6 +170,8 @@ fail:
 	{
 		free(cache);
 	}
+	free(ts_snapshot);
+	free(ts_changed);
 	if(pALGPorts != NULL)
 	{
 		free(pALGPorts);
@@ -172,6 +203,7 @@ uint32_t NatApp::GenerateMetdata(uint8_t mux_id)
 /* NAT APP related object function definitions */
 int NatApp::AddTable(uint32_t pub_ip, uint8_t mux_id)
 {
+	NAT_APP_LOCK();
 	int ret;
 	int cnt = 0;
 	ipa_nat_ipv4_rule nat_rule;
@@ -183,6 +215,7 @@ int NatApp::AddTable(uint32_t pub_ip, uint8_t mux_id)
 	{
 		IPACMDBG("Reset the cache because NAT-ipv4 different\n");
 		memset(cache, 0, sizeof(nat_table_entry) * max_entries);
+		cache_index.Init(cache, max_entries);
 		curCnt = 0;
 	}
 #endif
@@ -225,6 +258,7 @@ int NatApp::AddTable(uint32_t pub_ip, uint8_t mux_id)
 				if(ipa_nat_add_ipv4_rule(nat_table_hdl, &nat_rule, &cache[cnt].rule_hdl) < 0)
 				{
 					IPACMERR("unable to add the rule delete from cache\n");
+					cache_index.Remove(cnt);
 					memset(&cache[cnt], 0, sizeof(cache[cnt]));
 					curCnt--;
 					continue;
@@ -272,6 +306,7 @@ void NatApp::Reset()
 
 int NatApp::DeleteTable(uint32_t pub_ip)
 {
+	NAT_APP_LOCK();
 	int cnt = 0;
 	int ret;
 	IPACMDBG_H("%s() %d\n", __FUNCTION__, __LINE__);
@@ -320,6 +355,7 @@ int NatApp::DeleteTable(uint32_t pub_ip)
 
 int NatApp::MoveTable(bool to_ddr)
 {
+	NAT_APP_LOCK();
 	int ret;
 
 	if (to_ddr) {
@@ -336,21 +372,13 @@ int NatApp::MoveTable(bool to_ddr)
 /* Check for duplicate entries */
 bool NatApp::ChkForDup(const nat_table_entry *rule)
 {
-	int cnt = 0;
 	IPACMDBG("%s() %d\n", __FUNCTION__, __LINE__);
 
-	for(; cnt < max_entries; cnt++)
+	if(cache_index.Find(rule) >= 0)
 	{
-		if(cache[cnt].private_ip == rule->private_ip &&
-			 cache[cnt].target_ip == rule->target_ip &&
-			 cache[cnt].private_port ==  rule->private_port  &&
-			 cache[cnt].target_port == rule->target_port &&
-			 cache[cnt].protocol == rule->protocol)
-		{
-			log_nat(rule->protocol,rule->private_ip,rule->target_ip,rule->private_port,\
-			rule->target_port,"Duplicate Rule\n");
-			return true;
-		}
+		log_nat(rule->protocol,rule->private_ip,rule->target_ip,rule->private_port,\
+		rule->target_port,"Duplicate Rule\n");
+		return true;
 	}
 
 	return false;
@@ -359,6 +387,7 @@ bool NatApp::ChkForDup(const nat_table_entry *rule)
 /* Delete the entry from Nat table on connection close */
 int NatApp::DeleteEntry(const nat_table_entry *rule)
 {
+	NAT_APP_LOCK();
 	int cnt = 0;
 	int ret = 0;
 	IPACMDBG("%s() %d\n", __FUNCTION__, __LINE__);
@@ -367,48 +396,41 @@ int NatApp::DeleteEntry(const nat_table_entry *rule)
 	rule->target_port,"for deletion\n");
 
 
-	for(; cnt < max_entries; cnt++)
+	cnt = cache_index.Find(rule);
+	if(cnt >= 0)
 	{
-		if(cache[cnt].private_ip == rule->private_ip &&
-			 cache[cnt].target_ip == rule->target_ip &&
-			 cache[cnt].private_port ==  rule->private_port  &&
-			 cache[cnt].target_port == rule->target_port &&
-			 cache[cnt].protocol == rule->protocol)
+		if(cache[cnt].enabled == true)
 		{
-
-			if(cache[cnt].enabled == true)
+			/* send connections del info to pcie modem first */
+			if ((CtList->backhaul_mode == Q6_MHI_WAN) && (cache[cnt].dst_nat == true || cache[cnt].protocol == IPPROTO_TCP) && (cache[cnt].rule_id > 0))
 			{
-				/* send connections del info to pcie modem first */
-				if ((CtList->backhaul_mode == Q6_MHI_WAN) && (cache[cnt].dst_nat == true || cache[cnt].protocol == IPPROTO_TCP) && (cache[cnt].rule_id > 0))
+				ret = DelConnection(cache[cnt].rule_id);
+				if(ret)
 				{
-					ret = DelConnection(cache[cnt].rule_id);
-					if(ret)
-					{
-						IPACMERR("unable to del Connection to pcie modem: %d\n", ret);
-					}
-					else
-					{
-						/* save the rule id for deletion */
-						cache[cnt].rule_id = 0;
-					}
+					IPACMERR("unable to del Connection to pcie modem: %d\n", ret);
 				}
-
-				if(ipa_nat_del_ipv4_rule(nat_table_hdl, cache[cnt].rule_hdl) < 0)
+				else
 				{
-					IPACMERR("%s() %d deletion failed\n", __FUNCTION__, __LINE__);
+					/* save the rule id for deletion */
+					cache[cnt].rule_id = 0;
 				}
-
-				IPACMDBG_H("Deleted Nat entry(%d) Successfully\n", cnt);
 			}
-			else
+
+			if(ipa_nat_del_ipv4_rule(nat_table_hdl, cache[cnt].rule_hdl) < 0)
 			{
-				IPACMDBG_H("Deleted Nat entry(%d) only from cache\n", cnt);
+				IPACMERR("%s() %d deletion failed\n", __FUNCTION__, __LINE__);
 			}
 
-			memset(&cache[cnt], 0, sizeof(cache[cnt]));
-			curCnt--;
-			break;
+			IPACMDBG_H("Deleted Nat entry(%d) Successfully\n", cnt);
+		}
+		else
+		{
+			IPACMDBG_H("Deleted Nat entry(%d) only from cache\n", cnt);
 		}
+
+		cache_index.Remove(cnt);
+		memset(&cache[cnt], 0, sizeof(cache[cnt]));
+		curCnt--;
 	}
 
 	return 0;
@@ -417,6 +439,7 @@ int NatApp::DeleteEntry(const nat_table_entry *rule)
 /* Add new entry to the nat table on new connection */
 int NatApp::AddEntry(const nat_table_entry *rule)
 {
+	NAT_APP_LOCK();
 	int cnt = 0;
 	ipa_nat_ipv4_rule nat_rule;
 	int ret = 0;
@@ -445,19 +468,8 @@ int NatApp::AddEntry(const nat_table_entry *rule)
 
 	if(!ChkForDup(rule))
 	{
-		for(; cnt < max_entries; cnt++)
-		{
-			if(cache[cnt].private_ip == 0 &&
-				 cache[cnt].target_ip == 0 &&
-				 cache[cnt].private_port == 0  &&
-				 cache[cnt].target_port == 0 &&
-				 cache[cnt].protocol == 0)
-			{
-				break;
-			}
-		}
-
-		if(max_entries == cnt)
+		cnt = cache_index.GetFreeSlot();
+		if(cnt < 0)
 		{
 			IPACMERR("Error: Unable to add, reached maximum rules\n");
 			return -1;
@@ -514,6 +526,7 @@ int NatApp::AddEntry(const nat_table_entry *rule)
 			cache[cnt].timestamp = 0;
 			cache[cnt].public_port = rule->public_port;
 			cache[cnt].dst_nat = rule->dst_nat;
+			cache_index.Insert(cnt);
 			curCnt++;
 		}
 
@@ -539,6 +552,7 @@ int NatApp::AddEntry(const nat_table_entry *rule)
 /* Add new entry to the nat table on new connection, return rule-id */
 int NatApp::AddConnection(const nat_table_entry *rule)
 {
+	NAT_APP_LOCK();
 	int len, res = IPACM_SUCCESS;
 	ipa_ioc_add_flt_rule *pFilteringTable = NULL;
 
@@ -624,6 +638,7 @@ fail:
 
 int NatApp::DelConnection(const uint32_t rule_id)
 {
+	NAT_APP_LOCK();
 	int len, res = IPACM_SUCCESS;
 	ipa_ioc_del_flt_rule *pFilteringTable = NULL;
 
@@ -666,25 +681,24 @@ fail:
 	return res;
 }
 
-void NatApp::UpdateCTUdpTs(nat_table_entry *rule, uint32_t new_ts)
+static uint64_t now_us(void)
 {
-#ifdef FEATURE_IPACM_HAL
-	IOffloadManager::ConntrackTimeoutUpdater::natTimeoutUpdate_t entry;
-	IPACM_OffloadManager* OffloadMng;
-#endif
-	iptodot("Private IP:", rule->private_ip);
-	iptodot("Target IP:",  rule->target_ip);
-	IPACMDBG("Private Port: %d, Target Port: %d\n", rule->private_port, rule->target_port);
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+}
 
 #ifndef FEATURE_IPACM_HAL
-	int ret;
+int NatApp::OpenCTHandle(void)
+{
 	if(!ct_hdl)
 	{
 		ct_hdl = nfct_open(CONNTRACK, 0);
 		if(!ct_hdl)
 		{
 			PERROR("nfct_open");
-			return;
+			return -1;
 		}
 	}
 
@@ -694,10 +708,14 @@ void NatApp::UpdateCTUdpTs(nat_table_entry *rule, uint32_t new_ts)
 		if(!ct)
 		{
 			PERROR("nfct_new");
-			return;
+			return -1;
 		}
 	}
+	return 0;
+}
 
+void NatApp::SetCTAttrs(const nat_table_entry *rule)
+{
 	nfct_set_attr_u8(ct, ATTR_L3PROTO, AF_INET);
 	if(rule->protocol == IPPROTO_UDP)
 	{
@@ -738,6 +756,132 @@ void NatApp::UpdateCTUdpTs(nat_table_entry *rule, uint32_t new_ts)
 
 	IPACMDBG("updating %d connection with time: %d\n",
 					 rule->protocol, nfct_get_attr_u32(ct, ATTR_TIMEOUT));
+}
+
+/*
+ * Refreshes the conntrack entries of the given cache slots to the timestamps in ts_snapshot.
+ * Up to NAT_TS_BATCH_SIZE update requests go to the kernel in one datagram; nfnetlink handles
+ * them in order within the sendto() and queues one ack per request, which are then matched
+ * back to their slot by sequence number.
+ */
+void NatApp::UpdateCTUdpTsBatch(const int *slots, int num_slots, int *updated, int *failed)
+{
+	char req[NAT_TS_BATCH_SIZE * NAT_TS_BATCH_MSG_LEN];
+	char ack[8192];
+	int batch_slot[NAT_TS_BATCH_SIZE];
+	uint32_t batch_seq[NAT_TS_BATCH_SIZE];
+	int batch_err[NAT_TS_BATCH_SIZE];
+	struct sockaddr_nl kernel;
+	struct nlmsghdr *nlh;
+	struct nlmsgerr *nl_err;
+	int next, num, cnt, len, off, fd;
+
+	if(OpenCTHandle())
+	{
+		*failed += num_slots;
+		return;
+	}
+	fd = nfct_fd(ct_hdl);
+
+	memset(&kernel, 0, sizeof(kernel));
+	kernel.nl_family = AF_NETLINK;
+
+	for(next = 0; next < num_slots;)
+	{
+		num = 0;
+		off = 0;
+		for(; next < num_slots && num < NAT_TS_BATCH_SIZE; next++)
+		{
+			SetCTAttrs(&cache[slots[next]]);
+			if(nfct_build_query(nfct_subsys_ct(ct_hdl), NFCT_Q_UPDATE, ct,
+				req + off, NAT_TS_BATCH_MSG_LEN) < 0)
+			{
+				IPACMERR("unable to build update for rule handle: %d\n", cache[slots[next]].rule_hdl);
+				(*failed)++;
+				continue;
+			}
+			nlh = (struct nlmsghdr *)(req + off);
+			batch_slot[num] = slots[next];
+			batch_seq[num] = nlh->nlmsg_seq;
+			/* no ack means no answer, the flow is retried on the next cycle */
+			batch_err[num] = 1;
+			off += NLMSG_ALIGN(nlh->nlmsg_len);
+			num++;
+		}
+		if(num == 0)
+		{
+			continue;
+		}
+
+		if(sendto(fd, req, off, 0, (struct sockaddr *)&kernel, sizeof(kernel)) < 0)
+		{
+			IPACMERR("unable to send %d time stamp updates: %s\n", num, strerror(errno));
+			*failed += num;
+			continue;
+		}
+
+		while((len = recv(fd, ack, sizeof(ack), MSG_DONTWAIT)) > 0)
+		{
+			for(nlh = (struct nlmsghdr *)ack; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len))
+			{
+				if(nlh->nlmsg_type != NLMSG_ERROR)
+				{
+					continue;
+				}
+				nl_err = (struct nlmsgerr *)NLMSG_DATA(nlh);
+				for(cnt = 0; cnt < num; cnt++)
+				{
+					if(batch_seq[cnt] == nlh->nlmsg_seq)
+					{
+						batch_err[cnt] = nl_err->error;
+						break;
+					}
+				}
+			}
+		}
+
+		for(cnt = 0; cnt < num; cnt++)
+		{
+			if(batch_err[cnt] == 0)
+			{
+				cache[batch_slot[cnt]].timestamp = ts_snapshot[batch_slot[cnt]];
+				(*updated)++;
+			}
+			else if(batch_err[cnt] < 0)
+			{
+				IPACMERR("unable to update time stamp for rule handle: %d, error: %d\n",
+					cache[batch_slot[cnt]].rule_hdl, batch_err[cnt]);
+				DeleteEntry(&cache[batch_slot[cnt]]);
+				(*failed)++;
+			}
+			else
+			{
+				IPACMERR("no ack for rule handle: %d\n", cache[batch_slot[cnt]].rule_hdl);
+				(*failed)++;
+			}
+		}
+	}
+}
+#endif
+
+void NatApp::UpdateCTUdpTs(nat_table_entry *rule, uint32_t new_ts)
+{
+#ifdef FEATURE_IPACM_HAL
+	IOffloadManager::ConntrackTimeoutUpdater::natTimeoutUpdate_t entry;
+	IPACM_OffloadManager* OffloadMng;
+#endif
+	iptodot("Private IP:", rule->private_ip);
+	iptodot("Target IP:",  rule->target_ip);
+	IPACMDBG("Private Port: %d, Target Port: %d\n", rule->private_port, rule->target_port);
+
+#ifndef FEATURE_IPACM_HAL
+	int ret;
+	if(OpenCTHandle())
+	{
+		return;
+	}
+
+	SetCTAttrs(rule);
 
 	ret = nfct_query(ct_hdl, NFCT_Q_UPDATE, ct);
 	if(ret == -1)
@@ -794,14 +938,52 @@ void NatApp::UpdateCTUdpTs(nat_table_entry *rule, uint32_t new_ts)
 	return;
 }
 
+/* queries the hardware timestamp of every offloaded flow, returns the number of changed slots */
+int NatApp::SnapshotTimestamps(int *queried)
+{
+	int cnt, num_changed = 0;
+
+	for(cnt = 0; cnt < max_entries; cnt++)
+	{
+		ts_snapshot[cnt] = cache[cnt].timestamp;
+		if(cache[cnt].enabled == true &&
+		   (cache[cnt].private_ip != cache[cnt].public_ip))
+		{
+			(*queried)++;
+			if(ipa_nat_query_timestamp(nat_table_hdl, cache[cnt].rule_hdl, &ts_snapshot[cnt]) < 0)
+			{
+				IPACMERR("unable to retrieve timeout for rule hanle: %d\n", cache[cnt].rule_hdl);
+				ts_snapshot[cnt] = cache[cnt].timestamp;
+			}
+		}
+	}
+
+	/* diff against the cache only once the table has been read */
+	for(cnt = 0; cnt < max_entries; cnt++)
+	{
+		if(ts_snapshot[cnt] != cache[cnt].timestamp)
+		{
+			ts_changed[num_changed++] = cnt;
+		}
+	}
+	return num_changed;
+}
+
 void NatApp::UpdateUDPTimeStamp()
 {
-	int cnt;
-	uint32_t ts;
-	bool read_to = false;
+	NAT_APP_LOCK();
+	int num_changed, queried = 0, updated = 0, failed = 0;
+	uint64_t start_us;
+	uint32_t duration_us;
 	bool keep_awake;
 
-	keep_awake = ( max_entries && SRAM_IN_USE() && ipa_nat_is_sram_supported() );
+	if(max_entries == 0)
+	{
+		return;
+	}
+	start_us = now_us();
+
+	keep_awake = ( SRAM_IN_USE() && ipa_nat_is_sram_supported() );
 
 	if ( keep_awake )
 	{
@@ -814,35 +996,30 @@ void NatApp::UpdateUDPTimeStamp()
 		}
 	}
 
-	for(cnt = 0; cnt < max_entries; cnt++)
+	num_changed = SnapshotTimestamps(&queried);
+	if(num_changed > 0)
 	{
-		ts = 0;
-		if(cache[cnt].enabled == true &&
-		   (cache[cnt].private_ip != cache[cnt].public_ip))
+		Read_TcpUdp_Timeout();
+#ifndef FEATURE_IPACM_HAL
+		UpdateCTUdpTsBatch(ts_changed, num_changed, &updated, &failed);
+#else
+		int cnt;
+
+		/* the framework takes one flow per updateTimeout() callback */
+		for(cnt = 0; cnt < num_changed; cnt++)
 		{
-			IPACMDBG("\n");
-			if(ipa_nat_query_timestamp(nat_table_hdl, cache[cnt].rule_hdl, &ts) < 0)
+			UpdateCTUdpTs(&cache[ts_changed[cnt]], ts_snapshot[ts_changed[cnt]]);
+			if(cache[ts_changed[cnt]].timestamp == ts_snapshot[ts_changed[cnt]])
 			{
-				IPACMERR("unable to retrieve timeout for rule hanle: %d\n", cache[cnt].rule_hdl);
-				continue;
+				updated++;
 			}
-
-			if(cache[cnt].timestamp == ts)
+			else
 			{
-				IPACMDBG("No Change in Time Stamp: cahce:%d, ipahw:%d\n",
-								                  cache[cnt].timestamp, ts);
-				continue;
-			}
-
-			if (read_to == false) {
-				read_to = true;
-				Read_TcpUdp_Timeout();
+				failed++;
 			}
-
-			UpdateCTUdpTs(&cache[cnt], ts);
-		} /* end of outer if */
-
-	} /* end of for loop */
+		}
+#endif
+	}
 
 	if ( keep_awake )
 	{
@@ -853,6 +1030,44 @@ void NatApp::UpdateUDPTimeStamp()
 			IPACMERR("Voting clock off failed\n");
 		}
 	}
+
+	duration_us = (uint32_t)(now_us() - start_us);
+	ts_stats.cycles++;
+	ts_stats.queried += queried;
+	ts_stats.changed += num_changed;
+	ts_stats.updated += updated;
+	ts_stats.failed += failed;
+	ts_stats.last_duration_us = duration_us;
+	if(duration_us > ts_stats.max_duration_us)
+	{
+		ts_stats.max_duration_us = duration_us;
+	}
+
+	if(num_changed > 0)
+	{
+		IPACMDBG_H("UDP time stamp cycle: %uus, flows queried %d changed %d updated %d failed %d\n",
+			duration_us, queried, num_changed, updated, failed);
+	}
+	else
+	{
+		IPACMDBG("UDP time stamp cycle: %uus, flows queried %d, no change\n", duration_us, queried);
+	}
+}
+
+/* no instance is created here, this runs from the SIGHUP handler */
+void NatApp::DumpStats(void)
+{
+	nat_ts_harvest_stat *stats;
+
+	if(pInstance == NULL)
+	{
+		return;
+	}
+	stats = &pInstance->ts_stats;
+	IPACMDBG_H("UDP time stamp harvest: cycles %llu queried %llu changed %llu updated %llu failed %llu last %uus max %uus\n",
+		(unsigned long long)stats->cycles, (unsigned long long)stats->queried,
+		(unsigned long long)stats->changed, (unsigned long long)stats->updated,
+		(unsigned long long)stats->failed, stats->last_duration_us, stats->max_duration_us);
 }
 
 bool NatApp::isAlgPort(uint8_t proto, uint16_t port)
@@ -888,7 +1103,8 @@ bool NatApp::isPwrSaveIf(uint32_t ip_addr)
 
 int NatApp::UpdatePwrSaveIf(uint32_t client_lan_ip)
 {
-	int cnt, ret;
+	NAT_APP_LOCK();
+	int cnt, next, ret;
 	IPACMDBG_H("Received IP address: 0x%x\n", client_lan_ip);
 
 	if(client_lan_ip == INVALID_IP_ADDR)
@@ -916,10 +1132,10 @@ int NatApp::UpdatePwrSaveIf(uint32_t client_lan_ip)
 		}
 	}
 
-	for(cnt = 0; cnt < max_entries; cnt++)
+	for(cnt = cache_index.FirstByPrivateIp(client_lan_ip); cnt >= 0; cnt = next)
 	{
-		if(cache[cnt].private_ip == client_lan_ip &&
-			 cache[cnt].enabled == true)
+		next = cache_index.NextByPrivateIp(cnt);
+		if(cache[cnt].enabled == true)
 		{
 			/* send connections del info to pcie modem first */
 			if ((CtList->backhaul_mode == Q6_MHI_WAN) && (cache[cnt].dst_nat == true || cache[cnt].protocol == IPPROTO_TCP) && (cache[cnt].rule_id > 0))
@@ -952,7 +1168,8 @@ int NatApp::UpdatePwrSaveIf(uint32_t client_lan_ip)
 
 int NatApp::ResetPwrSaveIf(uint32_t client_lan_ip)
 {
-	int cnt, ret;
+	NAT_APP_LOCK();
+	int cnt, next, ret;
 	ipa_nat_ipv4_rule nat_rule;
 
 	IPACMDBG_H("Received ip address: 0x%x\n", client_lan_ip);
@@ -972,12 +1189,12 @@ int NatApp::ResetPwrSaveIf(uint32_t client_lan_ip)
 		}
 	}
 
-	for(cnt = 0; cnt < max_entries; cnt++)
+	for(cnt = cache_index.FirstByPrivateIp(client_lan_ip); cnt >= 0; cnt = next)
 	{
+		next = cache_index.NextByPrivateIp(cnt);
 		IPACMDBG("cache (%d): enable %d, ip 0x%x\n", cnt, cache[cnt].enabled, cache[cnt].private_ip);
 
-		if(cache[cnt].private_ip == client_lan_ip &&
-			 cache[cnt].enabled == false)
+		if(cache[cnt].enabled == false)
 		{
 			memset(&nat_rule, 0 , sizeof(nat_rule));
 			nat_rule.private_ip = cache[cnt].private_ip;
@@ -990,6 +1207,7 @@ int NatApp::ResetPwrSaveIf(uint32_t client_lan_ip)
 			if(ipa_nat_add_ipv4_rule(nat_table_hdl, &nat_rule, &cache[cnt].rule_hdl) < 0)
 			{
 				IPACMERR("unable to add the rule delete from cache\n");
+				cache_index.Remove(cnt);
 				memset(&cache[cnt], 0, sizeof(cache[cnt]));
 				curCnt--;
 				continue;
@@ -1027,6 +1245,7 @@ int NatApp::ResetPwrSaveIf(uint32_t client_lan_ip)
 
 uint32_t NatApp::GetTableHdl(uint32_t in_ip_addr)
 {
+	NAT_APP_LOCK();
 	if(in_ip_addr == pub_ip_addr)
 	{
 		return nat_table_hdl;
@@ -1037,6 +1256,7 @@ uint32_t NatApp::GetTableHdl(uint32_t in_ip_addr)
 
 void NatApp::AddTempEntry(const nat_table_entry *new_entry)
 {
+	NAT_APP_LOCK();
 	int cnt;
 
 	IPACMDBG("Received below Temp Nat entry\n");
@@ -1087,6 +1307,7 @@ void NatApp::AddTempEntry(const nat_table_entry *new_entry)
 
 void NatApp::DeleteTempEntry(const nat_table_entry *entry)
 {
+	NAT_APP_LOCK();
 	int cnt;
 
 	IPACMDBG("Received below nat entry\n");
@@ -1116,6 +1337,7 @@ void NatApp::DeleteTempEntry(const nat_table_entry *entry)
 void NatApp::FlushTempEntries(uint32_t ip_addr, bool isAdd,
 		bool isDummy)
 {
+	NAT_APP_LOCK();
 	int cnt;
 	int ret;
 
@@ -1156,7 +1378,8 @@ void NatApp::FlushTempEntries(uint32_t ip_addr, bool isAdd,
 
 int NatApp::DelEntriesOnClntDiscon(uint32_t ip_addr)
 {
-	int cnt, tmp = 0, ret;
+	NAT_APP_LOCK();
+	int cnt, next, tmp = 0, ret;
 	IPACMDBG_H("Received IP address: 0x%x\n", ip_addr);
 
 	if(ip_addr == INVALID_IP_ADDR)
@@ -1175,41 +1398,39 @@ int NatApp::DelEntriesOnClntDiscon(uint32_t ip_addr)
 		}
 	}
 
-	for(cnt = 0; cnt < max_entries; cnt++)
+	for(cnt = cache_index.FirstByPrivateIp(ip_addr); cnt >= 0; cnt = next)
 	{
-		if(cache[cnt].private_ip == ip_addr)
+		next = cache_index.NextByPrivateIp(cnt);
+		if(cache[cnt].enabled == true)
 		{
-			if(cache[cnt].enabled == true)
+			/* send connections del info to pcie modem first */
+			if ((CtList->backhaul_mode == Q6_MHI_WAN) && (cache[cnt].dst_nat == true || cache[cnt].protocol == IPPROTO_TCP) && (cache[cnt].rule_id > 0))
 			{
-				/* send connections del info to pcie modem first */
-				if ((CtList->backhaul_mode == Q6_MHI_WAN) && (cache[cnt].dst_nat == true || cache[cnt].protocol == IPPROTO_TCP) && (cache[cnt].rule_id > 0))
-				{
-					ret = DelConnection(cache[cnt].rule_id);
-					if(ret)
-					{
-						IPACMERR("unable to del Connection to pcie modem: %d\n", ret);
-					}
-					else
-					{
-						/* save the rule id for deletion */
-						cache[cnt].rule_id = 0;
-					}
-				}
-
-				if(ipa_nat_del_ipv4_rule(nat_table_hdl, cache[cnt].rule_hdl) < 0)
+				ret = DelConnection(cache[cnt].rule_id);
+				if(ret)
 				{
-					IPACMERR("unable to delete the rule\n");
-					continue;
+					IPACMERR("unable to del Connection to pcie modem: %d\n", ret);
 				}
 				else
 				{
-					IPACMDBG("won't delete the rule\n");
-					cache[cnt].enabled = false;
-					tmp++;
+					/* save the rule id for deletion */
+					cache[cnt].rule_id = 0;
 				}
 			}
-			IPACMDBG("won't delete the rule for entry %d, enabled %d\n",cnt, cache[cnt].enabled);
+
+			if(ipa_nat_del_ipv4_rule(nat_table_hdl, cache[cnt].rule_hdl) < 0)
+			{
+				IPACMERR("unable to delete the rule\n");
+				continue;
+			}
+			else
+			{
+				IPACMDBG("won't delete the rule\n");
+				cache[cnt].enabled = false;
+				tmp++;
+			}
 		}
+		IPACMDBG("won't delete the rule for entry %d, enabled %d\n",cnt, cache[cnt].enabled);
 	}
 
 	IPACMDBG("Deleted (but cached) %d entries\n", tmp);
@@ -1218,7 +1439,8 @@ int NatApp::DelEntriesOnClntDiscon(uint32_t ip_addr)
 
 int NatApp::DelEntriesOnSTAClntDiscon(uint32_t ip_addr)
 {
-	int cnt, tmp = curCnt, ret;
+	NAT_APP_LOCK();
+	int cnt, next, tmp = curCnt, ret;
 	IPACMDBG_H("Received IP address: 0x%x\n", ip_addr);
 
 	if(ip_addr == INVALID_IP_ADDR)
@@ -1228,37 +1450,36 @@ int NatApp::DelEntriesOnSTAClntDiscon(uint32_t ip_addr)
 	}
 
 
-	for(cnt = 0; cnt < max_entries; cnt++)
+	for(cnt = cache_index.FirstByTargetIp(ip_addr); cnt >= 0; cnt = next)
 	{
-		if(cache[cnt].target_ip == ip_addr)
+		next = cache_index.NextByTargetIp(cnt);
+		if(cache[cnt].enabled == true)
 		{
-			if(cache[cnt].enabled == true)
+			/* send connections del info to pcie modem first */
+			if ((CtList->backhaul_mode == Q6_MHI_WAN) && (cache[cnt].dst_nat == true || cache[cnt].protocol == IPPROTO_TCP) && (cache[cnt].rule_id > 0))
 			{
-				/* send connections del info to pcie modem first */
-				if ((CtList->backhaul_mode == Q6_MHI_WAN) && (cache[cnt].dst_nat == true || cache[cnt].protocol == IPPROTO_TCP) && (cache[cnt].rule_id > 0))
+				ret = DelConnection(cache[cnt].rule_id);
+				if(ret)
 				{
-					ret = DelConnection(cache[cnt].rule_id);
-					if(ret)
-					{
-						IPACMERR("unable to del Connection to pcie modem: %d\n", ret);
-					}
-					else
-					{
-						/* save the rule id for deletion */
-						cache[cnt].rule_id = 0;
-					}
+					IPACMERR("unable to del Connection to pcie modem: %d\n", ret);
 				}
-
-				if(ipa_nat_del_ipv4_rule(nat_table_hdl, cache[cnt].rule_hdl) < 0)
+				else
 				{
-					IPACMERR("unable to delete the rule\n");
-					continue;
+					/* save the rule id for deletion */
+					cache[cnt].rule_id = 0;
 				}
 			}
 
-			memset(&cache[cnt], 0, sizeof(cache[cnt]));
-			curCnt--;
+			if(ipa_nat_del_ipv4_rule(nat_table_hdl, cache[cnt].rule_hdl) < 0)
+			{
+				IPACMERR("unable to delete the rule\n");
+				continue;
+			}
 		}
+
+		cache_index.Remove(cnt);
+		memset(&cache[cnt], 0, sizeof(cache[cnt]));
+		curCnt--;
 	}
 
 	IPACMDBG("Deleted %d entries\n", (tmp - curCnt));
@@ -1267,6 +1488,7 @@ int NatApp::DelEntriesOnSTAClntDiscon(uint32_t ip_addr)
 
 void NatApp::CacheEntry(const nat_table_entry *rule)
 {
+	NAT_APP_LOCK();
 	int cnt;
 
 	if(rule->private_ip == 0 ||
@@ -1281,19 +1503,8 @@ void NatApp::CacheEntry(const nat_table_entry *rule)
 
 	if(!ChkForDup(rule))
 	{
-		for(cnt=0; cnt < max_entries; cnt++)
-		{
-			if(cache[cnt].private_ip == 0 &&
-				 cache[cnt].target_ip == 0 &&
-				 cache[cnt].private_port == 0  &&
-				 cache[cnt].target_port == 0 &&
-				 cache[cnt].protocol == 0)
-			{
-				break;
-			}
-		}
-
-		if(max_entries == cnt)
+		cnt = cache_index.GetFreeSlot();
+		if(cnt < 0)
 		{
 			IPACMERR("Error: Unable to add, reached maximum rules\n");
 			return;
@@ -1311,6 +1522,7 @@ void NatApp::CacheEntry(const nat_table_entry *rule)
 			cache[cnt].public_port = rule->public_port;
 			cache[cnt].public_ip = rule->public_ip;
 			cache[cnt].dst_nat = rule->dst_nat;
+			cache_index.Insert(cnt);
 			curCnt++;
 		}
 
@@ -1326,6 +1538,7 @@ void NatApp::CacheEntry(const nat_table_entry *rule)
 }
 
 void NatApp::Read_TcpUdp_Timeout(void) {
+	NAT_APP_LOCK();
 #ifdef FEATURE_IPACM_HAL
 	tcp_timeout = 432000;
 	udp_timeout = 120;
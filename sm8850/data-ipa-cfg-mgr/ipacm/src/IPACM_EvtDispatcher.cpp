@@ -38,17 +38,24 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include <string.h>
 #include <pthread.h>
+#include <time.h>
+#include <algorithm>
 #include <IPACM_EvtDispatcher.h>
 #include <IPACM_Neighbor.h>
 #include "IPACM_CmdQueue.h"
 #include "IPACM_Defs.h"
+#include "IPACM_RuleTxn.h"
 
 
-extern pthread_mutex_t mutex;
-extern pthread_cond_t  cond_var;
-
-cmd_evts *IPACM_EvtDispatcher::head = NULL;
-extern uint32_t ipacm_event_stats[IPACM_EVENT_MAX];
+std::vector<IPACM_Listener *> IPACM_EvtDispatcher::listeners[IPACM_EVENT_MAX];
+int IPACM_EvtDispatcher::dispatch_depth = 0;
+bool IPACM_EvtDispatcher::compact_pending = false;
+ipacm_evt_data_block IPACM_EvtDispatcher::data_pool[IPACM_EVT_DATA_POOL_SIZE];
+ipacm_evt_data_block *IPACM_EvtDispatcher::data_pool_free = NULL;
+pthread_mutex_t IPACM_EvtDispatcher::data_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+uint64_t IPACM_EvtDispatcher::data_pool_exhausted = 0;
+static bool data_pool_initialized = false;
+extern ipacm_event_stat ipacm_event_stats[IPACM_EVENT_MAX];
 
 int IPACM_EvtDispatcher::PostEvt
 (
@@ -74,7 +81,7 @@ int IPACM_EvtDispatcher::PostEvt
 		return IPACM_FAILURE;
 	}
 
-	item = new Message();
+	item = MessageQueue::allocMessage();
 	if(item == NULL)
 	{
 		IPACMERR("unable to create new message item\n");
@@ -82,133 +89,183 @@ int IPACM_EvtDispatcher::PostEvt
 	}
 
 	item->evt.callback_ptr = IPACM_EvtDispatcher::ProcessEvt;
-	memcpy(&item->evt.data, data, sizeof(ipacm_cmd_q_data));
-
-	if(pthread_mutex_lock(&mutex) != 0)
-	{
-		IPACMERR("unable to lock the mutex\n");
-		return IPACM_FAILURE;
-	}
+	item->evt.data = *data;
 
 	IPACMDBG("Enqueing item\n");
 	MsgQueue->enqueue(item);
 	IPACMDBG("Enqueued item %pK\n", item);
 
-	if(pthread_cond_signal(&cond_var) != 0)
-	{
-		IPACMDBG("unable to lock the mutex\n");
-		/* Release the mutex before you return failure */
-		if(pthread_mutex_unlock(&mutex) != 0)
-		{
-			IPACMERR("unable to unlock the mutex\n");
-			return IPACM_FAILURE;
-		}
-		return IPACM_FAILURE;
-	}
-
-	if(pthread_mutex_unlock(&mutex) != 0)
-	{
-		IPACMERR("unable to unlock the mutex\n");
-		return IPACM_FAILURE;
-	}
-
 	return IPACM_SUCCESS;
 }
 
 void IPACM_EvtDispatcher::ProcessEvt(ipacm_cmd_q_data *data)
 {
+	struct timespec start, end;
+	uint32_t latency_us;
+	size_t i;
 
-	cmd_evts *tmp = head, tmp1;
+	if(data->event >= IPACM_EVENT_MAX)
+	{
+		IPACMERR("Invalid event %d\n", data->event);
+		goto free_data;
+	}
 
-	if(head == NULL)
+	if(listeners[data->event].empty())
 	{
-		IPACMDBG("Queue is empty\n");
+		IPACMDBG("No listener for event %d\n", data->event);
 	}
 
-	while(tmp != NULL)
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	IPACM_RuleTxn::Begin();
+	dispatch_depth++;
+	/* index based, a callback may append listeners and reallocate the list */
+	for(i = 0; i < listeners[data->event].size(); i++)
 	{
-	        memcpy(&tmp1, tmp, sizeof(tmp1));
-		if(data->event == tmp1.event)
+		IPACM_Listener *obj = listeners[data->event][i];
+		if(obj != NULL)
 		{
-			ipacm_event_stats[data->event]++;
-			tmp1.obj->event_callback(data->event, data->evt_data);
+			ipacm_event_stats[data->event].count++;
+			obj->event_callback(data->event, data->evt_data);
 			IPACMDBG(" Find matched registered events\n");
 		}
-	        tmp = tmp1.next;
+	}
+	dispatch_depth--;
+	if(dispatch_depth == 0 && compact_pending)
+	{
+		compact();
+	}
+	/* one commit per touched table for everything the listeners changed */
+	IPACM_RuleTxn::End(data->event);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	latency_us = (uint32_t)((end.tv_sec - start.tv_sec) * 1000000 +
+		(end.tv_nsec - start.tv_nsec) / 1000);
+	ipacm_event_stats[data->event].dispatched++;
+	ipacm_event_stats[data->event].total_latency_us += latency_us;
+	if(latency_us > ipacm_event_stats[data->event].max_latency_us)
+	{
+		ipacm_event_stats[data->event].max_latency_us = latency_us;
 	}
 
 	IPACMDBG(" Finished process events\n");
-			
+
+free_data:
 	if(data->evt_data != NULL)
 	{
 		IPACMDBG("free the event:%d data: %pK\n", data->event, data->evt_data);
-		free(data->evt_data);
+		FreeEvtData(data->evt_data);
 	}
 	return;
 }
 
-int IPACM_EvtDispatcher::registr(ipa_cm_event_id event, IPACM_Listener *obj)
+void *IPACM_EvtDispatcher::AllocEvtData(size_t size)
 {
-	cmd_evts *tmp = head,*nw;
+	ipacm_evt_data_block *block = NULL;
+	int i;
 
-	nw = (cmd_evts *)malloc(sizeof(cmd_evts));
-	if(nw != NULL)
+	if(size > sizeof(ipacm_evt_data_block))
 	{
-		nw->event = event;
-		nw->obj = obj;
-		nw->next = NULL;
+		return malloc(size);
 	}
-	else
+
+	pthread_mutex_lock(&data_pool_lock);
+	if(!data_pool_initialized)
 	{
-		return IPACM_FAILURE;
+		for(i = IPACM_EVT_DATA_POOL_SIZE - 1; i >= 0; i--)
+		{
+			data_pool[i].next = data_pool_free;
+			data_pool_free = &data_pool[i];
+		}
+		data_pool_initialized = true;
 	}
 
-	if(head == NULL)
+	block = data_pool_free;
+	if(block != NULL)
 	{
-		head = nw;
+		data_pool_free = block->next;
 	}
 	else
 	{
-		while(tmp->next)
-		{
-			tmp = tmp->next;
-		}
-		tmp->next = nw;
+		data_pool_exhausted++;
+	}
+	pthread_mutex_unlock(&data_pool_lock);
+
+	if(block == NULL)
+	{
+		return malloc(size);
 	}
+	return block;
+}
+
+void IPACM_EvtDispatcher::FreeEvtData(void *data)
+{
+	ipacm_evt_data_block *block = (ipacm_evt_data_block *)data;
+
+	/* payloads of other posters are plain malloc */
+	if(block < &data_pool[0] || block >= &data_pool[IPACM_EVT_DATA_POOL_SIZE])
+	{
+		free(data);
+		return;
+	}
+
+	pthread_mutex_lock(&data_pool_lock);
+	block->next = data_pool_free;
+	data_pool_free = block;
+	pthread_mutex_unlock(&data_pool_lock);
+}
+
+void IPACM_EvtDispatcher::dumpStats(void)
+{
+	IPACMDBG_H("event data pool: %d payloads of %zu bytes, exhausted %llu times\n",
+		IPACM_EVT_DATA_POOL_SIZE, sizeof(ipacm_evt_data_block),
+		(unsigned long long)data_pool_exhausted);
+}
+
+int IPACM_EvtDispatcher::registr(ipa_cm_event_id event, IPACM_Listener *obj)
+{
+	if(event >= IPACM_EVENT_MAX || obj == NULL)
+	{
+		return IPACM_FAILURE;
+	}
+
+	listeners[event].push_back(obj);
 	return IPACM_SUCCESS;
 }
 
 
 int IPACM_EvtDispatcher::deregistr(IPACM_Listener *param)
 {
-	cmd_evts *tmp = head,*tmp1,*prev = head;
+	int event;
+	size_t i;
 
-	while(tmp != NULL)
+	for(event = 0; event < IPACM_EVENT_MAX; event++)
 	{
-		if(tmp->obj == param)
+		for(i = 0; i < listeners[event].size(); i++)
 		{
-			tmp1 = tmp;
-			if(tmp == head)
-			{
-				head = head->next;
-			}
-			else if(tmp->next == NULL)
-			{
-				prev->next = NULL;
-			}
-			else
+			if(listeners[event][i] == param)
 			{
-				prev->next = tmp->next;
+				/* leave a hole so that an ongoing dispatch keeps its position */
+				listeners[event][i] = NULL;
+				compact_pending = true;
 			}
-
-			tmp = tmp->next;
-			free(tmp1);
-		}
-		else
-		{
-			prev = tmp;
-			tmp = tmp->next;
 		}
 	}
+
+	if(dispatch_depth == 0 && compact_pending)
+	{
+		compact();
+	}
 	return IPACM_SUCCESS;
 }
+
+void IPACM_EvtDispatcher::compact(void)
+{
+	int event;
+
+	for(event = 0; event < IPACM_EVENT_MAX; event++)
+	{
+		std::vector<IPACM_Listener *> &list = listeners[event];
+		list.erase(std::remove(list.begin(), list.end(), (IPACM_Listener *)NULL), list.end());
+	}
+	compact_pending = false;
+}
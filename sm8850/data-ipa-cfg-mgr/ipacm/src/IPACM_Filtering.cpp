@@ -79,6 +79,7 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
 
 #include "IPACM_Filtering.h"
 #include <IPACM_Log.h>
+#include "IPACM_RuleTxn.h"
 #include "IPACM_Defs.h"
 #include "IPACM_Iface.h"
 
@@ -107,7 +108,7 @@ bool IPACM_Filtering::DeviceNodeIsOpened()
 	return fd;
 }
 
-bool IPACM_Filtering::AddFilteringRule(struct ipa_ioc_add_flt_rule const *ruleTable)
+bool IPACM_Filtering::AddFilteringRule(struct ipa_ioc_add_flt_rule *ruleTable)
 {
 	int retval = 0;
 
@@ -122,7 +123,8 @@ bool IPACM_Filtering::AddFilteringRule(struct ipa_ioc_add_flt_rule const *ruleTa
 				ruleTable->rules[cnt].rule.attrib.attrib_mask);
 	}
 
-	retval = ioctl(fd, IPA_IOC_ADD_FLT_RULE, ruleTable);
+	retval = IPACM_RuleTxn::Ioctl(fd, IPA_IOC_ADD_FLT_RULE, (void *)ruleTable, &ruleTable->commit,
+		IPACM_RuleTxn::FltTable(ruleTable->ip));
 	if (retval != 0)
 	{
 		IPACMERR("Failed adding Filtering rule %pK\n", ruleTable);
@@ -152,7 +154,7 @@ bool IPACM_Filtering::AddFilteringRule(struct ipa_ioc_add_flt_rule const *ruleTa
 	return true;
 }
 
-bool IPACM_Filtering::AddFilteringRule_v2(struct ipa_ioc_add_flt_rule_v2 const *ruleTable)
+bool IPACM_Filtering::AddFilteringRule_v2(struct ipa_ioc_add_flt_rule_v2 *ruleTable)
 {
 	int retval = 0;
 	int cnt;
@@ -168,7 +170,8 @@ bool IPACM_Filtering::AddFilteringRule_v2(struct ipa_ioc_add_flt_rule_v2 const *
 				((struct ipa_flt_rule_add_v2  *)ruleTable->rules)[cnt].rule.attrib.attrib_mask);
 	}
 
-	retval = ioctl(fd, IPA_IOC_ADD_FLT_RULE_V2, ruleTable);
+	retval = IPACM_RuleTxn::Ioctl(fd, IPA_IOC_ADD_FLT_RULE_V2, (void *)ruleTable, &ruleTable->commit,
+		IPACM_RuleTxn::FltTable(ruleTable->ip));
 	if (retval != 0)
 	{
 		for (cnt = 0; cnt < ruleTable->num_rules; cnt++)
@@ -266,7 +269,8 @@ bool IPACM_Filtering::AddFilteringRule_hw_index(struct ipa_ioc_add_flt_rule *rul
 			&flt_rule_entry, sizeof(flt_rule_entry));
 	}
 
-	retval = ioctl(fd, IPA_IOC_ADD_FLT_RULE_V2, ruleTable_v2);
+	retval = IPACM_RuleTxn::Ioctl(fd, IPA_IOC_ADD_FLT_RULE_V2, ruleTable_v2, &ruleTable_v2->commit,
+		IPACM_RuleTxn::FltTable(ruleTable_v2->ip));
 	if (retval != 0)
 	{
 		IPACMERR("Failed adding Filtering rule %pK\n", ruleTable_v2);
@@ -383,7 +387,8 @@ bool IPACM_Filtering::AddFilteringRuleAfter_hw_index(struct ipa_ioc_add_flt_rule
 				&flt_rule_entry, sizeof(flt_rule_entry));
 		}
 
-		retval = ioctl(fd, IPA_IOC_ADD_FLT_RULE_AFTER_V2, ruleTable_v2);
+		retval = IPACM_RuleTxn::Ioctl(fd, IPA_IOC_ADD_FLT_RULE_AFTER_V2, ruleTable_v2, &ruleTable_v2->commit,
+			IPACM_RuleTxn::FltTable(ruleTable_v2->ip));
 		if (retval != 0)
 		{
 			IPACMERR("Failed adding Filtering rule %pK\n", ruleTable_v2);
@@ -433,7 +438,7 @@ bool IPACM_Filtering::AddFilteringRuleAfter_hw_index(struct ipa_ioc_add_flt_rule
 }
 #endif //IPA_IOCTL_SET_FNR_COUNTER_INFO
 
-bool IPACM_Filtering::AddFilteringRuleAfter(struct ipa_ioc_add_flt_rule_after const *ruleTable)
+bool IPACM_Filtering::AddFilteringRuleAfter(struct ipa_ioc_add_flt_rule_after *ruleTable)
 {
 	int retval = 0;
 
@@ -445,7 +450,8 @@ bool IPACM_Filtering::AddFilteringRuleAfter(struct ipa_ioc_add_flt_rule_after co
 		IPACMDBG("End point: %d\n", ruleTable->ep);
 		IPACMDBG("commit value: %d\n", ruleTable->commit);
 
-		retval = ioctl(fd, IPA_IOC_ADD_FLT_RULE_AFTER, ruleTable);
+		retval = IPACM_RuleTxn::Ioctl(fd, IPA_IOC_ADD_FLT_RULE_AFTER, (void *)ruleTable, &ruleTable->commit,
+			IPACM_RuleTxn::FltTable(ruleTable->ip));
 
 		for (int cnt = 0; cnt<ruleTable->num_rules; cnt++)
 		{
@@ -475,7 +481,9 @@ bool IPACM_Filtering::DeleteFilteringRule(struct ipa_ioc_del_flt_rule *ruleTable
 {
 	int retval = 0;
 
+	IPACM_RuleTxn::Lock();
 	retval = ioctl(fd, IPA_IOC_DEL_FLT_RULE, ruleTable);
+	IPACM_RuleTxn::Unlock();
 	if (retval != 0)
 	{
 		IPACMERR("Failed deleting Filtering rule %pK\n", ruleTable);
@@ -490,7 +498,9 @@ bool IPACM_Filtering::Commit(enum ipa_ip_type ip)
 {
 	int retval = 0;
 
+	IPACM_RuleTxn::Lock();
 	retval = ioctl(fd, IPA_IOC_COMMIT_FLT, ip);
+	IPACM_RuleTxn::Unlock();
 	if (retval != 0)
 	{
 		IPACMERR("failed committing Filtering rules.\n");
@@ -505,8 +515,10 @@ bool IPACM_Filtering::Reset(enum ipa_ip_type ip)
 {
 	int retval = 0;
 
+	IPACM_RuleTxn::Lock();
 	retval = ioctl(fd, IPA_IOC_RESET_FLT, ip);
 	retval |= ioctl(fd, IPA_IOC_COMMIT_FLT, ip);
+	IPACM_RuleTxn::Unlock();
 	if (retval)
 	{
 		IPACMERR("failed resetting Filtering block.\n");
@@ -587,6 +599,9 @@ bool IPACM_Filtering::AddWanDLFilteringRule(struct ipa_ioc_add_flt_rule const *r
 	ipa_install_fltr_rule_req_msg_v01 qmi_rule_msg;
 	ipa_install_fltr_rule_req_ex_msg_v01 qmi_rule_ex_msg;
 
+	/* the modem is told about rules that must already be in HW */
+	IPACM_RuleTxn::Flush();
+
 	memset(&qmi_rule_msg, 0, sizeof(qmi_rule_msg));
 	int fd_wwan_ioctl = open(WWAN_QMI_IOCTL_DEVICE_NAME, O_RDWR);
 	if(fd_wwan_ioctl < 0)
@@ -805,6 +820,8 @@ bool IPACM_Filtering::AddOffloadFilteringRule(struct ipa_ioc_add_flt_rule *flt_r
 		return false;
 	}
 
+	IPACM_RuleTxn::Flush();
+
 	if(flt_rule_tbl == NULL)
 	{
 		if(mux_id ==0)
@@ -948,6 +965,8 @@ bool IPACM_Filtering::DelOffloadFilteringRule(struct ipa_ioc_del_flt_rule const
 	ipa_remove_offload_connection_req_msg_v01 qmi_del_msg;
 	int fd_wwan_ioctl = open(WWAN_QMI_IOCTL_DEVICE_NAME, O_RDWR);
 
+	IPACM_RuleTxn::Flush();
+
 	if(fd_wwan_ioctl < 0)
 	{
 		IPACMERR("Failed to open %s.\n",WWAN_QMI_IOCTL_DEVICE_NAME);
@@ -1044,6 +1063,8 @@ bool IPACM_Filtering::SendFilteringRuleIndex(struct ipa_fltr_installed_notif_req
 		return false;
 	}
 
+	IPACM_RuleTxn::Flush();
+
 	ret = ioctl(fd_wwan_ioctl, WAN_IOC_ADD_FLT_RULE_INDEX, table);
 	if (ret != 0)
 	{
@@ -1090,7 +1111,8 @@ bool IPACM_Filtering::ModifyFilteringRule(struct ipa_ioc_mdfy_flt_rule* ruleTabl
 		IPACMDBG("Filter rule:%d attrib mask: 0x%x\n", i, ruleTable->rules[i].rule.attrib.attrib_mask);
 	}
 
-	ret = ioctl(fd, IPA_IOC_MDFY_FLT_RULE, ruleTable);
+	ret = IPACM_RuleTxn::Ioctl(fd, IPA_IOC_MDFY_FLT_RULE, ruleTable, &ruleTable->commit,
+		IPACM_RuleTxn::FltTable(ruleTable->ip));
 
 	for (i = 0; i < ruleTable->num_rules; i++)
 	{
@@ -34,6 +34,7 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "IPACM_Header.h"
 #include "IPACM_Log.h"
+#include "IPACM_RuleTxn.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -74,7 +75,8 @@ bool IPACM_Header::AddHeader(struct ipa_ioc_add_hdr *pHeaderTableToAdd)
 {
 	int nRetVal = 0;
 	//call the Driver ioctl in order to add header
-	nRetVal = ioctl(m_fd, IPA_IOC_ADD_HDR, pHeaderTableToAdd);
+	nRetVal = IPACM_RuleTxn::Ioctl(m_fd, IPA_IOC_ADD_HDR, pHeaderTableToAdd, &pHeaderTableToAdd->commit,
+		IPACM_TXN_HDR);
 	IPACMDBG("return value: %d\n", nRetVal);
 	return (-1 != nRetVal);
 }
@@ -85,7 +87,9 @@ bool IPACM_Header::DeleteHeader(struct ipa_ioc_del_hdr *pHeaderTableToDelete)
 {
 	int nRetVal = 0;
 	//call the Driver ioctl in order to remove header
+	IPACM_RuleTxn::Lock();
 	nRetVal = ioctl(m_fd, IPA_IOC_DEL_HDR, pHeaderTableToDelete);
+	IPACM_RuleTxn::Unlock();
 	IPACMDBG("return value: %d\n", nRetVal);
 	return (-1 != nRetVal);
 }
@@ -95,7 +99,9 @@ bool IPACM_Header::DeleteHeader(struct ipa_ioc_del_hdr *pHeaderTableToDelete)
 bool IPACM_Header::Commit()
 {
 	int nRetVal = 0;
+	IPACM_RuleTxn::Lock();
 	nRetVal = ioctl(m_fd, IPA_IOC_COMMIT_HDR);
+	IPACM_RuleTxn::Unlock();
 	IPACMDBG("return value: %d\n", nRetVal);
 	return true;
 }
@@ -106,8 +112,10 @@ bool IPACM_Header::Reset()
 {
 	int nRetVal = 0;
 
+	IPACM_RuleTxn::Lock();
 	nRetVal = ioctl(m_fd, IPA_IOC_RESET_HDR);
 	nRetVal |= ioctl(m_fd, IPA_IOC_COMMIT_HDR);
+	IPACM_RuleTxn::Unlock();
 	IPACMDBG("return value: %d\n", nRetVal);
 	return true;
 }
@@ -202,7 +210,8 @@ bool IPACM_Header::AddHeaderProcCtx(struct ipa_ioc_add_hdr_proc_ctx* pHeader)
 {
 	int ret = 0;
 	//call the Driver ioctl to add header processing context
-	ret = ioctl(m_fd, IPA_IOC_ADD_HDR_PROC_CTX, pHeader);
+	ret = IPACM_RuleTxn::Ioctl(m_fd, IPA_IOC_ADD_HDR_PROC_CTX, pHeader, &pHeader->commit,
+		IPACM_TXN_HDR);
 	return (ret == 0);
 }
 
@@ -224,7 +233,9 @@ bool IPACM_Header::DeleteHeaderProcCtx(uint32_t hdl)
 	pHeaderTable->num_hdls = 1;
 	pHeaderTable->hdl[0].hdl = hdl;
 
+	IPACM_RuleTxn::Lock();
 	ret = ioctl(m_fd, IPA_IOC_DEL_HDR_PROC_CTX, pHeaderTable);
+	IPACM_RuleTxn::Unlock();
 	if(ret != 0)
 	{
 		IPACMERR("Failed to delete hdr proc ctx: return value %d, status %d\n",
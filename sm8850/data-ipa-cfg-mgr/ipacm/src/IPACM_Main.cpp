@@ -105,6 +105,7 @@ typedef uint32_t in_addr_t;
 #include "IPACM_ConntrackListener.h"
 #include "IPACM_ConntrackClient.h"
 #include "IPACM_Netlink.h"
+#include "IPACM_RuleTxn.h"
 
 #ifdef FEATURE_IPACM_HAL
 #include "IPACM_OffloadManager.h"
@@ -136,7 +137,7 @@ typedef uint32_t in_addr_t;
 #define IPA_DRIVER_WLAN_META_MSG    (sizeof(struct ipa_msg_meta))
 #define IPA_DRIVER_WLAN_BUF_LEN     (IPA_DRIVER_PIPE_STATS_EVENT_SIZE + IPA_DRIVER_WLAN_META_MSG)
 
-uint32_t ipacm_event_stats[IPACM_EVENT_MAX];
+ipacm_event_stat ipacm_event_stats[IPACM_EVENT_MAX];
 bool ipacm_logging = true;
 
 void ipa_is_ipacm_running(void);
@@ -1029,6 +1030,17 @@ void IPACM_Sig_Handler(int sig)
 	printf("Received Signal: %d\n", sig);
 	memset(&evt_data, 0, sizeof(evt_data));
 
+	if(sig == SIGHUP)
+	{
+		/* debug dump, nothing to post */
+		MessageQueue::dumpStats();
+		IPACM_EvtDispatcher::dumpStats();
+		IPACM_RuleTxn::DumpStats();
+		NatApp::DumpStats();
+		IPACM_ConntrackWorkers::DumpStats();
+		return;
+	}
+
 	switch(sig)
 	{
 		case SIGUSR1:
@@ -1054,6 +1066,7 @@ void RegisterForSignals(void)
 
 	signal(SIGUSR1, IPACM_Sig_Handler);
 	signal(SIGUSR2, IPACM_Sig_Handler);
+	signal(SIGHUP, IPACM_Sig_Handler);
 }
 
 
@@ -1101,6 +1114,8 @@ int main(int argc, char **argv)
 	/* reset coalesce settings */
 	IPACM_Wan::coalesce_config_reset();
 
+	IPACM_RuleTxn::Init();
+
 	RegisterForSignals();
 
 	if (IPACM_SUCCESS == cmd_queue_thread)
@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*!
+	@file
+	IPACM_NatCacheBench.cpp
+
+	@brief
+	Replays a synthetic connection churn against the NatApp cache, once with the
+	linear scans NatApp used to do and once with NatCacheIndex, and checks that
+	both end up with the same cache content.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include "IPACM_NatCacheIndex.h"
+
+#define BENCH_CLIENT_NET 0xC0A82B00 /* 192.168.43.0/24 */
+#define BENCH_TARGET_NET 0x0A000000 /* 10.0.0.0/8 */
+
+typedef struct
+{
+	uint64_t add_ns;
+	uint64_t del_ns;
+	uint64_t discon_ns;
+	int added;
+	int deleted;
+	int disconnected;
+	int full;
+} bench_result;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void gen_flow(unsigned int *seed, int num_clients, nat_table_entry *flow)
+{
+	memset(flow, 0, sizeof(*flow));
+	flow->private_ip = BENCH_CLIENT_NET + 2 + (rand_r(seed) % num_clients);
+	flow->target_ip = BENCH_TARGET_NET + (rand_r(seed) & 0xffffff);
+	flow->private_port = 1024 + (rand_r(seed) % 60000);
+	flow->target_port = (rand_r(seed) & 1) ? 443 : 1024 + (rand_r(seed) % 60000);
+	flow->public_port = flow->private_port;
+	flow->protocol = (rand_r(seed) & 3) ? IPPROTO_TCP : IPPROTO_UDP;
+}
+
+static bool same_tuple(const nat_table_entry *a, const nat_table_entry *b)
+{
+	return a->private_ip == b->private_ip &&
+		a->target_ip == b->target_ip &&
+		a->private_port == b->private_port &&
+		a->target_port == b->target_port &&
+		a->protocol == b->protocol;
+}
+
+static bool is_empty(const nat_table_entry *entry)
+{
+	return entry->private_ip == 0 && entry->target_ip == 0 && entry->private_port == 0 &&
+		entry->target_port == 0 && entry->protocol == 0;
+}
+
+/* the scans NatApp did before the index */
+static void run_linear(nat_table_entry *cache, int max_entries, const nat_table_entry *ops,
+	const char *op_type, int num_ops, bench_result *res)
+{
+	int op, cnt;
+	uint64_t start;
+
+	for(op = 0; op < num_ops; op++)
+	{
+		start = now_ns();
+		if(op_type[op] == 'a')
+		{
+			for(cnt = 0; cnt < max_entries; cnt++)
+			{
+				if(same_tuple(&cache[cnt], &ops[op]))
+				{
+					break;
+				}
+			}
+			if(cnt == max_entries)
+			{
+				for(cnt = 0; cnt < max_entries; cnt++)
+				{
+					if(is_empty(&cache[cnt]))
+					{
+						break;
+					}
+				}
+				if(cnt == max_entries)
+				{
+					res->full++;
+				}
+				else
+				{
+					cache[cnt] = ops[op];
+					res->added++;
+				}
+			}
+			res->add_ns += now_ns() - start;
+		}
+		else if(op_type[op] == 'd')
+		{
+			for(cnt = 0; cnt < max_entries; cnt++)
+			{
+				if(same_tuple(&cache[cnt], &ops[op]))
+				{
+					memset(&cache[cnt], 0, sizeof(cache[cnt]));
+					res->deleted++;
+					break;
+				}
+			}
+			res->del_ns += now_ns() - start;
+		}
+		else
+		{
+			for(cnt = 0; cnt < max_entries; cnt++)
+			{
+				if(cache[cnt].private_ip == ops[op].private_ip)
+				{
+					memset(&cache[cnt], 0, sizeof(cache[cnt]));
+					res->disconnected++;
+				}
+			}
+			res->discon_ns += now_ns() - start;
+		}
+	}
+}
+
+static int run_indexed(nat_table_entry *cache, int max_entries, const nat_table_entry *ops,
+	const char *op_type, int num_ops, bench_result *res)
+{
+	NatCacheIndex index;
+	int op, cnt, next;
+	uint64_t start;
+
+	if(index.Init(cache, max_entries))
+	{
+		return -1;
+	}
+
+	for(op = 0; op < num_ops; op++)
+	{
+		start = now_ns();
+		if(op_type[op] == 'a')
+		{
+			if(index.Find(&ops[op]) < 0)
+			{
+				cnt = index.GetFreeSlot();
+				if(cnt < 0)
+				{
+					res->full++;
+				}
+				else
+				{
+					cache[cnt] = ops[op];
+					index.Insert(cnt);
+					res->added++;
+				}
+			}
+			res->add_ns += now_ns() - start;
+		}
+		else if(op_type[op] == 'd')
+		{
+			cnt = index.Find(&ops[op]);
+			if(cnt >= 0)
+			{
+				index.Remove(cnt);
+				memset(&cache[cnt], 0, sizeof(cache[cnt]));
+				res->deleted++;
+			}
+			res->del_ns += now_ns() - start;
+		}
+		else
+		{
+			for(cnt = index.FirstByPrivateIp(ops[op].private_ip); cnt >= 0; cnt = next)
+			{
+				next = index.NextByPrivateIp(cnt);
+				index.Remove(cnt);
+				memset(&cache[cnt], 0, sizeof(cache[cnt]));
+				res->disconnected++;
+			}
+			res->discon_ns += now_ns() - start;
+		}
+	}
+	return 0;
+}
+
+static void print_result(const char *name, const bench_result *res, int adds, int dels,
+	int discons)
+{
+	printf("%-8s add %8.2fus del %8.2fus disconnect %8.2fus (added %d deleted %d disconnected %d full %d)\n",
+		name, adds ? res->add_ns / 1000.0 / adds : 0.0, dels ? res->del_ns / 1000.0 / dels : 0.0,
+		discons ? res->discon_ns / 1000.0 / discons : 0.0, res->added, res->deleted,
+		res->disconnected, res->full);
+}
+
+static void usage(const char *name)
+{
+	printf("Usage: %s [-e max_entries] [-f flows] [-c clients] [-o churn_ops] [-s seed]\n", name);
+}
+
+int main(int argc, char **argv)
+{
+	int max_entries = 16384, num_flows = 10000, num_clients = 64, churn = 100000;
+	unsigned int seed = 1;
+	int opt, op, num_ops, live, adds = 0, dels = 0, discons = 0;
+	nat_table_entry *ops, *live_flows, *linear_cache, *indexed_cache;
+	char *op_type;
+	bench_result linear, indexed;
+
+	while((opt = getopt(argc, argv, "e:f:c:o:s:h")) != -1)
+	{
+		switch(opt)
+		{
+			case 'e':
+				max_entries = atoi(optarg);
+				break;
+			case 'f':
+				num_flows = atoi(optarg);
+				break;
+			case 'c':
+				num_clients = atoi(optarg);
+				break;
+			case 'o':
+				churn = atoi(optarg);
+				break;
+			case 's':
+				seed = (unsigned int)atoi(optarg);
+				break;
+			default:
+				usage(argv[0]);
+				return -1;
+		}
+	}
+	if(max_entries <= 0 || num_flows <= 0 || num_clients <= 0 || churn < 0)
+	{
+		usage(argv[0]);
+		return -1;
+	}
+
+	/* fill up to num_flows, then replace one flow per step, disconnect a client every 1000 */
+	num_ops = num_flows + 2 * churn + churn / 1000;
+	ops = (nat_table_entry *)calloc(num_ops, sizeof(nat_table_entry));
+	op_type = (char *)calloc(num_ops, 1);
+	live_flows = (nat_table_entry *)calloc(num_flows, sizeof(nat_table_entry));
+	linear_cache = (nat_table_entry *)calloc(max_entries, sizeof(nat_table_entry));
+	indexed_cache = (nat_table_entry *)calloc(max_entries, sizeof(nat_table_entry));
+	if(!ops || !op_type || !live_flows || !linear_cache || !indexed_cache)
+	{
+		printf("Unable to allocate memory\n");
+		return -1;
+	}
+
+	num_ops = 0;
+	for(live = 0; live < num_flows; live++)
+	{
+		gen_flow(&seed, num_clients, &live_flows[live]);
+		ops[num_ops] = live_flows[live];
+		op_type[num_ops++] = 'a';
+		adds++;
+	}
+	for(op = 0; op < churn; op++)
+	{
+		live = rand_r(&seed) % num_flows;
+		ops[num_ops] = live_flows[live];
+		op_type[num_ops++] = 'd';
+		dels++;
+		gen_flow(&seed, num_clients, &live_flows[live]);
+		ops[num_ops] = live_flows[live];
+		op_type[num_ops++] = 'a';
+		adds++;
+		if(op % 1000 == 999)
+		{
+			memset(&ops[num_ops], 0, sizeof(ops[num_ops]));
+			ops[num_ops].private_ip = BENCH_CLIENT_NET + 2 + (rand_r(&seed) % num_clients);
+			op_type[num_ops++] = 'c';
+			discons++;
+		}
+	}
+
+	memset(&linear, 0, sizeof(linear));
+	memset(&indexed, 0, sizeof(indexed));
+	run_linear(linear_cache, max_entries, ops, op_type, num_ops, &linear);
+	if(run_indexed(indexed_cache, max_entries, ops, op_type, num_ops, &indexed))
+	{
+		printf("Unable to allocate the cache index\n");
+		return -1;
+	}
+
+	printf("entries %d flows %d clients %d churn %d\n", max_entries, num_flows, num_clients, churn);
+	print_result("linear", &linear, adds, dels, discons);
+	print_result("indexed", &indexed, adds, dels, discons);
+
+	/* slots may differ, the sets of flows must not */
+	if(linear.added != indexed.added || linear.deleted != indexed.deleted ||
+		linear.disconnected != indexed.disconnected || linear.full != indexed.full)
+	{
+		printf("MISMATCH between linear and indexed cache\n");
+		return -1;
+	}
+
+	free(ops);
+	free(op_type);
+	free(live_flows);
+	free(linear_cache);
+	free(indexed_cache);
+	return 0;
+}
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*!
+	@file
+	IPACM_NatCacheIndex.cpp
+
+	@brief
+	Hash indexes over the NatApp connection cache
+*/
+#include <stdlib.h>
+#include <string.h>
+#include "IPACM_NatCacheIndex.h"
+
+NatCacheIndex::NatCacheIndex()
+{
+	cache = NULL;
+	max_entries = 0;
+	bucket_mask = 0;
+	memset(buckets, 0, sizeof(buckets));
+	memset(links, 0, sizeof(links));
+	free_links = NULL;
+	free_head = -1;
+}
+
+NatCacheIndex::~NatCacheIndex()
+{
+	Release();
+}
+
+void NatCacheIndex::Release()
+{
+	int idx;
+
+	for(idx = 0; idx < IDX_MAX; idx++)
+	{
+		free(buckets[idx]);
+		buckets[idx] = NULL;
+		free(links[idx]);
+		links[idx] = NULL;
+	}
+	free(free_links);
+	free_links = NULL;
+	free_head = -1;
+}
+
+int NatCacheIndex::Init(const nat_table_entry *entries, int num_entries)
+{
+	uint32_t num_buckets = 1;
+	int idx, slot;
+
+	Release();
+	cache = entries;
+	max_entries = num_entries;
+
+	/* keep the load factor at or below one */
+	while(num_buckets < (uint32_t)num_entries)
+	{
+		num_buckets <<= 1;
+	}
+	bucket_mask = num_buckets - 1;
+
+	for(idx = 0; idx < IDX_MAX; idx++)
+	{
+		buckets[idx] = (int *)malloc(sizeof(int) * num_buckets);
+		links[idx] = (slot_link *)malloc(sizeof(slot_link) * (num_entries ? num_entries : 1));
+		if(buckets[idx] == NULL || links[idx] == NULL)
+		{
+			goto fail;
+		}
+		memset(buckets[idx], 0xff, sizeof(int) * num_buckets);
+	}
+	free_links = (slot_link *)malloc(sizeof(slot_link) * (num_entries ? num_entries : 1));
+	if(free_links == NULL)
+	{
+		goto fail;
+	}
+	for(slot = 0; slot < num_entries; slot++)
+	{
+		free_links[slot].prev = NOT_FREE;
+	}
+
+	/* walk backwards so that the lowest empty slot is handed out first, like the linear scan */
+	for(slot = num_entries - 1; slot >= 0; slot--)
+	{
+		if(IsEmpty(&cache[slot]))
+		{
+			Link(&free_head, free_links, slot);
+		}
+		else
+		{
+			Insert(slot);
+		}
+	}
+	return 0;
+
+fail:
+	Release();
+	max_entries = 0;
+	return -1;
+}
+
+uint32_t NatCacheIndex::HashIp(uint32_t ip)
+{
+	/* murmur3 finalizer */
+	ip ^= ip >> 16;
+	ip *= 0x85ebca6b;
+	ip ^= ip >> 13;
+	ip *= 0xc2b2ae35;
+	ip ^= ip >> 16;
+	return ip;
+}
+
+uint32_t NatCacheIndex::HashTuple(const nat_table_entry *rule)
+{
+	uint32_t hash;
+
+	hash = HashIp(rule->private_ip);
+	hash = HashIp(hash ^ rule->target_ip);
+	hash = HashIp(hash ^ (((uint32_t)rule->private_port << 16) | rule->target_port));
+	return HashIp(hash ^ rule->protocol);
+}
+
+bool NatCacheIndex::SameTuple(const nat_table_entry *a, const nat_table_entry *b)
+{
+	return a->private_ip == b->private_ip &&
+		a->target_ip == b->target_ip &&
+		a->private_port == b->private_port &&
+		a->target_port == b->target_port &&
+		a->protocol == b->protocol;
+}
+
+bool NatCacheIndex::IsEmpty(const nat_table_entry *entry)
+{
+	return entry->private_ip == 0 &&
+		entry->target_ip == 0 &&
+		entry->private_port == 0 &&
+		entry->target_port == 0 &&
+		entry->protocol == 0;
+}
+
+uint32_t NatCacheIndex::Bucket(int idx, const nat_table_entry *entry) const
+{
+	switch(idx)
+	{
+		case IDX_TUPLE:
+			return HashTuple(entry) & bucket_mask;
+		case IDX_PRIVATE_IP:
+			return HashIp(entry->private_ip) & bucket_mask;
+		default:
+			return HashIp(entry->target_ip) & bucket_mask;
+	}
+}
+
+void NatCacheIndex::Link(int *head, slot_link *link, int slot)
+{
+	link[slot].prev = -1;
+	link[slot].next = *head;
+	if(*head >= 0)
+	{
+		link[*head].prev = slot;
+	}
+	*head = slot;
+}
+
+void NatCacheIndex::Unlink(int *head, slot_link *link, int slot)
+{
+	if(link[slot].prev >= 0)
+	{
+		link[link[slot].prev].next = link[slot].next;
+	}
+	else
+	{
+		*head = link[slot].next;
+	}
+	if(link[slot].next >= 0)
+	{
+		link[link[slot].next].prev = link[slot].prev;
+	}
+}
+
+int NatCacheIndex::Find(const nat_table_entry *rule) const
+{
+	int slot;
+
+	if(max_entries == 0)
+	{
+		return -1;
+	}
+
+	for(slot = buckets[IDX_TUPLE][HashTuple(rule) & bucket_mask]; slot >= 0;
+		slot = links[IDX_TUPLE][slot].next)
+	{
+		if(SameTuple(&cache[slot], rule))
+		{
+			return slot;
+		}
+	}
+	return -1;
+}
+
+void NatCacheIndex::Insert(int slot)
+{
+	int idx;
+
+	if(slot < 0 || slot >= max_entries)
+	{
+		return;
+	}
+
+	if(free_links[slot].prev != NOT_FREE)
+	{
+		Unlink(&free_head, free_links, slot);
+		free_links[slot].prev = NOT_FREE;
+	}
+
+	for(idx = 0; idx < IDX_MAX; idx++)
+	{
+		Link(&buckets[idx][Bucket(idx, &cache[slot])], links[idx], slot);
+	}
+}
+
+void NatCacheIndex::Remove(int slot)
+{
+	int idx;
+
+	if(slot < 0 || slot >= max_entries)
+	{
+		return;
+	}
+
+	for(idx = 0; idx < IDX_MAX; idx++)
+	{
+		Unlink(&buckets[idx][Bucket(idx, &cache[slot])], links[idx], slot);
+	}
+	Link(&free_head, free_links, slot);
+}
+
+int NatCacheIndex::FirstByPrivateIp(uint32_t ip) const
+{
+	int slot;
+
+	if(max_entries == 0)
+	{
+		return -1;
+	}
+
+	slot = buckets[IDX_PRIVATE_IP][HashIp(ip) & bucket_mask];
+	while(slot >= 0 && cache[slot].private_ip != ip)
+	{
+		slot = links[IDX_PRIVATE_IP][slot].next;
+	}
+	return slot;
+}
+
+int NatCacheIndex::NextByPrivateIp(int slot) const
+{
+	uint32_t ip = cache[slot].private_ip;
+
+	do
+	{
+		slot = links[IDX_PRIVATE_IP][slot].next;
+	} while(slot >= 0 && cache[slot].private_ip != ip);
+	return slot;
+}
+
+int NatCacheIndex::FirstByTargetIp(uint32_t ip) const
+{
+	int slot;
+
+	if(max_entries == 0)
+	{
+		return -1;
+	}
+
+	slot = buckets[IDX_TARGET_IP][HashIp(ip) & bucket_mask];
+	while(slot >= 0 && cache[slot].target_ip != ip)
+	{
+		slot = links[IDX_TARGET_IP][slot].next;
+	}
+	return slot;
+}
+
+int NatCacheIndex::NextByTargetIp(int slot) const
+{
+	uint32_t ip = cache[slot].target_ip;
+
+	do
+	{
+		slot = links[IDX_TARGET_IP][slot].next;
+	} while(slot >= 0 && cache[slot].target_ip != ip);
+	return slot;
+}
@@ -287,170 +287,50 @@ static int ipa_nl_sock_listener_start
 	return IPACM_SUCCESS;
 }
 
-/* allocate memory for ipa_nl__msg */
-static struct msghdr* ipa_nl_alloc_msg
-(
-	 uint32_t msglen
-	 )
-{
-	unsigned char *buf = NULL;
-	struct sockaddr_nl *nladdr = NULL;
-	struct iovec *iov = NULL;
-	struct msghdr *msgh = NULL;
-
-	if(IPA_NL_MSG_MAX_LEN < msglen)
-	{
-		IPACMERR("Netlink message exceeds maximum length\n");
-		return NULL;
-	}
-
-	msgh = (struct msghdr *)malloc(sizeof(struct msghdr));
-	if(msgh == NULL)
-	{
-		IPACMERR("Failed malloc for msghdr\n");
-		return NULL;
-	}
-
-	nladdr = (struct sockaddr_nl *)malloc(sizeof(struct sockaddr_nl));
-	if(nladdr == NULL)
-	{
-		IPACMERR("Failed malloc for sockaddr\n");
-		free(msgh);
-		return NULL;
-	}
-
-	iov = (struct iovec *)malloc(sizeof(struct iovec));
-	if(iov == NULL)
-	{
-		PERROR("Failed malloc for iovec");
-		free(nladdr);
-		free(msgh);
-		return NULL;
-	}
-
-	buf = (unsigned char *)malloc(msglen);
-	if(buf == NULL)
-	{
-		IPACMERR("Failed malloc for mglen\n");
-		free(iov);
-		free(nladdr);
-		free(msgh);
-		return NULL;
-	}
-
-	memset(nladdr, 0, sizeof(struct sockaddr_nl));
-	nladdr->nl_family = AF_NETLINK;
-
-	memset(msgh, 0x0, sizeof(struct msghdr));
-	msgh->msg_name = nladdr;
-	msgh->msg_namelen = sizeof(struct sockaddr_nl);
-	msgh->msg_iov = iov;
-	msgh->msg_iovlen = 1;
-
-	memset(iov, 0x0, sizeof(struct iovec));
-	iov->iov_base = buf;
-	iov->iov_len = msglen;
-
-	return msgh;
-}
-
-/* release IPA message */
-static void ipa_nl_release_msg
-(
-	 struct msghdr *msgh
-	 )
+/* Receive arena of the netlink thread, reused for every read. The kernel queues one
+   datagram per notification, a single recvmmsg picks up a burst of them. */
+static struct
 {
-	unsigned char *buf = NULL;
-	struct sockaddr_nl *nladdr = NULL;
-	struct iovec *iov = NULL;
-
-	if(NULL == msgh)
-	{
-		return;
-	}
-
-	nladdr = (struct sockaddr_nl *)msgh->msg_name;
-	iov = msgh->msg_iov;
-	if(msgh->msg_iov)
-	{
-		buf = (unsigned char *)msgh->msg_iov->iov_base;
-	}
-
-	if(buf)
-	{
-	free(buf);
-	}
-	if(iov)
-	{
-	free(iov);
-	}
-	if(nladdr)
-	{
-	free(nladdr);
-	}
-	if(msgh)
-	{
-	free(msgh);
-	}
-	return;
-}
-
-/* receive and process nl message */
+	struct mmsghdr msgs[IPA_NL_RECV_MSGS];
+	struct iovec iov[IPA_NL_RECV_MSGS];
+	struct sockaddr_nl addr[IPA_NL_RECV_MSGS];
+	ipa_nl_msg_t nlmsg;
+	uint32_t buf[IPA_NL_RECV_MSGS][IPA_NL_MSG_MAX_LEN / sizeof(uint32_t)];
+} nl_arena;
+
+/* receive up to IPA_NL_RECV_MSGS messages, waiting only for the first */
 static int ipa_nl_recv
 (
-	 int              fd,
-	 struct msghdr **msg_pptr,
-	 unsigned int  *msglen_ptr
+	 int  fd,
+	 int *num_msgs
 	 )
 {
-	struct msghdr *msgh = NULL;
-	int rmsgl;
+	int i, rmsgs;
 
-	msgh = ipa_nl_alloc_msg(IPA_NL_MSG_MAX_LEN);
-	if(NULL == msgh)
+	for(i = 0; i < IPA_NL_RECV_MSGS; i++)
 	{
-		IPACMERR("Failed to allocate NL message\n");
-		goto error;
+		nl_arena.iov[i].iov_base = nl_arena.buf[i];
+		nl_arena.iov[i].iov_len = sizeof(nl_arena.buf[i]);
+		memset(&nl_arena.msgs[i].msg_hdr, 0, sizeof(nl_arena.msgs[i].msg_hdr));
+		nl_arena.msgs[i].msg_hdr.msg_name = &nl_arena.addr[i];
+		nl_arena.msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_nl);
+		nl_arena.msgs[i].msg_hdr.msg_iov = &nl_arena.iov[i];
+		nl_arena.msgs[i].msg_hdr.msg_iovlen = 1;
 	}
 
-
-	/* Receive message over the socket */
-	rmsgl = recvmsg(fd, msgh, 0);
+	/* Receive messages over the socket */
+	rmsgs = recvmmsg(fd, nl_arena.msgs, IPA_NL_RECV_MSGS, MSG_WAITFORONE, NULL);
 
 	/* Verify that something was read */
-	if(rmsgl <= 0)
+	if(rmsgs <= 0)
 	{
 		PERROR("NL recv error");
-		goto error;
-	}
-
-	/* Verify that NL address length in the received message is expected value */
-	if(sizeof(struct sockaddr_nl) != msgh->msg_namelen)
-	{
-		IPACMERR("rcvd msg with namelen != sizeof sockaddr_nl\n");
-		goto error;
-	}
-
-	/* Verify that message was not truncated. This should not occur */
-	if(msgh->msg_flags & MSG_TRUNC)
-	{
-		IPACMERR("Rcvd msg truncated!\n");
-		goto error;
+		*num_msgs = 0;
+		return IPACM_FAILURE;
 	}
 
-	*msg_pptr    = msgh;
-	*msglen_ptr = rmsgl;
-
+	*num_msgs = rmsgs;
 	return IPACM_SUCCESS;
-
-/* An error occurred while receiving the message. Free all memory before
-				 returning. */
-error:
-	ipa_nl_release_msg(msgh);
-	*msg_pptr    = NULL;
-	*msglen_ptr  = 0;
-
-	return IPACM_FAILURE;
 }
 
 /* decode the rtm netlink message */
@@ -485,7 +365,7 @@ static int ipa_nl_decode_rtm_addr
 
 	/* Extract the header data */
 	addr_info->metainfo = *((struct ifaddrmsg *)NLMSG_DATA(nlh));
-	buflen -= sizeof(struct nlmsghdr);
+	buflen = IFA_PAYLOAD(nlh);
 
 	/* Extract the available attributes */
 	addr_info->attr_info.param_mask = IPA_NLA_PARAM_NONE;
@@ -526,7 +406,7 @@ static int ipa_nl_decode_rtm_neigh
 
 	/* Extract the header data */
 	neigh_info->metainfo = *((struct ndmsg *)NLMSG_DATA(nlh));
-	buflen -= sizeof(struct nlmsghdr);
+	buflen = NLMSG_PAYLOAD(nlh, sizeof(struct ndmsg));
 
 	/* Extract the available attributes */
 	neigh_info->attr_info.param_mask = IPA_NLA_PARAM_NONE;
@@ -574,7 +454,7 @@ static int ipa_nl_decode_rtm_route
 
 	/* Extract the header data */
 	route_info->metainfo = *((struct rtmsg *)NLMSG_DATA(nlh));
-	buflen -= sizeof(struct nlmsghdr);
+	buflen = RTM_PAYLOAD(nlh);
 
 	route_info->attr_info.param_mask = IPA_RTA_PARAM_NONE;
 	rtah = RTM_RTA(NLMSG_DATA(nlh));
@@ -635,6 +515,19 @@ static int ipa_nl_decode_rtm_route
 	return IPACM_SUCCESS;
 }
 
+/* the payload goes back to the pool if the event could not be queued */
+static void ipa_nl_post_evt
+(
+	 ipacm_cmd_q_data *evt_data
+	 )
+{
+	if(0 != IPACM_EvtDispatcher::PostEvt(evt_data))
+	{
+		IPACMERR("Error posting event %d\n", evt_data->event);
+		IPACM_EvtDispatcher::FreeEvtData(evt_data->evt_data);
+	}
+}
+
 /* decode the ipa nl-message */
 static int ipa_nl_decode_nlmsg
 (
@@ -664,7 +557,7 @@ static int ipa_nl_decode_nlmsg
 		case RTM_NEWLINK:
 			msg_ptr->type = nlh->nlmsg_type;
 			msg_ptr->link_event = true;
-			if(IPACM_SUCCESS != ipa_nl_decode_rtm_link(buffer, buflen, &(msg_ptr->nl_link_info)))
+			if(IPACM_SUCCESS != ipa_nl_decode_rtm_link((const char *)nlh, nlh->nlmsg_len, &(msg_ptr->nl_link_info)))
 			{
 				IPACMERR("Failed to decode rtm link message\n");
 				return IPACM_FAILURE;
@@ -696,7 +589,7 @@ static int ipa_nl_decode_nlmsg
 						return IPACM_FAILURE;
 					}
 
-					data_fid = (ipacm_event_data_fid *)malloc(sizeof(ipacm_event_data_fid));
+					data_fid = (ipacm_event_data_fid *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_fid));
 					if(data_fid == NULL)
 					{
 						IPACMERR("unable to allocate memory for event data_fid\n");
@@ -721,7 +614,7 @@ static int ipa_nl_decode_nlmsg
 										 data_fid->if_index);
 					}
 					evt_data.evt_data = data_fid;
-					IPACM_EvtDispatcher::PostEvt(&evt_data);
+					ipa_nl_post_evt(&evt_data);
 				}
 				/* Andorid platform will use events from usb-driver directly */
 #ifndef FEATURE_IPA_ANDROID
@@ -734,7 +627,7 @@ static int ipa_nl_decode_nlmsg
                    (msg_ptr->nl_link_info.metainfo.ifi_flags & IFF_LOWER_UP))
                 {
 
-					data_fid = (ipacm_event_data_fid *)malloc(sizeof(ipacm_event_data_fid));
+					data_fid = (ipacm_event_data_fid *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_fid));
 					if(data_fid == NULL)
 					{
 						IPACMERR("unable to allocate memory for event data_fid\n");
@@ -746,6 +639,7 @@ static int ipa_nl_decode_nlmsg
 					if(ret_val != IPACM_SUCCESS)
 					{
 						IPACMERR("Error while getting interface name\n");
+						IPACM_EvtDispatcher::FreeEvtData(data_fid);
 						return IPACM_FAILURE;
 					}
 					IPACMDBG_H("Got a usb link_up event (Interface %s, %d) \n", dev_name, msg_ptr->nl_link_info.metainfo.ifi_index);
@@ -753,6 +647,7 @@ static int ipa_nl_decode_nlmsg
 					if (!strncmp(dev_name,"rmnet_data",strlen("rmnet_data")))
 					{
 						IPACMERR("Don't expect iff_flags change for rmnet_data interface. IGNORE\n");
+						IPACM_EvtDispatcher::FreeEvtData(data_fid);
 						return IPACM_FAILURE;
 					}
 
@@ -763,11 +658,11 @@ static int ipa_nl_decode_nlmsg
 					evt_data.evt_data = data_fid;
 					IPACMDBG_H("Posting usb IPA_USB_LINK_UP_EVENT with if index: %d\n",
 										 data_fid->if_index);
-					IPACM_EvtDispatcher::PostEvt(&evt_data);
+					ipa_nl_post_evt(&evt_data);
                 }
                 else if (!(msg_ptr->nl_link_info.metainfo.ifi_flags & IFF_LOWER_UP))
 				{
-					data_fid = (ipacm_event_data_fid *)malloc(sizeof(ipacm_event_data_fid));
+					data_fid = (ipacm_event_data_fid *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_fid));
 					if(data_fid == NULL)
 					{
 						IPACMERR("unable to allocate memory for event data_fid\n");
@@ -779,6 +674,7 @@ static int ipa_nl_decode_nlmsg
 					if(ret_val != IPACM_SUCCESS)
 					{
 						IPACMERR("Error while getting interface name\n");
+						IPACM_EvtDispatcher::FreeEvtData(data_fid);
 						return IPACM_FAILURE;
 					}
 					IPACMDBG_H("Got a usb link_down event (Interface %s) \n", dev_name);
@@ -790,7 +686,7 @@ static int ipa_nl_decode_nlmsg
 					evt_data.evt_data = data_fid;
 					IPACMDBG_H("Posting usb IPA_LINK_DOWN_EVENT with if index: %d\n",
 										 data_fid->if_index);
-					IPACM_EvtDispatcher::PostEvt(&evt_data);
+					ipa_nl_post_evt(&evt_data);
 				}
 #endif /* not defined(FEATURE_IPA_ANDROID)*/
 			}
@@ -801,7 +697,7 @@ static int ipa_nl_decode_nlmsg
 			msg_ptr->type = nlh->nlmsg_type;
 			msg_ptr->link_event = true;
 			IPACMDBG("entering rtm decode\n");
-			if(IPACM_SUCCESS != ipa_nl_decode_rtm_link(buffer, buflen, &(msg_ptr->nl_link_info)))
+			if(IPACM_SUCCESS != ipa_nl_decode_rtm_link((const char *)nlh, nlh->nlmsg_len, &(msg_ptr->nl_link_info)))
 			{
 				IPACMERR("Failed to decode rtm link message\n");
 				return IPACM_FAILURE;
@@ -833,7 +729,7 @@ static int ipa_nl_decode_nlmsg
 
 				/* post link down to command queue */
 				evt_data.event = IPA_LINK_DOWN_EVENT;
-				data_fid = (ipacm_event_data_fid *)malloc(sizeof(ipacm_event_data_fid));
+				data_fid = (ipacm_event_data_fid *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_fid));
 				if(data_fid == NULL)
 				{
 					IPACMERR("unable to allocate memory for event data_fid\n");
@@ -845,14 +741,14 @@ static int ipa_nl_decode_nlmsg
 				IPACMDBG_H("posting IPA_LINK_DOWN_EVENT with if idnex:%d\n",
 								 data_fid->if_index);
 				evt_data.evt_data = data_fid;
-				IPACM_EvtDispatcher::PostEvt(&evt_data);
+				ipa_nl_post_evt(&evt_data);
 				/* finish command queue */
 			}
 			break;
 
 		case RTM_NEWADDR:
 			IPACMDBG("\n GOT RTM_NEWADDR event\n");
-			if(IPACM_SUCCESS != ipa_nl_decode_rtm_addr(buffer, buflen, &(msg_ptr->nl_addr_info)))
+			if(IPACM_SUCCESS != ipa_nl_decode_rtm_addr((const char *)nlh, nlh->nlmsg_len, &(msg_ptr->nl_addr_info)))
 			{
 				IPACMERR("Failed to decode rtm addr message\n");
 				return IPACM_FAILURE;
@@ -866,7 +762,7 @@ static int ipa_nl_decode_nlmsg
 				}
 				IPACMDBG("Interface %s \n", dev_name);
 
-				data_addr = (ipacm_event_data_addr *)malloc(sizeof(ipacm_event_data_addr));
+				data_addr = (ipacm_event_data_addr *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_addr));
 				if(data_addr == NULL)
 				{
 					IPACMERR("unable to allocate memory for event data_addr\n");
@@ -911,13 +807,13 @@ static int ipa_nl_decode_nlmsg
 								 data_addr->ipv4_addr);
 				}
 				evt_data.evt_data = data_addr;
-				IPACM_EvtDispatcher::PostEvt(&evt_data);
+				ipa_nl_post_evt(&evt_data);
 			}
 			break;
 
 		case RTM_DELADDR:
 			IPACMDBG("\n GOT RTM_DELADDR event\n");
-			if(IPACM_SUCCESS != ipa_nl_decode_rtm_addr(buffer, buflen, &(msg_ptr->nl_addr_info)))
+			if(IPACM_SUCCESS != ipa_nl_decode_rtm_addr((const char *)nlh, nlh->nlmsg_len, &(msg_ptr->nl_addr_info)))
 			{
 				IPACMERR("Failed to decode rtm addr message\n");
 				return IPACM_FAILURE;
@@ -931,7 +827,7 @@ static int ipa_nl_decode_nlmsg
 				}
 				IPACMDBG("Interface %s \n", dev_name);
 
-				data_addr = (ipacm_event_data_addr *)malloc(sizeof(ipacm_event_data_addr));
+				data_addr = (ipacm_event_data_addr *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_addr));
 				if(data_addr == NULL)
 				{
 					IPACMERR("unable to allocate memory for event data_addr\n");
@@ -976,13 +872,13 @@ static int ipa_nl_decode_nlmsg
 								 data_addr->ipv4_addr);
 				}
 				evt_data.evt_data = data_addr;
-				IPACM_EvtDispatcher::PostEvt(&evt_data);
+				ipa_nl_post_evt(&evt_data);
 			}
 			break;
 
 		case RTM_NEWROUTE:
 
-			if(IPACM_SUCCESS != ipa_nl_decode_rtm_route(buffer, buflen, &(msg_ptr->nl_route_info)))
+			if(IPACM_SUCCESS != ipa_nl_decode_rtm_route((const char *)nlh, nlh->nlmsg_len, &(msg_ptr->nl_route_info)))
 			{
 				IPACMERR("Failed to decode rtm route message\n");
 				return IPACM_FAILURE;
@@ -1022,7 +918,7 @@ static int ipa_nl_decode_nlmsg
 					temp = (-1);
 
 					evt_data.event = IPA_ROUTE_ADD_EVENT;
-					data_addr = (ipacm_event_data_addr *)malloc(sizeof(ipacm_event_data_addr));
+					data_addr = (ipacm_event_data_addr *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_addr));
 					if(data_addr == NULL)
 					{
 						IPACMERR("unable to allocate memory for event data_addr\n");
@@ -1039,7 +935,7 @@ static int ipa_nl_decode_nlmsg
 									 data_addr->ipv4_addr,
 									 data_addr->ipv4_addr_mask);
 					evt_data.evt_data = data_addr;
-					IPACM_EvtDispatcher::PostEvt(&evt_data);
+					ipa_nl_post_evt(&evt_data);
 					/* finish command queue */
 
 				}
@@ -1055,7 +951,7 @@ static int ipa_nl_decode_nlmsg
 					if(AF_INET6 == msg_ptr->nl_route_info.metainfo.rtm_family)
 					{
 						/* insert to command queue */
-						data_addr = (ipacm_event_data_addr *)malloc(sizeof(ipacm_event_data_addr));
+						data_addr = (ipacm_event_data_addr *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_addr));
 						if(data_addr == NULL)
 						{
 							IPACMERR("unable to allocate memory for event data_addr\n");
@@ -1099,7 +995,7 @@ static int ipa_nl_decode_nlmsg
 						IPACMDBG("Posting IPA_ROUTE_ADD_EVENT with if index:%d, ipv6 address\n",
 										 data_addr->if_index);
 						evt_data.evt_data = data_addr;
-						IPACM_EvtDispatcher::PostEvt(&evt_data);
+						ipa_nl_post_evt(&evt_data);
 						/* finish command queue */
 
 					}
@@ -1110,7 +1006,7 @@ static int ipa_nl_decode_nlmsg
 						IPACM_NL_REPORT_ADDR( "dstIP:", msg_ptr->nl_route_info.attr_info.dst_addr );
 
 						/* insert to command queue */
-						data_addr = (ipacm_event_data_addr *)malloc(sizeof(ipacm_event_data_addr));
+						data_addr = (ipacm_event_data_addr *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_addr));
 						if(data_addr == NULL)
 						{
 							IPACMERR("unable to allocate memory for event data_addr\n");
@@ -1134,7 +1030,7 @@ static int ipa_nl_decode_nlmsg
 										 data_addr->ipv4_addr_mask,
 										 data_addr->ipv4_addr_gw);
 						evt_data.evt_data = data_addr;
-						IPACM_EvtDispatcher::PostEvt(&evt_data);
+						ipa_nl_post_evt(&evt_data);
 						/* finish command queue */
 					}
 				}
@@ -1163,7 +1059,7 @@ static int ipa_nl_decode_nlmsg
 									 dev_name);
 
 					/* insert to command queue */
-					data_addr = (ipacm_event_data_addr *)malloc(sizeof(ipacm_event_data_addr));
+					data_addr = (ipacm_event_data_addr *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_addr));
 					if(data_addr == NULL)
 					{
 						IPACMERR("unable to allocate memory for event data_addr\n");
@@ -1211,7 +1107,7 @@ static int ipa_nl_decode_nlmsg
 					IPACMDBG("Posting IPA_ROUTE_ADD_EVENT with if index:%d, ipv6 addr\n",
 									 data_addr->if_index);
 					evt_data.evt_data = data_addr;
-					IPACM_EvtDispatcher::PostEvt(&evt_data);
+					ipa_nl_post_evt(&evt_data);
 					/* finish command queue */
 				}
 				if(msg_ptr->nl_route_info.attr_info.param_mask & IPA_RTA_PARAM_GATEWAY)
@@ -1222,7 +1118,7 @@ static int ipa_nl_decode_nlmsg
 									 dev_name);
 
 					/* insert to command queue */
-					data_addr = (ipacm_event_data_addr *)malloc(sizeof(ipacm_event_data_addr));
+					data_addr = (ipacm_event_data_addr *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_addr));
 					if(data_addr == NULL)
 					{
 						IPACMERR("unable to allocate memory for event data_addr\n");
@@ -1250,14 +1146,14 @@ static int ipa_nl_decode_nlmsg
 					IPACMDBG("posting IPA_ROUTE_ADD_EVENT with if index:%d, ipv6 address\n",
 									 data_addr->if_index);
 					evt_data.evt_data = data_addr;
-					IPACM_EvtDispatcher::PostEvt(&evt_data);
+					ipa_nl_post_evt(&evt_data);
 					/* finish command queue */
 				}
 			}
 			break;
 
 		case RTM_DELROUTE:
-			if(IPACM_SUCCESS != ipa_nl_decode_rtm_route(buffer, buflen, &(msg_ptr->nl_route_info)))
+			if(IPACM_SUCCESS != ipa_nl_decode_rtm_route((const char *)nlh, nlh->nlmsg_len, &(msg_ptr->nl_route_info)))
 			{
 				IPACMERR("Failed to decode rtm route message\n");
 				return IPACM_FAILURE;
@@ -1283,7 +1179,7 @@ static int ipa_nl_decode_nlmsg
 					IPACMDBG("dev %s\n", dev_name);
 
 					/* insert to command queue */
-					data_addr = (ipacm_event_data_addr *)malloc(sizeof(ipacm_event_data_addr));
+					data_addr = (ipacm_event_data_addr *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_addr));
 					if(data_addr == NULL)
 					{
 						IPACMERR("unable to allocate memory for event data_addr\n");
@@ -1304,7 +1200,7 @@ static int ipa_nl_decode_nlmsg
 									 data_addr->ipv4_addr,
 									 data_addr->ipv4_addr_mask);
 					evt_data.evt_data = data_addr;
-					IPACM_EvtDispatcher::PostEvt(&evt_data);
+					ipa_nl_post_evt(&evt_data);
 					/* finish command queue */
 				}
 				else
@@ -1317,7 +1213,7 @@ static int ipa_nl_decode_nlmsg
 					}
 
 					/* insert to command queue */
-					data_addr = (ipacm_event_data_addr *)malloc(sizeof(ipacm_event_data_addr));
+					data_addr = (ipacm_event_data_addr *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_addr));
 					if(data_addr == NULL)
 					{
 						IPACMERR("unable to allocate memory for event data_addr\n");
@@ -1376,7 +1272,7 @@ static int ipa_nl_decode_nlmsg
 					IPACMDBG_H("Posting IPA_ROUTE_DEL_EVENT with if index:%d\n",
 									 data_addr->if_index);
 					evt_data.evt_data = data_addr;
-					IPACM_EvtDispatcher::PostEvt(&evt_data);
+					ipa_nl_post_evt(&evt_data);
 					/* finish command queue */
 				}
 			}
@@ -1404,7 +1300,7 @@ static int ipa_nl_decode_nlmsg
 									 dev_name);
 
 					/* insert to command queue */
-					data_addr = (ipacm_event_data_addr *)malloc(sizeof(ipacm_event_data_addr));
+					data_addr = (ipacm_event_data_addr *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_addr));
 					if(data_addr == NULL)
 					{
 						IPACMERR("unable to allocate memory for event data_addr\n");
@@ -1463,14 +1359,14 @@ static int ipa_nl_decode_nlmsg
 					IPACMDBG_H("posting event IPA_ROUTE_DEL_EVENT with if index:%d, ipv4 address\n",
 									 data_addr->if_index);
 					evt_data.evt_data = data_addr;
-					IPACM_EvtDispatcher::PostEvt(&evt_data);
+					ipa_nl_post_evt(&evt_data);
 					/* finish command queue */
 				}
 			}
 			break;
 
 		case RTM_NEWNEIGH:
-			if(IPACM_SUCCESS != ipa_nl_decode_rtm_neigh(buffer, buflen, &(msg_ptr->nl_neigh_info)))
+			if(IPACM_SUCCESS != ipa_nl_decode_rtm_neigh((const char *)nlh, nlh->nlmsg_len, &(msg_ptr->nl_neigh_info)))
 			{
 				IPACMERR("Failed to decode rtm neighbor message\n");
 				return IPACM_FAILURE;
@@ -1488,7 +1384,7 @@ static int ipa_nl_decode_nlmsg
 			}
 
 			/* insert to command queue */
-		    data_all = (ipacm_event_data_all *)malloc(sizeof(ipacm_event_data_all));
+		    data_all = (ipacm_event_data_all *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_all));
 		    if(data_all == NULL)
 			{
 		    	IPACMERR("unable to allocate memory for event data_all\n");
@@ -1553,12 +1449,12 @@ static int ipa_nl_decode_nlmsg
 		    				 msg_ptr->nl_neigh_info.attr_info.local_addr.ss_family);
 			}
 		    evt_data.evt_data = data_all;
-					IPACM_EvtDispatcher::PostEvt(&evt_data);
+					ipa_nl_post_evt(&evt_data);
 					/* finish command queue */
 			break;
 
 		case RTM_DELNEIGH:
-			if(IPACM_SUCCESS != ipa_nl_decode_rtm_neigh(buffer, buflen, &(msg_ptr->nl_neigh_info)))
+			if(IPACM_SUCCESS != ipa_nl_decode_rtm_neigh((const char *)nlh, nlh->nlmsg_len, &(msg_ptr->nl_neigh_info)))
 			{
 				IPACMERR("Failed to decode rtm neighbor message\n");
 				return IPACM_FAILURE;
@@ -1576,7 +1472,7 @@ static int ipa_nl_decode_nlmsg
 			}
 
 				/* insert to command queue */
-				data_all = (ipacm_event_data_all *)malloc(sizeof(ipacm_event_data_all));
+				data_all = (ipacm_event_data_all *)IPACM_EvtDispatcher::AllocEvtData(sizeof(ipacm_event_data_all));
 				if(data_all == NULL)
 				{
 					IPACMERR("unable to allocate memory for event data_all\n");
@@ -1626,7 +1522,7 @@ static int ipa_nl_decode_nlmsg
  		                    data_all->if_index,
 		    				 msg_ptr->nl_neigh_info.attr_info.local_addr.ss_family);
 				evt_data.evt_data = data_all;
-				IPACM_EvtDispatcher::PostEvt(&evt_data);
+				ipa_nl_post_evt(&evt_data);
 				/* finish command queue */
 			break;
 
@@ -1645,63 +1541,45 @@ static int ipa_nl_decode_nlmsg
 /*  Virtual function registered to receive incoming messages over the NETLINK routing socket*/
 int ipa_nl_recv_msg(int fd)
 {
-	struct msghdr *msghdr = NULL;
-	struct iovec *iov = NULL;
-	unsigned int msglen = 0;
-	ipa_nl_msg_t *nlmsg = NULL;
+	struct msghdr *msgh;
+	int i, num_msgs = 0, ret = IPACM_SUCCESS;
 
-	nlmsg = (ipa_nl_msg_t *)malloc(sizeof(ipa_nl_msg_t));
-	if(NULL == nlmsg)
+	if(IPACM_SUCCESS != ipa_nl_recv(fd, &num_msgs))
 	{
-		IPACMERR("Failed alloc of nlmsg \n");
-		goto error;
+		IPACMERR("Failed to receive nl message \n");
+		return IPACM_FAILURE;
 	}
-	else
+
+	for(i = 0; i < num_msgs; i++)
 	{
-		if(IPACM_SUCCESS != ipa_nl_recv(fd, &msghdr, &msglen))
+		msgh = &nl_arena.msgs[i].msg_hdr;
+
+		/* Verify that NL address length in the received message is expected value */
+		if(sizeof(struct sockaddr_nl) != msgh->msg_namelen)
 		{
-			IPACMERR("Failed to receive nl message \n");
-			goto error;
+			IPACMERR("rcvd msg with namelen != sizeof sockaddr_nl\n");
+			ret = IPACM_FAILURE;
+			continue;
 		}
 
-		if(msghdr== NULL)
+		/* Verify that message was not truncated. This should not occur */
+		if(msgh->msg_flags & MSG_TRUNC)
 		{
-			IPACMERR(" failed to get msghdr\n");
-			goto error;
+			IPACMERR("Rcvd msg truncated!\n");
+			ret = IPACM_FAILURE;
+			continue;
 		}
 
-		iov = msghdr->msg_iov;
-
-		memset(nlmsg, 0, sizeof(ipa_nl_msg_t));
-		if(IPACM_SUCCESS != ipa_nl_decode_nlmsg((char *)iov->iov_base, msglen, nlmsg))
+		memset(&nl_arena.nlmsg, 0, sizeof(nl_arena.nlmsg));
+		if(IPACM_SUCCESS != ipa_nl_decode_nlmsg((char *)nl_arena.buf[i], nl_arena.msgs[i].msg_len,
+			&nl_arena.nlmsg))
 		{
 			IPACMERR("Failed to decode nl message \n");
-			goto error;
-		}
-		/* Release NetLink message buffer */
-		if(msghdr)
-		{
-			ipa_nl_release_msg(msghdr);
-		}
-		if(nlmsg)
-		{
-			free(nlmsg);
+			ret = IPACM_FAILURE;
 		}
 	}
 
-	return IPACM_SUCCESS;
-
-error:
-	if(msghdr)
-	{
-		ipa_nl_release_msg(msghdr);
-	}
-	if(nlmsg)
-	{
-		free(nlmsg);
-	}
-
-	return IPACM_FAILURE;
+	return ret;
 }
 
 /*  get ipa interface name */
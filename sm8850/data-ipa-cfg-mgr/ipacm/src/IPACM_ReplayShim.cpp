@@ -0,0 +1,1578 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*!
+	@file
+	IPACM_ReplayShim.cpp
+
+	@brief
+	Preloaded shim recording the events ipacm receives on a device and replaying
+	them against a stand-in IPA device on a Linux host, see IPACM_Replay.h
+*/
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/netfilter/nfnetlink.h>
+#include <linux/netfilter/nfnetlink_conntrack.h>
+#include <linux/msm_ipa.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include "IPACM_Replay.h"
+
+#define REPLAY_MAX_FD 4096
+#define REPLAY_POLL_US 1000
+#define REPLAY_DEFAULT_IDLE_MS 20
+#define REPLAY_DEFAULT_WAIT_MS 5000
+
+typedef enum
+{
+	REPLAY_OFF,
+	REPLAY_RECORD,
+	REPLAY_PLAY
+} replay_mode;
+
+typedef enum
+{
+	FD_NONE,
+	FD_IPA_DEV,
+	FD_NL_ROUTE,
+	FD_NL_CT
+} replay_fd_kind;
+
+typedef struct
+{
+	uint8_t kind;
+	uint8_t event;
+	uint32_t ordinal;
+	uint32_t groups;
+	int peer;
+} replay_fd;
+
+/* where the arguments of an ioctl live, to copy them in and out of the trace */
+typedef struct
+{
+	bool known;
+	bool by_value;
+	size_t fixed_len;
+	/* v2 rule tables keep their rules behind a pointer */
+	void *ext;
+	size_t ext_len;
+	size_t ptr_off;
+} ioctl_layout;
+
+typedef struct
+{
+	std::vector<uint32_t> idx;
+	size_t next;
+} reply_list;
+
+typedef struct
+{
+	const ipacm_replay_rec *rec;
+	uint64_t inject_ns;
+	uint64_t last_ns;
+	uint32_t ioctls;
+	bool skipped;
+} replay_event;
+
+static int (*real_open)(const char *, int, ...);
+static int (*real_open64)(const char *, int, ...);
+static int (*real_close)(int);
+static ssize_t (*real_read)(int, void *, size_t);
+static int (*real_ioctl)(int, unsigned long, ...);
+static void *(*real_mmap)(void *, size_t, int, int, int, off_t);
+static int (*real_socket)(int, int, int);
+static int (*real_bind)(int, const struct sockaddr *, socklen_t);
+static int (*real_getsockname)(int, struct sockaddr *, socklen_t *);
+static int (*real_setsockopt)(int, int, int, const void *, socklen_t);
+static ssize_t (*real_send)(int, const void *, size_t, int);
+static ssize_t (*real_sendto)(int, const void *, size_t, int, const struct sockaddr *, socklen_t);
+static ssize_t (*real_sendmsg)(int, const struct msghdr *, int);
+static ssize_t (*real_recv)(int, void *, size_t, int);
+static ssize_t (*real_recvfrom)(int, void *, size_t, int, struct sockaddr *, socklen_t *);
+static ssize_t (*real_recvmsg)(int, struct msghdr *, int);
+static int (*real_recvmmsg)(int, struct mmsghdr *, unsigned int, int, struct timespec *);
+
+static pthread_once_t replay_once = PTHREAD_ONCE_INIT;
+static replay_mode mode = REPLAY_OFF;
+
+static pthread_mutex_t fd_lock = PTHREAD_MUTEX_INITIALIZER;
+static replay_fd fds[REPLAY_MAX_FD];
+static uint32_t num_event_socks[FD_NL_CT + 1];
+static int driver_fd = -1;
+
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static FILE *trace_file = NULL;
+static FILE *rules_file = NULL;
+
+/* replay state, allocated on first use since calls can come before static constructors ran */
+typedef struct
+{
+	std::vector<const ipacm_replay_rec *> replies;
+	std::vector<bool> consumed;
+	std::map<uint64_t, reply_list> reply_by_key;
+	std::map<uint32_t, reply_list> reply_by_req;
+	std::vector<replay_event> events;
+	std::map<uint32_t, uint64_t> emitted;
+} replay_tables;
+
+static char *trace_buf = NULL;
+static replay_tables *tables = NULL;
+static uint64_t last_ioctl_ns = 0;
+static uint32_t cur_event = 0;
+static bool flood = false;
+static uint64_t idle_ns = 0;
+static uint64_t wait_ns = 0;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t env_ms(const char *name, uint64_t def)
+{
+	const char *val = getenv(name);
+
+	return (val != NULL && *val != '\0') ? strtoull(val, NULL, 0) : def;
+}
+
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t len)
+{
+	const uint8_t *byte = (const uint8_t *)data;
+	size_t cnt;
+
+	for(cnt = 0; cnt < len; cnt++)
+	{
+		hash ^= byte[cnt];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+/* ---------------------------------------------------------------- fd table */
+
+static replay_fd *fd_entry(int fd)
+{
+	return (fd >= 0 && fd < REPLAY_MAX_FD) ? &fds[fd] : NULL;
+}
+
+static uint8_t fd_kind(int fd)
+{
+	replay_fd *entry = fd_entry(fd);
+	uint8_t kind;
+
+	if(entry == NULL)
+	{
+		return FD_NONE;
+	}
+	pthread_mutex_lock(&fd_lock);
+	kind = entry->kind;
+	pthread_mutex_unlock(&fd_lock);
+	return kind;
+}
+
+static void fd_track(int fd, uint8_t kind, int peer)
+{
+	replay_fd *entry = fd_entry(fd);
+
+	if(entry == NULL)
+	{
+		if(peer >= 0)
+		{
+			real_close(peer);
+		}
+		return;
+	}
+	pthread_mutex_lock(&fd_lock);
+	memset(entry, 0, sizeof(*entry));
+	entry->kind = kind;
+	entry->peer = peer;
+	pthread_mutex_unlock(&fd_lock);
+}
+
+/* a netlink socket subscribed to multicast groups receives the events */
+static void fd_mark_event(int fd, uint32_t groups)
+{
+	replay_fd *entry = fd_entry(fd);
+
+	if(entry == NULL)
+	{
+		return;
+	}
+	pthread_mutex_lock(&fd_lock);
+	entry->groups |= groups;
+	if(!entry->event && (entry->kind == FD_NL_ROUTE || entry->kind == FD_NL_CT))
+	{
+		entry->event = 1;
+		entry->ordinal = num_event_socks[entry->kind]++;
+	}
+	pthread_mutex_unlock(&fd_lock);
+}
+
+static bool is_ipa_device(const char *path)
+{
+	return path != NULL && (strncmp(path, "/dev/ipa", strlen("/dev/ipa")) == 0 ||
+		strcmp(path, "/dev/wwan_ioctl") == 0 || strcmp(path, "/dev/odu_ipa_bridge") == 0);
+}
+
+static bool is_ifreq_query(unsigned long request)
+{
+	switch(request)
+	{
+		case SIOCGIFNAME:
+		case SIOCGIFINDEX:
+		case SIOCGIFFLAGS:
+		case SIOCGIFADDR:
+		case SIOCGIFNETMASK:
+		case SIOCGIFMTU:
+		case SIOCGIFHWADDR:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/* ------------------------------------------------------------------- trace */
+
+static void trace_write(FILE *file, uint32_t type, uint32_t request, int32_t ret, uint32_t sock,
+	const void *in, uint32_t in_len, const void *out, uint32_t out_len)
+{
+	ipacm_replay_rec rec;
+
+	if(file == NULL)
+	{
+		return;
+	}
+	memset(&rec, 0, sizeof(rec));
+	rec.type = type;
+	rec.len = in_len + out_len;
+	rec.ts_ns = now_ns();
+	rec.request = request;
+	rec.in_len = in_len;
+	rec.ret = ret;
+	rec.sock = sock;
+
+	pthread_mutex_lock(&trace_lock);
+	fwrite(&rec, sizeof(rec), 1, file);
+	if(in_len > 0)
+	{
+		fwrite(in, in_len, 1, file);
+	}
+	if(out_len > 0)
+	{
+		fwrite(out, out_len, 1, file);
+	}
+	/* a recording ends when ipacm is killed, keep what was seen so far */
+	if(file == trace_file)
+	{
+		fflush(file);
+	}
+	pthread_mutex_unlock(&trace_lock);
+}
+
+static FILE *trace_create(const char *path)
+{
+	ipacm_replay_file_hdr hdr;
+	FILE *file;
+
+	file = fopen(path, "w");
+	if(file == NULL)
+	{
+		fprintf(stderr, "ipacm replay: unable to create %s: %s\n", path, strerror(errno));
+		return NULL;
+	}
+	hdr.magic = IPACM_REPLAY_MAGIC;
+	hdr.version = IPACM_REPLAY_VERSION;
+	fwrite(&hdr, sizeof(hdr), 1, file);
+	return file;
+}
+
+/* record a datagram received on a netlink event socket */
+static void trace_netlink(int fd, const struct iovec *iov, size_t iovlen, ssize_t len)
+{
+	replay_fd *entry = fd_entry(fd);
+	std::vector<uint8_t> buf;
+	uint32_t type, ordinal;
+	size_t cnt, chunk;
+
+	if(entry == NULL || len <= 0)
+	{
+		return;
+	}
+	pthread_mutex_lock(&fd_lock);
+	if(!entry->event)
+	{
+		pthread_mutex_unlock(&fd_lock);
+		return;
+	}
+	type = (entry->kind == FD_NL_CT) ? REPLAY_REC_NL_CT : REPLAY_REC_NL_ROUTE;
+	ordinal = entry->ordinal;
+	pthread_mutex_unlock(&fd_lock);
+
+	for(cnt = 0; cnt < iovlen && buf.size() < (size_t)len; cnt++)
+	{
+		chunk = std::min(iov[cnt].iov_len, (size_t)len - buf.size());
+		buf.insert(buf.end(), (uint8_t *)iov[cnt].iov_base, (uint8_t *)iov[cnt].iov_base + chunk);
+	}
+	trace_write(trace_file, type, 0, 0, ordinal, buf.data(), buf.size(), NULL, 0);
+}
+
+/* ------------------------------------------------------------------ ioctls */
+
+#define LAYOUT_FIXED(req, type) \
+	case req: \
+		lay->fixed_len = sizeof(type); \
+		break;
+#define LAYOUT_ARRAY(req, type, num, array) \
+	case req: \
+		lay->fixed_len = sizeof(type) + ((type *)arg)->num * sizeof(((type *)arg)->array[0]); \
+		break;
+#define LAYOUT_V2(req, type, size) \
+	case req: \
+		lay->fixed_len = sizeof(type); \
+		lay->ext = (void *)(uintptr_t)((type *)arg)->rules; \
+		lay->ext_len = (size_t)((type *)arg)->num_rules * ((type *)arg)->size; \
+		lay->ptr_off = offsetof(type, rules); \
+		break;
+#define LAYOUT_VALUE(req) \
+	case req: \
+		lay->by_value = true; \
+		break;
+
+static void ioctl_get_layout(unsigned long request, void *arg, ioctl_layout *lay)
+{
+	memset(lay, 0, sizeof(*lay));
+	lay->known = true;
+
+	if(is_ifreq_query(request))
+	{
+		lay->fixed_len = sizeof(struct ifreq);
+		return;
+	}
+
+	switch(request)
+	{
+		LAYOUT_VALUE(IPA_IOC_COMMIT_HDR)
+		LAYOUT_VALUE(IPA_IOC_COMMIT_RT)
+		LAYOUT_VALUE(IPA_IOC_COMMIT_FLT)
+		LAYOUT_VALUE(IPA_IOC_RESET_HDR)
+		LAYOUT_VALUE(IPA_IOC_RESET_RT)
+		LAYOUT_VALUE(IPA_IOC_RESET_FLT)
+		LAYOUT_VALUE(IPA_IOC_PUT_RT_TBL)
+		LAYOUT_VALUE(IPA_IOC_QUERY_EP_MAPPING)
+		LAYOUT_VALUE(IPA_IOC_QUERY_WLAN_CLIENT)
+#ifdef IPA_IOC_CLEANUP
+		LAYOUT_VALUE(IPA_IOC_CLEANUP)
+#endif
+#ifdef IPA_IOC_APP_CLOCK_VOTE
+		LAYOUT_VALUE(IPA_IOC_APP_CLOCK_VOTE)
+#endif
+		LAYOUT_FIXED(IPA_IOC_GENERATE_FLT_EQ, struct ipa_ioc_generate_flt_eq)
+		LAYOUT_FIXED(IPA_IOC_QUERY_RT_TBL_INDEX, struct ipa_ioc_get_rt_tbl_indx)
+		LAYOUT_FIXED(IPA_IOC_QUERY_INTF, struct ipa_ioc_query_intf)
+		LAYOUT_FIXED(IPA_IOC_GET_HDR, struct ipa_ioc_get_hdr)
+		LAYOUT_FIXED(IPA_IOC_COPY_HDR, struct ipa_ioc_copy_hdr)
+		LAYOUT_FIXED(IPA_IOC_GET_RT_TBL, struct ipa_ioc_get_rt_tbl)
+		LAYOUT_FIXED(IPA_IOC_GET_HW_VERSION, enum ipa_hw_type)
+		LAYOUT_FIXED(IPA_IOC_RM_ADD_DEPENDENCY, struct ipa_ioc_rm_dependency)
+		LAYOUT_FIXED(IPA_IOC_RM_DEL_DEPENDENCY, struct ipa_ioc_rm_dependency)
+		LAYOUT_FIXED(IPA_IOC_WRITE_QMAPID, struct ipa_ioc_write_qmapid)
+		LAYOUT_FIXED(IPA_IOC_ALLOC_NAT_MEM, struct ipa_ioc_nat_alloc_mem)
+		LAYOUT_FIXED(IPA_IOC_V4_INIT_NAT, struct ipa_ioc_v4_nat_init)
+		LAYOUT_ARRAY(IPA_IOC_NAT_DMA, struct ipa_ioc_nat_dma_cmd, entries, dma)
+#ifdef IPA_IOCTL_SET_FNR_COUNTER_INFO
+		LAYOUT_FIXED(IPA_IOC_FNR_COUNTER_ALLOC, struct ipa_ioc_flt_rt_counter_alloc)
+		LAYOUT_FIXED(IPA_IOC_SET_FNR_COUNTER_INFO, struct ipa_ioc_fnr_index_info)
+#endif
+		LAYOUT_ARRAY(IPA_IOC_ADD_HDR, struct ipa_ioc_add_hdr, num_hdrs, hdr)
+		LAYOUT_ARRAY(IPA_IOC_DEL_HDR, struct ipa_ioc_del_hdr, num_hdls, hdl)
+		LAYOUT_ARRAY(IPA_IOC_ADD_HDR_PROC_CTX, struct ipa_ioc_add_hdr_proc_ctx, num_proc_ctxs, proc_ctx)
+		LAYOUT_ARRAY(IPA_IOC_DEL_HDR_PROC_CTX, struct ipa_ioc_del_hdr_proc_ctx, num_hdls, hdl)
+		LAYOUT_ARRAY(IPA_IOC_ADD_RT_RULE, struct ipa_ioc_add_rt_rule, num_rules, rules)
+		LAYOUT_ARRAY(IPA_IOC_DEL_RT_RULE, struct ipa_ioc_del_rt_rule, num_hdls, hdl)
+		LAYOUT_ARRAY(IPA_IOC_MDFY_RT_RULE, struct ipa_ioc_mdfy_rt_rule, num_rules, rules)
+		LAYOUT_ARRAY(IPA_IOC_ADD_FLT_RULE, struct ipa_ioc_add_flt_rule, num_rules, rules)
+		LAYOUT_ARRAY(IPA_IOC_ADD_FLT_RULE_AFTER, struct ipa_ioc_add_flt_rule_after, num_rules, rules)
+		LAYOUT_ARRAY(IPA_IOC_DEL_FLT_RULE, struct ipa_ioc_del_flt_rule, num_hdls, hdl)
+		LAYOUT_ARRAY(IPA_IOC_MDFY_FLT_RULE, struct ipa_ioc_mdfy_flt_rule, num_rules, rules)
+		LAYOUT_ARRAY(IPA_IOC_QUERY_INTF_TX_PROPS, struct ipa_ioc_query_intf_tx_props, num_tx_props, tx)
+		LAYOUT_ARRAY(IPA_IOC_QUERY_INTF_RX_PROPS, struct ipa_ioc_query_intf_rx_props, num_rx_props, rx)
+		LAYOUT_ARRAY(IPA_IOC_QUERY_INTF_EXT_PROPS, struct ipa_ioc_query_intf_ext_props, num_ext_props, ext)
+#ifdef IPA_IOC_ADD_RT_RULE_V2
+		LAYOUT_V2(IPA_IOC_ADD_RT_RULE_V2, struct ipa_ioc_add_rt_rule_v2, rule_add_size)
+		LAYOUT_V2(IPA_IOC_ADD_FLT_RULE_V2, struct ipa_ioc_add_flt_rule_v2, flt_rule_size)
+		LAYOUT_V2(IPA_IOC_ADD_FLT_RULE_AFTER_V2, struct ipa_ioc_add_flt_rule_after_v2, flt_rule_size)
+#endif
+		default:
+			/* only the result is recorded and replayed */
+			lay->known = false;
+			break;
+	}
+}
+
+#define IOCTL_NAME(req) \
+	case req: \
+		return #req;
+
+static const char *ioctl_name(uint32_t request)
+{
+	switch(request)
+	{
+		IOCTL_NAME(IPA_IOC_ADD_HDR)
+		IOCTL_NAME(IPA_IOC_DEL_HDR)
+		IOCTL_NAME(IPA_IOC_ADD_HDR_PROC_CTX)
+		IOCTL_NAME(IPA_IOC_DEL_HDR_PROC_CTX)
+		IOCTL_NAME(IPA_IOC_COMMIT_HDR)
+		IOCTL_NAME(IPA_IOC_RESET_HDR)
+		IOCTL_NAME(IPA_IOC_GET_HDR)
+		IOCTL_NAME(IPA_IOC_COPY_HDR)
+		IOCTL_NAME(IPA_IOC_ADD_RT_RULE)
+		IOCTL_NAME(IPA_IOC_DEL_RT_RULE)
+		IOCTL_NAME(IPA_IOC_MDFY_RT_RULE)
+		IOCTL_NAME(IPA_IOC_COMMIT_RT)
+		IOCTL_NAME(IPA_IOC_RESET_RT)
+		IOCTL_NAME(IPA_IOC_GET_RT_TBL)
+		IOCTL_NAME(IPA_IOC_PUT_RT_TBL)
+		IOCTL_NAME(IPA_IOC_QUERY_RT_TBL_INDEX)
+		IOCTL_NAME(IPA_IOC_ADD_FLT_RULE)
+		IOCTL_NAME(IPA_IOC_ADD_FLT_RULE_AFTER)
+		IOCTL_NAME(IPA_IOC_DEL_FLT_RULE)
+		IOCTL_NAME(IPA_IOC_MDFY_FLT_RULE)
+		IOCTL_NAME(IPA_IOC_COMMIT_FLT)
+		IOCTL_NAME(IPA_IOC_RESET_FLT)
+		IOCTL_NAME(IPA_IOC_GENERATE_FLT_EQ)
+		IOCTL_NAME(IPA_IOC_QUERY_INTF)
+		IOCTL_NAME(IPA_IOC_QUERY_INTF_TX_PROPS)
+		IOCTL_NAME(IPA_IOC_QUERY_INTF_RX_PROPS)
+		IOCTL_NAME(IPA_IOC_QUERY_INTF_EXT_PROPS)
+		IOCTL_NAME(IPA_IOC_QUERY_EP_MAPPING)
+		IOCTL_NAME(IPA_IOC_QUERY_WLAN_CLIENT)
+		IOCTL_NAME(IPA_IOC_GET_HW_VERSION)
+		IOCTL_NAME(IPA_IOC_RM_ADD_DEPENDENCY)
+		IOCTL_NAME(IPA_IOC_RM_DEL_DEPENDENCY)
+		IOCTL_NAME(IPA_IOC_WRITE_QMAPID)
+		IOCTL_NAME(IPA_IOC_ALLOC_NAT_MEM)
+		IOCTL_NAME(IPA_IOC_V4_INIT_NAT)
+		IOCTL_NAME(IPA_IOC_NAT_DMA)
+#ifdef IPA_IOC_CLEANUP
+		IOCTL_NAME(IPA_IOC_CLEANUP)
+#endif
+#ifdef IPA_IOC_APP_CLOCK_VOTE
+		IOCTL_NAME(IPA_IOC_APP_CLOCK_VOTE)
+#endif
+#ifdef IPA_IOCTL_SET_FNR_COUNTER_INFO
+		IOCTL_NAME(IPA_IOC_FNR_COUNTER_ALLOC)
+		IOCTL_NAME(IPA_IOC_SET_FNR_COUNTER_INFO)
+#endif
+#ifdef IPA_IOC_ADD_RT_RULE_V2
+		IOCTL_NAME(IPA_IOC_ADD_RT_RULE_V2)
+		IOCTL_NAME(IPA_IOC_ADD_FLT_RULE_V2)
+		IOCTL_NAME(IPA_IOC_ADD_FLT_RULE_AFTER_V2)
+#endif
+		default:
+			return NULL;
+	}
+}
+
+/* copies the arguments into one buffer, with the v2 rules pointer cleared */
+static void ioctl_flatten(const ioctl_layout *lay, void *arg, std::vector<uint8_t> &buf)
+{
+	uint64_t value;
+
+	buf.clear();
+	if(!lay->known)
+	{
+		return;
+	}
+	if(lay->by_value)
+	{
+		value = (uint64_t)(uintptr_t)arg;
+		buf.insert(buf.end(), (uint8_t *)&value, (uint8_t *)&value + sizeof(value));
+		return;
+	}
+	if(arg == NULL)
+	{
+		return;
+	}
+	buf.insert(buf.end(), (uint8_t *)arg, (uint8_t *)arg + lay->fixed_len);
+	if(lay->ext != NULL)
+	{
+		memset(&buf[lay->ptr_off], 0, sizeof(uint64_t));
+		buf.insert(buf.end(), (uint8_t *)lay->ext, (uint8_t *)lay->ext + lay->ext_len);
+	}
+}
+
+/* writes a recorded output back, keeping the caller's rules pointer */
+static void ioctl_unflatten(const ioctl_layout *lay, void *arg, const uint8_t *out, size_t out_len)
+{
+	uint64_t ptr;
+
+	if(!lay->known || lay->by_value || arg == NULL || out_len != lay->fixed_len + lay->ext_len)
+	{
+		return;
+	}
+	if(lay->ext != NULL)
+	{
+		memcpy(&ptr, (uint8_t *)arg + lay->ptr_off, sizeof(ptr));
+		memcpy(arg, out, lay->fixed_len);
+		memcpy((uint8_t *)arg + lay->ptr_off, &ptr, sizeof(ptr));
+		memcpy(lay->ext, out + lay->fixed_len, lay->ext_len);
+	}
+	else
+	{
+		memcpy(arg, out, lay->fixed_len);
+	}
+}
+
+static int record_ioctl(int fd, unsigned long request, void *arg)
+{
+	ioctl_layout lay;
+	std::vector<uint8_t> in, out;
+	int ret, err;
+
+	ioctl_get_layout(request, arg, &lay);
+	ioctl_flatten(&lay, arg, in);
+	ret = real_ioctl(fd, request, arg);
+	err = errno;
+	if(!lay.by_value)
+	{
+		ioctl_flatten(&lay, arg, out);
+	}
+	trace_write(trace_file, REPLAY_REC_IOCTL, (uint32_t)request, ret, (ret < 0) ? err : 0,
+		in.data(), in.size(), out.data(), out.size());
+	errno = err;
+	return ret;
+}
+
+static const ipacm_replay_rec *reply_take(reply_list *list, bool reuse_last)
+{
+	while(list->next < list->idx.size() && tables->consumed[list->idx[list->next]])
+	{
+		list->next++;
+	}
+	if(list->next < list->idx.size())
+	{
+		tables->consumed[list->idx[list->next]] = true;
+		return tables->replies[list->idx[list->next++]];
+	}
+	/* queries are answered the same way every time they are repeated */
+	if(reuse_last && !list->idx.empty())
+	{
+		return tables->replies[list->idx.back()];
+	}
+	return NULL;
+}
+
+/* returns true when the ioctl was answered from the trace */
+static bool play_reply(unsigned long request, void *arg, int *ret)
+{
+	static pthread_mutex_t reply_lock = PTHREAD_MUTEX_INITIALIZER;
+	const ipacm_replay_rec *rec = NULL;
+	std::map<uint64_t, reply_list>::iterator key_it;
+	std::map<uint32_t, reply_list>::iterator req_it;
+	std::vector<uint8_t> in;
+	ioctl_layout lay;
+	uint32_t req = (uint32_t)request;
+	uint64_t key;
+
+	ioctl_get_layout(request, arg, &lay);
+	ioctl_flatten(&lay, arg, in);
+	key = fnv1a(fnv1a(0xcbf29ce484222325ULL, &req, sizeof(req)), in.data(), in.size());
+
+	pthread_mutex_lock(&reply_lock);
+	key_it = tables->reply_by_key.find(key);
+	if(key_it != tables->reply_by_key.end())
+	{
+		rec = reply_take(&key_it->second, true);
+	}
+	if(rec == NULL)
+	{
+		/* inputs differ from the recording, fall back to the order of the requests */
+		req_it = tables->reply_by_req.find(req);
+		if(req_it != tables->reply_by_req.end())
+		{
+			rec = reply_take(&req_it->second, false);
+		}
+	}
+	pthread_mutex_unlock(&reply_lock);
+
+	if(rec == NULL)
+	{
+		return false;
+	}
+	ioctl_unflatten(&lay, arg, (const uint8_t *)(rec + 1) + rec->in_len, rec->len - rec->in_len);
+	*ret = rec->ret;
+	if(rec->ret < 0)
+	{
+		errno = rec->sock ? (int)rec->sock : EINVAL;
+	}
+	return true;
+}
+
+/* the stand-in device: recorded results, otherwise success with the arguments untouched */
+static int play_ioctl(unsigned long request, void *arg)
+{
+	ioctl_layout lay;
+	std::vector<uint8_t> in;
+	uint32_t event;
+	uint64_t now;
+	int ret = 0;
+
+	if(rules_file != NULL)
+	{
+		ioctl_get_layout(request, arg, &lay);
+		ioctl_flatten(&lay, arg, in);
+	}
+	if(!play_reply(request, arg, &ret))
+	{
+		ret = 0;
+	}
+
+	now = now_ns();
+	event = __atomic_load_n(&cur_event, __ATOMIC_RELAXED);
+	__atomic_store_n(&last_ioctl_ns, now, __ATOMIC_RELAXED);
+	if(event < tables->events.size())
+	{
+		__atomic_add_fetch(&tables->events[event].ioctls, 1, __ATOMIC_RELAXED);
+		__atomic_store_n(&tables->events[event].last_ns, now, __ATOMIC_RELAXED);
+	}
+
+	pthread_mutex_lock(&trace_lock);
+	tables->emitted[(uint32_t)request]++;
+	pthread_mutex_unlock(&trace_lock);
+	trace_write(rules_file, REPLAY_REC_RULE, (uint32_t)request, ret, event, in.data(), in.size(),
+		NULL, 0);
+	return ret;
+}
+
+/* ------------------------------------------------------------------ replay */
+
+static bool play_load(const char *path)
+{
+	const ipacm_replay_file_hdr *hdr;
+	const ipacm_replay_rec *rec;
+	replay_event event;
+	uint64_t key;
+	size_t size = 0, off;
+	ssize_t len;
+	int fd;
+
+	fd = real_open(path, O_RDONLY);
+	if(fd < 0)
+	{
+		fprintf(stderr, "ipacm replay: unable to open %s: %s\n", path, strerror(errno));
+		return false;
+	}
+	size = lseek(fd, 0, SEEK_END);
+	lseek(fd, 0, SEEK_SET);
+	trace_buf = (char *)malloc(size + 1);
+	if(trace_buf == NULL)
+	{
+		real_close(fd);
+		return false;
+	}
+	for(off = 0; off < size; off += len)
+	{
+		len = real_read(fd, trace_buf + off, size - off);
+		if(len <= 0)
+		{
+			break;
+		}
+	}
+	real_close(fd);
+
+	hdr = (const ipacm_replay_file_hdr *)trace_buf;
+	if(off != size || size < sizeof(*hdr) || hdr->magic != IPACM_REPLAY_MAGIC ||
+		hdr->version != IPACM_REPLAY_VERSION)
+	{
+		fprintf(stderr, "ipacm replay: %s is not a replay trace\n", path);
+		return false;
+	}
+
+	memset(&event, 0, sizeof(event));
+	for(off = sizeof(*hdr); off + sizeof(*rec) <= size; off += sizeof(*rec) + rec->len)
+	{
+		rec = (const ipacm_replay_rec *)(trace_buf + off);
+		if(off + sizeof(*rec) + rec->len > size || rec->in_len > rec->len)
+		{
+			fprintf(stderr, "ipacm replay: %s is truncated at offset %zu\n", path, off);
+			break;
+		}
+		switch(rec->type)
+		{
+			case REPLAY_REC_NL_ROUTE:
+			case REPLAY_REC_NL_CT:
+			case REPLAY_REC_IPA_MSG:
+				event.rec = rec;
+				tables->events.push_back(event);
+				break;
+			case REPLAY_REC_IOCTL:
+				key = fnv1a(fnv1a(0xcbf29ce484222325ULL, &rec->request, sizeof(rec->request)),
+					rec + 1, rec->in_len);
+				tables->reply_by_key[key].idx.push_back(tables->replies.size());
+				tables->reply_by_req[rec->request].idx.push_back(tables->replies.size());
+				tables->replies.push_back(rec);
+				break;
+			default:
+				break;
+		}
+	}
+	tables->consumed.assign(tables->replies.size(), false);
+	fprintf(stderr, "ipacm replay: %zu events and %zu ioctl results loaded from %s\n",
+		tables->events.size(), tables->replies.size(), path);
+	return true;
+}
+
+/* peer of the descriptor the event is delivered to, -1 while ipacm has not opened it */
+static int play_target(const ipacm_replay_rec *rec)
+{
+	uint8_t kind;
+	int fd, peer = -1;
+
+	pthread_mutex_lock(&fd_lock);
+	if(rec->type == REPLAY_REC_IPA_MSG)
+	{
+		if(driver_fd >= 0)
+		{
+			peer = fds[driver_fd].peer;
+		}
+	}
+	else
+	{
+		kind = (rec->type == REPLAY_REC_NL_CT) ? FD_NL_CT : FD_NL_ROUTE;
+		for(fd = 0; fd < REPLAY_MAX_FD; fd++)
+		{
+			if(fds[fd].kind == kind && fds[fd].event && fds[fd].ordinal == rec->sock)
+			{
+				peer = fds[fd].peer;
+				break;
+			}
+		}
+	}
+	pthread_mutex_unlock(&fd_lock);
+	return peer;
+}
+
+/* waits until no ioctl came for idle_ns, returns false on timeout */
+static bool play_wait_idle(uint64_t since)
+{
+	uint64_t start = now_ns(), last;
+
+	while(1)
+	{
+		usleep(REPLAY_POLL_US);
+		last = std::max(since, __atomic_load_n(&last_ioctl_ns, __ATOMIC_RELAXED));
+		if(now_ns() - last >= idle_ns)
+		{
+			return true;
+		}
+		if(now_ns() - start >= wait_ns)
+		{
+			return false;
+		}
+	}
+}
+
+static std::string event_type(const ipacm_replay_rec *rec)
+{
+	const struct nlmsghdr *nlh = (const struct nlmsghdr *)(rec + 1);
+	struct ipa_msg_meta meta;
+	char name[32];
+
+	if(rec->type == REPLAY_REC_IPA_MSG)
+	{
+		if(rec->len < sizeof(meta))
+		{
+			return "ipa msg";
+		}
+		memcpy(&meta, rec + 1, sizeof(meta));
+		snprintf(name, sizeof(name), "ipa msg %u", meta.msg_type);
+		return name;
+	}
+	if(rec->len < sizeof(*nlh))
+	{
+		return "netlink";
+	}
+	if(rec->type == REPLAY_REC_NL_CT)
+	{
+		switch(NFNL_MSG_TYPE(nlh->nlmsg_type))
+		{
+			case IPCTNL_MSG_CT_NEW:
+				return (nlh->nlmsg_flags & (NLM_F_CREATE | NLM_F_EXCL)) ? "ct new" : "ct update";
+			case IPCTNL_MSG_CT_DELETE:
+				return "ct destroy";
+			default:
+				return "ct other";
+		}
+	}
+	switch(nlh->nlmsg_type)
+	{
+		case RTM_NEWLINK:
+			return "link new";
+		case RTM_DELLINK:
+			return "link del";
+		case RTM_NEWADDR:
+			return "addr new";
+		case RTM_DELADDR:
+			return "addr del";
+		case RTM_NEWNEIGH:
+			return "neigh new";
+		case RTM_DELNEIGH:
+			return "neigh del";
+		case RTM_NEWROUTE:
+			return "route new";
+		case RTM_DELROUTE:
+			return "route del";
+		default:
+			snprintf(name, sizeof(name), "netlink %u", nlh->nlmsg_type);
+			return name;
+	}
+}
+
+static void play_report(FILE *out, uint64_t start_ns, uint64_t end_ns)
+{
+	std::map<std::string, std::vector<uint64_t> > latency;
+	std::map<std::string, uint64_t> count, ioctls, no_rule;
+	std::map<std::string, std::vector<uint64_t> >::iterator it;
+	std::map<uint32_t, uint64_t>::iterator em;
+	std::vector<uint64_t> *lat;
+	uint64_t injected = 0, skipped = 0, total;
+	std::string type;
+	const char *name;
+	size_t cnt;
+
+	for(cnt = 0; cnt < tables->events.size(); cnt++)
+	{
+		if(tables->events[cnt].skipped)
+		{
+			skipped++;
+			continue;
+		}
+		injected++;
+		type = event_type(tables->events[cnt].rec);
+		latency[type];
+		count[type]++;
+		ioctls[type] += tables->events[cnt].ioctls;
+		if(flood)
+		{
+			continue;
+		}
+		if(tables->events[cnt].ioctls == 0)
+		{
+			no_rule[type]++;
+			continue;
+		}
+		latency[type].push_back(tables->events[cnt].last_ns - tables->events[cnt].inject_ns);
+	}
+
+	fprintf(out, "ipacm replay: %llu events injected, %llu skipped, %s mode\n",
+		(unsigned long long)injected, (unsigned long long)skipped, flood ? "flood" : "paced");
+	if(!flood)
+	{
+		fprintf(out, "%-16s %8s %8s %8s %10s %10s %10s %10s\n", "event", "count", "ioctls",
+			"no rule", "avg(us)", "p50(us)", "p99(us)", "max(us)");
+	}
+	for(it = latency.begin(); it != latency.end(); ++it)
+	{
+		lat = &it->second;
+		if(flood)
+		{
+			/* events overlap, ioctls cannot be told apart */
+			fprintf(out, "%-16s %8llu\n", it->first.c_str(), (unsigned long long)count[it->first]);
+			continue;
+		}
+		std::sort(lat->begin(), lat->end());
+		total = 0;
+		for(cnt = 0; cnt < lat->size(); cnt++)
+		{
+			total += (*lat)[cnt];
+		}
+		fprintf(out, "%-16s %8llu %8llu %8llu %10.1f %10.1f %10.1f %10.1f\n", it->first.c_str(),
+			(unsigned long long)count[it->first],
+			(unsigned long long)ioctls[it->first], (unsigned long long)no_rule[it->first],
+			lat->empty() ? 0.0 : total / 1000.0 / lat->size(),
+			lat->empty() ? 0.0 : (*lat)[lat->size() / 2] / 1000.0,
+			lat->empty() ? 0.0 : (*lat)[(lat->size() * 99) / 100] / 1000.0,
+			lat->empty() ? 0.0 : lat->back() / 1000.0);
+	}
+	/* paced, the window is mostly the idle waits between events */
+	if(flood && end_ns > start_ns)
+	{
+		fprintf(out, "throughput: %.1f events/s, %llu events in %.1fms until idle\n",
+			injected * 1e9 / (end_ns - start_ns), (unsigned long long)injected,
+			(end_ns - start_ns) / 1e6);
+	}
+
+	fprintf(out, "ioctls emitted:\n");
+	pthread_mutex_lock(&trace_lock);
+	for(em = tables->emitted.begin(); em != tables->emitted.end(); ++em)
+	{
+		name = ioctl_name(em->first);
+		if(name != NULL)
+		{
+			fprintf(out, "  %-32s %llu\n", name, (unsigned long long)em->second);
+		}
+		else
+		{
+			fprintf(out, "  0x%08x%24s %llu\n", em->first, "", (unsigned long long)em->second);
+		}
+	}
+	pthread_mutex_unlock(&trace_lock);
+}
+
+static void *play_thread(void *param)
+{
+	const char *report_path = getenv("IPACM_REPLAY_REPORT");
+	const char *exit_env = getenv("IPACM_REPLAY_EXIT");
+	uint64_t start_ns = 0, last_inject_ns = 0, end_ns, deadline, now;
+	replay_event *ev;
+	FILE *report;
+	size_t cnt;
+	int peer;
+
+	(void)param;
+	for(cnt = 0; cnt < tables->events.size(); cnt++)
+	{
+		ev = &tables->events[cnt];
+		deadline = now_ns() + wait_ns;
+		while((peer = play_target(ev->rec)) < 0 && now_ns() < deadline)
+		{
+			usleep(REPLAY_POLL_US);
+		}
+		if(peer < 0)
+		{
+			ev->skipped = true;
+			continue;
+		}
+
+		/* let ipacm settle, the first time this also waits for its initialization */
+		if(!flood || start_ns == 0)
+		{
+			play_wait_idle(last_inject_ns);
+		}
+
+		now = now_ns();
+		if(start_ns == 0)
+		{
+			start_ns = now;
+		}
+		ev->inject_ns = now;
+		last_inject_ns = now;
+		__atomic_store_n(&cur_event, (uint32_t)cnt, __ATOMIC_RELAXED);
+		if(write(peer, ev->rec + 1, ev->rec->len) != (ssize_t)ev->rec->len)
+		{
+			fprintf(stderr, "ipacm replay: unable to inject event %zu: %s\n", cnt, strerror(errno));
+			ev->skipped = true;
+		}
+	}
+	play_wait_idle(last_inject_ns);
+	end_ns = __atomic_load_n(&last_ioctl_ns, __ATOMIC_RELAXED);
+
+	play_report(stderr, start_ns, end_ns);
+	if(report_path != NULL)
+	{
+		report = fopen(report_path, "w");
+		if(report != NULL)
+		{
+			play_report(report, start_ns, end_ns);
+			fclose(report);
+		}
+	}
+	if(rules_file != NULL)
+	{
+		pthread_mutex_lock(&trace_lock);
+		fflush(rules_file);
+		pthread_mutex_unlock(&trace_lock);
+	}
+	if(exit_env == NULL || strcmp(exit_env, "0") != 0)
+	{
+		_exit(0);
+	}
+	return NULL;
+}
+
+#define RESOLVE(name) real_##name = (decltype(real_##name))dlsym(RTLD_NEXT, #name)
+
+static void replay_init(void)
+{
+	const char *record_path, *play_path, *rules_path;
+	pthread_t thread;
+
+	RESOLVE(open);
+	RESOLVE(open64);
+	RESOLVE(close);
+	RESOLVE(read);
+	RESOLVE(ioctl);
+	RESOLVE(mmap);
+	RESOLVE(socket);
+	RESOLVE(bind);
+	RESOLVE(getsockname);
+	RESOLVE(setsockopt);
+	RESOLVE(send);
+	RESOLVE(sendto);
+	RESOLVE(sendmsg);
+	RESOLVE(recv);
+	RESOLVE(recvfrom);
+	RESOLVE(recvmsg);
+	RESOLVE(recvmmsg);
+
+	record_path = getenv("IPACM_REPLAY_RECORD");
+	play_path = getenv("IPACM_REPLAY_PLAY");
+	if(record_path != NULL)
+	{
+		trace_file = trace_create(record_path);
+		if(trace_file != NULL)
+		{
+			mode = REPLAY_RECORD;
+		}
+		return;
+	}
+	if(play_path == NULL)
+	{
+		return;
+	}
+	tables = new replay_tables();
+	if(!play_load(play_path))
+	{
+		return;
+	}
+
+	rules_path = getenv("IPACM_REPLAY_RULES");
+	if(rules_path != NULL)
+	{
+		rules_file = trace_create(rules_path);
+	}
+	flood = env_ms("IPACM_REPLAY_FLOOD", 0) != 0;
+	idle_ns = env_ms("IPACM_REPLAY_IDLE_MS", REPLAY_DEFAULT_IDLE_MS) * 1000000ULL;
+	wait_ns = env_ms("IPACM_REPLAY_WAIT_MS", REPLAY_DEFAULT_WAIT_MS) * 1000000ULL;
+	/* no event is current until the first one is injected */
+	cur_event = tables->events.size();
+	mode = REPLAY_PLAY;
+	if(pthread_create(&thread, NULL, play_thread, NULL) != 0)
+	{
+		fprintf(stderr, "ipacm replay: unable to start the replay thread\n");
+		mode = REPLAY_OFF;
+		return;
+	}
+	pthread_detach(thread);
+}
+
+static void replay_ensure_init(void)
+{
+	pthread_once(&replay_once, replay_init);
+}
+
+__attribute__((constructor)) static void replay_ctor(void)
+{
+	replay_ensure_init();
+}
+
+/* ------------------------------------------------------- netlink stand-in */
+
+static void fill_nl_addr(struct sockaddr *addr, socklen_t *addrlen, uint32_t pid, uint32_t groups)
+{
+	struct sockaddr_nl nladdr;
+
+	if(addr == NULL || addrlen == NULL)
+	{
+		return;
+	}
+	memset(&nladdr, 0, sizeof(nladdr));
+	nladdr.nl_family = AF_NETLINK;
+	nladdr.nl_pid = pid;
+	nladdr.nl_groups = groups;
+	memcpy(addr, &nladdr, std::min((size_t)*addrlen, sizeof(nladdr)));
+	*addrlen = sizeof(nladdr);
+}
+
+static uint32_t play_nl_pid(int fd)
+{
+	return (uint32_t)getpid() + ((uint32_t)fd << 22);
+}
+
+/* acknowledges requests, dumps come back empty */
+static void play_nl_request(int fd, const void *buf, size_t len)
+{
+	const struct nlmsghdr *nlh = (const struct nlmsghdr *)buf;
+	struct
+	{
+		struct nlmsghdr hdr;
+		struct nlmsgerr err;
+	} ack;
+	struct
+	{
+		struct nlmsghdr hdr;
+		int status;
+	} done;
+	replay_fd *entry = fd_entry(fd);
+	int peer;
+	int rem = (int)len;
+
+	if(entry == NULL)
+	{
+		return;
+	}
+	pthread_mutex_lock(&fd_lock);
+	peer = entry->peer;
+	pthread_mutex_unlock(&fd_lock);
+
+	for(; NLMSG_OK(nlh, rem); nlh = NLMSG_NEXT(nlh, rem))
+	{
+		if(nlh->nlmsg_flags & NLM_F_DUMP)
+		{
+			memset(&done, 0, sizeof(done));
+			done.hdr.nlmsg_len = sizeof(done);
+			done.hdr.nlmsg_type = NLMSG_DONE;
+			done.hdr.nlmsg_flags = NLM_F_MULTI;
+			done.hdr.nlmsg_seq = nlh->nlmsg_seq;
+			done.hdr.nlmsg_pid = play_nl_pid(fd);
+			if(write(peer, &done, sizeof(done)) < 0)
+			{
+				fprintf(stderr, "ipacm replay: unable to answer netlink dump\n");
+			}
+		}
+		else if(nlh->nlmsg_flags & NLM_F_ACK)
+		{
+			memset(&ack, 0, sizeof(ack));
+			ack.hdr.nlmsg_len = sizeof(ack);
+			ack.hdr.nlmsg_type = NLMSG_ERROR;
+			ack.hdr.nlmsg_seq = nlh->nlmsg_seq;
+			ack.hdr.nlmsg_pid = play_nl_pid(fd);
+			ack.err.error = 0;
+			ack.err.msg = *nlh;
+			if(write(peer, &ack, sizeof(ack)) < 0)
+			{
+				fprintf(stderr, "ipacm replay: unable to acknowledge netlink request\n");
+			}
+		}
+	}
+}
+
+static bool is_nl_kind(uint8_t kind)
+{
+	return kind == FD_NL_ROUTE || kind == FD_NL_CT;
+}
+
+/* -------------------------------------------------------------- interposed */
+
+extern "C" {
+
+static int replay_open(int (*fn)(const char *, int, ...), const char *path, int flags, mode_t mode_arg)
+{
+	int fd, sv[2];
+
+	if(mode == REPLAY_PLAY && is_ipa_device(path))
+	{
+		/* seqpacket keeps the driver messages apart, like reads on /dev/ipa */
+		if(socketpair(AF_UNIX, SOCK_SEQPACKET | ((flags & O_CLOEXEC) ? SOCK_CLOEXEC : 0), 0, sv) < 0)
+		{
+			return -1;
+		}
+		fd_track(sv[0], FD_IPA_DEV, sv[1]);
+		return sv[0];
+	}
+	fd = fn(path, flags, mode_arg);
+	if(mode == REPLAY_RECORD && fd >= 0 && is_ipa_device(path))
+	{
+		fd_track(fd, FD_IPA_DEV, -1);
+	}
+	return fd;
+}
+
+int open(const char *path, int flags, ...)
+{
+	mode_t mode_arg = 0;
+	va_list ap;
+
+	replay_ensure_init();
+	if(flags & (O_CREAT | O_TMPFILE))
+	{
+		va_start(ap, flags);
+		mode_arg = va_arg(ap, mode_t);
+		va_end(ap);
+	}
+	return replay_open(real_open, path, flags, mode_arg);
+}
+
+int open64(const char *path, int flags, ...)
+{
+	mode_t mode_arg = 0;
+	va_list ap;
+
+	replay_ensure_init();
+	if(flags & (O_CREAT | O_TMPFILE))
+	{
+		va_start(ap, flags);
+		mode_arg = va_arg(ap, mode_t);
+		va_end(ap);
+	}
+	return replay_open(real_open64, path, flags, mode_arg);
+}
+
+int close(int fd)
+{
+	replay_fd *entry = fd_entry(fd);
+	int peer = -1;
+
+	replay_ensure_init();
+	if(entry != NULL)
+	{
+		pthread_mutex_lock(&fd_lock);
+		if(entry->kind != FD_NONE)
+		{
+			peer = entry->peer;
+			memset(entry, 0, sizeof(*entry));
+			if(driver_fd == fd)
+			{
+				driver_fd = -1;
+			}
+		}
+		pthread_mutex_unlock(&fd_lock);
+	}
+	if(peer >= 0)
+	{
+		real_close(peer);
+	}
+	return real_close(fd);
+}
+
+ssize_t read(int fd, void *buf, size_t count)
+{
+	uint8_t kind;
+	ssize_t ret;
+	struct iovec iov;
+
+	replay_ensure_init();
+	kind = (mode == REPLAY_OFF) ? (uint8_t)FD_NONE : fd_kind(fd);
+	if(kind == FD_IPA_DEV && mode == REPLAY_PLAY)
+	{
+		/* the descriptor ipacm reads is the one driver messages go to */
+		pthread_mutex_lock(&fd_lock);
+		driver_fd = fd;
+		pthread_mutex_unlock(&fd_lock);
+	}
+	ret = real_read(fd, buf, count);
+	if(mode == REPLAY_RECORD && ret > 0)
+	{
+		if(kind == FD_IPA_DEV)
+		{
+			trace_write(trace_file, REPLAY_REC_IPA_MSG, 0, 0, 0, buf, ret, NULL, 0);
+		}
+		else if(is_nl_kind(kind))
+		{
+			iov.iov_base = buf;
+			iov.iov_len = count;
+			trace_netlink(fd, &iov, 1, ret);
+		}
+	}
+	return ret;
+}
+
+int ioctl(int fd, unsigned long request, ...)
+{
+	uint8_t kind;
+	void *arg;
+	va_list ap;
+	int ret;
+
+	va_start(ap, request);
+	arg = va_arg(ap, void *);
+	va_end(ap);
+
+	replay_ensure_init();
+	if(mode == REPLAY_OFF)
+	{
+		return real_ioctl(fd, request, arg);
+	}
+	kind = fd_kind(fd);
+	if(mode == REPLAY_RECORD)
+	{
+		if(kind == FD_IPA_DEV || is_ifreq_query(request))
+		{
+			return record_ioctl(fd, request, arg);
+		}
+		return real_ioctl(fd, request, arg);
+	}
+	if(kind == FD_IPA_DEV)
+	{
+		return play_ioctl(request, arg);
+	}
+	/* interfaces of the recording device do not exist here */
+	if(is_ifreq_query(request) && play_reply(request, arg, &ret))
+	{
+		return ret;
+	}
+	return real_ioctl(fd, request, arg);
+}
+
+void *mmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset)
+{
+	replay_ensure_init();
+	if(mode == REPLAY_PLAY && fd_kind(fd) == FD_IPA_DEV)
+	{
+		/* NAT tables get plain memory */
+		return real_mmap(addr, length, prot, (flags & ~MAP_SHARED) | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	}
+	return real_mmap(addr, length, prot, flags, fd, offset);
+}
+
+int socket(int domain, int type, int protocol)
+{
+	uint8_t kind;
+	int fd, sv[2];
+
+	replay_ensure_init();
+	if(mode == REPLAY_OFF || domain != AF_NETLINK ||
+		(protocol != NETLINK_ROUTE && protocol != NETLINK_NETFILTER))
+	{
+		return real_socket(domain, type, protocol);
+	}
+	kind = (protocol == NETLINK_NETFILTER) ? FD_NL_CT : FD_NL_ROUTE;
+	if(mode == REPLAY_PLAY)
+	{
+		if(socketpair(AF_UNIX, SOCK_DGRAM | (type & (SOCK_CLOEXEC | SOCK_NONBLOCK)), 0, sv) < 0)
+		{
+			return -1;
+		}
+		fd_track(sv[0], kind, sv[1]);
+		return sv[0];
+	}
+	fd = real_socket(domain, type, protocol);
+	if(fd >= 0)
+	{
+		fd_track(fd, kind, -1);
+	}
+	return fd;
+}
+
+int bind(int fd, const struct sockaddr *addr, socklen_t addrlen)
+{
+	uint8_t kind;
+
+	replay_ensure_init();
+	kind = (mode == REPLAY_OFF) ? (uint8_t)FD_NONE : fd_kind(fd);
+	if(!is_nl_kind(kind))
+	{
+		return real_bind(fd, addr, addrlen);
+	}
+	if(addr != NULL && addrlen >= sizeof(struct sockaddr_nl) &&
+		((const struct sockaddr_nl *)addr)->nl_groups != 0)
+	{
+		fd_mark_event(fd, ((const struct sockaddr_nl *)addr)->nl_groups);
+	}
+	return (mode == REPLAY_PLAY) ? 0 : real_bind(fd, addr, addrlen);
+}
+
+int getsockname(int fd, struct sockaddr *addr, socklen_t *addrlen)
+{
+	replay_fd *entry = fd_entry(fd);
+	uint32_t groups;
+
+	replay_ensure_init();
+	if(mode == REPLAY_PLAY && is_nl_kind(fd_kind(fd)))
+	{
+		pthread_mutex_lock(&fd_lock);
+		groups = entry->groups;
+		pthread_mutex_unlock(&fd_lock);
+		fill_nl_addr(addr, addrlen, play_nl_pid(fd), groups);
+		return 0;
+	}
+	return real_getsockname(fd, addr, addrlen);
+}
+
+int setsockopt(int fd, int level, int optname, const void *optval, socklen_t optlen)
+{
+	uint8_t kind;
+
+	replay_ensure_init();
+	kind = (mode == REPLAY_OFF) ? (uint8_t)FD_NONE : fd_kind(fd);
+	if(!is_nl_kind(kind))
+	{
+		return real_setsockopt(fd, level, optname, optval, optlen);
+	}
+	if(level == SOL_NETLINK && optname == NETLINK_ADD_MEMBERSHIP && optval != NULL &&
+		optlen >= sizeof(int))
+	{
+		fd_mark_event(fd, 1U << ((*(const int *)optval - 1) & 31));
+	}
+	/* socket options, filters included, have no meaning on the stand-in */
+	return (mode == REPLAY_PLAY) ? 0 : real_setsockopt(fd, level, optname, optval, optlen);
+}
+
+ssize_t send(int fd, const void *buf, size_t len, int flags)
+{
+	replay_ensure_init();
+	if(mode == REPLAY_PLAY && is_nl_kind(fd_kind(fd)))
+	{
+		play_nl_request(fd, buf, len);
+		return len;
+	}
+	return real_send(fd, buf, len, flags);
+}
+
+ssize_t sendto(int fd, const void *buf, size_t len, int flags, const struct sockaddr *addr,
+	socklen_t addrlen)
+{
+	replay_ensure_init();
+	if(mode == REPLAY_PLAY && is_nl_kind(fd_kind(fd)))
+	{
+		play_nl_request(fd, buf, len);
+		return len;
+	}
+	return real_sendto(fd, buf, len, flags, addr, addrlen);
+}
+
+ssize_t sendmsg(int fd, const struct msghdr *msg, int flags)
+{
+	std::vector<uint8_t> buf;
+	size_t cnt;
+
+	replay_ensure_init();
+	if(mode == REPLAY_PLAY && is_nl_kind(fd_kind(fd)))
+	{
+		for(cnt = 0; cnt < msg->msg_iovlen; cnt++)
+		{
+			buf.insert(buf.end(), (uint8_t *)msg->msg_iov[cnt].iov_base,
+				(uint8_t *)msg->msg_iov[cnt].iov_base + msg->msg_iov[cnt].iov_len);
+		}
+		play_nl_request(fd, buf.data(), buf.size());
+		return buf.size();
+	}
+	return real_sendmsg(fd, msg, flags);
+}
+
+ssize_t recv(int fd, void *buf, size_t len, int flags)
+{
+	struct iovec iov;
+	ssize_t ret;
+
+	replay_ensure_init();
+	ret = real_recv(fd, buf, len, flags);
+	if(mode == REPLAY_RECORD && ret > 0 && !(flags & MSG_PEEK) && is_nl_kind(fd_kind(fd)))
+	{
+		iov.iov_base = buf;
+		iov.iov_len = len;
+		trace_netlink(fd, &iov, 1, ret);
+	}
+	return ret;
+}
+
+ssize_t recvfrom(int fd, void *buf, size_t len, int flags, struct sockaddr *addr,
+	socklen_t *addrlen)
+{
+	struct iovec iov;
+	uint8_t kind;
+	ssize_t ret;
+
+	replay_ensure_init();
+	kind = (mode == REPLAY_OFF) ? (uint8_t)FD_NONE : fd_kind(fd);
+	if(mode == REPLAY_PLAY && is_nl_kind(kind))
+	{
+		ret = real_recvfrom(fd, buf, len, flags, NULL, NULL);
+		if(ret >= 0)
+		{
+			/* everything comes from the kernel */
+			fill_nl_addr(addr, addrlen, 0, 0);
+		}
+		return ret;
+	}
+	ret = real_recvfrom(fd, buf, len, flags, addr, addrlen);
+	if(mode == REPLAY_RECORD && ret > 0 && !(flags & MSG_PEEK) && is_nl_kind(kind))
+	{
+		iov.iov_base = buf;
+		iov.iov_len = len;
+		trace_netlink(fd, &iov, 1, ret);
+	}
+	return ret;
+}
+
+ssize_t recvmsg(int fd, struct msghdr *msg, int flags)
+{
+	uint8_t kind;
+	void *name;
+	ssize_t ret;
+
+	replay_ensure_init();
+	kind = (mode == REPLAY_OFF) ? (uint8_t)FD_NONE : fd_kind(fd);
+	if(mode == REPLAY_PLAY && is_nl_kind(kind))
+	{
+		name = msg->msg_name;
+		msg->msg_name = NULL;
+		ret = real_recvmsg(fd, msg, flags);
+		msg->msg_name = name;
+		if(ret >= 0)
+		{
+			fill_nl_addr((struct sockaddr *)msg->msg_name, &msg->msg_namelen, 0, 0);
+		}
+		return ret;
+	}
+	ret = real_recvmsg(fd, msg, flags);
+	if(mode == REPLAY_RECORD && ret > 0 && !(flags & MSG_PEEK) && is_nl_kind(kind))
+	{
+		trace_netlink(fd, msg->msg_iov, msg->msg_iovlen, ret);
+	}
+	return ret;
+}
+
+int recvmmsg(int fd, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout)
+{
+	std::vector<void *> names;
+	uint8_t kind;
+	unsigned int cnt;
+	int ret;
+
+	replay_ensure_init();
+	kind = (mode == REPLAY_OFF) ? (uint8_t)FD_NONE : fd_kind(fd);
+	if(mode == REPLAY_PLAY && is_nl_kind(kind))
+	{
+		names.resize(vlen);
+		for(cnt = 0; cnt < vlen; cnt++)
+		{
+			names[cnt] = msgvec[cnt].msg_hdr.msg_name;
+			msgvec[cnt].msg_hdr.msg_name = NULL;
+		}
+		ret = real_recvmmsg(fd, msgvec, vlen, flags, timeout);
+		for(cnt = 0; cnt < vlen; cnt++)
+		{
+			msgvec[cnt].msg_hdr.msg_name = names[cnt];
+			if((int)cnt < ret)
+			{
+				fill_nl_addr((struct sockaddr *)names[cnt], &msgvec[cnt].msg_hdr.msg_namelen, 0, 0);
+			}
+		}
+		return ret;
+	}
+	ret = real_recvmmsg(fd, msgvec, vlen, flags, timeout);
+	if(mode == REPLAY_RECORD && ret > 0 && !(flags & MSG_PEEK) && is_nl_kind(kind))
+	{
+		for(cnt = 0; cnt < (unsigned int)ret; cnt++)
+		{
+			trace_netlink(fd, msgvec[cnt].msg_hdr.msg_iov, msgvec[cnt].msg_hdr.msg_iovlen,
+				msgvec[cnt].msg_len);
+		}
+	}
+	return ret;
+}
+
+} /* extern "C" */
@@ -79,6 +79,7 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "IPACM_Routing.h"
 #include <IPACM_Log.h>
+#include "IPACM_RuleTxn.h"
 
 const char *IPACM_Routing::DEVICE_NAME = "/dev/ipa";
 
@@ -130,7 +131,8 @@ bool IPACM_Routing::AddRoutingRule(struct ipa_ioc_add_rt_rule *ruleTable)
 		return false;
 	}
 
-	retval = ioctl(m_fd, IPA_IOC_ADD_RT_RULE, ruleTable);
+	retval = IPACM_RuleTxn::Ioctl(m_fd, IPA_IOC_ADD_RT_RULE, ruleTable, &ruleTable->commit,
+		IPACM_RuleTxn::RtTable(ruleTable->ip));
 	if (retval)
 	{
 		IPACMERR_LOG("Failed adding routing rule %p\n", ruleTable);
@@ -166,7 +168,8 @@ bool IPACM_Routing::AddRoutingRule(struct ipa_ioc_add_rt_rule_v2 *table) {
 		return false;
 	}
 
-	int retval = ioctl(m_fd, IPA_IOC_ADD_RT_RULE_V2, table);
+	int retval = IPACM_RuleTxn::Ioctl(m_fd, IPA_IOC_ADD_RT_RULE_V2, table, &table->commit,
+		IPACM_RuleTxn::RtTable(table->ip));
 	if (retval) {
 		IPACMERR("Failed adding routing table %p\n", table);
 		return false;
@@ -246,7 +249,8 @@ bool IPACM_Routing::AddRoutingRule_hw_index(struct ipa_ioc_add_rt_rule *ruleTabl
 			&rt_rule_entry, sizeof(rt_rule_entry));
 	}
 
-	retval = ioctl(m_fd, IPA_IOC_ADD_RT_RULE_V2, ruleTable_v2);
+	retval = IPACM_RuleTxn::Ioctl(m_fd, IPA_IOC_ADD_RT_RULE_V2, ruleTable_v2, &ruleTable_v2->commit,
+		IPACM_RuleTxn::RtTable(ruleTable_v2->ip));
 	if (retval != 0)
 	{
 		IPACMERR("Failed adding Routing rule %pK\n", ruleTable_v2);
@@ -295,7 +299,9 @@ bool IPACM_Routing::DeleteRoutingRule(struct ipa_ioc_del_rt_rule *ruleTable)
 
 	if (!DeviceNodeIsOpened()) return false;
 
+	IPACM_RuleTxn::Lock();
 	retval = ioctl(m_fd, IPA_IOC_DEL_RT_RULE, ruleTable);
+	IPACM_RuleTxn::Unlock();
 	if (retval)
 	{
 		IPACMERR("Failed deleting routing rule table %p\n", ruleTable);
@@ -312,7 +318,9 @@ bool IPACM_Routing::Commit(enum ipa_ip_type ip)
 
 	if (!DeviceNodeIsOpened()) return false;
 
+	IPACM_RuleTxn::Lock();
 	retval = ioctl(m_fd, IPA_IOC_COMMIT_RT, ip);
+	IPACM_RuleTxn::Unlock();
 	if (retval)
 	{
 		IPACMERR("Failed commiting routing rules.\n");
@@ -329,8 +337,10 @@ bool IPACM_Routing::Reset(enum ipa_ip_type ip)
 
 	if (!DeviceNodeIsOpened()) return false;
 
+	IPACM_RuleTxn::Lock();
 	retval = ioctl(m_fd, IPA_IOC_RESET_RT, ip);
 	retval |= ioctl(m_fd, IPA_IOC_COMMIT_RT, ip);
+	IPACM_RuleTxn::Unlock();
 	if (retval)
 	{
 		IPACMERR("Failed resetting routing block.\n");
@@ -433,7 +443,8 @@ bool IPACM_Routing::ModifyRoutingRule(struct ipa_ioc_mdfy_rt_rule *mdfyRules)
 		return false;
 	}
 
-	retval = ioctl(m_fd, IPA_IOC_MDFY_RT_RULE, mdfyRules);
+	retval = IPACM_RuleTxn::Ioctl(m_fd, IPA_IOC_MDFY_RT_RULE, mdfyRules, &mdfyRules->commit,
+		IPACM_RuleTxn::RtTable(mdfyRules->ip));
 	if (retval)
 	{
 		IPACMERR("Failed modifying routing rules %p\n", mdfyRules);
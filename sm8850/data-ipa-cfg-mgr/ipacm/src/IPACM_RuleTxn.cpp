@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+/*!
+	@file
+	IPACM_RuleTxn.cpp
+
+	@brief
+	Coalesces the header, routing and filtering commits of one event
+*/
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "IPACM_RuleTxn.h"
+#include "IPACM_Log.h"
+
+#define IPACM_TXN_DEVICE_NAME "/dev/ipa"
+
+pthread_mutex_t IPACM_RuleTxn::lock = PTHREAD_MUTEX_INITIALIZER;
+int IPACM_RuleTxn::depth = 0;
+pthread_t IPACM_RuleTxn::owner;
+uint32_t IPACM_RuleTxn::dirty = 0;
+uint64_t IPACM_RuleTxn::start_us = 0;
+int IPACM_RuleTxn::fd = -1;
+std::atomic<uint64_t> IPACM_RuleTxn::deferred[IPACM_TXN_TABLE_MAX];
+std::atomic<uint64_t> IPACM_RuleTxn::committed[IPACM_TXN_TABLE_MAX];
+std::atomic<uint64_t> IPACM_RuleTxn::attach_count(0);
+std::atomic<uint64_t> IPACM_RuleTxn::attach_total_us(0);
+std::atomic<uint32_t> IPACM_RuleTxn::attach_max_us(0);
+
+static const char *txn_table_name[IPACM_TXN_TABLE_MAX] =
+{
+	"hdr",
+	"rt v4",
+	"rt v6",
+	"flt v4",
+	"flt v6",
+};
+
+static uint64_t now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+}
+
+/* events that bring a client up to offload */
+static bool is_client_attach(ipa_cm_event_id event)
+{
+	switch(event)
+	{
+		case IPA_NEIGH_CLIENT_IP_ADDR_ADD_EVENT:
+		case IPA_WLAN_CLIENT_ADD_EVENT:
+		case IPA_WLAN_CLIENT_ADD_EVENT_EX:
+		case IPA_WIGIG_CLIENT_ADD_EVENT:
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool IPACM_RuleTxn::IsOwner(void)
+{
+	return depth > 0 && pthread_equal(owner, pthread_self());
+}
+
+void IPACM_RuleTxn::Init(void)
+{
+	fd = open(IPACM_TXN_DEVICE_NAME, O_RDWR);
+	if(fd < 0)
+	{
+		IPACMERR("unable to open %s, rule commits are not coalesced\n", IPACM_TXN_DEVICE_NAME);
+	}
+}
+
+void IPACM_RuleTxn::Begin(void)
+{
+	pthread_mutex_lock(&lock);
+	if(depth > 0)
+	{
+		/* nested dispatch on the command thread joins the open transaction */
+		if(IsOwner())
+		{
+			depth++;
+		}
+	}
+	else if(fd >= 0)
+	{
+		owner = pthread_self();
+		dirty = 0;
+		start_us = now_us();
+		depth = 1;
+	}
+	pthread_mutex_unlock(&lock);
+}
+
+bool IPACM_RuleTxn::Defer(ipacm_txn_table table)
+{
+	if(!IsOwner())
+	{
+		return false;
+	}
+
+	dirty |= (1 << table);
+	deferred[table]++;
+	return true;
+}
+
+int IPACM_RuleTxn::Ioctl(int dev_fd, unsigned long request, void *arg, uint8_t *commit,
+	ipacm_txn_table table)
+{
+	uint8_t saved = *commit;
+	int ret;
+
+	pthread_mutex_lock(&lock);
+	if(saved)
+	{
+		if(Defer(table))
+		{
+			*commit = 0;
+		}
+		else
+		{
+			/* the commit of another thread would push the pending rules along */
+			FlushLocked();
+		}
+	}
+	ret = ioctl(dev_fd, request, arg);
+	*commit = saved;
+	pthread_mutex_unlock(&lock);
+	return ret;
+}
+
+void IPACM_RuleTxn::Flush(void)
+{
+	pthread_mutex_lock(&lock);
+	if(IsOwner())
+	{
+		FlushLocked();
+	}
+	pthread_mutex_unlock(&lock);
+}
+
+void IPACM_RuleTxn::Lock(void)
+{
+	pthread_mutex_lock(&lock);
+	FlushLocked();
+}
+
+void IPACM_RuleTxn::Unlock(void)
+{
+	pthread_mutex_unlock(&lock);
+}
+
+void IPACM_RuleTxn::FlushLocked(void)
+{
+	int table;
+	int ret = 0;
+
+	if(dirty == 0)
+	{
+		return;
+	}
+
+	/* routing rules point at headers and filtering rules at routing tables */
+	for(table = 0; table < IPACM_TXN_TABLE_MAX; table++)
+	{
+		if(!(dirty & (1 << table)))
+		{
+			continue;
+		}
+
+		switch(table)
+		{
+			case IPACM_TXN_HDR:
+				ret = ioctl(fd, IPA_IOC_COMMIT_HDR);
+				break;
+			case IPACM_TXN_RT_V4:
+				ret = ioctl(fd, IPA_IOC_COMMIT_RT, IPA_IP_v4);
+				break;
+			case IPACM_TXN_RT_V6:
+				ret = ioctl(fd, IPA_IOC_COMMIT_RT, IPA_IP_v6);
+				break;
+			case IPACM_TXN_FLT_V4:
+				ret = ioctl(fd, IPA_IOC_COMMIT_FLT, IPA_IP_v4);
+				break;
+			case IPACM_TXN_FLT_V6:
+				ret = ioctl(fd, IPA_IOC_COMMIT_FLT, IPA_IP_v6);
+				break;
+		}
+		if(ret != 0)
+		{
+			IPACMERR("failed committing %s table, ret %d\n", txn_table_name[table], ret);
+		}
+		committed[table]++;
+	}
+	dirty = 0;
+}
+
+void IPACM_RuleTxn::End(ipa_cm_event_id event)
+{
+	uint32_t latency_us;
+
+	pthread_mutex_lock(&lock);
+	if(!IsOwner())
+	{
+		pthread_mutex_unlock(&lock);
+		return;
+	}
+
+	if(depth > 1)
+	{
+		depth--;
+		pthread_mutex_unlock(&lock);
+		return;
+	}
+
+	FlushLocked();
+	depth = 0;
+
+	if(is_client_attach(event))
+	{
+		latency_us = (uint32_t)(now_us() - start_us);
+		attach_count++;
+		attach_total_us += latency_us;
+		if(latency_us > attach_max_us)
+		{
+			attach_max_us = latency_us;
+		}
+	}
+	pthread_mutex_unlock(&lock);
+}
+
+void IPACM_RuleTxn::DumpStats(void)
+{
+	int table;
+	uint64_t count = attach_count.load();
+
+	for(table = 0; table < IPACM_TXN_TABLE_MAX; table++)
+	{
+		IPACMDBG_H("rule txn %s: %llu commits requested, %llu issued\n", txn_table_name[table],
+			(unsigned long long)deferred[table].load(), (unsigned long long)committed[table].load());
+	}
+	IPACMDBG_H("client attach to offload: %llu clients, latency avg %lluus max %uus\n",
+		(unsigned long long)count,
+		(unsigned long long)(count ? attach_total_us.load() / count : 0),
+		attach_max_us.load());
+}
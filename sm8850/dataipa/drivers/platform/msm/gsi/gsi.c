@@ -7,6 +7,7 @@
 #include <linux/of.h>
 #include <linux/interrupt.h>
 #include <linux/io.h>
+#include <linux/ktime.h>
 #include <linux/log2.h>
 #include <linux/module.h>
 #include <linux/msm_gsi.h>
@@ -668,6 +669,61 @@ static uint16_t gsi_get_complete_num(struct gsi_ring_ctx *ctx, uint64_t addr1,
 		return (addr_diff + ctx->len) / ctx->elem_sz;
 }
 
+static inline u32 gsi_tlm_bucket(unsigned long val, u32 num_buckets)
+{
+	return min_t(u32, fls_long(val), num_buckets - 1);
+}
+
+static inline u32 gsi_tlm_now(void)
+{
+	/* 0 marks a TRE without a doorbell time */
+	return (u32)(ktime_get_ns() >> GSI_TLM_LAT_UNIT_SHIFT) ?: 1;
+}
+
+static void gsi_tlm_chan_doorbell(struct gsi_chan_ctx *ctx)
+{
+	struct gsi_ring_ctx *ring = &ctx->ring;
+	uint16_t used = 0;
+	uint64_t last;
+
+	ctx->stats.tlm.doorbells++;
+	if (ring->wp_local == ring->wp)
+		return;
+
+	if (ring->rp_local != ring->wp_local)
+		used = gsi_get_complete_num(ring, ring->rp_local,
+			ring->wp_local);
+	ctx->stats.tlm.occ_hist[gsi_tlm_bucket(used, GSI_TLM_OCC_BUCKETS)]++;
+
+	/* GCI completions are matched by cookie, not by ring position */
+	if (!gsi_ctx->tlm_lat || ctx->props.prot != GSI_CHAN_PROT_GPI)
+		return;
+
+	last = (ring->wp_local == ring->base ? ring->end : ring->wp_local) -
+		ring->elem_sz;
+	ctx->user_data[gsi_find_idx_from_addr(ring, last)].db_ts =
+		gsi_tlm_now();
+}
+
+static void gsi_tlm_chan_compl(struct gsi_chan_ctx *ctx, uint16_t idx)
+{
+	u32 db_ts = ctx->user_data[idx].db_ts;
+
+	if (!db_ts)
+		return;
+
+	ctx->user_data[idx].db_ts = 0;
+	ctx->stats.tlm.lat_hist[gsi_tlm_bucket(gsi_tlm_now() - db_ts,
+		GSI_TLM_LAT_BUCKETS)]++;
+}
+
+static void gsi_tlm_evt_irq_pass(struct gsi_evt_ctx *ctx, unsigned long num)
+{
+	ctx->stats.irq_passes++;
+	ctx->stats.irq_batch_hist[gsi_tlm_bucket(num,
+		GSI_TLM_BATCH_BUCKETS)]++;
+}
+
 static void gsi_process_chan(struct gsi_xfer_compl_evt *evt,
 		struct gsi_chan_xfer_notify *notify, bool callback)
 {
@@ -687,6 +743,11 @@ static void gsi_process_chan(struct gsi_xfer_compl_evt *evt,
 		ch_ctx->props.prot != GSI_CHAN_PROT_GCI))
 		return;
 
+	if (callback)
+		ch_ctx->stats.tlm.irq_events++;
+	else
+		ch_ctx->stats.tlm.poll_events++;
+
 	if (evt->type != GSI_XFER_COMPL_TYPE_GCI) {
 		rp = evt->xfer_ptr;
 
@@ -728,6 +789,7 @@ static void gsi_process_chan(struct gsi_xfer_compl_evt *evt,
 		!ch_ctx->props.tx_poll)) {
 		ch_ctx->stats.completed++;
 		ch_ctx->user_data[rp_idx].valid = false;
+		gsi_tlm_chan_compl(ch_ctx, rp_idx);
 	}
 
 	notify->chan_user_data = ch_ctx->props.chan_user_data;
@@ -775,6 +837,7 @@ static void gsi_ring_evt_doorbell(struct gsi_evt_ctx *ctx)
 {
 	uint32_t val;
 
+	ctx->stats.doorbells++;
 	ctx->ring.wp = ctx->ring.wp_local;
 	val = GSI_LSB(ctx->ring.wp_local);
 	gsihal_write_reg_nk(GSI_EE_n_EV_CH_k_DOORBELL_0,
@@ -801,6 +864,7 @@ static void gsi_ring_chan_doorbell(struct gsi_chan_ctx *ctx)
 	 */
 	if (ctx->evtr && ctx->props.dir == GSI_CHAN_DIR_FROM_GSI)
 		gsi_ring_evt_doorbell(ctx->evtr);
+	gsi_tlm_chan_doorbell(ctx);
 	ctx->ring.wp = ctx->ring.wp_local;
 
 	val = GSI_LSB(ctx->ring.wp_local);
@@ -885,6 +949,8 @@ check_again_v3_0:
 								   true);
 						empty = false;
 					}
+					if (cntr != 0)
+						gsi_tlm_evt_irq_pass(ctx, cntr);
 					if (!empty)
 						gsi_ring_evt_doorbell(ctx);
 					if (cntr != 0)
@@ -938,6 +1004,8 @@ check_again_v3_0:
 					gsi_process_evt_re(ctx, &notify, true);
 					empty = false;
 				}
+				if (cntr != 0)
+					gsi_tlm_evt_irq_pass(ctx, cntr);
 				if (!empty)
 					gsi_ring_evt_doorbell(ctx);
 				if (cntr != 0)
@@ -4249,6 +4317,7 @@ int __gsi_populate_tre(struct gsi_chan_ctx *ctx,
 	*tre_ptr = tre;
 	ctx->user_data[idx].valid = true;
 	ctx->user_data[idx].p = xfer->xfer_user_data;
+	ctx->user_data[idx].db_ts = 0;
 
 	return 0;
 }
@@ -4465,6 +4534,7 @@ int gsi_poll_n_channel(unsigned long chan_hdl,
 			rp |= ctx->evtr->ring.rp & GSI_MSB_MASK;
 			ctx->evtr->ring.rp = rp;
 			if (rp == ctx->evtr->ring.rp_local) {
+				ctx->stats.tlm.poll_batch_hist[0]++;
 				spin_unlock_irqrestore(
 					&ctx->evtr->ring.slock,
 					flags);
@@ -4483,6 +4553,8 @@ int gsi_poll_n_channel(unsigned long chan_hdl,
 	for (i = 0; i < *actual_num; i++)
 		gsi_process_evt_re(ctx->evtr, notify + i, false);
 
+	ctx->stats.tlm.poll_batch_hist[gsi_tlm_bucket(*actual_num,
+		GSI_TLM_BATCH_BUCKETS)]++;
 	spin_unlock_irqrestore(&ctx->evtr->ring.slock, flags);
 	ctx->stats.poll_ok++;
 
@@ -18,6 +18,7 @@
 #include <linux/ipc_logging.h>
 #include <linux/iommu.h>
 #include <linux/msi.h>
+#include "gsi_telemetry.h"
 
 /*
  * The following for adding code (ie. for EMULATION) not found on x86.
@@ -1415,6 +1416,25 @@ struct gsi_chan_dp_stats {
 	unsigned long last_timestamp;
 };
 
+/**
+ * struct gsi_chan_tlm_stats - doorbell and completion telemetry, exported
+ *	through the gsi/telemetry debugfs file, see gsi_telemetry.h
+ * @doorbells: channel doorbell writes
+ * @irq_events: completion events seen from the IEOB interrupt
+ * @poll_events: completion events consumed by polling
+ * @lat_hist: log2 histogram of doorbell to completion latency
+ * @occ_hist: log2 histogram of the TREs owned by H/W after a doorbell
+ * @poll_batch_hist: log2 histogram of the events returned per poll
+ */
+struct gsi_chan_tlm_stats {
+	unsigned long doorbells;
+	unsigned long irq_events;
+	unsigned long poll_events;
+	u32 lat_hist[GSI_TLM_LAT_BUCKETS];
+	u32 occ_hist[GSI_TLM_OCC_BUCKETS];
+	u32 poll_batch_hist[GSI_TLM_BATCH_BUCKETS];
+};
+
 struct gsi_chan_stats {
 	unsigned long queued;
 	unsigned long completed;
@@ -1426,6 +1446,7 @@ struct gsi_chan_stats {
 	unsigned long poll_empty;
 	unsigned long userdata_in_use;
 	struct gsi_chan_dp_stats dp;
+	struct gsi_chan_tlm_stats tlm;
 };
 
 /**
@@ -1433,9 +1454,13 @@ struct gsi_chan_stats {
  * @valid: valid to be cleaned. if its true that means it is being used.
  *	false means its free to overwrite
  * @p: pointer to the user data array element
+ * @db_ts: time the doorbell covering this TRE was rung, in
+ *	GSI_TLM_LAT_UNIT_SHIFT units, when the TRE was the last of the
+ *	doorbell and latency sampling is on, 0 otherwise
  */
 struct gsi_user_data {
 	bool valid;
+	u32 db_ts;
 	void *p;
 };
 
@@ -1457,6 +1482,9 @@ struct gsi_chan_ctx {
 
 struct gsi_evt_stats {
 	unsigned long completed;
+	unsigned long doorbells;
+	unsigned long irq_passes;
+	u32 irq_batch_hist[GSI_TLM_BATCH_BUCKETS];
 };
 
 struct gsi_evt_ctx {
@@ -1545,6 +1573,7 @@ struct gsi_ctx {
 	struct gsi_ee_scratch scratch;
 	int num_ch_dp_stats;
 	struct workqueue_struct *dp_stat_wq;
+	bool tlm_lat;
 	u32 max_ch;
 	u32 max_ev;
 	struct completion gen_ee_cmd_compl;
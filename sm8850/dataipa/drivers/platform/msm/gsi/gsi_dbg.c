@@ -7,6 +7,7 @@
 #include <linux/debugfs.h>
 #include <linux/dma-mapping.h>
 #include <linux/random.h>
+#include <linux/slab.h>
 #include <linux/uaccess.h>
 #include <linux/msm_gsi.h>
 #include "gsi.h"
@@ -235,6 +236,9 @@ static void gsi_dump_ch_stats(struct gsi_chan_ctx *ctx)
 		PRT_STAT("compl_evt=%lu\n",
 			ctx->evtr->stats.completed);
 	PRT_STAT("userdata_in_use=%lu\n", ctx->stats.userdata_in_use);
+	PRT_STAT("doorbells=%lu irq_evt=%lu poll_evt=%lu\n",
+		ctx->stats.tlm.doorbells, ctx->stats.tlm.irq_events,
+		ctx->stats.tlm.poll_events);
 
 	PRT_STAT("ch_below_lo=%lu\n", ctx->stats.dp.ch_below_lo);
 	PRT_STAT("ch_below_hi=%lu\n", ctx->stats.dp.ch_below_hi);
@@ -679,6 +683,109 @@ done:
 	return simple_read_from_buffer(buf, count, ppos, dbg_buff, cnt);
 }
 
+static void gsi_tlm_fill_chan(struct gsi_chan_ctx *ctx,
+	struct gsi_tlm_chan *rec)
+{
+	struct gsi_chan_tlm_stats *tlm = &ctx->stats.tlm;
+
+	rec->ch_id = ctx->props.ch_id;
+	rec->evt_id = ctx->evtr ? ctx->evtr->id : GSI_NO_EVT_ERINDEX;
+	if (atomic_read(&ctx->poll_mode) == GSI_CHAN_MODE_POLL)
+		rec->flags |= GSI_TLM_CH_POLL_MODE;
+	if (ctx->props.dir == GSI_CHAN_DIR_FROM_GSI)
+		rec->flags |= GSI_TLM_CH_FROM_GSI;
+	if (ctx->props.prot == GSI_CHAN_PROT_GCI)
+		rec->flags |= GSI_TLM_CH_GCI;
+	rec->ring_elems = ctx->ring.max_num_elem;
+	rec->queued = ctx->stats.queued;
+	rec->completed = ctx->stats.completed;
+	rec->doorbells = tlm->doorbells;
+	rec->irq_events = tlm->irq_events;
+	rec->poll_events = tlm->poll_events;
+	rec->poll_ok = ctx->stats.poll_ok;
+	rec->poll_empty = ctx->stats.poll_empty;
+	rec->callback_to_poll = ctx->stats.callback_to_poll;
+	rec->poll_to_callback = ctx->stats.poll_to_callback;
+	memcpy(rec->lat_hist, tlm->lat_hist, sizeof(rec->lat_hist));
+	memcpy(rec->occ_hist, tlm->occ_hist, sizeof(rec->occ_hist));
+	memcpy(rec->poll_batch_hist, tlm->poll_batch_hist,
+		sizeof(rec->poll_batch_hist));
+	if (ctx->evtr) {
+		rec->evt_doorbells = ctx->evtr->stats.doorbells;
+		rec->evt_irq_passes = ctx->evtr->stats.irq_passes;
+		memcpy(rec->irq_batch_hist, ctx->evtr->stats.irq_batch_hist,
+			sizeof(rec->irq_batch_hist));
+	}
+}
+
+/*
+ * The snapshot is taken at open, so all the reads of one open see the
+ * same counters.
+ */
+static int gsi_tlm_open(struct inode *inode, struct file *file)
+{
+	struct gsi_tlm_hdr *hdr;
+	struct gsi_tlm_chan *rec;
+	int ch_id;
+
+	hdr = kvzalloc(sizeof(*hdr) + gsi_ctx->max_ch * sizeof(*rec),
+		GFP_KERNEL);
+	if (!hdr)
+		return -ENOMEM;
+
+	hdr->magic = GSI_TLM_MAGIC;
+	hdr->version = GSI_TLM_VERSION;
+	hdr->hdr_size = sizeof(*hdr);
+	hdr->rec_size = sizeof(*rec);
+	if (gsi_ctx->tlm_lat)
+		hdr->flags |= GSI_TLM_F_LATENCY;
+	hdr->timestamp_ns = ktime_get_ns();
+
+	rec = (struct gsi_tlm_chan *)(hdr + 1);
+	for (ch_id = 0; ch_id < gsi_ctx->max_ch; ch_id++) {
+		if (!gsi_ctx->chan[ch_id].allocated)
+			continue;
+		gsi_tlm_fill_chan(&gsi_ctx->chan[ch_id], &rec[hdr->num_chan++]);
+	}
+
+	file->private_data = hdr;
+
+	return 0;
+}
+
+static ssize_t gsi_tlm_read(struct file *file,
+	char __user *buf, size_t count, loff_t *ppos)
+{
+	struct gsi_tlm_hdr *hdr = file->private_data;
+
+	return simple_read_from_buffer(buf, count, ppos, hdr,
+		hdr->hdr_size + hdr->num_chan * hdr->rec_size);
+}
+
+static ssize_t gsi_tlm_write(struct file *file,
+	const char __user *buf, size_t count, loff_t *ppos)
+{
+	bool enable;
+	int ret;
+
+	ret = kstrtobool_from_user(buf, count, &enable);
+	if (ret) {
+		TERR("Usage: echo 1 > telemetry to sample latencies, 0 to stop\n");
+		return ret;
+	}
+
+	gsi_ctx->tlm_lat = enable;
+
+	return count;
+}
+
+static int gsi_tlm_release(struct inode *inode, struct file *file)
+{
+	kvfree(file->private_data);
+
+	return 0;
+}
+
 static const struct file_operations gsi_ev_dump_ops = {
 	.write = gsi_dump_evt,
 };
@@ -719,11 +826,19 @@ static const struct file_operations gsi_ver_ops = {
 	.read = gsi_read_gsi_fw_version,
 };
 
+static const struct file_operations gsi_tlm_ops = {
+	.open = gsi_tlm_open,
+	.read = gsi_tlm_read,
+	.write = gsi_tlm_write,
+	.release = gsi_tlm_release,
+};
+
 void gsi_debugfs_init(void)
 {
 	static struct dentry *dfile;
 	const mode_t write_only_mode = 0220;
 	const mode_t read_only_mode = 0440;
+	const mode_t read_write_mode = 0660;
 
 	dent = debugfs_create_dir("gsi", 0);
 	if (IS_ERR(dent)) {
@@ -801,6 +916,13 @@ void gsi_debugfs_init(void)
 		goto fail;
 	}
 
+	dfile = debugfs_create_file("telemetry", read_write_mode, dent, 0,
+				    &gsi_tlm_ops);
+	if (!dfile || IS_ERR(dfile)) {
+		TERR("could not create telemetry\n");
+		goto fail;
+	}
+
 	return;
 
 fail:
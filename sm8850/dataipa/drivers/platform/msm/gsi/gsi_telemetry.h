@@ -0,0 +1,111 @@
+/* SPDX-License-Identifier: GPL-2.0-only WITH Linux-syscall-note */
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef GSI_TELEMETRY_H
+#define GSI_TELEMETRY_H
+
+#include <linux/types.h>
+
+/*
+ * Layout of the gsi/telemetry debugfs file, shared with the userspace
+ * decoder in kernel-tests/gsi_telemetry. A read returns one struct
+ * gsi_tlm_hdr followed by num_chan struct gsi_tlm_chan records, one per
+ * allocated channel, in the CPU's byte order. Fields are only appended,
+ * a reader steps by hdr_size and rec_size and ignores what it does not
+ * know.
+ *
+ * Histograms are log2: bucket 0 counts the value 0, bucket b counts the
+ * values in [2^(b-1), 2^b) and the last bucket also everything above.
+ */
+
+#define GSI_TLM_MAGIC 0x4d4c5447 /* "GTLM" */
+#define GSI_TLM_VERSION 1
+
+#define GSI_TLM_LAT_BUCKETS 32
+#define GSI_TLM_OCC_BUCKETS 16
+#define GSI_TLM_BATCH_BUCKETS 16
+
+/* latencies are counted in units of 2^GSI_TLM_LAT_UNIT_SHIFT ns */
+#define GSI_TLM_LAT_UNIT_SHIFT 10
+
+/* gsi_tlm_hdr.flags */
+#define GSI_TLM_F_LATENCY (1 << 0)
+
+/* gsi_tlm_chan.flags */
+#define GSI_TLM_CH_POLL_MODE (1 << 0)
+#define GSI_TLM_CH_FROM_GSI (1 << 1)
+#define GSI_TLM_CH_GCI (1 << 2)
+
+/**
+ * struct gsi_tlm_hdr - telemetry snapshot header
+ * @magic: GSI_TLM_MAGIC
+ * @version: GSI_TLM_VERSION
+ * @hdr_size: size of this header
+ * @rec_size: size of each channel record
+ * @num_chan: number of channel records following the header
+ * @flags: GSI_TLM_F_*
+ * @timestamp_ns: monotonic time the snapshot was taken
+ */
+struct gsi_tlm_hdr {
+	__u32 magic;
+	__u16 version;
+	__u16 hdr_size;
+	__u16 rec_size;
+	__u16 num_chan;
+	__u32 flags;
+	__u64 timestamp_ns;
+};
+
+/**
+ * struct gsi_tlm_chan - telemetry of one channel and its event ring
+ * @ch_id: channel id
+ * @evt_id: event ring id, 255 when the channel has none
+ * @flags: GSI_TLM_CH_*
+ * @reserved: zero
+ * @ring_elems: usable elements of the transfer ring
+ * @queued: TREs queued
+ * @completed: TREs completed
+ * @doorbells: channel doorbell writes
+ * @irq_events: completion events seen from the IEOB interrupt
+ * @poll_events: completion events consumed by polling
+ * @poll_ok: polls which returned events
+ * @poll_empty: polls which found the event ring empty
+ * @callback_to_poll: switches from interrupt to poll mode
+ * @poll_to_callback: switches from poll to interrupt mode
+ * @evt_doorbells: event ring doorbell writes
+ * @evt_irq_passes: IEOB handler passes over the event ring which found
+ *	events
+ * @lat_hist: time from a doorbell to the driver consuming the completion
+ *	of its last TRE, in interrupt or poll context, sampled only while
+ *	GSI_TLM_F_LATENCY is set
+ * @occ_hist: TREs owned by the H/W once a doorbell lands
+ * @poll_batch_hist: events returned per poll
+ * @irq_batch_hist: events handled per IEOB pass over the event ring,
+ *	shared by the channels of the ring
+ */
+struct gsi_tlm_chan {
+	__u8 ch_id;
+	__u8 evt_id;
+	__u8 flags;
+	__u8 reserved;
+	__u32 ring_elems;
+	__u64 queued;
+	__u64 completed;
+	__u64 doorbells;
+	__u64 irq_events;
+	__u64 poll_events;
+	__u64 poll_ok;
+	__u64 poll_empty;
+	__u64 callback_to_poll;
+	__u64 poll_to_callback;
+	__u64 evt_doorbells;
+	__u64 evt_irq_passes;
+	__u32 lat_hist[GSI_TLM_LAT_BUCKETS];
+	__u32 occ_hist[GSI_TLM_OCC_BUCKETS];
+	__u32 poll_batch_hist[GSI_TLM_BATCH_BUCKETS];
+	__u32 irq_batch_hist[GSI_TLM_BATCH_BUCKETS];
+};
+
+#endif /* GSI_TELEMETRY_H */
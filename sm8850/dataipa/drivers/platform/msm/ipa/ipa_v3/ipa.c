@@ -2988,10 +2988,10 @@ static long ipa3_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
 			retval = -EFAULT;
 			break;
 		}
-		if (ipa3_table_dma_cmd(table_dma_cmd)) {
+		/* -EAGAIN tells the client the request was partially applied */
+		retval = ipa3_table_dma_cmd(table_dma_cmd);
+		if (retval && retval != -EAGAIN)
 			retval = -EFAULT;
-			break;
-		}
 		break;
 
 	case IPA_IOC_V4_DEL_NAT:
@@ -5892,6 +5892,9 @@ int _ipa_init_rt4_v3(void)
 		ipa3_ctx->rt_idx_bitmap[IPA_IP_v4] |= (1 << i);
 	IPADBG("v4 rt bitmap 0x%lx\n", ipa3_ctx->rt_idx_bitmap[IPA_IP_v4]);
 
+	/* SRAM is about to hold empty tables, nothing committed survives */
+	ipa3_rt_invalidate_hw_img(IPA_IP_v4);
+
 	rc = ipahal_rt_generate_empty_img(IPA_MEM_PART(v4_rt_num_index),
 		IPA_MEM_PART(v4_rt_hash_size), IPA_MEM_PART(v4_rt_nhash_size),
 		&mem, false);
@@ -5966,6 +5969,9 @@ int _ipa_init_rt6_v3(void)
 		ipa3_ctx->rt_idx_bitmap[IPA_IP_v6] |= (1 << i);
 	IPADBG("v6 rt bitmap 0x%lx\n", ipa3_ctx->rt_idx_bitmap[IPA_IP_v6]);
 
+	/* SRAM is about to hold empty tables, nothing committed survives */
+	ipa3_rt_invalidate_hw_img(IPA_IP_v6);
+
 	rc = ipahal_rt_generate_empty_img(IPA_MEM_PART(v6_rt_num_index),
 		IPA_MEM_PART(v6_rt_hash_size), IPA_MEM_PART(v6_rt_nhash_size),
 		&mem, false);
@@ -6033,6 +6039,9 @@ int _ipa_init_flt4_v3(void)
 	struct ipahal_imm_cmd_pyld *cmd_pyld;
 	int rc;
 
+	/* SRAM is about to hold empty tables, nothing committed survives */
+	ipa3_flt_invalidate_hw_img(IPA_IP_v4);
+
 	rc = ipahal_flt_generate_empty_img(ipa3_ctx->ep_flt_num,
 		IPA_MEM_PART(v4_flt_hash_size),
 		IPA_MEM_PART(v4_flt_nhash_size), ipa3_ctx->ep_flt_bitmap,
@@ -6101,6 +6110,9 @@ int _ipa_init_flt6_v3(void)
 	struct ipahal_imm_cmd_pyld *cmd_pyld;
 	int rc;
 
+	/* SRAM is about to hold empty tables, nothing committed survives */
+	ipa3_flt_invalidate_hw_img(IPA_IP_v6);
+
 	rc = ipahal_flt_generate_empty_img(ipa3_ctx->ep_flt_num,
 		IPA_MEM_PART(v6_flt_hash_size),
 		IPA_MEM_PART(v6_flt_nhash_size), ipa3_ctx->ep_flt_bitmap,
@@ -6397,12 +6409,21 @@ fail_lan_data_out:
 	if ( ipa3_ctx->clnt_hdl_data_in )
 		ipa3_teardown_sys_pipe(ipa3_ctx->clnt_hdl_data_in);
 fail_flt_hash_tuple:
-	if (ipa3_ctx->dflt_v6_rt_rule_hdl)
+	if (ipa3_ctx->dflt_v6_rt_rule_hdl) {
+		mutex_lock(&ipa3_ctx->rt_tbl_lock[IPA_IP_v6]);
 		__ipa3_del_rt_rule(ipa3_ctx->dflt_v6_rt_rule_hdl);
-	if (ipa3_ctx->dflt_v4_rt_rule_hdl)
+		mutex_unlock(&ipa3_ctx->rt_tbl_lock[IPA_IP_v6]);
+	}
+	if (ipa3_ctx->dflt_v4_rt_rule_hdl) {
+		mutex_lock(&ipa3_ctx->rt_tbl_lock[IPA_IP_v4]);
 		__ipa3_del_rt_rule(ipa3_ctx->dflt_v4_rt_rule_hdl);
-	if (ipa3_ctx->excp_hdr_hdl)
+		mutex_unlock(&ipa3_ctx->rt_tbl_lock[IPA_IP_v4]);
+	}
+	if (ipa3_ctx->excp_hdr_hdl) {
+		mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 		__ipa3_del_hdr(ipa3_ctx->excp_hdr_hdl, false);
+		mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
+	}
 	ipa3_teardown_sys_pipe(ipa3_ctx->clnt_hdl_cmd);
 fail_ch20_wa:
 	return result;
@@ -6414,9 +6435,15 @@ static void ipa3_teardown_apps_pipes(void)
 		ipa3_teardown_sys_pipe(ipa3_ctx->clnt_hdl_data_out);
 	if ( ipa3_ctx->clnt_hdl_data_in )
 		ipa3_teardown_sys_pipe(ipa3_ctx->clnt_hdl_data_in);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[IPA_IP_v6]);
 	__ipa3_del_rt_rule(ipa3_ctx->dflt_v6_rt_rule_hdl);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[IPA_IP_v6]);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[IPA_IP_v4]);
 	__ipa3_del_rt_rule(ipa3_ctx->dflt_v4_rt_rule_hdl);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[IPA_IP_v4]);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	__ipa3_del_hdr(ipa3_ctx->excp_hdr_hdl, false);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	ipa3_teardown_sys_pipe(ipa3_ctx->clnt_hdl_cmd);
 	ipa3_dealloc_common_event_ring();
 }
@@ -8059,6 +8086,8 @@ static int ipa3_post_init(const struct ipa3_plat_drv_res *resource_p,
 
 	INIT_LIST_HEAD(&ipa3_ctx->flt_tbl_nhash_lcl_list[IPA_IP_v4]);
 	INIT_LIST_HEAD(&ipa3_ctx->flt_tbl_nhash_lcl_list[IPA_IP_v6]);
+	ipa3_ctx->flt_full_commit[IPA_IP_v4] = true;
+	ipa3_ctx->flt_full_commit[IPA_IP_v6] = true;
 
 	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
 		if (!ipa_is_ep_support_flt(i))
@@ -8316,6 +8345,7 @@ fail_setup_apps_pipes:
 	gsi_deregister_device(ipa3_ctx->gsi_dev_hdl, false);
 fail_register_device:
 	ipa3_destroy_flt_tbl_idrs();
+	ipa3_rt_destroy_hw_img();
 fail_init_interrupts:
 	ipa3_remove_interrupt_handler(IPA_TX_SUSPEND_IRQ);
 	ipa3_interrupts_destroy(ipa3_res.ipa_irq, &ipa3_ctx->master_pdev->dev);
@@ -9682,8 +9712,12 @@ static int ipa3_pre_init(const struct ipa3_plat_drv_res *resource_p,
 	}
 	INIT_LIST_HEAD(&ipa3_ctx->rt_tbl_set[IPA_IP_v4].head_rt_tbl_list);
 	idr_init(&ipa3_ctx->rt_tbl_set[IPA_IP_v4].rule_ids);
+	hash_init(ipa3_ctx->rt_tbl_set[IPA_IP_v4].name_hash);
+	ipa3_ctx->rt_tbl_set[IPA_IP_v4].full_commit = true;
 	INIT_LIST_HEAD(&ipa3_ctx->rt_tbl_set[IPA_IP_v6].head_rt_tbl_list);
 	idr_init(&ipa3_ctx->rt_tbl_set[IPA_IP_v6].rule_ids);
+	hash_init(ipa3_ctx->rt_tbl_set[IPA_IP_v6].name_hash);
+	ipa3_ctx->rt_tbl_set[IPA_IP_v6].full_commit = true;
 
 	rset = &ipa3_ctx->reap_rt_tbl_set[IPA_IP_v4];
 	INIT_LIST_HEAD(&rset->head_rt_tbl_list);
@@ -11972,6 +12006,8 @@ static void ipa3_deepsleep_suspend(void)
 	gsi_deregister_device(ipa3_ctx->gsi_dev_hdl, false);
 	/*Destroying filter table ids*/
 	ipa3_destroy_flt_tbl_idrs();
+	/*Freeing the kept routing table images*/
+	ipa3_rt_destroy_hw_img();
 	/*Disabling IPA interrupt*/
 	ipa3_remove_interrupt_handler(IPA_TX_SUSPEND_IRQ);
 	ipa3_interrupts_destroy(ipa3_res.ipa_irq, &ipa3_ctx->master_pdev->dev);
@@ -12444,6 +12480,30 @@ uint ipa3_get_emulation_type(void)
 	return emulation_type;
 }
 
+/*
+ * Each family gets its own lockdep class, so that lockdep reports an
+ * inversion of the rule database lock order documented in ipa3_context
+ * instead of folding both families into one class.
+ */
+static void ipa3_init_rule_db_locks(void)
+{
+	static struct lock_class_key flt_key[IPA_IP_MAX];
+	static struct lock_class_key rt_key[IPA_IP_MAX];
+	static const char * const flt_name[IPA_IP_MAX] = {
+		"ipa_flt_tbl_lock_v4", "ipa_flt_tbl_lock_v6" };
+	static const char * const rt_name[IPA_IP_MAX] = {
+		"ipa_rt_tbl_lock_v4", "ipa_rt_tbl_lock_v6" };
+	int ip;
+
+	for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++) {
+		__mutex_init(&ipa3_ctx->flt_tbl_lock[ip], flt_name[ip],
+			&flt_key[ip]);
+		__mutex_init(&ipa3_ctx->rt_tbl_lock[ip], rt_name[ip],
+			&rt_key[ip]);
+	}
+	mutex_init(&ipa3_ctx->hdr_tbl_lock);
+}
+
 static int __init ipa_module_init(void)
 {
 	pr_debug("IPA module init\n");
@@ -12453,6 +12513,7 @@ static int __init ipa_module_init(void)
 		return -ENOMEM;
 	}
 	mutex_init(&ipa3_ctx->lock);
+	ipa3_init_rule_db_locks();
 
 	if (running_emulation) {
 		/* Register as a PCI device driver */
@@ -12467,13 +12528,11 @@ subsys_initcall(ipa_module_init);
 
 static void __exit ipa_module_exit(void)
 {
+	/* the harvester DMAs through the device, stop it while it is bound */
+	ipa_hw_stats_destroy();
 	if (running_emulation)
 		pci_unregister_driver(&ipa_pci_driver);
 	platform_driver_unregister(&ipa_plat_drv);
-	if(ipa3_ctx->hw_stats) {
-		kfree(ipa3_ctx->hw_stats);
-		ipa3_ctx->hw_stats = NULL;
-	}
 	unregister_pm_notifier(&ipa_pm_notifier);
 	kfree(ipa3_ctx);
 	ipa3_ctx = NULL;
@@ -742,7 +742,7 @@ static ssize_t ipa3_read_hdr(struct file *file, char __user *ubuf, size_t count,
 	struct ipa_hdr_offset_entry *offset_entry;
 	unsigned int offset_count;
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 
 	for (hdr_tbl = HDR_TBL_LCL; hdr_tbl < HDR_TBLS_TOTAL; hdr_tbl++) {
 		if (hdr_tbl == HDR_TBL_LCL)
@@ -808,7 +808,7 @@ static ssize_t ipa3_read_hdr(struct file *file, char __user *ubuf, size_t count,
 			pr_err("%s", dbg_buff);
 		}
 	}
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 
 	return 0;
 }
@@ -1084,7 +1084,8 @@ static ssize_t ipa3_read_rt(struct file *file, char __user *ubuf, size_t count,
 
 	set = &ipa3_ctx->rt_tbl_set[ip];
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 
 	pr_err("==== Routing Tables Start ====\n");
 	if (ipa3_ctx->rt_tbl_hash_lcl[ip])
@@ -1149,7 +1150,8 @@ static ssize_t ipa3_read_rt(struct file *file, char __user *ubuf, size_t count,
 		}
 	}
 	pr_err("==== Routing Tables End ====\n");
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 
 	return 0;
 }
@@ -1186,7 +1188,7 @@ static ssize_t ipa3_read_rt_hw(struct file *file, char __user *ubuf,
 	}
 
 	IPA_ACTIVE_CLIENTS_INC_SIMPLE();
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
 
 	for (tbl = 0 ; tbl < tbls_num ; tbl++) {
 		pr_err("=== Routing Table %d = Hashable Rules ===\n", tbl);
@@ -1266,7 +1268,7 @@ static ssize_t ipa3_read_rt_hw(struct file *file, char __user *ubuf,
 	}
 
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 	IPA_ACTIVE_CLIENTS_DEC_SIMPLE();
 	kfree(rules);
 	return res;
@@ -1282,7 +1284,7 @@ static ssize_t ipa3_read_proc_ctx(struct file *file, char __user *ubuf,
 
 	tbl = &ipa3_ctx->hdr_proc_ctx_tbl;
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 
 	if (ipa3_ctx->hdr_proc_ctx_tbl_lcl)
 		pr_info("Table resides on local memory\n");
@@ -1304,7 +1306,7 @@ static ssize_t ipa3_read_proc_ctx(struct file *file, char __user *ubuf,
 			"hdr[words]:%u\n",
 			entry->hdr->offset_entry->offset >> 2);
 	}
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 
 	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, nbytes);
 }
@@ -1323,7 +1325,8 @@ static ssize_t ipa3_read_flt(struct file *file, char __user *ubuf, size_t count,
 	bool eq;
 	int res = 0;
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[ip]);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
 
 	pr_err("==== Filtering Tables Start ====\n");
 	if (ipa3_ctx->flt_tbl_hash_lcl[ip])
@@ -1399,7 +1402,8 @@ static ssize_t ipa3_read_flt(struct file *file, char __user *ubuf, size_t count,
 	}
 bail:
 	pr_err("==== Filtering Tables End ====\n");
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[ip]);
 
 	return res;
 }
@@ -1424,7 +1428,7 @@ static ssize_t ipa3_read_flt_hw(struct file *file, char __user *ubuf,
 		return -ENOMEM;
 
 	IPA_ACTIVE_CLIENTS_INC_SIMPLE();
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[ip]);
 
 	if (ipa3_ctx->flt_tbl_hash_lcl[ip])
 		pr_err("Hashable table resides on local memory\n");
@@ -1513,7 +1517,7 @@ static ssize_t ipa3_read_flt_hw(struct file *file, char __user *ubuf,
 	}
 
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[ip]);
 	kfree(rules);
 	IPA_ACTIVE_CLIENTS_DEC_SIMPLE();
 	return res;
@@ -2696,6 +2700,49 @@ bail:
 	return 0;
 }
 
+static ssize_t ipa3_read_table_dma_stats(struct file *file,
+	char __user *ubuf, size_t count, loff_t *ppos)
+{
+	struct ipa3_nat_ipv6ct_common_mem *dev = &ipa3_ctx->nat_mem.dev;
+	struct ipa3_table_dma_stats stats;
+	int nbytes;
+
+	if (!dev->is_dev_init) {
+		nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
+			"NAT hasn't been initialized or not supported\n");
+		return simple_read_from_buffer(ubuf, count, ppos, dbg_buff,
+			nbytes);
+	}
+
+	mutex_lock(&dev->lock);
+	stats = ipa3_ctx->nat_mem.table_dma_stats;
+	mutex_unlock(&dev->lock);
+
+	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
+		"batches=%llu\n"
+		"entries=%llu\n"
+		"coalesced=%llu\n"
+		"cmds=%llu\n"
+		"chains=%llu\n"
+		"max_entries=%u\n"
+		"fails=%llu\n"
+		"partial=%llu\n"
+		"total_us=%llu\n"
+		"avg_us_per_batch=%llu\n",
+		stats.batches,
+		stats.entries,
+		stats.coalesced,
+		stats.cmds,
+		stats.chains,
+		stats.max_entries,
+		stats.fails,
+		stats.partial,
+		stats.total_us,
+		stats.batches ? div64_u64(stats.total_us, stats.batches) : 0);
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, nbytes);
+}
+
 static ssize_t ipa3_pm_read_stats(struct file *file, char __user *ubuf,
 		size_t count, loff_t *ppos)
 {
@@ -3844,6 +3891,10 @@ static const struct ipa3_debugfs_file debugfs_files[] = {
 		"ipv6ct", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_read_ipv6ct,
 		}
+	}, {
+		"table_dma_stats", IPA_READ_ONLY_MODE, NULL, {
+			.read = ipa3_read_table_dma_stats,
+		}
 	}, {
 		"pm_stats", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_pm_read_stats,
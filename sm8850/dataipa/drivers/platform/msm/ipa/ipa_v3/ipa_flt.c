@@ -127,6 +127,7 @@ static int ipa_prep_flt_tbl_for_cmt(enum ipa_ip_type ip,
 	struct ipa3_flt_entry *entry;
 	int prio_i;
 	int max_prio;
+	int prio;
 	u32 hdr_width;
 
 	tbl->sz[IPA_RULE_HASHABLE] = 0;
@@ -138,14 +139,23 @@ static int ipa_prep_flt_tbl_for_cmt(enum ipa_ip_type ip,
 	list_for_each_entry(entry, &tbl->head_flt_rule_list, link) {
 
 		if (entry->rule.max_prio) {
-			entry->prio = max_prio;
+			prio = max_prio;
 		} else {
 			if (ipahal_rule_decrease_priority(&prio_i)) {
 				IPAERR("cannot decrease rule priority - %d\n",
 					prio_i);
 				return -EPERM;
 			}
-			entry->prio = prio_i;
+			prio = prio_i;
+		}
+
+		/*
+		 * priorities run across both rule types, a change in one
+		 * type may shift the rules of the other
+		 */
+		if (entry->prio != prio) {
+			entry->prio = prio;
+			tbl->dirty[IPA_FLT_GET_RULE_TYPE(entry)] = true;
 		}
 
 		if (ipa3_generate_flt_hw_rule(ip, entry, NULL)) {
@@ -191,6 +201,13 @@ static int ipa_prep_flt_tbl_for_cmt(enum ipa_ip_type ip,
  * @hdr: the rules header (addresses/offsets) buffer to be filled
  * @body_ofst: the offset of the rules body from the rules header at
  *  ipa sram
+ * @lcl_dirty_ofst: [out] offset in @base of the first local body byte that
+ *  differs from the last committed image, U32_MAX if none does
+ *
+ * Tables with no change of this rule type since the last commit are not
+ * rendered again: a system body is pointed at as is and a local body is
+ * copied from the image the last commit wrote. Tables whose hdr entry or
+ * local body has to reach sram are marked stale.
  *
  * Returns: 0 on success, negative on failure
  *
@@ -198,7 +215,8 @@ static int ipa_prep_flt_tbl_for_cmt(enum ipa_ip_type ip,
  *
  */
 static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
-	enum ipa_rule_type rlt, u8 *base, u8 *hdr, u32 body_ofst)
+	enum ipa_rule_type rlt, u8 *base, u8 *hdr, u32 body_ofst,
+	u32 *lcl_dirty_ofst)
 {
 	u64 offset;
 	u8 *body_i;
@@ -206,23 +224,48 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 	struct ipa3_flt_entry *entry;
 	u8 *tbl_mem_buf;
 	struct ipa_mem_buffer tbl_mem;
+	struct ipa_mem_buffer *img;
 	struct ipa3_flt_tbl *tbl;
 	int i;
 	int hdr_idx = 0;
+	u32 bdy_sz;
+	u32 lcl_ofst;
+	bool is_sys;
+	bool reuse;
 
+	img = &ipa3_ctx->flt_lcl_img[ip][rlt];
+	*lcl_dirty_ofst = U32_MAX;
 	body_i = base;
 	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
 		if (!ipa_is_ep_support_flt(i))
 			continue;
 		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		reuse = !tbl->dirty[rlt] && !ipa3_ctx->flt_full_commit[ip];
 		if (tbl->sz[rlt] == 0) {
+			if (!reuse)
+				tbl->stale[rlt] = true;
 			hdr_idx++;
 			continue;
 		}
-		if (tbl->in_sys[rlt] || tbl->force_sys[rlt]) {
+		bdy_sz = tbl->sz[rlt] - ipahal_get_hw_tbl_hdr_width();
+		is_sys = tbl->in_sys[rlt] || tbl->force_sys[rlt];
+		if (tbl->cmt_sys[rlt] != is_sys) {
+			tbl->cmt_sys[rlt] = is_sys;
+			reuse = false;
+		}
+		if (is_sys && reuse && tbl->curr_mem[rlt].phys_base &&
+			tbl->curr_mem[rlt].size == bdy_sz +
+			ipahal_get_hw_prefetch_buf_size()) {
+			if (ipahal_fltrt_write_addr_to_hdr(
+				tbl->curr_mem[rlt].phys_base, hdr, hdr_idx,
+				true)) {
+				IPAERR("fail to wrt sys tbl addr to hdr\n");
+				goto err;
+			}
+		} else if (is_sys) {
+			tbl->stale[rlt] = true;
 			/* only body (no header) */
-			tbl_mem.size = tbl->sz[rlt] -
-				ipahal_get_hw_tbl_hdr_width();
+			tbl_mem.size = bdy_sz;
 			/* Add prefetech buf size. */
 			tbl_mem.size +=
 				ipahal_get_hw_prefetch_buf_size();
@@ -260,7 +303,8 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 			}
 			tbl->curr_mem[rlt] = tbl_mem;
 		} else {
-			offset = body_i - base + body_ofst;
+			lcl_ofst = body_i - base;
+			offset = lcl_ofst + body_ofst;
 
 			/* update the hdr at the right index */
 			if (ipahal_fltrt_write_addr_to_hdr(offset, hdr,
@@ -269,19 +313,36 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 				goto hdr_update_fail;
 			}
 
-			/* generate the rule-set */
-			list_for_each_entry(entry, &tbl->head_flt_rule_list,
-				link) {
-				if (IPA_FLT_GET_RULE_TYPE(entry) != rlt)
-					continue;
-				res = ipa3_generate_flt_hw_rule(
-					ip, entry, body_i);
-				if (res) {
-					IPAERR("failed to gen HW FLT rule\n");
-					goto err;
+			if (reuse && img->base &&
+				tbl->lcl_ofst[rlt] + bdy_sz <= img->size) {
+				memcpy(body_i, img->base + tbl->lcl_ofst[rlt],
+					bdy_sz);
+				body_i += bdy_sz;
+			} else {
+				/* generate the rule-set */
+				list_for_each_entry(entry,
+					&tbl->head_flt_rule_list, link) {
+					if (IPA_FLT_GET_RULE_TYPE(entry) != rlt)
+						continue;
+					res = ipa3_generate_flt_hw_rule(
+						ip, entry, body_i);
+					if (res) {
+						IPAERR(
+						"failed to gen HW FLT rule\n");
+						goto err;
+					}
+					body_i += entry->hw_len;
 				}
-				body_i += entry->hw_len;
+				reuse = false;
+			}
+
+			/* a moved body has to be written again as well */
+			if (!reuse || tbl->lcl_ofst[rlt] != lcl_ofst) {
+				tbl->stale[rlt] = true;
+				if (lcl_ofst < *lcl_dirty_ofst)
+					*lcl_dirty_ofst = lcl_ofst;
 			}
+			tbl->lcl_ofst[rlt] = lcl_ofst;
 
 			/**
 			 * advance body_i to next table alignment as local
@@ -309,11 +370,14 @@ err:
  * @ip: the ip address family type
  * @alloc_params: In and Out parameters for the allocations of the buffers
  *  4 buffers: hdr and bdy, each hashable and non-hashable
+ * @hash_dirty_ofst: [out] first changed byte of the hashable local bodies
+ * @nhash_dirty_ofst: [out] first changed byte of the non-hashable local bodies
  *
  * Return: 0 on success, negative on failure
  */
 static int ipa_generate_flt_hw_tbl_img(enum ipa_ip_type ip,
-	struct ipahal_fltrt_alloc_imgs_params *alloc_params)
+	struct ipahal_fltrt_alloc_imgs_params *alloc_params,
+	u32 *hash_dirty_ofst, u32 *nhash_dirty_ofst)
 {
 	u32 hash_bdy_start_ofst, nhash_bdy_start_ofst;
 	int rc = 0;
@@ -338,14 +402,14 @@ static int ipa_generate_flt_hw_tbl_img(enum ipa_ip_type ip,
 
 	if (ipa_translate_flt_tbl_to_hw_fmt(ip, IPA_RULE_HASHABLE,
 		alloc_params->hash_bdy.base, alloc_params->hash_hdr.base,
-		hash_bdy_start_ofst)) {
+		hash_bdy_start_ofst, hash_dirty_ofst)) {
 		IPAERR_RL("fail to translate hashable flt tbls to hw format\n");
 		rc = -EPERM;
 		goto translate_fail;
 	}
 	if (ipa_translate_flt_tbl_to_hw_fmt(ip, IPA_RULE_NON_HASHABLE,
 		alloc_params->nhash_bdy.base, alloc_params->nhash_hdr.base,
-		nhash_bdy_start_ofst)) {
+		nhash_bdy_start_ofst, nhash_dirty_ofst)) {
 		IPAERR_RL("fail to translate non-hash flt tbls to hw format\n");
 		rc = -EPERM;
 		goto translate_fail;
@@ -470,6 +534,34 @@ static bool ipa_flt_skip_pipe_config(int pipe)
 	return false;
 }
 
+/**
+ * ipa_flt_keep_lcl_img() - keep the local bodies just written to sram so the
+ *  next commit can copy unchanged tables out of them
+ * @img: the kept image of the previous commit, released
+ * @bdy: the bodies of this commit, ownership moves to @img
+ */
+static void ipa_flt_keep_lcl_img(struct ipa_mem_buffer *img,
+	struct ipa_mem_buffer *bdy)
+{
+	if (img->size)
+		ipahal_free_dma_mem(img);
+	*img = *bdy;
+	memset(bdy, 0, sizeof(*bdy));
+}
+
+/**
+ * ipa3_flt_invalidate_hw_img() - forget what the last commit wrote to the hw
+ *  so the next commit renders and writes every pipe table again
+ * @ip: the ip address family type
+ *
+ * To be called whenever the flt sram is written outside of
+ * __ipa_commit_flt_v3(), e.g. on flt block init.
+ */
+void ipa3_flt_invalidate_hw_img(enum ipa_ip_type ip)
+{
+	ipa3_ctx->flt_full_commit[ip] = true;
+}
+
 /**
  * __ipa_commit_flt_v3() - commit flt tables to the hw
  *  commit the headers and the bodies if are local with internal cache flushing.
@@ -477,6 +569,11 @@ static bool ipa_flt_skip_pipe_config(int pipe)
  *  then written via IC to the SRAM
  * @ipt: the ip address family type
  *
+ * Only pipes whose tables changed since the last commit, per hashable and
+ * non-hashable type, are rendered again and get their hdr entry written. The
+ * local bodies are written from the first table that changed or moved. When
+ * nothing changed no command is sent at all.
+ *
  * Return: 0 on success, negative on failure
  */
 int __ipa_commit_flt_v3(enum ipa_ip_type ip)
@@ -499,6 +596,11 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 	struct ipa3_flt_tbl_nhash_lcl *lcl_tbl;
 	u16 entries;
 	struct ipahal_imm_cmd_register_write reg_write_coal_close;
+	u32 hash_dirty_ofst, nhash_dirty_ofst;
+	int num_write = 0;
+	bool committed = false;
+
+	lockdep_assert_held(&ipa3_ctx->flt_tbl_lock[ip]);
 
 	tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
 	memset(&alloc_params, 0, sizeof(alloc_params));
@@ -533,11 +635,17 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		lcl_nhash = ipa3_ctx->flt_tbl_nhash_lcl[IPA_IP_v6];
 	}
 
+	/* the rules are rendered with the index of the rt tbl they point to */
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
 	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
 		if (!ipa_is_ep_support_flt(i))
 			continue;
 		tbl = &ipa3_ctx->flt_tbl[i][ip];
-		if (ipa_prep_flt_tbl_for_cmt(ip, tbl, i)) {
+		if ((tbl->dirty[IPA_RULE_HASHABLE] ||
+			tbl->dirty[IPA_RULE_NON_HASHABLE] ||
+			ipa3_ctx->flt_full_commit[ip]) &&
+			ipa_prep_flt_tbl_for_cmt(ip, tbl, i)) {
+			mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 			rc = -EPERM;
 			goto prep_failed;
 		}
@@ -567,6 +675,7 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 			alloc_params.total_sz_lcl_hash_tbls))) {
 		IPAERR_RL("Hash filter table for IP:%d too big to fit in lcl memory\n",
 			ip);
+		mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 		rc = -EFAULT;
 		goto fail_size_valid;
 	}
@@ -591,11 +700,14 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		alloc_params.total_sz_lcl_nhash_tbls += tbl_hdr_width;
 	}
 
-	if (ipa_generate_flt_hw_tbl_img(ip, &alloc_params)) {
+	if (ipa_generate_flt_hw_tbl_img(ip, &alloc_params,
+		&hash_dirty_ofst, &nhash_dirty_ofst)) {
 		IPAERR_RL("fail to generate FLT HW TBL image. IP %d\n", ip);
+		mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 		rc = -EFAULT;
 		goto prep_failed;
 	}
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 
 	/* +4: 2 for bodies (hashable and non-hashable), 1 for flushing and 1
 	 * for closing the colaescing frame
@@ -694,6 +806,14 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 			continue;
 		}
 
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		if (!tbl->stale[IPA_RULE_NON_HASHABLE] &&
+			(!tbl->stale[IPA_RULE_HASHABLE] ||
+			ipa3_ctx->ipa_fltrt_not_hashable)) {
+			hdr_idx++;
+			continue;
+		}
+
 		if (num_cmd + 1 >= entries) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -704,30 +824,36 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		IPADBG_LOW("Prepare imm cmd for hdr at index %d for pipe %d\n",
 			hdr_idx, i);
 
-		mem_cmd.is_read = false;
-		mem_cmd.skip_pipeline_clear = false;
-		mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-		mem_cmd.size = tbl_hdr_width;
-		mem_cmd.system_addr = alloc_params.nhash_hdr.phys_base +
-			hdr_idx * tbl_hdr_width;
-		mem_cmd.local_addr = lcl_nhash_hdr +
-			hdr_idx * tbl_hdr_width;
-		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-			IPA_IMM_CMD_DMA_SHARED_MEM, &mem_cmd, false);
-		if (!cmd_pyld[num_cmd]) {
-			IPAERR("fail construct dma_shared_mem cmd: IP = %d\n",
-				ip);
-			rc = -ENOMEM;
-			goto fail_imm_cmd_construct;
+		if (tbl->stale[IPA_RULE_NON_HASHABLE]) {
+			mem_cmd.is_read = false;
+			mem_cmd.skip_pipeline_clear = false;
+			mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+			mem_cmd.size = tbl_hdr_width;
+			mem_cmd.system_addr = alloc_params.nhash_hdr.phys_base +
+				hdr_idx * tbl_hdr_width;
+			mem_cmd.local_addr = lcl_nhash_hdr +
+				hdr_idx * tbl_hdr_width;
+			cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
+				IPA_IMM_CMD_DMA_SHARED_MEM, &mem_cmd, false);
+			if (!cmd_pyld[num_cmd]) {
+				IPAERR(
+				"fail construct dma_shared_mem cmd: IP = %d\n",
+					ip);
+				rc = -ENOMEM;
+				goto fail_imm_cmd_construct;
+			}
+			ipa3_init_imm_cmd_desc(&desc[num_cmd],
+						cmd_pyld[num_cmd]);
+			++num_cmd;
+			++num_write;
 		}
-		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-		++num_cmd;
 
 		/*
 		 * SRAM memory not allocated to hash tables. Sending command
 		 * to hash tables(filer/routing) operation not supported.
 		 */
-		if (!ipa3_ctx->ipa_fltrt_not_hashable) {
+		if (!ipa3_ctx->ipa_fltrt_not_hashable &&
+			tbl->stale[IPA_RULE_HASHABLE]) {
 			mem_cmd.is_read = false;
 			mem_cmd.skip_pipeline_clear = false;
 			mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
@@ -749,11 +875,13 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 			ipa3_init_imm_cmd_desc(&desc[num_cmd],
 						cmd_pyld[num_cmd]);
 			++num_cmd;
+			++num_write;
 		}
 		++hdr_idx;
 	}
 
-	if (lcl_nhash && alloc_params.num_lcl_nhash_tbls > 0) {
+	if (lcl_nhash && alloc_params.num_lcl_nhash_tbls > 0 &&
+		nhash_dirty_ofst < alloc_params.nhash_bdy.size) {
 		if (num_cmd >= entries) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -761,12 +889,15 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 			goto fail_imm_cmd_construct;
 		}
 
+		IPADBG_LOW("nhash bdy write from ofst %u of %u\n",
+			nhash_dirty_ofst, alloc_params.nhash_bdy.size);
 		mem_cmd.is_read = false;
 		mem_cmd.skip_pipeline_clear = false;
 		mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-		mem_cmd.size = alloc_params.nhash_bdy.size;
-		mem_cmd.system_addr = alloc_params.nhash_bdy.phys_base;
-		mem_cmd.local_addr = lcl_nhash_bdy;
+		mem_cmd.size = alloc_params.nhash_bdy.size - nhash_dirty_ofst;
+		mem_cmd.system_addr = alloc_params.nhash_bdy.phys_base +
+			nhash_dirty_ofst;
+		mem_cmd.local_addr = lcl_nhash_bdy + nhash_dirty_ofst;
 		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
 			IPA_IMM_CMD_DMA_SHARED_MEM, &mem_cmd, false);
 		if (!cmd_pyld[num_cmd]) {
@@ -777,8 +908,9 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		}
 		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
 		++num_cmd;
+		++num_write;
 	}
-	if (lcl_hash) {
+	if (lcl_hash && hash_dirty_ofst < alloc_params.hash_bdy.size) {
 		if (num_cmd >= entries) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -786,12 +918,15 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 			goto fail_imm_cmd_construct;
 		}
 
+		IPADBG_LOW("hash bdy write from ofst %u of %u\n",
+			hash_dirty_ofst, alloc_params.hash_bdy.size);
 		mem_cmd.is_read = false;
 		mem_cmd.skip_pipeline_clear = false;
 		mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-		mem_cmd.size = alloc_params.hash_bdy.size;
-		mem_cmd.system_addr = alloc_params.hash_bdy.phys_base;
-		mem_cmd.local_addr = lcl_hash_bdy;
+		mem_cmd.size = alloc_params.hash_bdy.size - hash_dirty_ofst;
+		mem_cmd.system_addr = alloc_params.hash_bdy.phys_base +
+			hash_dirty_ofst;
+		mem_cmd.local_addr = lcl_hash_bdy + hash_dirty_ofst;
 		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
 			IPA_IMM_CMD_DMA_SHARED_MEM, &mem_cmd, false);
 		if (!cmd_pyld[num_cmd]) {
@@ -802,6 +937,13 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		}
 		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
 		++num_cmd;
+		++num_write;
+	}
+
+	/* nothing changed, no need to flush or close the coal frame */
+	if (!num_write) {
+		IPADBG_LOW("flt tbls unchanged, nothing to send. IP %d\n", ip);
+		goto commit_done;
 	}
 
 	remaining_num_cmd = num_cmd;
@@ -847,9 +989,29 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 			alloc_params.nhash_bdy.size);
 	}
 
+commit_done:
 	__ipa_reap_sys_flt_tbls(ip, IPA_RULE_HASHABLE);
 	__ipa_reap_sys_flt_tbls(ip, IPA_RULE_NON_HASHABLE);
 
+	/* sram now matches the sw tables, except for the skipped pipes */
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		tbl->dirty[IPA_RULE_HASHABLE] = false;
+		tbl->dirty[IPA_RULE_NON_HASHABLE] = false;
+		if (ipa_flt_skip_pipe_config(i))
+			continue;
+		tbl->stale[IPA_RULE_HASHABLE] = false;
+		tbl->stale[IPA_RULE_NON_HASHABLE] = false;
+	}
+	ipa_flt_keep_lcl_img(&ipa3_ctx->flt_lcl_img[ip][IPA_RULE_HASHABLE],
+		&alloc_params.hash_bdy);
+	ipa_flt_keep_lcl_img(&ipa3_ctx->flt_lcl_img[ip][IPA_RULE_NON_HASHABLE],
+		&alloc_params.nhash_bdy);
+	ipa3_ctx->flt_full_commit[ip] = false;
+	committed = true;
+
 fail_imm_cmd_construct:
 	for (i = 0 ; i < num_cmd ; i++)
 		ipahal_destroy_imm_cmd(cmd_pyld[i]);
@@ -865,6 +1027,9 @@ fail_size_valid:
 	if (alloc_params.nhash_bdy.size)
 		ipahal_free_dma_mem(&alloc_params.nhash_bdy);
 prep_failed:
+	/* the local body offsets may no longer match what is in sram */
+	if (!committed)
+		ipa3_flt_invalidate_hw_img(ip);
 	return rc;
 }
 
@@ -873,6 +1038,8 @@ static int __ipa_validate_flt_rule(const struct ipa_flt_rule_i *rule,
 {
 	int index;
 
+	lockdep_assert_held(&ipa3_ctx->rt_tbl_lock[ip]);
+
 	if (rule->action != IPA_PASS_TO_EXCEPTION) {
 		if (!rule->eq_attrib_type) {
 			if (!rule->rt_tbl_hdl) {
@@ -880,6 +1047,11 @@ static int __ipa_validate_flt_rule(const struct ipa_flt_rule_i *rule,
 				goto error;
 			}
 
+			if (ipa3_id_ip(rule->rt_tbl_hdl) != ip) {
+				IPAERR_RL("RT tbl is not of ip family %d\n", ip);
+				goto error;
+			}
+
 			*rt_tbl = ipa3_id_find(rule->rt_tbl_hdl);
 			if (*rt_tbl == NULL) {
 				IPAERR_RL("RT tbl not found\n");
@@ -1001,17 +1173,19 @@ error:
 }
 
 static int __ipa_finish_flt_rule_add(struct ipa3_flt_tbl *tbl,
-		struct ipa3_flt_entry *entry, u32 *rule_hdl)
+		struct ipa3_flt_entry *entry, u32 *rule_hdl, enum ipa_ip_type ip)
 {
 	int id;
 
+	/* the rule is already linked, even a failed add reorders the table */
+	tbl->dirty[IPA_FLT_GET_RULE_TYPE(entry)] = true;
 	if (tbl->rule_cnt < IPA_RULE_CNT_MAX)
 		tbl->rule_cnt++;
 	else
 		return -EINVAL;
 	if (entry->rt_tbl)
 		entry->rt_tbl->ref_cnt++;
-	id = ipa3_id_alloc(entry);
+	id = ipa3_id_alloc_ip(entry, ip);
 	if (id < 0) {
 		IPAERR_RL("failed to add to tree\n");
 		WARN_ON_RATELIMIT_IPA(1);
@@ -1036,6 +1210,10 @@ static int __ipa_add_flt_rule(struct ipa3_flt_tbl *tbl, enum ipa_ip_type ip,
 	struct ipa3_flt_entry *entry;
 	struct ipa3_rt_tbl *rt_tbl = NULL;
 
+	lockdep_assert_held(&ipa3_ctx->flt_tbl_lock[ip]);
+
+	/* the rt tbl has to stay around until the rule holds a ref on it */
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
 	if (__ipa_validate_flt_rule(rule, &rt_tbl, ip))
 		goto error;
 
@@ -1052,9 +1230,10 @@ static int __ipa_add_flt_rule(struct ipa3_flt_tbl *tbl, enum ipa_ip_type ip,
 		list_add(&entry->link, &tbl->head_flt_rule_list);
 	}
 
-	if (__ipa_finish_flt_rule_add(tbl, entry, rule_hdl))
+	if (__ipa_finish_flt_rule_add(tbl, entry, rule_hdl, ip))
 		goto ipa_insert_failed;
 
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 	return 0;
 ipa_insert_failed:
 	list_del(&entry->link);
@@ -1065,6 +1244,7 @@ ipa_insert_failed:
 	kmem_cache_free(ipa3_ctx->flt_rule_cache, entry);
 
 error:
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 	return -EPERM;
 }
 
@@ -1086,16 +1266,20 @@ static int __ipa_add_flt_rule_after(struct ipa3_flt_tbl *tbl,
 		goto error;
 	}
 
+	lockdep_assert_held(&ipa3_ctx->flt_tbl_lock[ip]);
+
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
 	if (__ipa_validate_flt_rule(rule, &rt_tbl, ip))
-		goto error;
+		goto unlock;
 
 	if (__ipa_create_flt_entry(&entry, rule, rt_tbl, tbl, true))
-		goto error;
+		goto unlock;
 
 	list_add(&entry->link, &((*add_after_entry)->link));
 
-	if (__ipa_finish_flt_rule_add(tbl, entry, rule_hdl))
+	if (__ipa_finish_flt_rule_add(tbl, entry, rule_hdl, ip))
 		goto ipa_insert_failed;
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 
 	/*
 	 * prepare for next insertion
@@ -1112,6 +1296,8 @@ ipa_insert_failed:
 		idr_remove(entry->tbl->rule_ids, entry->rule_id);
 	kmem_cache_free(ipa3_ctx->flt_rule_cache, entry);
 
+unlock:
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 error:
 	*add_after_entry = NULL;
 	return -EPERM;
@@ -1120,8 +1306,11 @@ error:
 static int __ipa_del_flt_rule(u32 rule_hdl)
 {
 	struct ipa3_flt_entry *entry;
+	enum ipa_ip_type ip = ipa3_id_ip(rule_hdl);
 	int id;
 
+	lockdep_assert_held(&ipa3_ctx->flt_tbl_lock[ip]);
+
 	entry = ipa3_id_find(rule_hdl);
 	if (entry == NULL) {
 		IPAERR_RL("lookup failed\n");
@@ -1135,9 +1324,12 @@ static int __ipa_del_flt_rule(u32 rule_hdl)
 	id = entry->id;
 
 	list_del(&entry->link);
+	entry->tbl->dirty[IPA_FLT_GET_RULE_TYPE(entry)] = true;
 	entry->tbl->rule_cnt--;
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
 	if (entry->rt_tbl && !ipa3_check_idr_if_freed(entry->rt_tbl))
 		entry->rt_tbl->ref_cnt--;
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 	IPADBG("del flt rule rule_cnt=%d rule_id=%d\n",
 		entry->tbl->rule_cnt, entry->rule_id);
 	entry->cookie = 0;
@@ -1160,24 +1352,38 @@ static int __ipa_mdfy_flt_rule(struct ipa_flt_rule_mdfy_i *frule,
 	struct ipa3_flt_entry *entry;
 	struct ipa3_rt_tbl *rt_tbl = NULL;
 
+	lockdep_assert_held(&ipa3_ctx->flt_tbl_lock[ip]);
+
+	if (ipa3_id_ip(frule->rule_hdl) != ip) {
+		IPAERR_RL("rule is not of ip family %d\n", ip);
+		return -EPERM;
+	}
+
 	entry = ipa3_id_find(frule->rule_hdl);
 	if (entry == NULL) {
 		IPAERR_RL("lookup failed\n");
-		goto error;
+		return -EPERM;
 	}
 
 	if (entry->cookie != IPA_FLT_COOKIE) {
 		IPAERR_RL("bad params\n");
-		goto error;
+		return -EPERM;
 	}
 
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
 	if (__ipa_validate_flt_rule(&frule->rule, &rt_tbl, ip))
 		goto error;
 
 	if (entry->rt_tbl)
 		entry->rt_tbl->ref_cnt--;
 
+	/*
+	 * The modification may move the rule between the hashable and non
+	 * hashable tables, both the old and the new one need a rebuild.
+	 */
+	entry->tbl->dirty[IPA_FLT_GET_RULE_TYPE(entry)] = true;
 	entry->rule = frule->rule;
+	entry->tbl->dirty[IPA_FLT_GET_RULE_TYPE(entry)] = true;
 	entry->rt_tbl = rt_tbl;
 	if (entry->rt_tbl)
 		entry->rt_tbl->ref_cnt++;
@@ -1187,10 +1393,12 @@ static int __ipa_mdfy_flt_rule(struct ipa_flt_rule_mdfy_i *frule,
 		entry->cnt_idx = frule->rule.cnt_idx;
 	else
 		entry->cnt_idx = 0;
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 
 	return 0;
 
 error:
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 	return -EPERM;
 }
 
@@ -1352,7 +1560,7 @@ int ipa3_add_flt_rule_usr(struct ipa_ioc_add_flt_rule *rules, bool user_only)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[rules->ip]);
 	for (i = 0; i < rules->num_rules; i++) {
 		if (!rules->global) {
 			/* if hashing not supported, all table entry
@@ -1393,7 +1601,7 @@ int ipa3_add_flt_rule_usr(struct ipa_ioc_add_flt_rule *rules, bool user_only)
 		}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[rules->ip]);
 
 	return result;
 }
@@ -1420,7 +1628,7 @@ int ipa3_add_flt_rule_usr_v2(struct ipa_ioc_add_flt_rule_v2
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[rules->ip]);
 	for (i = 0; i < rules->num_rules; i++) {
 		if (!rules->global) {
 			/* if hashing not supported, all table entry
@@ -1464,7 +1672,7 @@ int ipa3_add_flt_rule_usr_v2(struct ipa_ioc_add_flt_rule_v2
 		}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[rules->ip]);
 
 	return result;
 }
@@ -1497,7 +1705,7 @@ int ipa3_add_flt_rule_after(struct ipa_ioc_add_flt_rule_after *rules)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[rules->ip]);
 
 	if (__ipa_add_flt_get_ep_idx(rules->ep, &ipa_ep_idx)) {
 		result = -EINVAL;
@@ -1512,6 +1720,13 @@ int ipa3_add_flt_rule_after(struct ipa_ioc_add_flt_rule_after *rules)
 
 	tbl = &ipa3_ctx->flt_tbl[ipa_ep_idx][rules->ip];
 
+	if (ipa3_id_ip(rules->add_after_hdl) != rules->ip) {
+		IPAERR_RL("rule %d is not of ip family %d\n",
+			rules->add_after_hdl, rules->ip);
+		result = -EINVAL;
+		goto bail;
+	}
+
 	entry = ipa3_id_find(rules->add_after_hdl);
 	if (entry == NULL) {
 		IPAERR_RL("lookup failed\n");
@@ -1581,7 +1796,7 @@ int ipa3_add_flt_rule_after(struct ipa_ioc_add_flt_rule_after *rules)
 		}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[rules->ip]);
 
 	return result;
 }
@@ -1615,7 +1830,7 @@ int ipa3_add_flt_rule_after_v2(struct ipa_ioc_add_flt_rule_after_v2
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[rules->ip]);
 
 	if (__ipa_add_flt_get_ep_idx(rules->ep, &ipa_ep_idx)) {
 		result = -EINVAL;
@@ -1631,6 +1846,13 @@ int ipa3_add_flt_rule_after_v2(struct ipa_ioc_add_flt_rule_after_v2
 
 	tbl = &ipa3_ctx->flt_tbl[ipa_ep_idx][rules->ip];
 
+	if (ipa3_id_ip(rules->add_after_hdl) != rules->ip) {
+		IPAERR_RL("rule %d is not of ip family %d\n",
+			rules->add_after_hdl, rules->ip);
+		result = -EINVAL;
+		goto bail;
+	}
+
 	entry = ipa3_id_find(rules->add_after_hdl);
 	if (entry == NULL) {
 		IPAERR_RL("lookup failed\n");
@@ -1697,7 +1919,7 @@ int ipa3_add_flt_rule_after_v2(struct ipa_ioc_add_flt_rule_after_v2
 		}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[rules->ip]);
 
 	return result;
 }
@@ -1720,9 +1942,10 @@ int ipa3_del_flt_rule(struct ipa_ioc_del_flt_rule *hdls)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[hdls->ip]);
 	for (i = 0; i < hdls->num_hdls; i++) {
-		if (__ipa_del_flt_rule(hdls->hdl[i].hdl)) {
+		if (ipa3_id_ip(hdls->hdl[i].hdl) != hdls->ip ||
+			__ipa_del_flt_rule(hdls->hdl[i].hdl)) {
 			IPAERR_RL("failed to del flt rule %i\n", i);
 			hdls->hdl[i].status = IPA_FLT_STATUS_OF_DEL_FAILED;
 		} else {
@@ -1737,7 +1960,7 @@ int ipa3_del_flt_rule(struct ipa_ioc_del_flt_rule *hdls)
 		}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[hdls->ip]);
 
 	return result;
 }
@@ -1761,7 +1984,7 @@ int ipa3_mdfy_flt_rule(struct ipa_ioc_mdfy_flt_rule *hdls)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[hdls->ip]);
 
 	for (i = 0; i < hdls->num_rules; i++) {
 		/* if hashing not supported, all tables are non-hash tables*/
@@ -1789,7 +2012,7 @@ int ipa3_mdfy_flt_rule(struct ipa_ioc_mdfy_flt_rule *hdls)
 		}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[hdls->ip]);
 
 	return result;
 }
@@ -1812,7 +2035,7 @@ int ipa3_mdfy_flt_rule_v2(struct ipa_ioc_mdfy_flt_rule_v2 *hdls)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[hdls->ip]);
 	for (i = 0; i < hdls->num_rules; i++) {
 		/* if hashing not supported, all tables are non-hash tables*/
 		if (ipa3_ctx->ipa_fltrt_not_hashable)
@@ -1836,7 +2059,7 @@ int ipa3_mdfy_flt_rule_v2(struct ipa_ioc_mdfy_flt_rule_v2 *hdls)
 		}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[hdls->ip]);
 
 	return result;
 }
@@ -1859,7 +2082,7 @@ int ipa3_commit_flt(enum ipa_ip_type ip)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[ip]);
 
 	if (ipa3_ctx->ctrl->ipa3_commit_flt(ip)) {
 		result = -EPERM;
@@ -1868,7 +2091,7 @@ int ipa3_commit_flt(enum ipa_ip_type ip)
 	result = 0;
 
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[ip]);
 
 	return result;
 }
@@ -1897,7 +2120,8 @@ int ipa3_reset_flt(enum ipa_ip_type ip, bool user_only)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[ip]);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
 	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
 		if (!ipa_is_ep_support_flt(i))
 			continue;
@@ -1907,13 +2131,15 @@ int ipa3_reset_flt(enum ipa_ip_type ip, bool user_only)
 				link) {
 			if (ipa3_id_find(entry->id) == NULL) {
 				WARN_ON_RATELIMIT_IPA(1);
-				mutex_unlock(&ipa3_ctx->lock);
+				mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
+				mutex_unlock(&ipa3_ctx->flt_tbl_lock[ip]);
 				return -EFAULT;
 			}
 
 			if (!user_only ||
 					entry->ipacm_installed) {
 				list_del(&entry->link);
+				tbl->dirty[IPA_FLT_GET_RULE_TYPE(entry)] = true;
 				entry->tbl->rule_cnt--;
 				if (entry->rt_tbl &&
 					(!ipa3_check_idr_if_freed(
@@ -1936,15 +2162,16 @@ int ipa3_reset_flt(enum ipa_ip_type ip, bool user_only)
 		}
 	}
 
-	/* commit the change to IPA-HW */
-	if (ipa3_ctx->ctrl->ipa3_commit_flt(IPA_IP_v4) ||
-		ipa3_ctx->ctrl->ipa3_commit_flt(IPA_IP_v6)) {
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
+
+	/* commit the change to IPA-HW, only this family was reset */
+	if (ipa3_ctx->ctrl->ipa3_commit_flt(ip)) {
 		IPAERR("fail to commit flt-rule\n");
 		WARN_ON_RATELIMIT_IPA(1);
-		mutex_unlock(&ipa3_ctx->lock);
+		mutex_unlock(&ipa3_ctx->flt_tbl_lock[ip]);
 		return -EPERM;
 	}
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[ip]);
 	return 0;
 }
 
@@ -1970,21 +2197,23 @@ void ipa3_install_dflt_flt_rules(u32 ipa_ep_idx)
 
 	memset(&rule, 0, sizeof(rule));
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[IPA_IP_v4]);
 	tbl = &ipa3_ctx->flt_tbl[ipa_ep_idx][IPA_IP_v4];
 	rule.action = IPA_PASS_TO_EXCEPTION;
 	__ipa_add_flt_rule(tbl, IPA_IP_v4, &rule, true,
 			&ep->dflt_flt4_rule_hdl, false);
 	ipa3_ctx->ctrl->ipa3_commit_flt(IPA_IP_v4);
 	tbl->sticky_rear = true;
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[IPA_IP_v4]);
 
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[IPA_IP_v6]);
 	tbl = &ipa3_ctx->flt_tbl[ipa_ep_idx][IPA_IP_v6];
 	rule.action = IPA_PASS_TO_EXCEPTION;
 	__ipa_add_flt_rule(tbl, IPA_IP_v6, &rule, true,
 			&ep->dflt_flt6_rule_hdl, false);
 	ipa3_ctx->ctrl->ipa3_commit_flt(IPA_IP_v6);
 	tbl->sticky_rear = true;
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[IPA_IP_v6]);
 }
 
 void ipa3_delete_dflt_flt_rules(u32 ipa_ep_idx)
@@ -1992,7 +2221,7 @@ void ipa3_delete_dflt_flt_rules(u32 ipa_ep_idx)
 	struct ipa3_ep_context *ep = &ipa3_ctx->ep[ipa_ep_idx];
 	struct ipa3_flt_tbl *tbl;
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[IPA_IP_v4]);
 	if (ep->dflt_flt4_rule_hdl) {
 		tbl = &ipa3_ctx->flt_tbl[ipa_ep_idx][IPA_IP_v4];
 		__ipa_del_flt_rule(ep->dflt_flt4_rule_hdl);
@@ -2001,6 +2230,9 @@ void ipa3_delete_dflt_flt_rules(u32 ipa_ep_idx)
 		tbl->sticky_rear = false;
 		ep->dflt_flt4_rule_hdl = 0;
 	}
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[IPA_IP_v4]);
+
+	mutex_lock(&ipa3_ctx->flt_tbl_lock[IPA_IP_v6]);
 	if (ep->dflt_flt6_rule_hdl) {
 		tbl = &ipa3_ctx->flt_tbl[ipa_ep_idx][IPA_IP_v6];
 		__ipa_del_flt_rule(ep->dflt_flt6_rule_hdl);
@@ -2009,7 +2241,7 @@ void ipa3_delete_dflt_flt_rules(u32 ipa_ep_idx)
 		tbl->sticky_rear = false;
 		ep->dflt_flt6_rule_hdl = 0;
 	}
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->flt_tbl_lock[IPA_IP_v6]);
 }
 
 /**
@@ -2239,10 +2471,11 @@ int ipa_flt_sram_set_client_prio_high(enum ipa_client_type client)
 	if (!ipa_is_ep_support_flt(ipa_ep_idx))
 		return -EINVAL;
 
-	mutex_lock(&ipa3_ctx->lock);
 	for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++) {
 		struct ipa3_flt_tbl_nhash_lcl *lcl_tbl, *tmp;
 		struct ipa3_flt_tbl *flt_tbl = &ipa3_ctx->flt_tbl[ipa_ep_idx][ip];
+
+		mutex_lock(&ipa3_ctx->flt_tbl_lock[ip]);
 		/* Position filtering table last in the list so, it will have first SRAM priority */
 		list_for_each_entry_safe(
 			lcl_tbl, tmp, &ipa3_ctx->flt_tbl_nhash_lcl_list[ip], link) {
@@ -2253,8 +2486,8 @@ int ipa_flt_sram_set_client_prio_high(enum ipa_client_type client)
 				break;
 			}
 		}
+		mutex_unlock(&ipa3_ctx->flt_tbl_lock[ip]);
 	}
-	mutex_unlock(&ipa3_ctx->lock);
 
 	return 0;
 }
@@ -204,6 +204,8 @@ int __ipa_commit_hdr_v3_0(void)
 	struct ipahal_reg_valmask valmask;
 	enum hdr_tbl_storage loc;
 
+	lockdep_assert_held(&ipa3_ctx->hdr_tbl_lock);
+
 	memset(desc, 0, 3 * sizeof(struct ipa3_desc));
 
 	/* Generate structures for both SRAM and DDR header tables */
@@ -444,6 +446,8 @@ static int __ipa_add_hdr_proc_ctx(struct ipa_hdr_proc_ctx_add *proc_ctx,
 	int needed_len;
 	int mem_size;
 
+	lockdep_assert_held(&ipa3_ctx->hdr_tbl_lock);
+
 	IPADBG_LOW("Add processing type %d hdr_hdl %d\n",
 		proc_ctx->type, proc_ctx->hdr_hdl);
 
@@ -577,6 +581,8 @@ static int __ipa_add_hdr(struct ipa_hdr_add *hdr, bool user,
 	int mem_size;
 	enum hdr_tbl_storage hdr_tbl_loc;
 
+	lockdep_assert_held(&ipa3_ctx->hdr_tbl_lock);
+
 	if (hdr->hdr_len > IPA_HDR_MAX_SIZE) {
 		IPAERR_RL("bad param\n");
 		goto error;
@@ -760,6 +766,8 @@ static int __ipa3_del_hdr_proc_ctx(u32 proc_ctx_hdl,
 	struct ipa3_hdr_proc_ctx_entry *entry;
 	struct ipa3_hdr_proc_ctx_tbl *htbl = &ipa3_ctx->hdr_proc_ctx_tbl;
 
+	lockdep_assert_held(&ipa3_ctx->hdr_tbl_lock);
+
 	entry = ipa3_id_find(proc_ctx_hdl);
 	if (!entry || (entry->cookie != IPA_PROC_HDR_COOKIE)) {
 		IPAERR_RL("bad param\n");
@@ -834,6 +842,8 @@ int __ipa3_del_hdr(u32 hdr_hdl, bool by_user)
 	struct ipa3_hdr_entry *entry;
 	struct ipa3_hdr_tbl *htbl;
 
+	lockdep_assert_held(&ipa3_ctx->hdr_tbl_lock);
+
 	entry = ipa3_id_find(hdr_hdl);
 	if (entry == NULL) {
 		IPAERR_RL("lookup failed\n");
@@ -925,7 +935,7 @@ int ipa3_add_hdr_hpc_usr(struct ipa_ioc_add_hdr *hdrs, bool user_only)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	IPADBG("adding %d headers to IPA driver internal data struct\n",
 		hdrs->num_hdrs);
 	for (i = 0; i < hdrs->num_hdrs; i++) {
@@ -947,7 +957,7 @@ int ipa3_add_hdr_hpc_usr(struct ipa_ioc_add_hdr *hdrs, bool user_only)
 	}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return result;
 }
 
@@ -973,7 +983,7 @@ int ipa3_del_hdr_hpc_usr(struct ipa_ioc_del_hdr *hdls, bool by_user)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	for (i = 0; i < hdls->num_hdls; i++) {
 		entry = (struct ipa3_hdr_entry *)ipa3_id_find(hdls->hdl[i].hdl);
 		if (entry) {
@@ -1000,7 +1010,7 @@ int ipa3_del_hdr_hpc_usr(struct ipa_ioc_del_hdr *hdls, bool by_user)
 	}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return result;
 }
 
@@ -1054,7 +1064,7 @@ int ipa3_add_hdr_usr(struct ipa_ioc_add_hdr *hdrs, bool user_only)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	IPADBG("adding %d headers to IPA driver internal data struct\n",
 			hdrs->num_hdrs);
 	for (i = 0; i < hdrs->num_hdrs; i++) {
@@ -1075,7 +1085,7 @@ int ipa3_add_hdr_usr(struct ipa_ioc_add_hdr *hdrs, bool user_only)
 	}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return result;
 }
 
@@ -1099,7 +1109,7 @@ int ipa3_del_hdr_by_user(struct ipa_ioc_del_hdr *hdls, bool by_user)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	for (i = 0; i < hdls->num_hdls; i++) {
 		if (__ipa3_del_hdr(hdls->hdl[i].hdl, by_user)) {
 			IPAERR_RL("failed to del hdr %i\n", i);
@@ -1117,7 +1127,7 @@ int ipa3_del_hdr_by_user(struct ipa_ioc_del_hdr *hdls, bool by_user)
 	}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return result;
 }
 
@@ -1157,7 +1167,7 @@ int ipa3_add_hdr_proc_ctx(struct ipa_ioc_add_hdr_proc_ctx *proc_ctxs,
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	IPADBG("adding %d header processing contextes to IPA driver\n",
 			proc_ctxs->num_proc_ctxs);
 	for (i = 0; i < proc_ctxs->num_proc_ctxs; i++) {
@@ -1179,7 +1189,7 @@ int ipa3_add_hdr_proc_ctx(struct ipa_ioc_add_hdr_proc_ctx *proc_ctxs,
 	}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return result;
 }
 
@@ -1205,7 +1215,7 @@ int ipa3_del_hdr_proc_ctx_by_user(struct ipa_ioc_del_hdr_proc_ctx *hdls,
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	for (i = 0; i < hdls->num_hdls; i++) {
 		if (__ipa3_del_hdr_proc_ctx(hdls->hdl[i].hdl, true, by_user)) {
 			IPAERR_RL("failed to del hdr %i\n", i);
@@ -1223,7 +1233,7 @@ int ipa3_del_hdr_proc_ctx_by_user(struct ipa_ioc_del_hdr_proc_ctx *hdls,
 	}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return result;
 }
 
@@ -1262,14 +1272,14 @@ int ipa3_commit_hdr(void)
 	if (ipa3_commit_rt(IPA_IP_v6))
 		return -EPERM;
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	if (ipa3_ctx->ctrl->ipa3_commit_hdr()) {
 		result = -EPERM;
 		goto bail;
 	}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return result;
 }
 
@@ -1305,7 +1315,7 @@ int ipa3_reset_hdr(bool user_only)
 	if (ipa3_reset_rt(IPA_IP_v6, user_only))
 		IPAERR_RL("fail to reset v6 rt\n");
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	IPADBG("reset hdr\n");
 	for (hdr_tbl_loc = HDR_TBL_LCL; hdr_tbl_loc < HDR_TBLS_TOTAL; hdr_tbl_loc++) {
 		list_for_each_entry_safe(entry, next,
@@ -1322,7 +1332,7 @@ int ipa3_reset_hdr(bool user_only)
 			}
 
 			if (ipa3_id_find(entry->id) == NULL) {
-				mutex_unlock(&ipa3_ctx->lock);
+				mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 				IPAERR_RL("Invalid header ID\n");
 				WARN_ON_RATELIMIT_IPA(1);
 				return -EFAULT;
@@ -1389,7 +1399,7 @@ int ipa3_reset_hdr(bool user_only)
 		link) {
 
 		if (ipa3_id_find(ctx_entry->id) == NULL) {
-			mutex_unlock(&ipa3_ctx->lock);
+			mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 			IPAERR_RL("Invalid proc header ID\n");
 			WARN_ON_RATELIMIT_IPA(1);
 			return -EFAULT;
@@ -1438,11 +1448,11 @@ int ipa3_reset_hdr(bool user_only)
 	if (ipa3_ctx->ctrl->ipa3_commit_hdr()) {
 		IPAERR("fail to commit hdr\n");
 		WARN_ON_RATELIMIT_IPA(1);
-		mutex_unlock(&ipa3_ctx->lock);
+		mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 		return -EFAULT;
 	}
 
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return 0;
 }
 
@@ -1498,14 +1508,14 @@ int ipa3_get_hdr(struct ipa_ioc_get_hdr *lookup)
 		IPAERR_RL("bad parm\n");
 		return -EINVAL;
 	}
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	lookup->name[IPA_RESOURCE_NAME_MAX-1] = '\0';
 	entry = __ipa_find_hdr(lookup->name);
 	if (entry) {
 		lookup->hdl = entry->id;
 		result = 0;
 	}
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 
 	return result;
 }
@@ -1530,7 +1540,7 @@ int ipa3_get_hdr_offset(char* name, u32* offset)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	name[IPA_RESOURCE_NAME_MAX-1] = '\0';
 	entry = __ipa_find_hdr(name);
 	if (entry && entry->offset_entry) {
@@ -1538,7 +1548,7 @@ int ipa3_get_hdr_offset(char* name, u32* offset)
 		result = 0;
 	}
 
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return result;
 }
 
@@ -1563,7 +1573,7 @@ int ipa3_get_hdr_proc_ctx_hdl(struct ipa_ioc_get_hdr *lookup)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	lookup->name[IPA_RESOURCE_NAME_MAX-1] = '\0';
 	entry = __ipa_find_hdr_proc_ctx(lookup->name);
 	if (entry) {
@@ -1571,7 +1581,7 @@ int ipa3_get_hdr_proc_ctx_hdl(struct ipa_ioc_get_hdr *lookup)
 		result = 0;
 	}
 
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return result;
 }
 
@@ -1599,7 +1609,7 @@ int ipa3_get_hdr_proc_ctx_offset(char* name, u32* offset)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	name[IPA_RESOURCE_NAME_MAX-1] = '\0';
 	entry = __ipa_find_hdr_proc_ctx(name);
 	if (entry && entry->offset_entry) {
@@ -1609,7 +1619,7 @@ int ipa3_get_hdr_proc_ctx_offset(char* name, u32* offset)
 		result = 0;
 	}
 
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return result;
 }
 
@@ -1682,7 +1692,7 @@ int ipa3_put_hdr(u32 hdr_hdl)
 	struct ipa3_hdr_entry *entry;
 	int result = -EFAULT;
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 
 	entry = ipa3_id_find(hdr_hdl);
 	if (entry == NULL) {
@@ -1699,7 +1709,7 @@ int ipa3_put_hdr(u32 hdr_hdl)
 
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return result;
 }
 
@@ -1724,7 +1734,7 @@ int ipa3_copy_hdr(struct ipa_ioc_copy_hdr *copy)
 		IPAERR_RL("bad parm\n");
 		return -EINVAL;
 	}
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	copy->name[IPA_RESOURCE_NAME_MAX-1] = '\0';
 	entry = __ipa_find_hdr(copy->name);
 	if (entry) {
@@ -1736,7 +1746,7 @@ int ipa3_copy_hdr(struct ipa_ioc_copy_hdr *copy)
 		copy->eth2_ofst = entry->eth2_ofst;
 		result = 0;
 	}
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 
 	return result;
 }
@@ -14,6 +14,11 @@
 #define IPA_INIT_DROP_STATS_MAX_CMD_NUM 5
 #define IPA_INIT_TETH_STATS_MAX_CMD_NUM 5
 #define IPA_INIT_QUOTA_STATS_MAX_CMD_NUM 5
+#define IPA_HW_STATS_HARVEST_MAX_CMD_NUM 5
+#define IPA_HW_STATS_HARVEST_MIN_PERIOD_MS 10
+#define IPA_HW_STATS_HARVEST_MAX_PERIOD_MS 60000
+
+static void ipa_hw_stats_harvest_work(struct work_struct *work);
 
 static inline u32 ipa_hw_stats_get_ep_bit_n_idx(enum ipa_client_type client,
 	u32 *reg_idx)
@@ -45,6 +50,11 @@ int ipa_hw_stats_init(void)
 
 	/* initialize stats here */
 	ipa3_ctx->hw_stats->enabled = true;
+	mutex_init(&ipa3_ctx->hw_stats->lock);
+	mutex_init(&ipa3_ctx->hw_stats->harvest.lock);
+	INIT_DELAYED_WORK(&ipa3_ctx->hw_stats->harvest.work,
+		ipa_hw_stats_harvest_work);
+	ipa3_ctx->hw_stats->harvest.active = -1;
 
 	/* for IPA_HW_v5_0, reserved teth_stats sram for flt-tbls */
 	if (ipa3_ctx->ipa_hw_type == IPA_HW_v5_0)
@@ -674,6 +684,52 @@ destroy_init_pyld:
 	return ret;
 }
 
+/*
+ * The snapshot is served while it is at most two harvest periods old.
+ * Called with the stats lock held.
+ */
+static bool ipa_hw_stats_snapshot_fresh(void)
+{
+	struct ipa_hw_stats_harvest *harvest = &ipa3_ctx->hw_stats->harvest;
+	u64 age_ns;
+
+	if (!harvest->period_ms || harvest->active < 0)
+		return false;
+
+	age_ns = ktime_get_ns() - harvest->snap[harvest->active].timestamp_ns;
+	return age_ns <= 2ULL * harvest->period_ms * NSEC_PER_MSEC;
+}
+
+/*
+ * update driver cache.
+ * the stats were read from hardware with clear_after_read meaning
+ * hardware stats are 0 now
+ * Called with the stats lock held.
+ */
+static void ipa_hw_stats_add_quota(struct ipahal_stats_quota_all *stats)
+{
+	int i;
+
+	for (i = 0; i < IPA_CLIENT_MAX; i++) {
+		int ep_idx = ipa3_get_ep_mapping(i);
+
+		if (ep_idx == -1 || ep_idx >= ipa3_get_max_num_pipes())
+			continue;
+
+		if (ipa3_ctx->ep[ep_idx].client != i)
+			continue;
+
+		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv4_bytes +=
+			stats->stats[ep_idx].num_ipv4_bytes;
+		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv4_pkts +=
+			stats->stats[ep_idx].num_ipv4_pkts;
+		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv6_bytes +=
+			stats->stats[ep_idx].num_ipv6_bytes;
+		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv6_pkts +=
+			stats->stats[ep_idx].num_ipv6_pkts;
+	}
+}
+
 int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 {
 	int i;
@@ -690,6 +746,16 @@ int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
 		return 0;
 
+	/* a reset (out == NULL) has to clear the hardware counters */
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
+	if (out && ipa_hw_stats_snapshot_fresh()) {
+		*out = ipa3_ctx->hw_stats->quota.stats;
+		ipa3_ctx->hw_stats->harvest.stats.served++;
+		mutex_unlock(&ipa3_ctx->hw_stats->lock);
+		return 0;
+	}
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
+
 	memset(desc, 0, sizeof(desc));
 	memset(cmd_pyld, 0, sizeof(cmd_pyld));
 
@@ -766,33 +832,13 @@ int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 		goto free_stats;
 	}
 
-	/*
-	 * update driver cache.
-	 * the stats were read from hardware with clear_after_read meaning
-	 * hardware stats are 0 now
-	 */
-	for (i = 0; i < IPA_CLIENT_MAX; i++) {
-		int ep_idx = ipa3_get_ep_mapping(i);
-
-		if (ep_idx == -1 || ep_idx >= ipa3_get_max_num_pipes())
-			continue;
-
-		if (ipa3_ctx->ep[ep_idx].client != i)
-			continue;
-
-		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv4_bytes +=
-			stats->stats[ep_idx].num_ipv4_bytes;
-		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv4_pkts +=
-			stats->stats[ep_idx].num_ipv4_pkts;
-		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv6_bytes +=
-			stats->stats[ep_idx].num_ipv6_bytes;
-		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv6_pkts +=
-			stats->stats[ep_idx].num_ipv6_pkts;
-	}
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
+	ipa_hw_stats_add_quota(stats);
 
 	/* copy results to out parameter */
 	if (out)
 		*out = ipa3_ctx->hw_stats->quota.stats;
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
 	ret = 0;
 free_stats:
 	kfree(stats);
@@ -826,8 +872,10 @@ int ipa_reset_quota_stats(enum ipa_client_type client)
 	}
 
 	/* reset driver's cache */
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
 	stats = &ipa3_ctx->hw_stats->quota.stats.client[client];
 	memset(stats, 0, sizeof(*stats));
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
 	return 0;
 }
 
@@ -847,8 +895,10 @@ int ipa_reset_all_quota_stats(void)
 	}
 
 	/* reset driver's cache */
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
 	stats = &ipa3_ctx->hw_stats->quota.stats;
 	memset(stats, 0, sizeof(*stats));
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
 	return 0;
 }
 
@@ -1071,10 +1121,106 @@ destroy_init_pyld:
 	return ret;
 }
 
-int ipa_get_teth_stats(void)
+/*
+ * Hand the tethering counts harvested since the last ipa_get_teth_stats()
+ * over to prod_stats. Called with the stats lock held.
+ */
+static void ipa_hw_stats_take_teth_delta(void)
+{
+	struct ipa_hw_stats *hw_stats = ipa3_ctx->hw_stats;
+
+	/* reset prod_stats cache */
+	if (hw_stats->harvest.teth_delta) {
+		memcpy(hw_stats->teth.prod_stats, hw_stats->harvest.teth_delta,
+			sizeof(hw_stats->teth.prod_stats));
+		memset(hw_stats->harvest.teth_delta, 0,
+			sizeof(hw_stats->teth.prod_stats));
+	} else {
+		memset(hw_stats->teth.prod_stats, 0,
+			sizeof(hw_stats->teth.prod_stats));
+	}
+}
+
+/*
+ * update driver cache.
+ * the stats were read from hardware with clear_after_read meaning
+ * hardware stats are 0 now
+ * The counts are added to the accumulated stats and to @delta, an array of
+ * IPA_CLIENT_MAX entries. Called with the stats lock held.
+ */
+static void ipa_hw_stats_add_teth(struct ipahal_stats_tethering_all *stats_all,
+	struct ipa_quota_stats_all *delta)
 {
 	int i, j;
 	int prod_reg, cons_reg;
+	struct ipa_hw_stats_teth *sw_stats = &ipa3_ctx->hw_stats->teth;
+	struct ipahal_stats_tethering *stats;
+	struct ipa_quota_stats *quota_stats;
+	struct ipahal_stats_init_tethering *init = &sw_stats->init;
+
+	for (i = 0; i < IPA_CLIENT_MAX; i++) {
+		for (j = 0; j < IPA_CLIENT_MAX; j++) {
+			int prod_idx = ipa3_get_ep_mapping(i);
+			int cons_idx = ipa3_get_ep_mapping(j);
+
+			if (prod_idx == -1 ||
+				prod_idx >= ipa3_get_max_num_pipes())
+				continue;
+
+			if (cons_idx == -1 ||
+				cons_idx >= ipa3_get_max_num_pipes())
+				continue;
+
+			prod_reg = ipahal_get_ep_reg_idx(prod_idx);
+			cons_reg = ipahal_get_ep_reg_idx(cons_idx);
+
+			/* save hw-query result */
+			if ((init->prod_bitmask[prod_reg] &
+				ipahal_get_ep_bit(prod_idx)) &&
+				(init->cons_bitmask[prod_idx][cons_reg]
+					& ipahal_get_ep_bit(cons_idx))) {
+				IPADBG_LOW("prod %d cons %d\n",
+					prod_idx, cons_idx);
+				stats = &stats_all->stats[prod_idx][cons_idx];
+				IPADBG_LOW("num_ipv4_bytes %lld\n",
+					stats->num_ipv4_bytes);
+				IPADBG_LOW("num_ipv4_pkts %lld\n",
+					stats->num_ipv4_pkts);
+				IPADBG_LOW("num_ipv6_pkts %lld\n",
+					stats->num_ipv6_pkts);
+				IPADBG_LOW("num_ipv6_bytes %lld\n",
+					stats->num_ipv6_bytes);
+
+				/* update stats*/
+				quota_stats = &delta[i].client[j];
+				quota_stats->num_ipv4_bytes +=
+					stats->num_ipv4_bytes;
+				quota_stats->num_ipv4_pkts +=
+					stats->num_ipv4_pkts;
+				quota_stats->num_ipv6_bytes +=
+					stats->num_ipv6_bytes;
+				quota_stats->num_ipv6_pkts +=
+					stats->num_ipv6_pkts;
+
+				/* Accumulated stats */
+				quota_stats =
+					&sw_stats->prod_stats_sum[i].client[j];
+				quota_stats->num_ipv4_bytes +=
+					stats->num_ipv4_bytes;
+				quota_stats->num_ipv4_pkts +=
+					stats->num_ipv4_pkts;
+				quota_stats->num_ipv6_bytes +=
+					stats->num_ipv6_bytes;
+				quota_stats->num_ipv6_pkts +=
+					stats->num_ipv6_pkts;
+			}
+		}
+	}
+}
+
+static int __ipa_get_teth_stats(bool from_snapshot)
+{
+	int i;
 	int ret;
 	struct ipahal_stats_get_offset_tethering get_offset;
 	struct ipahal_stats_offset offset = {0};
@@ -1083,19 +1229,20 @@ int ipa_get_teth_stats(void)
 	struct ipa_mem_buffer mem;
 	struct ipa3_desc desc[2];
 	struct ipahal_stats_tethering_all *stats_all;
-	struct ipa_hw_stats_teth *sw_stats;
-	struct ipahal_stats_tethering *stats;
-	struct ipa_quota_stats *quota_stats;
-	struct ipahal_stats_init_tethering *init;
 	int num_cmd = 0;
 
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled &&
 		ipa3_ctx->hw_stats->teth_stats_enabled))
 		return 0;
 
-	sw_stats = &ipa3_ctx->hw_stats->teth;
-	init = (struct ipahal_stats_init_tethering *)
-			&ipa3_ctx->hw_stats->teth.init;
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
+	if (from_snapshot && ipa_hw_stats_snapshot_fresh()) {
+		ipa_hw_stats_take_teth_delta();
+		ipa3_ctx->hw_stats->harvest.stats.served++;
+		mutex_unlock(&ipa3_ctx->hw_stats->lock);
+		return 0;
+	}
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
 
 	memset(desc, 0, sizeof(desc));
 	memset(cmd_pyld, 0, sizeof(cmd_pyld));
@@ -1175,81 +1322,14 @@ int ipa_get_teth_stats(void)
 		goto free_stats;
 	}
 
-	/* reset prod_stats cache */
-	for (i = 0; i < IPA_CLIENT_MAX; i++) {
-		memset(&ipa3_ctx->hw_stats->teth.prod_stats[i], 0,
-			sizeof(ipa3_ctx->hw_stats->teth.prod_stats[i]));
-	}
-
-	/*
-	 * update driver cache.
-	 * the stats were read from hardware with clear_after_read meaning
-	 * hardware stats are 0 now
-	 */
-	for (i = 0; i < IPA_CLIENT_MAX; i++) {
-		for (j = 0; j < IPA_CLIENT_MAX; j++) {
-			int prod_idx = ipa3_get_ep_mapping(i);
-			int cons_idx = ipa3_get_ep_mapping(j);
-
-			if (prod_idx == -1 ||
-				prod_idx >= ipa3_get_max_num_pipes())
-				continue;
-
-			if (cons_idx == -1 ||
-				cons_idx >= ipa3_get_max_num_pipes())
-				continue;
-
-			prod_reg = ipahal_get_ep_reg_idx(prod_idx);
-			cons_reg = ipahal_get_ep_reg_idx(cons_idx);
-
-			/* save hw-query result */
-			if ((init->prod_bitmask[prod_reg] &
-				ipahal_get_ep_bit(prod_idx)) &&
-				(init->cons_bitmask[prod_idx][cons_reg]
-					& ipahal_get_ep_bit(cons_idx))) {
-				IPADBG_LOW("prod %d cons %d\n",
-					prod_idx, cons_idx);
-				stats = &stats_all->stats[prod_idx][cons_idx];
-				IPADBG_LOW("num_ipv4_bytes %lld\n",
-					stats->num_ipv4_bytes);
-				IPADBG_LOW("num_ipv4_pkts %lld\n",
-					stats->num_ipv4_pkts);
-				IPADBG_LOW("num_ipv6_pkts %lld\n",
-					stats->num_ipv6_pkts);
-				IPADBG_LOW("num_ipv6_bytes %lld\n",
-					stats->num_ipv6_bytes);
-
-				/* update stats*/
-				quota_stats =
-					&sw_stats->prod_stats[i].client[j];
-				quota_stats->num_ipv4_bytes =
-					stats->num_ipv4_bytes;
-				quota_stats->num_ipv4_pkts =
-					stats->num_ipv4_pkts;
-				quota_stats->num_ipv6_bytes =
-					stats->num_ipv6_bytes;
-				quota_stats->num_ipv6_pkts =
-					stats->num_ipv6_pkts;
-
-				/* Accumulated stats */
-				quota_stats =
-					&sw_stats->prod_stats_sum[i].client[j];
-				quota_stats->num_ipv4_bytes +=
-					stats->num_ipv4_bytes;
-				quota_stats->num_ipv4_pkts +=
-					stats->num_ipv4_pkts;
-				quota_stats->num_ipv6_bytes +=
-					stats->num_ipv6_bytes;
-				quota_stats->num_ipv6_pkts +=
-					stats->num_ipv6_pkts;
-			}
-		}
-	}
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
+	ipa_hw_stats_take_teth_delta();
+	ipa_hw_stats_add_teth(stats_all, ipa3_ctx->hw_stats->teth.prod_stats);
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
 
 	ret = 0;
 free_stats:
 	vfree(stats_all);
-	stats = NULL;
 destroy_imm:
 	for (i = 0; i < num_cmd; i++)
 		ipahal_destroy_imm_cmd(cmd_pyld[i]);
@@ -1259,6 +1339,11 @@ free_dma_mem:
 
 }
 
+int ipa_get_teth_stats(void)
+{
+	return __ipa_get_teth_stats(true);
+}
+
 int ipa_query_teth_stats(enum ipa_client_type prod,
 	struct ipa_quota_stats_all *out, bool reset)
 {
@@ -1272,10 +1357,12 @@ int ipa_query_teth_stats(enum ipa_client_type prod,
 	}
 
 	/* copy results to out parameter */
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
 	if (reset)
 		*out = ipa3_ctx->hw_stats->teth.prod_stats[prod];
 	else
 		*out = ipa3_ctx->hw_stats->teth.prod_stats_sum[prod];
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
 	return 0;
 }
 
@@ -1294,15 +1381,17 @@ int ipa_reset_teth_stats(enum ipa_client_type prod, enum ipa_client_type cons)
 	}
 
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_teth_stats();
+	ret = __ipa_get_teth_stats(false);
 	if (ret) {
 		IPAERR("ipa_get_teth_stats failed %d\n", ret);
 		return ret;
 	}
 
 	/* reset driver's cache */
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
 	stats = &ipa3_ctx->hw_stats->teth.prod_stats_sum[prod].client[cons];
 	memset(stats, 0, sizeof(*stats));
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
 	return 0;
 }
 
@@ -1322,17 +1411,19 @@ int ipa_reset_all_cons_teth_stats(enum ipa_client_type prod)
 	}
 
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_teth_stats();
+	ret = __ipa_get_teth_stats(false);
 	if (ret) {
 		IPAERR("ipa_get_teth_stats failed %d\n", ret);
 		return ret;
 	}
 
 	/* reset driver's cache */
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
 	for (i = 0; i < IPA_CLIENT_MAX; i++) {
 		stats = &ipa3_ctx->hw_stats->teth.prod_stats_sum[prod].client[i];
 		memset(stats, 0, sizeof(*stats));
 	}
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
 
 	return 0;
 }
@@ -1350,7 +1441,7 @@ int ipa_reset_all_teth_stats(void)
 	/* reading stats will reset them in hardware */
 	for (i = 0; i < IPA_CLIENT_MAX; i++) {
 		if (IPA_CLIENT_IS_PROD(i) && ipa3_get_ep_mapping(i) != -1) {
-			ret = ipa_get_teth_stats();
+			ret = __ipa_get_teth_stats(false);
 			if (ret) {
 				IPAERR("ipa_get_teth_stats failed %d\n", ret);
 				return ret;
@@ -1361,10 +1452,12 @@ int ipa_reset_all_teth_stats(void)
 	}
 
 	/* reset driver's cache */
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
 	for (i = 0; i < IPA_CLIENT_MAX; i++) {
 		stats = &ipa3_ctx->hw_stats->teth.prod_stats_sum[i];
 		memset(stats, 0, sizeof(*stats));
 	}
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
 
 	return 0;
 }
@@ -1568,6 +1661,22 @@ destroy_init_pyld:
 	return ret;
 }
 
+/*
+ * The FnR counters were reset or written outside of the harvester: drop
+ * them from the published snapshot and make the harvest in flight, which
+ * may have read them before, discard its FnR part.
+ */
+static void ipa_hw_stats_invalidate_fnr(void)
+{
+	struct ipa_hw_stats_harvest *harvest = &ipa3_ctx->hw_stats->harvest;
+
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
+	harvest->fnr_gen++;
+	if (harvest->active >= 0)
+		harvest->snap[harvest->active].size[IPAHAL_HW_STATS_FNR] = 0;
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
+}
+
 static int __ipa_get_flt_rt_stats(struct ipa_ioc_flt_rt_query *query)
 {
 	int ret;
@@ -1652,6 +1761,9 @@ static int __ipa_get_flt_rt_stats(struct ipa_ioc_flt_rt_query *query)
 	++num_cmd;
 
 	ret = ipa3_send_cmd(num_cmd, desc);
+	/* even a failed reset may have cleared some of the counters */
+	if (clear)
+		ipa_hw_stats_invalidate_fnr();
 	if (ret) {
 		IPAERR("failed to send immediate command (error %d)\n", ret);
 		goto destroy_imm;
@@ -1675,6 +1787,41 @@ free_offset:
 	return ret;
 }
 
+/*
+ * Serve a query that does not clear the counters from the harvested
+ * snapshot, -EAGAIN if it is stale or does not hold them.
+ */
+static int ipa_get_flt_rt_stats_snapshot(struct ipa_ioc_flt_rt_query *query)
+{
+	struct ipa_hw_stats_harvest *harvest = &ipa3_ctx->hw_stats->harvest;
+	struct ipahal_stats_get_offset_flt_rt_v4_5 get_offset = { 0 };
+	struct ipahal_stats_offset offset = { 0 };
+	struct ipa_hw_stats_snapshot *snap;
+	int ret = -EAGAIN;
+
+	get_offset.start_id = query->start_id;
+	get_offset.end_id = query->end_id;
+	if (ipahal_stats_get_offset(IPAHAL_HW_STATS_FNR, &get_offset, &offset))
+		return -EAGAIN;
+
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
+	if (!ipa_hw_stats_snapshot_fresh())
+		goto unlock;
+
+	snap = &harvest->snap[harvest->active];
+	if (offset.offset + offset.size > snap->size[IPAHAL_HW_STATS_FNR])
+		goto unlock;
+
+	ret = ipahal_parse_stats(IPAHAL_HW_STATS_FNR, NULL,
+		(u8 *)snap->mem.base + snap->ofst[IPAHAL_HW_STATS_FNR] +
+		offset.offset, query);
+	if (!ret)
+		harvest->stats.served++;
+unlock:
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
+	return ret;
+}
+
 int ipa_get_flt_rt_stats(struct ipa_ioc_flt_rt_query *query)
 {
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled)) {
@@ -1717,6 +1864,9 @@ int ipa_get_flt_rt_stats(struct ipa_ioc_flt_rt_query *query)
 		return -EINVAL;
 	}
 
+	if (!query->reset && !ipa_get_flt_rt_stats_snapshot(query))
+		return 0;
+
 	return __ipa_get_flt_rt_stats(query);
 }
 
@@ -1788,6 +1938,7 @@ static int __ipa_set_flt_rt_stats(int index, struct ipa_flt_rt_stats stats)
 	desc.type = IPA_IMM_CMD_DESC;
 
 	ret = ipa3_send_cmd(1, &desc);
+	ipa_hw_stats_invalidate_fnr();
 	if (ret) {
 		IPAERR("failed to send immediate command (error %d)\n", ret);
 		goto destroy_imm;
@@ -2100,6 +2251,32 @@ fail_free_desc:
 	return ret;
 }
 
+/*
+ * update driver cache.
+ * the stats were read from hardware with clear_after_read meaning
+ * hardware stats are 0 now
+ * Called with the stats lock held.
+ */
+static void ipa_hw_stats_add_drop(struct ipahal_stats_drop_all *stats)
+{
+	int i;
+
+	for (i = 0; i < IPA_CLIENT_MAX; i++) {
+		int ep_idx = ipa3_get_ep_mapping(i);
+
+		if (ep_idx == -1 || ep_idx >= ipa3_get_max_num_pipes())
+			continue;
+
+		if (ipa3_ctx->ep[ep_idx].client != i)
+			continue;
+
+		ipa3_ctx->hw_stats->drop.stats.client[i].drop_byte_cnt +=
+			stats->stats[ep_idx].drop_byte_cnt;
+		ipa3_ctx->hw_stats->drop.stats.client[i].drop_packet_cnt +=
+			stats->stats[ep_idx].drop_packet_cnt;
+	}
+}
+
 int ipa_get_drop_stats(struct ipa_drop_stats_all *out)
 {
 	int i;
@@ -2116,6 +2293,16 @@ int ipa_get_drop_stats(struct ipa_drop_stats_all *out)
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
 		return 0;
 
+	/* a reset (out == NULL) has to clear the hardware counters */
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
+	if (out && ipa_hw_stats_snapshot_fresh()) {
+		*out = ipa3_ctx->hw_stats->drop.stats;
+		ipa3_ctx->hw_stats->harvest.stats.served++;
+		mutex_unlock(&ipa3_ctx->hw_stats->lock);
+		return 0;
+	}
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
+
 	memset(desc, 0, sizeof(desc));
 	memset(cmd_pyld, 0, sizeof(cmd_pyld));
 
@@ -2192,34 +2379,13 @@ int ipa_get_drop_stats(struct ipa_drop_stats_all *out)
 		goto free_stats;
 	}
 
-	/*
-	 * update driver cache.
-	 * the stats were read from hardware with clear_after_read meaning
-	 * hardware stats are 0 now
-	 */
-	for (i = 0; i < IPA_CLIENT_MAX; i++) {
-		int ep_idx = ipa3_get_ep_mapping(i);
-
-		if (ep_idx == -1 || ep_idx >= ipa3_get_max_num_pipes())
-			continue;
-
-		if (ipa3_ctx->ep[ep_idx].client != i)
-			continue;
-
-		ipa3_ctx->hw_stats->drop.stats.client[i].drop_byte_cnt +=
-			stats->stats[ep_idx].drop_byte_cnt;
-		ipa3_ctx->hw_stats->drop.stats.client[i].drop_packet_cnt +=
-			stats->stats[ep_idx].drop_packet_cnt;
-	}
-
-
-	if (!out) {
-		ret = 0;
-		goto free_stats;
-	}
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
+	ipa_hw_stats_add_drop(stats);
 
 	/* copy results to out parameter */
-	*out = ipa3_ctx->hw_stats->drop.stats;
+	if (out)
+		*out = ipa3_ctx->hw_stats->drop.stats;
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
 
 	ret = 0;
 free_stats:
@@ -2254,8 +2420,10 @@ int ipa_reset_drop_stats(enum ipa_client_type client)
 	}
 
 	/* reset driver's cache */
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
 	stats = &ipa3_ctx->hw_stats->drop.stats.client[client];
 	memset(stats, 0, sizeof(*stats));
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
 	return 0;
 }
 
@@ -2275,11 +2443,411 @@ int ipa_reset_all_drop_stats(void)
 	}
 
 	/* reset driver's cache */
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
 	stats = &ipa3_ctx->hw_stats->drop.stats;
 	memset(stats, 0, sizeof(*stats));
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
+	return 0;
+}
+
+/*
+ * SRAM partition of a stats class and the part of it holding the enabled
+ * counters, -EPERM if the class is not harvested.
+ */
+static int ipa_hw_stats_harvest_offset(enum ipahal_hw_stats_type type,
+	u32 *smem_ofst, u32 *smem_size, struct ipahal_stats_offset *offset)
+{
+	struct ipa_hw_stats *hw_stats = ipa3_ctx->hw_stats;
+	union {
+		struct ipahal_stats_get_offset_quota quota;
+		struct ipahal_stats_get_offset_tethering teth;
+		struct ipahal_stats_get_offset_drop drop;
+		struct ipahal_stats_get_offset_flt_rt_v4_5 fnr;
+	} params;
+
+	memset(&params, 0, sizeof(params));
+	switch (type) {
+	case IPAHAL_HW_STATS_QUOTA:
+		if (ipa3_ctx->ipa_hw_type < IPA_HW_v4_5)
+			return -EPERM;
+		params.quota.init = hw_stats->quota.init;
+		*smem_ofst = IPA_MEM_PART(stats_quota_ap_ofst);
+		*smem_size = IPA_MEM_PART(stats_quota_ap_size);
+		break;
+	case IPAHAL_HW_STATS_TETHERING:
+		if (!hw_stats->teth_stats_enabled)
+			return -EPERM;
+		params.teth.init = hw_stats->teth.init;
+		*smem_ofst = IPA_MEM_PART(stats_tethering_ofst);
+		*smem_size = IPA_MEM_PART(stats_tethering_size);
+		break;
+	case IPAHAL_HW_STATS_FNR:
+		if (ipa3_ctx->ipa_hw_type < IPA_HW_v4_5)
+			return -EPERM;
+		params.fnr.start_id = 1;
+		params.fnr.end_id = IPA_MAX_FLT_RT_CNT_INDEX;
+		*smem_ofst = IPA_MEM_PART(stats_fnr_ofst);
+		*smem_size = IPA_MEM_PART(stats_fnr_size);
+		break;
+	case IPAHAL_HW_STATS_DROP:
+		params.drop.init = hw_stats->drop.init;
+		*smem_ofst = IPA_MEM_PART(stats_drop_ofst);
+		*smem_size = IPA_MEM_PART(stats_drop_size);
+		break;
+	default:
+		return -EPERM;
+	}
+
+	return ipahal_stats_get_offset(type, &params, offset);
+}
+
+/* Called with the harvest lock held */
+static void ipa_hw_stats_harvest_free(void)
+{
+	struct ipa_hw_stats_harvest *harvest = &ipa3_ctx->hw_stats->harvest;
+	int i;
+
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
+	harvest->active = -1;
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
+
+	for (i = 0; i < ARRAY_SIZE(harvest->snap); i++) {
+		if (harvest->snap[i].mem.base)
+			dma_free_coherent(ipa3_ctx->pdev,
+				harvest->snap[i].mem.size,
+				harvest->snap[i].mem.base,
+				harvest->snap[i].mem.phys_base);
+		memset(&harvest->snap[i], 0, sizeof(harvest->snap[i]));
+	}
+	kfree(harvest->quota);
+	harvest->quota = NULL;
+	vfree(harvest->teth);
+	harvest->teth = NULL;
+	kfree(harvest->drop);
+	harvest->drop = NULL;
+}
+
+/*
+ * Both snapshots hold every stats partition, so a harvest never depends on
+ * how many counters are enabled. Called with the harvest lock held.
+ */
+static int ipa_hw_stats_harvest_alloc(void)
+{
+	struct ipa_hw_stats *hw_stats = ipa3_ctx->hw_stats;
+	struct ipa_hw_stats_harvest *harvest = &hw_stats->harvest;
+	struct ipa_quota_stats_all *teth_delta;
+	u32 ofst[IPAHAL_HW_STATS_MAX];
+	u32 size = 0;
+	int i;
+
+	ofst[IPAHAL_HW_STATS_QUOTA] = size;
+	size += ALIGN(IPA_MEM_PART(stats_quota_ap_size), 8);
+	ofst[IPAHAL_HW_STATS_TETHERING] = size;
+	size += ALIGN(IPA_MEM_PART(stats_tethering_size), 8);
+	ofst[IPAHAL_HW_STATS_DROP] = size;
+	size += ALIGN(IPA_MEM_PART(stats_drop_size), 8);
+	ofst[IPAHAL_HW_STATS_FNR] = size;
+	size += ALIGN(IPA_MEM_PART(stats_fnr_size), 8);
+
+	harvest->quota = kzalloc(sizeof(*harvest->quota), GFP_KERNEL);
+	harvest->teth = vzalloc(sizeof(*harvest->teth));
+	harvest->drop = kzalloc(sizeof(*harvest->drop), GFP_KERNEL);
+	if (!harvest->quota || !harvest->teth || !harvest->drop)
+		goto fail;
+
+	/* kept once allocated so that no tethering count is ever dropped */
+	if (!harvest->teth_delta) {
+		teth_delta = vzalloc(sizeof(hw_stats->teth.prod_stats));
+		if (!teth_delta)
+			goto fail;
+		mutex_lock(&hw_stats->lock);
+		harvest->teth_delta = teth_delta;
+		mutex_unlock(&hw_stats->lock);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(harvest->snap); i++) {
+		harvest->snap[i].mem.size = size;
+		harvest->snap[i].mem.base = dma_alloc_coherent(ipa3_ctx->pdev,
+			size, &harvest->snap[i].mem.phys_base, GFP_KERNEL);
+		if (!harvest->snap[i].mem.base)
+			goto fail;
+		memcpy(harvest->snap[i].ofst, ofst, sizeof(ofst));
+	}
+
+	return 0;
+
+fail:
+	IPAERR("failed to allocate the harvest buffers\n");
+	ipa_hw_stats_harvest_free();
+	return -ENOMEM;
+}
+
+/*
+ * ipa_hw_stats_harvest() - Read every enabled stats class with one command
+ * sequence into the snapshot not published, fold the counts into the
+ * driver caches and publish it. Only the folding holds the stats lock.
+ */
+static int ipa_hw_stats_harvest(void)
+{
+	struct ipa_hw_stats *hw_stats = ipa3_ctx->hw_stats;
+	struct ipa_hw_stats_harvest *harvest = &hw_stats->harvest;
+	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
+	struct ipahal_imm_cmd_pyld *cmd_pyld[IPA_HW_STATS_HARVEST_MAX_CMD_NUM];
+	struct ipa3_desc desc[IPA_HW_STATS_HARVEST_MAX_CMD_NUM];
+	struct ipahal_stats_offset offset;
+	struct ipa_hw_stats_snapshot *snap;
+	enum ipahal_hw_stats_type type;
+	u32 smem_ofst, smem_size;
+	ktime_t start = ktime_get();
+	int num_classes = 0;
+	int num_cmd = 0;
+	bool sent = false;
+	u32 fnr_gen;
+	int next;
+	int ret;
+	int rc;
+	int i;
+	u32 us;
+
+	memset(desc, 0, sizeof(desc));
+	memset(cmd_pyld, 0, sizeof(cmd_pyld));
+
+	mutex_lock(&harvest->lock);
+	if (!harvest->snap[0].mem.base) {
+		ret = ipa_hw_stats_harvest_alloc();
+		if (ret)
+			goto unlock;
+	}
+
+	/* only this function publishes, under the harvest lock */
+	next = harvest->active == 0 ? 1 : 0;
+	snap = &harvest->snap[next];
+	memset(snap->size, 0, sizeof(snap->size));
+
+	mutex_lock(&hw_stats->lock);
+	fnr_gen = harvest->fnr_gen;
+	mutex_unlock(&hw_stats->lock);
+
+	/* IC to close the coal frame before HPS Clear if coal is enabled */
+	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) !=
+		IPA_EP_NOT_ALLOCATED && !ipa3_ctx->ulso_wa) {
+		ipa_close_coal_frame(&cmd_pyld[num_cmd]);
+		if (!cmd_pyld[num_cmd]) {
+			IPAERR("failed to construct coal close IC\n");
+			ret = -ENOMEM;
+			goto destroy_imm;
+		}
+		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+		++num_cmd;
+	}
+
+	for (type = 0; type < IPAHAL_HW_STATS_MAX; type++) {
+		memset(&offset, 0, sizeof(offset));
+		if (ipa_hw_stats_harvest_offset(type, &smem_ofst, &smem_size,
+			&offset) || !offset.size)
+			continue;
+
+		if (offset.offset + offset.size > smem_size) {
+			IPAERR_RL("stats %d: %u bytes at %u overflow SRAM %u\n",
+				type, offset.size, offset.offset, smem_size);
+			continue;
+		}
+
+		/* FnR counters are left running, as the queries expect */
+		cmd.is_read = true;
+		cmd.clear_after_read = type != IPAHAL_HW_STATS_FNR;
+		cmd.skip_pipeline_clear = false;
+		cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+		cmd.size = offset.size;
+		cmd.system_addr = snap->mem.phys_base + snap->ofst[type];
+		cmd.local_addr = ipa3_ctx->smem_restricted_bytes + smem_ofst +
+			offset.offset;
+		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
+			IPA_IMM_CMD_DMA_SHARED_MEM, &cmd, false);
+		if (!cmd_pyld[num_cmd]) {
+			IPAERR("failed to construct dma_shared_mem imm cmd\n");
+			ret = -ENOMEM;
+			goto destroy_imm;
+		}
+		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+		++num_cmd;
+		snap->size[type] = offset.size;
+		++num_classes;
+	}
+
+	/* nothing enabled yet, the coal close alone is not worth sending */
+	if (!num_classes) {
+		ret = 0;
+		goto destroy_imm;
+	}
+
+	ret = ipa3_send_cmd(num_cmd, desc);
+	if (ret) {
+		IPAERR("failed to send immediate command (error %d)\n", ret);
+		goto destroy_imm;
+	}
+	sent = true;
+
+	/* parse before taking the stats lock, queries keep being served */
+	if (snap->size[IPAHAL_HW_STATS_QUOTA]) {
+		memset(harvest->quota, 0, sizeof(*harvest->quota));
+		rc = ipahal_parse_stats(IPAHAL_HW_STATS_QUOTA,
+			&hw_stats->quota.init,
+			(u8 *)snap->mem.base + snap->ofst[IPAHAL_HW_STATS_QUOTA],
+			harvest->quota);
+		if (rc) {
+			IPAERR("failed to parse quota stats (error %d)\n", rc);
+			ret = rc;
+			snap->size[IPAHAL_HW_STATS_QUOTA] = 0;
+		}
+	}
+	if (snap->size[IPAHAL_HW_STATS_TETHERING]) {
+		memset(harvest->teth, 0, sizeof(*harvest->teth));
+		rc = ipahal_parse_stats(IPAHAL_HW_STATS_TETHERING,
+			&hw_stats->teth.init,
+			(u8 *)snap->mem.base +
+			snap->ofst[IPAHAL_HW_STATS_TETHERING], harvest->teth);
+		if (rc) {
+			IPAERR("failed to parse teth stats (error %d)\n", rc);
+			ret = rc;
+			snap->size[IPAHAL_HW_STATS_TETHERING] = 0;
+		}
+	}
+	if (snap->size[IPAHAL_HW_STATS_DROP]) {
+		memset(harvest->drop, 0, sizeof(*harvest->drop));
+		rc = ipahal_parse_stats(IPAHAL_HW_STATS_DROP,
+			&hw_stats->drop.init,
+			(u8 *)snap->mem.base + snap->ofst[IPAHAL_HW_STATS_DROP],
+			harvest->drop);
+		if (rc) {
+			IPAERR("failed to parse drop stats (error %d)\n", rc);
+			ret = rc;
+			snap->size[IPAHAL_HW_STATS_DROP] = 0;
+		}
+	}
+
+	mutex_lock(&hw_stats->lock);
+	if (snap->size[IPAHAL_HW_STATS_QUOTA])
+		ipa_hw_stats_add_quota(harvest->quota);
+	if (snap->size[IPAHAL_HW_STATS_TETHERING])
+		ipa_hw_stats_add_teth(harvest->teth, harvest->teth_delta);
+	if (snap->size[IPAHAL_HW_STATS_DROP])
+		ipa_hw_stats_add_drop(harvest->drop);
+	/* the FnR counters were reset or written while we read them */
+	if (harvest->fnr_gen != fnr_gen)
+		snap->size[IPAHAL_HW_STATS_FNR] = 0;
+	snap->timestamp_ns = ktime_get_ns();
+	snap->seq = harvest->stats.harvests + 1;
+	harvest->active = next;
+	mutex_unlock(&hw_stats->lock);
+
+destroy_imm:
+	for (i = 0; i < num_cmd; i++)
+		ipahal_destroy_imm_cmd(cmd_pyld[i]);
+unlock:
+	us = ktime_us_delta(ktime_get(), start);
+	mutex_lock(&hw_stats->lock);
+	if (sent) {
+		harvest->stats.harvests++;
+		harvest->stats.total_us += us;
+		harvest->stats.last_us = us;
+		if (us > harvest->stats.max_us)
+			harvest->stats.max_us = us;
+	}
+	if (ret)
+		harvest->stats.fails++;
+	mutex_unlock(&hw_stats->lock);
+	mutex_unlock(&harvest->lock);
+	return ret;
+}
+
+static void ipa_hw_stats_harvest_work(struct work_struct *work)
+{
+	struct ipa_hw_stats *hw_stats = ipa3_ctx->hw_stats;
+	struct ipa_active_client_logging_info log_info;
+	u32 period_ms;
+
+	/* harvest while IPA is clocked, never vote it up for stats alone */
+	IPA_ACTIVE_CLIENTS_PREP_SPECIAL(log_info, "HW_STATS_HARVEST");
+	if (ipa3_inc_client_enable_clks_no_block(&log_info)) {
+		mutex_lock(&hw_stats->lock);
+		hw_stats->harvest.stats.skipped++;
+		mutex_unlock(&hw_stats->lock);
+	} else {
+		ipa_hw_stats_harvest();
+		ipa3_dec_client_disable_clks_no_block(&log_info);
+	}
+
+	period_ms = READ_ONCE(hw_stats->harvest.period_ms);
+	if (period_ms)
+		schedule_delayed_work(&hw_stats->harvest.work,
+			msecs_to_jiffies(period_ms));
+}
+
+static DEFINE_MUTEX(ipa_hw_stats_harvest_ctl);
+
+/**
+ * ipa_hw_stats_set_harvest_period() - Start, retime or stop the background
+ * harvest of the HW stats
+ * @period_ms: harvest cadence, 0 stops the harvester
+ *
+ * While the last harvest is at most two periods old, quota, drop and
+ * tethering queries and FnR queries that do not reset the counters are
+ * served from it instead of reading the stats SRAM. Resets, and every query
+ * once the snapshot is stale, still read the SRAM synchronously.
+ *
+ * Return: 0 on success, negative on failure
+ */
+int ipa_hw_stats_set_harvest_period(u32 period_ms)
+{
+	struct ipa_hw_stats_harvest *harvest;
+	u32 old_period_ms;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return -EPERM;
+
+	if (period_ms && (period_ms < IPA_HW_STATS_HARVEST_MIN_PERIOD_MS ||
+		period_ms > IPA_HW_STATS_HARVEST_MAX_PERIOD_MS)) {
+		IPAERR("invalid harvest period %u ms\n", period_ms);
+		return -EINVAL;
+	}
+
+	harvest = &ipa3_ctx->hw_stats->harvest;
+	mutex_lock(&ipa_hw_stats_harvest_ctl);
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
+	old_period_ms = harvest->period_ms;
+	harvest->period_ms = period_ms;
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
+
+	if (!period_ms) {
+		if (old_period_ms) {
+			cancel_delayed_work_sync(&harvest->work);
+			mutex_lock(&harvest->lock);
+			ipa_hw_stats_harvest_free();
+			mutex_unlock(&harvest->lock);
+		}
+	} else if (!old_period_ms) {
+		schedule_delayed_work(&harvest->work, 0);
+	} else {
+		mod_delayed_work(system_wq, &harvest->work,
+			msecs_to_jiffies(period_ms));
+	}
+	mutex_unlock(&ipa_hw_stats_harvest_ctl);
+
+	IPADBG("HW stats harvest period %u ms\n", period_ms);
 	return 0;
 }
 
+void ipa_hw_stats_destroy(void)
+{
+	if (!ipa3_ctx->hw_stats)
+		return;
+
+	ipa_hw_stats_set_harvest_period(0);
+	vfree(ipa3_ctx->hw_stats->harvest.teth_delta);
+	kfree(ipa3_ctx->hw_stats);
+	ipa3_ctx->hw_stats = NULL;
+}
 
 #ifndef CONFIG_DEBUG_FS
 int ipa_debugfs_init_stats(struct dentry *parent) { return 0; }
@@ -2808,6 +3376,83 @@ bail:
 	return ret;
 }
 
+static ssize_t ipa_debugfs_set_harvest_period(struct file *file,
+	const char __user *ubuf, size_t count, loff_t *ppos)
+{
+	u32 period_ms;
+	int ret;
+
+	ret = kstrtou32_from_user(ubuf, count, 0, &period_ms);
+	if (ret)
+		return ret;
+
+	ret = ipa_hw_stats_set_harvest_period(period_ms);
+	if (ret)
+		return ret;
+
+	return count;
+}
+
+static ssize_t ipa_debugfs_print_harvest(struct file *file,
+	char __user *ubuf, size_t count, loff_t *ppos)
+{
+	struct ipa_hw_stats_harvest *harvest = &ipa3_ctx->hw_stats->harvest;
+	struct ipa_hw_stats_harvest_stats stats;
+	struct ipa_hw_stats_snapshot snap = { { 0 } };
+	u64 age_us = 0;
+	u32 period_ms;
+	int nbytes;
+
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
+	stats = harvest->stats;
+	period_ms = harvest->period_ms;
+	if (harvest->active >= 0) {
+		snap = harvest->snap[harvest->active];
+		age_us = div_u64(ktime_get_ns() - snap.timestamp_ns,
+			NSEC_PER_USEC);
+	}
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
+
+	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
+		"period_ms=%u\n"
+		"seq=%llu\n"
+		"age_us=%llu\n"
+		"quota_bytes=%u\n"
+		"teth_bytes=%u\n"
+		"drop_bytes=%u\n"
+		"fnr_bytes=%u\n"
+		"harvests=%llu\n"
+		"skipped=%llu\n"
+		"fails=%llu\n"
+		"served=%llu\n"
+		"total_us=%llu\n"
+		"last_us=%u\n"
+		"max_us=%u\n"
+		"avg_us_per_harvest=%llu\n",
+		period_ms,
+		snap.seq,
+		age_us,
+		snap.size[IPAHAL_HW_STATS_QUOTA],
+		snap.size[IPAHAL_HW_STATS_TETHERING],
+		snap.size[IPAHAL_HW_STATS_DROP],
+		snap.size[IPAHAL_HW_STATS_FNR],
+		stats.harvests,
+		stats.skipped,
+		stats.fails,
+		stats.served,
+		stats.total_us,
+		stats.last_us,
+		stats.max_us,
+		stats.harvests ? div64_u64(stats.total_us, stats.harvests) : 0);
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, nbytes);
+}
+
+static const struct file_operations ipa3_harvest_ops = {
+	.read = ipa_debugfs_print_harvest,
+	.write = ipa_debugfs_set_harvest_period,
+};
+
 static const struct file_operations ipa3_quota_ops = {
 	.read = ipa_debugfs_print_quota_stats,
 	.write = ipa_debugfs_reset_quota_stats,
@@ -2883,6 +3528,13 @@ int ipa_debugfs_init_stats(struct dentry *parent)
 		goto fail;
 	}
 
+	file = debugfs_create_file("harvest", read_write_mode, dent, NULL,
+		&ipa3_harvest_ops);
+	if (IS_ERR_OR_NULL(file)) {
+		IPAERR("fail to create file %s\n", "harvest");
+		goto fail;
+	}
+
 	return 0;
 fail:
 	debugfs_remove_recursive(dent);
@@ -11,6 +11,7 @@
 #include <linux/bitops.h>
 #include <linux/cdev.h>
 #include <linux/export.h>
+#include <linux/hashtable.h>
 #include <linux/idr.h>
 #include <linux/list.h>
 #include <linux/mutex.h>
@@ -563,6 +564,8 @@ enum {
 
 #define IPA_RULE_CNT_MAX 512
 
+#define IPA_RT_TBL_NAME_HASH_BITS 5
+
 /* miscellaneous for rmnet_ipa and qmi_service */
 enum ipa_type_mode {
 	IPA_HW_TYPE,
@@ -793,6 +796,9 @@ struct ipa3_flt_entry {
  * @prev_mem: previous routing table block in sys memory
  * @id: routing table id
  * @rule_ids: common idr structure that holds the rule_id for each rule
+ * @name_node: table's link in the name index of its set
+ * @dirty: the rules changed since the table was last committed
+ * @lcl_ofst: offset of the table body in the last committed local image
  */
 struct ipa3_rt_tbl {
 	struct list_head link;
@@ -809,6 +815,9 @@ struct ipa3_rt_tbl {
 	struct ipa_mem_buffer prev_mem[IPA_RULE_TYPE_MAX];
 	int id;
 	struct idr *rule_ids;
+	struct hlist_node name_node;
+	bool dirty;
+	u32 lcl_ofst[IPA_RULE_TYPE_MAX];
 };
 
 /**
@@ -937,6 +946,10 @@ struct ipa3_hdr_proc_ctx_tbl {
  * @rule_ids: common idr structure that holds the rule_id for each rule
  * @force_sys: flag indicating if filter table is forced to be
 			located in system memory
+ * @dirty: the rules of this type changed since the last commit
+ * @stale: the hdr entry (and local body) in sram is to be written again
+ * @cmt_sys: the table was placed in system memory by the last commit
+ * @lcl_ofst: offset of the body in the last committed local image
  */
 struct ipa3_flt_tbl {
 	struct list_head head_flt_rule_list;
@@ -948,6 +961,10 @@ struct ipa3_flt_tbl {
 	bool sticky_rear;
 	struct idr *rule_ids;
 	bool force_sys[IPA_RULE_TYPE_MAX];
+	bool dirty[IPA_RULE_TYPE_MAX];
+	bool stale[IPA_RULE_TYPE_MAX];
+	bool cmt_sys[IPA_RULE_TYPE_MAX];
+	u32 lcl_ofst[IPA_RULE_TYPE_MAX];
 };
 
 struct ipa3_flt_tbl_nhash_lcl {
@@ -993,11 +1010,17 @@ struct ipa3_rt_entry {
  * @head_rt_tbl_list: collection of routing tables
  * @tbl_cnt: number of routing tables
  * @rule_ids: idr structure that holds the rule_id for each rule
+ * @name_hash: routing tables indexed by name
+ * @full_commit: the next commit renders and writes every table
+ * @lcl_img: local (sram) bodies as written by the last commit
  */
 struct ipa3_rt_tbl_set {
 	struct list_head head_rt_tbl_list;
 	u32 tbl_cnt;
 	struct idr rule_ids;
+	DECLARE_HASHTABLE(name_hash, IPA_RT_TBL_NAME_HASH_BITS);
+	bool full_commit;
+	struct ipa_mem_buffer lcl_img[IPA_RULE_TYPE_MAX];
 };
 
 /**
@@ -1486,6 +1509,32 @@ struct ipa3_nat_mem_loc_data {
 	char         *index_table_expansion_addr;
 };
 
+/**
+ * struct ipa3_table_dma_stats - TABLE_DMA batching counters
+ * @batches: requests posted
+ * @entries: writes requested
+ * @coalesced: writes dropped as the next write of the batch hits the same word
+ * @cmds: TABLE_DMA immediate commands sent
+ * @chains: descriptor chains sent
+ * @fails: requests that failed validation or submission
+ * @partial: failed requests of which earlier chains were applied
+ * @total_us: time spent posting the requests
+ * @max_entries: largest request seen
+ *
+ * Protected by the lock of the NAT memory device.
+ */
+struct ipa3_table_dma_stats {
+	u64 batches;
+	u64 entries;
+	u64 coalesced;
+	u64 cmds;
+	u64 chains;
+	u64 fails;
+	u64 partial;
+	u64 total_us;
+	u32 max_entries;
+};
+
 /**
  * struct ipa3_nat_mem - IPA NAT memory description
  * @dev: the memory device structure
@@ -1499,6 +1548,7 @@ struct ipa3_nat_mem_loc_data {
  * @ddr_in_use: is there table in ddr
  * @sram_in_use: is there table in sram
  * @mem_loc: memory specific info per table memory type
+ * @table_dma_stats: TABLE_DMA request counters, NAT and IPv6CT alike
  */
 struct ipa3_nat_mem {
 	struct ipa3_nat_ipv6ct_common_mem dev; /* this item must be first */
@@ -1518,6 +1568,8 @@ struct ipa3_nat_mem {
 	bool                         sram_in_use;
 
 	struct ipa3_nat_mem_loc_data mem_loc[IPA_NAT_MEM_IN_MAX];
+
+	struct ipa3_table_dma_stats  table_dma_stats;
 };
 
 /**
@@ -1969,13 +2021,91 @@ struct ipa_hw_stats_drop {
 	struct ipa_drop_stats_all stats;
 };
 
+/**
+ * struct ipa_hw_stats_snapshot - One harvest of the stats SRAM
+ * @mem: DMA buffer holding every harvested stats class
+ * @ofst: where each stats class starts in @mem
+ * @size: bytes harvested of each stats class, 0 if it was not
+ * @timestamp_ns: ktime_get_ns() when the harvest completed
+ * @seq: harvest sequence number
+ *
+ * The FnR counters are harvested from counter 1 on and not cleared.
+ */
+struct ipa_hw_stats_snapshot {
+	struct ipa_mem_buffer mem;
+	u32 ofst[IPAHAL_HW_STATS_MAX];
+	u32 size[IPAHAL_HW_STATS_MAX];
+	u64 timestamp_ns;
+	u64 seq;
+};
+
+/**
+ * struct ipa_hw_stats_harvest_stats - Background harvester counters
+ * @harvests: combined command sequences sent
+ * @skipped: periods skipped as IPA was not clocked
+ * @fails: harvests that failed
+ * @served: queries answered from a snapshot
+ * @total_us: time spent harvesting, parsing included
+ * @last_us: duration of the last harvest
+ * @max_us: longest harvest
+ */
+struct ipa_hw_stats_harvest_stats {
+	u64 harvests;
+	u64 skipped;
+	u64 fails;
+	u64 served;
+	u64 total_us;
+	u32 last_us;
+	u32 max_us;
+};
+
+/**
+ * struct ipa_hw_stats_harvest - Background harvester of the HW stats
+ * @lock: serializes harvests, which DMA into the snapshot not published
+ * @work: periodic harvest
+ * @period_ms: harvest cadence, 0 when the harvester is stopped
+ * @snap: the two snapshots, DMA goes to the one not published
+ * @active: index in @snap of the published snapshot, -1 if there is none
+ * @quota: parse buffer of the quota stats
+ * @teth: parse buffer of the tethering stats
+ * @drop: parse buffer of the drop stats
+ * @teth_delta: tethering counts harvested since the last
+ *  ipa_get_teth_stats(), per producer
+ * @fnr_gen: bumped whenever the FnR counters are reset or written outside
+ *  of the harvester, a harvest that sees it change drops its FnR part
+ * @stats: harvester counters
+ *
+ * @active, @teth_delta, @fnr_gen and @stats are protected by the lock of
+ * struct ipa_hw_stats.
+ */
+struct ipa_hw_stats_harvest {
+	struct mutex lock;
+	struct delayed_work work;
+	u32 period_ms;
+	struct ipa_hw_stats_snapshot snap[2];
+	int active;
+	struct ipahal_stats_quota_all *quota;
+	struct ipahal_stats_tethering_all *teth;
+	struct ipahal_stats_drop_all *drop;
+	struct ipa_quota_stats_all *teth_delta;
+	u32 fnr_gen;
+	struct ipa_hw_stats_harvest_stats stats;
+};
+
+/**
+ * struct ipa_hw_stats - HW stats context
+ * @lock: protects the driver caches of the stats and the published
+ *  snapshot of the harvester
+ */
 struct ipa_hw_stats {
 	bool enabled;
+	struct mutex lock;
 	struct ipa_hw_stats_quota quota;
 	struct ipa_hw_stats_teth teth;
 	struct ipa_hw_stats_flt_rt flt_rt;
 	struct ipa_hw_stats_drop drop;
 	bool teth_stats_enabled;
+	struct ipa_hw_stats_harvest harvest;
 };
 
 struct ipa_cne_evt {
@@ -2215,6 +2345,8 @@ enum ipa_per_usb_enum_type_e {
  * @resume_on_connect: resume ep on ipa connect
  * @flt_tbl: list of all IPA filter tables
  * @flt_rule_ids: idr structure that holds the rule_id for each rule
+ * @flt_full_commit: the next flt commit renders and writes every table
+ * @flt_lcl_img: local (sram) flt bodies as written by the last commit
  * @mode: IPA operating mode
  * @mmio: iomem
  * @ipa_wrapper_base: IPA wrapper base address
@@ -2236,6 +2368,9 @@ enum ipa_per_usb_enum_type_e {
  * @rx_pkt_wrapper_cache: Rx packets cache
  * @rt_idx_bitmap: routing table index bitmap
  * @lock: this does NOT protect the linked lists within ipa3_sys_context
+ * @flt_tbl_lock: per IP family, protects the flt tables, rules and commit
+ * @rt_tbl_lock: per IP family, protects the rt tables, rules and commit
+ * @hdr_tbl_lock: protects the hdr and proc ctx tables and commit
  * @smem_sz: shared memory size available for SW use starting
  *  from non-restricted bytes
  * @smem_restricted_bytes: the bytes that SW should not use in the shared mem
@@ -2361,6 +2496,13 @@ struct ipa3_context {
 	struct kmem_cache *rx_pkt_wrapper_cache;
 	unsigned long rt_idx_bitmap[IPA_IP_MAX];
 	struct mutex lock;
+	/*
+	 * rule database lock order, outermost first: flt_tbl_lock[ip],
+	 * rt_tbl_lock[ip], hdr_tbl_lock. The two families never nest.
+	 */
+	struct mutex flt_tbl_lock[IPA_IP_MAX];
+	struct mutex rt_tbl_lock[IPA_IP_MAX];
+	struct mutex hdr_tbl_lock;
 	u16 smem_sz;
 	u16 smem_restricted_bytes;
 	u16 smem_reqd_sz;
@@ -2380,6 +2522,8 @@ struct ipa3_context {
 	bool flt_tbl_hash_lcl[IPA_IP_MAX];
 	bool flt_tbl_nhash_lcl[IPA_IP_MAX];
 	struct list_head flt_tbl_nhash_lcl_list[IPA_IP_MAX];
+	bool flt_full_commit[IPA_IP_MAX];
+	struct ipa_mem_buffer flt_lcl_img[IPA_IP_MAX][IPA_RULE_TYPE_MAX];
 	struct ipa3_active_clients ipa3_active_clients;
 	struct ipa3_active_clients_log_ctx ipa3_active_clients_logging;
 	struct workqueue_struct *power_mgmt_wq;
@@ -3432,6 +3576,9 @@ int ipa3_generate_hw_rule(enum ipa_ip_type ip,
 			 u16 *en_rule);
 int ipa3_init_hw(void);
 struct ipa3_rt_tbl *__ipa3_find_rt_tbl(enum ipa_ip_type ip, const char *name);
+void ipa3_rt_invalidate_hw_img(enum ipa_ip_type ip);
+void ipa3_rt_destroy_hw_img(void);
+void ipa3_flt_invalidate_hw_img(enum ipa_ip_type ip);
 int ipa3_set_single_ndp_per_mbim(bool enable);
 void ipa3_debugfs_init(void);
 void ipa3_debugfs_remove(void);
@@ -3535,6 +3682,8 @@ int ipa3_alloc_counter_id(struct ipa_ioc_flt_rt_counter_alloc *counter);
 void ipa3_counter_remove_hdl(int hdl);
 void ipa3_counter_id_remove_all(void);
 int ipa3_id_alloc(void *ptr);
+int ipa3_id_alloc_ip(void *ptr, enum ipa_ip_type ip);
+enum ipa_ip_type ipa3_id_ip(u32 id);
 bool ipa3_check_idr_if_freed(void *ptr);
 void *ipa3_id_find(u32 id);
 void ipa3_id_remove(u32 id);
@@ -3654,6 +3803,10 @@ int ipa_reset_all_teth_stats(void);
 
 int ipa_get_flt_rt_stats(struct ipa_ioc_flt_rt_query *query);
 
+int ipa_hw_stats_set_harvest_period(u32 period_ms);
+
+void ipa_hw_stats_destroy(void);
+
 int ipa_set_flt_rt_stats(int index, struct ipa_flt_rt_stats stats);
 
 bool ipa_get_fnr_info(struct ipacm_fnr_info *fnr_info);
@@ -37,7 +37,14 @@
 
 #define IPA_NAT_MAX_NUM_OF_INIT_CMD_DESC 4
 #define IPA_IPV6CT_MAX_NUM_OF_INIT_CMD_DESC 3
-#define IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC 5
+
+/*
+ * TABLE_DMA requests are taken up to IPA_TABLE_DMA_MAX_ENTRIES writes and
+ * posted in chains no longer than what ipa3_send_cmd() can take at once
+ * (IPA_SEND_MAX_DESC).
+ */
+#define IPA_TABLE_DMA_MAX_ENTRIES 128
+#define IPA_TABLE_DMA_MAX_CHAIN_DESC 20
 
 /*
  * The base table max entries is limited by index into table 13 bits number.
@@ -1927,24 +1934,62 @@ static int ipa3_table_validate_table_dma_one(
 }
 
 
-/**
- * ipa3_table_dma_cmd() - Post TABLE_DMA command to IPA HW
- * @dma:	[in] initialization command attributes
+/*
+ * ipa3_table_dma_coalesce() - Pick the writes of a TABLE_DMA request that
+ *  are worth sending
+ * @dma:	[in] the request
+ * @idx:	[out] indexes into @dma->dma of the writes to send, in order
  *
- * Called by NAT/IPv6CT clients to post TABLE_DMA command to IPA HW
+ * TABLE_DMA moves a single 16 bit word, so only writes to the very same word
+ * can be folded: a write is dropped when the write right after it in the
+ * request hits the same word. Writes further apart are all kept, as a write
+ * to another word of the table in between, e.g. linking an entry before
+ * enabling it, must land in the order the client asked for.
  *
- * Returns:	0 on success, negative on failure
+ * Returns:	the number of writes to send
  */
-int ipa3_table_dma_cmd(
-	struct ipa_ioc_nat_dma_cmd *dma)
+static u8 ipa3_table_dma_coalesce(
+	struct ipa_ioc_nat_dma_cmd *dma,
+	u8                         *idx)
 {
-	struct ipa3_nat_ipv6ct_common_mem *dev = &ipa3_ctx->nat_mem.dev;
+	struct ipa_ioc_nat_dma_one *one, *next;
+	u8 cnt, num = 0;
 
+	for (cnt = 0; cnt < dma->entries; ++cnt) {
+		one = &dma->dma[cnt];
+		if (cnt + 1 < dma->entries) {
+			next = &dma->dma[cnt + 1];
+			if (next->table_index == one->table_index &&
+				next->base_addr == one->base_addr &&
+				next->offset == one->offset)
+				continue;
+		}
+		idx[num++] = cnt;
+	}
+
+	return num;
+}
+
+/*
+ * ipa3_table_dma_send_chain() - Post one descriptor chain of table writes
+ * @dma:	[in] the request
+ * @idx:	[in] indexes into @dma->dma of the writes of this chain
+ * @num:	[in] number of writes, fitting the chain with its leading ICs
+ * @cmd_pyld:	[in] scratch array of IPA_TABLE_DMA_MAX_CHAIN_DESC payloads
+ * @desc:	[in] scratch array of IPA_TABLE_DMA_MAX_CHAIN_DESC descriptors
+ *
+ * Returns:	0 on success, negative on failure
+ */
+static int ipa3_table_dma_send_chain(
+	struct ipa_ioc_nat_dma_cmd  *dma,
+	const u8                    *idx,
+	u8                           num,
+	struct ipahal_imm_cmd_pyld **cmd_pyld,
+	struct ipa3_desc            *desc)
+{
 	enum ipahal_imm_cmd_name cmd_name = IPA_IMM_CMD_NAT_DMA;
 
 	struct ipahal_imm_cmd_table_dma cmd;
-	struct ipahal_imm_cmd_pyld *cmd_pyld[IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC];
-	struct ipa3_desc desc[IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC];
 
 	uint8_t cnt, num_cmd = 0;
 
@@ -1952,59 +1997,11 @@ int ipa3_table_dma_cmd(
 	int i;
 	struct ipahal_reg_valmask valmask;
 	struct ipahal_imm_cmd_register_write reg_write_coal_close;
-	int max_dma_table_cmds = IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC;
-
-	IPADBG("In\n");
-
-	if (!sram_compatible)
-		dma->mem_type = 0;
-
-	if (!dev->is_dev_init) {
-		IPAERR_RL("NAT hasn't been initialized\n");
-		result = -EPERM;
-		goto bail;
-	}
-
-	if (!IPA_VALID_NAT_MEM_IN(dma->mem_type)) {
-		IPAERR_RL("Invalid ipa3_nat_mem_in type (%u)\n",
-				  dma->mem_type);
-		result = -EPERM;
-		goto bail;
-	}
-
-	IPADBG("nmi(%s)\n", ipa3_nat_mem_in_as_str(dma->mem_type));
 
 	memset(&cmd, 0, sizeof(cmd));
-	memset(cmd_pyld, 0, sizeof(cmd_pyld));
-	memset(desc, 0, sizeof(desc));
-
-	/**
-	 * We use a descriptor for closing coalsceing endpoint
-	 * by immediate command. So, DMA entries should be less than
-	 * IPA_MAX_NUM_OF_TABLE_DMA_CMD_DESC - 1 to overcome
-	 * buffer overflow of ipa3_desc array.
-	 */
-	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) != -1)
-		max_dma_table_cmds -= 1;
-
-	if (!dma->entries || dma->entries > (max_dma_table_cmds - 1)) {
-		IPAERR_RL("Invalid number of entries %d\n",
-			dma->entries);
-		result = -EPERM;
-		goto bail;
-	}
-
-	for (cnt = 0; cnt < dma->entries; ++cnt) {
-
-		result = ipa3_table_validate_table_dma_one(
-			dma->mem_type, &dma->dma[cnt]);
-
-		if (result) {
-			IPAERR_RL("Table DMA command parameter %d is invalid\n",
-					  cnt);
-			goto bail;
-		}
-	}
+	memset(cmd_pyld, 0,
+		IPA_TABLE_DMA_MAX_CHAIN_DESC * sizeof(*cmd_pyld));
+	memset(desc, 0, IPA_TABLE_DMA_MAX_CHAIN_DESC * sizeof(*desc));
 
 	/* IC to close the coal frame before HPS Clear if coal is enabled */
 	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) != -1
@@ -2058,12 +2055,12 @@ int ipa3_table_dma_cmd(
 	if (ipa3_ctx->ipa_hw_type >= IPA_HW_v4_0)
 		cmd_name = IPA_IMM_CMD_TABLE_DMA;
 
-	for (cnt = 0; cnt < dma->entries; ++cnt) {
+	for (cnt = 0; cnt < num; ++cnt) {
 
-		cmd.table_index = dma->dma[cnt].table_index;
-		cmd.base_addr   = dma->dma[cnt].base_addr;
-		cmd.offset      = dma->dma[cnt].offset;
-		cmd.data        = dma->dma[cnt].data;
+		cmd.table_index = dma->dma[idx[cnt]].table_index;
+		cmd.base_addr   = dma->dma[idx[cnt]].base_addr;
+		cmd.offset      = dma->dma[idx[cnt]].offset;
+		cmd.data        = dma->dma[idx[cnt]].data;
 
 		cmd_pyld[num_cmd] =
 			ipahal_construct_imm_cmd(cmd_name, &cmd, false);
@@ -2088,6 +2085,145 @@ destroy_imm_cmd:
 	for (cnt = 0; cnt < num_cmd; ++cnt)
 		ipahal_destroy_imm_cmd(cmd_pyld[cnt]);
 
+	return result;
+}
+
+/**
+ * ipa3_table_dma_cmd() - Post TABLE_DMA command to IPA HW
+ * @dma:	[in] initialization command attributes
+ *
+ * Called by NAT/IPv6CT clients to post TABLE_DMA command to IPA HW
+ *
+ * Up to IPA_TABLE_DMA_MAX_ENTRIES writes are taken at once. They are all
+ * validated before any is sent, folded by ipa3_table_dma_coalesce() and
+ * posted in as few descriptor chains as ipa3_send_cmd() allows, each
+ * behind a single pipeline clear.
+ *
+ * The chains are not applied atomically. Should a chain fail after earlier
+ * ones were sent, the writes of those stay in the tables and -EAGAIN is
+ * returned. Every write sets a word to a given value, so the client may
+ * post the whole request again.
+ *
+ * Returns:	0 on success, -EAGAIN when the request was partially applied,
+ *		other negative values when nothing was written
+ */
+int ipa3_table_dma_cmd(
+	struct ipa_ioc_nat_dma_cmd *dma)
+{
+	struct ipa3_nat_ipv6ct_common_mem *dev = &ipa3_ctx->nat_mem.dev;
+	struct ipa3_table_dma_stats *stats =
+		&ipa3_ctx->nat_mem.table_dma_stats;
+
+	struct ipahal_imm_cmd_pyld **cmd_pyld = NULL;
+	struct ipa3_desc *desc = NULL;
+
+	u8 idx[IPA_TABLE_DMA_MAX_ENTRIES];
+	uint8_t cnt, num = 0, sent = 0, chain_entries;
+	u32 chains = 0;
+	ktime_t start;
+
+	int result = 0;
+
+	IPADBG("In\n");
+
+	if (!sram_compatible)
+		dma->mem_type = 0;
+
+	if (!dev->is_dev_init) {
+		IPAERR_RL("NAT hasn't been initialized\n");
+		result = -EPERM;
+		goto bail;
+	}
+
+	if (!IPA_VALID_NAT_MEM_IN(dma->mem_type)) {
+		IPAERR_RL("Invalid ipa3_nat_mem_in type (%u)\n",
+				  dma->mem_type);
+		result = -EPERM;
+		goto bail;
+	}
+
+	IPADBG("nmi(%s)\n", ipa3_nat_mem_in_as_str(dma->mem_type));
+
+	start = ktime_get();
+
+	if (!dma->entries || dma->entries > IPA_TABLE_DMA_MAX_ENTRIES) {
+		IPAERR_RL("Invalid number of entries %d\n",
+			dma->entries);
+		result = -EPERM;
+		goto update_stats;
+	}
+
+	for (cnt = 0; cnt < dma->entries; ++cnt) {
+
+		result = ipa3_table_validate_table_dma_one(
+			dma->mem_type, &dma->dma[cnt]);
+
+		if (result) {
+			IPAERR_RL("Table DMA command parameter %d is invalid\n",
+					  cnt);
+			goto update_stats;
+		}
+	}
+
+	num = ipa3_table_dma_coalesce(dma, idx);
+
+	/**
+	 * Each chain starts with the NOP IC and, when coalescing is
+	 * enabled, the IC closing the coalescing endpoint.
+	 */
+	chain_entries = IPA_TABLE_DMA_MAX_CHAIN_DESC - 1;
+	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) != -1)
+		chain_entries -= 1;
+
+	cmd_pyld = kcalloc(IPA_TABLE_DMA_MAX_CHAIN_DESC, sizeof(*cmd_pyld),
+		GFP_KERNEL);
+	desc = kcalloc(IPA_TABLE_DMA_MAX_CHAIN_DESC, sizeof(*desc),
+		GFP_KERNEL);
+	if (!cmd_pyld || !desc) {
+		result = -ENOMEM;
+		goto free_mem;
+	}
+
+	for (sent = 0; sent < num; sent += cnt) {
+		cnt = min_t(uint8_t, num - sent, chain_entries);
+
+		result = ipa3_table_dma_send_chain(
+			dma, &idx[sent], cnt, cmd_pyld, desc);
+
+		if (result) {
+			if (sent) {
+				IPAERR_RL("%u of %u writes applied\n",
+					sent, num);
+				result = -EAGAIN;
+			}
+			goto free_mem;
+		}
+
+		++chains;
+	}
+
+free_mem:
+	kfree(desc);
+	kfree(cmd_pyld);
+
+update_stats:
+	mutex_lock(&dev->lock);
+	stats->batches++;
+	stats->entries += dma->entries;
+	/* num stays 0 for requests rejected before coalescing */
+	if (num)
+		stats->coalesced += dma->entries - num;
+	stats->cmds += sent;
+	stats->chains += chains;
+	if (dma->entries > stats->max_entries)
+		stats->max_entries = dma->entries;
+	if (result)
+		stats->fails++;
+	if (result == -EAGAIN)
+		stats->partial++;
+	stats->total_us += ktime_us_delta(ktime_get(), start);
+	mutex_unlock(&dev->lock);
+
 bail:
 	IPADBG("Out\n");
 
@@ -5,7 +5,9 @@
  */
 
 #include <linux/bitops.h>
+#include <linux/hashtable.h>
 #include <linux/idr.h>
+#include <linux/jhash.h>
 #include "ipa_i.h"
 #include "ipahal.h"
 #include "ipahal_fltrt.h"
@@ -143,6 +145,12 @@ static int ipa_generate_rt_hw_rule(enum ipa_ip_type ip,
  * @body_ofst: the offset of the rules body from the rules header at
  *  ipa sram (for local body usage)
  * @apps_start_idx: the first rt table index of apps tables
+ * @lcl_dirty_ofst: [out] offset in @base of the first local body byte that
+ *  differs from the last committed image, U32_MAX if none does
+ *
+ * Tables that did not change since the last commit are not rendered again:
+ * a system body is pointed at as is and a local body is copied from the
+ * image the last commit wrote.
  *
  * Returns: 0 on success, negative on failure
  *
@@ -151,26 +159,45 @@ static int ipa_generate_rt_hw_rule(enum ipa_ip_type ip,
  */
 static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 	enum ipa_rule_type rlt, u8 *base, u8 *hdr,
-	u32 body_ofst, u32 apps_start_idx)
+	u32 body_ofst, u32 apps_start_idx, u32 *lcl_dirty_ofst)
 {
 	struct ipa3_rt_tbl_set *set;
 	struct ipa3_rt_tbl *tbl;
 	struct ipa_mem_buffer tbl_mem;
+	struct ipa_mem_buffer *img;
 	u8 *tbl_mem_buf;
 	struct ipa3_rt_entry *entry;
 	int res;
 	u64 offset;
 	u8 *body_i;
+	u32 bdy_sz;
+	u32 lcl_ofst;
+	bool reuse;
 
 	set = &ipa3_ctx->rt_tbl_set[ip];
+	img = &set->lcl_img[rlt];
+	*lcl_dirty_ofst = U32_MAX;
 	body_i = base;
 	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
 		if (tbl->sz[rlt] == 0)
 			continue;
+		bdy_sz = tbl->sz[rlt] - ipahal_get_hw_tbl_hdr_width();
+		reuse = !tbl->dirty && !set->full_commit;
 		if (tbl->in_sys[rlt]) {
+			if (reuse && tbl->curr_mem[rlt].phys_base &&
+				tbl->curr_mem[rlt].size == bdy_sz +
+				ipahal_get_hw_prefetch_buf_size()) {
+				if (ipahal_fltrt_write_addr_to_hdr(
+					tbl->curr_mem[rlt].phys_base, hdr,
+					tbl->idx - apps_start_idx, true)) {
+					IPAERR_RL("fail to wrt sys tbl addr to hdr\n");
+					goto err;
+				}
+				continue;
+			}
+
 			/* only body (no header) */
-			tbl_mem.size = tbl->sz[rlt] -
-				ipahal_get_hw_tbl_hdr_width();
+			tbl_mem.size = bdy_sz;
 			/* Add prefetech buf size. */
 			tbl_mem.size +=
 				ipahal_get_hw_prefetch_buf_size();
@@ -208,7 +235,8 @@ static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 			}
 			tbl->curr_mem[rlt] = tbl_mem;
 		} else {
-			offset = body_i - base + body_ofst;
+			lcl_ofst = body_i - base;
+			offset = lcl_ofst + body_ofst;
 
 			/* update the hdr at the right index */
 			if (ipahal_fltrt_write_addr_to_hdr(offset, hdr,
@@ -217,20 +245,35 @@ static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 				goto hdr_update_fail;
 			}
 
-			/* generate the rule-set */
-			list_for_each_entry(entry, &tbl->head_rt_rule_list,
-					link) {
-				if (IPA_RT_GET_RULE_TYPE(entry) != rlt)
-					continue;
-				res = ipa_generate_rt_hw_rule(ip, entry,
-					body_i);
-				if (res) {
-					IPAERR_RL("failed to gen HW RT rule\n");
-					goto err;
+			if (reuse && img->base &&
+				tbl->lcl_ofst[rlt] + bdy_sz <= img->size) {
+				memcpy(body_i, img->base + tbl->lcl_ofst[rlt],
+					bdy_sz);
+				body_i += bdy_sz;
+			} else {
+				/* generate the rule-set */
+				list_for_each_entry(entry,
+					&tbl->head_rt_rule_list, link) {
+					if (IPA_RT_GET_RULE_TYPE(entry) != rlt)
+						continue;
+					res = ipa_generate_rt_hw_rule(ip, entry,
+						body_i);
+					if (res) {
+						IPAERR_RL(
+						"failed to gen HW RT rule\n");
+						goto err;
+					}
+					body_i += entry->hw_len;
 				}
-				body_i += entry->hw_len;
+				reuse = false;
 			}
 
+			/* a moved body has to be written again as well */
+			if ((!reuse || tbl->lcl_ofst[rlt] != lcl_ofst) &&
+				lcl_ofst < *lcl_dirty_ofst)
+				*lcl_dirty_ofst = lcl_ofst;
+			tbl->lcl_ofst[rlt] = lcl_ofst;
+
 			/**
 			 * advance body_i to next table alignment as local
 			 * tables
@@ -365,11 +408,14 @@ static int ipa_prep_rt_tbl_for_cmt(enum ipa_ip_type ip,
  * @alloc_params: IN/OUT parameters to hold info regard the tables headers
  *  and bodies on DDR (DMA buffers), and needed info for the allocation
  *  that the HAL needs
+ * @hash_dirty_ofst: [out] first changed byte of the hashable local bodies
+ * @nhash_dirty_ofst: [out] first changed byte of the non-hashable local bodies
  *
  * Return: 0 on success, negative on failure
  */
 static int ipa_generate_rt_hw_tbl_img(enum ipa_ip_type ip,
-	struct ipahal_fltrt_alloc_imgs_params *alloc_params)
+	struct ipahal_fltrt_alloc_imgs_params *alloc_params,
+	u32 *hash_dirty_ofst, u32 *nhash_dirty_ofst)
 {
 	u32 hash_bdy_start_ofst, nhash_bdy_start_ofst;
 	u32 apps_start_idx;
@@ -397,14 +443,14 @@ static int ipa_generate_rt_hw_tbl_img(enum ipa_ip_type ip,
 
 	if (ipa_translate_rt_tbl_to_hw_fmt(ip, IPA_RULE_HASHABLE,
 		alloc_params->hash_bdy.base, alloc_params->hash_hdr.base,
-		hash_bdy_start_ofst, apps_start_idx)) {
+		hash_bdy_start_ofst, apps_start_idx, hash_dirty_ofst)) {
 		IPAERR("fail to translate hashable rt tbls to hw format\n");
 		rc = -EPERM;
 		goto translate_fail;
 	}
 	if (ipa_translate_rt_tbl_to_hw_fmt(ip, IPA_RULE_NON_HASHABLE,
 		alloc_params->nhash_bdy.base, alloc_params->nhash_hdr.base,
-		nhash_bdy_start_ofst, apps_start_idx)) {
+		nhash_bdy_start_ofst, apps_start_idx, nhash_dirty_ofst)) {
 		IPAERR("fail to translate non-hashable rt tbls to hw format\n");
 		rc = -EPERM;
 		goto translate_fail;
@@ -454,11 +500,66 @@ static bool ipa_rt_valid_lcl_tbl_size(enum ipa_ip_type ipt,
 	return false;
 }
 
+/**
+ * ipa_rt_keep_lcl_img() - keep the local bodies just written to sram so the
+ *  next commit can copy unchanged tables out of them
+ * @img: the kept image of the previous commit, released
+ * @bdy: the bodies of this commit, ownership moves to @img
+ */
+static void ipa_rt_keep_lcl_img(struct ipa_mem_buffer *img,
+	struct ipa_mem_buffer *bdy)
+{
+	if (img->size)
+		ipahal_free_dma_mem(img);
+	*img = *bdy;
+	memset(bdy, 0, sizeof(*bdy));
+}
+
+/**
+ * ipa3_rt_invalidate_hw_img() - forget what the last commit wrote to the hw
+ *  so the next commit renders and writes every table again
+ * @ip: the ip address family type
+ *
+ * To be called whenever the rt sram is written outside of
+ * __ipa_commit_rt_v3(), e.g. on rt block init.
+ */
+void ipa3_rt_invalidate_hw_img(enum ipa_ip_type ip)
+{
+	ipa3_ctx->rt_tbl_set[ip].full_commit = true;
+}
+
+/**
+ * ipa3_rt_destroy_hw_img() - free the local bodies kept from the last commit
+ *  of both ip families, on teardown while ipahal is still up
+ */
+void ipa3_rt_destroy_hw_img(void)
+{
+	struct ipa3_rt_tbl_set *set;
+	enum ipa_ip_type ip;
+	int rlt;
+
+	for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++) {
+		mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
+		set = &ipa3_ctx->rt_tbl_set[ip];
+		for (rlt = 0; rlt < IPA_RULE_TYPE_MAX; rlt++) {
+			if (set->lcl_img[rlt].size)
+				ipahal_free_dma_mem(&set->lcl_img[rlt]);
+			memset(&set->lcl_img[rlt], 0, sizeof(set->lcl_img[rlt]));
+		}
+		set->full_commit = true;
+		mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
+	}
+}
+
 /**
  * __ipa_commit_rt_v3() - commit rt tables to the hw
  * commit the headers and the bodies if are local with internal cache flushing
  * @ipt: the ip address family type
  *
+ * Only the tables marked dirty since the last commit are rendered again and
+ * only the part of the local bodies that changed is written to sram. The
+ * headers are small and always written whole.
+ *
  * Return: 0 on success, negative on failure
  */
 int __ipa_commit_rt_v3(enum ipa_ip_type ip)
@@ -481,6 +582,10 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 	struct ipa3_rt_tbl *tbl;
 	u32 tbl_hdr_width;
 	struct ipahal_imm_cmd_register_write reg_write_coal_close;
+	u32 hash_dirty_ofst, nhash_dirty_ofst;
+	bool committed = false;
+
+	lockdep_assert_held(&ipa3_ctx->rt_tbl_lock[ip]);
 
 	tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
 	memset(desc, 0, sizeof(desc));
@@ -532,9 +637,13 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		goto no_rt_tbls;
 	}
 
+	/* the rules are rendered with the offsets of their hdr and proc ctx */
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	set = &ipa3_ctx->rt_tbl_set[ip];
 	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
-		if (ipa_prep_rt_tbl_for_cmt(ip, tbl)) {
+		if ((tbl->dirty || set->full_commit) &&
+			ipa_prep_rt_tbl_for_cmt(ip, tbl)) {
+			mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 			rc = -EPERM;
 			goto no_rt_tbls;
 		}
@@ -554,11 +663,14 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		}
 	}
 
-	if (ipa_generate_rt_hw_tbl_img(ip, &alloc_params)) {
+	if (ipa_generate_rt_hw_tbl_img(ip, &alloc_params,
+		&hash_dirty_ofst, &nhash_dirty_ofst)) {
 		IPAERR("fail to generate RT HW TBL images. IP %d\n", ip);
+		mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 		rc = -EFAULT;
 		goto no_rt_tbls;
 	}
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 
 	if (!ipa_rt_valid_lcl_tbl_size(ip, IPA_RULE_HASHABLE,
 		&alloc_params.hash_bdy)) {
@@ -681,7 +793,7 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		num_cmd++;
 	}
 
-	if (lcl_nhash) {
+	if (lcl_nhash && nhash_dirty_ofst < alloc_params.nhash_bdy.size) {
 		if (num_cmd >= IPA_RT_MAX_NUM_OF_COMMIT_TABLES_CMD_DESC) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -689,12 +801,15 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 			goto fail_imm_cmd_construct;
 		}
 
+		IPADBG_LOW("nhash bdy write from ofst %u of %u\n",
+			nhash_dirty_ofst, alloc_params.nhash_bdy.size);
 		mem_cmd.is_read = false;
 		mem_cmd.skip_pipeline_clear = false;
 		mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-		mem_cmd.size = alloc_params.nhash_bdy.size;
-		mem_cmd.system_addr = alloc_params.nhash_bdy.phys_base;
-		mem_cmd.local_addr = lcl_nhash_bdy;
+		mem_cmd.size = alloc_params.nhash_bdy.size - nhash_dirty_ofst;
+		mem_cmd.system_addr = alloc_params.nhash_bdy.phys_base +
+			nhash_dirty_ofst;
+		mem_cmd.local_addr = lcl_nhash_bdy + nhash_dirty_ofst;
 		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
 			IPA_IMM_CMD_DMA_SHARED_MEM, &mem_cmd, false);
 		if (!cmd_pyld[num_cmd]) {
@@ -705,7 +820,7 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
 		num_cmd++;
 	}
-	if (lcl_hash) {
+	if (lcl_hash && hash_dirty_ofst < alloc_params.hash_bdy.size) {
 		if (num_cmd >= IPA_RT_MAX_NUM_OF_COMMIT_TABLES_CMD_DESC) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -713,12 +828,15 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 			goto fail_imm_cmd_construct;
 		}
 
+		IPADBG_LOW("hash bdy write from ofst %u of %u\n",
+			hash_dirty_ofst, alloc_params.hash_bdy.size);
 		mem_cmd.is_read = false;
 		mem_cmd.skip_pipeline_clear = false;
 		mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-		mem_cmd.size = alloc_params.hash_bdy.size;
-		mem_cmd.system_addr = alloc_params.hash_bdy.phys_base;
-		mem_cmd.local_addr = lcl_hash_bdy;
+		mem_cmd.size = alloc_params.hash_bdy.size - hash_dirty_ofst;
+		mem_cmd.system_addr = alloc_params.hash_bdy.phys_base +
+			hash_dirty_ofst;
+		mem_cmd.local_addr = lcl_hash_bdy + hash_dirty_ofst;
 		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
 			IPA_IMM_CMD_DMA_SHARED_MEM, &mem_cmd, false);
 		if (!cmd_pyld[num_cmd]) {
@@ -760,6 +878,16 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 
 	__ipa_reap_sys_rt_tbls(ip);
 
+	/* sram now matches the sw tables */
+	list_for_each_entry(tbl, &set->head_rt_tbl_list, link)
+		tbl->dirty = false;
+	ipa_rt_keep_lcl_img(&set->lcl_img[IPA_RULE_HASHABLE],
+		&alloc_params.hash_bdy);
+	ipa_rt_keep_lcl_img(&set->lcl_img[IPA_RULE_NON_HASHABLE],
+		&alloc_params.nhash_bdy);
+	set->full_commit = false;
+	committed = true;
+
 fail_imm_cmd_construct:
 	for (i = 0 ; i < num_cmd ; i++)
 		ipahal_destroy_imm_cmd(cmd_pyld[i]);
@@ -773,6 +901,9 @@ fail_size_valid:
 		ipahal_free_dma_mem(&alloc_params.nhash_bdy);
 
 no_rt_tbls:
+	/* the local body offsets may no longer match what is in sram */
+	if (!committed)
+		ipa3_rt_invalidate_hw_img(ip);
 	return rc;
 }
 
@@ -789,14 +920,19 @@ struct ipa3_rt_tbl *__ipa3_find_rt_tbl(enum ipa_ip_type ip, const char *name)
 {
 	struct ipa3_rt_tbl *entry;
 	struct ipa3_rt_tbl_set *set;
+	size_t len;
 
-	if (strnlen(name, IPA_RESOURCE_NAME_MAX) == IPA_RESOURCE_NAME_MAX) {
+	lockdep_assert_held(&ipa3_ctx->rt_tbl_lock[ip]);
+
+	len = strnlen(name, IPA_RESOURCE_NAME_MAX);
+	if (len == IPA_RESOURCE_NAME_MAX) {
 		IPAERR_RL("Name too long: %s\n", name);
 		return NULL;
 	}
 
 	set = &ipa3_ctx->rt_tbl_set[ip];
-	list_for_each_entry(entry, &set->head_rt_tbl_list, link) {
+	hash_for_each_possible(set->name_hash, entry, name_node,
+		jhash(name, len, 0)) {
 		if (!ipa3_check_idr_if_freed(entry) &&
 			!strcmp(name, entry->name))
 			return entry;
@@ -822,16 +958,16 @@ int ipa3_query_rt_index(struct ipa_ioc_get_rt_tbl_indx *in)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[in->ip]);
 	in->name[IPA_RESOURCE_NAME_MAX-1] = '\0';
 	/* check if this table exists */
 	entry = __ipa3_find_rt_tbl(in->ip, in->name);
 	if (!entry) {
-		mutex_unlock(&ipa3_ctx->lock);
+		mutex_unlock(&ipa3_ctx->rt_tbl_lock[in->ip]);
 		return -EFAULT;
 	}
 	in->idx  = entry->idx;
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[in->ip]);
 	return 0;
 }
 
@@ -896,12 +1032,15 @@ static struct ipa3_rt_tbl *__ipa_add_rt_tbl(enum ipa_ip_type ip,
 		entry->in_sys[IPA_RULE_NON_HASHABLE] = !ipa3_ctx->rt_tbl_nhash_lcl[ip];
 		set->tbl_cnt++;
 		entry->rule_ids = &set->rule_ids;
+		entry->dirty = true;
 		list_add(&entry->link, &set->head_rt_tbl_list);
+		hash_add(set->name_hash, &entry->name_node,
+			jhash(entry->name, strlen(entry->name), 0));
 
 		IPADBG("add rt tbl idx=%d tbl_cnt=%d ip=%d\n", entry->idx,
 				set->tbl_cnt, ip);
 
-		id = ipa3_id_alloc(entry);
+		id = ipa3_id_alloc_ip(entry, ip);
 		if (id < 0) {
 			IPAERR_RL("failed to add to tree\n");
 			WARN_ON_RATELIMIT_IPA(1);
@@ -914,6 +1053,7 @@ static struct ipa3_rt_tbl *__ipa_add_rt_tbl(enum ipa_ip_type ip,
 ipa_insert_failed:
 	set->tbl_cnt--;
 	list_del(&entry->link);
+	hash_del(&entry->name_node);
 	idr_destroy(entry->rule_ids);
 fail_rt_idx_alloc:
 	entry->cookie = 0;
@@ -947,9 +1087,11 @@ static int __ipa_del_rt_tbl(struct ipa3_rt_tbl *entry)
 		return -EPERM;
 	}
 
+	lockdep_assert_held(&ipa3_ctx->rt_tbl_lock[ip]);
 	rset = &ipa3_ctx->reap_rt_tbl_set[ip];
 
 	entry->rule_ids = NULL;
+	hash_del(&entry->name_node);
 	if (entry->in_sys[IPA_RULE_HASHABLE] ||
 		entry->in_sys[IPA_RULE_NON_HASHABLE]) {
 		list_move(&entry->link, &rset->head_rt_tbl_list);
@@ -1107,6 +1249,8 @@ static int __ipa_finish_rt_rule_add(struct ipa3_rt_entry *entry, u32 *rule_hdl,
 {
 	int id, res = 0;
 
+	/* the rule is already linked, even a failed add reorders the table */
+	tbl->dirty = true;
 	if (tbl->rule_cnt < IPA_RULE_CNT_MAX)
 		tbl->rule_cnt++;
 	else {
@@ -1117,7 +1261,7 @@ static int __ipa_finish_rt_rule_add(struct ipa3_rt_entry *entry, u32 *rule_hdl,
 		entry->hdr->ref_cnt++;
 	else if (entry->proc_ctx)
 		entry->proc_ctx->ref_cnt++;
-	id = ipa3_id_alloc(entry);
+	id = ipa3_id_alloc_ip(entry, ipa3_id_ip(tbl->id));
 	if (id < 0) {
 		IPAERR_RL("failed to add to tree\n");
 		WARN_ON_RATELIMIT_IPA(1);
@@ -1152,6 +1296,9 @@ static int __ipa_add_rt_rule(enum ipa_ip_type ip, const char *name,
 	struct ipa3_hdr_entry *hdr = NULL;
 	struct ipa3_hdr_proc_ctx_entry *proc_ctx = NULL;
 
+	lockdep_assert_held(&ipa3_ctx->rt_tbl_lock[ip]);
+
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	if (__ipa_rt_validate_hndls(rule, &hdr, &proc_ctx))
 		goto error;
 
@@ -1186,9 +1333,11 @@ static int __ipa_add_rt_rule(enum ipa_ip_type ip, const char *name,
 	if (__ipa_finish_rt_rule_add(entry, rule_hdl, tbl))
 		goto error;
 
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return 0;
 
 error:
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	return -EPERM;
 }
 
@@ -1203,16 +1352,20 @@ static int __ipa_add_rt_rule_after(struct ipa3_rt_tbl *tbl,
 	if (!*add_after_entry)
 		goto error;
 
+	lockdep_assert_held(&ipa3_ctx->rt_tbl_lock[ipa3_id_ip(tbl->id)]);
+
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	if (__ipa_rt_validate_hndls(rule, &hdr, &proc_ctx))
-		goto error;
+		goto unlock;
 
 	if (__ipa_create_rt_entry(&entry, rule, tbl, hdr, proc_ctx, 0, true))
-		goto error;
+		goto unlock;
 
 	list_add(&entry->link, &((*add_after_entry)->link));
 
 	if (__ipa_finish_rt_rule_add(entry, rule_hdl, tbl))
-		goto error;
+		goto unlock;
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 
 	/*
 	 * prepare for next insertion
@@ -1221,6 +1374,8 @@ static int __ipa_add_rt_rule_after(struct ipa3_rt_tbl *tbl,
 
 	return 0;
 
+unlock:
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 error:
 	*add_after_entry = NULL;
 	return -EPERM;
@@ -1340,7 +1495,7 @@ int ipa3_add_rt_rule_usr(struct ipa_ioc_add_rt_rule *rules, bool user_only)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[rules->ip]);
 	for (i = 0; i < rules->num_rules; i++) {
 		rules->rt_tbl_name[IPA_RESOURCE_NAME_MAX-1] = '\0';
 		/* if hashing not supported, all tables are non-hash tables*/
@@ -1369,7 +1524,7 @@ int ipa3_add_rt_rule_usr(struct ipa_ioc_add_rt_rule *rules, bool user_only)
 
 	ret = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[rules->ip]);
 	return ret;
 }
 
@@ -1395,7 +1550,7 @@ int ipa3_add_rt_rule_usr_v2(struct ipa_ioc_add_rt_rule_v2 *rules,
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[rules->ip]);
 	for (i = 0; i < rules->num_rules; i++) {
 		rules->rt_tbl_name[IPA_RESOURCE_NAME_MAX-1] = '\0';
 		/* if hashing not supported, all tables are non-hash tables*/
@@ -1428,7 +1583,7 @@ int ipa3_add_rt_rule_usr_v2(struct ipa_ioc_add_rt_rule_v2 *rules,
 
 	ret = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[rules->ip]);
 	return ret;
 }
 
@@ -1453,7 +1608,7 @@ int ipa3_add_rt_rule_ext(struct ipa_ioc_add_rt_rule_ext *rules)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[rules->ip]);
 	for (i = 0; i < rules->num_rules; i++) {
 		/* if hashing not supported, all tables are non-hash tables*/
 		if (ipa3_ctx->ipa_fltrt_not_hashable)
@@ -1481,7 +1636,7 @@ int ipa3_add_rt_rule_ext(struct ipa_ioc_add_rt_rule_ext *rules)
 
 	ret = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[rules->ip]);
 	return ret;
 }
 
@@ -1506,7 +1661,7 @@ int ipa3_add_rt_rule_ext_v2(struct ipa_ioc_add_rt_rule_ext_v2 *rules,
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[rules->ip]);
 	for (i = 0; i < rules->num_rules; i++) {
 		/* if hashing not supported, all tables are non-hash tables*/
 		if (ipa3_ctx->ipa_fltrt_not_hashable)
@@ -1538,7 +1693,7 @@ int ipa3_add_rt_rule_ext_v2(struct ipa_ioc_add_rt_rule_ext_v2 *rules,
 
 	ret = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[rules->ip]);
 	return ret;
 }
 
@@ -1564,7 +1719,7 @@ int ipa3_add_rt_rule_after(struct ipa_ioc_add_rt_rule_after *rules)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[rules->ip]);
 	rules->rt_tbl_name[IPA_RESOURCE_NAME_MAX-1] = '\0';
 	tbl = __ipa3_find_rt_tbl(rules->ip, rules->rt_tbl_name);
 	if (tbl == NULL || (tbl->cookie != IPA_RT_TBL_COOKIE)) {
@@ -1580,6 +1735,13 @@ int ipa3_add_rt_rule_after(struct ipa_ioc_add_rt_rule_after *rules)
 		goto bail;
 	}
 
+	if (ipa3_id_ip(rules->add_after_hdl) != rules->ip) {
+		IPAERR_RL("rule %d is not of ip family %d\n",
+			rules->add_after_hdl, rules->ip);
+		ret = -EINVAL;
+		goto bail;
+	}
+
 	entry = ipa3_id_find(rules->add_after_hdl);
 	if (!entry) {
 		IPAERR_RL("failed finding rule %d in rt tbls\n",
@@ -1647,7 +1809,7 @@ int ipa3_add_rt_rule_after(struct ipa_ioc_add_rt_rule_after *rules)
 	goto bail;
 
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[rules->ip]);
 	return ret;
 }
 
@@ -1674,7 +1836,7 @@ int ipa3_add_rt_rule_after_v2(struct ipa_ioc_add_rt_rule_after_v2
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[rules->ip]);
 	rules->rt_tbl_name[IPA_RESOURCE_NAME_MAX-1] = '\0';
 	tbl = __ipa3_find_rt_tbl(rules->ip, rules->rt_tbl_name);
 	if (tbl == NULL || (tbl->cookie != IPA_RT_TBL_COOKIE)) {
@@ -1690,6 +1852,13 @@ int ipa3_add_rt_rule_after_v2(struct ipa_ioc_add_rt_rule_after_v2
 		goto bail;
 	}
 
+	if (ipa3_id_ip(rules->add_after_hdl) != rules->ip) {
+		IPAERR_RL("rule %d is not of ip family %d\n",
+			rules->add_after_hdl, rules->ip);
+		ret = -EINVAL;
+		goto bail;
+	}
+
 	entry = ipa3_id_find(rules->add_after_hdl);
 	if (!entry) {
 		IPAERR_RL("failed finding rule %d in rt tbls\n",
@@ -1759,7 +1928,7 @@ int ipa3_add_rt_rule_after_v2(struct ipa_ioc_add_rt_rule_after_v2
 	goto bail;
 
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[rules->ip]);
 	return ret;
 }
 
@@ -1770,6 +1939,8 @@ int __ipa3_del_rt_rule(u32 rule_hdl)
 	struct ipa3_hdr_entry *hdr_entry;
 	struct ipa3_hdr_proc_ctx_entry *hdr_proc_entry;
 
+	lockdep_assert_held(&ipa3_ctx->rt_tbl_lock[ipa3_id_ip(rule_hdl)]);
+
 	entry = ipa3_id_find(rule_hdl);
 
 	if (entry == NULL) {
@@ -1796,6 +1967,7 @@ int __ipa3_del_rt_rule(u32 rule_hdl)
 	 * header entry present in header table or not
 	 */
 
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	if (entry->hdr) {
 		hdr_entry = ipa3_id_find(entry->rule.hdr_hdl);
 		if (!hdr_entry || hdr_entry->cookie != IPA_HDR_COOKIE) {
@@ -1817,7 +1989,9 @@ int __ipa3_del_rt_rule(u32 rule_hdl)
 	else if (entry->proc_ctx &&
 		(!ipa3_check_idr_if_freed(entry->proc_ctx)))
 		__ipa3_release_hdr_proc_ctx(entry->proc_ctx->id);
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
 	list_del(&entry->link);
+	entry->tbl->dirty = true;
 	entry->tbl->rule_cnt--;
 	IPADBG("del rt rule tbl_idx=%d rule_cnt=%d rule_id=%d\n ref_cnt=%u",
 		entry->tbl->idx, entry->tbl->rule_cnt,
@@ -1858,9 +2032,10 @@ int ipa3_del_rt_rule(struct ipa_ioc_del_rt_rule *hdls)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[hdls->ip]);
 	for (i = 0; i < hdls->num_hdls; i++) {
-		if (__ipa3_del_rt_rule(hdls->hdl[i].hdl)) {
+		if (ipa3_id_ip(hdls->hdl[i].hdl) != hdls->ip ||
+			__ipa3_del_rt_rule(hdls->hdl[i].hdl)) {
 			IPAERR_RL("failed to del rt rule %i\n", i);
 			hdls->hdl[i].status = IPA_RT_STATUS_OF_DEL_FAILED;
 		} else {
@@ -1876,7 +2051,7 @@ int ipa3_del_rt_rule(struct ipa_ioc_del_rt_rule *hdls)
 
 	ret = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[hdls->ip]);
 	return ret;
 }
 
@@ -1905,7 +2080,7 @@ int ipa3_commit_rt(enum ipa_ip_type ip)
 	if (ipa3_commit_flt(ip))
 		return -EPERM;
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
 	if (ipa3_ctx->ctrl->ipa3_commit_rt(ip)) {
 		ret = -EPERM;
 		goto bail;
@@ -1913,7 +2088,7 @@ int ipa3_commit_rt(enum ipa_ip_type ip)
 
 	ret = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 	return ret;
 }
 
@@ -1962,7 +2137,8 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 
 	set = &ipa3_ctx->rt_tbl_set[ip];
 	rset = &ipa3_ctx->reap_rt_tbl_set[ip];
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	IPADBG("reset rt ip=%d\n", ip);
 	list_for_each_entry_safe(tbl, tbl_next, &set->head_rt_tbl_list, link) {
 		tbl_user = false;
@@ -1970,7 +2146,8 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 					 &tbl->head_rt_rule_list, link) {
 			if (ipa3_id_find(rule->id) == NULL) {
 				WARN_ON_RATELIMIT_IPA(1);
-				mutex_unlock(&ipa3_ctx->lock);
+				mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
+				mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 				return -EFAULT;
 			}
 
@@ -2011,6 +2188,7 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 					}
 				}
 				tbl->rule_cnt--;
+				tbl->dirty = true;
 				list_del(&rule->link);
 				if (rule->hdr &&
 					(!ipa3_check_idr_if_freed(
@@ -2035,7 +2213,8 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 
 		if (ipa3_id_find(tbl->id) == NULL) {
 			WARN_ON_RATELIMIT_IPA(1);
-			mutex_unlock(&ipa3_ctx->lock);
+			mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
+			mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 			return -EFAULT;
 		}
 		id = tbl->id;
@@ -2044,6 +2223,7 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 		if (tbl->idx != apps_start_idx) {
 			if (!user_only || tbl_user) {
 				tbl->rule_ids = NULL;
+				hash_del(&tbl->name_node);
 				if (tbl->in_sys[IPA_RULE_HASHABLE] ||
 					tbl->in_sys[IPA_RULE_NON_HASHABLE]) {
 					list_move(&tbl->link,
@@ -2069,15 +2249,16 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 		}
 	}
 
-	/* commit the change to IPA-HW */
-	if (ipa3_ctx->ctrl->ipa3_commit_rt(IPA_IP_v4) ||
-		ipa3_ctx->ctrl->ipa3_commit_rt(IPA_IP_v6)) {
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
+
+	/* commit the change to IPA-HW, only this family was reset */
+	if (ipa3_ctx->ctrl->ipa3_commit_rt(ip)) {
 		IPAERR("fail to commit rt-rule\n");
 		WARN_ON_RATELIMIT_IPA(1);
-		mutex_unlock(&ipa3_ctx->lock);
+		mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 		return -EPERM;
 	}
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 
 	return 0;
 }
@@ -2101,7 +2282,7 @@ int ipa3_get_rt_tbl(struct ipa_ioc_get_rt_tbl *lookup)
 		IPAERR_RL("bad param\n");
 		return -EINVAL;
 	}
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[lookup->ip]);
 	lookup->name[IPA_RESOURCE_NAME_MAX-1] = '\0';
 	entry = __ipa3_find_rt_tbl(lookup->ip, lookup->name);
 	if (entry && entry->cookie == IPA_RT_TBL_COOKIE) {
@@ -2120,7 +2301,7 @@ int ipa3_get_rt_tbl(struct ipa_ioc_get_rt_tbl *lookup)
 	}
 
 ret:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[lookup->ip]);
 
 	return result;
 }
@@ -2137,10 +2318,10 @@ EXPORT_SYMBOL(ipa3_get_rt_tbl);
 int ipa3_put_rt_tbl(u32 rt_tbl_hdl)
 {
 	struct ipa3_rt_tbl *entry;
-	enum ipa_ip_type ip = IPA_IP_MAX;
+	enum ipa_ip_type ip = ipa3_id_ip(rt_tbl_hdl);
 	int result = 0;
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
 	entry = ipa3_id_find(rt_tbl_hdl);
 	if (entry == NULL) {
 		IPAERR_RL("lookup failed\n");
@@ -2154,11 +2335,7 @@ int ipa3_put_rt_tbl(u32 rt_tbl_hdl)
 		goto ret;
 	}
 
-	if (entry->set == &ipa3_ctx->rt_tbl_set[IPA_IP_v4])
-		ip = IPA_IP_v4;
-	else if (entry->set == &ipa3_ctx->rt_tbl_set[IPA_IP_v6])
-		ip = IPA_IP_v6;
-	else {
+	if (entry->set != &ipa3_ctx->rt_tbl_set[ip]) {
 		WARN_ON_RATELIMIT_IPA(1);
 		result = -EINVAL;
 		goto ret;
@@ -2178,20 +2355,31 @@ int ipa3_put_rt_tbl(u32 rt_tbl_hdl)
 	result = 0;
 
 ret:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 
 	return result;
 }
 
 
-static int __ipa_mdfy_rt_rule(struct ipa_rt_rule_mdfy_i *rtrule)
+static int __ipa_mdfy_rt_rule(enum ipa_ip_type ip,
+	struct ipa_rt_rule_mdfy_i *rtrule)
 {
 	struct ipa3_rt_entry *entry;
 	struct ipa3_hdr_entry *hdr = NULL;
 	struct ipa3_hdr_proc_ctx_entry *proc_ctx = NULL;
 	struct ipa3_hdr_entry *hdr_entry;
 	struct ipa3_hdr_proc_ctx_entry *hdr_proc_entry;
+	int res = -EPERM;
+
+	lockdep_assert_held(&ipa3_ctx->rt_tbl_lock[ip]);
+
+	if (ipa3_id_ip(rtrule->rt_rule_hdl) != ip) {
+		IPAERR_RL("rule %d is not of ip family %d\n",
+			rtrule->rt_rule_hdl, ip);
+		return -EPERM;
+	}
 
+	mutex_lock(&ipa3_ctx->hdr_tbl_lock);
 	if (__ipa_rt_validate_hndls(&rtrule->rule, &hdr, &proc_ctx))
 		goto error;
 
@@ -2209,7 +2397,8 @@ static int __ipa_mdfy_rt_rule(struct ipa_rt_rule_mdfy_i *rtrule)
 	if (!ipa3_check_idr_if_freed(entry) &&
 		!strcmp(entry->tbl->name, IPA_DFLT_RT_TBL_NAME)) {
 		IPAERR_RL("Default tbl rule cannot be modified\n");
-		return -EINVAL;
+		res = -EINVAL;
+		goto error;
 	}
 	/* Adding check to confirm still
 	 * header entry present in header table or not
@@ -2220,7 +2409,7 @@ static int __ipa_mdfy_rt_rule(struct ipa_rt_rule_mdfy_i *rtrule)
 		if (!hdr_entry || (hdr_entry->cookie != IPA_HDR_COOKIE) ||
 			ipa3_check_idr_if_freed(entry->hdr)) {
 			IPAERR_RL("Header entry already deleted\n");
-			return -EPERM;
+			goto error;
 		}
 	} else if (entry->proc_ctx) {
 		hdr_proc_entry = ipa3_id_find(entry->rule.hdr_proc_ctx_hdl);
@@ -2228,7 +2417,7 @@ static int __ipa_mdfy_rt_rule(struct ipa_rt_rule_mdfy_i *rtrule)
 			(hdr_proc_entry->cookie != IPA_PROC_HDR_COOKIE) ||
 			ipa3_check_idr_if_freed(entry->proc_ctx)) {
 			IPAERR_RL("Proc header entry already deleted\n");
-			return -EPERM;
+			goto error;
 		}
 	}
 
@@ -2248,14 +2437,16 @@ static int __ipa_mdfy_rt_rule(struct ipa_rt_rule_mdfy_i *rtrule)
 
 	entry->hw_len = 0;
 	entry->prio = 0;
+	entry->tbl->dirty = true;
 	if (rtrule->rule.enable_stats)
 		entry->cnt_idx = rtrule->rule.cnt_idx;
 	else
 		entry->cnt_idx = 0;
-	return 0;
+	res = 0;
 
 error:
-	return -EPERM;
+	mutex_unlock(&ipa3_ctx->hdr_tbl_lock);
+	return res;
 }
 
 /**
@@ -2277,13 +2468,13 @@ int ipa3_mdfy_rt_rule(struct ipa_ioc_mdfy_rt_rule *hdls)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[hdls->ip]);
 	for (i = 0; i < hdls->num_rules; i++) {
 		/* if hashing not supported, all tables are non-hash tables*/
 		if (ipa3_ctx->ipa_fltrt_not_hashable)
 			hdls->rules[i].rule.hashable = false;
 		__ipa_convert_rt_mdfy_in(hdls->rules[i], &rule);
-		if (__ipa_mdfy_rt_rule(&rule)) {
+		if (__ipa_mdfy_rt_rule(hdls->ip, &rule)) {
 			IPAERR_RL("failed to mdfy rt rule %i\n", i);
 			hdls->rules[i].status = IPA_RT_STATUS_OF_MDFY_FAILED;
 		} else {
@@ -2299,7 +2490,7 @@ int ipa3_mdfy_rt_rule(struct ipa_ioc_mdfy_rt_rule *hdls)
 		}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[hdls->ip]);
 
 	return result;
 }
@@ -2322,13 +2513,13 @@ int ipa3_mdfy_rt_rule_v2(struct ipa_ioc_mdfy_rt_rule_v2 *hdls)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[hdls->ip]);
 	for (i = 0; i < hdls->num_rules; i++) {
 		/* if hashing not supported, all tables are non-hash tables*/
 		if (ipa3_ctx->ipa_fltrt_not_hashable)
 			((struct ipa_rt_rule_mdfy_i *)
 			hdls->rules)[i].rule.hashable = false;
-		if (__ipa_mdfy_rt_rule(&(((struct ipa_rt_rule_mdfy_i *)
+		if (__ipa_mdfy_rt_rule(hdls->ip, &(((struct ipa_rt_rule_mdfy_i *)
 			hdls->rules)[i]))) {
 			IPAERR_RL("failed to mdfy rt rule %i\n", i);
 			((struct ipa_rt_rule_mdfy_i *)
@@ -2346,7 +2537,7 @@ int ipa3_mdfy_rt_rule_v2(struct ipa_ioc_mdfy_rt_rule_v2 *hdls)
 		}
 	result = 0;
 bail:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[hdls->ip]);
 
 	return result;
 }
@@ -2581,7 +2772,12 @@ int ipa3_set_nat_conn_track_exc_rt_tbl(u32 rt_tbl_hdl, enum ipa_ip_type ip)
 		return -EINVAL;
 	}
 
-	mutex_lock(&ipa3_ctx->lock);
+	if (ipa3_id_ip(rt_tbl_hdl) != ip) {
+		IPAERR_RL("rt tbl %d is not of ip family %d\n", rt_tbl_hdl, ip);
+		return -EINVAL;
+	}
+
+	mutex_lock(&ipa3_ctx->rt_tbl_lock[ip]);
 	entry = ipa3_id_find(rt_tbl_hdl);
 	if (entry == NULL) {
 		IPAERR_RL("lookup failed\n");
@@ -2607,7 +2803,7 @@ int ipa3_set_nat_conn_track_exc_rt_tbl(u32 rt_tbl_hdl, enum ipa_ip_type ip)
 	result = 0;
 
 ret:
-	mutex_unlock(&ipa3_ctx->lock);
+	mutex_unlock(&ipa3_ctx->rt_tbl_lock[ip]);
 
 	return result;
 }
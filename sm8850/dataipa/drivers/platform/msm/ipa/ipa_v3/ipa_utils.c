@@ -10473,6 +10473,35 @@ int ipa3_id_alloc(void *ptr)
 	return id;
 }
 
+/*
+ * flt and rt handles carry their IP family in the handle range, so a handle
+ * only API can take the right family lock before looking the handle up.
+ */
+#define IPA_ID_V6_BASE (1 << 30)
+
+int ipa3_id_alloc_ip(void *ptr, enum ipa_ip_type ip)
+{
+	int id;
+
+	idr_preload(GFP_KERNEL);
+	spin_lock(&ipa3_ctx->idr_lock);
+	if (ip == IPA_IP_v6)
+		id = idr_alloc(&ipa3_ctx->ipa_idr, ptr, IPA_ID_V6_BASE,
+			INT_MAX, GFP_NOWAIT);
+	else
+		id = idr_alloc(&ipa3_ctx->ipa_idr, ptr, 1, IPA_ID_V6_BASE,
+			GFP_NOWAIT);
+	spin_unlock(&ipa3_ctx->idr_lock);
+	idr_preload_end();
+
+	return id;
+}
+
+enum ipa_ip_type ipa3_id_ip(u32 id)
+{
+	return id >= IPA_ID_V6_BASE ? IPA_IP_v6 : IPA_IP_v4;
+}
+
 void *ipa3_id_find(u32 id)
 {
 	void *ptr;
@@ -1903,7 +1903,6 @@ static int ipa_fltrt_generate_hw_rule_bdy_ip6(u16 *en_rule,
 		extra = ipa_write_8(134, extra);
 		rest = ipa_write_32(0xFF000000, rest);
 		rest = ipa_write_32(attrib->u.v6.next_hdr << 24, rest);
-		extra = ipa_write_8(attrib->u.v6.next_hdr, extra);
 		ihl_ofst_meq32++;
 	}
 
@@ -4001,19 +4000,28 @@ static int ipa_fltrt_parse_hw_rule_eq(u8 *addr, u32 hdr_sz,
 	if (extra_bytes > 13) {
 		IPAHAL_ERR("too much extra bytes\n");
 		return -EPERM;
-	} else if (extra_bytes > IPA3_0_HW_TBL_HDR_WIDTH) {
-		/* two extra words */
-		extra = addr + hdr_sz;
-		rest = extra + IPA3_0_HW_TBL_HDR_WIDTH * 2;
 	} else if (extra_bytes > 0) {
-		/* single extra word */
+		/*
+		 * one or two extra words. On IPAv5.5 the extension header
+		 * takes the first two bytes of the first one, so the rest
+		 * starts at the next 64 bit boundary after the extra bytes.
+		 */
 		extra = addr + hdr_sz;
-		rest = extra + IPA3_0_HW_TBL_HDR_WIDTH;
+		rest = (u8 *)(((unsigned long)extra + extra_bytes +
+			IPA3_0_HW_RULE_START_ALIGNMENT) &
+			~IPA3_0_HW_RULE_START_ALIGNMENT);
 	} else {
-		/* no extra words */
+		/*
+		 * no extra words. The IPAv5.5 extension header still ends
+		 * the header part off a 64 bit boundary and the generator
+		 * pads after it, so the rest starts at the next boundary
+		 * after hdr_sz. Without it hdr_sz is already aligned.
+		 */
 		dummy_extra_wrd = 0;
 		extra = &dummy_extra_wrd;
-		rest = addr + hdr_sz;
+		rest = (u8 *)(((unsigned long)addr + hdr_sz +
+			IPA3_0_HW_RULE_START_ALIGNMENT) &
+			~IPA3_0_HW_RULE_START_ALIGNMENT);
 	}
 	IPAHAL_DBG_LOW("addr=0x%pK extra=0x%pK rest=0x%pK\n",
 		addr, extra, rest);
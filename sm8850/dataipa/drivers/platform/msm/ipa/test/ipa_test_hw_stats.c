@@ -941,6 +941,115 @@ static int ipa_test_hw_stats_reset_all_quota_stats(void *priv)
        return ret;
 }
 
+/*
+ * Write a SW counter while the harvester runs, a query not resetting it
+ * has to see the new value rather than the harvested one.
+ */
+static int ipa_test_hw_stats_harvest_fnr(void)
+{
+	struct ipa_ioc_flt_rt_query query = { 0 };
+	struct ipa_flt_rt_stats set, got = { 0 };
+	int ret;
+
+	set.num_bytes = 0x1234567;
+	set.num_pkts_hash = 0x123;
+	set.num_pkts = 0x4567;
+	ret = ipa_set_flt_rt_stats(IPA_MAX_FLT_RT_CNT_INDEX, set);
+	if (ret) {
+		IPA_UT_ERR("ipa_set_flt_rt_stats failed %d\n", ret);
+		return ret;
+	}
+
+	query.start_id = IPA_MAX_FLT_RT_CNT_INDEX;
+	query.end_id = IPA_MAX_FLT_RT_CNT_INDEX;
+	query.stats_size = sizeof(got);
+	query.stats = (uint64_t)&got;
+	ret = ipa_get_flt_rt_stats(&query);
+	if (ret) {
+		IPA_UT_ERR("ipa_get_flt_rt_stats failed %d\n", ret);
+		return ret;
+	}
+
+	if (got.num_bytes != set.num_bytes || got.num_pkts != set.num_pkts) {
+		IPA_UT_ERR("stale counter pkt_cnt %u bytes cnt %llu\n",
+			got.num_pkts, got.num_bytes);
+		return -EFAULT;
+	}
+
+	return 0;
+}
+
+static int ipa_test_hw_stats_harvest(void *priv)
+{
+	struct ipa_hw_stats_harvest *harvest = &ipa3_ctx->hw_stats->harvest;
+	struct ipa_hw_stats_harvest_stats before, after;
+	struct ipa_quota_stats_all *out;
+	int ret;
+
+	out = kzalloc(sizeof(*out), GFP_KERNEL);
+	if (!out)
+		return -ENOMEM;
+
+	IPA_UT_INFO("========harvest stats in the background========\n");
+
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
+	before = harvest->stats;
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
+
+	ret = ipa_hw_stats_set_harvest_period(20);
+	if (ret) {
+		IPA_UT_ERR("ipa_hw_stats_set_harvest_period failed %d\n", ret);
+		goto free_out;
+	}
+	msleep(100);
+
+	ret = ipa_get_quota_stats(out);
+	if (ret) {
+		IPA_UT_ERR("ipa_get_quota_stats failed %d\n", ret);
+		goto stop;
+	}
+	ret = ipa_get_teth_stats();
+	if (ret) {
+		IPA_UT_ERR("ipa_get_teth_stats failed %d\n", ret);
+		goto stop;
+	}
+	ret = ipa_test_hw_stats_harvest_fnr();
+	if (ret)
+		goto stop;
+
+	mutex_lock(&ipa3_ctx->hw_stats->lock);
+	after = harvest->stats;
+	mutex_unlock(&ipa3_ctx->hw_stats->lock);
+
+	IPA_UT_INFO("harvests=%llu skipped=%llu fails=%llu served=%llu\n",
+		after.harvests - before.harvests,
+		after.skipped - before.skipped,
+		after.fails - before.fails,
+		after.served - before.served);
+	IPA_UT_INFO("last_us=%u max_us=%u\n", after.last_us, after.max_us);
+
+	if (after.fails != before.fails) {
+		IPA_UT_ERR("harvest failed\n");
+		ret = -EFAULT;
+	} else if (after.harvests != before.harvests &&
+		after.served == before.served) {
+		IPA_UT_ERR("queries were not served from the snapshot\n");
+		ret = -EFAULT;
+	}
+
+stop:
+	if (ipa_hw_stats_set_harvest_period(0)) {
+		IPA_UT_ERR("failed to stop the harvester\n");
+		ret = -EFAULT;
+	}
+
+	IPA_UT_INFO("================ done ============\n");
+
+free_out:
+	kfree(out);
+	return ret;
+}
+
 static int ipa_test_hw_stats_set_uc_event_ring(void *priv)
 {
 	struct ipa_ioc_flt_rt_counter_alloc *counter = NULL;
@@ -1181,6 +1290,10 @@ IPA_UT_DEFINE_SUITE_START(hw_stats, "HW stats test",
 		ipa_test_hw_stats_reset_all_quota_stats, false,
 		IPA_HW_v4_5, IPA_HW_MAX),
 
+	IPA_UT_ADD_TEST(harvest_stats, "Harvest stats in the background",
+		ipa_test_hw_stats_harvest, false,
+		IPA_HW_v4_5, IPA_HW_MAX),
+
 	IPA_UT_ADD_TEST(set_uc_evtring, "Set uc event ring",
 		ipa_test_hw_stats_set_uc_event_ring, false,
 		IPA_HW_v4_5, IPA_HW_MAX),
@@ -392,4 +392,10 @@ enum ipv6_ext_hdr_type {
  */
 #define XUNIT_REPORT_PATH_AND_NAME	"junit_result.xml"
 
+/*---------------------------------------------------------------------
+ *Performance tests results file name, one JSON object per line
+ *----------------------------------------------------------------------
+ */
+#define PERF_REPORT_PATH_AND_NAME	"perf_result.json"
+
 #endif /* CONSTANTS_H_ */
@@ -69,6 +69,7 @@
 #include <fcntl.h>
 
 #include "Feature.h"
+#include "IPAModel.h"
 
 /*
  * All interaction through the driver are
@@ -95,5 +96,9 @@ Feature::~Feature()
 
 bool Feature::DeviceNodeIsOpened()
 {
+	/* the model takes the requests, /dev/ipa is not needed */
+	if (IPAModel::IsEnabled())
+		return true;
+
 	return (m_fd > 0 && fcntl(m_fd, F_GETFL) >= 0);
 }
@@ -68,11 +68,15 @@
 #include <stdio.h>
 
 #include "Filtering.h"
+#include "IPAModel.h"
 
 bool Filtering::AddFilteringRule(struct ipa_ioc_add_flt_rule const * ruleTable)
 {
 	int retval = 0;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().AddFilteringRule(ruleTable);
+
 	retval = ioctl(m_fd, IPA_IOC_ADD_FLT_RULE, ruleTable);
 	if (retval) {
 		printf("%s(), failed adding Filtering rule table %p\n", __FUNCTION__, ruleTable);
@@ -87,6 +91,9 @@ bool Filtering::AddFilteringRule(struct ipa_ioc_add_flt_rule_v2 const * ruleTabl
 {
 	int retval = 0;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().AddFilteringRule(ruleTable);
+
 	retval = ioctl(m_fd, IPA_IOC_ADD_FLT_RULE_V2, ruleTable);
 	if (retval) {
 		printf("%s(), failed adding Filtering rule table %p\n", __FUNCTION__, ruleTable);
@@ -101,6 +108,9 @@ bool Filtering::DeleteFilteringRule(struct ipa_ioc_del_flt_rule *ruleTable)
 {
 	int retval = 0;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().DeleteFilteringRule(ruleTable);
+
 	retval = ioctl(m_fd, IPA_IOC_DEL_FLT_RULE, ruleTable);
 	if (retval) {
 		printf("%s(), failed deleting Filtering rule in table %p\n", __FUNCTION__, ruleTable);
@@ -115,6 +125,9 @@ bool Filtering::Commit(enum ipa_ip_type ip)
 {
 	int retval = 0;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().CommitFiltering(ip);
+
 	retval = ioctl(m_fd, IPA_IOC_COMMIT_FLT, ip);
 	if (retval) {
 		printf("%s(), failed committing Filtering rules.\n", __FUNCTION__);
@@ -129,6 +142,9 @@ bool Filtering::Reset(enum ipa_ip_type ip)
 {
 	int retval = 0;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().ResetFiltering(ip);
+
 	retval = ioctl(m_fd, IPA_IOC_RESET_FLT, ip);
 	retval |= ioctl(m_fd, IPA_IOC_COMMIT_FLT, ip);
 	if (retval) {
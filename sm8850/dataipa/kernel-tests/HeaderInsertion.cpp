@@ -70,6 +70,7 @@
 
 #include "HeaderInsertion.h"
 #include "TestsUtils.h"
+#include "IPAModel.h"
 
 #define LOG_IOCTL_RETURN_VALUE(nRetVal) \
 		printf("%s()- %s\n", __func__, \
@@ -78,6 +79,10 @@
 bool HeaderInsertion::AddHeader(struct ipa_ioc_add_hdr *pHeaderTableToAdd)
 {
 	int nRetVal = 0;
+
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().AddHeader(pHeaderTableToAdd);
+
 	/*call the Driver ioctl in order to add header*/
 	nRetVal = ioctl(m_fd, IPA_IOC_ADD_HDR, pHeaderTableToAdd);
 	LOG_IOCTL_RETURN_VALUE(nRetVal);
@@ -88,6 +93,11 @@ bool HeaderInsertion::addHeaderHpc(const string& name, uint8_t* header, const si
 	if(name.empty() || name.size() >= IPA_RESOURCE_NAME_MAX){
 		return false;
 	}
+	if (IPAModel::IsEnabled()) {
+		/* the per pipe header of the pkt_init_ex command is not modelled */
+		LOG_MSG_ERROR("IPA model does not support HPC headers\n");
+		return false;
+	}
 	int fd = open(CONFIGURATION_NODE_PATH, O_RDONLY);
 	if (fd < 0) {
 		cout << "failed to open " << CONFIGURATION_NODE_PATH << endl;
@@ -131,6 +141,10 @@ bool HeaderInsertion::addHeaderHpc(const string& name, uint8_t* header, const si
 bool HeaderInsertion::DeleteHeader(struct ipa_ioc_del_hdr *pHeaderTableToDelete)
 {
 	int nRetVal = 0;
+
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().DeleteHeader(pHeaderTableToDelete);
+
 	/*call the Driver ioctl in order to remove header*/
 	nRetVal = ioctl(m_fd, IPA_IOC_DEL_HDR , pHeaderTableToDelete);
 	LOG_IOCTL_RETURN_VALUE(nRetVal);
@@ -167,6 +181,9 @@ bool HeaderInsertion::AddProcCtx(struct ipa_ioc_add_hdr_proc_ctx *procCtxTable)
 {
 	int retval = 0;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().AddProcCtx(procCtxTable);
+
 	retval = ioctl(m_fd, IPA_IOC_ADD_HDR_PROC_CTX, procCtxTable);
 	if (retval) {
 		printf("%s(), failed adding ProcCtx rule table %p\n", __FUNCTION__, procCtxTable);
@@ -181,6 +198,9 @@ bool HeaderInsertion::DeleteProcCtx(struct ipa_ioc_del_hdr_proc_ctx *procCtxTabl
 {
 	int retval = 0;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().DeleteProcCtx(procCtxTable);
+
 	retval = ioctl(m_fd, IPA_IOC_DEL_HDR_PROC_CTX, procCtxTable);
 	if (retval) {
 		printf("%s(), failed deleting ProcCtx rule in table %p\n", __FUNCTION__, procCtxTable);
@@ -194,6 +214,10 @@ bool HeaderInsertion::DeleteProcCtx(struct ipa_ioc_del_hdr_proc_ctx *procCtxTabl
 bool HeaderInsertion::Commit()
 {
 	int nRetVal = 0;
+
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().CommitHeaders();
+
 	nRetVal = ioctl(m_fd, IPA_IOC_COMMIT_HDR);
 	LOG_IOCTL_RETURN_VALUE(nRetVal);
 	return true;
@@ -203,6 +227,9 @@ bool HeaderInsertion::Reset()
 {
 	int nRetVal = 0;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().ResetHeaders();
+
 	nRetVal = ioctl(m_fd, IPA_IOC_RESET_HDR);
 	nRetVal |= ioctl(m_fd, IPA_IOC_COMMIT_HDR);
 	LOG_IOCTL_RETURN_VALUE(nRetVal);
@@ -216,6 +243,9 @@ bool HeaderInsertion::GetHeaderHandle(struct ipa_ioc_get_hdr *pHeaderStruct)
 	if (!DeviceNodeIsOpened())
 		return false;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().GetHeaderHandle(pHeaderStruct);
+
 	retval = ioctl(m_fd, IPA_IOC_GET_HDR, pHeaderStruct);
 	if (retval) {
 		printf(
@@ -256,6 +286,9 @@ bool HeaderInsertion::CopyHeader(struct ipa_ioc_copy_hdr *pCopyHeaderStruct)
 	if (!DeviceNodeIsOpened())
 		return false;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().CopyHeader(pCopyHeaderStruct);
+
 	retval = ioctl(m_fd, IPA_IOC_COPY_HDR, pCopyHeaderStruct);
 	if (retval) {
 		printf(
@@ -0,0 +1,1384 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the
+ * disclaimer below) provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *     * Neither the name of Qualcomm Innovation Center, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+ * GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <netinet/in.h>
+#include <algorithm>
+
+#include "IPAModel.h"
+#include "TestsUtils.h"
+
+#define IPA_MODEL_STATUS_OPCODE_PACKET 0x01
+#define IPA_MODEL_TO_IPA_PREFIX "/dev/to_ipa_"
+#define IPA_MODEL_FROM_IPA_PREFIX "/dev/from_ipa_"
+
+bool IPAModel::m_enabled = false;
+enum ipa_hw_type IPAModel::m_hwType = IPA_HW_None;
+
+static uint16_t GetBe16(const uint8_t *p)
+{
+	return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t GetBe32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+		((uint32_t)p[2] << 8) | p[3];
+}
+
+static void PutBe16(uint8_t *p, uint16_t val)
+{
+	p[0] = val >> 8;
+	p[1] = val & 0xFF;
+}
+
+static void PutBe32(uint8_t *p, uint32_t val)
+{
+	PutBe16(p, val >> 16);
+	PutBe16(p + 2, val & 0xFFFF);
+}
+
+/*RFC 1624 incremental update of the checksum at csum*/
+static void UpdateChecksum16(uint8_t *csum, uint16_t oldVal, uint16_t newVal)
+{
+	uint32_t sum = (uint16_t)~GetBe16(csum);
+
+	sum += (uint16_t)~oldVal;
+	sum += newVal;
+	sum = (sum & 0xFFFF) + (sum >> 16);
+	sum = (sum & 0xFFFF) + (sum >> 16);
+	PutBe16(csum, (uint16_t)~sum);
+}
+
+/*The rules carry ttl_update from the v2 layout on*/
+static bool RuleTtlUpdate(const struct ipa_rt_rule &)
+{
+	return false;
+}
+
+static bool RuleTtlUpdate(const struct ipa_rt_rule_v2 &rule)
+{
+	return rule.ttl_update;
+}
+
+static bool RuleTtlUpdate(const struct ipa_flt_rule &)
+{
+	return false;
+}
+
+static bool RuleTtlUpdate(const struct ipa_flt_rule_v2 &rule)
+{
+	return rule.ttl_update;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+IPAModel::IPAModel()
+: m_nextHdl(1),
+  m_nextHandle(0),
+  m_natExcRtTblHdl(0),
+  m_rxPackets(0),
+  m_txPackets(0),
+  m_exceptions(0),
+  m_drops(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+IPAModel &IPAModel::GetInstance()
+{
+	static IPAModel model;
+
+	return model;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::IsEnabled()
+{
+	static bool envChecked = false;
+	const char *env;
+
+	if (!envChecked) {
+		envChecked = true;
+		env = getenv(IPA_MODEL_ENV);
+		if (env && !m_enabled)
+			Enable((enum ipa_hw_type)atoi(env));
+	}
+
+	return m_enabled;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+void IPAModel::Enable(enum ipa_hw_type hwType)
+{
+	if (hwType <= IPA_HW_None || hwType >= IPA_HW_MAX)
+		hwType = IPA_MODEL_HW_TYPE;
+
+	m_hwType = hwType;
+	m_enabled = true;
+	printf("IPA model enabled, reporting IPA HW type %d\n", m_hwType);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+enum ipa_hw_type IPAModel::GetHwType()
+{
+	return m_hwType;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+void IPAModel::AddChannel(const string &path, enum ipa_client_type client,
+		bool toIpa, int index)
+{
+	Channel &ch = m_channels[path];
+
+	ch.path = path;
+	ch.client = client;
+	ch.toIpa = toIpa;
+	ch.hdrLen = 0;
+	ch.dma = false;
+	ch.dmaDst = IPA_CLIENT_MAX;
+	ch.metadataInHdr = false;
+	ch.metadataOfst = 0;
+	ch.metadata = 0;
+	ch.status = false;
+	ch.index = index;
+	ch.rxQueue.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::Configure(const struct ipa_test_config_header *header)
+{
+	const struct ipa_channel_config *config;
+	const struct test_ipa_ep_cfg *cfg;
+	char path[32];
+	Channel *ch;
+	int i;
+
+	Clean();
+
+	for (i = 0; i < header->to_ipa_channels_num; i++) {
+		config = header->to_ipa_channel_config[i];
+		snprintf(path, sizeof(path), IPA_MODEL_TO_IPA_PREFIX "%d",
+			config->index);
+		AddChannel(path, config->client, true, config->index);
+		ch = &m_channels[path];
+		cfg = (const struct test_ipa_ep_cfg *)config->cfg;
+		if (!cfg || config->config_size < sizeof(*cfg))
+			continue;
+		ch->hdrLen = cfg->hdr.hdr_len;
+		ch->dma = (cfg->mode.mode == IPA_DMA);
+		ch->dmaDst = cfg->mode.dst;
+		ch->metadataInHdr = cfg->hdr.hdr_ofst_metadata_valid;
+		ch->metadataOfst = cfg->hdr.hdr_ofst_metadata;
+		ch->metadata = cfg->meta.qmap_id;
+	}
+
+	for (i = 0; i < header->from_ipa_channels_num; i++) {
+		config = header->from_ipa_channel_config[i];
+		snprintf(path, sizeof(path), IPA_MODEL_FROM_IPA_PREFIX "%d",
+			config->index);
+		AddChannel(path, config->client, false, config->index);
+		m_channels[path].status = config->en_status;
+	}
+
+	LOG_MSG_DEBUG("IPA model configured, %d producers, %d consumers\n",
+		header->to_ipa_channels_num, header->from_ipa_channels_num);
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+void IPAModel::Clean()
+{
+	m_channels.clear();
+	AddChannel(IPA_MODEL_EXCEPTION_PATH, IPA_CLIENT_APPS_LAN_CONS, false, -1);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+IPAModel::Channel *IPAModel::FindChannel(const string &path)
+{
+	map<string, Channel>::iterator it = m_channels.find(path);
+
+	return (it == m_channels.end()) ? NULL : &it->second;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+IPAModel::Channel *IPAModel::FindChannel(int handle)
+{
+	map<int, string>::iterator it = m_handles.find(handle);
+
+	return (it == m_handles.end()) ? NULL : FindChannel(it->second);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+IPAModel::Channel *IPAModel::FindConsumer(enum ipa_client_type client)
+{
+	map<string, Channel>::iterator it;
+
+	for (it = m_channels.begin(); it != m_channels.end(); ++it)
+		if (!it->second.toIpa && it->second.client == client)
+			return &it->second;
+
+	return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+int IPAModel::Open(const char *path, enum ipa_client_type client, int hdrLen)
+{
+	bool toIpa;
+	Channel *ch;
+
+	if (!path) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (m_channels.empty())
+		Clean();
+
+	ch = FindChannel(path);
+	if (!ch) {
+		/* the node of an old fashion configuration, described by the caller */
+		if (client == IPA_CLIENT_MAX) {
+			LOG_MSG_ERROR("IPA model has no %s node\n", path);
+			errno = ENOENT;
+			return -1;
+		}
+		toIpa = !strncmp(path, IPA_MODEL_TO_IPA_PREFIX,
+			strlen(IPA_MODEL_TO_IPA_PREFIX));
+		AddChannel(path, client, toIpa, (int)m_channels.size());
+		ch = FindChannel(path);
+		ch->hdrLen = toIpa ? hdrLen : 0;
+	}
+
+	m_handles[m_nextHandle] = path;
+	LOG_MSG_DEBUG("IPA model opened %s (client %d) as %d\n", path,
+		ch->client, m_nextHandle);
+	return m_nextHandle++;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+void IPAModel::Close(int handle)
+{
+	m_handles.erase(handle);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::ParsePacket(const vector<uint8_t> &pkt, size_t ipOfst,
+		PacketInfo &info)
+{
+	const uint8_t *p;
+	const uint8_t *l4;
+	size_t len;
+	size_t ofst;
+	size_t l4Len;
+	uint8_t nextHdr;
+	bool firstFrag = true;
+	int i;
+
+	memset(&info, 0, sizeof(info));
+	if (pkt.size() <= ipOfst)
+		return false;
+
+	p = &pkt[ipOfst];
+	len = pkt.size() - ipOfst;
+	info.ipOfst = ipOfst;
+
+	switch (p[0] >> 4) {
+	case 4:
+		ofst = (p[0] & 0xF) * 4;
+		if (len < 20 || ofst < 20 || len < ofst)
+			return false;
+		info.ip = IPA_IP_v4;
+		info.tos = p[1];
+		info.protocol = p[9];
+		info.src[0] = GetBe32(p + 12);
+		info.dst[0] = GetBe32(p + 16);
+		/* MF set or a non zero fragment offset */
+		info.fragment = (GetBe16(p + 6) & 0x3FFF) != 0;
+		firstFrag = (GetBe16(p + 6) & 0x1FFF) == 0;
+		break;
+	case 6:
+		if (len < 40)
+			return false;
+		info.ip = IPA_IP_v6;
+		info.tos = (GetBe16(p) >> 4) & 0xFF;
+		info.flowLabel = GetBe32(p) & 0xFFFFF;
+		for (i = 0; i < 4; i++) {
+			info.src[i] = GetBe32(p + 8 + 4 * i);
+			info.dst[i] = GetBe32(p + 24 + 4 * i);
+		}
+		nextHdr = p[6];
+		ofst = 40;
+		/* hop-by-hop, routing, fragment and destination options */
+		while (nextHdr == 0 || nextHdr == 43 || nextHdr == 44 ||
+			nextHdr == 60) {
+			if (len < ofst + 8)
+				return false;
+			if (nextHdr == 44) {
+				info.fragment = true;
+				firstFrag = (GetBe16(p + ofst + 2) & 0xFFF8) == 0;
+				nextHdr = p[ofst];
+				ofst += 8;
+			} else {
+				nextHdr = p[ofst];
+				ofst += (p[ofst + 1] + 1) * 8;
+			}
+		}
+		info.protocol = nextHdr;
+		break;
+	default:
+		return false;
+	}
+
+	info.l4Ofst = ipOfst + ofst;
+	if (!firstFrag || pkt.size() <= info.l4Ofst)
+		return true;
+
+	l4 = &pkt[info.l4Ofst];
+	l4Len = pkt.size() - info.l4Ofst;
+	/* what the H/W compares at fixed L4 offsets, whatever the protocol */
+	if (l4Len >= 2) {
+		info.type = l4[0];
+		info.code = l4[1];
+	}
+	if (l4Len >= 4)
+		info.spi = GetBe32(l4);
+	if ((info.protocol == IPPROTO_TCP && l4Len >= 20) ||
+		(info.protocol == IPPROTO_UDP && l4Len >= 8)) {
+		info.hasPorts = true;
+		info.srcPort = GetBe16(l4);
+		info.dstPort = GetBe16(l4 + 2);
+		if (info.protocol == IPPROTO_TCP)
+			info.tcpFlags = l4[13];
+	}
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+static bool MatchL2(const vector<uint8_t> &pkt, size_t ipOfst, int ofst,
+		const uint8_t *val, const uint8_t *mask, size_t len)
+{
+	size_t i;
+
+	if ((size_t)-ofst > ipOfst)
+		return false;
+
+	for (i = 0; i < len; i++)
+		if ((pkt[ipOfst + ofst + i] & mask[i]) != (val[i] & mask[i]))
+			return false;
+
+	return true;
+}
+
+static bool MatchAddr(enum ipa_ip_type ip, const uint32_t *pktAddr,
+		const uint32_t *addr, const uint32_t *mask)
+{
+	int words = (ip == IPA_IP_v4) ? 1 : 4;
+	int i;
+
+	for (i = 0; i < words; i++)
+		if ((pktAddr[i] & mask[i]) != (addr[i] & mask[i]))
+			return false;
+
+	return true;
+}
+
+bool IPAModel::MatchAttrib(const struct ipa_rule_attrib &attrib,
+		const vector<uint8_t> &pkt, const PacketInfo &info)
+{
+	const uint32_t supported = IPA_FLT_TOS | IPA_FLT_PROTOCOL |
+		IPA_FLT_SRC_ADDR | IPA_FLT_DST_ADDR | IPA_FLT_SRC_PORT_RANGE |
+		IPA_FLT_DST_PORT_RANGE | IPA_FLT_TYPE | IPA_FLT_CODE |
+		IPA_FLT_SPI | IPA_FLT_SRC_PORT | IPA_FLT_DST_PORT | IPA_FLT_TC |
+		IPA_FLT_FLOW_LABEL | IPA_FLT_NEXT_HDR | IPA_FLT_META_DATA |
+		IPA_FLT_FRAGMENT | IPA_FLT_TOS_MASKED |
+		IPA_FLT_MAC_SRC_ADDR_ETHER_II | IPA_FLT_MAC_DST_ADDR_ETHER_II |
+		IPA_FLT_MAC_SRC_ADDR_802_3 | IPA_FLT_MAC_DST_ADDR_802_3 |
+		IPA_FLT_MAC_SRC_ADDR_802_1Q | IPA_FLT_MAC_DST_ADDR_802_1Q |
+		IPA_FLT_MAC_ETHER_TYPE | IPA_FLT_VLAN_ID | IPA_FLT_TCP_SYN;
+	uint32_t mask = attrib.attrib_mask;
+	uint8_t etherType[2];
+	uint8_t vlanTag[4];
+	const uint8_t allOnes[4] = { 0xFF, 0xFF, 0x0F, 0xFF };
+	uint32_t v4Addr;
+	uint32_t v4Mask;
+
+	if ((mask & ~supported) || (attrib.ext_attrib_mask & ~IPA_FLT_EXT_NEXT_HDR)) {
+		LOG_MSG_ERROR("IPA model does not support attrib mask 0x%x/0x%x\n",
+			mask & ~supported, attrib.ext_attrib_mask);
+		return false;
+	}
+
+	if (info.ip == IPA_IP_v4) {
+		if ((mask & IPA_FLT_TOS) && info.tos != attrib.u.v4.tos)
+			return false;
+		if ((mask & IPA_FLT_PROTOCOL) &&
+			info.protocol != attrib.u.v4.protocol)
+			return false;
+		v4Addr = attrib.u.v4.src_addr;
+		v4Mask = attrib.u.v4.src_addr_mask;
+		if ((mask & IPA_FLT_SRC_ADDR) &&
+			!MatchAddr(info.ip, info.src, &v4Addr, &v4Mask))
+			return false;
+		v4Addr = attrib.u.v4.dst_addr;
+		v4Mask = attrib.u.v4.dst_addr_mask;
+		if ((mask & IPA_FLT_DST_ADDR) &&
+			!MatchAddr(info.ip, info.dst, &v4Addr, &v4Mask))
+			return false;
+	} else {
+		if ((mask & IPA_FLT_TC) && info.tos != attrib.u.v6.tc)
+			return false;
+		if ((mask & IPA_FLT_FLOW_LABEL) &&
+			info.flowLabel != attrib.u.v6.flow_label)
+			return false;
+		if (((mask & IPA_FLT_NEXT_HDR) ||
+			(attrib.ext_attrib_mask & IPA_FLT_EXT_NEXT_HDR)) &&
+			info.protocol != attrib.u.v6.next_hdr)
+			return false;
+		if ((mask & IPA_FLT_SRC_ADDR) && !MatchAddr(info.ip, info.src,
+			attrib.u.v6.src_addr, attrib.u.v6.src_addr_mask))
+			return false;
+		if ((mask & IPA_FLT_DST_ADDR) && !MatchAddr(info.ip, info.dst,
+			attrib.u.v6.dst_addr, attrib.u.v6.dst_addr_mask))
+			return false;
+	}
+
+	if ((mask & IPA_FLT_TOS_MASKED) &&
+		(info.tos & attrib.tos_mask) != (attrib.tos_value & attrib.tos_mask))
+		return false;
+
+	if ((mask & (IPA_FLT_SRC_PORT | IPA_FLT_DST_PORT |
+		IPA_FLT_SRC_PORT_RANGE | IPA_FLT_DST_PORT_RANGE)) && !info.hasPorts)
+		return false;
+	if ((mask & IPA_FLT_SRC_PORT) && info.srcPort != attrib.src_port)
+		return false;
+	if ((mask & IPA_FLT_DST_PORT) && info.dstPort != attrib.dst_port)
+		return false;
+	if ((mask & IPA_FLT_SRC_PORT_RANGE) &&
+		(info.srcPort < attrib.src_port_lo || info.srcPort > attrib.src_port_hi))
+		return false;
+	if ((mask & IPA_FLT_DST_PORT_RANGE) &&
+		(info.dstPort < attrib.dst_port_lo || info.dstPort > attrib.dst_port_hi))
+		return false;
+
+	if ((mask & IPA_FLT_TYPE) && info.type != attrib.type)
+		return false;
+	if ((mask & IPA_FLT_CODE) && info.code != attrib.code)
+		return false;
+	if ((mask & IPA_FLT_SPI) && info.spi != attrib.spi)
+		return false;
+	if ((mask & IPA_FLT_TCP_SYN) &&
+		(info.protocol != IPPROTO_TCP || !(info.tcpFlags & 0x02)))
+		return false;
+	if ((mask & IPA_FLT_FRAGMENT) && !info.fragment)
+		return false;
+	if ((mask & IPA_FLT_META_DATA) && (info.metadata & attrib.meta_data_mask) !=
+		(attrib.meta_data & attrib.meta_data_mask))
+		return false;
+
+	/* L2 offsets are relative to the start of the IP header */
+	if ((mask & IPA_FLT_MAC_DST_ADDR_ETHER_II) && !MatchL2(pkt, info.ipOfst,
+		-14, attrib.dst_mac_addr, attrib.dst_mac_addr_mask, ETH_ALEN))
+		return false;
+	if ((mask & IPA_FLT_MAC_SRC_ADDR_ETHER_II) && !MatchL2(pkt, info.ipOfst,
+		-8, attrib.src_mac_addr, attrib.src_mac_addr_mask, ETH_ALEN))
+		return false;
+	if ((mask & IPA_FLT_MAC_DST_ADDR_802_3) && !MatchL2(pkt, info.ipOfst,
+		-22, attrib.dst_mac_addr, attrib.dst_mac_addr_mask, ETH_ALEN))
+		return false;
+	if ((mask & IPA_FLT_MAC_SRC_ADDR_802_3) && !MatchL2(pkt, info.ipOfst,
+		-16, attrib.src_mac_addr, attrib.src_mac_addr_mask, ETH_ALEN))
+		return false;
+	if ((mask & IPA_FLT_MAC_DST_ADDR_802_1Q) && !MatchL2(pkt, info.ipOfst,
+		-18, attrib.dst_mac_addr, attrib.dst_mac_addr_mask, ETH_ALEN))
+		return false;
+	if ((mask & IPA_FLT_MAC_SRC_ADDR_802_1Q) && !MatchL2(pkt, info.ipOfst,
+		-12, attrib.src_mac_addr, attrib.src_mac_addr_mask, ETH_ALEN))
+		return false;
+	PutBe16(etherType, attrib.ether_type);
+	if ((mask & IPA_FLT_MAC_ETHER_TYPE) && !MatchL2(pkt, info.ipOfst,
+		-2, etherType, allOnes, sizeof(etherType)))
+		return false;
+	/* 0x8100 TPID followed by the VLAN ID */
+	PutBe32(vlanTag, (0x8100 << 16) | (attrib.vlan_id & 0xFFF));
+	if ((mask & IPA_FLT_VLAN_ID) && !MatchL2(pkt, info.ipOfst,
+		-6, vlanTag, allOnes, sizeof(vlanTag)))
+		return false;
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::CacheLookup(set<string> &cache, enum ipa_client_type src,
+		const PacketInfo &info)
+{
+	char key[128];
+
+	snprintf(key, sizeof(key), "%d:%08x%08x%08x%08x:%08x%08x%08x%08x:%u:%u:%u",
+		src, info.src[0], info.src[1], info.src[2], info.src[3],
+		info.dst[0], info.dst[1], info.dst[2], info.dst[3],
+		info.protocol, info.srcPort, info.dstPort);
+
+	return !cache.insert(key).second;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+const IPAModel::FltRule *IPAModel::LookupFilter(const Channel &prod,
+		const vector<uint8_t> &pkt, const PacketInfo &info,
+		Verdict &verdict)
+{
+	map<enum ipa_client_type, vector<FltRule> >::iterator it;
+	int pass;
+	size_t i;
+
+	it = m_fltTables[info.ip].find(prod.client);
+	if (it == m_fltTables[info.ip].end())
+		return NULL;
+
+	/* max_prio rules first, then the rest in table order */
+	for (pass = 0; pass < 2; pass++) {
+		for (i = 0; i < it->second.size(); i++) {
+			const FltRule &rule = it->second[i];
+
+			if ((pass == 0) != rule.maxPrio || rule.eqAttrib)
+				continue;
+			if (!MatchAttrib(rule.attrib, pkt, info))
+				continue;
+			verdict.fltRuleId = rule.hdl & 0x3FF;
+			verdict.fltHash = rule.hashable &&
+				CacheLookup(m_fltCache[info.ip], prod.client, info);
+			return &rule;
+		}
+	}
+
+	return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+const IPAModel::RtRule *IPAModel::LookupRoute(uint32_t rtTblHdl,
+		const Channel &prod, const vector<uint8_t> &pkt,
+		const PacketInfo &info, Verdict &verdict)
+{
+	map<uint32_t, RtTable>::iterator it;
+	int pass;
+	size_t i;
+
+	it = m_rtTables[info.ip].find(rtTblHdl);
+	if (it == m_rtTables[info.ip].end())
+		return NULL;
+
+	verdict.rtTblIdx = it->second.hdl & 0xFF;
+	for (pass = 0; pass < 2; pass++) {
+		for (i = 0; i < it->second.rules.size(); i++) {
+			const RtRule &rule = it->second.rules[i];
+
+			if ((pass == 0) != rule.maxPrio)
+				continue;
+			if (!MatchAttrib(rule.attrib, pkt, info))
+				continue;
+			verdict.rtRuleId = rule.hdl & 0x3FF;
+			verdict.rtHash = rule.hashable &&
+				CacheLookup(m_rtCache[info.ip], prod.client, info);
+			return &rule;
+		}
+	}
+
+	return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+void IPAModel::DecrementTtl(vector<uint8_t> &pkt, const PacketInfo &info)
+{
+	uint8_t *ip = &pkt[info.ipOfst];
+	uint16_t old;
+
+	if (info.ip == IPA_IP_v4) {
+		if (!ip[8])
+			return;
+		old = GetBe16(ip + 8);
+		ip[8]--;
+		UpdateChecksum16(ip + 10, old, GetBe16(ip + 8));
+	} else if (ip[7]) {
+		ip[7]--;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::InsertHeader(const RtRule &rule, vector<uint8_t> &pkt)
+{
+	map<uint32_t, ProcCtx>::iterator ctx;
+	map<uint32_t, Header>::iterator hdr;
+	uint32_t hdrHdl = rule.hdrHdl;
+	bool to802_3 = false;
+
+	if (rule.procCtxHdl) {
+		ctx = m_procCtxs.find(rule.procCtxHdl);
+		if (ctx == m_procCtxs.end())
+			return false;
+		hdrHdl = ctx->second.hdrHdl;
+		to802_3 = (ctx->second.type == IPA_HDR_PROC_ETHII_TO_802_3 ||
+			ctx->second.type == IPA_HDR_PROC_802_3_TO_802_3);
+	}
+	if (!hdrHdl)
+		return true;
+
+	hdr = m_headers.find(hdrHdl);
+	if (hdr == m_headers.end())
+		return false;
+
+	pkt.insert(pkt.begin(), hdr->second.bytes.begin(), hdr->second.bytes.end());
+	/* an 802.3 header carries the length of what follows it */
+	if (to802_3 && pkt.size() >= ETH_HLEN)
+		PutBe16(&pkt[12], (uint16_t)(pkt.size() - ETH_HLEN));
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+static void FillStatus(T &status, size_t len, int src, int dst)
+{
+	memset(&status, 0, sizeof(status));
+	status.status_opcode = IPA_MODEL_STATUS_OPCODE_PACKET;
+	status.pkt_len = len;
+	status.endp_src_idx = src;
+	status.endp_dest_idx = dst;
+}
+
+void IPAModel::AddStatus(const Channel &prod, const Channel &cons,
+		vector<uint8_t> &pkt, const Verdict &verdict)
+{
+	struct ipa3_hw_pkt_status status;
+	struct ipa3_hw_pkt_status_hw_v5_0 status_v5_0;
+	struct ipa3_hw_pkt_status_hw_v5_5 status_v5_5;
+	const uint8_t *p;
+	size_t len;
+
+	switch (m_hwType) {
+	case IPA_HW_v5_5:
+		FillStatus(status_v5_5, pkt.size(), prod.index, cons.index);
+		status_v5_5.flt_hash = verdict.fltHash;
+		status_v5_5.flt_rule_id = verdict.fltRuleId;
+		status_v5_5.rt_hash = verdict.rtHash;
+		status_v5_5.rt_rule_id = verdict.rtRuleId;
+		status_v5_5.rt_tbl_idx = verdict.rtTblIdx;
+		status_v5_5.nat_hit = verdict.natHit;
+		p = (const uint8_t *)&status_v5_5;
+		len = sizeof(status_v5_5);
+		break;
+	case IPA_HW_v5_0:
+	case IPA_HW_v5_1:
+		FillStatus(status_v5_0, pkt.size(), prod.index, cons.index);
+		status_v5_0.filt_hash = verdict.fltHash;
+		status_v5_0.filt_rule_id = verdict.fltRuleId;
+		status_v5_0.route_hash = verdict.rtHash;
+		status_v5_0.route_rule_id = verdict.rtRuleId;
+		status_v5_0.route_tbl_idx = verdict.rtTblIdx;
+		status_v5_0.nat_hit = verdict.natHit;
+		p = (const uint8_t *)&status_v5_0;
+		len = sizeof(status_v5_0);
+		break;
+	default:
+		FillStatus(status, pkt.size(), prod.index, cons.index);
+		status.filt_hash = verdict.fltHash;
+		status.filt_rule_id = verdict.fltRuleId;
+		status.route_hash = verdict.rtHash;
+		status.route_rule_id = verdict.rtRuleId;
+		status.route_tbl_idx = verdict.rtTblIdx;
+		status.nat_hit = verdict.natHit;
+		p = (const uint8_t *)&status;
+		len = sizeof(status);
+		break;
+	}
+
+	pkt.insert(pkt.begin(), p, p + len);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+void IPAModel::Deliver(const Channel &prod, vector<uint8_t> &pkt,
+		const Verdict &verdict)
+{
+	Channel *cons = FindConsumer(verdict.dst);
+
+	if (verdict.exception)
+		m_exceptions++;
+
+	if (!cons) {
+		LOG_MSG_DEBUG("IPA model dropped a packet to client %d\n",
+			verdict.dst);
+		m_drops++;
+		return;
+	}
+
+	if (cons->status)
+		AddStatus(prod, *cons, pkt, verdict);
+
+	cons->rxQueue.push_back(pkt);
+	m_txPackets++;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+long IPAModel::Write(int handle, const uint8_t *buf, size_t size)
+{
+	Channel *prod = FindChannel(handle);
+	vector<uint8_t> pkt(buf, buf + size);
+	const FltRule *flt;
+	const RtRule *rt;
+	PacketInfo info;
+	Verdict verdict;
+	uint32_t rtTblHdl;
+
+	if (!prod || !prod->toIpa) {
+		errno = EBADF;
+		return -1;
+	}
+
+	m_rxPackets++;
+	memset(&verdict, 0, sizeof(verdict));
+	verdict.dst = IPA_CLIENT_APPS_LAN_CONS;
+	verdict.exception = true;
+
+	if (prod->dma) {
+		verdict.dst = prod->dmaDst;
+		verdict.exception = false;
+		Deliver(*prod, pkt, verdict);
+		return size;
+	}
+
+	/* a packet the parser rejects goes up as is, like an IP exception */
+	if (!ParsePacket(pkt, prod->hdrLen, info)) {
+		Deliver(*prod, pkt, verdict);
+		return size;
+	}
+
+	if (prod->metadataInHdr && prod->metadataOfst + 4 <= prod->hdrLen)
+		info.metadata = GetBe32(&pkt[prod->metadataOfst]);
+	else
+		info.metadata = prod->metadata;
+
+	flt = LookupFilter(*prod, pkt, info, verdict);
+	if (!flt || flt->action == IPA_PASS_TO_EXCEPTION) {
+		Deliver(*prod, pkt, verdict);
+		return size;
+	}
+
+	rtTblHdl = flt->rtTblHdl;
+	/*NAT tables are not modelled, every NAT lookup misses*/
+	if (flt->action == IPA_PASS_TO_SRC_NAT ||
+		flt->action == IPA_PASS_TO_DST_NAT) {
+		if (!m_natExcRtTblHdl) {
+			Deliver(*prod, pkt, verdict);
+			return size;
+		}
+		rtTblHdl = m_natExcRtTblHdl;
+	}
+
+	rt = LookupRoute(rtTblHdl, *prod, pkt, info, verdict);
+	if (!rt) {
+		Deliver(*prod, pkt, verdict);
+		return size;
+	}
+
+	if (flt->ttlUpdate || rt->ttlUpdate)
+		DecrementTtl(pkt, info);
+
+	/* header removal, then header insertion unless the header is kept */
+	if (!flt->retainHdr && !rt->retainHdr) {
+		pkt.erase(pkt.begin(), pkt.begin() + prod->hdrLen);
+		if (!InsertHeader(*rt, pkt)) {
+			LOG_MSG_ERROR("IPA model: stale header of rule 0x%x\n", rt->hdl);
+			m_drops++;
+			return size;
+		}
+	}
+
+	verdict.dst = rt->dst;
+	verdict.exception = false;
+	Deliver(*prod, pkt, verdict);
+	return size;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+int IPAModel::Read(int handle, uint8_t *buf, size_t size)
+{
+	Channel *cons = FindChannel(handle);
+	size_t len;
+
+	if (!cons || cons->toIpa) {
+		errno = EBADF;
+		return -1;
+	}
+
+	/* nothing left: what a non blocking read of an idle pipe returns */
+	if (cons->rxQueue.empty())
+		return 0;
+
+	len = min(size, cons->rxQueue.front().size());
+	memcpy(buf, cons->rxQueue.front().data(), len);
+	cons->rxQueue.pop_front();
+	return len;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+bool IPAModel::AddRtRule(enum ipa_ip_type ip, const char *tableName, T &add)
+{
+	map<uint32_t, RtTable>::iterator it;
+	RtTable *tbl = NULL;
+	RtRule rule;
+
+	if (add.rule.hdr_hdl && add.rule.hdr_proc_ctx_hdl) {
+		add.status = -1;
+		return false;
+	}
+
+	for (it = m_rtTables[ip].begin(); it != m_rtTables[ip].end(); ++it) {
+		if (it->second.name == tableName) {
+			tbl = &it->second;
+			break;
+		}
+	}
+	if (!tbl) {
+		tbl = &m_rtTables[ip][m_nextHdl];
+		tbl->hdl = m_nextHdl++;
+		tbl->ip = ip;
+		tbl->name = tableName;
+		tbl->refCount = 0;
+	}
+
+	rule.hdl = m_nextHdl++;
+	rule.dst = add.rule.dst;
+	rule.hdrHdl = add.rule.hdr_hdl;
+	rule.procCtxHdl = add.rule.hdr_proc_ctx_hdl;
+	rule.attrib = add.rule.attrib;
+	rule.maxPrio = add.rule.max_prio;
+	rule.hashable = add.rule.hashable;
+	rule.retainHdr = add.rule.retain_hdr;
+	rule.ttlUpdate = RuleTtlUpdate(add.rule);
+	if (add.at_rear)
+		tbl->rules.push_back(rule);
+	else
+		tbl->rules.insert(tbl->rules.begin(), rule);
+
+	add.rt_rule_hdl = rule.hdl;
+	add.status = 0;
+	return true;
+}
+
+bool IPAModel::AddRoutingRule(struct ipa_ioc_add_rt_rule *ruleTable)
+{
+	bool ret = true;
+	int i;
+
+	if (ruleTable->ip >= IPA_IP_MAX)
+		return false;
+
+	ruleTable->rt_tbl_name[IPA_RESOURCE_NAME_MAX - 1] = '\0';
+	for (i = 0; i < ruleTable->num_rules; i++)
+		ret &= AddRtRule(ruleTable->ip, ruleTable->rt_tbl_name,
+			ruleTable->rules[i]);
+	if (ruleTable->commit)
+		CommitRouting(ruleTable->ip);
+
+	return ret;
+}
+
+bool IPAModel::AddRoutingRule(struct ipa_ioc_add_rt_rule_v2 *ruleTable)
+{
+	uint8_t *rules = (uint8_t *)(uintptr_t)ruleTable->rules;
+	bool ret = true;
+	int i;
+
+	if (ruleTable->ip >= IPA_IP_MAX || !rules)
+		return false;
+
+	ruleTable->rt_tbl_name[IPA_RESOURCE_NAME_MAX - 1] = '\0';
+	for (i = 0; i < ruleTable->num_rules; i++)
+		ret &= AddRtRule(ruleTable->ip, ruleTable->rt_tbl_name,
+			*(struct ipa_rt_rule_add_v2 *)
+			(rules + i * ruleTable->rule_add_size));
+	if (ruleTable->commit)
+		CommitRouting(ruleTable->ip);
+
+	return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::DeleteRoutingRule(struct ipa_ioc_del_rt_rule *ruleTable)
+{
+	map<uint32_t, RtTable>::iterator it;
+	vector<RtRule>::iterator rule;
+	bool ret = true;
+	int i;
+
+	if (ruleTable->ip >= IPA_IP_MAX)
+		return false;
+
+	for (i = 0; i < ruleTable->num_hdls; i++) {
+		ruleTable->hdl[i].status = -1;
+		for (it = m_rtTables[ruleTable->ip].begin();
+			it != m_rtTables[ruleTable->ip].end(); ++it) {
+			for (rule = it->second.rules.begin();
+				rule != it->second.rules.end(); ++rule) {
+				if (rule->hdl == ruleTable->hdl[i].hdl)
+					break;
+			}
+			if (rule != it->second.rules.end()) {
+				it->second.rules.erase(rule);
+				ruleTable->hdl[i].status = 0;
+				/* an unreferenced table goes with its last rule */
+				if (it->second.rules.empty() && !it->second.refCount)
+					m_rtTables[ruleTable->ip].erase(it);
+				break;
+			}
+		}
+		ret &= !ruleTable->hdl[i].status;
+	}
+	if (ruleTable->commit)
+		CommitRouting(ruleTable->ip);
+
+	return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::CommitRouting(enum ipa_ip_type ip)
+{
+	if (ip >= IPA_IP_MAX)
+		return false;
+
+	m_rtCache[ip].clear();
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::ResetRouting(enum ipa_ip_type ip)
+{
+	map<uint32_t, RtTable>::iterator it;
+
+	if (ip >= IPA_IP_MAX)
+		return false;
+
+	for (it = m_rtTables[ip].begin(); it != m_rtTables[ip].end();) {
+		it->second.rules.clear();
+		if (!it->second.refCount)
+			m_rtTables[ip].erase(it++);
+		else
+			++it;
+	}
+
+	return CommitRouting(ip);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::GetRoutingTable(struct ipa_ioc_get_rt_tbl *routingTable)
+{
+	map<uint32_t, RtTable>::iterator it;
+
+	if (routingTable->ip >= IPA_IP_MAX)
+		return false;
+
+	routingTable->name[IPA_RESOURCE_NAME_MAX - 1] = '\0';
+	for (it = m_rtTables[routingTable->ip].begin();
+		it != m_rtTables[routingTable->ip].end(); ++it) {
+		if (it->second.name == routingTable->name) {
+			it->second.refCount++;
+			routingTable->hdl = it->second.hdl;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::PutRoutingTable(uint32_t routingTableHandle)
+{
+	map<uint32_t, RtTable>::iterator it;
+	int ip;
+
+	for (ip = 0; ip < IPA_IP_MAX; ip++) {
+		it = m_rtTables[ip].find(routingTableHandle);
+		if (it == m_rtTables[ip].end() || !it->second.refCount)
+			continue;
+		if (!--it->second.refCount && it->second.rules.empty())
+			m_rtTables[ip].erase(it);
+		return true;
+	}
+
+	return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::SetExceptionRoutingTable(uint32_t routingTableHandle,
+		bool nat_or_conntrack)
+{
+	/* conntrack is not modelled, its exception table is only recorded */
+	if (nat_or_conntrack)
+		m_natExcRtTblHdl = routingTableHandle;
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+bool IPAModel::AddFltRule(enum ipa_ip_type ip, enum ipa_client_type ep, T &add)
+{
+	vector<FltRule> &rules = m_fltTables[ip][ep];
+	FltRule rule;
+
+	rule.hdl = m_nextHdl++;
+	rule.action = add.rule.action;
+	rule.rtTblHdl = add.rule.rt_tbl_hdl;
+	rule.attrib = add.rule.attrib;
+	rule.eqAttrib = add.rule.eq_attrib_type;
+	rule.maxPrio = add.rule.max_prio;
+	rule.hashable = add.rule.hashable;
+	rule.retainHdr = add.rule.retain_hdr;
+	rule.ttlUpdate = RuleTtlUpdate(add.rule);
+	if (rule.eqAttrib)
+		LOG_MSG_ERROR("IPA model does not evaluate equation form rules\n");
+
+	if (add.at_rear)
+		rules.push_back(rule);
+	else
+		rules.insert(rules.begin(), rule);
+
+	add.flt_rule_hdl = rule.hdl;
+	add.status = 0;
+	return true;
+}
+
+bool IPAModel::AddFilteringRule(struct ipa_ioc_add_flt_rule const *ruleTable)
+{
+	struct ipa_ioc_add_flt_rule *table = (struct ipa_ioc_add_flt_rule *)ruleTable;
+	bool ret = true;
+	int i;
+
+	/* global filtering tables are gone since IPA v3.0 */
+	if (table->ip >= IPA_IP_MAX || table->global)
+		return false;
+
+	for (i = 0; i < table->num_rules; i++)
+		ret &= AddFltRule(table->ip, table->ep, table->rules[i]);
+	if (table->commit)
+		CommitFiltering(table->ip);
+
+	return ret;
+}
+
+bool IPAModel::AddFilteringRule(struct ipa_ioc_add_flt_rule_v2 const *ruleTable)
+{
+	uint8_t *rules = (uint8_t *)(uintptr_t)ruleTable->rules;
+	bool ret = true;
+	int i;
+
+	if (ruleTable->ip >= IPA_IP_MAX || ruleTable->global || !rules)
+		return false;
+
+	for (i = 0; i < ruleTable->num_rules; i++)
+		ret &= AddFltRule(ruleTable->ip, ruleTable->ep,
+			*(struct ipa_flt_rule_add_v2 *)
+			(rules + i * ruleTable->flt_rule_size));
+	if (ruleTable->commit)
+		CommitFiltering(ruleTable->ip);
+
+	return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::DeleteFilteringRule(struct ipa_ioc_del_flt_rule *ruleTable)
+{
+	map<enum ipa_client_type, vector<FltRule> >::iterator it;
+	vector<FltRule>::iterator rule;
+	bool ret = true;
+	int i;
+
+	if (ruleTable->ip >= IPA_IP_MAX)
+		return false;
+
+	for (i = 0; i < ruleTable->num_hdls; i++) {
+		ruleTable->hdl[i].status = -1;
+		for (it = m_fltTables[ruleTable->ip].begin();
+			it != m_fltTables[ruleTable->ip].end(); ++it) {
+			for (rule = it->second.begin(); rule != it->second.end(); ++rule)
+				if (rule->hdl == ruleTable->hdl[i].hdl)
+					break;
+			if (rule != it->second.end()) {
+				it->second.erase(rule);
+				ruleTable->hdl[i].status = 0;
+				break;
+			}
+		}
+		ret &= !ruleTable->hdl[i].status;
+	}
+	if (ruleTable->commit)
+		CommitFiltering(ruleTable->ip);
+
+	return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::CommitFiltering(enum ipa_ip_type ip)
+{
+	if (ip >= IPA_IP_MAX)
+		return false;
+
+	m_fltCache[ip].clear();
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::ResetFiltering(enum ipa_ip_type ip)
+{
+	if (ip >= IPA_IP_MAX)
+		return false;
+
+	m_fltTables[ip].clear();
+	return CommitFiltering(ip);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::AddHeader(struct ipa_ioc_add_hdr *pHeaderTable)
+{
+	map<uint32_t, Header>::iterator it;
+	bool ret = true;
+	int i;
+
+	for (i = 0; i < pHeaderTable->num_hdrs; i++) {
+		struct ipa_hdr_add &add = pHeaderTable->hdr[i];
+
+		add.name[IPA_RESOURCE_NAME_MAX - 1] = '\0';
+		for (it = m_headers.begin(); it != m_headers.end(); ++it)
+			if (it->second.name == add.name)
+				break;
+		if (it != m_headers.end() || add.hdr_len > IPA_HDR_MAX_SIZE) {
+			add.status = -1;
+			ret = false;
+			continue;
+		}
+
+		Header &hdr = m_headers[m_nextHdl];
+
+		hdr.name = add.name;
+		hdr.bytes.assign(add.hdr, add.hdr + add.hdr_len);
+		hdr.isPartial = add.is_partial;
+		hdr.type = add.type;
+		add.hdr_hdl = m_nextHdl++;
+		add.status = 0;
+	}
+
+	return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::DeleteHeader(struct ipa_ioc_del_hdr *pHeaderTable)
+{
+	bool ret = true;
+	int i;
+
+	for (i = 0; i < pHeaderTable->num_hdls; i++) {
+		if (m_headers.erase(pHeaderTable->hdl[i].hdl)) {
+			pHeaderTable->hdl[i].status = 0;
+		} else {
+			pHeaderTable->hdl[i].status = -1;
+			ret = false;
+		}
+	}
+
+	return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::GetHeaderHandle(struct ipa_ioc_get_hdr *pHeaderStruct)
+{
+	map<uint32_t, Header>::iterator it;
+
+	pHeaderStruct->name[IPA_RESOURCE_NAME_MAX - 1] = '\0';
+	for (it = m_headers.begin(); it != m_headers.end(); ++it) {
+		if (it->second.name == pHeaderStruct->name) {
+			pHeaderStruct->hdl = it->first;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::CopyHeader(struct ipa_ioc_copy_hdr *pCopyHeaderStruct)
+{
+	map<uint32_t, Header>::iterator it;
+
+	pCopyHeaderStruct->name[IPA_RESOURCE_NAME_MAX - 1] = '\0';
+	for (it = m_headers.begin(); it != m_headers.end(); ++it) {
+		if (it->second.name == pCopyHeaderStruct->name) {
+			memcpy(pCopyHeaderStruct->hdr, it->second.bytes.data(),
+				it->second.bytes.size());
+			pCopyHeaderStruct->hdr_len = it->second.bytes.size();
+			pCopyHeaderStruct->type = it->second.type;
+			pCopyHeaderStruct->is_partial = it->second.isPartial;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::AddProcCtx(struct ipa_ioc_add_hdr_proc_ctx *procCtxTable)
+{
+	bool ret = true;
+	int i;
+
+	for (i = 0; i < procCtxTable->num_proc_ctxs; i++) {
+		struct ipa_hdr_proc_ctx_add &add = procCtxTable->proc_ctx[i];
+
+		switch (add.type) {
+		case IPA_HDR_PROC_NONE:
+		case IPA_HDR_PROC_ETHII_TO_ETHII:
+		case IPA_HDR_PROC_ETHII_TO_802_3:
+		case IPA_HDR_PROC_802_3_TO_ETHII:
+		case IPA_HDR_PROC_802_3_TO_802_3:
+		case IPA_HDR_PROC_ETHII_TO_ETHII_EX:
+			break;
+		default:
+			LOG_MSG_ERROR("IPA model does not support proc ctx type %d\n",
+				add.type);
+			add.status = -1;
+			ret = false;
+			continue;
+		}
+		if (add.hdr_hdl && !m_headers.count(add.hdr_hdl)) {
+			add.status = -1;
+			ret = false;
+			continue;
+		}
+
+		ProcCtx &ctx = m_procCtxs[m_nextHdl];
+
+		ctx.type = add.type;
+		ctx.hdrHdl = add.hdr_hdl;
+		add.proc_ctx_hdl = m_nextHdl++;
+		add.status = 0;
+	}
+
+	return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::DeleteProcCtx(struct ipa_ioc_del_hdr_proc_ctx *procCtxTable)
+{
+	bool ret = true;
+	int i;
+
+	for (i = 0; i < procCtxTable->num_hdls; i++) {
+		if (m_procCtxs.erase(procCtxTable->hdl[i].hdl)) {
+			procCtxTable->hdl[i].status = 0;
+		} else {
+			procCtxTable->hdl[i].status = -1;
+			ret = false;
+		}
+	}
+
+	return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::CommitHeaders()
+{
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool IPAModel::ResetHeaders()
+{
+	m_headers.clear();
+	m_procCtxs.clear();
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+void IPAModel::PrintStats()
+{
+	printf("IPA model: rx=%llu tx=%llu exceptions=%llu drops=%llu\n",
+		(unsigned long long)m_rxPackets, (unsigned long long)m_txPackets,
+		(unsigned long long)m_exceptions, (unsigned long long)m_drops);
+}
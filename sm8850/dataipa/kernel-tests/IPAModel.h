@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the
+ * disclaimer below) provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *     * Neither the name of Qualcomm Innovation Center, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+ * GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#ifndef _IPA_MODEL_H_
+#define _IPA_MODEL_H_
+
+#include <stdint.h>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "linux/msm_ipa.h"
+#include "ipa_test_module.h"
+
+using namespace std;
+
+/*Selects the model when set, the value is the IPA_HW_* version to report
+ *(e.g. IPA_TEST_MODEL=21), an empty or 0 value reports IPA_MODEL_HW_TYPE.
+ */
+#define IPA_MODEL_ENV "IPA_TEST_MODEL"
+#define IPA_MODEL_HW_TYPE IPA_HW_v5_0
+#define IPA_MODEL_EXCEPTION_PATH "/dev/ipa_exception_pipe"
+
+/*This class stands in for the IPA H/W, the IPA driver and the ipa_test
+ *kernel module, so the tests can run on a host without them.
+ *
+ *It is enabled by IPA_MODEL_ENV or by the --model option. The driver
+ *wrappers (RoutingDriverWrapper, Filtering, HeaderInsertion), Pipe,
+ *InterfaceAbstraction and the ipa_test configuration helpers then hand
+ *their requests to it instead of issuing them to /dev/ipa, /dev/ipa_test
+ *and the pipe device nodes.
+ *
+ *A write to a producer node goes through header removal, filtering,
+ *routing and header insertion (or processing context) against
+ *the in-memory tables, and the result is queued on the consumer node
+ *before the write returns, so the runs are deterministic. Hashable rule
+ *hits are cached per 5-tuple until the next commit, and the status is
+ *prepended on consumers configured with en_status.
+ *
+ *Not modelled: aggregation and deaggregation, equation form rules,
+ *checksum offload, ULSO, HOLB, endpoint suspend/delay, and the update of
+ *the packet length field of the inserted header.
+ */
+class IPAModel
+{
+public:
+	static IPAModel &GetInstance();
+
+	static bool IsEnabled();
+
+	/*Enables the model, reporting hwType (IPA_HW_None for the default)*/
+	static void Enable(enum ipa_hw_type hwType);
+
+	enum ipa_hw_type GetHwType();
+
+	/*ipa_test module configuration (IPA_TEST_IOC_CONFIGURE / _CLEAN)*/
+	bool Configure(const struct ipa_test_config_header *header);
+	void Clean();
+
+	/*Pipe device nodes. Nodes a generic configuration did not describe
+	 *take their client and header length from the caller. The handle
+	 *is not a file descriptor.
+	 */
+	int Open(const char *path, enum ipa_client_type client = IPA_CLIENT_MAX,
+			int hdrLen = 0);
+	void Close(int handle);
+	long Write(int handle, const uint8_t *buf, size_t size);
+	int Read(int handle, uint8_t *buf, size_t size);
+
+	/*Routing block*/
+	bool AddRoutingRule(struct ipa_ioc_add_rt_rule *ruleTable);
+	bool AddRoutingRule(struct ipa_ioc_add_rt_rule_v2 *ruleTable);
+	bool DeleteRoutingRule(struct ipa_ioc_del_rt_rule *ruleTable);
+	bool CommitRouting(enum ipa_ip_type ip);
+	bool ResetRouting(enum ipa_ip_type ip);
+	bool GetRoutingTable(struct ipa_ioc_get_rt_tbl *routingTable);
+	bool PutRoutingTable(uint32_t routingTableHandle);
+	bool SetExceptionRoutingTable(uint32_t routingTableHandle,
+			bool nat_or_conntrack);
+
+	/*Filtering block*/
+	bool AddFilteringRule(struct ipa_ioc_add_flt_rule const *ruleTable);
+	bool AddFilteringRule(struct ipa_ioc_add_flt_rule_v2 const *ruleTable);
+	bool DeleteFilteringRule(struct ipa_ioc_del_flt_rule *ruleTable);
+	bool CommitFiltering(enum ipa_ip_type ip);
+	bool ResetFiltering(enum ipa_ip_type ip);
+
+	/*Header insertion block*/
+	bool AddHeader(struct ipa_ioc_add_hdr *pHeaderTable);
+	bool DeleteHeader(struct ipa_ioc_del_hdr *pHeaderTable);
+	bool GetHeaderHandle(struct ipa_ioc_get_hdr *pHeaderStruct);
+	bool CopyHeader(struct ipa_ioc_copy_hdr *pCopyHeaderStruct);
+	bool AddProcCtx(struct ipa_ioc_add_hdr_proc_ctx *procCtxTable);
+	bool DeleteProcCtx(struct ipa_ioc_del_hdr_proc_ctx *procCtxTable);
+	bool CommitHeaders();
+	bool ResetHeaders();
+
+	void PrintStats();
+
+private:
+	struct Channel {
+		string path;
+		enum ipa_client_type client;
+		bool toIpa;
+		int hdrLen;
+		bool dma;
+		enum ipa_client_type dmaDst;
+		bool metadataInHdr;
+		int metadataOfst;
+		uint32_t metadata;
+		bool status;
+		int index;
+		deque<vector<uint8_t> > rxQueue;
+	};
+
+	struct RtRule {
+		uint32_t hdl;
+		enum ipa_client_type dst;
+		uint32_t hdrHdl;
+		uint32_t procCtxHdl;
+		struct ipa_rule_attrib attrib;
+		bool maxPrio;
+		bool hashable;
+		bool retainHdr;
+		bool ttlUpdate;
+	};
+
+	struct RtTable {
+		uint32_t hdl;
+		enum ipa_ip_type ip;
+		string name;
+		int refCount;
+		vector<RtRule> rules;
+	};
+
+	struct FltRule {
+		uint32_t hdl;
+		enum ipa_flt_action action;
+		uint32_t rtTblHdl;
+		struct ipa_rule_attrib attrib;
+		bool eqAttrib;
+		bool maxPrio;
+		bool hashable;
+		bool retainHdr;
+		bool ttlUpdate;
+	};
+
+	struct Header {
+		string name;
+		vector<uint8_t> bytes;
+		bool isPartial;
+		enum ipa_hdr_l2_type type;
+	};
+
+	struct ProcCtx {
+		enum ipa_hdr_proc_type type;
+		uint32_t hdrHdl;
+	};
+
+	/*Fields of an IP packet the rules look at, in host order*/
+	struct PacketInfo {
+		enum ipa_ip_type ip;
+		size_t ipOfst;
+		size_t l4Ofst;
+		uint8_t tos;
+		uint8_t protocol;
+		uint32_t src[4];
+		uint32_t dst[4];
+		uint32_t flowLabel;
+		bool fragment;
+		bool hasPorts;
+		uint16_t srcPort;
+		uint16_t dstPort;
+		uint8_t type;
+		uint8_t code;
+		uint32_t spi;
+		uint8_t tcpFlags;
+		uint32_t metadata;
+	};
+
+	/*What the lookup did to a packet, reported in the status*/
+	struct Verdict {
+		enum ipa_client_type dst;
+		bool fltHash;
+		uint32_t fltRuleId;
+		bool rtHash;
+		uint32_t rtRuleId;
+		uint32_t rtTblIdx;
+		bool natHit;
+		bool exception;
+	};
+
+	IPAModel();
+
+	Channel *FindChannel(const string &path);
+	Channel *FindChannel(int handle);
+	Channel *FindConsumer(enum ipa_client_type client);
+	void AddChannel(const string &path, enum ipa_client_type client,
+			bool toIpa, int index);
+
+	bool ParsePacket(const vector<uint8_t> &pkt, size_t ipOfst,
+			PacketInfo &info);
+	bool MatchAttrib(const struct ipa_rule_attrib &attrib,
+			const vector<uint8_t> &pkt, const PacketInfo &info);
+	bool CacheLookup(set<string> &cache, enum ipa_client_type src,
+			const PacketInfo &info);
+	const FltRule *LookupFilter(const Channel &prod,
+			const vector<uint8_t> &pkt, const PacketInfo &info,
+			Verdict &verdict);
+	const RtRule *LookupRoute(uint32_t rtTblHdl, const Channel &prod,
+			const vector<uint8_t> &pkt, const PacketInfo &info,
+			Verdict &verdict);
+	bool InsertHeader(const RtRule &rule, vector<uint8_t> &pkt);
+	void DecrementTtl(vector<uint8_t> &pkt, const PacketInfo &info);
+	void Deliver(const Channel &prod, vector<uint8_t> &pkt,
+			const Verdict &verdict);
+	void AddStatus(const Channel &prod, const Channel &cons,
+			vector<uint8_t> &pkt, const Verdict &verdict);
+
+	template <typename T>
+	bool AddRtRule(enum ipa_ip_type ip, const char *tableName, T &add);
+	template <typename T>
+	bool AddFltRule(enum ipa_ip_type ip, enum ipa_client_type ep, T &add);
+
+	static bool m_enabled;
+	static enum ipa_hw_type m_hwType;
+
+	uint32_t m_nextHdl;
+	map<string, Channel> m_channels;
+	map<int, string> m_handles;
+	int m_nextHandle;
+
+	/*[ip] -> table handle -> table*/
+	map<uint32_t, RtTable> m_rtTables[IPA_IP_MAX];
+	/*[ip] -> producer -> rules in lookup order*/
+	map<enum ipa_client_type, vector<FltRule> > m_fltTables[IPA_IP_MAX];
+	map<uint32_t, Header> m_headers;
+	map<uint32_t, ProcCtx> m_procCtxs;
+	uint32_t m_natExcRtTblHdl;
+
+	/*5-tuples that hit a hashable rule since the last commit*/
+	set<string> m_fltCache[IPA_IP_MAX];
+	set<string> m_rtCache[IPA_IP_MAX];
+
+	uint64_t m_rxPackets;
+	uint64_t m_txPackets;
+	uint64_t m_exceptions;
+	uint64_t m_drops;
+};
+
+#endif
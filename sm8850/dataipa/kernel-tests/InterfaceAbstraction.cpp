@@ -32,6 +32,7 @@
 #include <errno.h>
 #include <iostream>
 #include "InterfaceAbstraction.h"
+#include "IPAModel.h"
 
 #define MAX_OPEN_RETRY 10000
 
@@ -47,6 +48,24 @@ bool InterfaceAbstraction::Open(const char * toIPAPath, const char * fromIPAPath
 		exit(0);
 	}
 
+	/* the model nodes exist once configured, there is nothing to wait for */
+	if (IPAModel::IsEnabled()) {
+		m_toIPADescriptor = -1;
+		m_fromIPADescriptor = -1;
+		if (NULL != toIPAPath)
+			m_toIPADescriptor = IPAModel::GetInstance().Open(toIPAPath);
+		if (NULL != fromIPAPath)
+			m_fromIPADescriptor = IPAModel::GetInstance().Open(fromIPAPath);
+		if ((NULL != toIPAPath && -1 == m_toIPADescriptor) ||
+			(NULL != fromIPAPath && -1 == m_fromIPADescriptor)) {
+			printf("InterfaceAbstraction failed while opening model nodes.\n");
+			exit(0);
+		}
+		m_toChannelName = toIPAPath ? toIPAPath : "";
+		m_fromChannelName = fromIPAPath ? fromIPAPath : "";
+		return true;
+	}
+
 	if (NULL != toIPAPath) {
 		while (tries_cnt > 0) {
 			printf("trying to open %s %d/%d\n", toIPAPath, MAX_OPEN_RETRY - tries_cnt, MAX_OPEN_RETRY);
@@ -95,6 +114,12 @@ bool InterfaceAbstraction::Open(const char * toIPAPath, const char * fromIPAPath
 
 void InterfaceAbstraction::Close()
 {
+	if (IPAModel::IsEnabled()) {
+		IPAModel::GetInstance().Close(m_toIPADescriptor);
+		IPAModel::GetInstance().Close(m_fromIPADescriptor);
+		return;
+	}
+
 	close(m_toIPADescriptor);
 	close(m_fromIPADescriptor);
 }
@@ -105,7 +130,10 @@ long InterfaceAbstraction::SendData(unsigned char *buf, size_t size)
 
 	printf("Trying to write %zu bytes to %d.\n", size, m_toIPADescriptor);
 
-	bytesWritten = write(m_toIPADescriptor, buf, size);
+	if (IPAModel::IsEnabled())
+		bytesWritten = IPAModel::GetInstance().Write(m_toIPADescriptor, buf, size);
+	else
+		bytesWritten = write(m_toIPADescriptor, buf, size);
 	if (-1 == bytesWritten)
 	{
 		int err = errno;
@@ -137,7 +165,10 @@ int InterfaceAbstraction::ReceiveData(unsigned char *buf, size_t size)
 	{
 		printf("Trying to read %zu bytes from %d.\n", size, m_fromIPADescriptor);
 
-		bytesRead = read(m_fromIPADescriptor, (void*)buf, size);
+		if (IPAModel::IsEnabled())
+			bytesRead = IPAModel::GetInstance().Read(m_fromIPADescriptor, buf, size);
+		else
+			bytesRead = read(m_fromIPADescriptor, (void*)buf, size);
 		printf("Read %zu bytes.\n", bytesRead);
 		totalBytesRead += bytesRead;
 		if (bytesRead == size)
@@ -152,12 +183,18 @@ int InterfaceAbstraction::ReceiveData(unsigned char *buf, size_t size)
 int InterfaceAbstraction::ReceiveSingleDataChunk(unsigned char *buf, size_t size){
 	size_t bytesRead = 0;
 	printf("Trying to read %zu bytes from %d.\n", size, m_fromIPADescriptor);
-	bytesRead = read(m_fromIPADescriptor, (void*)buf, size);
+	if (IPAModel::IsEnabled())
+		bytesRead = IPAModel::GetInstance().Read(m_fromIPADescriptor, buf, size);
+	else
+		bytesRead = read(m_fromIPADescriptor, (void*)buf, size);
 	printf("Read %zu bytes.\n", bytesRead);
 	return bytesRead;
 }
 
 int InterfaceAbstraction::setReadNoBlock(){
+	/* model reads never block */
+	if (IPAModel::IsEnabled())
+		return 0;
 	int flags = fcntl(m_fromIPADescriptor, F_GETFL, 0);
 	if(flags == -1){
 		return -1;
@@ -166,6 +203,8 @@ int InterfaceAbstraction::setReadNoBlock(){
 }
 
 int InterfaceAbstraction::clearReadNoBlock(){
+	if (IPAModel::IsEnabled())
+		return 0;
 	int flags = fcntl(m_fromIPADescriptor, F_GETFL, 0);
 	if(flags == -1){
 		return -1;
@@ -175,9 +214,13 @@ int InterfaceAbstraction::clearReadNoBlock(){
 
 InterfaceAbstraction::~InterfaceAbstraction()
 {
-	close(m_fromIPADescriptor);
+	if (IPAModel::IsEnabled()) {
+		IPAModel::GetInstance().Close(m_fromIPADescriptor);
+		IPAModel::GetInstance().Close(m_toIPADescriptor);
+	} else {
+		close(m_fromIPADescriptor);
+		close(m_toIPADescriptor);
+	}
 	m_fromChannelName = "";
-
-	close(m_toIPADescriptor);
 	m_toChannelName = "";
 }
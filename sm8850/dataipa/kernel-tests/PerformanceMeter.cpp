@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the
+ * disclaimer below) provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *     * Neither the name of Qualcomm Innovation Center, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+ * GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include <algorithm>
+
+#include "PerformanceMeter.h"
+#include "Constants.h"
+#include "TestsUtils.h"
+#include "TestManager.h"
+
+/////////////////////////////////////////////////////////////////////////////////
+
+PerformanceMeter::PerformanceMeter(const string &testName, const string &mode,
+		size_t packetSize, int numRules)
+: m_testName(testName),
+  m_mode(mode),
+  m_packetSize(packetSize),
+  m_numRules(numRules),
+  m_startNs(0),
+  m_stopNs(0),
+  m_packets(0),
+  m_bytes(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+uint64_t PerformanceMeter::NowNs()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+void PerformanceMeter::Start()
+{
+	m_startNs = NowNs();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+void PerformanceMeter::Stop()
+{
+	m_stopNs = NowNs();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+void PerformanceMeter::AddLatency(uint64_t latencyNs)
+{
+	m_latenciesNs.push_back(latencyNs);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+void PerformanceMeter::AddTraffic(size_t packets, size_t bytes)
+{
+	m_packets += packets;
+	m_bytes += bytes;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+/*Nearest rank percentile, m_latenciesNs must already be sorted*/
+uint64_t PerformanceMeter::Percentile(unsigned int percent)
+{
+	size_t rank;
+
+	if (m_latenciesNs.empty())
+		return 0;
+
+	rank = (m_latenciesNs.size() * percent + 99) / 100;
+	if (rank > 0)
+		rank--;
+	return m_latenciesNs[rank];
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool PerformanceMeter::Report()
+{
+	double seconds = (double)(m_stopNs - m_startNs) / 1e9;
+	double pps;
+	double mbps;
+	uint64_t p50, p99, max;
+	FILE *pFile;
+
+	if (m_stopNs <= m_startNs || m_latenciesNs.empty()) {
+		LOG_MSG_ERROR("%s: nothing was measured", m_testName.c_str());
+		return false;
+	}
+
+	sort(m_latenciesNs.begin(), m_latenciesNs.end());
+	p50 = Percentile(50);
+	p99 = Percentile(99);
+	max = m_latenciesNs.back();
+	pps = m_packets / seconds;
+	mbps = m_bytes * 8 / seconds / 1e6;
+
+	printf("%s %s size %zu rules %d: %.0f pps, %.2f Mbps, "
+		"latency p50 %.1f us p99 %.1f us max %.1f us\n",
+		m_testName.c_str(), m_mode.c_str(), m_packetSize, m_numRules,
+		pps, mbps, p50 / 1e3, p99 / 1e3, max / 1e3);
+
+	pFile = fopen(PERF_REPORT_PATH_AND_NAME, "a");
+	if (!pFile) {
+		LOG_MSG_ERROR("Failed to open %s", PERF_REPORT_PATH_AND_NAME);
+		return false;
+	}
+	fprintf(pFile, "{\"test\":\"%s\",\"mode\":\"%s\",\"hw\":%d,"
+		"\"packet_size\":%zu,\"rules\":%d,\"packets\":%llu,"
+		"\"bytes\":%llu,\"seconds\":%.6f,\"pps\":%.1f,\"mbps\":%.3f,"
+		"\"samples\":%zu,\"p50_ns\":%llu,\"p99_ns\":%llu,"
+		"\"max_ns\":%llu}\n",
+		m_testName.c_str(), m_mode.c_str(),
+		TestManager::GetInstance()->GetIPAHwType(), m_packetSize,
+		m_numRules, (unsigned long long)m_packets,
+		(unsigned long long)m_bytes, seconds, pps, mbps,
+		m_latenciesNs.size(), (unsigned long long)p50,
+		(unsigned long long)p99, (unsigned long long)max);
+	fclose(pFile);
+
+	return true;
+}
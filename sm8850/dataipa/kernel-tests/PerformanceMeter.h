@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the
+ * disclaimer below) provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *     * Neither the name of Qualcomm Innovation Center, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+ * GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#ifndef _PERFORMANCE_METER_H_
+#define _PERFORMANCE_METER_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*This class collects the measurements of one performance run:
+ *the packets and bytes moved inside the Start()/Stop() window and
+ *one latency sample per transaction (a packet, or an aggregated
+ *frame). Report() prints a summary line and appends the results as one
+ *JSON object per line to PERF_REPORT_PATH_AND_NAME so they can be
+ *compared across builds and targets.
+ */
+class PerformanceMeter
+{
+public:
+	PerformanceMeter(const string &testName, const string &mode,
+			size_t packetSize, int numRules);
+
+	/*Monotonic time in nanoseconds*/
+	static uint64_t NowNs();
+
+	void Start();
+
+	void Stop();
+
+	void AddLatency(uint64_t latencyNs);
+
+	void AddTraffic(size_t packets, size_t bytes);
+
+	bool Report();
+
+private:
+	uint64_t Percentile(unsigned int percent);
+
+	string m_testName;
+	string m_mode;
+	size_t m_packetSize;
+	int m_numRules;
+	uint64_t m_startNs;
+	uint64_t m_stopNs;
+	uint64_t m_packets;
+	uint64_t m_bytes;
+	vector<uint64_t> m_latenciesNs;
+};
+
+#endif
@@ -0,0 +1,520 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the
+ * disclaimer below) provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *     * Neither the name of Qualcomm Innovation Center, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+ * GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdint.h>
+#include "hton.h" // for htonl
+#include "PipeTestFixture.h"
+#include "MBIMAggregationTestFixtureConf11.h"
+#include "RNDISAggregationTestFixture.h"
+#include "TLPAggregationTestFixture.h"
+#include "PerformanceMeter.h"
+#include "Constants.h"
+#include "TestsUtils.h"
+#include "linux/msm_ipa.h"
+
+#define IPV4_DST_ADDR_OFFSET (16)
+
+/*Measured rounds per packet size, after PERF_WARMUP_ROUNDS unmeasured ones*/
+#define PERF_ROUNDS 1000
+#define PERF_WARMUP_ROUNDS 10
+/*Packets in flight per round of the non aggregated tests*/
+#define PERF_BURST 8
+/*Largest frame an aggregated round may close: the byte limit, the
+ *packet which crossed it and the framing
+ */
+#define PERF_RX_BUFF_SIZE (4 * MAX_PACKET_SIZE)
+/*The bypass routing table the rules point to*/
+#define PERF_BYPASS_TABLE "PerfBypass"
+
+/*The default IP packet is padded up to each size, so none is smaller
+ *than it
+ */
+static const size_t aPipePacketSizes[] = { 64, 256, 512, 1024 };
+static const size_t aRoutedPacketSizes[] = { 128, 256, 512, 1024 };
+static const size_t aAggPacketSizes[] = { 128, 256, 512 };
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+/////////////////////////////////////////////////////////////////////////////////
+//							Performance scenarios                              //
+/////////////////////////////////////////////////////////////////////////////////
+
+class PerformanceScenarios {
+public:
+	//Load the default IPv4 packet towards 127.0.0.1 and pad it to nSize
+	static bool LoadPacket(enum ipa_ip_type eIP, Byte *pPacket, size_t nSize);
+	//Send PERF_BURST packets, then receive them back one by one, each
+	//latency sample is the time from a packet's send to its receive
+	static bool BurstTest(Pipe *input, Pipe *output, Byte *pPacket,
+			size_t nSize, PerformanceMeter &meter);
+	//Send packets until their framed size reaches nByteLimit and receive
+	//the aggregated frame this closes, each latency sample is the time from
+	//the first packet of the round to the frame
+	static bool AggregationTest(Pipe *input, Pipe *output, Byte *pPacket,
+			size_t nSize, size_t nPacketOverhead, size_t nFrameOverhead,
+			size_t nByteLimit, PerformanceMeter &meter);
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool PerformanceScenarios::LoadPacket(enum ipa_ip_type eIP, Byte *pPacket,
+		size_t nSize)
+{
+	size_t nLoaded = nSize;
+	uint32_t nIPv4DSTAddr;
+
+	if (!LoadDefaultPacket(eIP, pPacket, nLoaded)) {
+		LOG_MSG_ERROR("Failed to load the default packet");
+		return false;
+	}
+	if (IPA_IP_v4 == eIP) {
+		nIPv4DSTAddr = ntohl(0x7F000001);
+		memcpy(&pPacket[IPV4_DST_ADDR_OFFSET], &nIPv4DSTAddr,
+				sizeof(nIPv4DSTAddr));
+	}
+	for (size_t i = nLoaded; i < nSize; i++)
+		pPacket[i] = i & 0xFF;
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool PerformanceScenarios::BurstTest(Pipe *input, Pipe *output, Byte *pPacket,
+		size_t nSize, PerformanceMeter &meter)
+{
+	Byte pReceivedPacket[PERF_RX_BUFF_SIZE];
+	uint64_t aSentNs[PERF_BURST];
+	int nBytes;
+
+	for (int round = 0; round < PERF_WARMUP_ROUNDS + PERF_ROUNDS; round++) {
+		if (PERF_WARMUP_ROUNDS == round)
+			meter.Start();
+
+		for (int i = 0; i < PERF_BURST; i++) {
+			aSentNs[i] = PerformanceMeter::NowNs();
+			nBytes = input->Send(pPacket, nSize);
+			if (nSize != (size_t)nBytes) {
+				LOG_MSG_ERROR("Sending packet into the USB pipe(%zu bytes) "
+						"failed!", nSize);
+				return false;
+			}
+		}
+
+		for (int i = 0; i < PERF_BURST; i++) {
+			nBytes = output->Receive(pReceivedPacket,
+					sizeof(pReceivedPacket));
+			if (nSize != (size_t)nBytes) {
+				LOG_MSG_ERROR("Receiving packet from the USB pipe(%zu "
+						"bytes) failed, got %d!", nSize, nBytes);
+				return false;
+			}
+			if (round >= PERF_WARMUP_ROUNDS)
+				meter.AddLatency(PerformanceMeter::NowNs() - aSentNs[i]);
+		}
+
+		if (round >= PERF_WARMUP_ROUNDS)
+			meter.AddTraffic(PERF_BURST, PERF_BURST * nSize);
+	}
+	meter.Stop();
+
+	return meter.Report();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool PerformanceScenarios::AggregationTest(Pipe *input, Pipe *output,
+		Byte *pPacket, size_t nSize, size_t nPacketOverhead,
+		size_t nFrameOverhead, size_t nByteLimit, PerformanceMeter &meter)
+{
+	Byte pReceivedPacket[PERF_RX_BUFF_SIZE];
+	uint64_t nFirstSentNs;
+	size_t nFramed;
+	size_t nPackets;
+	int nBytes;
+
+	for (int round = 0; round < PERF_WARMUP_ROUNDS + PERF_ROUNDS; round++) {
+		if (PERF_WARMUP_ROUNDS == round)
+			meter.Start();
+
+		/*The framing overheads are lower bounds, so the H/W frame is
+		 *never smaller than nFramed and always reaches the limit
+		 */
+		nFirstSentNs = PerformanceMeter::NowNs();
+		nFramed = nFrameOverhead;
+		nPackets = 0;
+		while (nFramed < nByteLimit) {
+			nBytes = input->Send(pPacket, nSize);
+			if (nSize != (size_t)nBytes) {
+				LOG_MSG_ERROR("Sending packet into the USB pipe(%zu bytes) "
+						"failed!", nSize);
+				return false;
+			}
+			nFramed += nSize + nPacketOverhead;
+			nPackets++;
+		}
+
+		nBytes = output->Receive(pReceivedPacket, sizeof(pReceivedPacket));
+		if (nBytes <= 0) {
+			LOG_MSG_ERROR("Receiving aggregated packet from the USB pipe "
+					"failed!");
+			return false;
+		}
+
+		if (round >= PERF_WARMUP_ROUNDS) {
+			meter.AddLatency(PerformanceMeter::NowNs() - nFirstSentNs);
+			meter.AddTraffic(nPackets, nPackets * nSize);
+		}
+	}
+	meter.Stop();
+
+	return meter.Report();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+
+class PerfPipeDmaTest: public PipeTestFixture {
+public:
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	PerfPipeDmaTest()
+	{
+		m_name = "PerfPipeDmaTest";
+		m_description = "Performance - pps, throughput and latency of "
+				"raw bursts through a DMA mode pipe, per packet size";
+		m_testSuiteName.clear();
+		m_testSuiteName.push_back("Perf");
+		m_runInRegression = false;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	bool Run()
+	{
+		Byte pPacket[MAX_PACKET_SIZE];
+
+		for (size_t i = 0; i < ARRAY_SIZE(aPipePacketSizes); i++) {
+			PerformanceMeter meter(m_name, "dma", aPipePacketSizes[i], 0);
+
+			for (size_t j = 0; j < aPipePacketSizes[i]; j++)
+				pPacket[j] = j & 0xFF;
+			if (!PerformanceScenarios::BurstTest(&m_UsbToIpaPipe,
+					&m_IpaToUsbPipe, pPacket, aPipePacketSizes[i],
+					meter))
+				return false;
+		}
+
+		return true;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+
+class PerfRuleTableTest: public MBIMAggregationTestFixtureConf11 {
+public:
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	PerfRuleTableTest(uint8_t nNumRules) :
+		MBIMAggregationTestFixtureConf11(true),
+		m_nNumRules(nNumRules)
+	{
+		m_name = "PerfRuleTable" + to_string(nNumRules) + "Test";
+		m_description = "Performance - pps, throughput and latency of "
+				"routed bursts when only the last of " +
+				to_string(nNumRules) + " non hashable filtering rules "
+				"matches, per packet size";
+		m_testSuiteName.clear();
+		m_testSuiteName.push_back("Perf");
+		m_runInRegression = false;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	virtual bool AddRules()
+	{
+		IPAFilteringTable cFilterTable;
+		struct ipa_flt_rule_add sFilterRuleEntry;
+		uint32_t nTableHdl;
+
+		m_eIP = IPA_IP_v4;
+		if (!CreateBypassRoutingTable(&m_Routing, m_eIP, PERF_BYPASS_TABLE,
+				IPA_CLIENT_TEST3_CONS, 0, &nTableHdl)) {
+			LOG_MSG_ERROR("CreateBypassRoutingTable Failed\n");
+			return false;
+		}
+
+		cFilterTable.Init(m_eIP, IPA_CLIENT_TEST_PROD, false, m_nNumRules);
+		for (uint8_t i = 0; i < m_nNumRules; i++) {
+			memset(&sFilterRuleEntry, 0, sizeof(sFilterRuleEntry));
+			cFilterTable.GeneratePresetRule(1, sFilterRuleEntry);
+			sFilterRuleEntry.at_rear = true;
+			sFilterRuleEntry.flt_rule_hdl = -1; // return Value
+			sFilterRuleEntry.status = -1; // return value
+			sFilterRuleEntry.rule.action = IPA_PASS_TO_ROUTING;
+			sFilterRuleEntry.rule.rt_tbl_hdl = nTableHdl;
+			// keep the lookup off the hash table, so all rules are walked
+			sFilterRuleEntry.rule.hashable = 0;
+			sFilterRuleEntry.rule.attrib.attrib_mask = IPA_FLT_DST_ADDR;
+			if (m_nNumRules - 1 == i) {
+				sFilterRuleEntry.rule.attrib.u.v4.dst_addr_mask = 0xFF0000FF;
+				sFilterRuleEntry.rule.attrib.u.v4.dst_addr = 0x7F000001; // Filter DST_IP == 127.0.0.1.
+			} else {
+				sFilterRuleEntry.rule.attrib.u.v4.dst_addr_mask = 0xFFFFFFFF;
+				sFilterRuleEntry.rule.attrib.u.v4.dst_addr = 0x0A000001 + i; // Filter DST_IP == 10.0.x.y, never sent
+			}
+			if ((uint8_t)-1 == cFilterTable.AddRuleToTable(sFilterRuleEntry)) {
+				LOG_MSG_ERROR("Adding Rule (%d) to the table Failed.", i);
+				return false;
+			}
+		}
+
+		if (!m_Filtering.AddFilteringRule(cFilterTable.GetFilteringTable())) {
+			LOG_MSG_ERROR("Adding %d Rules to Filtering block Failed.",
+					m_nNumRules);
+			return false;
+		}
+
+		return true;
+	} // AddRules()
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	bool TestLogic()
+	{
+		Byte pPacket[MAX_PACKET_SIZE];
+
+		for (size_t i = 0; i < ARRAY_SIZE(aRoutedPacketSizes); i++) {
+			PerformanceMeter meter(m_name, "routing", aRoutedPacketSizes[i],
+					m_nNumRules);
+
+			if (!PerformanceScenarios::LoadPacket(m_eIP, pPacket,
+					aRoutedPacketSizes[i]))
+				return false;
+			if (!PerformanceScenarios::BurstTest(&m_UsbToIpaPipe,
+					&m_IpaToUsbPipe, pPacket, aRoutedPacketSizes[i],
+					meter))
+				return false;
+		}
+
+		return true;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+private:
+	uint8_t m_nNumRules;
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+
+class PerfMBIMAggregationTest: public MBIMAggregationTestFixtureConf11 {
+public:
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	PerfMBIMAggregationTest() :
+		MBIMAggregationTestFixtureConf11(true)
+	{
+		m_name = "PerfMBIMAggregationTest";
+		m_description = "Performance - pps, throughput and frame latency "
+				"of generic MBIM byte limit aggregation, per packet size";
+		m_testSuiteName.clear();
+		m_testSuiteName.push_back("Perf");
+		m_runInRegression = false;
+		// the IPA model does not aggregate
+		m_runOnModel = false;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	virtual bool AddRules()
+	{
+		return AddRules1HeaderAggregation();
+	} // AddRules()
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	bool TestLogic()
+	{
+		Byte pPacket[MAX_PACKET_SIZE];
+
+		for (size_t i = 0; i < ARRAY_SIZE(aAggPacketSizes); i++) {
+			PerformanceMeter meter(m_name, "mbim", aAggPacketSizes[i], 1);
+
+			if (!PerformanceScenarios::LoadPacket(m_eIP, pPacket,
+					aAggPacketSizes[i]))
+				return false;
+			//NTH16, NDP16 header and its null entry, then one entry
+			//per datagram
+			if (!PerformanceScenarios::AggregationTest(&m_UsbToIpaPipe,
+					&m_IpaToUsbPipeAgg, pPacket, aAggPacketSizes[i],
+					4, 24, MAX_PACKET_SIZE, meter))
+				return false;
+		}
+
+		return true;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+
+class PerfRNDISAggregationTest: public RNDISAggregationTestFixture {
+public:
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	PerfRNDISAggregationTest()
+	{
+		m_name = "PerfRNDISAggregationTest";
+		m_description = "Performance - pps, throughput and frame latency "
+				"of RNDIS byte limit aggregation, per packet size";
+		m_testSuiteName.clear();
+		m_testSuiteName.push_back("Perf");
+		m_runInRegression = false;
+		// the IPA model does not aggregate
+		m_runOnModel = false;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	virtual bool AddRules()
+	{
+		return AddRulesAggByteLimit();
+	} // AddRules()
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	bool TestLogic()
+	{
+		Byte pPacket[MAX_PACKET_SIZE];
+
+		for (size_t i = 0; i < ARRAY_SIZE(aAggPacketSizes); i++) {
+			PerformanceMeter meter(m_name, "rndis", aAggPacketSizes[i], 1);
+
+			if (!PerformanceScenarios::LoadPacket(m_eIP, pPacket,
+					aAggPacketSizes[i]))
+				return false;
+			if (!PerformanceScenarios::AggregationTest(&m_HsicToIpaPipe,
+					&m_IpaToUsbPipeAgg, pPacket, aAggPacketSizes[i],
+					sizeof(struct RndisEtherHeader), 0,
+					RNDISAggregationHelper::RNDIS_AGGREGATION_BYTE_LIMIT,
+					meter))
+				return false;
+		}
+
+		return true;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+
+class PerfTLPAggregationTest: public TLPAggregationTestFixture {
+public:
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	PerfTLPAggregationTest()
+	{
+		m_name = "PerfTLPAggregationTest";
+		m_description = "Performance - pps, throughput and frame latency "
+				"of TLP aggregation, per packet size";
+		m_testSuiteName.clear();
+		m_testSuiteName.push_back("Perf");
+		m_runInRegression = false;
+		// the IPA model does not aggregate
+		m_runOnModel = false;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	bool Run()
+	{
+		Byte pPacket[MAX_PACKET_SIZE];
+
+		for (size_t i = 0; i < ARRAY_SIZE(aAggPacketSizes); i++) {
+			PerformanceMeter meter(m_name, "tlp", aAggPacketSizes[i], 0);
+
+			for (size_t j = 0; j < aAggPacketSizes[i]; j++)
+				pPacket[j] = j & 0xFF;
+			//every packet is prefixed by its 2 bytes length
+			if (!PerformanceScenarios::AggregationTest(&m_UsbNoAggToIpaPipeAgg,
+					&m_IpaToUsbPipeAggr, pPacket, aAggPacketSizes[i],
+					2, 0, MAX_PACKET_SIZE, meter))
+				return false;
+		}
+
+		return true;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+
+static PerfPipeDmaTest perfPipeDmaTest;
+static PerfRuleTableTest perfRuleTable1Test(1);
+static PerfRuleTableTest perfRuleTable8Test(8);
+static PerfRuleTableTest perfRuleTable32Test(32);
+static PerfRuleTableTest perfRuleTable128Test(128);
+static PerfMBIMAggregationTest perfMbimAggregationTest;
+static PerfRNDISAggregationTest perfRndisAggregationTest;
+static PerfTLPAggregationTest perfTlpAggregationTest;
+
+/////////////////////////////////////////////////////////////////////////////////
+//                                  EOF                                      ////
+/////////////////////////////////////////////////////////////////////////////////
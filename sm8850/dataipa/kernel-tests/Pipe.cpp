@@ -29,6 +29,7 @@
 
 #include "Pipe.h"
 #include "TestsUtils.h"
+#include "IPAModel.h"
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 //Do not change those default values due to the fact that some test may relay on those default values.
@@ -72,7 +73,12 @@ bool Pipe::Init() {
 	int tries_cnt = 1;
 	SetSpecificClientParameters(m_nClientType, m_eConfiguration);
 	//By examining the Client type we will map the inode device name
-	while (tries_cnt <= 10000) {
+	//The model learns the node of an old fashion configuration from the pipe
+	if (IPAModel::IsEnabled())
+		m_Fd = IPAModel::GetInstance().Open(m_pInodePath,
+			m_ExceptionPipe ? IPA_CLIENT_APPS_LAN_CONS : m_nClientType,
+			m_nHeaderLengthAdd);
+	while (!IPAModel::IsEnabled() && tries_cnt <= 10000) {
 		m_Fd = open(m_pInodePath, O_RDWR);
 		if (-1 != m_Fd)
 			break;
@@ -97,7 +103,10 @@ void Pipe::Destroy() {
 		LOG_MSG_ERROR("Pipe is being used without being initialized!");
 		return;
 	}
-	close(m_Fd);
+	if (IPAModel::IsEnabled())
+		IPAModel::GetInstance().Close(m_Fd);
+	else
+		close(m_Fd);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -108,7 +117,10 @@ int Pipe::Send(unsigned char * pBuffer, size_t nBytesToSend) {
 		return 0;
 	}
 	size_t nBytesWritten = 0;
-	nBytesWritten = write(m_Fd, pBuffer, nBytesToSend);
+	if (IPAModel::IsEnabled())
+		nBytesWritten = IPAModel::GetInstance().Write(m_Fd, pBuffer, nBytesToSend);
+	else
+		nBytesWritten = write(m_Fd, pBuffer, nBytesToSend);
 	return nBytesWritten;
 }
 
@@ -149,7 +161,10 @@ int Pipe::Receive(unsigned char *pBuffer, size_t nBytesToReceive) {
 		return 0;
 	}
 	size_t nBytesRead = 0;
-	nBytesRead = read(m_Fd, (void*) pBuffer, nBytesToReceive);
+	if (IPAModel::IsEnabled())
+		nBytesRead = IPAModel::GetInstance().Read(m_Fd, pBuffer, nBytesToReceive);
+	else
+		nBytesRead = read(m_Fd, (void*) pBuffer, nBytesToReceive);
 	return nBytesRead;
 }
 
@@ -68,6 +68,7 @@
 
 #include "RoutingDriverWrapper.h"
 #include "TestsUtils.h"
+#include "IPAModel.h"
 
 bool RoutingDriverWrapper::AddRoutingRule(struct ipa_ioc_add_rt_rule *ruleTable)
 {
@@ -76,6 +77,9 @@ bool RoutingDriverWrapper::AddRoutingRule(struct ipa_ioc_add_rt_rule *ruleTable)
 	if (!DeviceNodeIsOpened())
 		return false;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().AddRoutingRule(ruleTable);
+
 	retval = ioctl(m_fd, IPA_IOC_ADD_RT_RULE, ruleTable);
 	if (retval) {
 		printf("%s(), failed adding routing rule table %p\n", __FUNCTION__, ruleTable);
@@ -93,6 +97,9 @@ bool RoutingDriverWrapper::AddRoutingRule(struct ipa_ioc_add_rt_rule_v2 *ruleTab
 	if (!DeviceNodeIsOpened())
 		return false;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().AddRoutingRule(ruleTable_v2);
+
 	retval = ioctl(m_fd, IPA_IOC_ADD_RT_RULE_V2, ruleTable_v2);
 	if (retval) {
 		printf("%s(), failed adding routing rule table %p\n", __FUNCTION__, ruleTable_v2);
@@ -110,6 +117,9 @@ bool RoutingDriverWrapper::DeleteRoutingRule(struct ipa_ioc_del_rt_rule *ruleTab
 	if (!DeviceNodeIsOpened())
 		return false;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().DeleteRoutingRule(ruleTable);
+
 	retval = ioctl(m_fd, IPA_IOC_DEL_RT_RULE, ruleTable);
 	if (retval) {
 		printf("%s(), failed deleting routing rule table %p\n", __FUNCTION__, ruleTable);
@@ -127,6 +137,9 @@ bool RoutingDriverWrapper::Commit(enum ipa_ip_type ip)
 	if (!DeviceNodeIsOpened())
 		return false;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().CommitRouting(ip);
+
 	retval = ioctl(m_fd, IPA_IOC_COMMIT_RT, ip);
 	if (retval) {
 		printf("%s(), failed commiting routing rules.\n", __FUNCTION__);
@@ -144,6 +157,9 @@ bool RoutingDriverWrapper::Reset(enum ipa_ip_type ip)
 	if (!DeviceNodeIsOpened())
 		return false;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().ResetRouting(ip);
+
 	retval = ioctl(m_fd, IPA_IOC_RESET_RT, ip);
 	retval |= ioctl(m_fd, IPA_IOC_COMMIT_RT, ip);
 	if (retval) {
@@ -162,6 +178,9 @@ bool RoutingDriverWrapper::GetRoutingTable(struct ipa_ioc_get_rt_tbl *routingTab
 	if (!DeviceNodeIsOpened())
 		return false;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().GetRoutingTable(routingTable);
+
 	retval = ioctl(m_fd, IPA_IOC_GET_RT_TBL, routingTable);
 	if (retval) {
 		printf("%s(), IPA_IOCTL_GET_RT_TBL ioctl failed, routingTable =0x%p, retval=0x%x.\n", __FUNCTION__, routingTable, retval);
@@ -179,6 +198,9 @@ bool RoutingDriverWrapper::PutRoutingTable(uint32_t routingTableHandle)
 	if (!DeviceNodeIsOpened())
 		return false;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().PutRoutingTable(routingTableHandle);
+
 	retval = ioctl(m_fd, IPA_IOC_PUT_RT_TBL, routingTableHandle);
 	if (retval) {
 		printf("%s(), IPA_IOCTL_PUT_RT_TBL ioctl failed.\n", __FUNCTION__);
@@ -196,6 +218,10 @@ bool RoutingDriverWrapper::SetNatConntrackExcRoutingTable(uint32_t routingTableH
 	if (!DeviceNodeIsOpened())
 		return false;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().SetExceptionRoutingTable(routingTableHandle,
+			nat_or_conntrack);
+
 	if (nat_or_conntrack)
 		retval = ioctl(m_fd, IPA_IOC_SET_NAT_EXC_RT_TBL_IDX, routingTableHandle);
 	else
@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the
+ * disclaimer below) provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *     * Neither the name of Qualcomm Innovation Center, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+ * GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <atomic>
+#include "RoutingDriverWrapper.h"
+#include "HeaderInsertion.h"
+#include "PerformanceMeter.h"
+#include "IPAModel.h"
+#include "TestsUtils.h"
+#include "linux/msm_ipa.h"
+
+/*Measured operations of the thread under test, alone and contended*/
+#define CONTENTION_OPS 500
+/*The header every header churn operation adds and deletes*/
+#define CONTENTION_HDR_LEN 14
+
+/*What the second thread churns while the thread under test keeps adding
+ *and deleting one IPv4 routing rule
+ */
+enum ContentionPeer {
+	CONTEND_RT_V4,	/*the same database: expected to serialize*/
+	CONTEND_RT_V6,	/*the other IP family's routing database*/
+	CONTEND_HDR,	/*the header database*/
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+//							Rule churn operations                              //
+/////////////////////////////////////////////////////////////////////////////////
+
+class RuleChurn {
+public:
+	//Add one rule to sTable and delete it, both committed, so each
+	//call takes the family's routing database lock twice
+	static bool Routing(RoutingDriverWrapper &routing, enum ipa_ip_type eIP,
+			const char *sTable);
+	//Add one header and delete it, both committed
+	static bool Header(HeaderInsertion &header, const char *sName);
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool RuleChurn::Routing(RoutingDriverWrapper &routing, enum ipa_ip_type eIP,
+		const char *sTable)
+{
+	struct ipa_ioc_add_rt_rule *pAdd;
+	struct ipa_ioc_del_rt_rule *pDel;
+	bool bRetVal = false;
+
+	pAdd = (struct ipa_ioc_add_rt_rule *)calloc(1,
+			sizeof(struct ipa_ioc_add_rt_rule) +
+			sizeof(struct ipa_rt_rule_add));
+	pDel = (struct ipa_ioc_del_rt_rule *)calloc(1,
+			sizeof(struct ipa_ioc_del_rt_rule) +
+			sizeof(struct ipa_rt_rule_del));
+	if (!pAdd || !pDel) {
+		LOG_MSG_ERROR("calloc failed to allocate the rule descriptors");
+		goto bail;
+	}
+
+	pAdd->commit = 1;
+	pAdd->ip = eIP;
+	pAdd->num_rules = 1;
+	strlcpy(pAdd->rt_tbl_name, sTable, sizeof(pAdd->rt_tbl_name));
+	pAdd->rules[0].at_rear = 1;
+	pAdd->rules[0].rule.dst = IPA_CLIENT_APPS_LAN_CONS;
+	if (IPA_IP_v4 == eIP) {
+		pAdd->rules[0].rule.attrib.attrib_mask = IPA_FLT_DST_ADDR;
+		pAdd->rules[0].rule.attrib.u.v4.dst_addr = 0x0A000001;
+		pAdd->rules[0].rule.attrib.u.v4.dst_addr_mask = 0xFFFFFFFF;
+	}
+	if (!routing.AddRoutingRule(pAdd) || pAdd->rules[0].status) {
+		LOG_MSG_ERROR("Adding a rule to %s failed", sTable);
+		goto bail;
+	}
+
+	pDel->commit = 1;
+	pDel->ip = eIP;
+	pDel->num_hdls = 1;
+	pDel->hdl[0].hdl = pAdd->rules[0].rt_rule_hdl;
+	if (!routing.DeleteRoutingRule(pDel) || pDel->hdl[0].status) {
+		LOG_MSG_ERROR("Deleting rule 0x%x of %s failed",
+				pAdd->rules[0].rt_rule_hdl, sTable);
+		goto bail;
+	}
+
+	bRetVal = true;
+bail:
+	free(pAdd);
+	free(pDel);
+	return bRetVal;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+bool RuleChurn::Header(HeaderInsertion &header, const char *sName)
+{
+	struct ipa_ioc_add_hdr *pAdd;
+	struct ipa_ioc_del_hdr *pDel;
+	bool bRetVal = false;
+
+	pAdd = (struct ipa_ioc_add_hdr *)calloc(1,
+			sizeof(struct ipa_ioc_add_hdr) + sizeof(struct ipa_hdr_add));
+	pDel = (struct ipa_ioc_del_hdr *)calloc(1,
+			sizeof(struct ipa_ioc_del_hdr) + sizeof(struct ipa_hdr_del));
+	if (!pAdd || !pDel) {
+		LOG_MSG_ERROR("calloc failed to allocate the header descriptors");
+		goto bail;
+	}
+
+	pAdd->commit = 1;
+	pAdd->num_hdrs = 1;
+	strlcpy(pAdd->hdr[0].name, sName, sizeof(pAdd->hdr[0].name));
+	for (int i = 0; i < CONTENTION_HDR_LEN; i++)
+		pAdd->hdr[0].hdr[i] = i;
+	pAdd->hdr[0].hdr_len = CONTENTION_HDR_LEN;
+	if (!header.AddHeader(pAdd) || pAdd->hdr[0].status) {
+		LOG_MSG_ERROR("Adding header %s failed", sName);
+		goto bail;
+	}
+
+	pDel->commit = 1;
+	pDel->num_hdls = 1;
+	pDel->hdl[0].hdl = pAdd->hdr[0].hdr_hdl;
+	if (!header.DeleteHeader(pDel) || pDel->hdl[0].status) {
+		LOG_MSG_ERROR("Deleting header %s failed", sName);
+		goto bail;
+	}
+
+	bRetVal = true;
+bail:
+	free(pAdd);
+	free(pDel);
+	return bRetVal;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//							Contention tests                                   //
+/////////////////////////////////////////////////////////////////////////////////
+
+/*Every thread opens its own instance of the device node, as separate
+ *clients of the driver would
+ */
+class RuleContentionTest: public TestBase {
+public:
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	RuleContentionTest(enum ContentionPeer ePeer) :
+		m_ePeer(ePeer),
+		m_bStop(false),
+		m_bPeerFailed(false),
+		m_nPeerOps(0)
+	{
+		m_name = "RuleContentionVs" + PeerName() + "Test";
+		m_description = "Stress - latency and rate of IPv4 routing rule "
+				"add/delete commits, alone and while another thread "
+				"churns the " + PeerName() + " database";
+		m_testSuiteName.clear();
+		m_testSuiteName.push_back("Stress");
+		m_runInRegression = false;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	bool Setup()
+	{
+		if (!m_Routing.DeviceNodeIsOpened() ||
+				!m_PeerRouting.DeviceNodeIsOpened() ||
+				!m_PeerHeader.DeviceNodeIsOpened()) {
+			LOG_MSG_ERROR("Failed opening the driver device nodes");
+			return false;
+		}
+
+		return true;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	bool Run()
+	{
+		pthread_t peer;
+
+		//the model is not thread safe and has no driver locks to
+		//contend on
+		if (IPAModel::IsEnabled()) {
+			LOG_MSG_INFO("%s needs the device, skipped", m_name.c_str());
+			return true;
+		}
+
+		if (!Measure("alone"))
+			return false;
+
+		m_bStop = false;
+		if (pthread_create(&peer, NULL, PeerThread, this)) {
+			LOG_MSG_ERROR("Failed to start the peer thread");
+			return false;
+		}
+		bool bRetVal = Measure("vs_" + PeerName());
+		m_bStop = true;
+		pthread_join(peer, NULL);
+
+		if (m_bPeerFailed) {
+			LOG_MSG_ERROR("The peer thread failed after %zu operations",
+					m_nPeerOps.load());
+			return false;
+		}
+		LOG_MSG_INFO("The peer thread completed %zu operations",
+				m_nPeerOps.load());
+
+		return bRetVal;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+private:
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	string PeerName()
+	{
+		switch (m_ePeer) {
+		case CONTEND_RT_V4:
+			return "RtV4";
+		case CONTEND_RT_V6:
+			return "RtV6";
+		default:
+			return "Hdr";
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	bool Measure(const string &sMode)
+	{
+		PerformanceMeter meter(m_name, sMode, 0, 1);
+		uint64_t nStartNs;
+
+		meter.Start();
+		for (int i = 0; i < CONTENTION_OPS; i++) {
+			nStartNs = PerformanceMeter::NowNs();
+			if (!RuleChurn::Routing(m_Routing, IPA_IP_v4, "ContentionV4"))
+				return false;
+			meter.AddLatency(PerformanceMeter::NowNs() - nStartNs);
+			meter.AddTraffic(1, 0);
+		}
+		meter.Stop();
+
+		return meter.Report();
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	static void *PeerThread(void *pArg)
+	{
+		RuleContentionTest *pTest = (RuleContentionTest *)pArg;
+		bool bOk;
+
+		while (!pTest->m_bStop) {
+			switch (pTest->m_ePeer) {
+			case CONTEND_RT_V4:
+				bOk = RuleChurn::Routing(pTest->m_PeerRouting, IPA_IP_v4,
+						"ContentionPeerV4");
+				break;
+			case CONTEND_RT_V6:
+				bOk = RuleChurn::Routing(pTest->m_PeerRouting, IPA_IP_v6,
+						"ContentionPeerV6");
+				break;
+			default:
+				bOk = RuleChurn::Header(pTest->m_PeerHeader,
+						"ContentionPeerHdr");
+				break;
+			}
+			if (!bOk) {
+				pTest->m_bPeerFailed = true;
+				break;
+			}
+			pTest->m_nPeerOps++;
+		}
+
+		return NULL;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	enum ContentionPeer m_ePeer;
+	RoutingDriverWrapper m_Routing;
+	RoutingDriverWrapper m_PeerRouting;
+	HeaderInsertion m_PeerHeader;
+	std::atomic<bool> m_bStop;
+	std::atomic<bool> m_bPeerFailed;
+	std::atomic<size_t> m_nPeerOps;
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+
+static RuleContentionTest ruleContentionVsRtV4Test(CONTEND_RT_V4);
+static RuleContentionTest ruleContentionVsRtV6Test(CONTEND_RT_V6);
+static RuleContentionTest ruleContentionVsHdrTest(CONTEND_HDR);
+
+/////////////////////////////////////////////////////////////////////////////////
+//                                  EOF                                      ////
+/////////////////////////////////////////////////////////////////////////////////
@@ -35,6 +35,7 @@
 
 TestBase::TestBase() :
 		m_runInRegression(true),
+		m_runOnModel(true),
 		m_minIPAHwType(IPA_HW_v1_1),
 		m_maxIPAHwType(IPA_HW_MAX)
 {
@@ -66,6 +66,8 @@ public:
 	/* Every test can belong to multiple test suites */
 	bool m_runInRegression;
 	/* Should this test be run in a regression test ? (Default is yes) */
+	bool m_runOnModel;
+	/* Can this test run against the IPA model ? (Default is yes) */
 	int m_minIPAHwType;
 	/* The minimal IPA HW version which this test can run on */
 	int m_maxIPAHwType;
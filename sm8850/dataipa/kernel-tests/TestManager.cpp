@@ -36,6 +36,7 @@
 #include <sstream>
 #include "TestManager.h"
 #include "TestsUtils.h"
+#include "IPAModel.h"
 #include <fcntl.h>
 #include <unistd.h>
 #include "ipa_test_module.h"
@@ -262,10 +263,17 @@ bool TestManager::Run(vector<string> testSuiteList, vector<string> testNameList)
 
 		// Run the test only if it's applicable to the current IPA HW type / version
 		if (runTest) {
-			if (!(m_IPAHwType >= test->m_minIPAHwType && m_IPAHwType <= test->m_maxIPAHwType))
+			if (!(GetIPAHwType() >= test->m_minIPAHwType && GetIPAHwType() <= test->m_maxIPAHwType))
 				runTest = false;
 		}
 
+		// Leave out the tests relying on what the IPA model does not cover
+		if (runTest && IPAModel::IsEnabled() && !test->m_runOnModel) {
+			printf("\n\nSkipping test %s, not covered by the IPA model\n",
+				test->m_name.c_str());
+			runTest = false;
+		}
+
 		if (!runTest)
 			continue;
 
@@ -368,10 +376,27 @@ void TestManager::PrintRegisteredTests()
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+enum ipa_hw_type TestManager::GetIPAHwType()
+{
+	// --model is parsed after the tests registered, and fetched the H/W type
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().GetHwType();
+
+	return m_IPAHwType;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 void TestManager::FetchIPAHwType()
 {
 	int fd;
 
+	if (IPAModel::IsEnabled()) {
+		m_IPAHwType = IPAModel::GetInstance().GetHwType();
+		printf("%s(), IPA model HW type (version) = %d\n", __FUNCTION__, m_IPAHwType);
+		return;
+	}
+
 	// Open ipa_test device node
 	fd = open("/dev/ipa_test" , O_RDONLY);
 	if (fd < 0) {
@@ -77,7 +77,7 @@ public:
 	vector < TestBase * > m_testList;
 	/* Holds pointers to all of the tests in the system */
 
-	enum ipa_hw_type GetIPAHwType() {return m_IPAHwType;}
+	enum ipa_hw_type GetIPAHwType();
 	const char* GetMemType() { return m_nat_mem_type_ptr; }
 
 private:
@@ -74,6 +74,7 @@
 #include "InterfaceAbstraction.h"
 #include "Constants.h"
 #include "Pipe.h"
+#include "IPAModel.h"
 
 using namespace std;
 ///////////////////////////////////////////////////////////////////////////////
@@ -815,6 +816,13 @@ void ConfigureScenario(int testConfiguration, const char* params)
 	char str[10];
 	int currentConf;
 
+	// The model learns the nodes of an old fashion configuration from the
+	// pipes opening them, start over from the exception node.
+	if (IPAModel::IsEnabled()) {
+		IPAModel::GetInstance().Clean();
+		return;
+	}
+
 	// Open /dev/ipa_test device node. This will allow to configure the system
 	// and read its current configuration.
 	fd = open(CONFIGURATION_NODE_PATH, O_RDWR);
@@ -1031,6 +1039,9 @@ int GenericConfigureScenario(struct ipa_test_config_header *header, bool isUlso)
 	int fd;
 	int retval;
 
+	if (IPAModel::IsEnabled())
+		return IPAModel::GetInstance().Configure(header);
+
 	if (is_reconfigure_required(header) == false) {
 		g_Logger.AddMessage(LOG_DEVELOPMENT , "No need to reconfigure, we are all good :)\n");
 		return true;
@@ -1130,6 +1141,11 @@ int GenericConfigureScenarioDestory(void)
 
 	g_Logger.AddMessage(LOG_DEVELOPMENT, "cleanup started\n");
 
+	if (IPAModel::IsEnabled()) {
+		IPAModel::GetInstance().Clean();
+		return true;
+	}
+
 	fd = open(CONFIGURATION_NODE_PATH,  O_RDWR);
 	if (fd == -1) {
 		g_Logger.AddMessage(LOG_ERROR,
@@ -1160,6 +1176,11 @@ bool configure_ep_ctrl(struct ipa_test_ep_ctrl *ep_ctrl)
 
 	g_Logger.AddMessage(LOG_DEVELOPMENT, "ep ctrl started \n");
 
+	if (IPAModel::IsEnabled()) {
+		g_Logger.AddMessage(LOG_ERROR, "ep suspend/delay is not modelled\n");
+		return false;
+	}
+
 	fd = open(CONFIGURATION_NODE_PATH,  O_RDWR);
 	if (fd == -1) {
 		g_Logger.AddMessage(LOG_ERROR,
@@ -1194,6 +1215,10 @@ bool configure_holb(struct ipa_test_holb_config *test_holb_config)
 		return false;
 	}
 
+	// The model queues every packet, there is no HOLB to configure
+	if (IPAModel::IsEnabled())
+		return true;
+
 	fd = open(CONFIGURATION_NODE_PATH,  O_RDWR);
 	if (fd == -1) {
 		g_Logger.AddMessage(LOG_ERROR,
@@ -1366,6 +1391,11 @@ bool RegSuspendHandler(bool deferred_flag, bool reg, int DevNum)
 	int retval = 0;
 	struct ipa_test_reg_suspend_handler RegData;
 
+	if (IPAModel::IsEnabled()) {
+		g_Logger.AddMessage(LOG_ERROR, "suspend interrupts are not modelled\n");
+		return false;
+	}
+
 	fd = open(CONFIGURATION_NODE_PATH,  O_RDWR);
 	if (fd == -1) {
 		g_Logger.AddMessage(LOG_ERROR,
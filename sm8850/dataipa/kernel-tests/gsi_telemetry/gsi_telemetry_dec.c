@@ -0,0 +1,284 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gsi_telemetry_dec.h"
+
+int gsi_tlm_parse(const void *buf, size_t len, struct gsi_tlm_snap *snap)
+{
+	const unsigned char *p = buf;
+	size_t rec_len;
+	int i;
+
+	memset(snap, 0, sizeof(*snap));
+	if (len < sizeof(snap->hdr))
+		return -EINVAL;
+
+	memcpy(&snap->hdr, p, sizeof(snap->hdr));
+	if (snap->hdr.magic != GSI_TLM_MAGIC || snap->hdr.version < 1 ||
+		snap->hdr.hdr_size < sizeof(snap->hdr) ||
+		snap->hdr.rec_size < offsetof(struct gsi_tlm_chan, queued))
+		return -EINVAL;
+	if (len < snap->hdr.hdr_size +
+		(size_t)snap->hdr.num_chan * snap->hdr.rec_size)
+		return -EINVAL;
+
+	snap->chan = calloc(snap->hdr.num_chan ? snap->hdr.num_chan : 1,
+		sizeof(*snap->chan));
+	if (!snap->chan)
+		return -ENOMEM;
+
+	rec_len = snap->hdr.rec_size < sizeof(*snap->chan) ?
+		snap->hdr.rec_size : sizeof(*snap->chan);
+	p += snap->hdr.hdr_size;
+	for (i = 0; i < snap->hdr.num_chan; i++, p += snap->hdr.rec_size)
+		memcpy(&snap->chan[i], p, rec_len);
+
+	return 0;
+}
+
+void gsi_tlm_free(struct gsi_tlm_snap *snap)
+{
+	free(snap->chan);
+	snap->chan = NULL;
+}
+
+static void sub_hist(__u32 *hist, const __u32 *old, int num_buckets)
+{
+	int i;
+
+	for (i = 0; i < num_buckets; i++)
+		if (hist[i] >= old[i])
+			hist[i] -= old[i];
+}
+
+void gsi_tlm_sub(struct gsi_tlm_snap *snap, const struct gsi_tlm_snap *old)
+{
+	struct gsi_tlm_chan *c;
+	const struct gsi_tlm_chan *o;
+	int i, j;
+
+	for (i = 0; i < snap->hdr.num_chan; i++) {
+		c = &snap->chan[i];
+		o = NULL;
+		for (j = 0; j < old->hdr.num_chan; j++)
+			if (old->chan[j].ch_id == c->ch_id)
+				o = &old->chan[j];
+		if (!o)
+			continue;
+		/*
+		 * rst_stats clears the whole record, a snapshot taken after it
+		 * is already the difference from the reset
+		 */
+		if (c->queued < o->queued || c->doorbells < o->doorbells)
+			continue;
+
+#define SUB_FIELD(f) \
+	do { \
+		if (c->f >= o->f) \
+			c->f -= o->f; \
+	} while (0)
+
+		SUB_FIELD(queued);
+		SUB_FIELD(completed);
+		SUB_FIELD(doorbells);
+		SUB_FIELD(irq_events);
+		SUB_FIELD(poll_events);
+		SUB_FIELD(poll_ok);
+		SUB_FIELD(poll_empty);
+		SUB_FIELD(callback_to_poll);
+		SUB_FIELD(poll_to_callback);
+		SUB_FIELD(evt_doorbells);
+		SUB_FIELD(evt_irq_passes);
+#undef SUB_FIELD
+
+		sub_hist(c->lat_hist, o->lat_hist, GSI_TLM_LAT_BUCKETS);
+		sub_hist(c->occ_hist, o->occ_hist, GSI_TLM_OCC_BUCKETS);
+		sub_hist(c->poll_batch_hist, o->poll_batch_hist,
+			GSI_TLM_BATCH_BUCKETS);
+		sub_hist(c->irq_batch_hist, o->irq_batch_hist,
+			GSI_TLM_BATCH_BUCKETS);
+	}
+}
+
+static unsigned long long bucket_max(int b, int num_buckets)
+{
+	if (b == num_buckets - 1)
+		return UINT64_MAX;
+
+	return b ? (1ULL << b) - 1 : 0;
+}
+
+static unsigned long long hist_total(const __u32 *hist, int num_buckets)
+{
+	unsigned long long total = 0;
+	int i;
+
+	for (i = 0; i < num_buckets; i++)
+		total += hist[i];
+
+	return total;
+}
+
+unsigned long long gsi_tlm_percentile(const __u32 *hist, int num_buckets,
+	unsigned int percent)
+{
+	unsigned long long total = hist_total(hist, num_buckets);
+	unsigned long long target, sum = 0;
+	int i;
+
+	if (!total)
+		return 0;
+
+	target = (total * percent + 99) / 100;
+	for (i = 0; i < num_buckets; i++) {
+		sum += hist[i];
+		if (sum >= target)
+			return bucket_max(i, num_buckets);
+	}
+
+	return bucket_max(num_buckets - 1, num_buckets);
+}
+
+static const char *fmt_count(char *buf, size_t len, unsigned long long val)
+{
+	if (val == UINT64_MAX)
+		snprintf(buf, len, "inf");
+	else
+		snprintf(buf, len, "%llu", val);
+
+	return buf;
+}
+
+/* Upper bound of a latency bucket, in the units a human reads it in */
+static const char *fmt_lat(char *buf, size_t len, unsigned long long val)
+{
+	unsigned long long ns;
+
+	if (val == UINT64_MAX)
+		return fmt_count(buf, len, val);
+
+	ns = (val + 1) << GSI_TLM_LAT_UNIT_SHIFT;
+	if (ns < 10000ULL)
+		snprintf(buf, len, "%lluns", ns);
+	else if (ns < 10000000ULL)
+		snprintf(buf, len, "%lluus", ns / 1000);
+	else if (ns < 10000000000ULL)
+		snprintf(buf, len, "%llums", ns / 1000000);
+	else
+		snprintf(buf, len, "%llus", ns / 1000000000);
+
+	return buf;
+}
+
+static unsigned int ratio(unsigned long long part, unsigned long long total)
+{
+	return total ? (unsigned int)(100 * part / total) : 0;
+}
+
+static void print_hist(const char *name, const __u32 *hist, int num_buckets,
+	int is_lat, FILE *out)
+{
+	char lo[16], hi[16];
+	int i;
+
+	if (!hist_total(hist, num_buckets))
+		return;
+
+	fprintf(out, "    %s:\n", name);
+	for (i = 0; i < num_buckets; i++) {
+		if (!hist[i])
+			continue;
+		/* latency buckets print as [lo, hi), the others as [lo, hi] */
+		if (is_lat) {
+			if (i)
+				fmt_lat(lo, sizeof(lo), bucket_max(i - 1,
+					num_buckets));
+			else
+				snprintf(lo, sizeof(lo), "0");
+			fmt_lat(hi, sizeof(hi), bucket_max(i, num_buckets));
+			fprintf(out, "      %8s .. %-8s %u\n", lo, hi, hist[i]);
+		} else {
+			fmt_count(lo, sizeof(lo), i ? 1ULL << (i - 1) : 0);
+			fmt_count(hi, sizeof(hi), bucket_max(i, num_buckets));
+			fprintf(out, "      %8s .. %-8s %u\n", lo, hi, hist[i]);
+		}
+	}
+}
+
+static void print_chan(const struct gsi_tlm_chan *c, int verbose,
+	int lat_on, FILE *out)
+{
+	unsigned long long events = c->irq_events + c->poll_events;
+	unsigned long long polls = c->poll_ok + c->poll_empty;
+	char p50[16], p99[16];
+
+	fprintf(out, "ch %2u ev %3u %-8s %-8s%s ring %u\n", c->ch_id, c->evt_id,
+		c->flags & GSI_TLM_CH_FROM_GSI ? "from_gsi" : "to_gsi",
+		c->flags & GSI_TLM_CH_POLL_MODE ? "poll" : "callback",
+		c->flags & GSI_TLM_CH_GCI ? " gci" : "", c->ring_elems);
+	fprintf(out, "  tre queued %llu completed %llu doorbells %llu",
+		c->queued, c->completed, c->doorbells);
+	if (c->doorbells)
+		fprintf(out, " (%.1f tre/db)",
+			(double)c->queued / (double)c->doorbells);
+	fprintf(out, "\n");
+	fprintf(out, "  events irq %llu poll %llu (%u%% irq) polls ok %llu empty %llu (%u%% empty)\n",
+		c->irq_events, c->poll_events, ratio(c->irq_events, events),
+		c->poll_ok, c->poll_empty, ratio(c->poll_empty, polls));
+	fprintf(out, "  mode cb->poll %llu poll->cb %llu evt doorbells %llu irq passes %llu\n",
+		c->callback_to_poll, c->poll_to_callback, c->evt_doorbells,
+		c->evt_irq_passes);
+
+	fprintf(out, "  occupancy p50 <= %s p99 <= %s of %u\n",
+		fmt_count(p50, sizeof(p50), gsi_tlm_percentile(c->occ_hist,
+			GSI_TLM_OCC_BUCKETS, 50)),
+		fmt_count(p99, sizeof(p99), gsi_tlm_percentile(c->occ_hist,
+			GSI_TLM_OCC_BUCKETS, 99)), c->ring_elems);
+	fprintf(out, "  poll batch p50 <= %s p99 <= %s",
+		fmt_count(p50, sizeof(p50), gsi_tlm_percentile(
+			c->poll_batch_hist, GSI_TLM_BATCH_BUCKETS, 50)),
+		fmt_count(p99, sizeof(p99), gsi_tlm_percentile(
+			c->poll_batch_hist, GSI_TLM_BATCH_BUCKETS, 99)));
+	fprintf(out, ", irq batch p50 <= %s p99 <= %s\n",
+		fmt_count(p50, sizeof(p50), gsi_tlm_percentile(
+			c->irq_batch_hist, GSI_TLM_BATCH_BUCKETS, 50)),
+		fmt_count(p99, sizeof(p99), gsi_tlm_percentile(
+			c->irq_batch_hist, GSI_TLM_BATCH_BUCKETS, 99)));
+	if (lat_on || hist_total(c->lat_hist, GSI_TLM_LAT_BUCKETS))
+		fprintf(out, "  latency p50 < %s p99 < %s (%llu samples)\n",
+			fmt_lat(p50, sizeof(p50), gsi_tlm_percentile(
+				c->lat_hist, GSI_TLM_LAT_BUCKETS, 50)),
+			fmt_lat(p99, sizeof(p99), gsi_tlm_percentile(
+				c->lat_hist, GSI_TLM_LAT_BUCKETS, 99)),
+			hist_total(c->lat_hist, GSI_TLM_LAT_BUCKETS));
+
+	if (!verbose)
+		return;
+
+	print_hist("doorbell to completion", c->lat_hist, GSI_TLM_LAT_BUCKETS,
+		1, out);
+	print_hist("occupancy at doorbell", c->occ_hist, GSI_TLM_OCC_BUCKETS,
+		0, out);
+	print_hist("events per poll", c->poll_batch_hist,
+		GSI_TLM_BATCH_BUCKETS, 0, out);
+	print_hist("events per irq pass", c->irq_batch_hist,
+		GSI_TLM_BATCH_BUCKETS, 0, out);
+}
+
+void gsi_tlm_print(const struct gsi_tlm_snap *snap, int verbose, FILE *out)
+{
+	int lat_on = !!(snap->hdr.flags & GSI_TLM_F_LATENCY);
+	int i;
+
+	fprintf(out, "gsi telemetry v%u at %llu ns, %u channels, latency sampling %s\n",
+		snap->hdr.version, (unsigned long long)snap->hdr.timestamp_ns,
+		snap->hdr.num_chan, lat_on ? "on" : "off");
+	for (i = 0; i < snap->hdr.num_chan; i++)
+		print_chan(&snap->chan[i], verbose, lat_on, out);
+}
@@ -0,0 +1,46 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _GSI_TELEMETRY_DEC_H_
+#define _GSI_TELEMETRY_DEC_H_
+
+#include <stddef.h>
+#include <stdio.h>
+#include "gsi_telemetry.h"
+
+/*
+ * struct gsi_tlm_snap - A parsed gsi/telemetry snapshot
+ * @hdr: the header, with hdr_size/rec_size of the driver which wrote it
+ * @chan: the channel records, converted to this decoder's layout: fields
+ *	the driver did not have are zero, fields it added are dropped
+ */
+struct gsi_tlm_snap {
+	struct gsi_tlm_hdr hdr;
+	struct gsi_tlm_chan *chan;
+};
+
+/* Parse len bytes of a snapshot, 0 or -EINVAL/-ENOMEM */
+int gsi_tlm_parse(const void *buf, size_t len, struct gsi_tlm_snap *snap);
+
+void gsi_tlm_free(struct gsi_tlm_snap *snap);
+
+/*
+ * Turn snap into the difference from old, for the channels present in
+ * both; a channel whose queued or doorbells count went backwards
+ * (rst_stats) is taken as restarted and left whole
+ */
+void gsi_tlm_sub(struct gsi_tlm_snap *snap, const struct gsi_tlm_snap *old);
+
+/*
+ * Upper bound of the bucket holding the given percentile of a log2
+ * histogram, UINT64_MAX when it is the open ended last bucket and 0 when
+ * the histogram is empty
+ */
+unsigned long long gsi_tlm_percentile(const __u32 *hist, int num_buckets,
+	unsigned int percent);
+
+void gsi_tlm_print(const struct gsi_tlm_snap *snap, int verbose, FILE *out);
+
+#endif /* _GSI_TELEMETRY_DEC_H_ */
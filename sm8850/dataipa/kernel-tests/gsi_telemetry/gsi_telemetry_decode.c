@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+/*
+ * Decoder of the gsi/telemetry debugfs file.
+ *
+ * Prints the per channel counters and log2 histograms of one snapshot, or
+ * with -i the difference between two snapshots taken the given number of
+ * milliseconds apart. The input is the debugfs file or a copy of it.
+ */
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "gsi_telemetry_dec.h"
+
+#define GSI_TLM_DEFAULT_PATH "/sys/kernel/debug/gsi/telemetry"
+#define GSI_TLM_READ_CHUNK 4096
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+		"usage: %s [-i interval_ms] [-v] [file]\n"
+		"  -i  print the difference of two snapshots interval_ms apart\n"
+		"  -v  print every histogram bucket\n"
+		"  file defaults to %s\n",
+		prog, GSI_TLM_DEFAULT_PATH);
+}
+
+static int read_snap(const char *path, struct gsi_tlm_snap *snap)
+{
+	unsigned char *buf = NULL, *tmp;
+	size_t len = 0, size = 0, n;
+	FILE *f;
+	int ret;
+
+	f = fopen(path, "rb");
+	if (!f) {
+		ret = -errno;
+		fprintf(stderr, "cannot open %s: %s\n", path, strerror(-ret));
+		return ret;
+	}
+
+	do {
+		if (len == size) {
+			size += GSI_TLM_READ_CHUNK;
+			tmp = realloc(buf, size);
+			if (!tmp) {
+				ret = -ENOMEM;
+				goto bail;
+			}
+			buf = tmp;
+		}
+		n = fread(buf + len, 1, size - len, f);
+		len += n;
+	} while (n);
+
+	ret = gsi_tlm_parse(buf, len, snap);
+	if (ret)
+		fprintf(stderr, "%s is not a gsi telemetry snapshot\n", path);
+bail:
+	free(buf);
+	fclose(f);
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	const char *path = GSI_TLM_DEFAULT_PATH;
+	struct gsi_tlm_snap old, snap;
+	int interval_ms = 0;
+	int verbose = 0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "i:vh")) != -1) {
+		switch (opt) {
+		case 'i':
+			interval_ms = atoi(optarg);
+			break;
+		case 'v':
+			verbose = 1;
+			break;
+		default:
+			usage(argv[0]);
+			return -1;
+		}
+	}
+	if (optind < argc)
+		path = argv[optind];
+
+	if (interval_ms > 0) {
+		if (read_snap(path, &old))
+			return -1;
+		usleep(interval_ms * 1000);
+	}
+	if (read_snap(path, &snap)) {
+		if (interval_ms > 0)
+			gsi_tlm_free(&old);
+		return -1;
+	}
+
+	if (interval_ms > 0) {
+		gsi_tlm_sub(&snap, &old);
+		gsi_tlm_free(&old);
+		printf("over %d ms:\n", interval_ms);
+	}
+	gsi_tlm_print(&snap, verbose, stdout);
+	gsi_tlm_free(&snap);
+
+	return 0;
+}
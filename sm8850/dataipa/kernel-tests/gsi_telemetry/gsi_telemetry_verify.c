@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+/*
+ * Checks of the gsi/telemetry decoder against snapshots built here: the
+ * header checks, reading records of older and newer drivers, histogram
+ * percentiles, the difference of two snapshots and the printed summary.
+ */
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gsi_telemetry_dec.h"
+
+static int fails;
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			fprintf(stderr, "%s:%d: %s\n", __func__, __LINE__, #cond); \
+			fails++; \
+		} \
+	} while (0)
+
+/*
+ * Lay out num_chan records of rec_size bytes after a header of hdr_size
+ * bytes, the way a driver with that layout would; the records are
+ * truncated or padded with 0xff
+ */
+static unsigned char *build(const struct gsi_tlm_chan *chan, int num_chan,
+	size_t hdr_size, size_t rec_size, size_t *len)
+{
+	struct gsi_tlm_hdr hdr;
+	unsigned char *buf;
+	int i;
+
+	*len = hdr_size + num_chan * rec_size;
+	buf = malloc(*len);
+	if (!buf)
+		abort();
+	memset(buf, 0xff, *len);
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = GSI_TLM_MAGIC;
+	hdr.version = GSI_TLM_VERSION;
+	hdr.hdr_size = hdr_size;
+	hdr.rec_size = rec_size;
+	hdr.num_chan = num_chan;
+	hdr.flags = GSI_TLM_F_LATENCY;
+	hdr.timestamp_ns = 1000;
+	memcpy(buf, &hdr, sizeof(hdr));
+	for (i = 0; i < num_chan; i++)
+		memcpy(buf + hdr_size + i * rec_size, &chan[i],
+			rec_size < sizeof(chan[i]) ? rec_size : sizeof(chan[i]));
+
+	return buf;
+}
+
+static void init_chan(struct gsi_tlm_chan *c, int ch_id)
+{
+	memset(c, 0, sizeof(*c));
+	c->ch_id = ch_id;
+	c->evt_id = ch_id + 1;
+	c->flags = GSI_TLM_CH_FROM_GSI;
+	c->ring_elems = 255;
+	c->queued = 1000;
+	c->completed = 990;
+	c->doorbells = 100;
+	c->irq_events = 10;
+	c->poll_events = 980;
+	c->lat_hist[3] = 4;
+	c->occ_hist[7] = 100;
+	c->poll_batch_hist[0] = 5;
+	c->poll_batch_hist[5] = 95;
+}
+
+static void verify_parse(void)
+{
+	struct gsi_tlm_chan chan[2];
+	struct gsi_tlm_snap snap;
+	unsigned char *buf;
+	size_t len;
+
+	init_chan(&chan[0], 3);
+	init_chan(&chan[1], 7);
+
+	buf = build(chan, 2, sizeof(struct gsi_tlm_hdr), sizeof(chan[0]), &len);
+	CHECK(!gsi_tlm_parse(buf, len, &snap));
+	CHECK(snap.hdr.num_chan == 2);
+	CHECK(!memcmp(snap.chan, chan, sizeof(chan)));
+	gsi_tlm_free(&snap);
+
+	CHECK(gsi_tlm_parse(buf, len - 1, &snap) == -EINVAL);
+	CHECK(gsi_tlm_parse(buf, sizeof(struct gsi_tlm_hdr) - 1, &snap) ==
+		-EINVAL);
+	buf[0] ^= 1;
+	CHECK(gsi_tlm_parse(buf, len, &snap) == -EINVAL);
+	free(buf);
+
+	/* a newer driver with a longer header and records */
+	buf = build(chan, 2, sizeof(struct gsi_tlm_hdr) + 8,
+		sizeof(chan[0]) + 16, &len);
+	CHECK(!gsi_tlm_parse(buf, len, &snap));
+	CHECK(!memcmp(snap.chan, chan, sizeof(chan)));
+	gsi_tlm_free(&snap);
+	free(buf);
+
+	/* an older driver without the histograms */
+	buf = build(chan, 2, sizeof(struct gsi_tlm_hdr),
+		offsetof(struct gsi_tlm_chan, lat_hist), &len);
+	CHECK(!gsi_tlm_parse(buf, len, &snap));
+	CHECK(snap.chan[1].ch_id == 7 && snap.chan[1].evt_irq_passes == 0);
+	CHECK(snap.chan[1].poll_events == 980);
+	CHECK(snap.chan[1].lat_hist[3] == 0);
+	gsi_tlm_free(&snap);
+	free(buf);
+}
+
+static void verify_percentile(void)
+{
+	__u32 hist[GSI_TLM_BATCH_BUCKETS];
+
+	memset(hist, 0, sizeof(hist));
+	CHECK(gsi_tlm_percentile(hist, GSI_TLM_BATCH_BUCKETS, 50) == 0);
+
+	hist[1] = 10;
+	hist[3] = 80;
+	hist[5] = 10;
+	CHECK(gsi_tlm_percentile(hist, GSI_TLM_BATCH_BUCKETS, 10) == 1);
+	CHECK(gsi_tlm_percentile(hist, GSI_TLM_BATCH_BUCKETS, 50) == 7);
+	CHECK(gsi_tlm_percentile(hist, GSI_TLM_BATCH_BUCKETS, 99) == 31);
+
+	hist[GSI_TLM_BATCH_BUCKETS - 1] = 1000;
+	CHECK(gsi_tlm_percentile(hist, GSI_TLM_BATCH_BUCKETS, 99) == UINT64_MAX);
+}
+
+static void verify_sub(void)
+{
+	struct gsi_tlm_chan old_chan[2], chan[3];
+	struct gsi_tlm_snap old, snap;
+	unsigned char *buf;
+	size_t len;
+
+	init_chan(&old_chan[0], 3);
+	init_chan(&old_chan[1], 5);
+	init_chan(&chan[0], 3);
+	init_chan(&chan[1], 5);
+	init_chan(&chan[2], 7);
+	chan[0].queued = 1500;
+	chan[0].doorbells = 150;
+	chan[0].lat_hist[3] = 10;
+	/* reset by rst_stats in between, then busier than before */
+	chan[1].queued = 1200;
+	chan[1].doorbells = 20;
+	chan[1].lat_hist[3] = 10;
+
+	buf = build(old_chan, 2, sizeof(struct gsi_tlm_hdr),
+		sizeof(old_chan[0]), &len);
+	CHECK(!gsi_tlm_parse(buf, len, &old));
+	free(buf);
+	buf = build(chan, 3, sizeof(struct gsi_tlm_hdr), sizeof(chan[0]), &len);
+	CHECK(!gsi_tlm_parse(buf, len, &snap));
+	free(buf);
+
+	gsi_tlm_sub(&snap, &old);
+	CHECK(snap.chan[0].queued == 500);
+	CHECK(snap.chan[0].doorbells == 50);
+	CHECK(snap.chan[0].completed == 0);
+	CHECK(snap.chan[0].lat_hist[3] == 6);
+	/* the whole record is taken as restarted, not only doorbells */
+	CHECK(snap.chan[1].queued == 1200);
+	CHECK(snap.chan[1].doorbells == 20);
+	CHECK(snap.chan[1].completed == 990);
+	CHECK(snap.chan[1].lat_hist[3] == 10);
+	/* not in the old snapshot */
+	CHECK(snap.chan[2].queued == 1000);
+
+	gsi_tlm_free(&old);
+	gsi_tlm_free(&snap);
+}
+
+static void verify_print(void)
+{
+	struct gsi_tlm_chan chan[1];
+	struct gsi_tlm_snap snap;
+	unsigned char *buf;
+	char *out = NULL;
+	size_t len, out_len;
+	FILE *f;
+
+	init_chan(&chan[0], 3);
+	buf = build(chan, 1, sizeof(struct gsi_tlm_hdr), sizeof(chan[0]), &len);
+	CHECK(!gsi_tlm_parse(buf, len, &snap));
+	free(buf);
+
+	f = open_memstream(&out, &out_len);
+	if (!f)
+		abort();
+	gsi_tlm_print(&snap, 1, f);
+	fclose(f);
+
+	CHECK(strstr(out, "ch  3 ev   4 from_gsi") != NULL);
+	CHECK(strstr(out, "(1% irq)") != NULL);
+	CHECK(strstr(out, "occupancy p50 <= 127 p99 <= 127 of 255") != NULL);
+	CHECK(strstr(out, "poll batch p50 <= 31 p99 <= 31") != NULL);
+	/* bucket 3 holds [4, 8) units of 1024 ns */
+	CHECK(strstr(out, "latency p50 < 8192ns") != NULL);
+	CHECK(strstr(out, "4096ns .. 8192ns") != NULL);
+
+	free(out);
+	gsi_tlm_free(&snap);
+}
+
+int main(void)
+{
+	verify_parse();
+	verify_percentile();
+	verify_sub();
+	verify_print();
+
+	printf("gsi telemetry decoder: %d failed\n", fails);
+
+	return fails ? 1 : 0;
+}
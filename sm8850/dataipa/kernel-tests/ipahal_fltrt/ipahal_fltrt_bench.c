@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+/*
+ * Host benchmark of the FLT/RT rule encoders and parsers.
+ *
+ * For every H/W version the rule corpus is cycled through and timed the way
+ * the driver exercises it: equation generation, the size pass (buf == NULL)
+ * followed by the write pass of filter and routing rules, the parsers, and
+ * building a whole filter table of -r rules into one coherent buffer.
+ * Rules the version does not support are left out of its run.
+ */
+#include <time.h>
+#include <unistd.h>
+#include "ipahal_fltrt_rules.h"
+#include "ipahal_fltrt_i.h"
+
+#define BENCH_BUF_SIZE (IPA3_0_HW_RULE_BUF_SIZE + 64)
+
+static int iterations = 20000;
+static int table_rules = 64;
+
+static u64 now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void report(int hw, const char *op, u64 ns, u64 ops)
+{
+	double per_op = ops ? (double)ns / ops : 0;
+
+	printf("hw %2d %-12s %10.1f ns/rule %12.0f rules/s\n", hw, op, per_op,
+		per_op ? 1e9 / per_op : 0);
+}
+
+static void init_flt(const struct ipahal_us_rule *r,
+	struct ipa_flt_rule_i *rule, struct ipahal_flt_rule_gen_params *gen,
+	int prio, u32 id)
+{
+	memset(rule, 0, sizeof(*rule));
+	rule->action = IPA_PASS_TO_ROUTING;
+	rule->attrib = r->attrib;
+
+	memset(gen, 0, sizeof(*gen));
+	gen->ipt = r->ipt;
+	gen->rt_tbl_idx = 1;
+	gen->priority = prio;
+	gen->id = id;
+	gen->rule = rule;
+}
+
+static void init_rt(const struct ipahal_us_rule *r,
+	struct ipa_rt_rule_i *rule, struct ipahal_rt_rule_gen_params *gen,
+	int prio, u32 id)
+{
+	memset(rule, 0, sizeof(*rule));
+	rule->attrib = r->attrib;
+
+	memset(gen, 0, sizeof(*gen));
+	gen->ipt = r->ipt;
+	gen->dst_pipe_idx = 1;
+	gen->hdr_type = IPAHAL_RT_RULE_HDR_NONE;
+	gen->priority = prio;
+	gen->id = id;
+	gen->rule = rule;
+}
+
+static int bench_table(int hw, const struct ipahal_us_rule **sel, int sel_num)
+{
+	struct ipa_flt_rule_i *rules;
+	struct ipahal_flt_rule_gen_params *gens;
+	u32 *hw_lens;
+	struct ipa_mem_buffer mem;
+	u64 start;
+	u64 ns = 0;
+	u8 *p;
+	int prio;
+	int it;
+	int i;
+	int rc = -ENOMEM;
+
+	rules = calloc(table_rules, sizeof(*rules));
+	gens = calloc(table_rules, sizeof(*gens));
+	hw_lens = calloc(table_rules, sizeof(*hw_lens));
+	if (!rules || !gens || !hw_lens)
+		goto out;
+
+	prio = ipahal_get_rule_max_priority();
+	for (i = 0; i < table_rules; i++) {
+		init_flt(sel[i % sel_num], &rules[i], &gens[i], prio,
+			ipahal_get_low_rule_id() + i);
+		ipahal_rule_decrease_priority(&prio);
+	}
+
+	for (it = 0; it < iterations / table_rules + 1; it++) {
+		start = now_ns();
+		memset(&mem, 0, sizeof(mem));
+		for (i = 0; i < table_rules; i++) {
+			hw_lens[i] = 0;
+			if (ipahal_flt_generate_hw_rule(&gens[i], &hw_lens[i],
+				NULL))
+				goto fail;
+			mem.size += hw_lens[i];
+		}
+		if (ipahal_fltrt_allocate_hw_sys_tbl(&mem))
+			goto fail;
+		p = mem.base;
+		for (i = 0; i < table_rules; i++) {
+			if (ipahal_flt_generate_hw_rule(&gens[i], &hw_lens[i],
+				p)) {
+				ipahal_free_dma_mem(&mem);
+				goto fail;
+			}
+			p += hw_lens[i];
+		}
+		ipahal_free_dma_mem(&mem);
+		ns += now_ns() - start;
+	}
+
+	report(hw, "flt table", ns, (u64)it * table_rules);
+	rc = 0;
+	goto out;
+
+fail:
+	fprintf(stderr, "hw %d: table build failed\n", hw);
+	rc = -EFAULT;
+out:
+	free(hw_lens);
+	free(gens);
+	free(rules);
+	return rc;
+}
+
+static int bench_hw(int hw)
+{
+	const struct ipahal_us_rule *corpus;
+	const struct ipahal_us_rule *sel[32];
+	struct ipa_ipfltri_rule_eq eq;
+	struct ipa_flt_rule_i flt_rule;
+	struct ipahal_flt_rule_gen_params flt_gen;
+	struct ipahal_flt_rule_entry flt_entry;
+	struct ipa_rt_rule_i rt_rule;
+	struct ipahal_rt_rule_gen_params rt_gen;
+	struct ipahal_rt_rule_entry rt_entry;
+	u8 flt_bufs[32][BENCH_BUF_SIZE] __attribute__((aligned(8)));
+	u8 rt_bufs[32][BENCH_BUF_SIZE] __attribute__((aligned(8)));
+	u8 buf[BENCH_BUF_SIZE] __attribute__((aligned(8)));
+	u64 start;
+	u32 hw_len;
+	int sel_num = 0;
+	int num;
+	int prio;
+	int rc = -EFAULT;
+	int i;
+	int n;
+
+	if (ipahal_us_init(hw)) {
+		fprintf(stderr, "hw %d: ipahal_us_init failed\n", hw);
+		return -EFAULT;
+	}
+
+	/* keep the rules this version encodes, and their images to parse */
+	corpus = ipahal_us_get_rules(&num);
+	prio = ipahal_get_rule_max_priority();
+	for (i = 0; i < num && sel_num < ARRAY_SIZE(sel); i++) {
+		init_flt(&corpus[i], &flt_rule, &flt_gen, prio,
+			ipahal_get_low_rule_id());
+		hw_len = 0;
+		if (ipahal_flt_generate_hw_rule(&flt_gen, &hw_len,
+			flt_bufs[sel_num]))
+			continue;
+		init_rt(&corpus[i], &rt_rule, &rt_gen, prio,
+			ipahal_get_low_rule_id());
+		hw_len = 0;
+		if (ipahal_rt_generate_hw_rule(&rt_gen, &hw_len,
+			rt_bufs[sel_num]))
+			continue;
+		sel[sel_num++] = &corpus[i];
+	}
+	if (!sel_num) {
+		fprintf(stderr, "hw %d: no rule supported\n", hw);
+		goto out;
+	}
+
+	start = now_ns();
+	for (n = 0; n < iterations; n++) {
+		memset(&eq, 0, sizeof(eq));
+		/* not every rule has an equation form, time the attempt */
+		ipahal_flt_generate_equation(sel[n % sel_num]->ipt,
+			&sel[n % sel_num]->attrib, &eq);
+	}
+	report(hw, "eq gen", now_ns() - start, iterations);
+
+	start = now_ns();
+	for (n = 0; n < iterations; n++) {
+		init_flt(sel[n % sel_num], &flt_rule, &flt_gen, prio,
+			ipahal_get_low_rule_id());
+		/* size pass then write pass, as the driver adds a rule */
+		hw_len = 0;
+		if (ipahal_flt_generate_hw_rule(&flt_gen, &hw_len, NULL) ||
+			ipahal_flt_generate_hw_rule(&flt_gen, &hw_len, buf))
+			goto out;
+	}
+	report(hw, "flt encode", now_ns() - start, iterations);
+
+	start = now_ns();
+	for (n = 0; n < iterations; n++) {
+		init_rt(sel[n % sel_num], &rt_rule, &rt_gen, prio,
+			ipahal_get_low_rule_id());
+		hw_len = 0;
+		if (ipahal_rt_generate_hw_rule(&rt_gen, &hw_len, NULL) ||
+			ipahal_rt_generate_hw_rule(&rt_gen, &hw_len, buf))
+			goto out;
+	}
+	report(hw, "rt encode", now_ns() - start, iterations);
+
+	start = now_ns();
+	for (n = 0; n < iterations; n++) {
+		memset(&flt_entry, 0, sizeof(flt_entry));
+		if (ipahal_flt_parse_hw_rule(flt_bufs[n % sel_num],
+			&flt_entry))
+			goto out;
+	}
+	report(hw, "flt parse", now_ns() - start, iterations);
+
+	start = now_ns();
+	for (n = 0; n < iterations; n++) {
+		memset(&rt_entry, 0, sizeof(rt_entry));
+		if (ipahal_rt_parse_hw_rule(rt_bufs[n % sel_num], &rt_entry))
+			goto out;
+	}
+	report(hw, "rt parse", now_ns() - start, iterations);
+
+	rc = bench_table(hw, sel, sel_num);
+out:
+	if (rc)
+		fprintf(stderr, "hw %d: benchmark failed\n", hw);
+	ipahal_us_destroy();
+	return rc;
+}
+
+static void usage(const char *name)
+{
+	printf("Usage: %s [-n iterations] [-r rules] [-v hw_type]\n", name);
+	printf("  -n: rules processed per measurement (default %d)\n",
+		iterations);
+	printf("  -r: rules per table for the table build (default %d)\n",
+		table_rules);
+	printf("  -v: only run this IPA_HW_* value (default all)\n");
+}
+
+int main(int argc, char **argv)
+{
+	int first = IPA_HW_v3_0;
+	int last = IPA_HW_MAX - 1;
+	int fails = 0;
+	int hw;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:r:v:h")) != -1) {
+		switch (opt) {
+		case 'n':
+			iterations = atoi(optarg);
+			break;
+		case 'r':
+			table_rules = atoi(optarg);
+			break;
+		case 'v':
+			first = last = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return -1;
+		}
+	}
+	if (iterations <= 0 || table_rules <= 0) {
+		usage(argv[0]);
+		return -1;
+	}
+
+	for (hw = first; hw <= last; hw++)
+		if (bench_hw(hw))
+			fails++;
+
+	return fails ? 1 : 0;
+}
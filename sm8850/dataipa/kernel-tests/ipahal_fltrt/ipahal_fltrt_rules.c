@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#include "ipahal_fltrt_rules.h"
+
+#define IPAHAL_US_MAX_RULES 32
+
+static struct ipahal_us_rule rules[IPAHAL_US_MAX_RULES];
+static int rules_num;
+
+static struct ipa_rule_attrib *add_rule(const char *name,
+	enum ipa_ip_type ipt, u32 attrib_mask)
+{
+	struct ipahal_us_rule *rule = &rules[rules_num++];
+
+	rule->name = name;
+	rule->ipt = ipt;
+	rule->attrib.attrib_mask = attrib_mask;
+	return &rule->attrib;
+}
+
+static void set_v6_addr(u32 *addr, u32 *mask, u32 host, int prefix_words)
+{
+	int i;
+
+	addr[0] = htonl(0x20010db8);
+	addr[1] = htonl(0x00000001);
+	addr[2] = 0;
+	addr[3] = htonl(host);
+	for (i = 0; i < 4; i++)
+		mask[i] = (i < prefix_words) ? 0xFFFFFFFF : 0;
+}
+
+static void build_rules(void)
+{
+	static const u8 mac_a[ETH_ALEN] = { 0x02, 0x00, 0x00, 0x11, 0x22, 0x33 };
+	static const u8 mac_b[ETH_ALEN] = { 0x02, 0x00, 0x00, 0x44, 0x55, 0x66 };
+	struct ipa_rule_attrib *a;
+
+	a = add_rule("v4 5-tuple", IPA_IP_v4, IPA_FLT_PROTOCOL |
+		IPA_FLT_SRC_ADDR | IPA_FLT_DST_ADDR | IPA_FLT_SRC_PORT |
+		IPA_FLT_DST_PORT);
+	a->u.v4.protocol = 6;
+	a->u.v4.src_addr = 0xC0A80102;
+	a->u.v4.src_addr_mask = 0xFFFFFFFF;
+	a->u.v4.dst_addr = 0x08080808;
+	a->u.v4.dst_addr_mask = 0xFFFFFF00;
+	a->src_port = 40000;
+	a->dst_port = 443;
+
+	a = add_rule("v4 port ranges, tos", IPA_IP_v4, IPA_FLT_TOS |
+		IPA_FLT_SRC_PORT_RANGE | IPA_FLT_DST_PORT_RANGE);
+	a->u.v4.tos = 0x2e;
+	a->src_port_lo = 1024;
+	a->src_port_hi = 65535;
+	a->dst_port_lo = 5000;
+	a->dst_port_hi = 5100;
+
+	a = add_rule("v4 icmp type/code, metadata", IPA_IP_v4,
+		IPA_FLT_PROTOCOL | IPA_FLT_TYPE | IPA_FLT_CODE |
+		IPA_FLT_META_DATA);
+	a->u.v4.protocol = 1;
+	a->type = 8;
+	a->code = 0;
+	a->meta_data = 0x00050000;
+	a->meta_data_mask = 0x00FF0000;
+
+	a = add_rule("v4 masked tos, fragment", IPA_IP_v4,
+		IPA_FLT_TOS_MASKED | IPA_FLT_FRAGMENT);
+	a->tos_value = 0xb8;
+	a->tos_mask = 0xfc;
+
+	a = add_rule("v4 ether II macs, ether type", IPA_IP_v4,
+		IPA_FLT_MAC_DST_ADDR_ETHER_II | IPA_FLT_MAC_SRC_ADDR_ETHER_II |
+		IPA_FLT_MAC_ETHER_TYPE);
+	memcpy(a->dst_mac_addr, mac_a, ETH_ALEN);
+	memset(a->dst_mac_addr_mask, 0xFF, ETH_ALEN);
+	memcpy(a->src_mac_addr, mac_b, ETH_ALEN);
+	memset(a->src_mac_addr_mask, 0xFF, ETH_ALEN);
+	a->ether_type = 0x0800;
+
+	a = add_rule("v4 802.1Q mac, vlan, tcp syn", IPA_IP_v4,
+		IPA_FLT_MAC_DST_ADDR_802_1Q | IPA_FLT_VLAN_ID |
+		IPA_FLT_TCP_SYN);
+	memcpy(a->dst_mac_addr, mac_a, ETH_ALEN);
+	memset(a->dst_mac_addr_mask, 0xFF, ETH_ALEN);
+	a->vlan_id = 100;
+
+	a = add_rule("v4 esp spi", IPA_IP_v4, IPA_FLT_PROTOCOL | IPA_FLT_SPI);
+	a->u.v4.protocol = 50;
+	a->spi = 0x12345678;
+
+	a = add_rule("v4 pure ack", IPA_IP_v4, IPA_FLT_PROTOCOL |
+		IPA_FLT_IS_PURE_ACK);
+	a->u.v4.protocol = 6;
+
+	a = add_rule("v4 mtu", IPA_IP_v4, IPA_FLT_DST_ADDR);
+	a->ext_attrib_mask = IPA_FLT_EXT_MTU;
+	a->u.v4.dst_addr = 0x0A000001;
+	a->u.v4.dst_addr_mask = 0xFFFFFFFF;
+	a->payload_length = 1400;
+
+	a = add_rule("v6 5-tuple", IPA_IP_v6, IPA_FLT_NEXT_HDR |
+		IPA_FLT_SRC_ADDR | IPA_FLT_DST_ADDR | IPA_FLT_SRC_PORT |
+		IPA_FLT_DST_PORT);
+	a->u.v6.next_hdr = 17;
+	set_v6_addr(a->u.v6.src_addr, a->u.v6.src_addr_mask, 0x10, 4);
+	set_v6_addr(a->u.v6.dst_addr, a->u.v6.dst_addr_mask, 0x20, 2);
+	a->src_port = 5353;
+	a->dst_port = 53;
+
+	a = add_rule("v6 tc, flow label", IPA_IP_v6, IPA_FLT_TC |
+		IPA_FLT_FLOW_LABEL);
+	a->u.v6.tc = 0x20;
+	a->u.v6.flow_label = 0xabcde;
+
+	a = add_rule("v6 port ranges, metadata", IPA_IP_v6,
+		IPA_FLT_SRC_PORT_RANGE | IPA_FLT_DST_PORT_RANGE |
+		IPA_FLT_META_DATA);
+	a->src_port_lo = 49152;
+	a->src_port_hi = 65535;
+	a->dst_port_lo = 80;
+	a->dst_port_hi = 81;
+	a->meta_data = 0x3;
+	a->meta_data_mask = 0xFF;
+
+	a = add_rule("v6 fragment, 802.3 mac", IPA_IP_v6, IPA_FLT_FRAGMENT |
+		IPA_FLT_MAC_DST_ADDR_802_3);
+	memcpy(a->dst_mac_addr, mac_b, ETH_ALEN);
+	memset(a->dst_mac_addr_mask, 0xFF, ETH_ALEN);
+
+	a = add_rule("v6 icmpv6 type/code", IPA_IP_v6, IPA_FLT_NEXT_HDR |
+		IPA_FLT_TYPE | IPA_FLT_CODE);
+	a->u.v6.next_hdr = 58;
+	a->type = 135;
+	a->code = 0;
+
+	a = add_rule("v6 ext next hdr", IPA_IP_v6, IPA_FLT_NEXT_HDR);
+	a->ext_attrib_mask = IPA_FLT_EXT_NEXT_HDR;
+	a->u.v6.next_hdr = 6;
+
+	/*
+	 * no extra word at all, with the IPAv5.5 extension header the rest
+	 * starts at the 64 bit boundary after it
+	 */
+	a = add_rule("v4 metadata only", IPA_IP_v4, IPA_FLT_META_DATA);
+	a->meta_data = 0x00070000;
+	a->meta_data_mask = 0x00FF0000;
+
+	a = add_rule("v6 flow label only", IPA_IP_v6, IPA_FLT_FLOW_LABEL);
+	a->u.v6.flow_label = 0x12345;
+}
+
+const struct ipahal_us_rule *ipahal_us_get_rules(int *num)
+{
+	if (!rules_num)
+		build_rules();
+
+	*num = rules_num;
+	return rules;
+}
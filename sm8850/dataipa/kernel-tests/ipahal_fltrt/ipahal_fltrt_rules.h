@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _IPAHAL_FLTRT_RULES_H_
+#define _IPAHAL_FLTRT_RULES_H_
+
+#include "ipahal_fltrt_us.h"
+
+/*
+ * struct ipahal_us_rule - Rule attributes shared by the benchmark and the
+ *  verifier
+ * @name: short description printed on failures
+ * @ipt: IP family the attributes are meant for
+ * @attrib: the attributes, as a client would hand them to the driver
+ */
+struct ipahal_us_rule {
+	const char *name;
+	enum ipa_ip_type ipt;
+	struct ipa_rule_attrib attrib;
+};
+
+/*
+ * ipahal_us_get_rules() - Corpus of rules covering every equation type,
+ *  several of them only supported by some H/W versions
+ * @num: OUT number of rules in the returned array
+ */
+const struct ipahal_us_rule *ipahal_us_get_rules(int *num);
+
+#endif /* _IPAHAL_FLTRT_RULES_H_ */
@@ -0,0 +1,21 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _IPAHAL_FLTRT_US_H_
+#define _IPAHAL_FLTRT_US_H_
+
+#include "ipahal.h"
+#include "ipahal_fltrt.h"
+
+/*
+ * ipahal_us_init() - Userspace counterpart of ipahal_init() limited to the
+ *  FLT/RT part: sets up ipahal_ctx for @ipa_hw_type and runs
+ *  ipahal_fltrt_init(). May be called again after ipahal_us_destroy() to
+ *  switch to another H/W version.
+ */
+int ipahal_us_init(enum ipa_hw_type ipa_hw_type);
+void ipahal_us_destroy(void);
+
+#endif /* _IPAHAL_FLTRT_US_H_ */
@@ -0,0 +1,453 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+/*
+ * Round-trip check of the FLT/RT rule encoders, for every H/W version.
+ *
+ * Each rule of the corpus is encoded as a filter from its attributes,
+ * parsed back and encoded again from the parsed equations; both encodings
+ * must be byte identical and the header fields and rule size must survive.
+ * The equations ipahal_flt_generate_equation() builds for the rule are
+ * encoded and parsed back the same way and must come out unchanged. The
+ * routing encoding of the attributes must parse back to the same
+ * equations as the filter one. From IPAv5.5 every rule is also checked
+ * with the extension header (TTL update, QoS class, both), which moves
+ * the extra and rest words.
+ *
+ * Where the attribute encoder and the equation generator disagree (one
+ * rejects what the other takes, or they build different equations) a
+ * divergence is reported; -s turns those into failures.
+ */
+#include <unistd.h>
+#include "ipahal_fltrt_rules.h"
+#include "ipahal_fltrt_i.h"
+
+#define RULE_BUF_SIZE (IPA3_0_HW_RULE_BUF_SIZE + 64)
+
+static int verbose;
+
+#define VERIFY_ERR(hw, rule, fmt, args...) \
+	fprintf(stderr, "hw %d [%s]: " fmt "\n", (hw), (rule)->name, ## args)
+
+static int eq_cmp(const struct ipa_ipfltri_rule_eq *exp,
+	const struct ipa_ipfltri_rule_eq *got, const char **what)
+{
+	int i;
+
+#define EQ_FIELD(f) \
+	do { \
+		if (exp->f != got->f) { \
+			*what = #f; \
+			return -1; \
+		} \
+	} while (0)
+
+	EQ_FIELD(rule_eq_bitmap);
+	EQ_FIELD(tos_eq_present);
+	if (exp->tos_eq_present)
+		EQ_FIELD(tos_eq);
+	EQ_FIELD(protocol_eq_present);
+	if (exp->protocol_eq_present)
+		EQ_FIELD(protocol_eq);
+	EQ_FIELD(tc_eq_present);
+	if (exp->tc_eq_present)
+		EQ_FIELD(tc_eq);
+	EQ_FIELD(num_offset_meq_128);
+	for (i = 0; i < exp->num_offset_meq_128; i++) {
+		EQ_FIELD(offset_meq_128[i].offset);
+		if (memcmp(exp->offset_meq_128[i].mask,
+			got->offset_meq_128[i].mask, 16) ||
+			memcmp(exp->offset_meq_128[i].value,
+			got->offset_meq_128[i].value, 16)) {
+			*what = "offset_meq_128";
+			return -1;
+		}
+	}
+	EQ_FIELD(num_offset_meq_32);
+	for (i = 0; i < exp->num_offset_meq_32; i++) {
+		EQ_FIELD(offset_meq_32[i].offset);
+		EQ_FIELD(offset_meq_32[i].mask);
+		EQ_FIELD(offset_meq_32[i].value);
+	}
+	EQ_FIELD(num_ihl_offset_meq_32);
+	for (i = 0; i < exp->num_ihl_offset_meq_32; i++) {
+		EQ_FIELD(ihl_offset_meq_32[i].offset);
+		EQ_FIELD(ihl_offset_meq_32[i].mask);
+		EQ_FIELD(ihl_offset_meq_32[i].value);
+	}
+	EQ_FIELD(metadata_meq32_present);
+	if (exp->metadata_meq32_present) {
+		EQ_FIELD(metadata_meq32.mask);
+		EQ_FIELD(metadata_meq32.value);
+	}
+	EQ_FIELD(num_ihl_offset_range_16);
+	for (i = 0; i < exp->num_ihl_offset_range_16; i++) {
+		EQ_FIELD(ihl_offset_range_16[i].offset);
+		EQ_FIELD(ihl_offset_range_16[i].range_low);
+		EQ_FIELD(ihl_offset_range_16[i].range_high);
+	}
+	EQ_FIELD(ihl_offset_eq_32_present);
+	if (exp->ihl_offset_eq_32_present) {
+		EQ_FIELD(ihl_offset_eq_32.offset);
+		EQ_FIELD(ihl_offset_eq_32.value);
+	}
+	EQ_FIELD(ihl_offset_eq_16_present);
+	if (exp->ihl_offset_eq_16_present) {
+		EQ_FIELD(ihl_offset_eq_16.offset);
+		EQ_FIELD(ihl_offset_eq_16.value);
+	}
+	EQ_FIELD(fl_eq_present);
+	if (exp->fl_eq_present && (exp->fl_eq & 0xfffff) != got->fl_eq) {
+		*what = "fl_eq";
+		return -1;
+	}
+	EQ_FIELD(ipv4_frag_eq_present);
+
+#undef EQ_FIELD
+	return 0;
+}
+
+struct verify_stats {
+	int checked;
+	int skipped;
+	int fails;
+	int divergences;
+};
+
+static int check_flt_hdr(int hw, const struct ipahal_us_rule *r,
+	const struct ipahal_flt_rule_gen_params *gen,
+	const struct ipahal_flt_rule_entry *parsed, u32 hw_len)
+{
+	const struct ipa_flt_rule_i *rule = gen->rule;
+
+	if (parsed->rule_size != hw_len) {
+		VERIFY_ERR(hw, r, "flt: parsed size %u, encoded %u",
+			parsed->rule_size, hw_len);
+		return -1;
+	}
+	if (parsed->rule.action != rule->action ||
+		parsed->rule.rt_tbl_idx != gen->rt_tbl_idx ||
+		parsed->rule.retain_hdr != rule->retain_hdr ||
+		parsed->priority != gen->priority || parsed->id != gen->id) {
+		VERIFY_ERR(hw, r,
+			"flt: hdr action %d/%d rt_tbl %u/%u retain %u/%u prio %u/%u id %u/%u",
+			parsed->rule.action, rule->action,
+			parsed->rule.rt_tbl_idx, gen->rt_tbl_idx,
+			parsed->rule.retain_hdr, rule->retain_hdr,
+			parsed->priority, gen->priority, parsed->id, gen->id);
+		return -1;
+	}
+	if (hw >= IPA_HW_v4_0 && (parsed->rule.pdn_idx != rule->pdn_idx ||
+		parsed->rule.set_metadata != rule->set_metadata)) {
+		VERIFY_ERR(hw, r, "flt: pdn %u/%u set_metadata %u/%u",
+			parsed->rule.pdn_idx, rule->pdn_idx,
+			parsed->rule.set_metadata, rule->set_metadata);
+		return -1;
+	}
+	if (hw >= IPA_HW_v5_5 &&
+		(parsed->rule.ttl_update != rule->ttl_update ||
+		parsed->rule.qos_class != rule->qos_class)) {
+		VERIFY_ERR(hw, r, "flt: ttl %u/%u qos %u/%u",
+			parsed->rule.ttl_update, rule->ttl_update,
+			parsed->rule.qos_class, rule->qos_class);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Filtering rule, from the attributes and from the equations. Fills
+ * @parsed_eq with the equations parsed back from the attribute encoding
+ * for the routing check. Returns 1 when verified, 0 when the rule is not
+ * supported by this version and -1 on failure.
+ */
+static int verify_flt(int hw, const struct ipahal_us_rule *r, u32 id,
+	u32 prio, int ext, struct ipa_ipfltri_rule_eq *parsed_eq,
+	struct verify_stats *stats)
+{
+	struct ipa_ipfltri_rule_eq eq;
+	struct ipa_flt_rule_i rule;
+	struct ipahal_flt_rule_gen_params gen;
+	struct ipahal_flt_rule_entry parsed;
+	u8 buf[RULE_BUF_SIZE] __attribute__((aligned(8)));
+	u8 buf_eq[RULE_BUF_SIZE] __attribute__((aligned(8)));
+	u32 hw_len = 0;
+	u32 hw_len_eq = 0;
+	const char *what;
+	int rc_eq;
+	int rc;
+
+	memset(&eq, 0, sizeof(eq));
+	rc_eq = ipahal_flt_generate_equation(r->ipt, &r->attrib, &eq);
+
+	memset(&rule, 0, sizeof(rule));
+	rule.action = IPA_PASS_TO_ROUTING;
+	rule.retain_hdr = 1;
+	rule.attrib = r->attrib;
+	rule.pdn_idx = 3;
+	rule.set_metadata = 1;
+	rule.ttl_update = (ext & 1);
+	rule.qos_class = (ext & 2) ? 5 : 0;
+
+	memset(&gen, 0, sizeof(gen));
+	gen.ipt = r->ipt;
+	gen.rt_tbl_idx = 7;
+	gen.priority = prio;
+	gen.id = id;
+	gen.rule = &rule;
+
+	memset(buf, 0, sizeof(buf));
+	rc = ipahal_flt_generate_hw_rule(&gen, &hw_len, buf);
+	if (rc_eq && rc)
+		return 0;
+	if (rc_eq || rc) {
+		VERIFY_ERR(hw, r, "divergence: equation rc %d, encoder rc %d",
+			rc_eq, rc);
+		stats->divergences++;
+	}
+
+	if (!rc) {
+		/* attributes -> H/W -> equations -> H/W */
+		memset(&parsed, 0, sizeof(parsed));
+		if (ipahal_flt_parse_hw_rule(buf, &parsed)) {
+			VERIFY_ERR(hw, r, "flt: parse failed");
+			return -1;
+		}
+		if (check_flt_hdr(hw, r, &gen, &parsed, hw_len))
+			return -1;
+		*parsed_eq = parsed.rule.eq_attrib;
+
+		rule.eq_attrib_type = 1;
+		rule.eq_attrib = parsed.rule.eq_attrib;
+		memset(buf_eq, 0, sizeof(buf_eq));
+		if (ipahal_flt_generate_hw_rule(&gen, &hw_len_eq, buf_eq)) {
+			VERIFY_ERR(hw, r, "flt: encoding parsed equations failed");
+			return -1;
+		}
+		if (hw_len_eq != hw_len || memcmp(buf, buf_eq, hw_len)) {
+			VERIFY_ERR(hw, r, "flt: re-encoding differs (%u/%u bytes)",
+				hw_len, hw_len_eq);
+			return -1;
+		}
+		rule.eq_attrib_type = 0;
+	}
+
+	if (!rc_eq) {
+		/* equations -> H/W -> equations */
+		rule.eq_attrib_type = 1;
+		rule.eq_attrib = eq;
+		hw_len_eq = 0;
+		memset(buf_eq, 0, sizeof(buf_eq));
+		if (ipahal_flt_generate_hw_rule(&gen, &hw_len_eq, buf_eq)) {
+			VERIFY_ERR(hw, r, "flt: encoding from equations failed");
+			return -1;
+		}
+		memset(&parsed, 0, sizeof(parsed));
+		if (ipahal_flt_parse_hw_rule(buf_eq, &parsed)) {
+			VERIFY_ERR(hw, r, "flt: parse of equation form failed");
+			return -1;
+		}
+		if (check_flt_hdr(hw, r, &gen, &parsed, hw_len_eq))
+			return -1;
+		if (eq_cmp(&eq, &parsed.rule.eq_attrib, &what)) {
+			VERIFY_ERR(hw, r, "flt: equation field %s lost", what);
+			return -1;
+		}
+	}
+
+	/*
+	 * Both generators are meant to describe the same match; report
+	 * where they do not (some are on purpose, e.g. the IPv2 word order
+	 * of 128 bit equations)
+	 */
+	if (!rc && !rc_eq && eq_cmp(&eq, parsed_eq, &what)) {
+		VERIFY_ERR(hw, r, "divergence: attrib and equation generators differ in %s",
+			what);
+		stats->divergences++;
+	}
+
+	return rc ? 0 : 1;
+}
+
+/* Routing rule from the attributes, the body must match the filter one */
+static int verify_rt(int hw, const struct ipahal_us_rule *r, u32 id,
+	u32 prio, int ext, const struct ipa_ipfltri_rule_eq *flt_eq)
+{
+	struct ipa_rt_rule_i rule;
+	struct ipahal_rt_rule_gen_params gen;
+	struct ipahal_rt_rule_entry parsed;
+	u8 buf[RULE_BUF_SIZE] __attribute__((aligned(8)));
+	u32 hw_len = 0;
+	const char *what;
+
+	memset(&rule, 0, sizeof(rule));
+	rule.attrib = r->attrib;
+	rule.retain_hdr = 1;
+	rule.ttl_update = (ext & 1);
+	rule.qos_class = (ext & 2) ? 3 : 0;
+
+	memset(&gen, 0, sizeof(gen));
+	gen.ipt = r->ipt;
+	gen.dst_pipe_idx = 12;
+	gen.hdr_type = IPAHAL_RT_RULE_HDR_RAW;
+	gen.hdr_lcl = true;
+	gen.hdr_ofst = 0x40;
+	gen.priority = prio;
+	gen.id = id;
+	gen.rule = &rule;
+
+	memset(buf, 0, sizeof(buf));
+	if (ipahal_rt_generate_hw_rule(&gen, &hw_len, buf)) {
+		VERIFY_ERR(hw, r, "rt: encoding failed, flt did not");
+		return -1;
+	}
+
+	memset(&parsed, 0, sizeof(parsed));
+	if (ipahal_rt_parse_hw_rule(buf, &parsed)) {
+		VERIFY_ERR(hw, r, "rt: parse failed");
+		return -1;
+	}
+	if (parsed.rule_size != hw_len) {
+		VERIFY_ERR(hw, r, "rt: parsed size %u, encoded %u",
+			parsed.rule_size, hw_len);
+		return -1;
+	}
+	if (eq_cmp(flt_eq, &parsed.eq_attrib, &what)) {
+		VERIFY_ERR(hw, r, "rt: equation field %s differs from flt",
+			what);
+		return -1;
+	}
+	if (parsed.dst_pipe_idx != gen.dst_pipe_idx ||
+		parsed.hdr_type != gen.hdr_type ||
+		parsed.hdr_lcl != gen.hdr_lcl ||
+		parsed.hdr_ofst != gen.hdr_ofst ||
+		parsed.retain_hdr != rule.retain_hdr ||
+		parsed.priority != prio || parsed.id != id) {
+		VERIFY_ERR(hw, r,
+			"rt: hdr pipe %d/%d type %d/%d lcl %d/%d ofst %u/%u retain %d/%d prio %u/%u id %u/%u",
+			parsed.dst_pipe_idx, gen.dst_pipe_idx,
+			parsed.hdr_type, gen.hdr_type,
+			parsed.hdr_lcl, gen.hdr_lcl,
+			parsed.hdr_ofst, gen.hdr_ofst,
+			parsed.retain_hdr, rule.retain_hdr,
+			parsed.priority, prio, parsed.id, id);
+		return -1;
+	}
+	if (hw >= IPA_HW_v5_5 && (parsed.ttl_update != rule.ttl_update ||
+		parsed.qos_class != rule.qos_class)) {
+		VERIFY_ERR(hw, r, "rt: ttl %u/%u qos %u/%u",
+			parsed.ttl_update, rule.ttl_update,
+			parsed.qos_class, rule.qos_class);
+		return -1;
+	}
+
+	return 1;
+}
+
+static int verify_hw(int hw, struct verify_stats *stats)
+{
+	const struct ipahal_us_rule *rules;
+	struct ipa_ipfltri_rule_eq parsed_eq;
+	int num;
+	int i;
+	int rc;
+	u32 id;
+	int prio;
+	int ext;
+	int num_ext;
+
+	if (ipahal_us_init(hw)) {
+		fprintf(stderr, "hw %d: ipahal_us_init failed\n", hw);
+		return -1;
+	}
+
+	/* without, then with the extension header: TTL, QoS class, both */
+	num_ext = (hw >= IPA_HW_v5_5) ? 4 : 1;
+
+	rules = ipahal_us_get_rules(&num);
+	prio = ipahal_get_rule_max_priority();
+	for (i = 0; i < num; i++) {
+		id = ipahal_get_low_rule_id() + i;
+
+		for (ext = 0; ext < num_ext; ext++) {
+			memset(&parsed_eq, 0, sizeof(parsed_eq));
+			rc = verify_flt(hw, &rules[i], id, prio, ext,
+				&parsed_eq, stats);
+			if (rc > 0)
+				rc = verify_rt(hw, &rules[i], id, prio, ext,
+					&parsed_eq);
+
+			if (rc < 0)
+				stats->fails++;
+			else if (rc)
+				stats->checked++;
+			else
+				stats->skipped++;
+			if (verbose)
+				printf("hw %d %-32s ext %d %s\n", hw,
+					rules[i].name, ext, rc < 0 ? "FAIL" :
+					rc ? "ok" : "unsupported");
+		}
+
+		ipahal_rule_decrease_priority(&prio);
+	}
+
+	ipahal_us_destroy();
+	return 0;
+}
+
+static void usage(const char *name)
+{
+	printf("Usage: %s [-v hw_type] [-s] [-V]\n", name);
+	printf("  -v: only check this IPA_HW_* value (default all)\n");
+	printf("  -s: fail on attrib/equation generator divergences too\n");
+	printf("  -V: print the result of every rule\n");
+}
+
+int main(int argc, char **argv)
+{
+	struct verify_stats stats;
+	int first = IPA_HW_v3_0;
+	int last = IPA_HW_MAX - 1;
+	int strict = 0;
+	int total_fails = 0;
+	int total_divergences = 0;
+	int hw;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "v:sVh")) != -1) {
+		switch (opt) {
+		case 'v':
+			first = last = atoi(optarg);
+			break;
+		case 's':
+			strict = 1;
+			break;
+		case 'V':
+			verbose = 1;
+			break;
+		default:
+			usage(argv[0]);
+			return -1;
+		}
+	}
+
+	for (hw = first; hw <= last; hw++) {
+		memset(&stats, 0, sizeof(stats));
+		if (verify_hw(hw, &stats))
+			stats.fails++;
+		printf("hw %2d: %3d ok, %3d unsupported, %3d failed, %3d divergences\n",
+			hw, stats.checked, stats.skipped, stats.fails,
+			stats.divergences);
+		total_fails += stats.fails;
+		total_divergences += stats.divergences;
+	}
+
+	if (strict)
+		total_fails += total_divergences;
+	printf("%s\n", total_fails ? "FAIL" : "PASS");
+	return total_fails ? 1 : 0;
+}
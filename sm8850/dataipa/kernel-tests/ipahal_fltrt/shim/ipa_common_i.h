@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _IPA_COMMON_I_H_
+#define _IPA_COMMON_I_H_
+
+/*
+ * Userspace replacement of drivers/platform/msm/ipa/ipa_common_i.h for the
+ * host build of ipahal_fltrt.c. It keeps the include guard of the driver
+ * header and carries only the definitions ipahal.h and ipahal_fltrt.c use;
+ * the GSI, MHI and offload interfaces are left out.
+ */
+#include <linux/ipa.h>
+#include <linux/ipc_logging.h>
+
+#ifdef CONFIG_IPA_DEBUG
+#define WARN_ON_RATELIMIT_IPA(condition) WARN_ON(condition)
+#else
+#define WARN_ON_RATELIMIT_IPA(condition)
+#endif
+
+#define pr_err_ratelimited_ipa(fmt, args...) pr_err_ratelimited(fmt, ## args)
+
+#define ipa_assert_on(condition)\
+do {\
+	if (unlikely(condition))\
+		ipa_assert();\
+} while (0)
+
+/**
+ * struct ipa_mem_buffer - IPA memory buffer
+ * @base: base
+ * @phys_base: physical base address
+ * @size: size of memory buffer
+ */
+struct ipa_mem_buffer {
+	void *base;
+	dma_addr_t phys_base;
+	u32 size;
+};
+
+/**
+ * struct ipa_hdr_offset_entry - IPA header offset entry
+ * @link: entry's link in global header offset entries list
+ * @offset: the offset
+ * @bin: bin
+ * @ipacm_installed: indicate if installed by ipacm
+ */
+struct ipa_hdr_offset_entry {
+	struct list_head link;
+	u32 offset;
+	u32 bin;
+	bool ipacm_installed;
+};
+
+#define IPA_IPC_LOGGING(buf, fmt, args...) \
+	do { \
+		if (buf) \
+			ipc_log_string((buf), fmt, __func__, __LINE__, \
+				## args); \
+	} while (0)
+
+void *ipa3_get_ipc_logbuf(void);
+void *ipa3_get_ipc_logbuf_low(void);
+void ipa_assert(void);
+
+u8 *ipa_write_64(u64 w, u8 *dest);
+u8 *ipa_write_32(u32 w, u8 *dest);
+u8 *ipa_write_16(u16 hw, u8 *dest);
+u8 *ipa_write_8(u8 b, u8 *dest);
+u8 *ipa_pad_to_64(u8 *dest);
+
+#endif /* _IPA_COMMON_I_H_ */
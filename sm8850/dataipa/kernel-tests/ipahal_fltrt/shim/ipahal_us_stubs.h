@@ -0,0 +1,113 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#if !defined(_IPAHAL_US_STUBS_H_)
+# define _IPAHAL_US_STUBS_H_
+
+/*
+ * Userspace stand-ins for the kernel services ipahal_fltrt.c relies on,
+ * so the FLT/RT rule encoders and parsers build unmodified as a host
+ * library. Only what that file and the headers it pulls in touch is
+ * provided here.
+ */
+
+# include <stdbool.h>
+# include <stddef.h>
+# include <stdint.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <arpa/inet.h>
+# include <linux/errno.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef unsigned long long u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef long long s64;
+typedef u64 dma_addr_t;
+typedef unsigned int gfp_t;
+
+struct device;
+struct dentry;
+
+struct list_head {
+	struct list_head *next, *prev;
+};
+
+# define __iomem
+# define __packed __attribute__((packed))
+# define likely(x) __builtin_expect(!!(x), 1)
+# define unlikely(x) __builtin_expect(!!(x), 0)
+
+# define BIT(nr) (1UL << (nr))
+# define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+# define hweight_long(w) __builtin_popcountl(w)
+
+# define GFP_KERNEL 0
+# define GFP_ATOMIC 1
+
+/* pr_debug is compiled out like a kernel built without DYNAMIC_DEBUG */
+# define pr_debug(fmt, args...) do { } while (0)
+# define pr_err(fmt, args...) fprintf(stderr, fmt, ## args)
+# define pr_err_ratelimited(fmt, args...) pr_err(fmt, ## args)
+
+# define WARN(condition, fmt, args...) \
+({ \
+	int __ret_warn = !!(condition); \
+	\
+	if (__ret_warn) \
+		fprintf(stderr, "WARNING at %s:%d " fmt, __FILE__, \
+			__LINE__, ## args); \
+	__ret_warn; \
+})
+# define WARN_ON(condition) WARN(condition, "\n")
+# define BUG() abort()
+
+static inline void *kzalloc(size_t size, gfp_t flags)
+{
+	(void)flags;
+	return calloc(1, size);
+}
+
+static inline void kfree(const void *p)
+{
+	free((void *)p);
+}
+
+/*
+ * Coherent buffers are plain page aligned heap memory; the virtual address
+ * doubles as the "physical" one so the alignment checks done on phys_base
+ * still mean something.
+ */
+static inline void *dma_alloc_coherent(struct device *dev, size_t size,
+	dma_addr_t *dma_handle, gfp_t flags)
+{
+	void *p;
+
+	(void)dev;
+	(void)flags;
+	if (posix_memalign(&p, 4096, size ? size : 1))
+		return NULL;
+	*dma_handle = (dma_addr_t)(uintptr_t)p;
+	return p;
+}
+
+static inline void dma_free_coherent(struct device *dev, size_t size,
+	void *cpu_addr, dma_addr_t dma_handle)
+{
+	(void)dev;
+	(void)size;
+	(void)dma_handle;
+	free(cpu_addr);
+}
+
+/* Nothing is logged to IPC buffers, ipa3_get_ipc_logbuf() returns NULL */
+# define ipc_log_string(ilctxt, fmt, args...) do { } while (0)
+
+#endif /* _IPAHAL_US_STUBS_H_ */
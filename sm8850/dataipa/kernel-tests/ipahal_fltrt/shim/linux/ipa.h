@@ -0,0 +1,16 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _IPAHAL_US_LINUX_IPA_H_
+#define _IPAHAL_US_LINUX_IPA_H_
+
+/*
+ * Shadows the kernel <linux/ipa.h>. The rule encoders only need the UAPI
+ * definitions (rule attributes, equations, ip/hw types).
+ */
+#include "../ipahal_us_stubs.h"
+#include <linux/msm_ipa.h>
+
+#endif /* _IPAHAL_US_LINUX_IPA_H_ */
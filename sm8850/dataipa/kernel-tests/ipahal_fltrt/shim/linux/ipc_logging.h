@@ -0,0 +1,12 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _IPAHAL_US_LINUX_IPC_LOGGING_H_
+#define _IPAHAL_US_LINUX_IPC_LOGGING_H_
+
+/* Shadows the kernel <linux/ipc_logging.h>, see ipahal_us_stubs.h */
+#include "../ipahal_us_stubs.h"
+
+#endif /* _IPAHAL_US_LINUX_IPC_LOGGING_H_ */
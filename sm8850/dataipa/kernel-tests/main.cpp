@@ -66,6 +66,7 @@
 #include "Logger.h"
 #include "TestManager.h"
 #include "TestsUtils.h"
+#include "IPAModel.h"
 #include <stdio.h>
 #include <iostream>
 #include <set>
@@ -82,7 +83,9 @@ string sFormat = "ip_accelerator <control_flag> <suit/name>, ..., <suit/name>\n"
 							"ip_accelerator " SHOW_TEST_FLAG  "\n"
 							"ip_accelerator " SHOW_SUIT_FLAG  "\n"
 							"or ip_accelerator --chooser "
-							"for menu chooser interface\n";
+							"for menu chooser interface\n"
+							"add --model[=<IPA_HW_* value>] to run against "
+							"the userspace IPA model\n";
 #define MAX_SUITES 19
 
 #undef strcasesame
@@ -362,6 +365,7 @@ int main(int argc, char* argv[])
 		{"test",        no_argument,       &what, 4},
 		{"suite",       no_argument,       &what, 5},
 		{"mem",         required_argument, 0,    'm'},
+		{"model",       optional_argument, 0,    'M'},
 		{0, 0, 0, 0}
 	};
 
@@ -387,6 +391,9 @@ int main(int argc, char* argv[])
 				exit(1);
 			}
 			break;
+		case 'M':
+			IPAModel::Enable(optarg ? (enum ipa_hw_type)atoi(optarg) : IPA_HW_None);
+			break;
 		default:
 			fprintf(stderr, "Illegal command line argument passed\n");
 			printf("please use correct format:\n%s", sFormat.c_str());
@@ -432,6 +439,8 @@ int main(int argc, char* argv[])
 	} else {
 		result = scriptMode(argc, argv);
 	}
+	if (IPAModel::IsEnabled())
+		IPAModel::GetInstance().PrintStats();
 	return result;
 }//main
 
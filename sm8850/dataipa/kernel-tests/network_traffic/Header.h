@@ -31,13 +31,20 @@
 
 
 #include <vector>
+#include <algorithm>
 #include <climits>
 #include <cassert>
 #include <ostream>
 #include <bitset>
 #include <iostream>
 #include <iomanip>
+#include <cstring>
 #include <netinet/in.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 #include "bits_utils.h"
 
 using std::vector;
@@ -82,23 +89,98 @@ public:
         return resSize;
     }
 
-    static uint16_t computeChecksum(uint16_t *buf, size_t count){
-        uint32_t sum = 0;
-
-        while(count > 1){
-            sum += *buf++;
+    /**
+     * One's complement sum of count bytes at buf, in memory byte order, added to sum and folded to 16 bits.
+     * Partial sums of consecutive buffers can be chained as long as every buffer but the last has an even size.
+     */
+    static uint32_t checksumPartial(const void *buf, size_t count, uint32_t sum=0){
+        const uint8_t *p = static_cast<const uint8_t*>(buf);
+        uint64_t total = sum;
+        uint32_t word;
+        uint16_t tail = 0;
+
+#if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+
+        while(count >= 16){
+            // 32 bit lanes take up to 2 * 0xffff per block, fold them before they can overflow
+            size_t blocks = std::min<size_t>(count / 16, 16384);
+            __m128i acc = _mm_setzero_si128();
+            uint32_t lanes[4];
+
+            count -= blocks * 16;
+            while(blocks--){
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(v, zero));
+                acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(v, zero));
+                p += 16;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+            total += static_cast<uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        while(count >= 16){
+            size_t blocks = std::min<size_t>(count / 16, 16384);
+            uint32x4_t acc = vdupq_n_u32(0);
+
+            count -= blocks * 16;
+            while(blocks--){
+                acc = vpadalq_u16(acc, vreinterpretq_u16_u8(vld1q_u8(p)));
+                p += 16;
+            }
+            total += vaddlvq_u32(acc);
+        }
+#endif
+        // the sum of 32 bit words folds to the same 16 bit sum
+        while(count >= 4){
+            memcpy(&word, p, 4);
+            total += word;
+            p += 4;
+            count -= 4;
+        }
+        if(count >= 2){
+            memcpy(&tail, p, 2);
+            total += tail;
+            p += 2;
             count -= 2;
         }
         if(count > 0){
-            sum += ((*buf)&htons(0xFF00));
+            tail = 0;
+            memcpy(&tail, p, 1);
+            total += tail;
         }
+        return checksumFold(total);
+    }
+
+    static uint32_t checksumFold(uint64_t sum){
         while(sum >> 16u){
             sum = (sum & 0xffffu) + (sum >> 16u);
         }
-        sum = ~sum;
+        return static_cast<uint32_t>(sum);
+    }
+
+    /**
+     * Turn a sum from checksumPartial() into the checksum field value.
+     */
+    static uint16_t checksumFinish(uint32_t sum){
+        sum = ~checksumFold(sum);
         return htons(static_cast<uint16_t>(sum));
     }
 
+    static uint16_t computeChecksum(uint16_t *buf, size_t count){
+        return checksumFinish(checksumPartial(buf, count));
+    }
+
+    /**
+     * Incremental update of a checksum after one of the 16 bit words it covers changed from oldVal to newVal, as
+     * HC' = ~(~HC + ~m + m') of RFC 1624. All values are in host byte order.
+     */
+    static uint16_t updateChecksum(uint16_t checksum, uint16_t oldVal, uint16_t newVal){
+        uint32_t sum = static_cast<uint16_t>(~checksum) + static_cast<uint16_t>(~oldVal) + newVal;
+
+        return static_cast<uint16_t>(~checksumFold(sum));
+    }
+
     virtual ~Header() = default;
 
 };
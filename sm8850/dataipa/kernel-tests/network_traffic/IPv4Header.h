@@ -140,7 +140,7 @@ public:
                 htons(static_cast<uint16_t>(mTotalLength.to_ulong() - (mIhl.to_ulong() << 2u)));
     }
 
-    static size_t l3ChecksumPseudoHeaderSize(){
+    static constexpr size_t l3ChecksumPseudoHeaderSize(){
         return 12;
     }
 
@@ -154,12 +154,57 @@ public:
 
 private:
 
-    void fixChecksum(){
-        mHeaderChecksum = 0;
-        uint8_t arr[mSize];
+    static const unsigned int mNumWords {mSize / 2};
+    static const unsigned int mChecksumWord {5};
+
+    // the header words from the last checksum computation, valid while mChecksumWordsValid is set
+    uint16_t mChecksumWords[mNumWords] {};
+    bool mChecksumWordsValid {false};
+
+    void toWords(uint16_t *words) const {
+        words[0] = (mVersion.to_ulong() << 12u) | (mIhl.to_ulong() << 8u) | (mDscp.to_ulong() << 2u) |
+                mEcn.to_ulong();
+        words[1] = mTotalLength.to_ulong();
+        words[2] = mId.to_ulong();
+        words[3] = (mFlags.to_ulong() << 13u) | mFragmentOffset.to_ulong();
+        words[4] = (mTimeToLive.to_ulong() << 8u) | mProtocol.to_ulong();
+        words[5] = mHeaderChecksum.to_ulong();
+        words[6] = mSourceIpAddress.to_ulong() >> 16u;
+        words[7] = mSourceIpAddress.to_ulong() & 0xffffu;
+        words[8] = mDestIpAddress.to_ulong() >> 16u;
+        words[9] = mDestIpAddress.to_ulong() & 0xffffu;
+    }
 
-        asArray(arr);
-        mHeaderChecksum = computeChecksum(reinterpret_cast<uint16_t*>(arr), mSize);
+    /**
+     * While the checksum field still holds the value computed last, only the words changed since are folded into it
+     * (RFC 1624), otherwise it is computed from scratch.
+     */
+    void fixChecksum(){
+        uint16_t words[mNumWords];
+        uint16_t checksum;
+
+        toWords(words);
+        if(mChecksumWordsValid && words[mChecksumWord] == mChecksumWords[mChecksumWord]){
+            checksum = words[mChecksumWord];
+            for(unsigned int i = 0; i < mNumWords; i++){
+                if(i != mChecksumWord && words[i] != mChecksumWords[i]){
+                    checksum = updateChecksum(checksum, mChecksumWords[i], words[i]);
+                }
+            }
+        } else {
+            uint32_t sum = 0;
+
+            for(unsigned int i = 0; i < mNumWords; i++){
+                if(i != mChecksumWord){
+                    sum += words[i];
+                }
+            }
+            checksum = static_cast<uint16_t>(~checksumFold(sum));
+        }
+        mHeaderChecksum = checksum;
+        words[mChecksumWord] = checksum;
+        memcpy(mChecksumWords, words, sizeof(mChecksumWords));
+        mChecksumWordsValid = true;
     }
 
 };
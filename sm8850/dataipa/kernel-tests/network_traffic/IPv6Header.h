@@ -109,7 +109,7 @@ public:
         pseudoHeaderBuf[39] = 17;
     }
 
-    static size_t l3ChecksumPseudoHeaderSize(){
+    static constexpr size_t l3ChecksumPseudoHeaderSize(){
         return 40;
     }
 
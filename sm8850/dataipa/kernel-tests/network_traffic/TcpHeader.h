@@ -136,8 +136,9 @@ public:
         return 6;
     }
 
-    void adjust(uint8_t *checksumBuf, size_t count){
-        fixChecksum(checksumBuf, count);
+    // checksumSum is the checksumPartial() of the pseudo header, this header and the payload
+    void adjust(uint32_t checksumSum){
+        mChecksum = checksumFinish(checksumSum);
     }
 
     void zeroChecksum(){
@@ -193,14 +194,6 @@ public:
             .fin = mFIN.test(0)
         };
     }
-
-private:
-
-    void fixChecksum(uint8_t *checksumBuf, size_t count){
-        mChecksum = 0;
-        mChecksum = computeChecksum(reinterpret_cast<uint16_t*>(checksumBuf), count);
-    }
-
 };
 
 
@@ -87,9 +87,10 @@ public:
         mLength = mSize + payloadSize;
     }
 
-    void adjust(uint8_t *checksumBuf, size_t count, size_t payloadSize){
+    // checksumSum is the checksumPartial() of the pseudo header, this header and the payload
+    void adjust(uint32_t checksumSum, size_t payloadSize){
         mLength = mSize + payloadSize;
-        fixChecksum(checksumBuf, count);
+        mChecksum = checksumFinish(checksumSum);
     }
 
     void zeroChecksum(){
@@ -106,14 +107,6 @@ public:
             << "Length: " << mLength.to_ulong() << ", "
             << "Checksum: " << mChecksum.to_ulong() << "\n";
     }
-
-private:
-
-    void fixChecksum(uint8_t *checksumBuf, size_t count){
-        mChecksum = 0;
-        mChecksum = computeChecksum(reinterpret_cast<uint16_t*>(checksumBuf), count);
-    }
-
 };
 
 #endif //NETWORK_TRAFFIC_UDPHEADER_H
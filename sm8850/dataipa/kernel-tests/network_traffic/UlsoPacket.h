@@ -299,23 +299,7 @@ private:
         }
         tcpHeader.setmSequenceNumber(seqNum);
         seqNum += mPayload.size();
-        size_t checksumBufSize = mInternetHeader.l3ChecksumPseudoHeaderSize() + mTransportHeader.size() + mPayload.size();
-        uint8_t checksumBuf[checksumBufSize];
-        memset(checksumBuf, 0, checksumBufSize);
-        uint8_t *checksumBufPtr = checksumBuf;
-
-        size_t ulsoBufSize = size();
-        uint8_t ulsoBuf[ulsoBufSize];
-        memset(ulsoBuf, 0, ulsoBufSize);
-        asArray(ulsoBuf);
-        size_t ipOffset = mQmapHeader.size() + mEthernetHeaderValid * mEthernetHeader.size();
-        mInternetHeader.tcpChecksumPseudoHeader(checksumBuf, ulsoBuf + ipOffset);
-        checksumBufPtr += mInternetHeader.l3ChecksumPseudoHeaderSize();
-        checksumBufPtr += tcpHeader.asArray(checksumBufPtr);
-        for(auto val: mPayload){
-            *checksumBufPtr++ = val;
-        }
-        mTransportHeader.adjust(checksumBuf, checksumBufSize);
+        mTransportHeader.adjust(transportChecksumSum(tcpHeader, true));
     }
 
     void adjustHeader(UdpHeader& udpHeader, uint32_t seqNum, bool first){
@@ -324,24 +308,33 @@ private:
             mTransportHeader.adjust(mPayload.size());
         } else{
             udpHeader.setmLength(udpHeader.size() + mPayload.size());
-            size_t checksumBufSize = mInternetHeader.l3ChecksumPseudoHeaderSize() + mTransportHeader.size() + mPayload.size();
-            uint8_t checksumBuf[checksumBufSize];
-            memset(checksumBuf, 0, checksumBufSize);
-            uint8_t *checksumBufPtr = checksumBuf;
-
-            size_t ulsoBufSize = size();
-            uint8_t ulsoBuf[ulsoBufSize];
-            memset(ulsoBuf, 0, ulsoBufSize);
-            asArray(ulsoBuf);
-            size_t ipOffset = mQmapHeader.size() + mEthernetHeaderValid * mEthernetHeader.size();
-            mInternetHeader.udpChecksumPseudoHeader(checksumBuf, ulsoBuf + ipOffset);
-            checksumBufPtr += mInternetHeader.l3ChecksumPseudoHeaderSize();
-            checksumBufPtr += udpHeader.asArray(checksumBufPtr);
-            for(auto val: mPayload){
-                *checksumBufPtr++ = val;
-            }
-            mTransportHeader.adjust(checksumBuf, checksumBufSize, mPayload.size());
+            mTransportHeader.adjust(transportChecksumSum(udpHeader, false), mPayload.size());
+        }
+    }
+
+    /**
+     * Sum the pseudo header, the transport header and the payload where they are, rather than serializing the whole
+     * packet and copying them into one buffer first.
+     */
+    template <typename T>
+    uint32_t transportChecksumSum(const T& transportHeader, bool isTcp) const {
+        uint8_t ipHeaderBuf[Internet::mSize];
+        uint8_t pseudoHeaderBuf[Internet::l3ChecksumPseudoHeaderSize()];
+        uint8_t transportHeaderBuf[T::mSize];
+        uint32_t sum;
+
+        memset(ipHeaderBuf, 0, sizeof(ipHeaderBuf));
+        memset(pseudoHeaderBuf, 0, sizeof(pseudoHeaderBuf));
+        memset(transportHeaderBuf, 0, sizeof(transportHeaderBuf));
+        mInternetHeader.asArray(ipHeaderBuf);
+        if(isTcp){
+            mInternetHeader.tcpChecksumPseudoHeader(pseudoHeaderBuf, ipHeaderBuf);
+        } else {
+            mInternetHeader.udpChecksumPseudoHeader(pseudoHeaderBuf, ipHeaderBuf);
         }
+        sum = Header::checksumPartial(pseudoHeaderBuf, sizeof(pseudoHeaderBuf));
+        sum = Header::checksumPartial(transportHeaderBuf, transportHeader.asArray(transportHeaderBuf), sum);
+        return Header::checksumPartial(mPayload.data(), mPayload.size(), sum);
     }
 
     template <typename T, typename I>
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the
+ * disclaimer below) provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *     * Neither the name of Qualcomm Innovation Center, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE
+ * GRANTED BY THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT
+ * HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*
+ * Checks the one's complement sum of Header::checksumPartial() against a plain byte pair loop, times both, times the
+ * IPv4 header checksum kept up to date incrementally against serializing and summing the header, and times the
+ * segmentation of large ULSO packets, whose segments' checksums are verified afterwards.
+ * Exits with 1 on the first mismatch.
+ */
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "UlsoPacket.h"
+
+using std::vector;
+
+static const size_t benchSizes[] = {20, 64, 576, 1500, 9000, 65535};
+
+static uint64_t nowNs(){
+    struct timespec ts {};
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+// folded sum of big endian byte pairs, an odd trailing byte is the high byte of its pair
+static uint16_t referenceSum(const uint8_t *buf, size_t count, uint32_t sum=0){
+    for(size_t i = 0; i + 1 < count; i += 2){
+        sum += (buf[i] << 8u) | buf[i + 1];
+    }
+    if(count % 2){
+        sum += buf[count - 1] << 8u;
+    }
+    while(sum >> 16u){
+        sum = (sum & 0xffffu) + (sum >> 16u);
+    }
+    return static_cast<uint16_t>(sum);
+}
+
+static bool checkSums(std::mt19937& rng){
+    vector<uint8_t> buf(65536 + 16);
+
+    for(auto& b: buf){
+        b = static_cast<uint8_t>(rng());
+    }
+    for(size_t offset = 0; offset < 4; offset++){
+        for(size_t count = 0; count < 300; count++){
+            uint16_t ref = referenceSum(buf.data() + offset, count);
+            uint16_t sum = static_cast<uint16_t>(Header::checksumPartial(buf.data() + offset, count));
+
+            if(htons(ref) != sum){
+                printf("sum mismatch: offset %zu count %zu ref 0x%04x got 0x%04x\n", offset, count, ref, ntohs(sum));
+                return false;
+            }
+        }
+        for(size_t count: benchSizes){
+            uint16_t ref = referenceSum(buf.data() + offset, count);
+            uint16_t sum = static_cast<uint16_t>(Header::checksumPartial(buf.data() + offset, count));
+
+            if(htons(ref) != sum){
+                printf("sum mismatch: offset %zu count %zu ref 0x%04x got 0x%04x\n", offset, count, ref, ntohs(sum));
+                return false;
+            }
+        }
+    }
+    // all ones must not overflow the lanes
+    memset(buf.data(), 0xff, buf.size());
+    if(Header::checksumPartial(buf.data(), 65536) != 0xffff){
+        printf("sum mismatch on an all ones buffer\n");
+        return false;
+    }
+    return true;
+}
+
+static void benchSums(int iterations){
+    vector<uint8_t> buf(65536 + 1, 0xa5);
+    volatile uint32_t sink = 0;
+
+    printf("%-8s %8s %12s %12s\n", "bytes", "offset", "ref MB/s", "simd MB/s");
+    for(size_t count: benchSizes){
+        for(size_t offset = 0; offset < 2; offset++){
+            int n = std::max<int>(1, static_cast<int>(iterations * 64 / count));
+            uint64_t start = nowNs();
+            uint64_t refNs;
+            uint64_t simdNs;
+
+            for(int i = 0; i < n; i++){
+                sink = sink + referenceSum(buf.data() + offset, count);
+            }
+            refNs = nowNs() - start;
+            start = nowNs();
+            for(int i = 0; i < n; i++){
+                sink = sink + Header::checksumPartial(buf.data() + offset, count);
+            }
+            simdNs = nowNs() - start;
+            printf("%-8zu %8zu %12.1f %12.1f\n", count, offset, 1e3 * count * n / std::max<uint64_t>(refNs, 1),
+                   1e3 * count * n / std::max<uint64_t>(simdNs, 1));
+        }
+    }
+}
+
+static bool benchIpv4(int iterations){
+    IPv4Header header;
+    uint8_t buf[IPv4Header::mSize];
+    volatile uint32_t sink = 0;
+    uint64_t start;
+    uint64_t incrementalNs;
+    uint64_t fullNs;
+
+    start = nowNs();
+    for(int i = 0; i < iterations; i++){
+        header.setmId(i);
+        header.adjust(i % 1480, 17);
+        sink = sink + header.mHeaderChecksum.to_ulong();
+    }
+    incrementalNs = nowNs() - start;
+    memset(buf, 0, sizeof(buf));
+    header.asArray(buf);
+    if(referenceSum(buf, sizeof(buf)) != 0xffff){
+        printf("ipv4 header checksum mismatch after incremental updates\n");
+        return false;
+    }
+
+    start = nowNs();
+    for(int i = 0; i < iterations; i++){
+        header.setmId(i);
+        header.mTotalLength = i % 1480;
+        header.mHeaderChecksum = 0;
+        memset(buf, 0, sizeof(buf));
+        header.asArray(buf);
+        sink = sink + Header::computeChecksum(reinterpret_cast<uint16_t*>(buf), sizeof(buf));
+    }
+    fullNs = nowNs() - start;
+    printf("ipv4 header checksum: incremental %.1f ns, serialize and sum %.1f ns\n",
+           static_cast<double>(incrementalNs) / iterations, static_cast<double>(fullNs) / iterations);
+    return true;
+}
+
+// the IP header and the transport checksum of a serialized segment, the QMAP header is already removed
+static bool validSegment(const uint8_t *ip, size_t len){
+    uint8_t pseudoHeader[40] {};
+    size_t ipHeaderSize;
+    size_t pseudoHeaderSize;
+    uint8_t protocol;
+    uint16_t sum;
+
+    if((ip[0] >> 4u) == 4){
+        ipHeaderSize = IPv4Header::mSize;
+        protocol = ip[9];
+        if(referenceSum(ip, ipHeaderSize) != 0xffff){
+            return false;
+        }
+        memcpy(pseudoHeader, ip + 12, 8);
+        pseudoHeader[9] = protocol;
+        pseudoHeader[10] = static_cast<uint8_t>((len - ipHeaderSize) >> 8u);
+        pseudoHeader[11] = static_cast<uint8_t>(len - ipHeaderSize);
+        pseudoHeaderSize = IPv4Header::l3ChecksumPseudoHeaderSize();
+    } else {
+        ipHeaderSize = IPv6Header::mSize;
+        protocol = ip[6];
+        memcpy(pseudoHeader, ip + 8, 32);
+        pseudoHeader[34] = static_cast<uint8_t>((len - ipHeaderSize) >> 8u);
+        pseudoHeader[35] = static_cast<uint8_t>(len - ipHeaderSize);
+        pseudoHeader[39] = protocol;
+        pseudoHeaderSize = IPv6Header::l3ChecksumPseudoHeaderSize();
+    }
+    // a zero UDP checksum means none was computed
+    if(protocol == 17 && ip[ipHeaderSize + 6] == 0 && ip[ipHeaderSize + 7] == 0){
+        return true;
+    }
+    sum = referenceSum(pseudoHeader, pseudoHeaderSize);
+    sum = referenceSum(ip + ipHeaderSize, len - ipHeaderSize, sum);
+    return sum == 0xffff;
+}
+
+template <typename Transport, typename Internet>
+static bool benchSegmentation(const char *name, int iterations, unsigned int segmentSize, unsigned int payloadSize){
+    UlsoPacket<Transport, Internet> packet(segmentSize, payloadSize, false);
+    vector<UlsoPacket<Transport, Internet>> segments;
+    vector<uint8_t> buf(UlsoPacket<Transport, Internet>::maxSize);
+    uint64_t start = nowNs();
+    uint64_t ns;
+
+    for(int i = 0; i < iterations; i++){
+        segments = packet.segment();
+    }
+    ns = nowNs() - start;
+    printf("%s: %u bytes into %zu segments of %u, %.1f us per packet\n", name, payloadSize, segments.size(),
+           segmentSize, static_cast<double>(ns) / iterations / 1e3);
+    for(size_t i = 0; i < segments.size(); i++){
+        size_t len = segments[i].asArray(buf.data());
+
+        if(!validSegment(buf.data(), len)){
+            printf("%s: bad checksum in segment %zu\n", name, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv){
+    std::mt19937 rng(1);
+    int iterations = argc > 1 ? atoi(argv[1]) : 20000;
+
+    if(iterations <= 0){
+        printf("Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+    if(!checkSums(rng)){
+        return 1;
+    }
+    benchSums(iterations);
+    if(!benchIpv4(iterations)){
+        return 1;
+    }
+    if(!benchSegmentation<UdpHeader, IPv4Header>("ipv4 udp", iterations / 1000 + 1, 1400, 64000) ||
+       !benchSegmentation<TcpHeader, IPv4Header>("ipv4 tcp", iterations / 1000 + 1, 1400, 64000) ||
+       !benchSegmentation<UdpHeader, IPv6Header>("ipv6 udp", iterations / 1000 + 1, 1400, 64000) ||
+       !benchSegmentation<TcpHeader, IPv6Header>("ipv6 tcp", iterations / 1000 + 1, 1401, 63999)){
+        return 1;
+    }
+    return 0;
+}
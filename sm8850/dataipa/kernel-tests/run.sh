@@ -28,7 +28,14 @@
 # IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 set -e
-./test_env_setup.sh
+
+# The model needs neither the device nor the ipa_test module
+if [ "$1" = "-m" ] || [ "$1" = "--model" ]; then
+	shift
+	export IPA_TEST_MODEL=${IPA_TEST_MODEL:-0}
+else
+	./test_env_setup.sh
+fi
 
 echo "Starting test"
 
@@ -43,7 +50,6 @@ while [ $# -gt 0 ]; do
 	-n | --nominal)
 		echo "Nominal\n"
 		exec ./ipa_kernel_tests --suite_name Regression
-		exit 0
 		;;
 	-a | --adversarial)
 		echo "adversarial\n"
@@ -52,12 +58,18 @@ while [ $# -gt 0 ]; do
 		;;
 	-r | --repeatability)
 		echo "Currently no repeatability tests"
-	-s | --stress)
-		echo "Currently no stress tests"
 		exit 0
 		;;
+	-s | --stress)
+		echo "Stress\n"
+		exec ./ipa_kernel_tests --suite Stress
+		;;
+	-p | --performance)
+		echo "Performance\n"
+		exec ./ipa_kernel_tests --suite Perf
+		;;
 	-h | --help | *)
-		echo "Usage: ./run.sh -[n][a][r][s]"
+		echo "Usage: ./run.sh [-m] -[n][a][r][s][p]"
 		exit 1
 		;;
         esac
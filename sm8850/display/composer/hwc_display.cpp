@@ -34,6 +34,7 @@
 #include <utils/debug.h>
 #include <utils/utils.h>
 #include <utils/formats.h>
+#include <utils/frame_record.h>
 #include <utils/rect.h>
 #include <vendor/qti/hardware/display/composer/3.0/IQtiComposerClient.h>
 #include <QtiGralloc.h>
@@ -527,6 +528,9 @@ int HWCDisplay::Init() {
 
   UpdateConfigs();
 
+  OpenFrameRecord();
+  HWCDebugHandler::Get()->GetProperty(ENABLE_FRAME_TIMING_RETIRE, &enable_frame_timing_retire_);
+
   int enable_gpu_tonemapper = 0;
   HWCDebugHandler::Get()->GetProperty(ENABLE_GPU_TONEMAPPER_PROP, &enable_gpu_tonemapper);
   // Disable instantiating HWCTonemapper when GPU tonemapping is not used.
@@ -610,6 +614,10 @@ int HWCDisplay::Deinit() {
     tone_mapper_ = nullptr;
   }
 
+  if (frame_record_.is_open()) {
+    frame_record_.close();
+  }
+
   return 0;
 }
 
@@ -1501,7 +1509,13 @@ HWC2::Error HWCDisplay::PrepareLayerStack(uint32_t *out_num_types, uint32_t *out
 
   UpdateRefreshRate();
   UpdateActiveConfig();
-  DisplayError error = display_intf_->Prepare(&layer_stack_);
+  RecordFrame();
+  BeginFrameTiming();
+  DisplayError error = kErrorNone;
+  {
+    ScopedFrameTiming frame_timing(sdm_id_, kPhasePrepareLayerStack);
+    error = display_intf_->Prepare(&layer_stack_);
+  }
   auto status = HandlePrepareError(error);
   if (status != HWC2::Error::None) {
     return status;
@@ -1757,8 +1771,14 @@ HWC2::Error HWCDisplay::CommitOrPrepare(bool validate_only, shared_ptr<Fence> *o
   }
 
   layer_stack_.validate_only = validate_only;
+  RecordFrame();
+  BeginFrameTiming();
 
-  DisplayError error = display_intf_->CommitOrPrepare(&layer_stack_);
+  DisplayError error = kErrorNone;
+  {
+    ScopedFrameTiming frame_timing(sdm_id_, kPhasePresentOrValidate);
+    error = display_intf_->CommitOrPrepare(&layer_stack_);
+  }
   // Mask error if needed.
   auto status = HandlePrepareError(error);
   if (status != HWC2::Error::None) {
@@ -1809,7 +1829,10 @@ HWC2::Error HWCDisplay::CommitLayerStack(void) {
     }
   }
 
-  error = display_intf_->Commit(&layer_stack_);
+  {
+    ScopedFrameTiming frame_timing(sdm_id_, kPhasePresentOrValidate);
+    error = display_intf_->Commit(&layer_stack_);
+  }
 
   if (error == kErrorNone) {
     // A commit is successfully submitted, start flushing on failure now onwards.
@@ -1848,6 +1871,8 @@ HWC2::Error HWCDisplay::PostCommitLayerStack(shared_ptr<Fence> *out_retire_fence
   DumpInputBuffers();
 
   RetrieveFences(out_retire_fence);
+  EndFrameTiming();
+  frame_recorded_ = false;
   client_target_->ResetGeometryChanges();
 
   for (auto hwc_layer : layer_set_) {
@@ -1936,6 +1961,113 @@ DisplayError HWCDisplay::SetMaxMixerStages(uint32_t max_mixer_stages) {
   return error;
 }
 
+void HWCDisplay::OpenFrameRecord() {
+  char path[PROPERTY_VALUE_MAX] = {};
+  if (HWCDebugHandler::Get()->GetProperty(FRAME_RECORD_PATH, path) != kErrorNone || !path[0]) {
+    return;
+  }
+
+  // Frames are buffered and written out when the buffer fills, on dump and on close, keeping
+  // file I/O off the composition path of most frames.
+  frame_record_buf_.resize(kFrameRecordBufSize);
+  frame_record_.rdbuf()->pubsetbuf(frame_record_buf_.data(), kFrameRecordBufSize);
+  std::string file_name = std::string(path) + "/frame_record_" + std::to_string(sdm_id_) + ".txt";
+  frame_record_.open(file_name, std::ios::out | std::ios::trunc);
+  if (!frame_record_.is_open()) {
+    DLOGW("Failed to open frame record %s", file_name.c_str());
+    return;
+  }
+
+  DLOGI("Recording layer stacks of display %d to %s", sdm_id_, file_name.c_str());
+}
+
+void HWCDisplay::RecordFrame() {
+  // Validate may follow a present or validate which needs it, record the frame only once.
+  if (!frame_record_.is_open() || frame_recorded_) {
+    return;
+  }
+
+  WriteFrameRecord(frame_record_index_++, layer_stack_, &frame_record_);
+  frame_recorded_ = true;
+}
+
+void HWCDisplay::BeginFrameTiming() {
+  FrameTiming *frame_timing = FrameTiming::Get(sdm_id_);
+
+  // Retire latency of the previous frame, only tracked when enabled as reading the fence signal
+  // time costs an allocation and an ioctl per frame. Its fence signals on the vsync that shows
+  // the frame, use the time until now as a lower bound if it is still pending.
+  if (frame_timing_retire_fence_) {
+    uint64_t signal_ns = 0;
+    if (Fence::GetStatus(frame_timing_retire_fence_) == Fence::Status::kSignaled) {
+      Fence::ScopedRef scoped_ref;
+      struct sync_file_info *file_info =
+          sync_file_info(scoped_ref.Get(frame_timing_retire_fence_));
+      if (file_info) {
+        struct sync_fence_info *fence_info = sync_get_fence_info(file_info);
+        for (uint32_t i = 0; i < file_info->num_fences; i++) {
+          signal_ns = std::max(signal_ns, static_cast<uint64_t>(fence_info[i].timestamp_ns));
+        }
+        sync_file_info_free(file_info);
+      }
+    }
+    if (!signal_ns) {
+      signal_ns = FrameTiming::NowNs();
+    }
+    if (signal_ns > frame_timing_commit_ns_) {
+      frame_timing->RecordRetire(signal_ns - frame_timing_commit_ns_, frame_timing_vsync_ns_);
+    }
+    frame_timing_retire_fence_ = nullptr;
+  }
+
+  frame_timing->BeginFrame();
+}
+
+void HWCDisplay::EndFrameTiming() {
+  VsyncPeriodNanos vsync_period = 0;
+  GetVsyncPeriodByActiveConfig(&vsync_period);
+
+  FrameTiming::Get(sdm_id_)->EndFrame(vsync_period, GetGpuFallbackReason());
+  if (enable_frame_timing_retire_) {
+    frame_timing_retire_fence_ = layer_stack_.retire_fence;
+    frame_timing_commit_ns_ = FrameTiming::NowNs();
+  }
+  frame_timing_vsync_ns_ = vsync_period;
+}
+
+GpuFallbackReason HWCDisplay::GetGpuFallbackReason() {
+  bool gpu_composed = false;
+  bool client_requested = false;
+  for (auto hwc_layer : layer_set_) {
+    if (hwc_layer->GetSDMLayer()->composition != kCompositionGPU) {
+      continue;
+    }
+    gpu_composed = true;
+    client_requested |=
+        (hwc_layer->GetOrigClientRequestedCompositionType() == HWC2::Composition::Client);
+  }
+
+  if (!gpu_composed) {
+    return kGpuFallbackNone;
+  } else if (layer_stack_.flags.skip_present) {
+    return kGpuFallbackSkipLayer;
+  } else if (client_requested) {
+    return kGpuFallbackClientRequest;
+  } else if (layer_stack_.flags.animating) {
+    return kGpuFallbackAnimation;
+  }
+
+  return kGpuFallbackStrategy;
+}
+
+void HWCDisplay::DumpFrameTiming(std::ostringstream *os, bool reset) {
+  FrameTiming *frame_timing = FrameTiming::Get(sdm_id_);
+  frame_timing->Dump(os);
+  if (reset) {
+    frame_timing->Reset();
+  }
+}
+
 void HWCDisplay::DumpInputBuffers() {
   char dir_path[PATH_MAX];
   int  status;
@@ -2543,6 +2675,9 @@ DisplayClass HWCDisplay::GetDisplayClass() {
 }
 
 void HWCDisplay::Dump(std::ostringstream *os) {
+  if (frame_record_.is_open()) {
+    frame_record_.flush();
+  }
   *os << "\n------------HWC----------------\n";
   *os << "HWC2 display_id: " << id_ << std::endl;
   for (auto layer : layer_set_) {
@@ -2592,6 +2727,9 @@ void HWCDisplay::Dump(std::ostringstream *os) {
     *os << display_intf_->Dump();
   }
 
+  *os << "\n---------Frame Timing----------\n";
+  FrameTiming::Get(sdm_id_)->Dump(os);
+
   *os << "\n";
 }
 
@@ -2701,6 +2839,7 @@ void HWCDisplay::WaitOnPreviousFence() {
     return;
   }
 
+  ScopedFrameTiming frame_timing(sdm_id_, kPhaseWaitOnPreviousFence);
   if (Fence::Wait(release_fence_) != kErrorNone) {
     DLOGW("sync_wait error errno = %d, desc = %s", errno, strerror(errno));
     return;
@@ -33,8 +33,10 @@
 #include <hardware/hwcomposer.h>
 #include <private/color_params.h>
 #include <sys/stat.h>
+#include <utils/frame_timing.h>
 #include <algorithm>
 #include <bitset>
+#include <fstream>
 #include <map>
 #include <queue>
 #include <set>
@@ -225,6 +227,7 @@ class HWCDisplay : public DisplayEventHandler {
   virtual void GetPanelResolution(uint32_t *width, uint32_t *height);
   virtual void GetRealPanelResolution(uint32_t *width, uint32_t *height);
   virtual void Dump(std::ostringstream *os);
+  void DumpFrameTiming(std::ostringstream *os, bool reset);
 
   // CWB related methods
   virtual int GetCwbBufferResolution(CwbConfig *cwb_config, uint32_t *x_pixels,
@@ -489,6 +492,7 @@ class HWCDisplay : public DisplayEventHandler {
   static uint32_t throttling_refresh_rate_;
   // Maximum number of layers supported by display manager.
   static const uint32_t kMaxLayerCount = 32;
+  static const uint32_t kFrameRecordBufSize = 1 << 20;
   static bool mmrm_restricted_;
   HWCDisplay(CoreInterface *core_intf, BufferAllocator *buffer_allocator, HWCCallbacks *callbacks,
              HWCDisplayEventHandler *event_handler, qService::QService *qservice, DisplayType type,
@@ -546,6 +550,11 @@ class HWCDisplay : public DisplayEventHandler {
   void UpdateRefreshRate();
   void UpdateActiveConfig();
   void DumpInputBuffers(void);
+  void OpenFrameRecord();
+  void RecordFrame();
+  void BeginFrameTiming();
+  void EndFrameTiming();
+  GpuFallbackReason GetGpuFallbackReason();
   void RetrieveFences(shared_ptr<Fence> *out_retire_fence);
   void SetDrawMethod();
 
@@ -591,6 +600,14 @@ class HWCDisplay : public DisplayEventHandler {
   bool color_tranform_failed_ = false;
   HWCColorMode *color_mode_ = NULL;
   HWCToneMapper *tone_mapper_ = nullptr;
+  std::ofstream frame_record_;
+  std::vector<char> frame_record_buf_;
+  uint32_t frame_record_index_ = 0;
+  bool frame_recorded_ = false;
+  int enable_frame_timing_retire_ = 0;
+  shared_ptr<Fence> frame_timing_retire_fence_ = nullptr;
+  uint64_t frame_timing_commit_ns_ = 0;
+  uint64_t frame_timing_vsync_ns_ = 0;
   uint32_t num_configs_ = 0;
   int disable_hdr_handling_ = 0;  // disables HDR handling.
   int disable_sdr_histogram_ = 0;  // disables handling of SDR histogram data.
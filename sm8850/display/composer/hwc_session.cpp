@@ -2020,6 +2020,14 @@ android::status_t HWCSession::notifyCallback(uint32_t command, const android::Pa
     }
     break;
 
+    case qService::IQService::GET_FRAME_TIMING:
+      if (!input_parcel || !output_parcel) {
+        DLOGE("QService command = %d: input_parcel and output_parcel needed.", command);
+        break;
+      }
+      status = GetFrameTiming(input_parcel, output_parcel);
+      break;
+
     default:
       DLOGW("QService command = %d is not supported.", command);
       break;
@@ -2058,6 +2066,30 @@ android::status_t HWCSession::RetrieveDemuraTnFiles(const android::Parcel *input
   return 0;
 }
 
+android::status_t HWCSession::GetFrameTiming(const android::Parcel *input_parcel,
+                                             android::Parcel *output_parcel) {
+  auto display_id = static_cast<int>(input_parcel->readInt32());
+  bool reset = (input_parcel->readInt32() != 0);
+
+  int disp_idx = GetDisplayIndex(display_id);
+  if (disp_idx == -1) {
+    DLOGE("Invalid display = %d", display_id);
+    return -EINVAL;
+  }
+
+  SEQUENCE_WAIT_SCOPE_LOCK(locker_[disp_idx]);
+  if (!hwc_display_[disp_idx]) {
+    DLOGW("Display = %d is not connected.", disp_idx);
+    return -ENODEV;
+  }
+
+  std::ostringstream os;
+  hwc_display_[disp_idx]->DumpFrameTiming(&os, reset);
+  output_parcel->writeCString(os.str().c_str());
+
+  return 0;
+}
+
 android::status_t HWCSession::getComposerStatus() {
   return is_composer_up_;
 }
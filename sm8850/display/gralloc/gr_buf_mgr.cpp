@@ -40,8 +40,10 @@
 
 #include "gr_adreno_info.h"
 #include "gr_buf_descriptor.h"
+#include "gr_layout_cache.h"
 #include "gr_utils.h"
 #include "qd_utils.h"
+#include "qdMetaDataMapCache.h"
 #include "color_extensions.h"
 
 static bool enable_logs = false;
@@ -263,7 +265,6 @@ int BufferManager::GetCustomDimensions(private_handle_t *hnd, int *stride, int *
 }
 
 BufferManager::BufferManager() : next_id_(0) {
-  handles_map_.clear();
   allocator_ = new Allocator();
   enable_logs = property_get_bool(ENABLE_LOGS_PROP, 0);
 }
@@ -284,6 +285,7 @@ void BufferManager::SetGrallocDebugProperties(gralloc::GrallocProperties props)
   if (AdrenoMemInfo::GetInstance()) {
     AdrenoMemInfo::GetInstance()->AdrenoSetProperties(props);
   }
+  BufferLayoutCache::GetInstance()->Clear();
 }
 
 Error BufferManager::FreeBuffer(std::shared_ptr<Buffer> buf) {
@@ -330,8 +332,8 @@ Error BufferManager::ValidateBufferSize(private_handle_t const *hnd, BufferInfo
   return Error::NONE;
 }
 
-void BufferManager::RegisterHandleLocked(const private_handle_t *hnd, int ion_handle,
-                                         int ion_handle_meta) {
+void BufferManager::RegisterHandle(const private_handle_t *hnd, int ion_handle,
+                                   int ion_handle_meta) {
   auto buffer = std::make_shared<Buffer>(hnd, ion_handle, ion_handle_meta);
 
   if (hnd->base_metadata) {
@@ -357,7 +359,9 @@ void BufferManager::RegisterHandleLocked(const private_handle_t *hnd, int ion_ha
 #endif
   }
 
-  handles_map_.emplace(std::make_pair(hnd, buffer));
+  HandleShard &shard = GetShard(hnd);
+  std::lock_guard<std::mutex> shard_lock(shard.lock);
+  shard.handles_map.emplace(std::make_pair(hnd, buffer));
 }
 
 Error BufferManager::ImportHandleLocked(private_handle_t *hnd) {
@@ -390,7 +394,7 @@ Error BufferManager::ImportHandleLocked(private_handle_t *hnd) {
     return Error::BAD_BUFFER;
   }
 
-  RegisterHandleLocked(hnd, ion_handle, ion_handle_meta);
+  RegisterHandle(hnd, ion_handle, ion_handle_meta);
   allocated_ += hnd->size;
   if (allocated_ >= kAllocThreshold) {
     kAllocThreshold += kMemoryOffset;
@@ -399,16 +403,58 @@ Error BufferManager::ImportHandleLocked(private_handle_t *hnd) {
   return Error::NONE;
 }
 
-std::shared_ptr<BufferManager::Buffer> BufferManager::GetBufferFromHandleLocked(
+BufferManager::HandleShard &BufferManager::GetShard(const private_handle_t *hnd) {
+  // Handles are heap allocated, drop the alignment bits before picking a shard
+  auto key = reinterpret_cast<uintptr_t>(hnd);
+  return shards_[((key >> 4) ^ (key >> 12)) % kNumHandleShards];
+}
+
+std::shared_ptr<BufferManager::Buffer> BufferManager::GetBufferFromHandle(
     const private_handle_t *hnd) {
-  auto it = handles_map_.find(hnd);
-  if (it != handles_map_.end()) {
+  HandleShard &shard = GetShard(hnd);
+  std::lock_guard<std::mutex> shard_lock(shard.lock);
+  auto it = shard.handles_map.find(hnd);
+  if (it != shard.handles_map.end()) {
     return it->second;
   } else {
     return nullptr;
   }
 }
 
+std::shared_ptr<BufferManager::Buffer> BufferManager::AcquireBuffer(
+    const private_handle_t *hnd, std::unique_lock<std::mutex> *buf_lock) {
+  auto buf = GetBufferFromHandle(hnd);
+  if (buf == nullptr) {
+    return nullptr;
+  }
+
+  *buf_lock = std::unique_lock<std::mutex>(buf->lock);
+  if (buf->released) {
+    buf_lock->unlock();
+    return nullptr;
+  }
+  return buf;
+}
+
+void BufferManager::ForEachBuffer(
+    const std::function<void(const std::shared_ptr<Buffer> &)> &fn) {
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> shard_lock(shard.lock);
+    for (auto &it : shard.handles_map) {
+      fn(it.second);
+    }
+  }
+}
+
+size_t BufferManager::GetBufferCount() {
+  size_t count = 0;
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> shard_lock(shard.lock);
+    count += shard.handles_map.size();
+  }
+  return count;
+}
+
 Error BufferManager::MapBuffer(private_handle_t const *handle) {
   private_handle_t *hnd = const_cast<private_handle_t *>(handle);
   ALOGD_IF(enable_logs, "Map buffer handle:%p id: %" PRIu64, hnd, hnd->id);
@@ -422,8 +468,7 @@ Error BufferManager::MapBuffer(private_handle_t const *handle) {
 }
 
 Error BufferManager::IsBufferImported(const private_handle_t *hnd) {
-  std::lock_guard<std::mutex> lock(buffer_lock_);
-  auto buf = GetBufferFromHandleLocked(hnd);
+  auto buf = GetBufferFromHandle(hnd);
   if (buf != nullptr) {
     return Error::NONE;
   }
@@ -432,40 +477,65 @@ Error BufferManager::IsBufferImported(const private_handle_t *hnd) {
 
 Error BufferManager::RetainBuffer(private_handle_t const *hnd) {
   ALOGD_IF(enable_logs, "Retain buffer handle:%p id: %" PRIu64, hnd, hnd->id);
-  auto err = Error::NONE;
+  HandleShard &shard = GetShard(hnd);
+  auto retain_registered = [&shard, hnd]() {
+    std::lock_guard<std::mutex> shard_lock(shard.lock);
+    auto it = shard.handles_map.find(hnd);
+    if (it == shard.handles_map.end()) {
+      return false;
+    }
+    it->second->IncRef();
+    return true;
+  };
+
+  if (retain_registered()) {
+    return Error::NONE;
+  }
+
+  // First reference in this process, import under the topology lock and
+  // recheck in case another thread imported the same handle meanwhile
   std::lock_guard<std::mutex> lock(buffer_lock_);
-  auto buf = GetBufferFromHandleLocked(hnd);
-  if (buf != nullptr) {
-    buf->IncRef();
-  } else {
-    private_handle_t *handle = const_cast<private_handle_t *>(hnd);
-    err = ImportHandleLocked(handle);
+  if (retain_registered()) {
+    return Error::NONE;
   }
-  return err;
+  private_handle_t *handle = const_cast<private_handle_t *>(hnd);
+  return ImportHandleLocked(handle);
 }
 
 Error BufferManager::ReleaseBuffer(private_handle_t const *hnd) {
   ALOGD_IF(enable_logs, "Release buffer handle:%p", hnd);
-  std::lock_guard<std::mutex> lock(buffer_lock_);
-  auto buf = GetBufferFromHandleLocked(hnd);
-  if (buf == nullptr) {
-    ALOGE("Could not find handle: %p", hnd);
-    return Error::BAD_BUFFER;
-  } else {
-    if (buf->DecRef()) {
-      handles_map_.erase(hnd);
-      // Unmap, close ion handle and close fd
-      if (allocated_ >= hnd->size) {
-        allocated_ -= hnd->size;
-      }
-      FreeBuffer(buf);
+  std::shared_ptr<Buffer> buf;
+  {
+    HandleShard &shard = GetShard(hnd);
+    std::lock_guard<std::mutex> shard_lock(shard.lock);
+    auto it = shard.handles_map.find(hnd);
+    if (it == shard.handles_map.end()) {
+      ALOGE("Could not find handle: %p", hnd);
+      return Error::BAD_BUFFER;
+    }
+    if (!it->second->DecRef()) {
+      return Error::NONE;
     }
+    buf = it->second;
+    shard.handles_map.erase(it);
   }
+
+  // Drop the metadata mappings qdMetaData cached for the buffer in this process
+  purgeMetaDataMapCache(hnd->id);
+
+  // Wait for in-flight operations on this buffer before tearing it down
+  std::lock_guard<std::mutex> lock(buffer_lock_);
+  std::lock_guard<std::mutex> buf_lock(buf->lock);
+  buf->released = true;
+  // Unmap, close ion handle and close fd
+  if (allocated_ >= hnd->size) {
+    allocated_ -= hnd->size;
+  }
+  FreeBuffer(buf);
   return Error::NONE;
 }
 
 Error BufferManager::LockBuffer(const private_handle_t *hnd, uint64_t usage) {
-  std::lock_guard<std::mutex> lock(buffer_lock_);
   auto err = Error::NONE;
   ALOGD_IF(enable_logs, "LockBuffer buffer handle:%p id: %" PRIu64, hnd, hnd->id);
 
@@ -474,7 +544,8 @@ Error BufferManager::LockBuffer(const private_handle_t *hnd, uint64_t usage) {
     return Error::BAD_VALUE;
   }
 
-  auto buf = GetBufferFromHandleLocked(hnd);
+  std::unique_lock<std::mutex> buf_lock;
+  auto buf = AcquireBuffer(hnd, &buf_lock);
   if (buf == nullptr) {
     return Error::BAD_BUFFER;
   }
@@ -507,11 +578,11 @@ Error BufferManager::LockBuffer(const private_handle_t *hnd, uint64_t usage) {
 }
 
 Error BufferManager::FlushBuffer(const private_handle_t *handle) {
-  std::lock_guard<std::mutex> lock(buffer_lock_);
   auto status = Error::NONE;
 
   private_handle_t *hnd = const_cast<private_handle_t *>(handle);
-  auto buf = GetBufferFromHandleLocked(hnd);
+  std::unique_lock<std::mutex> buf_lock;
+  auto buf = AcquireBuffer(hnd, &buf_lock);
   if (buf == nullptr) {
     return Error::BAD_BUFFER;
   }
@@ -525,11 +596,11 @@ Error BufferManager::FlushBuffer(const private_handle_t *handle) {
 }
 
 Error BufferManager::RereadBuffer(const private_handle_t *handle) {
-  std::lock_guard<std::mutex> lock(buffer_lock_);
   auto status = Error::NONE;
 
   private_handle_t *hnd = const_cast<private_handle_t *>(handle);
-  auto buf = GetBufferFromHandleLocked(hnd);
+  std::unique_lock<std::mutex> buf_lock;
+  auto buf = AcquireBuffer(hnd, &buf_lock);
   if (buf == nullptr) {
     return Error::BAD_BUFFER;
   }
@@ -543,11 +614,11 @@ Error BufferManager::RereadBuffer(const private_handle_t *handle) {
 }
 
 Error BufferManager::UnlockBuffer(const private_handle_t *handle) {
-  std::lock_guard<std::mutex> lock(buffer_lock_);
   auto status = Error::NONE;
 
   private_handle_t *hnd = const_cast<private_handle_t *>(handle);
-  auto buf = GetBufferFromHandleLocked(hnd);
+  std::unique_lock<std::mutex> buf_lock;
+  auto buf = AcquireBuffer(hnd, &buf_lock);
   if (buf == nullptr) {
     return Error::BAD_BUFFER;
   }
@@ -600,7 +671,6 @@ Error BufferManager::AllocateBuffer(const BufferDescriptor &descriptor, buffer_h
                                     unsigned int bufferSize, bool testAlloc) {
   if (!handle)
     return Error::BAD_BUFFER;
-  std::lock_guard<std::mutex> buffer_lock(buffer_lock_);
 
   uint64_t reserved_size = descriptor.GetReservedSize();
   uint64_t usage = descriptor.GetUsage();
@@ -640,6 +710,8 @@ Error BufferManager::AllocateBuffer(const BufferDescriptor &descriptor, buffer_h
     return Error::NONE;
   }
 
+  std::lock_guard<std::mutex> buffer_lock(buffer_lock_);
+
   size = (bufferSize >= size) ? bufferSize : size;
   uint64_t flags = 0;
   auto page_size = UINT(getpagesize());
@@ -727,7 +799,7 @@ Error BufferManager::AllocateBuffer(const BufferDescriptor &descriptor, buffer_h
 
   *handle = hnd;
 
-  RegisterHandleLocked(hnd, data.ion_handle, e_data.ion_handle);
+  RegisterHandle(hnd, data.ion_handle, e_data.ion_handle);
   ALOGD_IF(enable_logs, "Allocated buffer handle: %p id: %" PRIu64, hnd, hnd->id);
   if (enable_logs) {
     private_handle_t::Dump(hnd);
@@ -755,10 +827,9 @@ void BufferManager::BuffersDump() {
   }
   fs << "============================" << std::endl;
   fs << timeStamp << std::endl;
-  fs << "Total layers = " << handles_map_.size() << std::endl;
+  fs << "Total layers = " << GetBufferCount() << std::endl;
   uint64_t totalAllocationSize = 0;
-  for (auto it : handles_map_) {
-    auto buf = it.second;
+  ForEachBuffer([&](const std::shared_ptr<Buffer> &buf) {
     auto hnd = buf->handle;
     auto metadata = reinterpret_cast<MetaData_t *>(hnd->base_metadata);
     fs << std::setw(80) << "Client:" << (metadata ? metadata->name : "No name");
@@ -766,7 +837,7 @@ void BufferManager::BuffersDump() {
        << hnd->height;
     fs << std::setw(20) << "Size: " << std::setw(9) << hnd->size << std::endl;
     totalAllocationSize += hnd->size;
-  }
+  });
   fs << "Total allocation  = " << totalAllocationSize / 1024 << "KiB" << std::endl;
   file_dump_.position = fs.tellp();
   if (file_dump_.position > (20 * 1024 * 1024)) {
@@ -776,9 +847,7 @@ void BufferManager::BuffersDump() {
 }
 
 Error BufferManager::Dump(std::ostringstream *os) {
-  std::lock_guard<std::mutex> buffer_lock(buffer_lock_);
-  for (auto it : handles_map_) {
-    auto buf = it.second;
+  ForEachBuffer([os](const std::shared_ptr<Buffer> &buf) {
     auto hnd = buf->handle;
     *os << "handle id: " << std::setw(4) << hnd->id;
     *os << " fd: " << std::setw(3) << hnd->fd;
@@ -796,30 +865,29 @@ Error BufferManager::Dump(std::ostringstream *os) {
     *os << " format: "
         << "0x" << std::setw(8) << hnd->format;
     *os << std::dec << std::setfill(' ') << std::endl;
-  }
+  });
+  BufferLayoutCache::GetInstance()->Dump(os);
   return Error::NONE;
 }
 
-// Get list of private handles in handles_map_
+// Get list of registered private handles
 Error BufferManager::GetAllHandles(std::vector<const private_handle_t *> *out_handle_list) {
-  std::lock_guard<std::mutex> lock(buffer_lock_);
-  if (handles_map_.empty()) {
+  ForEachBuffer([out_handle_list](const std::shared_ptr<Buffer> &buf) {
+    out_handle_list->push_back(buf->handle);
+  });
+  if (out_handle_list->empty()) {
     return Error::NO_RESOURCES;
   }
-  out_handle_list->reserve(handles_map_.size());
-  for (auto handle : handles_map_) {
-    out_handle_list->push_back(handle.first);
-  }
   return Error::NONE;
 }
 
 Error BufferManager::GetReservedRegion(private_handle_t *handle, void **reserved_region,
                                        uint64_t *reserved_region_size) {
-  std::lock_guard<std::mutex> lock(buffer_lock_);
   if (!handle)
     return Error::BAD_BUFFER;
 
-  auto buf = GetBufferFromHandleLocked(handle);
+  std::unique_lock<std::mutex> buf_lock;
+  auto buf = AcquireBuffer(handle, &buf_lock);
   if (buf == nullptr)
     return Error::BAD_BUFFER;
   if (!handle->base_metadata) {
@@ -835,11 +903,11 @@ Error BufferManager::GetReservedRegion(private_handle_t *handle, void **reserved
 Error BufferManager::GetCustomContentMdRegion(private_handle_t *handle,
                                             void **custom_content_md_region,
                                             uint64_t *custom_content_md_region_size) {
-  std::lock_guard<std::mutex> lock(buffer_lock_);
   if (!handle)
     return Error::BAD_BUFFER;
 
-  auto buf = GetBufferFromHandleLocked(handle);
+  std::unique_lock<std::mutex> buf_lock;
+  auto buf = AcquireBuffer(handle, &buf_lock);
   if (buf == nullptr)
     return Error::BAD_BUFFER;
   if (!handle->base_metadata) {
@@ -854,10 +922,11 @@ Error BufferManager::GetCustomContentMdRegion(private_handle_t *handle,
 
 Error BufferManager::GetMetadataValue(private_handle_t *handle, int64_t metadatatype_value,
                                       void *param) {
-  std::lock_guard<std::mutex> lock(buffer_lock_);
   if (!handle)
     return Error::BAD_BUFFER;
-  auto buf = GetBufferFromHandleLocked(handle);
+
+  std::unique_lock<std::mutex> buf_lock;
+  auto buf = AcquireBuffer(handle, &buf_lock);
   if (buf == nullptr)
     return Error::BAD_BUFFER;
 
@@ -903,10 +972,11 @@ static Error GetCustomMetadataHelper(void *custom_content_md_region_ptr,
 
 Error BufferManager::GetMetadata(private_handle_t *handle, int64_t metadatatype_value,
                                  hidl_vec<uint8_t> *out) {
-  std::lock_guard<std::mutex> lock(buffer_lock_);
   if (!handle)
     return Error::BAD_BUFFER;
-  auto buf = GetBufferFromHandleLocked(handle);
+
+  std::unique_lock<std::mutex> buf_lock;
+  auto buf = AcquireBuffer(handle, &buf_lock);
   if (buf == nullptr)
     return Error::BAD_BUFFER;
 
@@ -1415,12 +1485,11 @@ Error BufferManager::GetMetadata(private_handle_t *handle, int64_t metadatatype_
 
 Error BufferManager::SetMetadata(private_handle_t *handle, int64_t metadatatype_value,
                                  hidl_vec<uint8_t> in) {
-  std::lock_guard<std::mutex> lock(buffer_lock_);
-
   if (!handle)
     return Error::BAD_BUFFER;
 
-  auto buf = GetBufferFromHandleLocked(handle);
+  std::unique_lock<std::mutex> buf_lock;
+  auto buf = AcquireBuffer(handle, &buf_lock);
   if (buf == nullptr)
     return Error::BAD_BUFFER;
 
@@ -26,6 +26,7 @@
 
 #include <pthread.h>
 
+#include <functional>
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
@@ -73,17 +74,23 @@ class BufferManager {
   // Imports the ion fds into the current process. Returns an error for invalid handles
   Error ImportHandleLocked(private_handle_t *hnd);
 
-  // Creates a Buffer from the valid private handle and adds it to the map
-  void RegisterHandleLocked(const private_handle_t *hnd, int ion_handle, int ion_handle_meta);
+  // Creates a Buffer from the valid private handle and adds it to its registry shard
+  void RegisterHandle(const private_handle_t *hnd, int ion_handle, int ion_handle_meta);
 
   // Wrapper structure over private handle
   // Values associated with the private handle
   // that do not need to go over IPC can be placed here
   // This structure is also not expected to be ABI stable
   // unlike private_handle_t
+  // ref_count is guarded by the owning shard's lock, everything else that is
+  // mutated after registration by the per-buffer lock
   struct Buffer {
     const private_handle_t *handle = nullptr;
     int ref_count = 1;
+    std::mutex lock;
+    // Set once the buffer is unregistered, under lock, so in-flight
+    // operations holding a reference bail out instead of touching freed memory
+    bool released = false;
     // Hold the main and metadata ion handles
     // Freed from the allocator process
     // and unused in the mapping process
@@ -103,11 +110,28 @@ class BufferManager {
 
   Error FreeBuffer(std::shared_ptr<Buffer> buf);
 
+  // Handles are spread over independently locked shards so that lookups from
+  // concurrent mapper clients do not serialize on a single mutex
+  static constexpr size_t kNumHandleShards = 16;
+  struct HandleShard {
+    std::mutex lock;
+    std::unordered_map<const private_handle_t *, std::shared_ptr<Buffer>> handles_map = {};
+  };
+
+  HandleShard &GetShard(const private_handle_t *hnd);
   // Get the wrapper Buffer object from the handle, returns nullptr if handle is not found
-  std::shared_ptr<Buffer> GetBufferFromHandleLocked(const private_handle_t *hnd);
+  std::shared_ptr<Buffer> GetBufferFromHandle(const private_handle_t *hnd);
+  // Locks the buffer for a mapper operation, returns nullptr if handle is not registered
+  std::shared_ptr<Buffer> AcquireBuffer(const private_handle_t *hnd,
+                                        std::unique_lock<std::mutex> *buf_lock);
+  // Invokes fn for every registered buffer, one shard lock at a time
+  void ForEachBuffer(const std::function<void(const std::shared_ptr<Buffer> &)> &fn);
+  size_t GetBufferCount();
+
   Allocator *allocator_ = NULL;
+  // Serializes topology changes: allocation, import and final release
   std::mutex buffer_lock_;
-  std::unordered_map<const private_handle_t *, std::shared_ptr<Buffer>> handles_map_ = {};
+  HandleShard shards_[kNumHandleShards];
   std::atomic<uint64_t> next_id_;
   uint64_t allocated_ = 0;
   uint64_t kAllocThreshold = (uint64_t)1*1024*1024*1024;
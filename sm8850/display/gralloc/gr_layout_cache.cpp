@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <log/log.h>
+#include <string.h>
+
+#include <algorithm>
+#include <functional>
+
+#include "gr_layout_cache.h"
+
+using std::lock_guard;
+using std::mutex;
+
+namespace gralloc {
+
+BufferLayoutCache *BufferLayoutCache::GetInstance() {
+  static BufferLayoutCache *instance = new BufferLayoutCache();
+  return instance;
+}
+
+size_t BufferLayoutCache::KeyHash::operator()(const Key &key) const {
+  size_t hash = std::hash<uint64_t>()(key.usage);
+  auto combine = [&hash](uint64_t value) {
+    hash ^= std::hash<uint64_t>()(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  };
+  combine(static_cast<uint32_t>(key.width));
+  combine(static_cast<uint32_t>(key.height));
+  combine(static_cast<uint32_t>(key.format));
+  combine(static_cast<uint32_t>(key.layer_count));
+  return hash;
+}
+
+BufferLayoutCache::Key BufferLayoutCache::MakeKey(const BufferInfo &info) {
+  return Key{info.width, info.height, info.format, info.layer_count, info.usage};
+}
+
+bool BufferLayoutCache::Lookup(const BufferInfo &info, unsigned int *size, unsigned int *alignedw,
+                               unsigned int *alignedh, GraphicsMetadata *graphics_metadata) {
+  lock_guard<mutex> lock(lock_);
+  auto it = entries_.find(MakeKey(info));
+  if (it == entries_.end()) {
+    misses_++;
+    return false;
+  }
+
+  Entry &entry = it->second;
+  lru_.splice(lru_.begin(), lru_, entry.lru_pos);
+  hits_++;
+
+  *size = entry.size;
+  *alignedw = entry.alignedw;
+  *alignedh = entry.alignedh;
+  if (graphics_metadata && !entry.graphics_metadata.empty()) {
+    graphics_metadata->size = static_cast<uint32_t>(entry.graphics_metadata.size());
+    memcpy(graphics_metadata->data, entry.graphics_metadata.data(),
+           entry.graphics_metadata.size());
+  }
+
+  return true;
+}
+
+void BufferLayoutCache::Insert(const BufferInfo &info, unsigned int size, unsigned int alignedw,
+                               unsigned int alignedh, const GraphicsMetadata *graphics_metadata) {
+  Key key = MakeKey(info);
+  lock_guard<mutex> lock(lock_);
+  if (entries_.find(key) != entries_.end()) {
+    return;
+  }
+
+  if (entries_.size() >= kMaxEntries) {
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+    evictions_++;
+  }
+
+  Entry entry;
+  entry.size = size;
+  entry.alignedw = alignedw;
+  entry.alignedh = alignedh;
+  if (graphics_metadata && graphics_metadata->size) {
+    size_t blob_size = std::min(static_cast<size_t>(graphics_metadata->size),
+                                sizeof(graphics_metadata->data));
+    auto blob = reinterpret_cast<const uint8_t *>(graphics_metadata->data);
+    entry.graphics_metadata.assign(blob, blob + blob_size);
+  }
+
+  lru_.push_front(key);
+  entry.lru_pos = lru_.begin();
+  entries_.emplace(key, std::move(entry));
+}
+
+void BufferLayoutCache::Clear() {
+  lock_guard<mutex> lock(lock_);
+  entries_.clear();
+  lru_.clear();
+}
+
+void BufferLayoutCache::Dump(std::ostringstream *os) {
+  lock_guard<mutex> lock(lock_);
+  *os << "layout cache entries: " << entries_.size() << "/" << kMaxEntries;
+  *os << " hits: " << hits_ << " misses: " << misses_ << " evictions: " << evictions_;
+  *os << std::endl;
+}
+
+}  // namespace gralloc
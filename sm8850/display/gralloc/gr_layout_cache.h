@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __GR_LAYOUT_CACHE_H__
+#define __GR_LAYOUT_CACHE_H__
+
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include "gr_utils.h"
+
+namespace gralloc {
+
+/*
+ * Bounded LRU cache of buffer layouts keyed by the normalized descriptor.
+ * Holds the buffer size, aligned dimensions and, for buffers sized through the
+ * Adreno size API, the populated graphics metadata blob, so that repeated
+ * allocations and IsSupported queries of the same descriptor skip the
+ * alignment, UBWC and Adreno computations.
+ */
+class BufferLayoutCache {
+ public:
+  static BufferLayoutCache *GetInstance();
+
+  /*
+   * Function to look up a previously computed layout.
+   * graphics_metadata may be null when the caller does not need it.
+   *
+   * @return true  : layout found and copied out
+   *         false : layout not cached
+   */
+  bool Lookup(const BufferInfo &info, unsigned int *size, unsigned int *alignedw,
+              unsigned int *alignedh, GraphicsMetadata *graphics_metadata);
+
+  /*
+   * Function to store a successfully computed layout, evicting the least
+   * recently used entry when the cache is full.
+   */
+  void Insert(const BufferInfo &info, unsigned int size, unsigned int alignedw,
+              unsigned int alignedh, const GraphicsMetadata *graphics_metadata);
+
+  // Drops all entries, used when properties affecting the layout change.
+  void Clear();
+
+  void Dump(std::ostringstream *os);
+
+ private:
+  struct Key {
+    int width;
+    int height;
+    int format;
+    int layer_count;
+    uint64_t usage;
+
+    bool operator==(const Key &other) const {
+      return width == other.width && height == other.height && format == other.format &&
+             layer_count == other.layer_count && usage == other.usage;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key &key) const;
+  };
+
+  struct Entry {
+    unsigned int size = 0;
+    unsigned int alignedw = 0;
+    unsigned int alignedh = 0;
+    // Valid graphics metadata bytes, empty when Adreno was not used for sizing
+    std::vector<uint8_t> graphics_metadata;
+    std::list<Key>::iterator lru_pos;
+  };
+
+  BufferLayoutCache() = default;
+  static Key MakeKey(const BufferInfo &info);
+
+  static constexpr size_t kMaxEntries = 64;
+
+  std::mutex lock_;
+  std::list<Key> lru_ = {};
+  std::unordered_map<Key, Entry, KeyHash> entries_ = {};
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
+};
+
+}  // namespace gralloc
+
+#endif  // __GR_LAYOUT_CACHE_H__
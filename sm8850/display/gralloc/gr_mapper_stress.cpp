@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+// Multi-threaded stress benchmark for the BufferManager mapper paths.
+// Every worker repeatedly retains, locks, unlocks, queries metadata of and
+// releases buffers from a shared pool, mimicking concurrent camera, codec
+// and composer clients, and the aggregate operation rate is reported.
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gr_buf_descriptor.h"
+#include "gr_buf_mgr.h"
+
+using gralloc::BufferDescriptor;
+using gralloc::BufferManager;
+using gralloc::Error;
+
+namespace {
+
+constexpr int kDefaultThreads = 8;
+constexpr int kDefaultBuffers = 64;
+constexpr int kDefaultSeconds = 5;
+
+struct alignas(64) WorkerStats {
+  uint64_t ops = 0;
+  uint64_t errors = 0;
+};
+
+void Usage(const char *name) {
+  printf("Usage: %s [-t threads] [-b buffers] [-s seconds]\n", name);
+}
+
+void Worker(BufferManager *buf_mgr, const std::vector<private_handle_t *> &handles, int seed,
+            const std::atomic<bool> &stop, WorkerStats *stats) {
+  uint64_t usage = BufferUsage::CPU_READ_OFTEN | BufferUsage::CPU_WRITE_OFTEN;
+  size_t index = static_cast<size_t>(seed);
+  while (!stop.load(std::memory_order_relaxed)) {
+    private_handle_t *hnd = handles[index % handles.size()];
+    hidl_vec<uint8_t> out;
+
+    if (buf_mgr->RetainBuffer(hnd) != Error::NONE) {
+      stats->errors++;
+      continue;
+    }
+    if (buf_mgr->LockBuffer(hnd, usage) != Error::NONE) {
+      stats->errors++;
+    }
+    if (buf_mgr->UnlockBuffer(hnd) != Error::NONE) {
+      stats->errors++;
+    }
+    if (buf_mgr->GetMetadata(hnd, (int64_t)StandardMetadataType::BUFFER_ID, &out) != Error::NONE) {
+      stats->errors++;
+    }
+    if (buf_mgr->ReleaseBuffer(hnd) != Error::NONE) {
+      stats->errors++;
+    }
+
+    stats->ops += 5;
+    index += 7;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int num_threads = kDefaultThreads;
+  int num_buffers = kDefaultBuffers;
+  int seconds = kDefaultSeconds;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "t:b:s:h")) != -1) {
+    switch (opt) {
+      case 't':
+        num_threads = atoi(optarg);
+        break;
+      case 'b':
+        num_buffers = atoi(optarg);
+        break;
+      case 's':
+        seconds = atoi(optarg);
+        break;
+      default:
+        Usage(argv[0]);
+        return -1;
+    }
+  }
+
+  if (num_threads < 1 || num_buffers < 1 || seconds < 1) {
+    Usage(argv[0]);
+    return -1;
+  }
+
+  BufferManager *buf_mgr = BufferManager::GetInstance();
+  std::vector<private_handle_t *> handles;
+  for (int i = 0; i < num_buffers; i++) {
+    BufferDescriptor descriptor;
+    descriptor.SetDimensions(256, 256);
+    descriptor.SetColorFormat(HAL_PIXEL_FORMAT_RGBA_8888);
+    descriptor.SetUsage(BufferUsage::CPU_READ_OFTEN | BufferUsage::CPU_WRITE_OFTEN);
+    descriptor.SetName("gralloc_mapper_stress");
+
+    buffer_handle_t handle = nullptr;
+    if (buf_mgr->AllocateBuffer(descriptor, &handle) != Error::NONE) {
+      printf("Failed to allocate buffer %d\n", i);
+      return -1;
+    }
+    auto hnd = const_cast<private_handle_t *>(static_cast<const private_handle_t *>(handle));
+    // Allocation leaves metadata unmapped, map it as an importing client would
+    if (gralloc::ValidateAndMap(hnd)) {
+      printf("Failed to map metadata of buffer %d\n", i);
+      return -1;
+    }
+    handles.push_back(hnd);
+  }
+
+  std::atomic<bool> stop(false);
+  std::vector<WorkerStats> stats(static_cast<size_t>(num_threads));
+  std::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_threads; i++) {
+    workers.emplace_back(Worker, buf_mgr, std::cref(handles), i, std::cref(stop), &stats[i]);
+  }
+
+  std::this_thread::sleep_for(std::chrono::seconds(seconds));
+  stop = true;
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  uint64_t total_ops = 0, total_errors = 0;
+  for (int i = 0; i < num_threads; i++) {
+    printf("thread %2d: %10" PRIu64 " ops %6" PRIu64 " errors\n", i, stats[i].ops,
+           stats[i].errors);
+    total_ops += stats[i].ops;
+    total_errors += stats[i].errors;
+  }
+  printf("threads: %d buffers: %d duration: %.2fs\n", num_threads, num_buffers, elapsed);
+  printf("total: %" PRIu64 " ops %" PRIu64 " errors, %.0f ops/s\n", total_ops, total_errors,
+         total_ops / elapsed);
+
+  for (auto hnd : handles) {
+    buf_mgr->ReleaseBuffer(hnd);
+  }
+
+  return total_errors ? -1 : 0;
+}
@@ -43,6 +43,7 @@
 
 #include "gr_adreno_info.h"
 #include "gr_camera_info.h"
+#include "gr_layout_cache.h"
 #include "gr_utils.h"
 #include "QtiGralloc.h"
 #include "color_extensions.h"
@@ -555,9 +556,18 @@ int GetBufferSizeAndDimensions(const BufferInfo &info, unsigned int *size, unsig
 
 int GetBufferSizeAndDimensions(const BufferInfo &info, unsigned int *size, unsigned int *alignedw,
                                unsigned int *alignedh, GraphicsMetadata *graphics_metadata) {
+  BufferLayoutCache *layout_cache = BufferLayoutCache::GetInstance();
+  if (layout_cache->Lookup(info, size, alignedw, alignedh, graphics_metadata)) {
+    return 0;
+  }
+
   int buffer_type = GetBufferType(info.format);
   if (CanUseAdrenoForSize(buffer_type, info.usage)) {
-    return GetGpuResourceSizeAndDimensions(info, size, alignedw, alignedh, graphics_metadata);
+    int err = GetGpuResourceSizeAndDimensions(info, size, alignedw, alignedh, graphics_metadata);
+    if (err) {
+      return err;
+    }
+    layout_cache->Insert(info, *size, *alignedw, *alignedh, graphics_metadata);
   } else {
     int err = GetAlignedWidthAndHeight(info, alignedw, alignedh);
     if (err) {
@@ -565,6 +575,9 @@ int GetBufferSizeAndDimensions(const BufferInfo &info, unsigned int *size, unsig
       return err;
     }
     *size = GetSize(info, *alignedw, *alignedh);
+    if (*size) {
+      layout_cache->Insert(info, *size, *alignedw, *alignedh, nullptr);
+    }
   }
   return 0;
 }
@@ -219,6 +219,10 @@
 #define PRIORITIZE_CLIENT_CWB                DISPLAY_PROP("prioritize_client_cwb")
 #define TRANSIENT_FPS_CYCLE_COUNT            DISPLAY_PROP("transient_fps_cycle_count")
 #define FORCE_LM_TO_FB_CONFIG                DISPLAY_PROP("force_lm_to_fb_config")
+// Directory to which per-display layer stack records for off-device replay are written
+#define FRAME_RECORD_PATH                    DISPLAY_PROP("frame_record_path")
+// Reads the retire fence signal time each frame to attribute retire latency in frame timing
+#define ENABLE_FRAME_TIMING_RETIRE           DISPLAY_PROP("enable_frame_timing_retire")
 
 // Add all other.properties above
 // End of property
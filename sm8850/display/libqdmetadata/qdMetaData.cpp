@@ -40,6 +40,13 @@
 #include <sys/mman.h>
 
 #include <cinttypes>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "qdMetaDataMapCache.h"
 
 static int colorMetaDataToColorSpace(ColorMetaData in, ColorSpace_t *out) {
   if (in.colorPrimaries == ColorPrimaries_BT601_6_525 ||
@@ -236,6 +243,30 @@ unsigned long getMetaDataSizeWithReservedRegion(uint64_t reserved_size) {
   return static_cast<unsigned long>(ROUND_UP_PAGESIZE(sizeof(MetaData_t) + reserved_size));
 }
 
+// Maps the metadata buffer behind fd, including the reserved region if any
+static int mapMetaData(int fd, void **out_base, size_t *out_size) {
+    auto size = getMetaDataSize();
+    void *base = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == reinterpret_cast<void*>(MAP_FAILED)) {
+        ALOGE("%s: metadata mmap failed - fd: %d err: %s", __func__, fd, strerror(errno));
+        return -1;
+    }
+    auto metadata = reinterpret_cast<MetaData_t *>(base);
+    if (metadata->reservedSize) {
+        auto reserved_size = metadata->reservedSize;
+        munmap(base, size);
+        size = getMetaDataSizeWithReservedRegion(reserved_size);
+        base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == reinterpret_cast<void *>(MAP_FAILED)) {
+            ALOGE("%s: metadata mmap failed - fd: %d err: %s", __func__, fd, strerror(errno));
+            return -1;
+        }
+    }
+    *out_base = base;
+    *out_size = size;
+    return 0;
+}
+
 static int validateAndMap(private_handle_t* handle) {
     if (private_handle_t::validate(handle)) {
         ALOGE("%s: Private handle is invalid - handle:%p", __func__, handle);
@@ -247,30 +278,13 @@ static int validateAndMap(private_handle_t* handle) {
     }
 
     if (!handle->base_metadata) {
-        auto size = getMetaDataSize();
-        void *base = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED,
-                handle->fd_metadata, 0);
-        if (base == reinterpret_cast<void*>(MAP_FAILED)) {
-            ALOGE("%s: metadata mmap failed - handle:%p fd: %d err: %s",
-                __func__, handle, handle->fd_metadata, strerror(errno));
+        void *base = nullptr;
+        size_t size = 0;
+        if (mapMetaData(handle->fd_metadata, &base, &size)) {
+            ALOGE("%s: metadata map failed - handle:%p", __func__, handle);
             return -1;
         }
         handle->base_metadata = (uintptr_t) base;
-        auto metadata = reinterpret_cast<MetaData_t *>(handle->base_metadata);
-        if (metadata->reservedSize) {
-          auto reserved_size = metadata->reservedSize;
-          munmap(reinterpret_cast<void *>(handle->base_metadata), getMetaDataSize());
-          handle->base_metadata = 0;
-          size = getMetaDataSizeWithReservedRegion(reserved_size);
-          void *new_base =
-              mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, handle->fd_metadata, 0);
-          if (new_base == reinterpret_cast<void *>(MAP_FAILED)) {
-            ALOGE("%s: metadata mmap failed - handle:%p fd: %d err: %s", __func__, handle,
-                  handle->fd_metadata, strerror(errno));
-            return -1;
-          }
-          handle->base_metadata = (uintptr_t)new_base;
-        }
     }
     return 0;
 }
@@ -285,6 +299,185 @@ static void unmapAndReset(private_handle_t *handle) {
     }
 }
 
+// Process wide cache of metadata mappings used by the *AndUnmap helpers.
+// Per-frame callers would otherwise pay an mmap/munmap pair on every call.
+// Entries are keyed by the buffer id together with the metadata fd, so a
+// recycled fd number never aliases a different buffer. Entries are refcounted
+// while in use and the least recently used idle ones are unmapped once the
+// entry count or mapped size budget is exceeded, or as soon as gralloc frees
+// their buffer. Mappings are created and torn down outside of the lock.
+class MetaDataMapCache {
+ public:
+    static MetaDataMapCache *getInstance() {
+        static MetaDataMapCache *instance = new MetaDataMapCache();
+        return instance;
+    }
+
+    MetaData_t *acquire(private_handle_t *handle) {
+        Key key{handle->id, handle->fd_metadata};
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            auto it = mEntries.find(key);
+            if (it != mEntries.end()) {
+                mLru.splice(mLru.begin(), mLru, it->second.lruPos);
+                it->second.refCount++;
+                mStats.hits++;
+                return reinterpret_cast<MetaData_t *>(it->second.base);
+            }
+            mStats.misses++;
+        }
+
+        Entry entry;
+        if (mapMetaData(handle->fd_metadata, &entry.base, &entry.size)) {
+            return nullptr;
+        }
+
+        std::vector<Entry> victims;
+        void *base = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            mStats.mmaps++;
+            auto it = mEntries.find(key);
+            if (it != mEntries.end()) {
+                // Another thread mapped the buffer meanwhile, use its mapping.
+                mLru.splice(mLru.begin(), mLru, it->second.lruPos);
+                it->second.refCount++;
+                base = it->second.base;
+                victims.push_back(entry);
+                mStats.munmaps++;
+            } else {
+                entry.refCount = 1;
+                mLru.push_front(key);
+                entry.lruPos = mLru.begin();
+                mMappedSize += entry.size;
+                base = entry.base;
+                mEntries.emplace(key, entry);
+                evictLocked(&victims);
+            }
+        }
+        unmap(victims);
+        return reinterpret_cast<MetaData_t *>(base);
+    }
+
+    void release(private_handle_t *handle) {
+        Key key{handle->id, handle->fd_metadata};
+        std::vector<Entry> victims;
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            auto it = mEntries.find(key);
+            if (it != mEntries.end() && it->second.refCount > 0) {
+                it->second.refCount--;
+                if (!it->second.refCount && it->second.purged) {
+                    eraseLocked(it, &victims);
+                }
+            }
+            evictLocked(&victims);
+        }
+        unmap(victims);
+    }
+
+    void getStats(MetaDataMapCacheStats *stats) {
+        std::lock_guard<std::mutex> lock(mLock);
+        *stats = mStats;
+        stats->entries = static_cast<uint32_t>(mEntries.size());
+        stats->mappedSize = mMappedSize;
+    }
+
+    // Drops the mappings of a buffer being freed, those still in use once
+    // their last user releases them.
+    void purge(uint64_t id) {
+        std::vector<Entry> victims;
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            for (auto it = mEntries.begin(); it != mEntries.end();) {
+                auto next = std::next(it);
+                if (it->first.id == id) {
+                    if (it->second.refCount) {
+                        it->second.purged = true;
+                    } else {
+                        eraseLocked(it, &victims);
+                    }
+                }
+                it = next;
+            }
+        }
+        unmap(victims);
+    }
+
+ private:
+    struct Key {
+        uint64_t id;
+        int fd;
+        bool operator==(const Key &other) const { return id == other.id && fd == other.fd; }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const {
+            return std::hash<uint64_t>()(key.id) ^ (std::hash<int>()(key.fd) << 1);
+        }
+    };
+
+    struct Entry {
+        void *base = nullptr;
+        size_t size = 0;
+        uint32_t refCount = 0;
+        bool purged = false;
+        std::list<Key>::iterator lruPos;
+    };
+
+    using EntryMap = std::unordered_map<Key, Entry, KeyHash>;
+
+    static constexpr size_t kMaxEntries = 128;
+    static constexpr size_t kMaxMappedSize = 4 * 1024 * 1024;
+
+    MetaDataMapCache() = default;
+
+    void eraseLocked(EntryMap::iterator it, std::vector<Entry> *victims) {
+        victims->push_back(it->second);
+        mStats.munmaps++;
+        mMappedSize -= it->second.size;
+        mLru.erase(it->second.lruPos);
+        mEntries.erase(it);
+    }
+
+    void evictLocked(std::vector<Entry> *victims) {
+        auto pos = mLru.end();
+        while ((mEntries.size() > kMaxEntries || mMappedSize > kMaxMappedSize) &&
+               pos != mLru.begin()) {
+            --pos;
+            auto it = mEntries.find(*pos);
+            if (it->second.refCount) {
+                continue;
+            }
+            pos = std::next(pos);
+            eraseLocked(it, victims);
+            mStats.evictions++;
+        }
+    }
+
+    static void unmap(const std::vector<Entry> &victims) {
+        for (auto &entry : victims) {
+            munmap(entry.base, entry.size);
+        }
+    }
+
+    std::mutex mLock;
+    std::list<Key> mLru;
+    EntryMap mEntries;
+    size_t mMappedSize = 0;
+    MetaDataMapCacheStats mStats = {};
+};
+
+void getMetaDataMapCacheStats(MetaDataMapCacheStats *stats) {
+    if (stats) {
+        MetaDataMapCache::getInstance()->getStats(stats);
+    }
+}
+
+void purgeMetaDataMapCache(uint64_t bufferId) {
+    MetaDataMapCache::getInstance()->purge(bufferId);
+}
+
 int setMetaData(private_handle_t *handle, DispParamType paramType,
                 void *param) {
     auto err = validateAndMap(handle);
@@ -628,6 +821,16 @@ int copyMetaDataVaToVa(MetaData_t *src_data, MetaData_t *dst_data) {
 
 int setMetaDataAndUnmap(struct private_handle_t *handle, enum DispParamType paramType,
                         void *param) {
+    if (private_handle_t::validate(handle) == 0 && !handle->base_metadata &&
+        handle->fd_metadata >= 0) {
+        auto cache = MetaDataMapCache::getInstance();
+        auto data = cache->acquire(handle);
+        if (data) {
+            auto ret = setMetaDataVa(data, paramType, param);
+            cache->release(handle);
+            return ret;
+        }
+    }
     auto ret = setMetaData(handle, paramType, param);
     unmapAndReset(handle);
     return ret;
@@ -636,6 +839,16 @@ int setMetaDataAndUnmap(struct private_handle_t *handle, enum DispParamType para
 int getMetaDataAndUnmap(struct private_handle_t *handle,
                         enum DispFetchParamType paramType,
                         void *param) {
+    if (private_handle_t::validate(handle) == 0 && !handle->base_metadata &&
+        handle->fd_metadata >= 0) {
+        auto cache = MetaDataMapCache::getInstance();
+        auto data = cache->acquire(handle);
+        if (data) {
+            auto ret = getMetaDataVa(data, paramType, param);
+            cache->release(handle);
+            return ret;
+        }
+    }
     auto ret = getMetaData(handle, paramType, param);
     unmapAndReset(handle);
     return ret;
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef _QDMETADATA_MAP_CACHE_H
+#define _QDMETADATA_MAP_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Counters of the metadata mapping cache used by the *AndUnmap helpers */
+typedef struct MetaDataMapCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    /* metadata mappings created and torn down by the cache */
+    uint64_t mmaps;
+    uint64_t munmaps;
+    /* idle mappings dropped to stay within the cache budget */
+    uint64_t evictions;
+    uint32_t entries;
+    size_t mappedSize;
+} MetaDataMapCacheStats;
+
+void getMetaDataMapCacheStats(MetaDataMapCacheStats *stats);
+
+/*
+ * Unmaps the metadata mappings cached by the *AndUnmap helpers for a buffer
+ * that is being freed. Called by gralloc when it releases the buffer.
+ */
+void purgeMetaDataMapCache(uint64_t bufferId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _QDMETADATA_MAP_CACHE_H */
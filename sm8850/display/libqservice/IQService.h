@@ -126,6 +126,7 @@ public:
       SET_JITTER_CONFIG = 58,                  // Watchdog TE Jitter Configuration
       RETRIEVE_DEMURATN_FILES = 59,            // Retrieve DemuraTn files from TVM
       SET_DEMURA_STATE = 60,                   // Enable/disable demura feature
+      GET_FRAME_TIMING = 61,                   // Dump per phase frame timing and jank stats
       COMMAND_LIST_END = 400,
     };
 
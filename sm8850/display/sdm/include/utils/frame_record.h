@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __FRAME_RECORD_H__
+#define __FRAME_RECORD_H__
+
+#include <core/layer_stack.h>
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace sdm {
+
+/*
+ * Line oriented text format used to capture the layer stacks handed to SDM on target and feed
+ * them back through CoreInterface off device. Buffers are reduced to their descriptors, i.e.
+ * dimensions, format and flags; no pixel data or fences are kept.
+ *
+ *   frame <index> <layer count> <stack flags>
+ *   layer <composition> <blending> <alpha> <rotation> <flip h> <flip v>
+ *         <src l t r b> <dst l t r b> <format> <w> <h> <unaligned w> <unaligned h>
+ *         <buffer flags> <layer flags> <frame rate> <layer id>
+ */
+struct RecordedFrame {
+  uint32_t index = 0;
+  uint32_t stack_flags = 0;
+  std::vector<Layer> layers = {};
+};
+
+void WriteFrameRecord(uint32_t index, const LayerStack &layer_stack, std::ostream *os);
+
+// Returns false at end of stream or when the record is malformed.
+bool ReadFrameRecord(std::istream *is, RecordedFrame *frame);
+
+}  // namespace sdm
+
+#endif  // __FRAME_RECORD_H__
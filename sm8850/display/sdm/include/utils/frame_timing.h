@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __FRAME_TIMING_H__
+#define __FRAME_TIMING_H__
+
+#include <stdint.h>
+
+#include <atomic>
+#include <sstream>
+
+namespace sdm {
+
+// Phases of the display pipeline timed per frame. Phases recorded by SDM nest inside the composer
+// ones, e.g. kPhaseStrategy and kPhaseHWValidate run within kPhasePrepareLayerStack or
+// kPhasePresentOrValidate.
+enum FrameTimingPhase {
+  kPhasePresentOrValidate,    // HWCDisplay::CommitOrPrepare and CommitLayerStack
+  kPhasePrepareLayerStack,    // HWCDisplay::PrepareLayerStack
+  kPhaseStrategy,             // CompManager::Prepare, strategy selection and resource allocation
+  kPhaseHWValidate,           // HWDeviceDRM::Validate
+  kPhaseAtomicCommit,         // Atomic commit ioctl
+  kPhaseWaitOnPreviousFence,  // HWCDisplay::WaitOnPreviousFence
+  kPhaseRetireFence,          // Commit return to retire fence signal
+  kPhaseMax,
+};
+
+enum GpuFallbackReason {
+  kGpuFallbackNone,           // No layer composed by GPU
+  kGpuFallbackSkipLayer,      // Layer stack carries skip layers
+  kGpuFallbackClientRequest,  // SurfaceFlinger requested client composition
+  kGpuFallbackAnimation,      // Composition simplified while animating
+  kGpuFallbackStrategy,       // Strategy could not place all layers on pipes
+  kGpuFallbackMax,
+};
+
+/*
+ * Per display frame timing recorder. All state lives in preallocated arrays of relaxed atomics,
+ * so phases can be recorded from the composer and SDM threads without locks or allocations.
+ * The last kWindow frames feed the rolling histograms; frames that exceed the vsync period are
+ * attributed to their dominant phase and GPU fallback reason.
+ */
+class FrameTiming {
+ public:
+  // Returns the recorder of the display, claiming a free one on first use. Never returns null,
+  // displays beyond kMaxDisplays share the last recorder.
+  static FrameTiming *Get(int32_t display_id);
+  static uint64_t NowNs();  // CLOCK_MONOTONIC, the sync fence timestamp base
+
+  // Starts a new frame unless one is already open, e.g. Present following Validate.
+  void BeginFrame();
+  void Record(FrameTimingPhase phase, uint64_t duration_ns);
+  // Marks the composer phase the SDM phases recorded from now on nest in, returns the one it
+  // replaces. Use through ScopedFrameTiming.
+  FrameTimingPhase EnterPhase(FrameTimingPhase phase);
+  void ExitPhase(FrameTimingPhase previous);
+  void EndFrame(uint64_t vsync_period_ns, GpuFallbackReason reason);
+  // Retire latency of the last ended frame, known only once its fence has signaled.
+  void RecordRetire(uint64_t latency_ns, uint64_t vsync_period_ns);
+  void Reset();
+  void Dump(std::ostringstream *os);
+  uint64_t GetJankCount(FrameTimingPhase phase);
+
+  // Composer phases which contain the SDM ones.
+  static bool IsParentPhase(FrameTimingPhase phase) {
+    return phase == kPhasePresentOrValidate || phase == kPhasePrepareLayerStack;
+  }
+
+ private:
+  static constexpr uint32_t kMaxDisplays = 8;
+  static constexpr uint32_t kWindow = 256;
+  static constexpr uint32_t kNumBuckets = 16;  // log2(us) buckets, the last one open ended
+
+  struct Sample {
+    std::atomic<uint32_t> phase_us[kPhaseMax];
+    std::atomic<uint32_t> nested_us[kPhaseMax];  // Time of the SDM phases run within a parent
+    std::atomic<uint32_t> fallback;
+    std::atomic<uint32_t> jank_phase;  // kPhaseMax when the frame made its vsync
+  };
+
+  FrameTimingPhase DominantPhase(const Sample &sample);
+
+  std::atomic<int32_t> display_id_ {-1};
+  std::atomic<bool> frame_open_ {false};
+  std::atomic<uint32_t> active_parent_ {kPhaseMax};
+  std::atomic<uint64_t> frame_start_ns_ {0};
+  std::atomic<uint64_t> frames_ {0};
+  std::atomic<uint64_t> janky_frames_ {0};
+  std::atomic<uint64_t> jank_by_phase_[kPhaseMax] {};
+  std::atomic<uint64_t> jank_by_fallback_[kGpuFallbackMax] {};
+  std::atomic<uint64_t> fallback_frames_[kGpuFallbackMax] {};
+  Sample samples_[kWindow] {};
+};
+
+class ScopedFrameTiming {
+ public:
+  ScopedFrameTiming(int32_t display_id, FrameTimingPhase phase)
+    : timing_(FrameTiming::Get(display_id)), phase_(phase) {
+    if (FrameTiming::IsParentPhase(phase_)) {
+      previous_ = timing_->EnterPhase(phase_);
+    }
+    start_ns_ = FrameTiming::NowNs();
+  }
+  ~ScopedFrameTiming() {
+    timing_->Record(phase_, FrameTiming::NowNs() - start_ns_);
+    if (FrameTiming::IsParentPhase(phase_)) {
+      timing_->ExitPhase(previous_);
+    }
+  }
+
+ private:
+  FrameTiming *timing_;
+  FrameTimingPhase phase_;
+  FrameTimingPhase previous_ = kPhaseMax;
+  uint64_t start_ns_;
+};
+
+}  // namespace sdm
+
+#endif  // __FRAME_TIMING_H__
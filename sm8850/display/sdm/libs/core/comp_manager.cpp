@@ -32,6 +32,7 @@
 #include <core/buffer_allocator.h>
 #include <utils/constants.h>
 #include <utils/debug.h>
+#include <utils/frame_timing.h>
 #include <set>
 #include <string>
 #include <vector>
@@ -378,6 +379,7 @@ DisplayError CompManager::Prepare(Handle display_ctx, DispLayerStack *disp_layer
                              reinterpret_cast<DisplayCompositionContext *>(display_ctx);
   Handle &display_resource_ctx = display_comp_ctx->display_resource_ctx;
   DisplayError error = kErrorUndefined;
+  ScopedFrameTiming frame_timing(display_comp_ctx->display_id, kPhaseStrategy);
 
   PrepareStrategyConstraints(display_ctx, disp_layer_stack);
   // Select a composition strategy, and try to allocate resources for it.
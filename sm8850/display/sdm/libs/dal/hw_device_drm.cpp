@@ -54,6 +54,7 @@
 #include <utils/constants.h>
 #include <utils/debug.h>
 #include <utils/formats.h>
+#include <utils/frame_timing.h>
 #include <utils/sys.h>
 #include <display/drm/sde_drm.h>
 #include <private/color_params.h>
@@ -1779,6 +1780,7 @@ void HWDeviceDRM::ClearSolidfillStages() {
 
 DisplayError HWDeviceDRM::Validate(HWLayersInfo *hw_layers_info) {
   DTRACE_SCOPED();
+  ScopedFrameTiming frame_timing(display_id_, kPhaseHWValidate);
 
   DisplayError err = kErrorNone;
   registry_.Register(hw_layers_info);
@@ -1886,7 +1888,10 @@ DisplayError HWDeviceDRM::AtomicCommit(HWLayersInfo *hw_layers_info) {
     }
   }
 
+  uint64_t commit_start_ns = FrameTiming::NowNs();
   int ret = drm_atomic_intf_->Commit(sync_commit, false /* retain_planes*/);
+  FrameTiming::Get(display_id_)->Record(kPhaseAtomicCommit,
+                                        FrameTiming::NowNs() - commit_start_ns);
   shared_ptr<Fence> release_fence = Fence::Create(INT(release_fence_fd), "release");
   shared_ptr<Fence> retire_fence = Fence::Create(INT(retire_fence_fd), "retire");
   if (ret) {
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/debug.h>
+#include <utils/formats.h>
+#include <utils/utils.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include "hw_device_sim.h"
+
+#define __CLASS__ "HWDeviceSim"
+
+namespace sdm {
+
+HWSimStats HWDeviceSim::stats_ = {};
+
+static uint64_t ElapsedNs(const std::chrono::steady_clock::time_point &start) {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count());
+}
+
+DisplayError HWDeviceSim::Init() {
+  const HWSimConfig &config = HWInfoSim::GetConfig();
+
+  DisplayError error = hw_info_intf_->GetHWResourceInfo(&hw_resource_);
+  if (error != kErrorNone) {
+    return error;
+  }
+
+  display_attributes_.x_pixels = config.panel_width;
+  display_attributes_.y_pixels = config.panel_height;
+  display_attributes_.x_dpi = 400.0f;
+  display_attributes_.y_dpi = 400.0f;
+  display_attributes_.fps = config.panel_fps;
+  display_attributes_.vsync_period_ns = UINT32(1000000000L / std::max(config.panel_fps, 1U));
+  display_attributes_.h_total = config.panel_width;
+  display_attributes_.v_total = config.panel_height;
+  display_attributes_.is_device_split = (config.panel_width > config.max_mixer_width);
+  display_attributes_.topology = display_attributes_.is_device_split ? kDualLM : kSingleLM;
+  display_attributes_.topology_num_split = display_attributes_.is_device_split ? 2 : 1;
+
+  mixer_attributes_.width = config.panel_width;
+  mixer_attributes_.height = config.panel_height;
+  mixer_attributes_.split_type = display_attributes_.is_device_split ? kDualSplit : kNoSplit;
+  mixer_attributes_.split_left = display_attributes_.is_device_split ? config.panel_width / 2 :
+                                                                       config.panel_width;
+
+  panel_info_.port = kPortDSI;
+  panel_info_.mode = kModeVideo;
+  panel_info_.is_primary_panel = (display_id_ == 0);
+  panel_info_.min_fps = config.panel_fps;
+  panel_info_.max_fps = config.panel_fps;
+  panel_info_.split_info.left_split = mixer_attributes_.split_left;
+  panel_info_.split_info.right_split = config.panel_width - mixer_attributes_.split_left;
+
+  DLOGI("Simulated display %d: %dx%d@%d", display_id_, config.panel_width, config.panel_height,
+        config.panel_fps);
+
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::GetDisplayId(int32_t *display_id) {
+  *display_id = display_id_;
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::GetActiveConfig(uint32_t *active_config) {
+  *active_config = 0;
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::GetDefaultConfig(uint32_t *default_config) {
+  *default_config = 0;
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::GetNumDisplayAttributes(uint32_t *count) {
+  *count = 1;
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::GetDisplayAttributes(uint32_t index,
+                                               HWDisplayAttributes *display_attributes) {
+  if (index != 0) {
+    return kErrorParameters;
+  }
+
+  *display_attributes = display_attributes_;
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::GetHWPanelInfo(HWPanelInfo *panel_info) {
+  *panel_info = panel_info_;
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::SetDisplayAttributes(uint32_t index) {
+  return (index == 0) ? kErrorNone : kErrorParameters;
+}
+
+DisplayError HWDeviceSim::SetDisplayAttributes(const HWDisplayAttributes &display_attributes) {
+  return kErrorNotSupported;
+}
+
+DisplayError HWDeviceSim::PowerOn(const HWQosData &qos_data, SyncPoints *sync_points) {
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::PowerOff(bool teardown, SyncPoints *sync_points) {
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::Doze(const HWQosData &qos_data, SyncPoints *sync_points) {
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::DozeSuspend(const HWQosData &qos_data, SyncPoints *sync_points) {
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::Standby(SyncPoints *sync_points) {
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::Validate(HWLayersInfo *hw_layers_info) {
+  const HWSimConfig &config = HWInfoSim::GetConfig();
+  auto start = std::chrono::steady_clock::now();
+  uint32_t num_pipes = 0;
+  uint64_t bandwidth_kbps = 0;
+  float fps = static_cast<float>(config.panel_fps);
+
+  uint32_t num_layers = UINT32(std::min(hw_layers_info->hw_layers.size(),
+                                        static_cast<size_t>(kMaxSDELayers)));
+  for (uint32_t i = 0; i < num_layers; i++) {
+    const Layer &layer = hw_layers_info->hw_layers.at(i);
+    HWLayerConfig &layer_config = hw_layers_info->config[i];
+    float bpp = GetBufferFormatBpp(layer.input_buffer.format);
+
+    for (HWPipeInfo *pipe : {&layer_config.left_pipe, &layer_config.right_pipe}) {
+      if (!pipe->valid) {
+        continue;
+      }
+      num_pipes++;
+      float width = pipe->src_roi.right - pipe->src_roi.left;
+      float height = pipe->src_roi.bottom - pipe->src_roi.top;
+      bandwidth_kbps += static_cast<uint64_t>(width * height * bpp * 8.0f * fps / 1000.0f);
+    }
+  }
+
+  stats_.validate_count++;
+  stats_.max_pipes = std::max(stats_.max_pipes, static_cast<uint64_t>(num_pipes));
+  stats_.max_bandwidth_kbps = std::max(stats_.max_bandwidth_kbps, bandwidth_kbps);
+
+  DisplayError error = kErrorNone;
+  uint32_t total_pipes = config.num_vig_pipe + config.num_dma_pipe;
+  if (num_pipes > total_pipes || num_layers > config.num_blending_stages ||
+      bandwidth_kbps > config.max_bandwidth_kbps) {
+    DLOGV_IF(kTagDriverConfig, "Rejected: pipes %d/%d layers %d/%d bw %" PRIu64 "/%" PRIu64,
+             num_pipes, total_pipes, num_layers, config.num_blending_stages, bandwidth_kbps,
+             config.max_bandwidth_kbps);
+    stats_.validate_rejects++;
+    error = kErrorResources;
+  }
+
+  stats_.validate_ns += ElapsedNs(start);
+  return error;
+}
+
+DisplayError HWDeviceSim::Commit(HWLayersInfo *hw_layers_info) {
+  auto start = std::chrono::steady_clock::now();
+
+  // Nothing is fetched, so every buffer is released as soon as it is committed.
+  for (Layer &layer : hw_layers_info->hw_layers) {
+    layer.input_buffer.release_fence = nullptr;
+  }
+  hw_layers_info->retire_fence = nullptr;
+  hw_layers_info->sync_handle = nullptr;
+
+  stats_.commit_count++;
+  stats_.commit_ns += ElapsedNs(start);
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::SetDisplayMode(const HWDisplayMode hw_display_mode) {
+  panel_info_.mode = hw_display_mode;
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::SetRefreshRate(uint32_t refresh_rate) {
+  return (refresh_rate == display_attributes_.fps) ? kErrorNone : kErrorNotSupported;
+}
+
+DisplayError HWDeviceSim::SetMixerAttributes(const HWMixerAttributes &mixer_attributes) {
+  mixer_attributes_ = mixer_attributes;
+  return kErrorNone;
+}
+
+DisplayError HWDeviceSim::GetMixerAttributes(HWMixerAttributes *mixer_attributes) {
+  *mixer_attributes = mixer_attributes_;
+  return kErrorNone;
+}
+
+}  // namespace sdm
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __HW_DEVICE_SIM_H__
+#define __HW_DEVICE_SIM_H__
+
+#include <private/hw_interface.h>
+#include <private/hw_events_interface.h>
+#include <string>
+#include <vector>
+
+#include "hw_info_sim.h"
+
+namespace sdm {
+
+// Counters accumulated by HWDeviceSim across all simulated displays.
+struct HWSimStats {
+  uint64_t validate_count = 0;
+  uint64_t validate_rejects = 0;
+  uint64_t validate_ns = 0;
+  uint64_t commit_count = 0;
+  uint64_t commit_ns = 0;
+  uint64_t max_pipes = 0;           // Largest number of pipes staged in one frame
+  uint64_t max_bandwidth_kbps = 0;  // Largest fetch bandwidth estimated for one frame
+};
+
+// Display device backed by HWSimConfig rather than a DRM connector. Validate enforces the pipe,
+// blend stage and bandwidth limits of the configuration; Commit only accounts the frame.
+class HWDeviceSim : public HWInterface {
+ public:
+  HWDeviceSim(int32_t display_id, HWInfoInterface *hw_info_intf)
+    : display_id_(display_id), hw_info_intf_(hw_info_intf) { }
+  static const HWSimStats &GetStats() { return stats_; }
+  static void ResetStats() { stats_ = {}; }
+
+  virtual DisplayError Init();
+  virtual DisplayError Deinit() { return kErrorNone; }
+  virtual DisplayError GetDisplayId(int32_t *display_id);
+  virtual DisplayError GetActiveConfig(uint32_t *active_config);
+  virtual DisplayError GetDefaultConfig(uint32_t *default_config);
+  virtual DisplayError GetNumDisplayAttributes(uint32_t *count);
+  virtual DisplayError GetDisplayAttributes(uint32_t index,
+                                            HWDisplayAttributes *display_attributes);
+  virtual DisplayError GetHWPanelInfo(HWPanelInfo *panel_info);
+  virtual DisplayError SetDisplayAttributes(uint32_t index);
+  virtual DisplayError SetDisplayAttributes(const HWDisplayAttributes &display_attributes);
+  virtual DisplayError GetConfigIndex(char *mode, uint32_t *index) { return kErrorNotSupported; }
+  virtual DisplayError PowerOn(const HWQosData &qos_data, SyncPoints *sync_points);
+  virtual DisplayError PowerOff(bool teardown, SyncPoints *sync_points);
+  virtual DisplayError Doze(const HWQosData &qos_data, SyncPoints *sync_points);
+  virtual DisplayError DozeSuspend(const HWQosData &qos_data, SyncPoints *sync_points);
+  virtual DisplayError Standby(SyncPoints *sync_points);
+  virtual DisplayError Validate(HWLayersInfo *hw_layers_info);
+  virtual DisplayError Commit(HWLayersInfo *hw_layers_info);
+  virtual DisplayError Flush(HWLayersInfo *hw_layers_info) { return kErrorNone; }
+  virtual DisplayError GetPPFeaturesVersion(PPFeatureVersion *vers) { return kErrorNotSupported; }
+  virtual DisplayError SetPPFeature(PPFeatureInfo *feature) { return kErrorNotSupported; }
+  virtual DisplayError SetVSyncState(bool enable) { return kErrorNone; }
+  virtual void SetIdleTimeoutMs(uint32_t timeout_ms) { }
+  virtual DisplayError SetDisplayMode(const HWDisplayMode hw_display_mode);
+  virtual DisplayError SetRefreshRate(uint32_t refresh_rate);
+  virtual DisplayError SetPanelBrightness(int level) { return kErrorNone; }
+  virtual DisplayError GetHWScanInfo(HWScanInfo *scan_info) { return kErrorNotSupported; }
+  virtual DisplayError GetVideoFormat(uint32_t config_index, uint32_t *video_format) {
+    return kErrorNotSupported;
+  }
+  virtual DisplayError GetMaxCEAFormat(uint32_t *max_cea_format) { return kErrorNotSupported; }
+  virtual DisplayError SetCursorPosition(HWLayersInfo *hw_layers_info, int x, int y) {
+    return kErrorNotSupported;
+  }
+  virtual DisplayError OnMinHdcpEncryptionLevelChange(uint32_t min_enc_level) {
+    return kErrorNotSupported;
+  }
+  virtual DisplayError GetPanelBrightness(int *level) { return kErrorNotSupported; }
+  virtual DisplayError SetAutoRefresh(bool enable) { return kErrorNone; }
+  virtual DisplayError SetScaleLutConfig(HWScaleLutInfo *lut_info) { return kErrorNone; }
+  virtual DisplayError UnsetScaleLutConfig() { return kErrorNone; }
+  virtual DisplayError SetMixerAttributes(const HWMixerAttributes &mixer_attributes);
+  virtual DisplayError GetMixerAttributes(HWMixerAttributes *mixer_attributes);
+  virtual DisplayError DumpDebugData() { return kErrorNone; }
+  virtual DisplayError SetDppsFeature(void *payload, size_t size) { return kErrorNotSupported; }
+  virtual DisplayError GetDppsFeatureInfo(void *payload, size_t size) {
+    return kErrorNotSupported;
+  }
+  virtual DisplayError HandleSecureEvent(SecureEvent secure_event, const HWQosData &qos_data) {
+    return kErrorNone;
+  }
+  virtual DisplayError ControlIdlePowerCollapse(bool enable, bool synchronous) {
+    return kErrorNone;
+  }
+  virtual DisplayError SetDisplayDppsAdROI(void *payload) { return kErrorNotSupported; }
+  virtual DisplayError SetJitterConfig(uint32_t jitter_type, float value, uint32_t time) {
+    return kErrorNotSupported;
+  }
+  virtual DisplayError SetDynamicDSIClock(uint64_t bit_clk_rate) { return kErrorNotSupported; }
+  virtual DisplayError GetDynamicDSIClock(uint64_t *bit_clk_rate) { return kErrorNotSupported; }
+  virtual DisplayError GetDisplayIdentificationData(uint8_t *out_port, uint32_t *out_data_size,
+                                                    uint8_t *out_data) {
+    return kErrorNotSupported;
+  }
+  virtual DisplayError SetFrameTrigger(FrameTriggerMode mode) { return kErrorNotSupported; }
+  virtual DisplayError SetBLScale(uint32_t level) { return kErrorNotSupported; }
+  virtual DisplayError GetPanelBlMaxLvl(uint32_t *max_bl) { return kErrorNotSupported; }
+  virtual DisplayError SetPPConfig(void *payload, size_t size) { return kErrorNotSupported; }
+  virtual DisplayError GetPanelBrightnessBasePath(std::string *base_path) const {
+    return kErrorNotSupported;
+  }
+  virtual DisplayError SetBlendSpace(const PrimariesTransfer &blend_space) { return kErrorNone; }
+  virtual DisplayError EnableSelfRefresh(SelfRefreshState self_refresh_state) {
+    return kErrorNotSupported;
+  }
+  virtual PanelFeaturePropertyIntf *GetPanelFeaturePropertyIntf() { return nullptr; }
+  virtual DisplayError GetFeatureSupportStatus(const HWFeature feature, uint32_t *status) {
+    return kErrorNotSupported;
+  }
+  virtual void FlushConcurrentWriteback() { }
+  virtual DisplayError SetAlternateDisplayConfig(uint32_t *alt_config) {
+    return kErrorNotSupported;
+  }
+  virtual DisplayError GetQsyncFps(uint32_t *qsync_fps) { return kErrorNotSupported; }
+  virtual DisplayError UpdateTransferTime(uint32_t transfer_time) { return kErrorNotSupported; }
+  virtual DisplayError CancelDeferredPowerMode() { return kErrorNone; }
+  virtual void HandleCwbTeardown() { }
+
+ private:
+  static HWSimStats stats_;
+
+  int32_t display_id_ = -1;
+  HWInfoInterface *hw_info_intf_ = nullptr;
+  HWResourceInfo hw_resource_ = {};
+  HWDisplayAttributes display_attributes_ = {};
+  HWMixerAttributes mixer_attributes_ = {};
+  HWPanelInfo panel_info_ = {};
+};
+
+// Events are never raised by the simulated device; the client drives frames itself.
+class HWEventsSim : public HWEventsInterface {
+ public:
+  virtual DisplayError Init(int display_id, DisplayType display_type,
+                            HWEventHandler *event_handler, const std::vector<HWEvent> &event_list,
+                            const HWInterface *hw_intf) {
+    return kErrorNone;
+  }
+  virtual DisplayError Deinit() { return kErrorNone; }
+  virtual DisplayError SetEventState(HWEvent event, bool enable, void *aux = nullptr) {
+    return kErrorNone;
+  }
+};
+
+}  // namespace sdm
+
+#endif  // __HW_DEVICE_SIM_H__
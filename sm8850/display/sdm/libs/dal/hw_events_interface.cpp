@@ -32,6 +32,8 @@
 
 #include <vector>
 
+#include "hw_device_sim.h"
+
 #ifndef TARGET_HEADLESS
 #include "hw_events_drm.h"
 #endif
@@ -45,6 +47,11 @@ DisplayError HWEventsInterface::Create(int display_id, DisplayType display_type,
                                        const std::vector<HWEvent> &event_list,
                                        const HWInterface *hw_intf, HWEventsInterface **intf) {
   DisplayError error = kErrorNone;
+  if (HWInfoSim::IsEnabled()) {
+    *intf = new HWEventsSim();
+    return error;
+  }
+
 #ifndef TARGET_HEADLESS
   HWEventsInterface *hw_events = new HWEventsDRM();
 
@@ -30,6 +30,8 @@
 #include <utils/utils.h>
 #include <private/hw_info_interface.h>
 
+#include "hw_info_sim.h"
+
 #ifndef TARGET_HEADLESS
 #include "hw_info_drm.h"
 #endif
@@ -42,17 +44,21 @@ int32_t HWInfoInterface::ref_count_ = 0;
 HWInfoInterface* HWInfoInterface::intf_ = nullptr;
 
 DisplayError HWInfoInterface::Create(HWInfoInterface **intf) {
-#ifndef TARGET_HEADLESS
   if (ref_count_ > 0 && intf_) {
     ref_count_++;
     *intf = intf_;
     return kErrorNone;
   }
 
-  *intf = new HWInfoDRM();
+  if (HWInfoSim::IsEnabled()) {
+    *intf = new HWInfoSim();
+  } else {
+#ifndef TARGET_HEADLESS
+    *intf = new HWInfoDRM();
 #else
-  *intf = nullptr;
+    *intf = nullptr;
 #endif
+  }
 
   DisplayError error = kErrorNone;
   if (*intf) {
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/debug.h>
+
+#include <vector>
+#include <map>
+#include <string>
+
+#include "hw_info_sim.h"
+
+#define __CLASS__ "HWInfoSim"
+
+namespace sdm {
+
+HWSimConfig HWInfoSim::config_ = {};
+
+DisplayError HWInfoSim::Init() {
+  DLOGI("Simulated HW: VIG=%d DMA=%d stages=%d mixers=%d bw=%" PRIu64 "kbps panel=%dx%d@%d",
+        config_.num_vig_pipe, config_.num_dma_pipe, config_.num_blending_stages,
+        config_.num_mixers, config_.max_bandwidth_kbps, config_.panel_width,
+        config_.panel_height, config_.panel_fps);
+  return kErrorNone;
+}
+
+DisplayError HWInfoSim::GetHWResourceInfo(HWResourceInfo *hw_resource) {
+  *hw_resource = {};
+  hw_resource->hw_version = 0x90000000;
+  hw_resource->num_vig_pipe = config_.num_vig_pipe;
+  hw_resource->num_dma_pipe = config_.num_dma_pipe;
+  hw_resource->num_blending_stages = config_.num_blending_stages;
+  hw_resource->max_mixer_width = config_.max_mixer_width;
+  hw_resource->max_pipe_width = config_.max_pipe_width;
+  hw_resource->max_pipe_width_dma = config_.max_pipe_width;
+  hw_resource->max_scaler_pipe_width = config_.max_pipe_width;
+  hw_resource->max_scale_up = config_.max_scale_up;
+  hw_resource->max_scale_down = config_.max_scale_down;
+  hw_resource->max_bandwidth_low = config_.max_bandwidth_kbps;
+  hw_resource->max_bandwidth_high = config_.max_bandwidth_kbps;
+  hw_resource->has_ubwc = true;
+  hw_resource->has_qseed3 = true;
+  hw_resource->is_src_split = true;
+
+  uint32_t id = 0;
+  for (uint32_t i = 0; i < config_.num_vig_pipe; i++, id++) {
+    HWPipeCaps pipe_caps;
+    pipe_caps.type = kPipeTypeVIG;
+    pipe_caps.id = id;
+    pipe_caps.max_rects = 2;
+    hw_resource->hw_pipes.push_back(pipe_caps);
+  }
+  for (uint32_t i = 0; i < config_.num_dma_pipe; i++, id++) {
+    HWPipeCaps pipe_caps;
+    pipe_caps.type = kPipeTypeDMA;
+    pipe_caps.id = id;
+    pipe_caps.max_rects = 2;
+    hw_resource->hw_pipes.push_back(pipe_caps);
+  }
+
+  return kErrorNone;
+}
+
+DisplayError HWInfoSim::GetFirstDisplayInterfaceType(HWDisplayInterfaceInfo *hw_disp_info) {
+  hw_disp_info->type = kBuiltIn;
+  hw_disp_info->is_connected = true;
+
+  return kErrorNone;
+}
+
+DisplayError HWInfoSim::GetDisplaysStatus(HWDisplaysInfo *hw_displays_info) {
+  HWDisplayInfo hw_info = {};
+
+  hw_info.display_type = kBuiltIn;
+  hw_info.is_connected = true;
+  hw_info.is_primary = true;
+  hw_info.is_wb_ubwc_supported = false;
+  hw_info.display_id = 0;
+  hw_info.max_linewidth = config_.max_mixer_width;
+  (*hw_displays_info)[hw_info.display_id] = hw_info;
+
+  return kErrorNone;
+}
+
+DisplayError HWInfoSim::GetMaxDisplaysSupported(const DisplayType type, int32_t *max_displays) {
+  switch (type) {
+    case kPluggable:
+    case kVirtual:
+      *max_displays = 0;
+      break;
+    case kBuiltIn:
+    case kDisplayTypeMax:
+      *max_displays = 1;
+      break;
+    default:
+      DLOGE("Unknown display type %d.", type);
+      return kErrorParameters;
+  }
+
+  return kErrorNone;
+}
+
+DisplayError HWInfoSim::GetRequiredDemuraFetchResourceCount(
+    std::map<uint32_t, uint8_t> *required_demura_fetch_cnt) {
+  return kErrorNotSupported;
+}
+
+DisplayError HWInfoSim::GetDemuraPanelIds(std::vector<uint64_t> *panel_ids) {
+  return kErrorNotSupported;
+}
+
+DisplayError HWInfoSim::GetPanelBootParamString(std::string *panel_boot_param_string) {
+  return kErrorNotSupported;
+}
+
+uint32_t HWInfoSim::GetMaxMixerCount() {
+  return config_.num_mixers;
+}
+
+}  // namespace sdm
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __HW_INFO_SIM_H__
+#define __HW_INFO_SIM_H__
+
+#include <core/core_interface.h>
+#include <core/sdm_types.h>
+#include <private/hw_info_types.h>
+#include <private/hw_info_interface.h>
+#include <vector>
+#include <map>
+#include <string>
+
+namespace sdm {
+
+// Capabilities of the simulated display hardware. When enabled, the HW interface factories hand
+// out HWInfoSim, HWDeviceSim and HWEventsSim instead of the DRM backed implementations, so that
+// the composition stack can be driven without a panel (see tools/sdm_replay).
+struct HWSimConfig {
+  bool enable = false;
+  uint32_t num_vig_pipe = 4;
+  uint32_t num_dma_pipe = 6;
+  uint32_t num_blending_stages = 11;
+  uint32_t num_mixers = 2;
+  uint32_t max_mixer_width = 2560;
+  uint32_t max_pipe_width = 2560;
+  uint32_t max_scale_up = 20;
+  uint32_t max_scale_down = 4;
+  uint64_t max_bandwidth_kbps = 20000000;  // Fetch bandwidth the simulated SDE can sustain
+  uint32_t panel_width = 1080;
+  uint32_t panel_height = 2400;
+  uint32_t panel_fps = 60;
+};
+
+class HWInfoSim : public HWInfoInterface {
+ public:
+  static void SetConfig(const HWSimConfig &config) { config_ = config; }
+  static const HWSimConfig &GetConfig() { return config_; }
+  static bool IsEnabled() { return config_.enable; }
+
+  virtual DisplayError Init();
+  virtual DisplayError GetHWResourceInfo(HWResourceInfo *hw_resource);
+  virtual DisplayError GetFirstDisplayInterfaceType(HWDisplayInterfaceInfo *hw_disp_info);
+  virtual DisplayError GetDisplaysStatus(HWDisplaysInfo *hw_displays_info);
+  virtual DisplayError GetMaxDisplaysSupported(DisplayType type, int32_t *max_displays);
+  virtual DisplayError GetRequiredDemuraFetchResourceCount(
+      std::map<uint32_t, uint8_t> *required_demura_fetch_cnt);
+  virtual DisplayError GetDemuraPanelIds(std::vector<uint64_t> *panel_ids);
+  virtual DisplayError GetPanelBootParamString(std::string *panel_boot_param_string);
+  virtual uint32_t GetMaxMixerCount();
+
+ private:
+  static HWSimConfig config_;
+};
+
+}  // namespace sdm
+
+#endif  // __HW_INFO_SIM_H__
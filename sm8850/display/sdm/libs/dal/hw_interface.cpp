@@ -31,6 +31,7 @@
 #include <utils/utils.h>
 
 #include <private/hw_interface.h>
+#include "hw_device_sim.h"
 #ifndef TARGET_HEADLESS
 #include "hw_peripheral_drm.h"
 #include "hw_virtual_drm.h"
@@ -47,21 +48,29 @@ DisplayError HWInterface::Create(int32_t display_id, DisplayType type,
   DisplayError error = kErrorNone;
   HWInterface *hw = nullptr;
 
-  switch (type) {
+  if (HWInfoSim::IsEnabled()) {
+    if (type != kBuiltIn) {
+      DLOGE("Display type %d is not simulated", type);
+      return kErrorNotSupported;
+    }
+    hw = new HWDeviceSim(display_id, hw_info_intf);
+  } else {
+    switch (type) {
 #ifndef TARGET_HEADLESS
-    case kBuiltIn:
-        hw = new HWPeripheralDRM(display_id, buffer_allocator, hw_info_intf);
-      break;
-    case kPluggable:
-        hw = new HWTVDRM(display_id, buffer_allocator, hw_info_intf);
-      break;
-    case kVirtual:
-        hw = new HWVirtualDRM(display_id, buffer_allocator, hw_info_intf);
-      break;
+      case kBuiltIn:
+          hw = new HWPeripheralDRM(display_id, buffer_allocator, hw_info_intf);
+        break;
+      case kPluggable:
+          hw = new HWTVDRM(display_id, buffer_allocator, hw_info_intf);
+        break;
+      case kVirtual:
+          hw = new HWVirtualDRM(display_id, buffer_allocator, hw_info_intf);
+        break;
 #endif
-    default:
-      DLOGE("Undefined display type");
-      return kErrorUndefined;
+      default:
+        DLOGE("Undefined display type");
+        return kErrorUndefined;
+    }
   }
 
   error = hw->Init();
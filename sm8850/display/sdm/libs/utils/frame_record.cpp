@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/frame_record.h>
+
+#include <sstream>
+#include <string>
+
+namespace sdm {
+
+static void WriteRect(const LayerRect &rect, std::ostream *os) {
+  *os << " " << rect.left << " " << rect.top << " " << rect.right << " " << rect.bottom;
+}
+
+static bool ReadRect(std::istream *is, LayerRect *rect) {
+  return static_cast<bool>(*is >> rect->left >> rect->top >> rect->right >> rect->bottom);
+}
+
+void WriteFrameRecord(uint32_t index, const LayerStack &layer_stack, std::ostream *os) {
+  *os << "frame " << index << " " << layer_stack.layers.size() << " "
+      << layer_stack.flags.flags << "\n";
+
+  for (auto layer : layer_stack.layers) {
+    const LayerBuffer &buffer = layer->input_buffer;
+    *os << "layer " << layer->composition << " " << layer->blending << " "
+        << static_cast<uint32_t>(layer->plane_alpha) << " " << layer->transform.rotation << " "
+        << layer->transform.flip_horizontal << " " << layer->transform.flip_vertical;
+    WriteRect(layer->src_rect, os);
+    WriteRect(layer->dst_rect, os);
+    *os << " " << buffer.format << " " << buffer.width << " " << buffer.height << " "
+        << buffer.unaligned_width << " " << buffer.unaligned_height << " " << buffer.flags.flags
+        << " " << layer->flags.flags << " " << layer->frame_rate << " " << layer->layer_id
+        << "\n";
+  }
+}
+
+bool ReadFrameRecord(std::istream *is, RecordedFrame *frame) {
+  std::string line;
+  size_t num_layers = 0;
+
+  // Skip blank lines and comments between frames.
+  while (std::getline(*is, line)) {
+    if (!line.empty() && line[0] != '#') {
+      break;
+    }
+  }
+
+  std::istringstream header(line);
+  std::string tag;
+  if (!(header >> tag >> frame->index >> num_layers >> frame->stack_flags) || tag != "frame") {
+    return false;
+  }
+
+  frame->layers.clear();
+  frame->layers.resize(num_layers);
+  for (auto &layer : frame->layers) {
+    if (!std::getline(*is, line)) {
+      return false;
+    }
+
+    std::istringstream record(line);
+    int composition = 0, blending = 0, format = 0;
+    uint32_t alpha = 0;
+    bool flip_h = false, flip_v = false;
+    LayerBuffer &buffer = layer.input_buffer;
+    if (!(record >> tag >> composition >> blending >> alpha >> layer.transform.rotation >>
+          flip_h >> flip_v) || tag != "layer") {
+      return false;
+    }
+    if (!ReadRect(&record, &layer.src_rect) || !ReadRect(&record, &layer.dst_rect)) {
+      return false;
+    }
+    if (!(record >> format >> buffer.width >> buffer.height >> buffer.unaligned_width >>
+          buffer.unaligned_height >> buffer.flags.flags >> layer.flags.flags >>
+          layer.frame_rate >> layer.layer_id)) {
+      return false;
+    }
+
+    layer.composition = static_cast<LayerComposition>(composition);
+    layer.blending = static_cast<LayerBlending>(blending);
+    layer.plane_alpha = static_cast<uint8_t>(alpha);
+    layer.transform.flip_horizontal = flip_h;
+    layer.transform.flip_vertical = flip_v;
+    buffer.format = static_cast<LayerBufferFormat>(format);
+    layer.visible_regions.push_back(layer.dst_rect);
+    layer.dirty_regions.push_back(layer.src_rect);
+  }
+
+  return true;
+}
+
+}  // namespace sdm
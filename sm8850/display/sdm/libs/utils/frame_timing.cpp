@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <time.h>
+#include <utils/frame_timing.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <vector>
+
+namespace sdm {
+
+static const char *kPhaseNames[kPhaseMax] = {
+  "PresentOrValidate", "PrepareLayerStack", "Strategy", "HWValidate", "AtomicCommit",
+  "WaitOnPreviousFence", "RetireFence",
+};
+
+static const char *kFallbackNames[kGpuFallbackMax] = {
+  "none", "skip_layer", "client_request", "animation", "strategy",
+};
+
+FrameTiming *FrameTiming::Get(int32_t display_id) {
+  static FrameTiming recorders[kMaxDisplays];
+
+  for (uint32_t i = 0; i < kMaxDisplays; i++) {
+    int32_t id = recorders[i].display_id_.load(std::memory_order_acquire);
+    if (id == display_id) {
+      return &recorders[i];
+    }
+    if (id == -1 && recorders[i].display_id_.compare_exchange_strong(id, display_id)) {
+      return &recorders[i];
+    }
+    // Lost the race for this recorder, it may have been claimed for the same display.
+    if (id == display_id) {
+      return &recorders[i];
+    }
+  }
+
+  return &recorders[kMaxDisplays - 1];
+}
+
+uint64_t FrameTiming::NowNs() {
+  struct timespec ts = {};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void FrameTiming::BeginFrame() {
+  if (frame_open_.exchange(true, std::memory_order_relaxed)) {
+    return;
+  }
+
+  Sample &sample = samples_[frames_.load(std::memory_order_relaxed) % kWindow];
+  for (uint32_t i = 0; i < kPhaseMax; i++) {
+    sample.phase_us[i].store(0, std::memory_order_relaxed);
+    sample.nested_us[i].store(0, std::memory_order_relaxed);
+  }
+  sample.fallback.store(kGpuFallbackNone, std::memory_order_relaxed);
+  sample.jank_phase.store(kPhaseMax, std::memory_order_relaxed);
+  frame_start_ns_.store(NowNs(), std::memory_order_relaxed);
+}
+
+void FrameTiming::Record(FrameTimingPhase phase, uint64_t duration_ns) {
+  Sample &sample = samples_[frames_.load(std::memory_order_relaxed) % kWindow];
+  uint64_t duration_us = std::min(duration_ns / 1000, static_cast<uint64_t>(UINT32_MAX));
+  sample.phase_us[phase].fetch_add(static_cast<uint32_t>(duration_us), std::memory_order_relaxed);
+
+  uint32_t parent = active_parent_.load(std::memory_order_relaxed);
+  if (!IsParentPhase(phase) && parent < kPhaseMax) {
+    sample.nested_us[parent].fetch_add(static_cast<uint32_t>(duration_us),
+                                       std::memory_order_relaxed);
+  }
+}
+
+FrameTimingPhase FrameTiming::EnterPhase(FrameTimingPhase phase) {
+  return static_cast<FrameTimingPhase>(active_parent_.exchange(phase, std::memory_order_relaxed));
+}
+
+void FrameTiming::ExitPhase(FrameTimingPhase previous) {
+  active_parent_.store(previous, std::memory_order_relaxed);
+}
+
+FrameTimingPhase FrameTiming::DominantPhase(const Sample &sample) {
+  // Only the own share of a parent phase competes with the SDM phases that ran within it.
+  uint32_t us[kPhaseMax] = {};
+  for (uint32_t i = 0; i < kPhaseMax; i++) {
+    uint32_t total = sample.phase_us[i].load(std::memory_order_relaxed);
+    uint32_t nested = sample.nested_us[i].load(std::memory_order_relaxed);
+    us[i] = total > nested ? total - nested : 0;
+  }
+
+  // The retire fence of the frame signals after EndFrame, RecordRetire attributes it.
+  FrameTimingPhase dominant = kPhasePresentOrValidate;
+  uint32_t max_us = 0;
+  for (uint32_t i = 0; i < kPhaseRetireFence; i++) {
+    if (us[i] > max_us) {
+      max_us = us[i];
+      dominant = static_cast<FrameTimingPhase>(i);
+    }
+  }
+
+  return dominant;
+}
+
+void FrameTiming::EndFrame(uint64_t vsync_period_ns, GpuFallbackReason reason) {
+  if (!frame_open_.exchange(false, std::memory_order_relaxed)) {
+    return;
+  }
+
+  uint64_t frame = frames_.load(std::memory_order_relaxed);
+  Sample &sample = samples_[frame % kWindow];
+  sample.fallback.store(reason, std::memory_order_relaxed);
+  fallback_frames_[reason].fetch_add(1, std::memory_order_relaxed);
+
+  uint64_t elapsed_ns = NowNs() - frame_start_ns_.load(std::memory_order_relaxed);
+  if (vsync_period_ns && elapsed_ns > vsync_period_ns) {
+    FrameTimingPhase phase = DominantPhase(sample);
+    sample.jank_phase.store(phase, std::memory_order_relaxed);
+    janky_frames_.fetch_add(1, std::memory_order_relaxed);
+    jank_by_phase_[phase].fetch_add(1, std::memory_order_relaxed);
+    jank_by_fallback_[reason].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Publish the frame last so that readers never see a half written sample as complete.
+  frames_.store(frame + 1, std::memory_order_release);
+}
+
+void FrameTiming::RecordRetire(uint64_t latency_ns, uint64_t vsync_period_ns) {
+  uint64_t frames = frames_.load(std::memory_order_acquire);
+  if (!frames) {
+    return;
+  }
+
+  Sample &sample = samples_[(frames - 1) % kWindow];
+  uint64_t latency_us = std::min(latency_ns / 1000, static_cast<uint64_t>(UINT32_MAX));
+  sample.phase_us[kPhaseRetireFence].store(static_cast<uint32_t>(latency_us),
+                                           std::memory_order_relaxed);
+
+  // The retire fence of a frame committed in time signals at the latest one vsync later.
+  uint32_t expected = kPhaseMax;
+  if (vsync_period_ns && latency_ns > 2 * vsync_period_ns &&
+      sample.jank_phase.compare_exchange_strong(expected, kPhaseRetireFence,
+                                                std::memory_order_relaxed)) {
+    janky_frames_.fetch_add(1, std::memory_order_relaxed);
+    jank_by_phase_[kPhaseRetireFence].fetch_add(1, std::memory_order_relaxed);
+    jank_by_fallback_[sample.fallback.load(std::memory_order_relaxed)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+}
+
+void FrameTiming::Reset() {
+  frames_.store(0, std::memory_order_relaxed);
+  janky_frames_.store(0, std::memory_order_relaxed);
+  for (uint32_t i = 0; i < kPhaseMax; i++) {
+    jank_by_phase_[i].store(0, std::memory_order_relaxed);
+  }
+  for (uint32_t i = 0; i < kGpuFallbackMax; i++) {
+    jank_by_fallback_[i].store(0, std::memory_order_relaxed);
+    fallback_frames_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+uint64_t FrameTiming::GetJankCount(FrameTimingPhase phase) {
+  return jank_by_phase_[phase].load(std::memory_order_relaxed);
+}
+
+void FrameTiming::Dump(std::ostringstream *os) {
+  uint64_t frames = frames_.load(std::memory_order_acquire);
+  uint64_t janky = janky_frames_.load(std::memory_order_relaxed);
+  uint32_t window = static_cast<uint32_t>(std::min(frames, static_cast<uint64_t>(kWindow)));
+
+  *os << "frames: " << frames << " janky: " << janky;
+  if (frames) {
+    std::ios_base::fmtflags flags = os->flags();
+    std::streamsize precision = os->precision();
+    *os << " (" << std::fixed << std::setprecision(2)
+        << (100.0 * static_cast<double>(janky) / static_cast<double>(frames)) << "%)";
+    os->flags(flags);
+    os->precision(precision);
+  }
+  *os << " window: " << window << std::endl;
+
+  std::vector<uint32_t> values;
+  values.reserve(kWindow);
+  for (uint32_t phase = 0; phase < kPhaseMax; phase++) {
+    uint32_t buckets[kNumBuckets] = {};
+    values.clear();
+    for (uint32_t i = 0; i < window; i++) {
+      uint32_t us = samples_[(frames - 1 - i) % kWindow].phase_us[phase].load(
+          std::memory_order_relaxed);
+      if (!us) {
+        continue;
+      }
+      values.push_back(us);
+      uint32_t bucket = 0;
+      while ((us >> bucket) > 1 && bucket < kNumBuckets - 1) {
+        bucket++;
+      }
+      buckets[bucket]++;
+    }
+
+    *os << std::left << std::setw(20) << kPhaseNames[phase] << std::right;
+    if (values.empty()) {
+      *os << " no samples" << std::endl;
+      continue;
+    }
+
+    std::sort(values.begin(), values.end());
+    *os << " n: " << std::setw(3) << values.size();
+    *os << " p50: " << std::setw(6) << values[values.size() / 2] << "us";
+    *os << " p99: " << std::setw(6) << values[(values.size() * 99) / 100] << "us";
+    *os << " max: " << std::setw(6) << values.back() << "us";
+    *os << " hist:";
+    for (uint32_t i = 0; i < kNumBuckets - 1; i++) {
+      if (buckets[i]) {
+        *os << " <" << (1U << (i + 1)) << "us:" << buckets[i];
+      }
+    }
+    if (buckets[kNumBuckets - 1]) {
+      *os << " >=" << (1U << (kNumBuckets - 1)) << "us:" << buckets[kNumBuckets - 1];
+    }
+    *os << " jank: " << jank_by_phase_[phase].load(std::memory_order_relaxed) << std::endl;
+  }
+
+  *os << "gpu fallback (frames/janky):";
+  for (uint32_t i = 0; i < kGpuFallbackMax; i++) {
+    *os << " " << kFallbackNames[i] << ": " << fallback_frames_[i].load(std::memory_order_relaxed)
+        << "/" << jank_by_fallback_[i].load(std::memory_order_relaxed);
+  }
+  *os << std::endl;
+}
+
+}  // namespace sdm
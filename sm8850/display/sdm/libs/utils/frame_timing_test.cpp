@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <utils/frame_timing.h>
+
+using namespace sdm;
+
+static const uint64_t kVsyncNs = 16666666;
+static const uint64_t kUsNs = 1000;
+
+// Ends a frame that missed its vsync, so that it is attributed to its dominant phase.
+static void EndLateFrame(FrameTiming *timing) {
+  timing->EndFrame(1 /* vsync_period_ns */, kGpuFallbackNone);
+}
+
+TEST(FrameTimingTest, PresentOrValidateDominates) {
+  FrameTiming *timing = FrameTiming::Get(100);
+  timing->Reset();
+
+  timing->BeginFrame();
+  FrameTimingPhase previous = timing->EnterPhase(kPhasePresentOrValidate);
+  timing->Record(kPhaseStrategy, 200 * kUsNs);
+  timing->Record(kPhaseAtomicCommit, 300 * kUsNs);
+  timing->Record(kPhasePresentOrValidate, 4000 * kUsNs);
+  timing->ExitPhase(previous);
+  EndLateFrame(timing);
+
+  EXPECT_EQ(1u, timing->GetJankCount(kPhasePresentOrValidate));
+  EXPECT_EQ(0u, timing->GetJankCount(kPhaseAtomicCommit));
+}
+
+TEST(FrameTimingTest, NestedTimeLeavesPresentOrValidate) {
+  FrameTiming *timing = FrameTiming::Get(101);
+  timing->Reset();
+
+  // Most of PresentOrValidate is spent in the atomic commit it ran.
+  timing->BeginFrame();
+  FrameTimingPhase previous = timing->EnterPhase(kPhasePresentOrValidate);
+  timing->Record(kPhaseAtomicCommit, 3000 * kUsNs);
+  timing->Record(kPhasePresentOrValidate, 4000 * kUsNs);
+  timing->ExitPhase(previous);
+  EndLateFrame(timing);
+
+  EXPECT_EQ(1u, timing->GetJankCount(kPhaseAtomicCommit));
+  EXPECT_EQ(0u, timing->GetJankCount(kPhasePresentOrValidate));
+}
+
+TEST(FrameTimingTest, NestedTimeLeavesPrepareLayerStack) {
+  FrameTiming *timing = FrameTiming::Get(102);
+  timing->Reset();
+
+  timing->BeginFrame();
+  {
+    ScopedFrameTiming prepare(102, kPhasePrepareLayerStack);
+    timing->Record(kPhaseStrategy, 5000 * kUsNs);
+  }
+  // Outside of any parent, nothing is taken out of PrepareLayerStack.
+  timing->Record(kPhaseWaitOnPreviousFence, 100 * kUsNs);
+  EndLateFrame(timing);
+
+  EXPECT_EQ(1u, timing->GetJankCount(kPhaseStrategy));
+  EXPECT_EQ(0u, timing->GetJankCount(kPhasePrepareLayerStack));
+}
+
+TEST(FrameTimingTest, FrameInTimeIsNotJanky) {
+  FrameTiming *timing = FrameTiming::Get(103);
+  timing->Reset();
+
+  timing->BeginFrame();
+  timing->Record(kPhasePresentOrValidate, 1000 * kUsNs);
+  timing->EndFrame(kVsyncNs, kGpuFallbackNone);
+
+  for (uint32_t i = 0; i < kPhaseMax; i++) {
+    EXPECT_EQ(0u, timing->GetJankCount(static_cast<FrameTimingPhase>(i)));
+  }
+}
+
+TEST(FrameTimingTest, LateRetireIsAttributedOnce) {
+  FrameTiming *timing = FrameTiming::Get(104);
+  timing->Reset();
+
+  timing->BeginFrame();
+  timing->EndFrame(kVsyncNs, kGpuFallbackNone);
+  timing->RecordRetire(3 * kVsyncNs, kVsyncNs);
+  timing->RecordRetire(3 * kVsyncNs, kVsyncNs);
+
+  EXPECT_EQ(1u, timing->GetJankCount(kPhaseRetireFence));
+}
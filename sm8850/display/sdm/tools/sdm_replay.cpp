@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+// Replays layer stacks recorded by the composer (vendor.display.frame_record_path) through
+// CoreInterface against the simulated HW interface, so that the CPU cost of SDM composition
+// can be measured on a host or in CI without a panel.
+
+#include <core/buffer_allocator.h>
+#include <core/buffer_sync_handler.h>
+#include <core/core_interface.h>
+#include <core/socket_handler.h>
+#include <utils/fence.h>
+#include <utils/frame_record.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "hw_device_sim.h"
+#include "hw_info_sim.h"
+
+using sdm::AllocatedBufferInfo;
+using sdm::BufferAllocator;
+using sdm::BufferConfig;
+using sdm::BufferInfo;
+using sdm::BufferSyncHandler;
+using sdm::CoreInterface;
+using sdm::DisplayError;
+using sdm::DisplayEvent;
+using sdm::DisplayEventHandler;
+using sdm::DisplayEventVSync;
+using sdm::DisplayInterface;
+using sdm::Fence;
+using sdm::HWDeviceSim;
+using sdm::HWInfoSim;
+using sdm::HWSimConfig;
+using sdm::HWSimStats;
+using sdm::Layer;
+using sdm::LayerStack;
+using sdm::RecordedFrame;
+using sdm::SocketHandler;
+using sdm::SocketType;
+
+namespace {
+
+class ReplayBufferAllocator : public BufferAllocator {
+ public:
+  int AllocateBuffer(BufferInfo *buffer_info) override { return -ENOTSUP; }
+  int FreeBuffer(BufferInfo *buffer_info) override { return 0; }
+  uint32_t GetBufferSize(BufferInfo *buffer_info) override { return 0; }
+  int GetAllocatedBufferInfo(const BufferConfig &buffer_config,
+                             AllocatedBufferInfo *allocated_buffer_info) override {
+    return -ENOTSUP;
+  }
+};
+
+class ReplayBufferSyncHandler : public BufferSyncHandler {
+ public:
+  int SyncWait(int fd, int timeout) override { return 0; }
+  int SyncMerge(int fd1, int fd2, int *merged_fd) override {
+    *merged_fd = -1;
+    return 0;
+  }
+  void GetSyncInfo(int fd, std::ostringstream *os) override { }
+};
+
+class ReplaySocketHandler : public SocketHandler {
+ public:
+  int GetSocketFd(SocketType socket_type) override { return -1; }
+};
+
+class ReplayEventHandler : public DisplayEventHandler {
+ public:
+  DisplayError VSync(const DisplayEventVSync &vsync) override { return sdm::kErrorNone; }
+  DisplayError Refresh() override { return sdm::kErrorNone; }
+  DisplayError CECMessage(char *message) override { return sdm::kErrorNone; }
+  DisplayError HistogramEvent(int source_fd, uint32_t blob_id) override {
+    return sdm::kErrorNone;
+  }
+  DisplayError HandleEvent(DisplayEvent event) override { return sdm::kErrorNone; }
+  void MMRMEvent(bool restricted) override { }
+};
+
+struct StageTimes {
+  const char *name;
+  std::vector<uint64_t> ns;
+};
+
+uint64_t ElapsedNs(const std::chrono::steady_clock::time_point &start) {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count());
+}
+
+void Usage(const char *name) {
+  printf("Usage: %s [options] <frame record>\n", name);
+  printf("  -l loops      Replay the record this many times (default 1)\n");
+  printf("  -v num        Number of VIG pipes\n");
+  printf("  -d num        Number of DMA pipes (at least 2)\n");
+  printf("  -s num        Number of blending stages\n");
+  printf("  -m num        Number of layer mixers\n");
+  printf("  -b kbps       Maximum fetch bandwidth\n");
+  printf("  -W width      Panel width\n");
+  printf("  -H height     Panel height\n");
+  printf("  -F fps        Panel refresh rate\n");
+}
+
+void PrintStage(StageTimes *stage) {
+  if (stage->ns.empty()) {
+    printf("%-8s: no samples\n", stage->name);
+    return;
+  }
+
+  std::vector<uint64_t> &ns = stage->ns;
+  std::sort(ns.begin(), ns.end());
+  uint64_t total = 0;
+  for (auto sample : ns) {
+    total += sample;
+  }
+  auto us = [&ns](size_t pct) {
+    return static_cast<double>(ns[std::min(ns.size() - 1, ns.size() * pct / 100)]) / 1000.0;
+  };
+  printf("%-8s: %6zu calls avg %8.1fus p50 %8.1fus p99 %8.1fus max %8.1fus\n", stage->name,
+         ns.size(), static_cast<double>(total / ns.size()) / 1000.0, us(50), us(99), us(100));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  HWSimConfig config = {};
+  int loops = 1;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "l:v:d:s:m:b:W:H:F:h")) != -1) {
+    switch (opt) {
+      case 'l':
+        loops = atoi(optarg);
+        break;
+      case 'v':
+        config.num_vig_pipe = static_cast<uint32_t>(atoi(optarg));
+        break;
+      case 'd':
+        config.num_dma_pipe = static_cast<uint32_t>(atoi(optarg));
+        break;
+      case 's':
+        config.num_blending_stages = static_cast<uint32_t>(atoi(optarg));
+        break;
+      case 'm':
+        config.num_mixers = static_cast<uint32_t>(atoi(optarg));
+        break;
+      case 'b':
+        config.max_bandwidth_kbps = strtoull(optarg, nullptr, 0);
+        break;
+      case 'W':
+        config.panel_width = static_cast<uint32_t>(atoi(optarg));
+        break;
+      case 'H':
+        config.panel_height = static_cast<uint32_t>(atoi(optarg));
+        break;
+      case 'F':
+        config.panel_fps = static_cast<uint32_t>(atoi(optarg));
+        break;
+      default:
+        Usage(argv[0]);
+        return -1;
+    }
+  }
+
+  // ResourceDefault reserves two pipes after the VIG pipes for the kernel.
+  if (optind >= argc || loops < 1 || config.num_dma_pipe < 2 || !config.panel_fps) {
+    Usage(argv[0]);
+    return -1;
+  }
+
+  std::ifstream record(argv[optind]);
+  if (!record.is_open()) {
+    printf("Failed to open %s\n", argv[optind]);
+    return -1;
+  }
+
+  // Parse everything up front so that only SDM is on the clock.
+  std::vector<RecordedFrame> frames;
+  RecordedFrame frame;
+  while (sdm::ReadFrameRecord(&record, &frame)) {
+    frames.push_back(frame);
+  }
+  if (frames.empty()) {
+    printf("No frames in %s\n", argv[optind]);
+    return -1;
+  }
+
+  config.enable = true;
+  HWInfoSim::SetConfig(config);
+
+  ReplayBufferAllocator buffer_allocator;
+  ReplayBufferSyncHandler buffer_sync_handler;
+  ReplaySocketHandler socket_handler;
+  ReplayEventHandler event_handler;
+  Fence::Set(&buffer_sync_handler);
+
+  CoreInterface *core_intf = nullptr;
+  DisplayError error = CoreInterface::CreateCore(&buffer_allocator, &buffer_sync_handler,
+                                                 &socket_handler, nullptr, &core_intf);
+  if (error != sdm::kErrorNone) {
+    printf("CreateCore failed %d\n", error);
+    return -1;
+  }
+
+  DisplayInterface *display_intf = nullptr;
+  error = core_intf->CreateDisplay(sdm::kBuiltIn, &event_handler, &display_intf);
+  if (error != sdm::kErrorNone) {
+    printf("CreateDisplay failed %d\n", error);
+    CoreInterface::DestroyCore();
+    return -1;
+  }
+
+  std::shared_ptr<Fence> release_fence = nullptr;
+  display_intf->SetDisplayState(sdm::kStateOn, false, &release_fence);
+
+  StageTimes prepare = {"Prepare", {}};
+  StageTimes commit = {"Commit", {}};
+  uint64_t prepare_errors = 0, commit_errors = 0;
+  HWDeviceSim::ResetStats();
+
+  for (int loop = 0; loop < loops; loop++) {
+    for (auto &recorded : frames) {
+      // SDM writes composition decisions back into the layers, replay a fresh copy every time.
+      std::vector<Layer> layers = recorded.layers;
+      LayerStack layer_stack = {};
+      layer_stack.flags.flags = recorded.stack_flags;
+      for (auto &layer : layers) {
+        layer_stack.layers.push_back(&layer);
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      error = display_intf->Prepare(&layer_stack);
+      prepare.ns.push_back(ElapsedNs(start));
+      if (error != sdm::kErrorNone && error != sdm::kErrorNeedsCommit) {
+        prepare_errors++;
+        continue;
+      }
+
+      start = std::chrono::steady_clock::now();
+      error = display_intf->Commit(&layer_stack);
+      commit.ns.push_back(ElapsedNs(start));
+      if (error != sdm::kErrorNone) {
+        commit_errors++;
+      }
+    }
+  }
+
+  const HWSimStats &stats = HWDeviceSim::GetStats();
+  printf("frames: %zu loops: %d pipes: %d VIG %d DMA stages: %d mixers: %d bw: %" PRIu64 "kbps\n",
+         frames.size(), loops, config.num_vig_pipe, config.num_dma_pipe,
+         config.num_blending_stages, config.num_mixers, config.max_bandwidth_kbps);
+  PrintStage(&prepare);
+  PrintStage(&commit);
+  uint64_t validate_avg_ns = stats.validate_count ? stats.validate_ns / stats.validate_count : 0;
+  uint64_t commit_avg_ns = stats.commit_count ? stats.commit_ns / stats.commit_count : 0;
+  printf("HW validate: %" PRIu64 " calls avg %.1fus, %" PRIu64 " rejected\n",
+         stats.validate_count, static_cast<double>(validate_avg_ns) / 1000.0,
+         stats.validate_rejects);
+  printf("HW commit  : %" PRIu64 " calls avg %.1fus\n", stats.commit_count,
+         static_cast<double>(commit_avg_ns) / 1000.0);
+  printf("peak pipes: %" PRIu64 " peak bandwidth: %" PRIu64 "kbps\n", stats.max_pipes,
+         stats.max_bandwidth_kbps);
+  printf("errors: prepare %" PRIu64 " commit %" PRIu64 "\n", prepare_errors, commit_errors);
+
+  display_intf->SetDisplayState(sdm::kStateOff, true, &release_fence);
+  core_intf->DestroyDisplay(display_intf);
+  CoreInterface::DestroyCore();
+
+  return (prepare_errors || commit_errors) ? -1 : 0;
+}